@@ -122,12 +122,6 @@
 
     static void prvDeviceAdvisorTask( void * arg );
 
-/**
- * @brief The MQTT agent manages the MQTT contexts.  This set the handle to the
- * context used by this demo.
- */
-    extern MQTTAgentContext_t xGlobalMqttAgentContext;
-
     void vStartDeviceAdvisorTask( void )
     {
         if( xTaskCreate( prvDeviceAdvisorTask,
@@ -203,7 +197,7 @@
 
         xTaskNotifyStateClear( NULL );
 
-        xCommandStatus = MQTTAgent_Subscribe( &xGlobalMqttAgentContext,
+        xCommandStatus = MQTTAgent_Subscribe( pxGetMqttAgentContext( eMqttAgentConnectionControl ),
                                               &xSubscribeArgs,
                                               &xCommandParams );
 
@@ -273,7 +267,7 @@
         xCommandParams.cmdCompleteCallback = prvPublishCommandCallback;
         xCommandParams.pCmdCompleteCallbackContext = &xCommandContext;
 
-        xCommandStatus = MQTTAgent_Publish( &xGlobalMqttAgentContext,
+        xCommandStatus = MQTTAgent_Publish( pxGetMqttAgentContext( eMqttAgentConnectionControl ),
                                             &xPublishInfo,
                                             &xCommandParams );
 
@@ -318,7 +312,8 @@
                                               uint16_t topicFilterLength )
     {
         /* Add subscription so that incoming publishes are routed to the application callback. */
-        bool subscriptionAdded = addSubscription( pTopicFilter,
+        bool subscriptionAdded = addSubscription( pxGetMqttAgentSubscriptionList( eMqttAgentConnectionControl ),
+                                                  pTopicFilter,
                                                   topicFilterLength,
                                                   prvIncomingPublishCallback,
                                                   NULL );
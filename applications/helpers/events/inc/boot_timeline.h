@@ -0,0 +1,98 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Milestones of the boot, from reset to the first inference.
+ */
+typedef enum BootTimelinePhase
+{
+    BootTimelineMain = 0,       /*!< main() started. */
+    BootTimelineProvisioned,    /*!< The device credentials are provisioned. */
+    BootTimelineSchedulerStart, /*!< The scheduler is about to start. */
+    BootTimelineNpuReady,       /*!< The NPU is initialised. */
+    BootTimelineModelReady,     /*!< The ML model and its tensor arena are initialised. */
+    BootTimelineDhcpStart,      /*!< DHCP discovery started. */
+    BootTimelineNetworkUp,      /*!< EVENT_MASK_NETWORK_UP was set. */
+    BootTimelineDnsResolved,    /*!< The first host name was resolved. */
+    BootTimelineTlsConnected,   /*!< The first TLS handshake completed. */
+    BootTimelineMqttReady,      /*!< EVENT_MASK_MQTT_INIT was set. */
+    BootTimelineMqttConnected,  /*!< CONNACK was received, EVENT_MASK_MQTT_CONNECTED was set. */
+    BootTimelineFirstInference, /*!< The first inference completed. */
+    BootTimelinePhaseCount
+} BootTimelinePhase_t;
+
+/**
+ * @brief Time at which each boot phase was first reached.
+ *
+ * Phases may be recorded concurrently from any task, only the first time a
+ * phase is reached is kept.
+ */
+typedef struct BootTimeline
+{
+    uint32_t claimed;                                 /*!< Phases a recorder started writing. */
+    uint32_t recorded;                                /*!< Phases whose time can be read. */
+    uint64_t timestampsUs[ BootTimelinePhaseCount ]; /*!< Time of each phase, in microseconds since reset. */
+} BootTimeline_t;
+
+/**
+ * @brief Clear all the phases of the timeline.
+ *
+ * @param[out] timeline The timeline.
+ */
+void bootTimeline_Init( BootTimeline_t * timeline );
+
+/**
+ * @brief Record the time a phase was reached.
+ *
+ * @param[in, out] timeline The timeline.
+ * @param[in] phase The phase.
+ * @param[in] timestampUs The time, in microseconds since reset.
+ *
+ * @return true if this is the first time the phase was reached.
+ */
+bool bootTimeline_Record( BootTimeline_t * timeline,
+                          BootTimelinePhase_t phase,
+                          uint64_t timestampUs );
+
+/**
+ * @brief Write the recorded phases as a compact trace, in the order they
+ * were reached, e.g. "main:0 prov:1520 sched:1533 net:2804113".
+ *
+ * @param[in] timeline The timeline.
+ * @param[in] phases Bit mask of the phases to write, bit n for phase n.
+ * @param[out] buffer Buffer for the NULL terminated trace.
+ * @param[in] bufferSize Size of the buffer. Phases that do not fit are left out.
+ *
+ * @return The length of the trace.
+ */
+size_t bootTimeline_Format( const BootTimeline_t * timeline,
+                            uint32_t phases,
+                            char * buffer,
+                            size_t bufferSize );
+
+/**
+ * @brief Convert a 32-bit cycle counter to microseconds since reset.
+ *
+ * The counter wraps around every few minutes, the number of wraps is taken
+ * from a coarse estimate of the time, such as the tick count.
+ *
+ * @param[in] cycles The cycle counter.
+ * @param[in] approximateUs Time since reset within 2^31 cycles, 0 if unknown.
+ * @param[in] cyclesPerUs The frequency of the counter, in MHz.
+ *
+ * @return The time since reset, in microseconds.
+ */
+uint64_t bootTimeline_CyclesToUs( uint32_t cycles,
+                                  uint64_t approximateUs,
+                                  uint32_t cyclesPerUs );
+
+#endif /* BOOT_TIMELINE_H */
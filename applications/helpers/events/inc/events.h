@@ -12,12 +12,16 @@
 #include "FreeRTOS.h"
 #include "event_groups.h"
 
-#define EVENT_MASK_NETWORK_UP        0x01
-#define EVENT_MASK_MQTT_INIT         0x02
-#define EVENT_MASK_MQTT_CONNECTED    0x04
-#define EVENT_MASK_ML_START          0x08
-#define EVENT_MASK_ML_STOP           0x10
-#define EVENT_MASK_DSP_START         0x20
+#include "boot_timeline.h"
+
+#define EVENT_MASK_NETWORK_UP             0x01
+#define EVENT_MASK_MQTT_INIT              0x02
+#define EVENT_MASK_MQTT_CONNECTED         0x04
+#define EVENT_MASK_ML_START               0x08
+#define EVENT_MASK_ML_STOP                0x10
+#define EVENT_MASK_DSP_START              0x20
+#define EVENT_MASK_ML_MODEL_RELOAD        0x40
+#define EVENT_MASK_MQTT_BULK_CONNECTED    0x80
 
 extern EventGroupHandle_t xSystemEvents;
 
@@ -38,7 +42,9 @@ void vWaitUntilNetworkIsUp( void );
 void vWaitUntilMQTTAgentReady( void );
 
 /**
- * @brief Wait until MQTT agent is connected to an MQTT broker.
+ * @brief Wait until MQTT agent is connected to an MQTT broker, on its control
+ * connection. vWaitUntilMqttAgentConnectionConnected() waits for another
+ * connection.
  */
 void vWaitUntilMQTTAgentConnected( void );
 
@@ -49,4 +55,12 @@ void vWaitUntilMQTTAgentConnected( void );
  */
 bool xIsMqttAgentConnected( void );
 
+/**
+ * @brief Record the time a boot phase was first reached. The whole boot
+ * timeline is logged once the first inference completed, phases reached
+ * later are logged on their own.
+ * @param xPhase The phase reached.
+ */
+void vBootTimelineMark( BootTimelinePhase_t xPhase );
+
 #endif /* EVENT_H */
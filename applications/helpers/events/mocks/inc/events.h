@@ -9,8 +9,11 @@
 #include "fff.h"
 #include <stdbool.h>
 
-#define EVENT_MASK_MQTT_INIT         0x02
-#define EVENT_MASK_MQTT_CONNECTED    0x04
+#include "boot_timeline.h"
+
+#define EVENT_MASK_MQTT_INIT              0x02
+#define EVENT_MASK_MQTT_CONNECTED         0x04
+#define EVENT_MASK_MQTT_BULK_CONNECTED    0x80
 
 typedef void * EventGroupHandle_t;
 
@@ -21,6 +24,8 @@ DECLARE_FAKE_VALUE_FUNC( bool,
 DECLARE_FAKE_VOID_FUNC( vWaitUntilNetworkIsUp );
 DECLARE_FAKE_VOID_FUNC( vWaitUntilMQTTAgentReady );
 DECLARE_FAKE_VOID_FUNC( vWaitUntilMQTTAgentConnected );
+DECLARE_FAKE_VOID_FUNC( vBootTimelineMark,
+                        BootTimelinePhase_t );
 
 
 #endif /* EVENT_H */
@@ -12,3 +12,5 @@ DEFINE_FAKE_VALUE_FUNC( bool,
 DEFINE_FAKE_VOID_FUNC( vWaitUntilNetworkIsUp );
 DEFINE_FAKE_VOID_FUNC( vWaitUntilMQTTAgentReady );
 DEFINE_FAKE_VOID_FUNC( vWaitUntilMQTTAgentConnected );
+DEFINE_FAKE_VOID_FUNC( vBootTimelineMark,
+                       BootTimelinePhase_t );
@@ -0,0 +1,122 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "boot_timeline.h"
+
+#define CYCLE_COUNTER_WRAP    ( 1ULL << 32 )
+
+static const char * const phaseTags[ BootTimelinePhaseCount ] =
+{
+    "main",
+    "prov",
+    "sched",
+    "npu",
+    "model",
+    "dhcp",
+    "net",
+    "dns",
+    "tls",
+    "mqtt",
+    "connack",
+    "infer"
+};
+
+void bootTimeline_Init( BootTimeline_t * timeline )
+{
+    ( void ) memset( timeline, 0, sizeof( *timeline ) );
+}
+
+bool bootTimeline_Record( BootTimeline_t * timeline,
+                          BootTimelinePhase_t phase,
+                          uint64_t timestampUs )
+{
+    uint32_t mask = 1UL << phase;
+    bool first = false;
+
+    if( ( __atomic_fetch_or( &timeline->claimed, mask, __ATOMIC_RELAXED ) & mask ) == 0U )
+    {
+        timeline->timestampsUs[ phase ] = timestampUs;
+        ( void ) __atomic_fetch_or( &timeline->recorded, mask, __ATOMIC_RELEASE );
+        first = true;
+    }
+
+    return first;
+}
+
+size_t bootTimeline_Format( const BootTimeline_t * timeline,
+                            uint32_t phases,
+                            char * buffer,
+                            size_t bufferSize )
+{
+    uint32_t remaining = __atomic_load_n( &timeline->recorded, __ATOMIC_ACQUIRE ) & phases;
+    size_t length = 0U;
+
+    if( bufferSize > 0U )
+    {
+        buffer[ 0 ] = '\0';
+    }
+
+    /* Write the earliest phase left each time, there are only a few. */
+    while( remaining != 0U )
+    {
+        uint32_t earliest = BootTimelinePhaseCount;
+        uint32_t phase;
+        int written;
+
+        for( phase = 0U; phase < BootTimelinePhaseCount; phase++ )
+        {
+            if( ( ( remaining & ( 1UL << phase ) ) != 0U ) &&
+                ( ( earliest == BootTimelinePhaseCount ) ||
+                  ( timeline->timestampsUs[ phase ] < timeline->timestampsUs[ earliest ] ) ) )
+            {
+                earliest = phase;
+            }
+        }
+
+        remaining &= ~( 1UL << earliest );
+
+        if( length < bufferSize )
+        {
+            written = snprintf( &buffer[ length ],
+                                bufferSize - length,
+                                "%s%s:%llu",
+                                ( length > 0U ) ? " " : "",
+                                phaseTags[ earliest ],
+                                ( unsigned long long ) timeline->timestampsUs[ earliest ] );
+
+            if( ( written > 0 ) && ( ( size_t ) written < ( bufferSize - length ) ) )
+            {
+                length += ( size_t ) written;
+            }
+            else
+            {
+                /* Drop the phase that was cut short. */
+                buffer[ length ] = '\0';
+                break;
+            }
+        }
+    }
+
+    return length;
+}
+
+uint64_t bootTimeline_CyclesToUs( uint32_t cycles,
+                                  uint64_t approximateUs,
+                                  uint32_t cyclesPerUs )
+{
+    uint64_t approximateCycles = approximateUs * cyclesPerUs;
+    uint64_t wraps = 0U;
+
+    /* Pick the number of wraps that lands closest to the estimate. */
+    if( ( approximateCycles + ( CYCLE_COUNTER_WRAP / 2U ) ) > cycles )
+    {
+        wraps = ( approximateCycles + ( CYCLE_COUNTER_WRAP / 2U ) - cycles ) / CYCLE_COUNTER_WRAP;
+    }
+
+    return ( ( wraps * CYCLE_COUNTER_WRAP ) + cycles ) / cyclesPerUs;
+}
@@ -5,10 +5,33 @@
 
 #include "events.h"
 
+#include "task.h"
+
+#include CMSIS_device_header
+
+/* Include header that defines log levels. */
+#include "logging_levels.h"
+
+/* Configure name and log level for the events helper. */
+#ifndef LIBRARY_LOG_NAME
+    #define LIBRARY_LOG_NAME     "Boot"
+#endif
+#ifndef LIBRARY_LOG_LEVEL
+    #define LIBRARY_LOG_LEVEL    LOG_INFO
+#endif
+#include "logging_stack.h"
+
+#define BOOT_TIMELINE_TRACE_LENGTH    ( 256U )
+#define BOOT_TIMELINE_PHASE_LENGTH    ( 32U )
+#define DWT_LAR_UNLOCK                ( 0xC5ACCE55UL )
+
 /* System events group. */
 EventGroupHandle_t xSystemEvents = NULL;
 static StaticEventGroup_t xSystemEventsGroup;
 
+static BootTimeline_t xBootTimeline;
+static uint64_t ullSchedulerStartUs = 0U;
+
 int32_t xEventHelperInit( void )
 {
     /* Create a system events group. */
@@ -61,3 +84,63 @@ bool xIsMqttAgentConnected( void )
 
     return( ( bool ) ( uxEvents & EVENT_MASK_MQTT_CONNECTED ) );
 }
+
+static uint64_t prvBootTimeUs( void )
+{
+    uint64_t ullApproximateUs = 0U;
+
+    /* The cycle counter alone is enough until it first wraps around, which
+     * is long after the scheduler starts. */
+    if( ( __atomic_load_n( &xBootTimeline.recorded, __ATOMIC_ACQUIRE ) & ( 1UL << BootTimelineSchedulerStart ) ) != 0U )
+    {
+        ullApproximateUs = ullSchedulerStartUs +
+                           ( ( uint64_t ) TICKS_TO_pdMS( xTaskGetTickCount() ) * 1000U );
+    }
+
+    return bootTimeline_CyclesToUs( DWT->CYCCNT, ullApproximateUs, SystemCoreClock / 1000000U );
+}
+
+void vBootTimelineMark( BootTimelinePhase_t xPhase )
+{
+    uint64_t ullTimeUs;
+
+    /* main() marks the first phase before any task runs. */
+    if( xPhase == BootTimelineMain )
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->LAR = DWT_LAR_UNLOCK;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    /* Some phases are marked on every inference, skip those already reached
+     * without reading the time. */
+    if( ( __atomic_load_n( &xBootTimeline.claimed, __ATOMIC_RELAXED ) & ( 1UL << xPhase ) ) != 0U )
+    {
+        return;
+    }
+
+    ullTimeUs = prvBootTimeUs();
+
+    if( xPhase == BootTimelineSchedulerStart )
+    {
+        ullSchedulerStartUs = ullTimeUs;
+    }
+
+    if( bootTimeline_Record( &xBootTimeline, xPhase, ullTimeUs ) )
+    {
+        if( xPhase == BootTimelineFirstInference )
+        {
+            char cTrace[ BOOT_TIMELINE_TRACE_LENGTH ];
+
+            ( void ) bootTimeline_Format( &xBootTimeline, ~0UL, cTrace, sizeof( cTrace ) );
+            LogInfo( ( "Boot timeline (us): %s", cTrace ) );
+        }
+        else if( ( __atomic_load_n( &xBootTimeline.recorded, __ATOMIC_ACQUIRE ) & ( 1UL << BootTimelineFirstInference ) ) != 0U )
+        {
+            char cTrace[ BOOT_TIMELINE_PHASE_LENGTH ];
+
+            ( void ) bootTimeline_Format( &xBootTimeline, 1UL << xPhase, cTrace, sizeof( cTrace ) );
+            LogInfo( ( "Boot timeline (us): %s", cTrace ) );
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "boot_timeline.h"
+}
+
+static const uint32_t allPhases = ~0U;
+
+class TestBootTimeline : public ::testing::Test
+{
+public:
+    TestBootTimeline()
+    {
+        bootTimeline_Init( &timeline );
+    }
+
+    std::string format( uint32_t phases,
+                        size_t bufferSize = 256U )
+    {
+        std::string trace( bufferSize, 'x' );
+        size_t length = bootTimeline_Format( &timeline, phases, &trace[ 0 ], bufferSize );
+
+        EXPECT_EQ( length, strlen( trace.c_str() ) );
+
+        return trace.substr( 0, length );
+    }
+
+    BootTimeline_t timeline;
+};
+
+TEST_F( TestBootTimeline, an_empty_timeline_formats_to_an_empty_trace )
+{
+    EXPECT_EQ( format( allPhases ), "" );
+}
+
+TEST_F( TestBootTimeline, only_the_first_time_a_phase_is_reached_is_kept )
+{
+    EXPECT_TRUE( bootTimeline_Record( &timeline, BootTimelineNetworkUp, 2000U ) );
+    EXPECT_FALSE( bootTimeline_Record( &timeline, BootTimelineNetworkUp, 9000U ) );
+
+    EXPECT_EQ( format( allPhases ), "net:2000" );
+}
+
+TEST_F( TestBootTimeline, phases_are_traced_in_the_order_they_were_reached )
+{
+    bootTimeline_Record( &timeline, BootTimelineMain, 0U );
+    bootTimeline_Record( &timeline, BootTimelineMqttConnected, 4100000U );
+    bootTimeline_Record( &timeline, BootTimelineModelReady, 35000U );
+    bootTimeline_Record( &timeline, BootTimelineNetworkUp, 2800000U );
+    bootTimeline_Record( &timeline, BootTimelineFirstInference, 5200000U );
+
+    EXPECT_EQ( format( allPhases ), "main:0 model:35000 net:2800000 connack:4100000 infer:5200000" );
+}
+
+TEST_F( TestBootTimeline, only_the_requested_phases_are_traced )
+{
+    bootTimeline_Record( &timeline, BootTimelineMain, 0U );
+    bootTimeline_Record( &timeline, BootTimelineDnsResolved, 3000000U );
+    bootTimeline_Record( &timeline, BootTimelineTlsConnected, 3900000U );
+
+    EXPECT_EQ( format( 1U << BootTimelineTlsConnected ), "tls:3900000" );
+}
+
+TEST_F( TestBootTimeline, phases_that_do_not_fit_are_left_out )
+{
+    bootTimeline_Record( &timeline, BootTimelineMain, 0U );
+    bootTimeline_Record( &timeline, BootTimelineProvisioned, 1520U );
+    bootTimeline_Record( &timeline, BootTimelineSchedulerStart, 1533U );
+
+    /* "main:0 prov:1520" and the terminator. */
+    EXPECT_EQ( format( allPhases, 17U ), "main:0 prov:1520" );
+    EXPECT_EQ( format( allPhases, 16U ), "main:0" );
+    EXPECT_EQ( format( allPhases, 6U ), "" );
+}
+
+TEST_F( TestBootTimeline, cycles_before_the_first_wrap_convert_directly )
+{
+    EXPECT_EQ( bootTimeline_CyclesToUs( 25000000U, 0U, 25U ), 1000000U );
+    EXPECT_EQ( bootTimeline_CyclesToUs( 0xFFFFFFFFU, 0U, 25U ), 0xFFFFFFFFULL / 25U );
+}
+
+TEST_F( TestBootTimeline, wraps_of_the_cycle_counter_are_taken_from_the_estimate )
+{
+    const uint64_t wrap = 1ULL << 32;
+    const uint64_t timeUs = ( 3U * wrap + 1000U ) / 25U;
+
+    /* The estimate is only as precise as the tick, on either side. */
+    EXPECT_EQ( bootTimeline_CyclesToUs( 1000U, timeUs, 25U ), timeUs );
+    EXPECT_EQ( bootTimeline_CyclesToUs( 1000U, timeUs - 5000U, 25U ), timeUs );
+    EXPECT_EQ( bootTimeline_CyclesToUs( 1000U, timeUs + 5000U, 25U ), timeUs );
+
+    /* Just before the third wrap. */
+    EXPECT_EQ( bootTimeline_CyclesToUs( 0xFFFFFF00U, timeUs, 25U ), ( 3U * wrap - 0x100U ) / 25U );
+}
@@ -0,0 +1,147 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include CMSIS_device_header
+
+#include "hdlcd_display.h"
+
+#include "hdlcd_drv.h"
+
+void hdlcd_display_init( struct hdlcd_display * display,
+                         struct hdlcd_dev_t * dev,
+                         void * buffer0,
+                         void * buffer1,
+                         size_t buffer_size )
+{
+    display->dev = dev;
+    display->buffer_size = buffer_size;
+    display->width = 0;
+    display->height = 0;
+    display->format = HDLCD_PIXEL_FORMAT_NOT_SUPPORTED;
+    hdlcd_flip_init( &display->chain, ( uint32_t ) buffer0, ( uint32_t ) buffer1 );
+    display->flipped = xSemaphoreCreateBinaryStatic( &display->flipped_buffer );
+}
+
+bool hdlcd_display_configure( struct hdlcd_display * display,
+                              uint32_t width,
+                              uint32_t height,
+                              enum hdlcd_pixel_format format )
+{
+    struct hdlcd_resolution_cfg_t resolution_cfg = { 0 };
+    uint32_t line_length;
+
+    if( format >= HDLCD_PIXEL_FORMAT_NOT_SUPPORTED )
+    {
+        return false;
+    }
+
+    if( ( width == display->width ) && ( height == display->height ) && ( format == display->format ) )
+    {
+        return true;
+    }
+
+    line_length = width * HDLCD_MODES[ format ].bytes_per_pixel;
+
+    if( ( width == 0 ) || ( height == 0 ) || ( ( ( size_t ) line_length * height ) > display->buffer_size ) )
+    {
+        return false;
+    }
+
+    hdlcd_disable( display->dev );
+    hdlcd_disable_irq( display->dev, INT_DMA_END_Msk );
+
+    /* The scan out is stopped, a presented buffer can be shown right away. */
+    if( hdlcd_flip_frame_end( &display->chain, NULL ) )
+    {
+        ( void ) xSemaphoreGive( display->flipped );
+    }
+
+    /* Note: This only works, because FVP ignores all timing values */
+    resolution_cfg.v_data = height;
+    resolution_cfg.h_data = width;
+    hdlcd_set_custom_resolution( display->dev, &resolution_cfg );
+
+    display->buffer_cfg.base_address = hdlcd_flip_front( &display->chain );
+    display->buffer_cfg.line_length = line_length;
+    display->buffer_cfg.line_count = height - 1;
+    display->buffer_cfg.line_pitch = line_length;
+    display->buffer_cfg.pixel_format = HDLCD_MODES[ format ].pixel_format;
+
+    /* A failed configuration is retried by the next call. */
+    display->width = 0;
+
+    if( ( hdlcd_buffer_config( display->dev, &display->buffer_cfg ) != HDLCD_ERR_NONE ) ||
+        ( hdlcd_pixel_config( display->dev, HDLCD_MODES[ format ].pixel_cfg ) != HDLCD_ERR_NONE ) )
+    {
+        return false;
+    }
+
+    display->width = width;
+    display->height = height;
+    display->format = format;
+
+    hdlcd_clear_irq( display->dev, INT_DMA_END_Msk );
+    hdlcd_enable_irq( display->dev, INT_DMA_END_Msk );
+    hdlcd_enable( display->dev );
+
+    return true;
+}
+
+void * hdlcd_display_acquire( struct hdlcd_display * display,
+                              TickType_t timeout )
+{
+    while( hdlcd_flip_is_pending( &display->chain ) )
+    {
+        if( xSemaphoreTake( display->flipped, timeout ) != pdTRUE )
+        {
+            return NULL;
+        }
+    }
+
+    return ( void * ) hdlcd_flip_back( &display->chain );
+}
+
+bool hdlcd_display_present( struct hdlcd_display * display )
+{
+    #if defined( __DCACHE_PRESENT ) && ( __DCACHE_PRESENT == 1U )
+        /* The HDLCD fetches the frame from memory. */
+        if( ( SCB->CCR & SCB_CCR_DC_Msk ) != 0U )
+        {
+            SCB_CleanDCache_by_Addr( ( void * ) hdlcd_flip_back( &display->chain ),
+                                     ( int32_t ) ( display->buffer_cfg.line_pitch * display->height ) );
+        }
+    #endif
+
+    /* Drop a flip signalled before this buffer was presented. */
+    ( void ) xSemaphoreTake( display->flipped, 0 );
+
+    return hdlcd_flip_present( &display->chain );
+}
+
+void hdlcd_display_irq_handler( struct hdlcd_display * display )
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    uint32_t irq_state = hdlcd_get_irq_state( display->dev );
+    uint32_t front;
+
+    hdlcd_clear_irq( display->dev, irq_state );
+
+    /* The whole frame was fetched: the new base address is used from the
+     * next frame on, and the old front buffer can be drawn into. */
+    if( ( ( irq_state & INT_DMA_END_Msk ) != 0 ) && hdlcd_flip_frame_end( &display->chain, &front ) )
+    {
+        display->buffer_cfg.base_address = front;
+        ( void ) hdlcd_buffer_config( display->dev, &display->buffer_cfg );
+        ( void ) xSemaphoreGiveFromISR( display->flipped, &higher_priority_task_woken );
+    }
+
+    portYIELD_FROM_ISR( higher_priority_task_woken );
+}
+
+void hdlcd_display_get_stats( const struct hdlcd_display * display,
+                              struct hdlcd_flip_stats * stats )
+{
+    hdlcd_flip_get_stats( &display->chain, stats );
+}
@@ -0,0 +1,75 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __HDLCD_DISPLAY_H__
+#define __HDLCD_DISPLAY_H__
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#include "hdlcd_drv.h"
+#include "hdlcd_flip.h"
+#include "hdlcd_helper.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Double-buffered HDLCD display. The frames are composed into the back
+ * buffer and presented; the HDLCD keeps scanning out the front buffer, and
+ * the end of frame interrupt moves the frame buffer base address to the
+ * presented buffer. The HDLCD is only disabled when the resolution or the
+ * pixel format changes.
+ *
+ * The application routes the HDLCD interrupt to hdlcd_display_irq_handler(),
+ * at a priority that allows FreeRTOS API calls. */
+
+struct hdlcd_display
+{
+    struct hdlcd_dev_t * dev;
+    struct hdlcd_flip_chain chain;
+    size_t buffer_size;
+    uint32_t width;
+    uint32_t height;
+    enum hdlcd_pixel_format format;
+    struct hdlcd_buffer_cfg_t buffer_cfg;
+    SemaphoreHandle_t flipped;
+    StaticSemaphore_t flipped_buffer;
+};
+
+/* Use two buffers of buffer_size bytes each. buffer0 is shown first. */
+void hdlcd_display_init( struct hdlcd_display * display,
+                         struct hdlcd_dev_t * dev,
+                         void * buffer0,
+                         void * buffer1,
+                         size_t buffer_size );
+
+/* Set the resolution and the pixel format, and start the scan out of the
+ * front buffer. Nothing is reprogrammed if they did not change. Returns
+ * false if a frame does not fit in a buffer or the HDLCD rejects the
+ * configuration. */
+bool hdlcd_display_configure( struct hdlcd_display * display,
+                              uint32_t width,
+                              uint32_t height,
+                              enum hdlcd_pixel_format format );
+
+/* Get the back buffer to compose the next frame into, waiting for the flip of
+ * the previously presented one. Returns NULL on timeout. */
+void * hdlcd_display_acquire( struct hdlcd_display * display,
+                              TickType_t timeout );
+
+/* Present the back buffer acquired last. It is shown from the frame after
+ * the one being scanned out. Returns false, and the frame is dropped, if the
+ * previously presented buffer has not been flipped yet. */
+bool hdlcd_display_present( struct hdlcd_display * display );
+
+/* HDLCD interrupt handler. Clears the interrupts and flips the buffers at the
+ * end of a frame. */
+void hdlcd_display_irq_handler( struct hdlcd_display * display );
+
+/* Get the flip counters of the display. */
+void hdlcd_display_get_stats( const struct hdlcd_display * display,
+                              struct hdlcd_flip_stats * stats );
+
+#endif /* __HDLCD_DISPLAY_H__ */
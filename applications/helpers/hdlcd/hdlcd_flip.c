@@ -0,0 +1,75 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hdlcd_flip.h"
+
+#include <stddef.h>
+
+void hdlcd_flip_init( struct hdlcd_flip_chain * chain,
+                      uint32_t buffer0,
+                      uint32_t buffer1 )
+{
+    *chain = ( struct hdlcd_flip_chain ) { 0 };
+    chain->buffers[ 0 ] = buffer0;
+    chain->buffers[ 1 ] = buffer1;
+}
+
+uint32_t hdlcd_flip_front( const struct hdlcd_flip_chain * chain )
+{
+    return chain->buffers[ chain->front ];
+}
+
+uint32_t hdlcd_flip_back( const struct hdlcd_flip_chain * chain )
+{
+    return chain->buffers[ chain->front ^ 1U ];
+}
+
+bool hdlcd_flip_is_pending( const struct hdlcd_flip_chain * chain )
+{
+    return chain->pending;
+}
+
+bool hdlcd_flip_present( struct hdlcd_flip_chain * chain )
+{
+    if( chain->pending )
+    {
+        return false;
+    }
+
+    chain->stats.presented++;
+    chain->pending = true;
+
+    return true;
+}
+
+bool hdlcd_flip_frame_end( struct hdlcd_flip_chain * chain,
+                           uint32_t * front )
+{
+    chain->stats.frames++;
+
+    if( !chain->pending )
+    {
+        chain->stats.repeated++;
+        return false;
+    }
+
+    /* The whole front buffer was fetched, it becomes the back buffer. */
+    chain->front ^= 1U;
+    chain->stats.flipped++;
+    chain->pending = false;
+
+    if( front != NULL )
+    {
+        *front = chain->buffers[ chain->front ];
+    }
+
+    return true;
+}
+
+void hdlcd_flip_get_stats( const struct hdlcd_flip_chain * chain,
+                           struct hdlcd_flip_stats * stats )
+{
+    *stats = chain->stats;
+}
@@ -0,0 +1,67 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __HDLCD_FLIP_H__
+#define __HDLCD_FLIP_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Bookkeeping of two frame buffers scanned out by the HDLCD in turn: the
+ * front buffer is scanned out, the back buffer is drawn. A presented back
+ * buffer is only swapped with the front buffer once the HDLCD has fetched
+ * the whole front buffer, from the end of frame interrupt, so that the
+ * display never shows a buffer that is being drawn.
+ *
+ * The task owns the back buffer while no flip is pending, the interrupt
+ * handler owns the chain while one is. */
+
+#define HDLCD_FLIP_BUFFERS    2U
+
+struct hdlcd_flip_stats
+{
+    uint32_t presented; /* Back buffers presented. */
+    uint32_t flipped;   /* Back buffers that became the front buffer. */
+    uint32_t frames;    /* Frames scanned out. */
+    uint32_t repeated;  /* Frames scanned out again because nothing new was presented. */
+};
+
+struct hdlcd_flip_chain
+{
+    uint32_t buffers[ HDLCD_FLIP_BUFFERS ];
+    volatile uint32_t front;
+    volatile bool pending;
+    struct hdlcd_flip_stats stats;
+};
+
+/* Start with buffer0 as the front buffer. */
+void hdlcd_flip_init( struct hdlcd_flip_chain * chain,
+                      uint32_t buffer0,
+                      uint32_t buffer1 );
+
+/* Address of the buffer scanned out. */
+uint32_t hdlcd_flip_front( const struct hdlcd_flip_chain * chain );
+
+/* Address of the buffer to draw into, only valid while no flip is pending. */
+uint32_t hdlcd_flip_back( const struct hdlcd_flip_chain * chain );
+
+/* True while a presented back buffer waits for the end of the frame. */
+bool hdlcd_flip_is_pending( const struct hdlcd_flip_chain * chain );
+
+/* Present the back buffer. Returns false, and presents nothing, if the
+ * previous back buffer has not been flipped yet. */
+bool hdlcd_flip_present( struct hdlcd_flip_chain * chain );
+
+/* Called at the end of each frame. Returns true, with the address of the new
+ * front buffer, if a presented buffer must be scanned out from the next
+ * frame on. */
+bool hdlcd_flip_frame_end( struct hdlcd_flip_chain * chain,
+                           uint32_t * front );
+
+/* Get the counters of the chain. */
+void hdlcd_flip_get_stats( const struct hdlcd_flip_chain * chain,
+                           struct hdlcd_flip_stats * stats );
+
+#endif /* __HDLCD_FLIP_H__ */
@@ -0,0 +1,103 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "hdlcd_flip.h"
+}
+
+static const uint32_t buffer0 = 0x80000000UL;
+static const uint32_t buffer1 = 0x80800000UL;
+
+class TestHdlcdFlip : public ::testing::Test
+{
+public:
+    TestHdlcdFlip()
+    {
+        hdlcd_flip_init( &chain, buffer0, buffer1 );
+    }
+
+    struct hdlcd_flip_stats stats()
+    {
+        struct hdlcd_flip_stats flipStats;
+
+        hdlcd_flip_get_stats( &chain, &flipStats );
+
+        return flipStats;
+    }
+
+    struct hdlcd_flip_chain chain;
+};
+
+TEST_F( TestHdlcdFlip, the_first_buffer_is_scanned_out_first )
+{
+    EXPECT_EQ( hdlcd_flip_front( &chain ), buffer0 );
+    EXPECT_EQ( hdlcd_flip_back( &chain ), buffer1 );
+    EXPECT_FALSE( hdlcd_flip_is_pending( &chain ) );
+}
+
+TEST_F( TestHdlcdFlip, frames_without_a_presented_buffer_repeat_the_front_buffer )
+{
+    uint32_t front = 0;
+
+    EXPECT_FALSE( hdlcd_flip_frame_end( &chain, &front ) );
+    EXPECT_FALSE( hdlcd_flip_frame_end( &chain, &front ) );
+
+    EXPECT_EQ( front, 0U );
+    EXPECT_EQ( hdlcd_flip_front( &chain ), buffer0 );
+    EXPECT_EQ( stats().frames, 2U );
+    EXPECT_EQ( stats().repeated, 2U );
+    EXPECT_EQ( stats().flipped, 0U );
+}
+
+TEST_F( TestHdlcdFlip, a_presented_buffer_is_flipped_at_the_end_of_the_frame )
+{
+    uint32_t front = 0;
+
+    EXPECT_TRUE( hdlcd_flip_present( &chain ) );
+    EXPECT_TRUE( hdlcd_flip_is_pending( &chain ) );
+
+    /* Still scanning out the old front buffer. */
+    EXPECT_EQ( hdlcd_flip_front( &chain ), buffer0 );
+
+    EXPECT_TRUE( hdlcd_flip_frame_end( &chain, &front ) );
+    EXPECT_EQ( front, buffer1 );
+    EXPECT_EQ( hdlcd_flip_front( &chain ), buffer1 );
+    EXPECT_EQ( hdlcd_flip_back( &chain ), buffer0 );
+    EXPECT_FALSE( hdlcd_flip_is_pending( &chain ) );
+
+    /* Flipped once only. */
+    EXPECT_FALSE( hdlcd_flip_frame_end( &chain, &front ) );
+    EXPECT_EQ( hdlcd_flip_front( &chain ), buffer1 );
+}
+
+TEST_F( TestHdlcdFlip, a_buffer_cannot_be_presented_while_a_flip_is_pending )
+{
+    EXPECT_TRUE( hdlcd_flip_present( &chain ) );
+    EXPECT_FALSE( hdlcd_flip_present( &chain ) );
+
+    EXPECT_EQ( stats().presented, 1U );
+    EXPECT_TRUE( hdlcd_flip_frame_end( &chain, nullptr ) );
+    EXPECT_TRUE( hdlcd_flip_present( &chain ) );
+}
+
+TEST_F( TestHdlcdFlip, the_buffers_alternate )
+{
+    uint32_t front = 0;
+
+    for( uint32_t frame = 1; frame <= 6; frame++ )
+    {
+        ASSERT_TRUE( hdlcd_flip_present( &chain ) );
+        ASSERT_TRUE( hdlcd_flip_frame_end( &chain, &front ) );
+        EXPECT_EQ( front, ( frame % 2U ) != 0U ? buffer1 : buffer0 );
+        EXPECT_NE( hdlcd_flip_back( &chain ), hdlcd_flip_front( &chain ) );
+    }
+
+    EXPECT_EQ( stats().presented, 6U );
+    EXPECT_EQ( stats().flipped, 6U );
+    EXPECT_EQ( stats().frames, 6U );
+    EXPECT_EQ( stats().repeated, 0U );
+}
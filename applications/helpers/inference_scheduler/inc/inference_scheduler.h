@@ -0,0 +1,193 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file inference_scheduler.h
+ * @brief Decide for every frame of a stream how much of it to infer.
+ *
+ * A frame is summarised by the mean intensity of the cells of a grid laid
+ * over it, sampled rather than read in full. The cells are compared with
+ * those of the last inferred frame:
+ * - no cell changed: the detections of the last inferred frame still hold
+ *   and the frame is skipped,
+ * - a few cells changed: only the region around the changed cells and the
+ *   previous detections is inferred,
+ * - many cells or the whole scene changed: the whole frame is inferred.
+ *
+ * The whole frame is still inferred at a minimum rate, to pick up what the
+ * grid can not see.
+ *
+ * The scheduler is not thread-safe, the callers serialise the accesses.
+ */
+
+#ifndef INFERENCE_SCHEDULER_H
+#define INFERENCE_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Cells of the grid along the width and along the height */
+#ifndef inferenceschedulerGRID_SIZE
+    #define inferenceschedulerGRID_SIZE    16
+#endif
+
+/* Distance between two sampled pixels of a cell, along both axes */
+#ifndef inferenceschedulerSAMPLE_STEP
+    #define inferenceschedulerSAMPLE_STEP    4
+#endif
+
+/* Detections kept to place the next regions */
+#ifndef inferenceschedulerMAX_DETECTIONS
+    #define inferenceschedulerMAX_DETECTIONS    10
+#endif
+
+/**
+ * @brief What to infer of a frame.
+ */
+typedef enum InferenceDecision
+{
+    eInferenceFull = 0, /*!< Infer the whole frame. */
+    eInferenceRegion,   /*!< Infer a region of the frame. */
+    eInferenceSkip      /*!< Keep the detections of the last inferred frame. */
+} InferenceDecision_t;
+
+/**
+ * @brief A rectangle of a frame, in pixels.
+ */
+typedef struct InferenceRect
+{
+    uint32_t ulX;
+    uint32_t ulY;
+    uint32_t ulWidth;
+    uint32_t ulHeight;
+} InferenceRect_t;
+
+/**
+ * @brief Thresholds of the decisions.
+ */
+typedef struct InferenceSchedulerConfig
+{
+    uint32_t ulCellThreshold;     /*!< A cell changed if its mean intensity moved by more than this. */
+    uint32_t ulSceneThreshold;    /*!< The scene changed if the mean change of the cells is above this. */
+    uint32_t ulMaxSkippedFrames;  /*!< Skipped frames in a row after which a frame is inferred in full. */
+    uint32_t ulFullPeriod;        /*!< Regions inferred in a row after which a frame is inferred in full, 0 for no regions. */
+    uint32_t ulRegionMargin;      /*!< Pixels added around the changed cells and the detections. */
+    uint32_t ulMaxRegionPercent;  /*!< Regions larger than this percentage of the frame are inferred in full. */
+} InferenceSchedulerConfig_t;
+
+/**
+ * @brief Counters of the decisions.
+ */
+typedef struct InferenceSchedulerStats
+{
+    uint32_t ulFrames;             /*!< Frames decided on. */
+    uint32_t ulFull;               /*!< Frames inferred in full. */
+    uint32_t ulRegion;             /*!< Frames of which a region was inferred. */
+    uint32_t ulSkipped;            /*!< Frames skipped. */
+    uint32_t ulRegionPercent;      /*!< Average area of the inferred regions, in percent of the frame. */
+    uint32_t ulLastChangeX16;      /*!< Mean change of the cells of the last frame, in 1/16 of an intensity level. */
+    uint32_t ulLastChangedCells;   /*!< Cells changed in the last frame. */
+} InferenceSchedulerStats_t;
+
+/**
+ * @brief A scheduler of one stream. The fields are private to
+ * inference_scheduler.c.
+ */
+typedef struct InferenceScheduler
+{
+    InferenceSchedulerConfig_t xConfig;
+    uint8_t ucCells[ inferenceschedulerGRID_SIZE * inferenceschedulerGRID_SIZE ]; /*!< Cells of the last inferred frame. */
+    uint32_t ulWidth;                                                            /*!< Size of the last inferred frame, 0 before the first one. */
+    uint32_t ulHeight;
+    InferenceRect_t xDetections[ inferenceschedulerMAX_DETECTIONS ];             /*!< Detections of the last inferred frame. */
+    uint32_t ulDetections;
+    uint32_t ulSkippedInRow;                                                     /*!< Frames skipped since the last inferred one. */
+    uint32_t ulSinceFull;                                                        /*!< Frames inferred since the last full one. */
+    uint64_t ullRegionPercentSum;                                                /*!< Sum of the areas of the inferred regions, in percent. */
+    InferenceSchedulerStats_t xStats;                                            /*!< The counters, without the averages. */
+} InferenceScheduler_t;
+
+/**
+ * @brief Start a scheduler without a previous frame, its first frame is
+ * inferred in full.
+ *
+ * @param[out] pxScheduler The scheduler.
+ * @param[in] pxConfig The thresholds.
+ */
+void vInferenceSchedulerInit( InferenceScheduler_t * pxScheduler,
+                              const InferenceSchedulerConfig_t * pxConfig );
+
+/**
+ * @brief Decide what to infer of a frame. Unless the frame is skipped, it
+ * becomes the frame the next ones are compared with.
+ *
+ * @param[in, out] pxScheduler The scheduler.
+ * @param[in] pucImage The frame, one byte of intensity per pixel.
+ * @param[in] ulWidth Width of the frame.
+ * @param[in] ulHeight Height of the frame.
+ * @param[out] pxRegion The region to infer, with the aspect ratio of the
+ * frame. The whole frame unless the decision is eInferenceRegion.
+ *
+ * @return The decision.
+ */
+InferenceDecision_t xInferenceSchedulerDecide( InferenceScheduler_t * pxScheduler,
+                                               const uint8_t * pucImage,
+                                               uint32_t ulWidth,
+                                               uint32_t ulHeight,
+                                               InferenceRect_t * pxRegion );
+
+/**
+ * @brief Record the detections of the inferred frame, in the coordinates of
+ * the frame. They place the regions of the next frames.
+ *
+ * @param[in, out] pxScheduler The scheduler.
+ * @param[in] pxDetections The detections.
+ * @param[in] ulCount Number of detections, only the first
+ * inferenceschedulerMAX_DETECTIONS are kept.
+ */
+void vInferenceSchedulerSetDetections( InferenceScheduler_t * pxScheduler,
+                                       const InferenceRect_t * pxDetections,
+                                       uint32_t ulCount );
+
+/**
+ * @brief Scale a region of a frame to the size of the frame, with the
+ * nearest pixels, to infer it with the same input size as the whole frame.
+ *
+ * @param[in] pucImage The frame, one byte of intensity per pixel.
+ * @param[in] ulWidth Width of the frame.
+ * @param[in] ulHeight Height of the frame.
+ * @param[in] pxRegion The region, in the frame.
+ * @param[out] pucRegionImage The scaled region, of the size of the frame.
+ */
+void vInferenceSchedulerScaleRegion( const uint8_t * pucImage,
+                                     uint32_t ulWidth,
+                                     uint32_t ulHeight,
+                                     const InferenceRect_t * pxRegion,
+                                     uint8_t * pucRegionImage );
+
+/**
+ * @brief Move a detection of a scaled region back to the coordinates of the
+ * frame.
+ *
+ * @param[in] ulWidth Width of the frame.
+ * @param[in] ulHeight Height of the frame.
+ * @param[in] pxRegion The region, in the frame.
+ * @param[in, out] pxRect The detection.
+ */
+void vInferenceSchedulerRegionToFrame( uint32_t ulWidth,
+                                       uint32_t ulHeight,
+                                       const InferenceRect_t * pxRegion,
+                                       InferenceRect_t * pxRect );
+
+/**
+ * @brief Get the counters of the decisions.
+ *
+ * @param[in] pxScheduler The scheduler.
+ * @param[out] pxStats The counters.
+ */
+void vInferenceSchedulerGetStats( const InferenceScheduler_t * pxScheduler,
+                                  InferenceSchedulerStats_t * pxStats );
+
+#endif /* INFERENCE_SCHEDULER_H */
@@ -0,0 +1,378 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "inference_scheduler.h"
+
+#define inferenceschedulerCELLS    ( inferenceschedulerGRID_SIZE * inferenceschedulerGRID_SIZE )
+
+/*-----------------------------------------------------------*/
+
+/* Mean intensity of the sampled pixels of every cell of the grid. The
+ * sampled rows are read once, in memory order. */
+static void prvComputeCells( const uint8_t * pucImage,
+                             uint32_t ulWidth,
+                             uint32_t ulHeight,
+                             uint8_t * pucCells )
+{
+    uint32_t ulBounds[ inferenceschedulerGRID_SIZE + 1 ];
+    uint32_t ulSums[ inferenceschedulerGRID_SIZE ];
+    uint32_t ulColumns[ inferenceschedulerGRID_SIZE ];
+    uint32_t ulCellX;
+    uint32_t ulCellY;
+    uint32_t ulX;
+    uint32_t ulY;
+    uint32_t ulRows;
+
+    /* First sampled column of every cell, the columns are sampled across
+     * the cells at the same step. */
+    for( ulCellX = 0; ulCellX <= inferenceschedulerGRID_SIZE; ulCellX++ )
+    {
+        ulBounds[ ulCellX ] = ( ( ( ( ulCellX * ulWidth ) / inferenceschedulerGRID_SIZE ) + inferenceschedulerSAMPLE_STEP - 1U ) /
+                                inferenceschedulerSAMPLE_STEP ) * inferenceschedulerSAMPLE_STEP;
+    }
+
+    for( ulCellX = 0; ulCellX < inferenceschedulerGRID_SIZE; ulCellX++ )
+    {
+        ulColumns[ ulCellX ] = ( ulBounds[ ulCellX + 1U ] - ulBounds[ ulCellX ] ) / inferenceschedulerSAMPLE_STEP;
+    }
+
+    ulY = 0U;
+
+    for( ulCellY = 0; ulCellY < inferenceschedulerGRID_SIZE; ulCellY++ )
+    {
+        uint32_t ulBottom = ( ( ulCellY + 1U ) * ulHeight ) / inferenceschedulerGRID_SIZE;
+
+        ( void ) memset( ulSums, 0, sizeof( ulSums ) );
+        ulRows = 0U;
+
+        for( ; ulY < ulBottom; ulY += inferenceschedulerSAMPLE_STEP )
+        {
+            const uint8_t * pucRow = &pucImage[ ulY * ulWidth ];
+
+            for( ulCellX = 0; ulCellX < inferenceschedulerGRID_SIZE; ulCellX++ )
+            {
+                uint32_t ulSum = 0U;
+
+                for( ulX = ulBounds[ ulCellX ]; ulX < ulBounds[ ulCellX + 1U ]; ulX += inferenceschedulerSAMPLE_STEP )
+                {
+                    ulSum += pucRow[ ulX ];
+                }
+
+                ulSums[ ulCellX ] += ulSum;
+            }
+
+            ulRows++;
+        }
+
+        for( ulCellX = 0; ulCellX < inferenceschedulerGRID_SIZE; ulCellX++ )
+        {
+            uint32_t ulSamples = ulRows * ulColumns[ ulCellX ];
+
+            pucCells[ ( ulCellY * inferenceschedulerGRID_SIZE ) + ulCellX ] = ( ulSamples > 0U ) ? ( uint8_t ) ( ulSums[ ulCellX ] / ulSamples ) : 0U;
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/* Grow a side of a region to ulSize, around its centre, within [0, ulLimit). */
+static void prvGrowSide( uint32_t * pulStart,
+                         uint32_t * pulSize,
+                         uint32_t ulSize,
+                         uint32_t ulLimit )
+{
+    uint32_t ulGrowth;
+    uint32_t ulStart;
+
+    if( ulSize <= *pulSize )
+    {
+        return;
+    }
+
+    ulSize = ( ulSize < ulLimit ) ? ulSize : ulLimit;
+    ulGrowth = ( ulSize - *pulSize ) / 2U;
+    ulStart = ( *pulStart > ulGrowth ) ? ( *pulStart - ulGrowth ) : 0U;
+
+    if( ( ulStart + ulSize ) > ulLimit )
+    {
+        ulStart = ulLimit - ulSize;
+    }
+
+    *pulStart = ulStart;
+    *pulSize = ulSize;
+}
+
+/*-----------------------------------------------------------*/
+
+/* The region around the changed cells and the previous detections, with the
+ * aspect ratio of the frame so that it scales evenly to the frame size. */
+static void prvComputeRegion( const InferenceScheduler_t * pxScheduler,
+                              const uint8_t * pucCells,
+                              uint32_t ulWidth,
+                              uint32_t ulHeight,
+                              InferenceRect_t * pxRegion )
+{
+    uint32_t ulLeft = ulWidth;
+    uint32_t ulTop = ulHeight;
+    uint32_t ulRight = 0U;
+    uint32_t ulBottom = 0U;
+    uint32_t ulMargin = pxScheduler->xConfig.ulRegionMargin;
+    uint32_t ulCell;
+    uint32_t i;
+
+    for( ulCell = 0; ulCell < inferenceschedulerCELLS; ulCell++ )
+    {
+        uint32_t ulCellX = ulCell % inferenceschedulerGRID_SIZE;
+        uint32_t ulCellY = ulCell / inferenceschedulerGRID_SIZE;
+        uint32_t ulChange = ( pucCells[ ulCell ] > pxScheduler->ucCells[ ulCell ] ) ?
+                            ( uint32_t ) ( pucCells[ ulCell ] - pxScheduler->ucCells[ ulCell ] ) :
+                            ( uint32_t ) ( pxScheduler->ucCells[ ulCell ] - pucCells[ ulCell ] );
+
+        if( ulChange > pxScheduler->xConfig.ulCellThreshold )
+        {
+            uint32_t ulCellLeft = ( ulCellX * ulWidth ) / inferenceschedulerGRID_SIZE;
+            uint32_t ulCellTop = ( ulCellY * ulHeight ) / inferenceschedulerGRID_SIZE;
+            uint32_t ulCellRight = ( ( ulCellX + 1U ) * ulWidth ) / inferenceschedulerGRID_SIZE;
+            uint32_t ulCellBottom = ( ( ulCellY + 1U ) * ulHeight ) / inferenceschedulerGRID_SIZE;
+
+            ulLeft = ( ulCellLeft < ulLeft ) ? ulCellLeft : ulLeft;
+            ulTop = ( ulCellTop < ulTop ) ? ulCellTop : ulTop;
+            ulRight = ( ulCellRight > ulRight ) ? ulCellRight : ulRight;
+            ulBottom = ( ulCellBottom > ulBottom ) ? ulCellBottom : ulBottom;
+        }
+    }
+
+    for( i = 0; i < pxScheduler->ulDetections; i++ )
+    {
+        const InferenceRect_t * pxDetection = &pxScheduler->xDetections[ i ];
+        uint32_t ulDetectionRight = pxDetection->ulX + pxDetection->ulWidth;
+        uint32_t ulDetectionBottom = pxDetection->ulY + pxDetection->ulHeight;
+
+        ulLeft = ( pxDetection->ulX < ulLeft ) ? pxDetection->ulX : ulLeft;
+        ulTop = ( pxDetection->ulY < ulTop ) ? pxDetection->ulY : ulTop;
+        ulRight = ( ulDetectionRight > ulRight ) ? ulDetectionRight : ulRight;
+        ulBottom = ( ulDetectionBottom > ulBottom ) ? ulDetectionBottom : ulBottom;
+    }
+
+    ulLeft = ( ulLeft > ulMargin ) ? ( ulLeft - ulMargin ) : 0U;
+    ulTop = ( ulTop > ulMargin ) ? ( ulTop - ulMargin ) : 0U;
+    ulRight = ( ( ulRight + ulMargin ) < ulWidth ) ? ( ulRight + ulMargin ) : ulWidth;
+    ulBottom = ( ( ulBottom + ulMargin ) < ulHeight ) ? ( ulBottom + ulMargin ) : ulHeight;
+
+    pxRegion->ulX = ulLeft;
+    pxRegion->ulY = ulTop;
+    pxRegion->ulWidth = ulRight - ulLeft;
+    pxRegion->ulHeight = ulBottom - ulTop;
+
+    /* Widen or heighten the region to the aspect ratio of the frame. */
+    if( ( pxRegion->ulWidth * ulHeight ) < ( pxRegion->ulHeight * ulWidth ) )
+    {
+        prvGrowSide( &pxRegion->ulX, &pxRegion->ulWidth, ( ( pxRegion->ulHeight * ulWidth ) + ulHeight - 1U ) / ulHeight, ulWidth );
+    }
+    else
+    {
+        prvGrowSide( &pxRegion->ulY, &pxRegion->ulHeight, ( ( pxRegion->ulWidth * ulHeight ) + ulWidth - 1U ) / ulWidth, ulHeight );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void vInferenceSchedulerInit( InferenceScheduler_t * pxScheduler,
+                              const InferenceSchedulerConfig_t * pxConfig )
+{
+    *pxScheduler = ( InferenceScheduler_t ) { 0 };
+
+    pxScheduler->xConfig = *pxConfig;
+}
+
+/*-----------------------------------------------------------*/
+
+InferenceDecision_t xInferenceSchedulerDecide( InferenceScheduler_t * pxScheduler,
+                                               const uint8_t * pucImage,
+                                               uint32_t ulWidth,
+                                               uint32_t ulHeight,
+                                               InferenceRect_t * pxRegion )
+{
+    const InferenceSchedulerConfig_t * pxConfig = &pxScheduler->xConfig;
+    InferenceSchedulerStats_t * pxStats = &pxScheduler->xStats;
+    uint8_t ucCells[ inferenceschedulerCELLS ];
+    InferenceDecision_t xDecision;
+    uint32_t ulChangeSum = 0U;
+    uint32_t ulChangedCells = 0U;
+    uint32_t ulCell;
+    bool xNewScene;
+
+    pxRegion->ulX = 0U;
+    pxRegion->ulY = 0U;
+    pxRegion->ulWidth = ulWidth;
+    pxRegion->ulHeight = ulHeight;
+
+    pxStats->ulFrames++;
+
+    if( ( ulWidth == 0U ) || ( ulHeight == 0U ) )
+    {
+        pxStats->ulFull++;
+
+        return eInferenceFull;
+    }
+
+    prvComputeCells( pucImage, ulWidth, ulHeight, ucCells );
+
+    for( ulCell = 0; ulCell < inferenceschedulerCELLS; ulCell++ )
+    {
+        uint32_t ulChange = ( ucCells[ ulCell ] > pxScheduler->ucCells[ ulCell ] ) ?
+                            ( uint32_t ) ( ucCells[ ulCell ] - pxScheduler->ucCells[ ulCell ] ) :
+                            ( uint32_t ) ( pxScheduler->ucCells[ ulCell ] - ucCells[ ulCell ] );
+
+        ulChangeSum += ulChange;
+
+        if( ulChange > pxConfig->ulCellThreshold )
+        {
+            ulChangedCells++;
+        }
+    }
+
+    pxStats->ulLastChangeX16 = ( ulChangeSum * 16U ) / inferenceschedulerCELLS;
+    pxStats->ulLastChangedCells = ulChangedCells;
+
+    /* The first frame, a new resolution or a new scene. */
+    xNewScene = ( ulWidth != pxScheduler->ulWidth ) ||
+                ( ulHeight != pxScheduler->ulHeight ) ||
+                ( pxStats->ulLastChangeX16 > ( pxConfig->ulSceneThreshold * 16U ) );
+
+    if( xNewScene == true )
+    {
+        xDecision = eInferenceFull;
+    }
+    else if( ulChangedCells == 0U )
+    {
+        xDecision = ( pxScheduler->ulSkippedInRow < pxConfig->ulMaxSkippedFrames ) ? eInferenceSkip : eInferenceFull;
+    }
+    else if( pxScheduler->ulSinceFull >= pxConfig->ulFullPeriod )
+    {
+        xDecision = eInferenceFull;
+    }
+    else
+    {
+        prvComputeRegion( pxScheduler, ucCells, ulWidth, ulHeight, pxRegion );
+
+        if( ( ( uint64_t ) pxRegion->ulWidth * pxRegion->ulHeight * 100U ) >
+            ( ( uint64_t ) ulWidth * ulHeight * pxConfig->ulMaxRegionPercent ) )
+        {
+            xDecision = eInferenceFull;
+        }
+        else
+        {
+            xDecision = eInferenceRegion;
+        }
+    }
+
+    if( xDecision == eInferenceSkip )
+    {
+        pxScheduler->ulSkippedInRow++;
+        pxStats->ulSkipped++;
+
+        return xDecision;
+    }
+
+    /* The inferred frame is the reference of the next ones. */
+    ( void ) memcpy( pxScheduler->ucCells, ucCells, sizeof( ucCells ) );
+    pxScheduler->ulWidth = ulWidth;
+    pxScheduler->ulHeight = ulHeight;
+    pxScheduler->ulSkippedInRow = 0U;
+
+    if( xDecision == eInferenceRegion )
+    {
+        pxScheduler->ulSinceFull++;
+        pxScheduler->ullRegionPercentSum += ( ( uint64_t ) pxRegion->ulWidth * pxRegion->ulHeight * 100U ) / ( ( uint64_t ) ulWidth * ulHeight );
+        pxStats->ulRegion++;
+    }
+    else
+    {
+        pxRegion->ulX = 0U;
+        pxRegion->ulY = 0U;
+        pxRegion->ulWidth = ulWidth;
+        pxRegion->ulHeight = ulHeight;
+        pxScheduler->ulSinceFull = 0U;
+        pxStats->ulFull++;
+    }
+
+    return xDecision;
+}
+
+/*-----------------------------------------------------------*/
+
+void vInferenceSchedulerSetDetections( InferenceScheduler_t * pxScheduler,
+                                       const InferenceRect_t * pxDetections,
+                                       uint32_t ulCount )
+{
+    if( ulCount > inferenceschedulerMAX_DETECTIONS )
+    {
+        ulCount = inferenceschedulerMAX_DETECTIONS;
+    }
+
+    if( ulCount > 0U )
+    {
+        ( void ) memcpy( pxScheduler->xDetections, pxDetections, ulCount * sizeof( InferenceRect_t ) );
+    }
+
+    pxScheduler->ulDetections = ulCount;
+}
+
+/*-----------------------------------------------------------*/
+
+void vInferenceSchedulerScaleRegion( const uint8_t * pucImage,
+                                     uint32_t ulWidth,
+                                     uint32_t ulHeight,
+                                     const InferenceRect_t * pxRegion,
+                                     uint8_t * pucRegionImage )
+{
+    /* Steps through the region in 1/65536 of a pixel. */
+    uint32_t ulStepX = ( pxRegion->ulWidth << 16 ) / ulWidth;
+    uint32_t ulStepY = ( pxRegion->ulHeight << 16 ) / ulHeight;
+    uint32_t ulSourceY = pxRegion->ulY << 16;
+    uint32_t ulX;
+    uint32_t ulY;
+
+    for( ulY = 0; ulY < ulHeight; ulY++, ulSourceY += ulStepY )
+    {
+        const uint8_t * pucRow = &pucImage[ ( ( ulSourceY >> 16 ) * ulWidth ) + pxRegion->ulX ];
+        uint32_t ulSourceX = 0U;
+
+        for( ulX = 0; ulX < ulWidth; ulX++, ulSourceX += ulStepX )
+        {
+            *pucRegionImage++ = pucRow[ ulSourceX >> 16 ];
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void vInferenceSchedulerRegionToFrame( uint32_t ulWidth,
+                                       uint32_t ulHeight,
+                                       const InferenceRect_t * pxRegion,
+                                       InferenceRect_t * pxRect )
+{
+    pxRect->ulX = pxRegion->ulX + ( ( pxRect->ulX * pxRegion->ulWidth ) / ulWidth );
+    pxRect->ulY = pxRegion->ulY + ( ( pxRect->ulY * pxRegion->ulHeight ) / ulHeight );
+    pxRect->ulWidth = ( pxRect->ulWidth * pxRegion->ulWidth ) / ulWidth;
+    pxRect->ulHeight = ( pxRect->ulHeight * pxRegion->ulHeight ) / ulHeight;
+}
+
+/*-----------------------------------------------------------*/
+
+void vInferenceSchedulerGetStats( const InferenceScheduler_t * pxScheduler,
+                                  InferenceSchedulerStats_t * pxStats )
+{
+    *pxStats = pxScheduler->xStats;
+
+    if( pxStats->ulRegion > 0U )
+    {
+        pxStats->ulRegionPercent = ( uint32_t ) ( pxScheduler->ullRegionPercentSum / pxStats->ulRegion );
+    }
+}
@@ -0,0 +1,288 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "inference_scheduler.h"
+}
+
+static const uint32_t width = 192U;
+static const uint32_t height = 192U;
+
+static InferenceSchedulerConfig_t config()
+{
+    InferenceSchedulerConfig_t schedulerConfig = {};
+
+    schedulerConfig.ulCellThreshold = 12U;
+    schedulerConfig.ulSceneThreshold = 24U;
+    schedulerConfig.ulMaxSkippedFrames = 3U;
+    schedulerConfig.ulFullPeriod = 4U;
+    schedulerConfig.ulRegionMargin = 16U;
+    schedulerConfig.ulMaxRegionPercent = 50U;
+
+    return schedulerConfig;
+}
+
+class TestInferenceScheduler : public ::testing::Test
+{
+public:
+    TestInferenceScheduler() : image( width * height )
+    {
+        InferenceSchedulerConfig_t schedulerConfig = config();
+
+        vInferenceSchedulerInit( &scheduler, &schedulerConfig );
+
+        /* A gradient, so that no two rows look the same. */
+        for( uint32_t y = 0; y < height; y++ )
+        {
+            for( uint32_t x = 0; x < width; x++ )
+            {
+                image[ ( y * width ) + x ] = static_cast<uint8_t>( 40U + ( ( x + y ) / 4U ) );
+            }
+        }
+    }
+
+    InferenceDecision_t decide()
+    {
+        return xInferenceSchedulerDecide( &scheduler, image.data(), width, height, &region );
+    }
+
+    void brighten( uint32_t left,
+                   uint32_t top,
+                   uint32_t size,
+                   uint8_t step )
+    {
+        for( uint32_t y = top; y < top + size; y++ )
+        {
+            for( uint32_t x = left; x < left + size; x++ )
+            {
+                image[ ( y * width ) + x ] += step;
+            }
+        }
+    }
+
+    bool regionContains( uint32_t left,
+                         uint32_t top,
+                         uint32_t size )
+    {
+        return ( region.ulX <= left ) && ( region.ulY <= top ) &&
+               ( region.ulX + region.ulWidth >= left + size ) &&
+               ( region.ulY + region.ulHeight >= top + size );
+    }
+
+    InferenceSchedulerStats_t stats()
+    {
+        InferenceSchedulerStats_t schedulerStats;
+
+        vInferenceSchedulerGetStats( &scheduler, &schedulerStats );
+
+        return schedulerStats;
+    }
+
+    std::vector<uint8_t> image;
+    InferenceScheduler_t scheduler;
+    InferenceRect_t region;
+};
+
+TEST_F( TestInferenceScheduler, the_first_frame_is_inferred_in_full )
+{
+    EXPECT_EQ( decide(), eInferenceFull );
+    EXPECT_EQ( region.ulX, 0U );
+    EXPECT_EQ( region.ulY, 0U );
+    EXPECT_EQ( region.ulWidth, width );
+    EXPECT_EQ( region.ulHeight, height );
+}
+
+TEST_F( TestInferenceScheduler, steady_frames_are_skipped_up_to_the_maximum )
+{
+    ASSERT_EQ( decide(), eInferenceFull );
+
+    for( uint32_t i = 0; i < config().ulMaxSkippedFrames; i++ )
+    {
+        EXPECT_EQ( decide(), eInferenceSkip );
+    }
+
+    EXPECT_EQ( decide(), eInferenceFull );
+    EXPECT_EQ( decide(), eInferenceSkip );
+}
+
+TEST_F( TestInferenceScheduler, a_local_change_is_inferred_in_a_region_around_it )
+{
+    ASSERT_EQ( decide(), eInferenceFull );
+
+    brighten( 96, 96, 24, 60 );
+
+    EXPECT_EQ( decide(), eInferenceRegion );
+    EXPECT_TRUE( regionContains( 96, 96, 24 ) );
+    EXPECT_EQ( region.ulWidth, region.ulHeight );
+    EXPECT_LE( region.ulX + region.ulWidth, width );
+    EXPECT_LE( region.ulY + region.ulHeight, height );
+    EXPECT_LT( region.ulWidth * region.ulHeight, width * height / 2U );
+    EXPECT_EQ( stats().ulLastChangedCells, 4U );
+
+    /* The changed frame became the reference. */
+    EXPECT_EQ( decide(), eInferenceSkip );
+}
+
+TEST_F( TestInferenceScheduler, regions_keep_the_previous_detections_and_the_aspect_ratio )
+{
+    InferenceRect_t detection = { 24, 60, 20, 20 };
+
+    ASSERT_EQ( decide(), eInferenceFull );
+    vInferenceSchedulerSetDetections( &scheduler, &detection, 1 );
+
+    brighten( 72, 72, 12, 60 );
+
+    EXPECT_EQ( decide(), eInferenceRegion );
+    EXPECT_TRUE( regionContains( 72, 72, 12 ) );
+    EXPECT_TRUE( regionContains( 24, 60, 20 ) );
+    EXPECT_EQ( region.ulWidth, region.ulHeight );
+}
+
+TEST_F( TestInferenceScheduler, regions_at_the_border_stay_in_the_frame )
+{
+    ASSERT_EQ( decide(), eInferenceFull );
+
+    brighten( 0, 180, 12, 60 );
+
+    EXPECT_EQ( decide(), eInferenceRegion );
+    EXPECT_TRUE( regionContains( 0, 180, 12 ) );
+    EXPECT_EQ( region.ulWidth, region.ulHeight );
+    EXPECT_EQ( region.ulY + region.ulHeight, height );
+}
+
+TEST_F( TestInferenceScheduler, scene_changes_and_large_changes_are_inferred_in_full )
+{
+    ASSERT_EQ( decide(), eInferenceFull );
+
+    /* Lights on. */
+    brighten( 0, 0, width, 40 );
+    EXPECT_EQ( decide(), eInferenceFull );
+    EXPECT_GT( stats().ulLastChangeX16, config().ulSceneThreshold * 16U );
+
+    /* Most of the frame, but below the scene threshold. */
+    brighten( 0, 0, 160, 20 );
+    EXPECT_EQ( decide(), eInferenceFull );
+    EXPECT_LE( stats().ulLastChangeX16, config().ulSceneThreshold * 16U );
+}
+
+TEST_F( TestInferenceScheduler, a_new_resolution_is_inferred_in_full )
+{
+    ASSERT_EQ( decide(), eInferenceFull );
+
+    EXPECT_EQ( xInferenceSchedulerDecide( &scheduler, image.data(), width / 2U, height, &region ), eInferenceFull );
+    EXPECT_EQ( region.ulWidth, width / 2U );
+    EXPECT_EQ( decide(), eInferenceFull );
+}
+
+TEST_F( TestInferenceScheduler, regions_give_way_to_a_full_frame_periodically )
+{
+    ASSERT_EQ( decide(), eInferenceFull );
+
+    for( uint32_t i = 0; i < config().ulFullPeriod; i++ )
+    {
+        brighten( 96, 96, 24, 20 );
+        EXPECT_EQ( decide(), eInferenceRegion );
+    }
+
+    brighten( 96, 96, 24, 20 );
+    EXPECT_EQ( decide(), eInferenceFull );
+
+    brighten( 96, 96, 24, 20 );
+    EXPECT_EQ( decide(), eInferenceRegion );
+}
+
+TEST_F( TestInferenceScheduler, slow_changes_add_up_over_skipped_frames )
+{
+    ASSERT_EQ( decide(), eInferenceFull );
+
+    /* Each step is below the cell threshold, compared with the last
+     * inferred frame the third one is above it. */
+    brighten( 96, 96, 24, 5 );
+    EXPECT_EQ( decide(), eInferenceSkip );
+    brighten( 96, 96, 24, 5 );
+    EXPECT_EQ( decide(), eInferenceSkip );
+    brighten( 96, 96, 24, 5 );
+    EXPECT_EQ( decide(), eInferenceRegion );
+}
+
+TEST_F( TestInferenceScheduler, the_statistics_count_the_decisions )
+{
+    ASSERT_EQ( decide(), eInferenceFull );
+    ASSERT_EQ( decide(), eInferenceSkip );
+    brighten( 96, 96, 24, 60 );
+    ASSERT_EQ( decide(), eInferenceRegion );
+
+    InferenceSchedulerStats_t schedulerStats = stats();
+
+    EXPECT_EQ( schedulerStats.ulFrames, 3U );
+    EXPECT_EQ( schedulerStats.ulFull, 1U );
+    EXPECT_EQ( schedulerStats.ulSkipped, 1U );
+    EXPECT_EQ( schedulerStats.ulRegion, 1U );
+    EXPECT_EQ( schedulerStats.ulRegionPercent, ( region.ulWidth * region.ulHeight * 100U ) / ( width * height ) );
+}
+
+TEST_F( TestInferenceScheduler, regions_scale_to_the_frame_and_detections_back )
+{
+    InferenceRect_t half = { 48, 32, 96, 96 };
+    InferenceRect_t detection = { 20, 40, 60, 30 };
+    std::vector<uint8_t> scaled( width * height );
+
+    vInferenceSchedulerScaleRegion( image.data(), width, height, &half, scaled.data() );
+
+    for( uint32_t y = 0; y < height; y += 7U )
+    {
+        for( uint32_t x = 0; x < width; x += 5U )
+        {
+            ASSERT_EQ( scaled[ ( y * width ) + x ], image[ ( ( 32U + ( y / 2U ) ) * width ) + 48U + ( x / 2U ) ] );
+        }
+    }
+
+    vInferenceSchedulerRegionToFrame( width, height, &half, &detection );
+
+    EXPECT_EQ( detection.ulX, 58U );
+    EXPECT_EQ( detection.ulY, 52U );
+    EXPECT_EQ( detection.ulWidth, 30U );
+    EXPECT_EQ( detection.ulHeight, 15U );
+}
+
+TEST_F( TestInferenceScheduler, benchmark_the_decision )
+{
+    const int rounds = 2000;
+    const uint32_t samples = ( width / inferenceschedulerSAMPLE_STEP ) * ( height / inferenceschedulerSAMPLE_STEP );
+    std::mt19937 generator( 20261018U );
+    std::uniform_int_distribution<int> pixel( 0, 255 );
+    std::vector<std::vector<uint8_t> > frames( 2, std::vector<uint8_t>( width * height ) );
+
+    for( std::vector<uint8_t> & frame : frames )
+    {
+        for( uint8_t & value : frame )
+        {
+            value = static_cast<uint8_t>( pixel( generator ) );
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for( int round = 0; round < rounds; round++ )
+    {
+        ( void ) xInferenceSchedulerDecide( &scheduler, frames[ round % 2 ].data(), width, height, &region );
+    }
+
+    double decisionUs = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() / rounds;
+
+    EXPECT_EQ( stats().ulFrames, static_cast<uint32_t>( rounds ) );
+
+    RecordProperty( "decisionUs", std::to_string( decisionUs ) );
+    printf( "%ux%u frame: decision %.2f us, reading %u of %u pixels\n", width, height, decisionUs, samples, width * height );
+}
@@ -0,0 +1,50 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file mve_kernels.h
+ * @brief Helium (MVE) kernels for the hot loops of the applications.
+ *
+ * The kernels use the M-profile Vector Extension when the compiler targets
+ * it (__ARM_FEATURE_MVE) and the MVE_KERNELS_HELIUM build option is enabled,
+ * and an equivalent scalar loop otherwise, as in the host build. Both give the
+ * same results for the same input.
+ *
+ * A task that calls the vector paths uses the vector registers, so the kernel
+ * port must save and restore the MVE context (configENABLE_MVE).
+ */
+
+#ifndef MVE_KERNELS_H
+#define MVE_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Copy bytes forward. The buffers may overlap as long as the
+ * destination does not start after the source, as when a FIFO moves its
+ * unread samples to the start of its buffer.
+ *
+ * @param[out] pvDst Destination.
+ * @param[in] pvSrc Source.
+ * @param[in] xBytes Number of bytes to copy.
+ */
+void vMveCopy( void * pvDst,
+               const void * pvSrc,
+               size_t xBytes );
+
+/**
+ * @brief Convert RGB565 pixels to 8-bit grayscale, with the BT.601 weights
+ * (0.299, 0.587, 0.114) in 8-bit fixed point, rounded to nearest.
+ *
+ * @param[in] pusSrc RGB565 pixels.
+ * @param[out] pucDst Grayscale pixels.
+ * @param[in] xPixels Number of pixels.
+ */
+void vMveRgb565ToGray( const uint16_t * pusSrc,
+                       uint8_t * pucDst,
+                       size_t xPixels );
+
+#endif /* MVE_KERNELS_H */
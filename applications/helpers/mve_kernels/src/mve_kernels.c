@@ -0,0 +1,89 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include "mve_kernels.h"
+
+/* The vector paths are only built when MVE_KERNELS_HELIUM is enabled. */
+#if ( mveUSE_HELIUM == 1 ) && defined( MVE_KERNELS_HELIUM )
+    #define mveUSE_HELIUM    1
+    #include <arm_mve.h>
+#else
+    #define mveUSE_HELIUM    0
+#endif
+
+/* BT.601 luma weights in 8-bit fixed point, they add up to 256. */
+#define mveGRAY_RED_WEIGHT      77U
+#define mveGRAY_GREEN_WEIGHT    150U
+#define mveGRAY_BLUE_WEIGHT     29U
+#define mveGRAY_ROUNDING        128U
+
+/*-----------------------------------------------------------*/
+
+void vMveCopy( void * pvDst,
+               const void * pvSrc,
+               size_t xBytes )
+{
+    #if ( mveUSE_HELIUM == 1 )
+        uint8_t * pucDst = ( uint8_t * ) pvDst;
+        const uint8_t * pucSrc = ( const uint8_t * ) pvSrc;
+
+        /* Each vector is loaded before it is stored, so copying forward is safe
+         * when the destination overlaps the end of the source. */
+        while( xBytes > 0U )
+        {
+            mve_pred16_t xPredicate = vctp8q( ( uint32_t ) xBytes );
+
+            vstrbq_p_u8( pucDst, vldrbq_z_u8( pucSrc, xPredicate ), xPredicate );
+            pucDst += 16;
+            pucSrc += 16;
+            xBytes = ( xBytes > 16U ) ? ( xBytes - 16U ) : 0U;
+        }
+    #else /* if ( mveUSE_HELIUM == 1 ) */
+        ( void ) memmove( pvDst, pvSrc, xBytes );
+    #endif /* if ( mveUSE_HELIUM == 1 ) */
+}
+
+/*-----------------------------------------------------------*/
+
+void vMveRgb565ToGray( const uint16_t * pusSrc,
+                       uint8_t * pucDst,
+                       size_t xPixels )
+{
+    #if ( mveUSE_HELIUM == 1 )
+        /* The weighted sum is at most 255 * 256 + 128, so it fits the 16-bit
+         * lanes. */
+        while( xPixels > 0U )
+        {
+            mve_pred16_t xPredicate = vctp16q( ( uint32_t ) xPixels );
+            uint16x8_t xPixel = vldrhq_z_u16( pusSrc, xPredicate );
+            uint16x8_t xRed = vshlq_n_u16( vshrq_n_u16( xPixel, 11 ), 3 );
+            uint16x8_t xGreen = vshlq_n_u16( vandq_u16( vshrq_n_u16( xPixel, 5 ), vdupq_n_u16( 0x3FU ) ), 2 );
+            uint16x8_t xBlue = vshlq_n_u16( vandq_u16( xPixel, vdupq_n_u16( 0x1FU ) ), 3 );
+            uint16x8_t xGray = vdupq_n_u16( mveGRAY_ROUNDING );
+
+            xGray = vmlaq_n_u16( xGray, xRed, mveGRAY_RED_WEIGHT );
+            xGray = vmlaq_n_u16( xGray, xGreen, mveGRAY_GREEN_WEIGHT );
+            xGray = vmlaq_n_u16( xGray, xBlue, mveGRAY_BLUE_WEIGHT );
+
+            /* Store the low byte of each lane. */
+            vstrbq_p_u16( pucDst, vshrq_n_u16( xGray, 8 ), xPredicate );
+            pusSrc += 8;
+            pucDst += 8;
+            xPixels = ( xPixels > 8U ) ? ( xPixels - 8U ) : 0U;
+        }
+    #else /* if ( mveUSE_HELIUM == 1 ) */
+        for( size_t i = 0; i < xPixels; i++ )
+        {
+            uint32_t ulRed = ( ( uint32_t ) pusSrc[ i ] >> 11 ) << 3;
+            uint32_t ulGreen = ( ( ( uint32_t ) pusSrc[ i ] >> 5 ) & 0x3FU ) << 2;
+            uint32_t ulBlue = ( ( uint32_t ) pusSrc[ i ] & 0x1FU ) << 3;
+
+            pucDst[ i ] = ( uint8_t ) ( ( mveGRAY_ROUNDING + ( mveGRAY_RED_WEIGHT * ulRed ) +
+                                          ( mveGRAY_GREEN_WEIGHT * ulGreen ) + ( mveGRAY_BLUE_WEIGHT * ulBlue ) ) >> 8 );
+        }
+    #endif /* if ( mveUSE_HELIUM == 1 ) */
+}
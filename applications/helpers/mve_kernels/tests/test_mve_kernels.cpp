@@ -0,0 +1,105 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "mve_kernels.h"
+}
+
+/* Lengths around the vector widths, to cover the predicated tails. */
+static const size_t maxLength = 67U;
+static const uint8_t guard = 0xA5U;
+
+static uint8_t referenceGray( uint16_t pixel )
+{
+    double red = ( pixel >> 11 ) << 3;
+    double green = ( ( pixel >> 5 ) & 0x3FU ) << 2;
+    double blue = ( pixel & 0x1FU ) << 3;
+
+    return static_cast<uint8_t>( std::lround( 0.299 * red + 0.587 * green + 0.114 * blue ) );
+}
+
+TEST( TestMveKernels, copies_every_length_without_writing_past_the_end )
+{
+    std::vector<uint8_t> source( maxLength );
+
+    std::iota( source.begin(), source.end(), 1U );
+
+    for( size_t length = 0; length < maxLength; length++ )
+    {
+        std::vector<uint8_t> destination( maxLength + 1U, guard );
+
+        vMveCopy( destination.data(), source.data(), length );
+
+        EXPECT_TRUE( std::equal( source.begin(), source.begin() + length, destination.begin() ) ) << length;
+        EXPECT_EQ( destination[ length ], guard ) << length;
+    }
+}
+
+TEST( TestMveKernels, copies_forward_into_an_overlapping_buffer )
+{
+    for( size_t offset = 1; offset < 40U; offset++ )
+    {
+        std::vector<int16_t> fifo( 100U );
+        std::vector<int16_t> expected;
+
+        std::iota( fifo.begin(), fifo.end(), 0 );
+        expected.assign( fifo.begin() + offset, fifo.end() );
+
+        /* As a FIFO moves its unread samples to the start of its buffer. */
+        vMveCopy( fifo.data(), fifo.data() + offset, expected.size() * sizeof( int16_t ) );
+
+        EXPECT_TRUE( std::equal( expected.begin(), expected.end(), fifo.begin() ) ) << offset;
+    }
+}
+
+TEST( TestMveKernels, converts_every_rgb565_colour_to_the_rounded_bt601_gray )
+{
+    std::vector<uint16_t> pixels( 0x10000U );
+    std::vector<uint8_t> gray( pixels.size() );
+
+    std::iota( pixels.begin(), pixels.end(), 0U );
+    vMveRgb565ToGray( pixels.data(), gray.data(), pixels.size() );
+
+    EXPECT_EQ( gray[ 0x0000U ], 0U );
+    EXPECT_EQ( gray[ 0xFFFFU ], 250U );
+
+    for( size_t pixel = 0; pixel < pixels.size(); pixel++ )
+    {
+        /* The weights are rounded to 8 bits. */
+        ASSERT_LE( std::abs( gray[ pixel ] - referenceGray( pixel ) ), 1 ) << pixel;
+    }
+}
+
+TEST( TestMveKernels, converts_every_length_of_pixels_without_writing_past_the_end )
+{
+    std::vector<uint16_t> pixels( maxLength );
+    std::vector<uint8_t> whole( maxLength );
+    std::mt19937 generator( 20261018U );
+
+    for( uint16_t & pixel : pixels )
+    {
+        pixel = static_cast<uint16_t>( generator() );
+    }
+
+    vMveRgb565ToGray( pixels.data(), whole.data(), pixels.size() );
+
+    for( size_t length = 0; length < maxLength; length++ )
+    {
+        std::vector<uint8_t> gray( maxLength + 1U, guard );
+
+        vMveRgb565ToGray( pixels.data(), gray.data(), length );
+
+        EXPECT_TRUE( std::equal( whole.begin(), whole.begin() + length, gray.begin() ) ) << length;
+        EXPECT_EQ( gray[ length ], guard ) << length;
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef OTA_DELTA_SOURCE_H
+#define OTA_DELTA_SOURCE_H
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ota_payload_decoder.h"
+
+/**
+ * @brief Check that a delta payload was made against the image in a memory
+ * mapped slot.
+ *
+ * The SHA-256 of the first header->sourceSize bytes of the slot must match the
+ * digest in the payload header.
+ *
+ * @param[in] header Header of the delta payload.
+ * @param[in] slot Start of the slot of the running image.
+ * @param[in] slotSize Size of the slot.
+ *
+ * @return true if the payload applies to the image in the slot, otherwise
+ * false.
+ */
+bool otaDeltaSource_Matches( const OtaPayloadHeader_t * header,
+                             const uint8_t * slot,
+                             size_t slotSize );
+
+/**
+ * @brief Read bytes of the image in a memory mapped slot.
+ *
+ * @param[in] slot Start of the slot of the running image.
+ * @param[in] slotSize Size of the slot.
+ * @param[in] offset Offset of the first byte to read.
+ * @param[out] data Buffer to read into.
+ * @param[in] length Number of bytes to read.
+ *
+ * @return true on success, false if the bytes are not all within the slot.
+ */
+bool otaDeltaSource_Read( const uint8_t * slot,
+                          size_t slotSize,
+                          uint32_t offset,
+                          uint8_t * data,
+                          size_t length );
+
+#endif /* OTA_DELTA_SOURCE_H */
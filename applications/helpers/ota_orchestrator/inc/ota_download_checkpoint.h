@@ -0,0 +1,193 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef OTA_DOWNLOAD_CHECKPOINT_H
+#define OTA_DOWNLOAD_CHECKPOINT_H
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Maximum length of a job ID held by a checkpoint, including the
+ * terminating NUL character.
+ */
+#define OTA_CHECKPOINT_MAX_JOB_ID_LENGTH    64U
+
+/**
+ * @brief Number of blocks past the first missing block whose reception is
+ * tracked by a checkpoint.
+ */
+#define OTA_CHECKPOINT_WINDOW_BLOCKS        32U
+
+/**
+ * @brief Size of the image hash state held by a checkpoint.
+ */
+#define OTA_CHECKPOINT_HASH_STATE_SIZE      128U
+
+/**
+ * @brief Return codes of the checkpoint storage functions.
+ */
+typedef enum OtaCheckpointStatus
+{
+    OtaCheckpointSuccess = 0,  /*!< The operation succeeded. */
+    OtaCheckpointNotFound,     /*!< No checkpoint is stored. */
+    OtaCheckpointInvalid,      /*!< The stored checkpoint has another layout. */
+    OtaCheckpointStorageError  /*!< Protected storage returned an error. */
+} OtaCheckpointStatus_t;
+
+/**
+ * @brief Progress of a file download, as persisted in protected storage.
+ *
+ * Every block before windowBaseBlock has been written to the image. Bit n of
+ * windowReceivedBitmap is set once block windowBaseBlock + n has been written,
+ * so blocks received out of order are remembered as well. imageHashState is
+ * the state of the image hash over the blocks before windowBaseBlock, in the
+ * layout of the hash implementation of the caller.
+ */
+typedef struct OtaDownloadCheckpoint
+{
+    uint32_t version;                                          /*!< Layout version of the checkpoint. */
+    char jobId[ OTA_CHECKPOINT_MAX_JOB_ID_LENGTH ];            /*!< NUL terminated ID of the OTA job. */
+    int32_t fileId;                                            /*!< Stream file ID of the image. */
+    uint32_t fileSize;                                         /*!< Size of the image in bytes. */
+    uint32_t windowBaseBlock;                                  /*!< Index of the first block not written. */
+    uint32_t windowReceivedBitmap;                             /*!< Blocks written past windowBaseBlock. */
+    uint32_t bytesReceived;                                    /*!< Number of image bytes written. */
+    uint32_t imageHashSaved;                                   /*!< 1 if imageHashState is set, otherwise 0. */
+    uint8_t imageHashState[ OTA_CHECKPOINT_HASH_STATE_SIZE ];  /*!< Hash state of the image before windowBaseBlock. */
+} OtaDownloadCheckpoint_t;
+
+/**
+ * @brief Start tracking the download of a new file.
+ *
+ * @param[out] checkpoint Checkpoint to initialize, no block is received.
+ * @param[in] jobId ID of the OTA job, not necessarily NUL terminated.
+ * @param[in] jobIdLength Length of jobId.
+ * @param[in] fileId Stream file ID of the image.
+ * @param[in] fileSize Size of the image in bytes.
+ */
+void otaCheckpoint_Reset( OtaDownloadCheckpoint_t * checkpoint,
+                          const char * jobId,
+                          size_t jobIdLength,
+                          int32_t fileId,
+                          uint32_t fileSize );
+
+/**
+ * @brief Check whether a checkpoint tracks the download of a job document.
+ *
+ * @param[in] checkpoint Checkpoint to check.
+ * @param[in] jobId ID of the OTA job, not necessarily NUL terminated.
+ * @param[in] jobIdLength Length of jobId.
+ * @param[in] fileId Stream file ID of the image.
+ * @param[in] fileSize Size of the image in bytes.
+ *
+ * @return true if the job ID, file ID and file size all match, otherwise false.
+ */
+bool otaCheckpoint_MatchesJob( const OtaDownloadCheckpoint_t * checkpoint,
+                               const char * jobId,
+                               size_t jobIdLength,
+                               int32_t fileId,
+                               uint32_t fileSize );
+
+/**
+ * @brief Check whether a block has been written.
+ *
+ * @param[in] checkpoint Checkpoint to check.
+ * @param[in] blockId Index of the block within the file.
+ *
+ * @return true if the block has been written, otherwise false.
+ */
+bool otaCheckpoint_IsBlockReceived( const OtaDownloadCheckpoint_t * checkpoint,
+                                    uint32_t blockId );
+
+/**
+ * @brief Record that a block has been written, and slide the window past
+ * every block written in order.
+ *
+ * @param[in,out] checkpoint Checkpoint to update.
+ * @param[in] blockId Index of the block within the file.
+ * @param[in] blockLength Number of bytes written for the block.
+ *
+ * @return false if the block was already written or lies past the tracked
+ * window, otherwise true.
+ */
+bool otaCheckpoint_MarkBlockReceived( OtaDownloadCheckpoint_t * checkpoint,
+                                      uint32_t blockId,
+                                      uint32_t blockLength );
+
+/**
+ * @brief Get the end of the blocks requested ahead of the first block not
+ * written.
+ *
+ * @param[in] checkpoint Checkpoint to check.
+ * @param[in] windowBlocks Number of blocks requested ahead, at most
+ * OTA_CHECKPOINT_WINDOW_BLOCKS.
+ * @param[in] totalBlocks Number of blocks of the file.
+ *
+ * @return Index of the first block past the window, at most totalBlocks.
+ */
+uint32_t otaCheckpoint_GetWindowEnd( const OtaDownloadCheckpoint_t * checkpoint,
+                                     uint32_t windowBlocks,
+                                     uint32_t totalBlocks );
+
+/**
+ * @brief Find the first run of consecutive blocks not written in a range.
+ *
+ * @param[in] checkpoint Checkpoint to check.
+ * @param[in] firstBlock First block of the range.
+ * @param[in] endBlock Block past the range.
+ * @param[out] runStart First block of the run, only set if a run is found.
+ *
+ * @return Number of blocks of the run, 0 if every block of the range has been
+ * written.
+ */
+uint32_t otaCheckpoint_FindMissingRun( const OtaDownloadCheckpoint_t * checkpoint,
+                                       uint32_t firstBlock,
+                                       uint32_t endBlock,
+                                       uint32_t * runStart );
+
+/**
+ * @brief Count the blocks written.
+ *
+ * @param[in] checkpoint Checkpoint to check.
+ *
+ * @return Number of blocks written.
+ */
+uint32_t otaCheckpoint_GetReceivedBlockCount( const OtaDownloadCheckpoint_t * checkpoint );
+
+/**
+ * @brief Persist a checkpoint in protected storage, replacing any previous one.
+ *
+ * @param[in] checkpoint Checkpoint to persist.
+ *
+ * @return OtaCheckpointSuccess or OtaCheckpointStorageError.
+ */
+OtaCheckpointStatus_t otaCheckpoint_Save( const OtaDownloadCheckpoint_t * checkpoint );
+
+/**
+ * @brief Read the checkpoint persisted in protected storage.
+ *
+ * @param[out] checkpoint Checkpoint read, only valid on success.
+ *
+ * @return OtaCheckpointSuccess, OtaCheckpointNotFound, OtaCheckpointInvalid or
+ * OtaCheckpointStorageError.
+ */
+OtaCheckpointStatus_t otaCheckpoint_Load( OtaDownloadCheckpoint_t * checkpoint );
+
+/**
+ * @brief Remove the checkpoint persisted in protected storage, if any.
+ *
+ * @return OtaCheckpointSuccess or OtaCheckpointStorageError.
+ */
+OtaCheckpointStatus_t otaCheckpoint_Erase( void );
+
+#endif /* OTA_DOWNLOAD_CHECKPOINT_H */
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef OTA_FLASH_WRITER_H
+#define OTA_FLASH_WRITER_H
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Jobs Library include. */
+#include "ota_job_processor.h"
+
+/* Library config includes. */
+#include "ota_config.h"
+
+/**
+ * @brief Flash sector size of the staging area, see ota_config.h.
+ */
+#ifndef otaconfigFLASH_WRITE_SECTOR_SIZE
+    #define otaconfigFLASH_WRITE_SECTOR_SIZE    4096U
+#endif
+
+/**
+ * @brief Number of sector buffers, see ota_config.h.
+ */
+#ifndef otaconfigFLASH_WRITE_BUFFERS
+    #define otaconfigFLASH_WRITE_BUFFERS        2U
+#endif
+
+/**
+ * @brief Create the task programming the image into flash. Called once,
+ * before any other function of this file.
+ *
+ * @return true on success, otherwise false.
+ */
+bool otaFlashWriter_Init( void );
+
+/**
+ * @brief Start writing an image opened with otaPal_CreateFileForRx().
+ *
+ * Any write of a previous image still in progress is discarded.
+ *
+ * @param[in] fileContext Image to write to.
+ * @param[in] startOffset Offset of the first byte to be written.
+ */
+void otaFlashWriter_Start( AfrOtaJobDocumentFields_t * fileContext,
+                           uint32_t startOffset );
+
+/**
+ * @brief Queue data following the data already queued to be written.
+ *
+ * The data is copied into sector aligned buffers, which the writer task
+ * programs while the caller goes on receiving. This only blocks once every
+ * buffer is waiting to be programmed.
+ *
+ * @param[in] data Data to write.
+ * @param[in] length Length of data.
+ *
+ * @return false if a write failed, otherwise true.
+ */
+bool otaFlashWriter_Write( const uint8_t * data,
+                           size_t length );
+
+/**
+ * @brief Write the data still queued and wait until it is in flash.
+ *
+ * @return true if all the data queued since otaFlashWriter_Start() has been
+ * written, otherwise false.
+ */
+bool otaFlashWriter_Finish( void );
+
+/**
+ * @brief Wait for the write in progress, if any, and discard the data queued.
+ */
+void otaFlashWriter_Abort( void );
+
+/**
+ * @brief Get the offset up to which the image is known to be in flash.
+ *
+ * @return Offset following the last byte written.
+ */
+uint32_t otaFlashWriter_GetWrittenOffset( void );
+
+#endif /* OTA_FLASH_WRITER_H */
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef OTA_IMAGE_HEADER_H
+#define OTA_IMAGE_HEADER_H
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Magic number starting the MCUboot header of a signed image.
+ */
+#define OTA_IMAGE_HEADER_MAGIC    0x96F3B83DUL
+
+/**
+ * @brief Size of the fixed part of the MCUboot image header in bytes.
+ */
+#define OTA_IMAGE_HEADER_SIZE     32U
+
+/**
+ * @brief Version of a signed image, as major.minor.revision+buildNum.
+ */
+typedef struct OtaImageVersion
+{
+    uint8_t major;
+    uint8_t minor;
+    uint16_t revision;
+    uint32_t buildNum;
+} OtaImageVersion_t;
+
+/**
+ * @brief Fields of the MCUboot image header, stored little endian.
+ */
+typedef struct OtaImageHeader
+{
+    uint32_t loadAddress;      /*!< Address the image is loaded at, if any. */
+    uint16_t headerSize;       /*!< Size of the header padding the image starts after. */
+    uint32_t imageSize;        /*!< Size of the image following the header. */
+    OtaImageVersion_t version; /*!< Version of the image. */
+} OtaImageHeader_t;
+
+/**
+ * @brief Parse the MCUboot header at the start of a signed image.
+ *
+ * @param[in] data First bytes of the image.
+ * @param[in] length Length of data, at least OTA_IMAGE_HEADER_SIZE.
+ * @param[out] header Parsed header.
+ *
+ * @return true if data starts with a valid header, otherwise false.
+ */
+bool otaImageHeader_Parse( const uint8_t * data,
+                           size_t length,
+                           OtaImageHeader_t * header );
+
+/**
+ * @brief Compare two image versions the way MCUboot does.
+ *
+ * @param[in] version Version to compare.
+ * @param[in] reference Version to compare it to.
+ *
+ * @return A negative value, zero or a positive value if version is lower than,
+ * equal to or higher than reference.
+ */
+int32_t otaImageHeader_CompareVersions( const OtaImageVersion_t * version,
+                                        const OtaImageVersion_t * reference );
+
+#endif /* OTA_IMAGE_HEADER_H */
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef OTA_MODEL_INSTALL_H
+#define OTA_MODEL_INSTALL_H
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Maximum length of the ID of the job of a pending model install.
+ */
+#define OTA_MODEL_INSTALL_MAX_JOB_ID_LENGTH    64U
+
+/**
+ * @brief A model-only update reloaded at runtime, waiting for MCUboot to
+ * install it in flash.
+ *
+ * psa_fwu_install() leaves the model component STAGED and the job
+ * IN_PROGRESS until the device reboots. No other image can be staged in the
+ * meantime, and only the self test after the reboot completes the job. The
+ * device is therefore rebooted once the application is idle, or before any
+ * other job is started.
+ */
+typedef struct OtaModelInstall
+{
+    bool pending;                                         /*!< A model was installed and the reboot is due. */
+    char jobId[ OTA_MODEL_INSTALL_MAX_JOB_ID_LENGTH ];    /*!< ID of the job of the model, not NUL terminated. */
+    size_t jobIdLength;                                   /*!< Length of jobId. */
+} OtaModelInstall_t;
+
+/**
+ * @brief What the OTA agent does about a pending model install.
+ */
+typedef enum OtaModelInstallAction
+{
+    OtaModelInstallNone = 0, /*!< No install is pending, carry on. */
+    OtaModelInstallWait,     /*!< Leave the job to the self test after the reboot. */
+    OtaModelInstallReboot    /*!< Reboot now, so that MCUboot installs the model. */
+} OtaModelInstallAction_t;
+
+/**
+ * @brief Start without a pending install.
+ *
+ * @param[out] install The install state.
+ */
+void otaModelInstall_Init( OtaModelInstall_t * install );
+
+/**
+ * @brief Record that the model of a job was installed with psa_fwu_install().
+ *
+ * @param[in, out] install The install state.
+ * @param[in] jobId ID of the job of the model.
+ * @param[in] jobIdLength Length of jobId, at most
+ * OTA_MODEL_INSTALL_MAX_JOB_ID_LENGTH.
+ *
+ * @return true if the install is recorded, false if the job ID is too long.
+ */
+bool otaModelInstall_Staged( OtaModelInstall_t * install,
+                             const char * jobId,
+                             size_t jobIdLength );
+
+/**
+ * @brief Decide what to do with a job document.
+ *
+ * The job of the pending model is left to the self test. Any other job is
+ * only started after the reboot, so the device is rebooted first.
+ *
+ * @param[in] install The install state.
+ * @param[in] jobId ID of the job of the document.
+ * @param[in] jobIdLength Length of jobId.
+ *
+ * @return The action.
+ */
+OtaModelInstallAction_t otaModelInstall_OnJobDocument( const OtaModelInstall_t * install,
+                                                       const char * jobId,
+                                                       size_t jobIdLength );
+
+/**
+ * @brief Decide whether to reboot while the OTA agent has nothing to do.
+ *
+ * @param[in] install The install state.
+ * @param[in] applicationIdle The application can be rebooted without
+ * interrupting its work.
+ *
+ * @return OtaModelInstallReboot if an install is pending and the application
+ * is idle, OtaModelInstallWait if it is busy, otherwise OtaModelInstallNone.
+ */
+OtaModelInstallAction_t otaModelInstall_OnIdle( const OtaModelInstall_t * install,
+                                                bool applicationIdle );
+
+#endif /* OTA_MODEL_INSTALL_H */
@@ -48,4 +48,21 @@ bool jobDocumentParser( char * message,
                         size_t messageLength,
                         AfrOtaJobDocumentFields_t * jobFields );
 
+/**
+ * @brief Convert a DER encoded ECDSA signature into the concatenation of its
+ * r and s values, the format expected by psa_verify_hash().
+ *
+ * @param[in] der The DER encoded signature.
+ * @param[in] derLength Length of the DER encoded signature.
+ * @param[out] raw The destination buffer, at least 2 * coordinateLength long.
+ * @param[in] coordinateLength Length of r and s in the raw format, i.e. the
+ * size of the curve in bytes.
+ *
+ * @return true if the signature was successfully converted, otherwise false.
+ */
+bool convertEcdsaSignatureToRaw( const uint8_t * der,
+                                 size_t derLength,
+                                 uint8_t * raw,
+                                 size_t coordinateLength );
+
 #endif /* OTA_ORCHESTRATOR_HELPERS_H */
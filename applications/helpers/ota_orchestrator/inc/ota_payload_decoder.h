@@ -0,0 +1,220 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef OTA_PAYLOAD_DECODER_H
+#define OTA_PAYLOAD_DECODER_H
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Magic number starting an encoded payload, "OTAP" in file order.
+ *
+ * A file starting with anything else is a plain image.
+ */
+#define OTA_PAYLOAD_MAGIC                  0x5041544FUL
+
+/**
+ * @brief Version of the payload header layout.
+ */
+#define OTA_PAYLOAD_VERSION                1U
+
+/**
+ * @brief Size of the payload header in bytes.
+ */
+#define OTA_PAYLOAD_HEADER_SIZE            48U
+
+/**
+ * @brief The payload is LZSS compressed.
+ */
+#define OTA_PAYLOAD_FLAG_COMPRESSED        0x01U
+
+/**
+ * @brief The payload is a delta against the running image.
+ */
+#define OTA_PAYLOAD_FLAG_DELTA             0x02U
+
+/**
+ * @brief Largest LZSS window supported, as a power of two. The window is the
+ * only buffer the decompression needs.
+ */
+#define OTA_PAYLOAD_MAX_WINDOW_BITS        12U
+
+/**
+ * @brief Size of the buffers batching source reads and the decoded output
+ * that is not written straight from the payload.
+ */
+#define OTA_PAYLOAD_CHUNK_SIZE             64U
+
+/**
+ * @brief Length of the SHA-256 digest of the delta source.
+ */
+#define OTA_PAYLOAD_SOURCE_DIGEST_LENGTH   32U
+
+/**
+ * @brief Header of an encoded payload, stored little endian.
+ */
+typedef struct OtaPayloadHeader
+{
+    uint32_t magic;                                              /*!< OTA_PAYLOAD_MAGIC. */
+    uint8_t version;                                             /*!< OTA_PAYLOAD_VERSION. */
+    uint8_t flags;                                               /*!< OTA_PAYLOAD_FLAG_* bits. */
+    uint8_t windowBits;                                          /*!< LZSS window size, as a power of two. */
+    uint8_t lookaheadBits;                                       /*!< LZSS match length field width. */
+    uint32_t imageSize;                                          /*!< Size of the decoded image. */
+    uint32_t sourceSize;                                         /*!< Size of the delta source. */
+    uint8_t sourceDigest[ OTA_PAYLOAD_SOURCE_DIGEST_LENGTH ];    /*!< SHA-256 of the delta source. */
+} OtaPayloadHeader_t;
+
+/**
+ * @brief Functions the decoder reads the delta source and writes the image
+ * through.
+ */
+typedef struct OtaPayloadInterface
+{
+    /**
+     * @brief Consume decoded image data, in image order.
+     *
+     * Plain images, stored payloads and the INSERT commands of uncompressed
+     * deltas are passed straight from the data given to otaPayload_Decode(),
+     * in spans of any length. Other decoded data is passed in chunks of up to
+     * OTA_PAYLOAD_CHUNK_SIZE bytes.
+     *
+     * @return true on success, false to fail the decoding.
+     */
+    bool ( * writeImage )( const uint8_t * data,
+                           size_t length,
+                           void * context );
+
+    /**
+     * @brief Check that the running image is the source a delta was made
+     * against, before any of it is read.
+     *
+     * @return true if it is, false to fail the decoding.
+     */
+    bool ( * checkSource )( const OtaPayloadHeader_t * header,
+                            void * context );
+
+    /**
+     * @brief Read bytes of the running image a delta is applied to.
+     *
+     * @return true on success, false to fail the decoding.
+     */
+    bool ( * readSource )( uint32_t offset,
+                           uint8_t * data,
+                           size_t length,
+                           void * context );
+
+    void * context; /*!< Context passed to every function. */
+} OtaPayloadInterface_t;
+
+/**
+ * @brief State of the streaming payload decoder.
+ *
+ * Its size is bounded by OTA_PAYLOAD_MAX_WINDOW_BITS whatever the size of the
+ * image.
+ */
+typedef struct OtaPayloadDecoder
+{
+    const OtaPayloadInterface_t * callbacks;
+    bool failed;
+    bool passthrough;
+    bool headerParsed;
+
+    uint8_t headerBytes[ OTA_PAYLOAD_HEADER_SIZE ];
+    size_t headerFill;
+    OtaPayloadHeader_t header;
+    uint32_t imageBytes;
+
+    /* LZSS decompression. */
+    uint8_t window[ 1U << OTA_PAYLOAD_MAX_WINDOW_BITS ];
+    uint32_t windowHead;
+    uint32_t bitBuffer;
+    uint8_t bitCount;
+    uint8_t lzssState;
+    uint32_t backrefIndex;
+
+    /* Delta application. */
+    uint8_t deltaState;
+    uint8_t deltaOpcode;
+    uint32_t deltaOperand;
+    uint8_t deltaOperandShift;
+    uint32_t deltaRemaining;
+    uint32_t sourceOffset;
+    uint8_t sourceChunk[ OTA_PAYLOAD_CHUNK_SIZE ];
+    uint32_t sourceChunkOffset;
+    size_t sourceChunkLength;
+
+    /* Decoded output waiting to be written. */
+    uint8_t outputChunk[ OTA_PAYLOAD_CHUNK_SIZE ];
+    size_t outputFill;
+
+    uint32_t copiedBytes; /*!< Bytes copied into headerBytes and outputChunk. */
+} OtaPayloadDecoder_t;
+
+/**
+ * @brief Start decoding a payload.
+ *
+ * @param[out] decoder Decoder to initialize.
+ * @param[in] callbacks Functions to write the image and read the delta source.
+ * @param[in] atFileStart false when the download resumes past the start of the
+ * file, in which case the file is written as is.
+ */
+void otaPayload_Init( OtaPayloadDecoder_t * decoder,
+                      const OtaPayloadInterface_t * callbacks,
+                      bool atFileStart );
+
+/**
+ * @brief Decode the next bytes of the payload, in file order.
+ *
+ * @param[in,out] decoder Decoder to feed.
+ * @param[in] data Payload bytes.
+ * @param[in] length Length of data.
+ *
+ * @return false if the payload is invalid or an interface function failed,
+ * now or earlier, otherwise true.
+ */
+bool otaPayload_Decode( OtaPayloadDecoder_t * decoder,
+                        const uint8_t * data,
+                        size_t length );
+
+/**
+ * @brief Write the decoded data still buffered, once the whole file has been
+ * decoded.
+ *
+ * @param[in,out] decoder Decoder to finish.
+ *
+ * @return true if the whole image has been written, otherwise false.
+ */
+bool otaPayload_Finish( OtaPayloadDecoder_t * decoder );
+
+/**
+ * @brief Check whether the file is an encoded payload rather than an image.
+ *
+ * @param[in] decoder Decoder to check.
+ *
+ * @return true once the header of an encoded payload has been decoded.
+ */
+bool otaPayload_IsEncoded( const OtaPayloadDecoder_t * decoder );
+
+/**
+ * @brief Get the number of bytes the decoder copied rather than passed
+ * straight to OtaPayloadInterface_t::writeImage.
+ *
+ * @param[in] decoder Decoder to check.
+ *
+ * @return The bytes held while looking for the header, plus the decoded bytes
+ * buffered in the output chunk.
+ */
+uint32_t otaPayload_GetCopiedBytes( const OtaPayloadDecoder_t * decoder );
+
+#endif /* OTA_PAYLOAD_DECODER_H */
@@ -52,6 +52,14 @@
  */
 #define otaexampleMAX_UINT32              ( 0xffffffff )
 
+/**
+ * @brief MQTT agent connection that carries the OTA job and file stream traffic.
+ *
+ * File blocks are routed over the bulk connection so that a large download
+ * does not delay control traffic queued on the control connection.
+ */
+#define otaexampleMQTT_AGENT_CONNECTION   eMqttAgentConnectionBulk
+
 /**
  * @brief Starting index of client identifier within OTA topic.
  */
@@ -67,6 +75,16 @@
  */
 #define OTA_AGENT_TASK_PRIORITY      ( tskIDLE_PRIORITY + 1 )
 
+/**
+ * @brief Stack size required for the task writing the image to flash.
+ */
+#define OTA_FLASH_WRITER_TASK_STACK_SIZE    ( 1024U )
+
+/**
+ * @brief Priority of the task writing the image to flash.
+ */
+#define OTA_FLASH_WRITER_TASK_PRIORITY      ( tskIDLE_PRIORITY + 1 )
+
 /* Max bytes supported for a file signature (3072 bit RSA is 384 bytes). */
 #define OTA_MAX_SIGNATURE_SIZE       ( 384U )
 
@@ -126,11 +144,21 @@ typedef enum OtaState
  * @brief  The OTA Agent event and data structures.
  */
 
+/**
+ * @brief A decoded file block loaned from the OTA data buffer pool.
+ *
+ * The block is decoded straight from the MQTT agent network buffer into
+ * `data` by the subscription callback, so the OTA agent task can write it to
+ * flash without any further copy. Ownership of the buffer passes to the OTA
+ * agent task with the event and returns to the pool once the block is written.
+ */
 typedef struct OtaDataEvent
 {
-    uint8_t data[ OTA_DATA_BLOCK_SIZE * 2 ]; /*!< Buffer for storing event information. */
-    size_t dataLength;                       /*!< Total space required for the event. */
-    bool bufferUsed;                         /*!< Flag set when buffer is used otherwise cleared. */
+    uint8_t data[ OTA_DATA_BLOCK_SIZE ]; /*!< Decoded file block. */
+    size_t dataLength;                   /*!< Number of valid bytes in data. */
+    int32_t fileId;                      /*!< File ID the block belongs to. */
+    int32_t blockId;                     /*!< Index of the block within the file. */
+    bool bufferUsed;                     /*!< Flag set when buffer is used otherwise cleared. */
 } OtaDataEvent_t;
 
 typedef struct OtaJobEventData
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef OTA_WRITE_COMBINER_H
+#define OTA_WRITE_COMBINER_H
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Hand a filled buffer over to be written to flash.
+ *
+ * @param[in] buffer Data to write, owned by the callee until it is written.
+ * @param[in] offset Offset of the data within the image.
+ * @param[in] length Number of bytes to write.
+ * @param[in] context Context given to otaWriteCombiner_Init().
+ *
+ * @return Empty buffer of at least one sector to fill next, or NULL if the
+ * data cannot be written.
+ */
+typedef uint8_t * ( * OtaWriteCombinerSubmit_t )( uint8_t * buffer,
+                                                  uint32_t offset,
+                                                  size_t length,
+                                                  void * context );
+
+/**
+ * @brief Accumulates image data written in file order into sector aligned
+ * chunks.
+ *
+ * Each chunk ends on a sector boundary, so every chunk but the first and last
+ * covers exactly one sector.
+ */
+typedef struct OtaWriteCombiner
+{
+    uint8_t * buffer;                /*!< Buffer being filled, NULL once a submit failed. */
+    size_t sectorSize;               /*!< Flash sector size in bytes. */
+    uint32_t bufferOffset;           /*!< Image offset of the first byte of buffer. */
+    size_t bufferFill;               /*!< Number of bytes held in buffer. */
+    OtaWriteCombinerSubmit_t submit; /*!< Callback writing a filled buffer. */
+    void * context;                  /*!< Context passed to submit. */
+} OtaWriteCombiner_t;
+
+/**
+ * @brief Start combining the data written from an image offset.
+ *
+ * @param[out] combiner Combiner to initialize.
+ * @param[in] sectorSize Flash sector size in bytes.
+ * @param[in] startOffset Image offset of the first byte to be appended.
+ * @param[in] buffer Empty buffer of at least sectorSize bytes to fill first.
+ * @param[in] submit Callback writing a filled buffer.
+ * @param[in] context Context passed to submit.
+ */
+void otaWriteCombiner_Init( OtaWriteCombiner_t * combiner,
+                            size_t sectorSize,
+                            uint32_t startOffset,
+                            uint8_t * buffer,
+                            OtaWriteCombinerSubmit_t submit,
+                            void * context );
+
+/**
+ * @brief Append data following the data already appended, submitting every
+ * buffer that reaches a sector boundary.
+ *
+ * @param[in,out] combiner Combiner to append to.
+ * @param[in] data Data to append.
+ * @param[in] length Length of data.
+ *
+ * @return false if a submit failed, now or earlier, otherwise true.
+ */
+bool otaWriteCombiner_Append( OtaWriteCombiner_t * combiner,
+                              const uint8_t * data,
+                              size_t length );
+
+/**
+ * @brief Submit the data held short of a sector boundary, at the end of the
+ * image.
+ *
+ * @param[in,out] combiner Combiner to flush.
+ *
+ * @return false if a submit failed, now or earlier, otherwise true.
+ */
+bool otaWriteCombiner_Flush( OtaWriteCombiner_t * combiner );
+
+#endif /* OTA_WRITE_COMBINER_H */
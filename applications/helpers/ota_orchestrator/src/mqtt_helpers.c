@@ -33,12 +33,6 @@
     #define STATIC    static
 #endif /* UNIT_TESTING */
 
-/**
- * @brief The MQTT agent manages the MQTT contexts. It will set this handle to
- * the context used by this demo.
- */
-extern MQTTAgentContext_t xGlobalMqttAgentContext;
-
 STATIC void prvMQTTSubscribeCompleteCallback( MQTTAgentCommandContext_t * pxCommandContext,
                                               MQTTAgentReturnInfo_t * pxReturnInfo )
 {
@@ -120,7 +114,7 @@ OtaMqttStatus_t prvMQTTSubscribe( const char * pTopicFilter,
 
     xTaskNotifyStateClear( NULL );
 
-    mqttStatus = MQTTAgent_Subscribe( &xGlobalMqttAgentContext,
+    mqttStatus = MQTTAgent_Subscribe( pxGetMqttAgentContext( otaexampleMQTT_AGENT_CONNECTION ),
                                       &xSubscribeArgs,
                                       &xCommandParams );
 
@@ -183,7 +177,7 @@ OtaMqttStatus_t prvMQTTPublish( const char * const pacTopic,
     xCommandParams.cmdCompleteCallback = prvOTAPublishCommandCallback;
     xCommandParams.pCmdCompleteCallbackContext = ( void * ) &xCommandContext;
 
-    mqttStatus = MQTTAgent_Publish( &xGlobalMqttAgentContext,
+    mqttStatus = MQTTAgent_Publish( pxGetMqttAgentContext( otaexampleMQTT_AGENT_CONNECTION ),
                                     &publishInfo,
                                     &xCommandParams );
 
@@ -252,7 +246,7 @@ OtaMqttStatus_t prvMQTTUnsubscribe( const char * pTopicFilter,
     xTaskNotifyStateClear( NULL );
 
 
-    mqttStatus = MQTTAgent_Unsubscribe( &xGlobalMqttAgentContext,
+    mqttStatus = MQTTAgent_Unsubscribe( pxGetMqttAgentContext( otaexampleMQTT_AGENT_CONNECTION ),
                                         &xSubscribeArgs,
                                         &xCommandParams );
 
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "psa/crypto.h"
+#include "psa/error.h"
+
+#include "ota_delta_source.h"
+
+bool otaDeltaSource_Matches( const OtaPayloadHeader_t * header,
+                             const uint8_t * slot,
+                             size_t slotSize )
+{
+    uint8_t digest[ OTA_PAYLOAD_SOURCE_DIGEST_LENGTH ];
+    size_t digestLength = 0U;
+
+    return ( header != NULL ) &&
+           ( slot != NULL ) &&
+           ( header->sourceSize <= slotSize ) &&
+           ( psa_hash_compute( PSA_ALG_SHA_256,
+                               slot,
+                               header->sourceSize,
+                               digest,
+                               sizeof( digest ),
+                               &digestLength ) == PSA_SUCCESS ) &&
+           ( digestLength == sizeof( header->sourceDigest ) ) &&
+           ( memcmp( digest, header->sourceDigest, digestLength ) == 0 );
+}
+
+bool otaDeltaSource_Read( const uint8_t * slot,
+                          size_t slotSize,
+                          uint32_t offset,
+                          uint8_t * data,
+                          size_t length )
+{
+    bool read = false;
+
+    if( ( slot != NULL ) &&
+        ( data != NULL ) &&
+        ( offset <= slotSize ) &&
+        ( length <= slotSize - offset ) )
+    {
+        ( void ) memcpy( data, slot + offset, length );
+        read = true;
+    }
+
+    return read;
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* TF-M protected storage include. */
+#include "psa/protected_storage.h"
+
+#include "ota_config.h"
+#include "ota_download_checkpoint.h"
+
+/**
+ * @brief Protected storage UID of the download checkpoint, see ota_config.h.
+ */
+#ifndef otaconfigCHECKPOINT_STORAGE_UID
+    #define otaconfigCHECKPOINT_STORAGE_UID    ( 0x4F544143UL )
+#endif
+
+/**
+ * @brief Layout version of OtaDownloadCheckpoint_t. A checkpoint stored with
+ * another layout is ignored.
+ */
+#define OTA_CHECKPOINT_VERSION                 ( 2U )
+
+void otaCheckpoint_Reset( OtaDownloadCheckpoint_t * checkpoint,
+                          const char * jobId,
+                          size_t jobIdLength,
+                          int32_t fileId,
+                          uint32_t fileSize )
+{
+    ( void ) memset( checkpoint, 0, sizeof( *checkpoint ) );
+
+    if( jobIdLength >= sizeof( checkpoint->jobId ) )
+    {
+        jobIdLength = sizeof( checkpoint->jobId ) - 1U;
+    }
+
+    ( void ) memcpy( checkpoint->jobId, jobId, jobIdLength );
+    checkpoint->version = OTA_CHECKPOINT_VERSION;
+    checkpoint->fileId = fileId;
+    checkpoint->fileSize = fileSize;
+}
+
+bool otaCheckpoint_MatchesJob( const OtaDownloadCheckpoint_t * checkpoint,
+                               const char * jobId,
+                               size_t jobIdLength,
+                               int32_t fileId,
+                               uint32_t fileSize )
+{
+    return ( checkpoint->version == OTA_CHECKPOINT_VERSION ) &&
+           ( jobIdLength < sizeof( checkpoint->jobId ) ) &&
+           ( strncmp( checkpoint->jobId, jobId, jobIdLength ) == 0 ) &&
+           ( checkpoint->jobId[ jobIdLength ] == '\0' ) &&
+           ( checkpoint->fileId == fileId ) &&
+           ( checkpoint->fileSize == fileSize );
+}
+
+bool otaCheckpoint_IsBlockReceived( const OtaDownloadCheckpoint_t * checkpoint,
+                                    uint32_t blockId )
+{
+    bool received = false;
+
+    if( blockId < checkpoint->windowBaseBlock )
+    {
+        received = true;
+    }
+    else if( ( blockId - checkpoint->windowBaseBlock ) < OTA_CHECKPOINT_WINDOW_BLOCKS )
+    {
+        received = ( checkpoint->windowReceivedBitmap &
+                     ( 1UL << ( blockId - checkpoint->windowBaseBlock ) ) ) != 0U;
+    }
+    else
+    {
+        /* Past the tracked window, never written. */
+    }
+
+    return received;
+}
+
+bool otaCheckpoint_MarkBlockReceived( OtaDownloadCheckpoint_t * checkpoint,
+                                      uint32_t blockId,
+                                      uint32_t blockLength )
+{
+    bool marked = false;
+
+    if( ( blockId >= checkpoint->windowBaseBlock ) &&
+        ( ( blockId - checkpoint->windowBaseBlock ) < OTA_CHECKPOINT_WINDOW_BLOCKS ) &&
+        ( otaCheckpoint_IsBlockReceived( checkpoint, blockId ) == false ) )
+    {
+        checkpoint->windowReceivedBitmap |= ( 1UL << ( blockId - checkpoint->windowBaseBlock ) );
+        checkpoint->bytesReceived += blockLength;
+        marked = true;
+
+        /* Slide the window past every block received in order. */
+        while( ( checkpoint->windowReceivedBitmap & 1UL ) != 0U )
+        {
+            checkpoint->windowReceivedBitmap >>= 1;
+            checkpoint->windowBaseBlock++;
+        }
+    }
+
+    return marked;
+}
+
+uint32_t otaCheckpoint_GetWindowEnd( const OtaDownloadCheckpoint_t * checkpoint,
+                                     uint32_t windowBlocks,
+                                     uint32_t totalBlocks )
+{
+    uint32_t windowEnd = totalBlocks;
+
+    if( ( checkpoint->windowBaseBlock < totalBlocks ) &&
+        ( ( totalBlocks - checkpoint->windowBaseBlock ) > windowBlocks ) )
+    {
+        windowEnd = checkpoint->windowBaseBlock + windowBlocks;
+    }
+
+    return windowEnd;
+}
+
+uint32_t otaCheckpoint_FindMissingRun( const OtaDownloadCheckpoint_t * checkpoint,
+                                       uint32_t firstBlock,
+                                       uint32_t endBlock,
+                                       uint32_t * runStart )
+{
+    uint32_t blockIndex = firstBlock;
+    uint32_t runLength = 0U;
+
+    while( ( blockIndex < endBlock ) &&
+           otaCheckpoint_IsBlockReceived( checkpoint, blockIndex ) )
+    {
+        blockIndex++;
+    }
+
+    if( blockIndex < endBlock )
+    {
+        *runStart = blockIndex;
+
+        while( ( blockIndex < endBlock ) &&
+               ( otaCheckpoint_IsBlockReceived( checkpoint, blockIndex ) == false ) )
+        {
+            blockIndex++;
+            runLength++;
+        }
+    }
+
+    return runLength;
+}
+
+uint32_t otaCheckpoint_GetReceivedBlockCount( const OtaDownloadCheckpoint_t * checkpoint )
+{
+    uint32_t count = checkpoint->windowBaseBlock;
+    uint32_t bitmap = checkpoint->windowReceivedBitmap;
+
+    while( bitmap != 0U )
+    {
+        count += bitmap & 1UL;
+        bitmap >>= 1;
+    }
+
+    return count;
+}
+
+OtaCheckpointStatus_t otaCheckpoint_Save( const OtaDownloadCheckpoint_t * checkpoint )
+{
+    OtaCheckpointStatus_t status = OtaCheckpointSuccess;
+
+    if( psa_ps_set( otaconfigCHECKPOINT_STORAGE_UID,
+                    sizeof( *checkpoint ),
+                    checkpoint,
+                    PSA_STORAGE_FLAG_NONE ) != PSA_SUCCESS )
+    {
+        status = OtaCheckpointStorageError;
+    }
+
+    return status;
+}
+
+OtaCheckpointStatus_t otaCheckpoint_Load( OtaDownloadCheckpoint_t * checkpoint )
+{
+    OtaCheckpointStatus_t status = OtaCheckpointSuccess;
+    psa_status_t psaStatus;
+    size_t readLength = 0U;
+
+    psaStatus = psa_ps_get( otaconfigCHECKPOINT_STORAGE_UID,
+                            0U,
+                            sizeof( *checkpoint ),
+                            checkpoint,
+                            &readLength );
+
+    if( psaStatus == PSA_ERROR_DOES_NOT_EXIST )
+    {
+        status = OtaCheckpointNotFound;
+    }
+    else if( psaStatus != PSA_SUCCESS )
+    {
+        status = OtaCheckpointStorageError;
+    }
+    else if( ( readLength != sizeof( *checkpoint ) ) ||
+             ( checkpoint->version != OTA_CHECKPOINT_VERSION ) )
+    {
+        status = OtaCheckpointInvalid;
+    }
+    else
+    {
+        /* The job ID is compared as a string, never trust its terminator. */
+        checkpoint->jobId[ sizeof( checkpoint->jobId ) - 1U ] = '\0';
+    }
+
+    return status;
+}
+
+OtaCheckpointStatus_t otaCheckpoint_Erase( void )
+{
+    OtaCheckpointStatus_t status = OtaCheckpointSuccess;
+    psa_status_t psaStatus;
+
+    psaStatus = psa_ps_remove( otaconfigCHECKPOINT_STORAGE_UID );
+
+    if( ( psaStatus != PSA_SUCCESS ) && ( psaStatus != PSA_ERROR_DOES_NOT_EXIST ) )
+    {
+        status = OtaCheckpointStorageError;
+    }
+
+    return status;
+}
@@ -0,0 +1,331 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Library config includes. */
+#include "ota_config.h"
+
+/* Include platform abstraction header. */
+#include "ota_pal.h"
+
+#include "ota_flash_writer.h"
+#include "ota_types_definitions.h"
+#include "ota_write_combiner.h"
+
+/* Include header that defines log levels. */
+#include "logging_levels.h"
+
+/* Configure name and log level for the OTA library. */
+#ifndef LIBRARY_LOG_NAME
+    #define LIBRARY_LOG_NAME     "OTA"
+#endif
+#ifndef LIBRARY_LOG_LEVEL
+    #define LIBRARY_LOG_LEVEL    LOG_INFO
+#endif
+#include "logging_stack.h"
+
+#if ( otaconfigFLASH_WRITE_BUFFERS < 2 )
+    #error "otaconfigFLASH_WRITE_BUFFERS must be at least 2 to fill a buffer while another one is written."
+#endif
+
+/* otaPal_WriteBlock() returns the number of bytes written as an int16_t. */
+#if ( otaconfigFLASH_WRITE_SECTOR_SIZE < 1 ) || ( otaconfigFLASH_WRITE_SECTOR_SIZE > 0x7FFF )
+    #error "otaconfigFLASH_WRITE_SECTOR_SIZE must be between 1 and 32767."
+#endif
+
+/**
+ * @brief Sector aligned chunk of the image waiting to be written.
+ */
+typedef struct OtaFlashWriteRequest
+{
+    uint8_t * buffer;
+    uint32_t offset;
+    size_t length;
+} OtaFlashWriteRequest_t;
+
+/**
+ * @brief Buffers holding the image data until it is written.
+ */
+static uint8_t sectorBuffers[ otaconfigFLASH_WRITE_BUFFERS ][ otaconfigFLASH_WRITE_SECTOR_SIZE ];
+
+/**
+ * @brief Buffers free to be filled.
+ */
+static QueueHandle_t freeBufferQueue = NULL;
+
+/**
+ * @brief Filled buffers, in the order they are written.
+ */
+static QueueHandle_t writeRequestQueue = NULL;
+
+/**
+ * @brief Combines the data queued into the buffers.
+ */
+static OtaWriteCombiner_t writeCombiner = { 0 };
+
+/**
+ * @brief Image being written.
+ */
+static AfrOtaJobDocumentFields_t * imageFileContext = NULL;
+
+/**
+ * @brief Set once a write of the current image failed. Later requests are
+ * discarded.
+ */
+static volatile bool writeFailed = false;
+
+/**
+ * @brief Offset following the last byte written, updated by the writer task.
+ */
+static volatile uint32_t writtenOffset = 0;
+
+/**
+ * @brief Write statistics of the current image, updated by the writer task.
+ */
+static volatile uint32_t bytesWritten = 0;
+static volatile uint32_t writeCount = 0;
+static volatile TickType_t writeTicks = 0;
+
+/**
+ * @brief Tick count when the current image was started.
+ */
+static TickType_t startTick = 0;
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Write the requests in the order they are queued.
+ *
+ * @param[in] pvParam Unused.
+ */
+static void prvFlashWriterTask( void * pvParam );
+
+/**
+ * @brief Queue a filled buffer to the writer task, and take a free one.
+ *
+ * Implements OtaWriteCombinerSubmit_t.
+ */
+static uint8_t * prvSubmitWrite( uint8_t * buffer,
+                                 uint32_t offset,
+                                 size_t length,
+                                 void * context );
+
+/**
+ * @brief Wait until the writer task has returned every buffer not held by the
+ * write combiner.
+ */
+static void prvWaitUntilIdle( void );
+
+/* -------------------------------------------------------------------------- */
+
+static void prvFlashWriterTask( void * pvParam )
+{
+    OtaFlashWriteRequest_t request;
+    TickType_t writeStartTick;
+    int16_t writeResult;
+
+    ( void ) pvParam;
+
+    for( ; ; )
+    {
+        if( xQueueReceive( writeRequestQueue, &request, portMAX_DELAY ) == pdTRUE )
+        {
+            if( writeFailed == false )
+            {
+                writeStartTick = xTaskGetTickCount();
+                writeResult = otaPal_WriteBlock( imageFileContext,
+                                                 request.offset,
+                                                 request.buffer,
+                                                 ( uint32_t ) request.length );
+                writeTicks += xTaskGetTickCount() - writeStartTick;
+
+                if( writeResult == ( int16_t ) request.length )
+                {
+                    bytesWritten += ( uint32_t ) request.length;
+                    writeCount++;
+                    writtenOffset = request.offset + ( uint32_t ) request.length;
+                }
+                else
+                {
+                    LogError( ( "Failed to write %u bytes of the image at offset %u.\n",
+                                ( unsigned int ) request.length,
+                                ( unsigned int ) request.offset ) );
+                    writeFailed = true;
+                }
+            }
+
+            ( void ) xQueueSendToBack( freeBufferQueue, &request.buffer, portMAX_DELAY );
+        }
+    }
+}
+
+static uint8_t * prvSubmitWrite( uint8_t * buffer,
+                                 uint32_t offset,
+                                 size_t length,
+                                 void * context )
+{
+    OtaFlashWriteRequest_t request = { buffer, offset, length };
+    uint8_t * nextBuffer = NULL;
+
+    ( void ) context;
+
+    if( ( writeFailed == false ) &&
+        ( xQueueSendToBack( writeRequestQueue, &request, portMAX_DELAY ) == pdTRUE ) )
+    {
+        /* Blocks only while every other buffer waits to be written. */
+        ( void ) xQueueReceive( freeBufferQueue, &nextBuffer, portMAX_DELAY );
+    }
+    else
+    {
+        ( void ) xQueueSendToBack( freeBufferQueue, &buffer, portMAX_DELAY );
+    }
+
+    return nextBuffer;
+}
+
+static void prvWaitUntilIdle( void )
+{
+    uint8_t * buffers[ otaconfigFLASH_WRITE_BUFFERS ];
+    uint32_t bufferCount = otaconfigFLASH_WRITE_BUFFERS;
+    uint32_t ulIndex;
+
+    if( writeCombiner.buffer != NULL )
+    {
+        bufferCount--;
+    }
+
+    for( ulIndex = 0; ulIndex < bufferCount; ulIndex++ )
+    {
+        ( void ) xQueueReceive( freeBufferQueue, &buffers[ ulIndex ], portMAX_DELAY );
+    }
+
+    for( ulIndex = 0; ulIndex < bufferCount; ulIndex++ )
+    {
+        ( void ) xQueueSendToBack( freeBufferQueue, &buffers[ ulIndex ], portMAX_DELAY );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool otaFlashWriter_Init( void )
+{
+    bool initialized = false;
+    uint8_t * buffer;
+
+    freeBufferQueue = xQueueCreate( otaconfigFLASH_WRITE_BUFFERS, sizeof( uint8_t * ) );
+    writeRequestQueue = xQueueCreate( otaconfigFLASH_WRITE_BUFFERS, sizeof( OtaFlashWriteRequest_t ) );
+
+    if( ( freeBufferQueue != NULL ) && ( writeRequestQueue != NULL ) )
+    {
+        for( uint32_t ulIndex = 0; ulIndex < otaconfigFLASH_WRITE_BUFFERS; ulIndex++ )
+        {
+            buffer = sectorBuffers[ ulIndex ];
+            ( void ) xQueueSendToBack( freeBufferQueue, &buffer, 0 );
+        }
+
+        initialized = ( xTaskCreate( prvFlashWriterTask,
+                                     "OTA Flash Writer",
+                                     OTA_FLASH_WRITER_TASK_STACK_SIZE,
+                                     NULL,
+                                     OTA_FLASH_WRITER_TASK_PRIORITY,
+                                     NULL ) == pdPASS );
+    }
+
+    if( initialized == false )
+    {
+        LogError( ( "Failed to create the OTA flash writer task.\n" ) );
+    }
+
+    return initialized;
+}
+
+void otaFlashWriter_Start( AfrOtaJobDocumentFields_t * fileContext,
+                           uint32_t startOffset )
+{
+    uint8_t * buffer = NULL;
+
+    otaFlashWriter_Abort();
+
+    imageFileContext = fileContext;
+    writeFailed = false;
+    writtenOffset = startOffset;
+    bytesWritten = 0;
+    writeCount = 0;
+    writeTicks = 0;
+    startTick = xTaskGetTickCount();
+
+    ( void ) xQueueReceive( freeBufferQueue, &buffer, portMAX_DELAY );
+    otaWriteCombiner_Init( &writeCombiner,
+                           otaconfigFLASH_WRITE_SECTOR_SIZE,
+                           startOffset,
+                           buffer,
+                           prvSubmitWrite,
+                           NULL );
+}
+
+bool otaFlashWriter_Write( const uint8_t * data,
+                           size_t length )
+{
+    return otaWriteCombiner_Append( &writeCombiner, data, length ) && ( writeFailed == false );
+}
+
+bool otaFlashWriter_Finish( void )
+{
+    bool flushed = otaWriteCombiner_Flush( &writeCombiner );
+    uint32_t elapsedMs;
+    uint32_t writeMs;
+
+    prvWaitUntilIdle();
+
+    elapsedMs = TICKS_TO_pdMS( xTaskGetTickCount() - startTick );
+    writeMs = TICKS_TO_pdMS( writeTicks );
+
+    /* Flash throughput is measured over the time spent programming, and the
+     * download throughput over the time since the image was opened. */
+    LogInfo( ( "Wrote %u bytes to flash in %u writes, %u ms programming (%u KiB/s), %u ms in total (%u KiB/s).\n",
+               ( unsigned int ) bytesWritten,
+               ( unsigned int ) writeCount,
+               ( unsigned int ) writeMs,
+               ( unsigned int ) ( ( ( uint64_t ) bytesWritten * 1000U ) /
+                                  ( 1024U * ( ( writeMs > 0U ) ? writeMs : 1U ) ) ),
+               ( unsigned int ) elapsedMs,
+               ( unsigned int ) ( ( ( uint64_t ) bytesWritten * 1000U ) /
+                                  ( 1024U * ( ( elapsedMs > 0U ) ? elapsedMs : 1U ) ) ) ) );
+
+    return flushed && ( writeFailed == false );
+}
+
+void otaFlashWriter_Abort( void )
+{
+    uint8_t * buffer = writeCombiner.buffer;
+
+    /* Requests still queued are dropped by the writer task. */
+    writeFailed = true;
+    prvWaitUntilIdle();
+
+    if( buffer != NULL )
+    {
+        writeCombiner.buffer = NULL;
+        ( void ) xQueueSendToBack( freeBufferQueue, &buffer, portMAX_DELAY );
+    }
+}
+
+uint32_t otaFlashWriter_GetWrittenOffset( void )
+{
+    return writtenOffset;
+}
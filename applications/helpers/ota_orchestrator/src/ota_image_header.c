@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ota_image_header.h"
+
+static uint16_t readLittleEndian16( const uint8_t * data )
+{
+    return ( uint16_t ) ( ( uint16_t ) data[ 0 ] | ( ( uint16_t ) data[ 1 ] << 8 ) );
+}
+
+static uint32_t readLittleEndian32( const uint8_t * data )
+{
+    return ( uint32_t ) data[ 0 ] |
+           ( ( uint32_t ) data[ 1 ] << 8 ) |
+           ( ( uint32_t ) data[ 2 ] << 16 ) |
+           ( ( uint32_t ) data[ 3 ] << 24 );
+}
+
+bool otaImageHeader_Parse( const uint8_t * data,
+                           size_t length,
+                           OtaImageHeader_t * header )
+{
+    bool parsed = false;
+
+    if( ( data != NULL ) &&
+        ( header != NULL ) &&
+        ( length >= OTA_IMAGE_HEADER_SIZE ) &&
+        ( readLittleEndian32( &data[ 0 ] ) == OTA_IMAGE_HEADER_MAGIC ) )
+    {
+        header->loadAddress = readLittleEndian32( &data[ 4 ] );
+        header->headerSize = readLittleEndian16( &data[ 8 ] );
+        header->imageSize = readLittleEndian32( &data[ 12 ] );
+        header->version.major = data[ 20 ];
+        header->version.minor = data[ 21 ];
+        header->version.revision = readLittleEndian16( &data[ 22 ] );
+        header->version.buildNum = readLittleEndian32( &data[ 24 ] );
+
+        /* The header padding includes the fixed part of the header. */
+        parsed = ( header->headerSize >= OTA_IMAGE_HEADER_SIZE );
+    }
+
+    return parsed;
+}
+
+int32_t otaImageHeader_CompareVersions( const OtaImageVersion_t * version,
+                                        const OtaImageVersion_t * reference )
+{
+    int32_t result;
+
+    if( version->major != reference->major )
+    {
+        result = ( version->major > reference->major ) ? 1 : -1;
+    }
+    else if( version->minor != reference->minor )
+    {
+        result = ( version->minor > reference->minor ) ? 1 : -1;
+    }
+    else if( version->revision != reference->revision )
+    {
+        result = ( version->revision > reference->revision ) ? 1 : -1;
+    }
+    else if( version->buildNum != reference->buildNum )
+    {
+        result = ( version->buildNum > reference->buildNum ) ? 1 : -1;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
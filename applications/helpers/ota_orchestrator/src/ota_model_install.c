@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ota_model_install.h"
+
+void otaModelInstall_Init( OtaModelInstall_t * install )
+{
+    if( install != NULL )
+    {
+        memset( install, 0, sizeof( *install ) );
+    }
+}
+
+bool otaModelInstall_Staged( OtaModelInstall_t * install,
+                             const char * jobId,
+                             size_t jobIdLength )
+{
+    bool staged = false;
+
+    if( ( install != NULL ) &&
+        ( jobId != NULL ) &&
+        ( jobIdLength <= sizeof( install->jobId ) ) )
+    {
+        memcpy( install->jobId, jobId, jobIdLength );
+        install->jobIdLength = jobIdLength;
+        install->pending = true;
+        staged = true;
+    }
+
+    return staged;
+}
+
+OtaModelInstallAction_t otaModelInstall_OnJobDocument( const OtaModelInstall_t * install,
+                                                       const char * jobId,
+                                                       size_t jobIdLength )
+{
+    OtaModelInstallAction_t action = OtaModelInstallNone;
+
+    if( ( install != NULL ) && install->pending )
+    {
+        if( ( jobId != NULL ) &&
+            ( jobIdLength == install->jobIdLength ) &&
+            ( memcmp( jobId, install->jobId, jobIdLength ) == 0 ) )
+        {
+            action = OtaModelInstallWait;
+        }
+        else
+        {
+            action = OtaModelInstallReboot;
+        }
+    }
+
+    return action;
+}
+
+OtaModelInstallAction_t otaModelInstall_OnIdle( const OtaModelInstall_t * install,
+                                                bool applicationIdle )
+{
+    OtaModelInstallAction_t action = OtaModelInstallNone;
+
+    if( ( install != NULL ) && install->pending )
+    {
+        action = applicationIdle ? OtaModelInstallReboot : OtaModelInstallWait;
+    }
+
+    return action;
+}
@@ -23,7 +23,9 @@
 #include "events.h"
 
 /* Includes for TF-M */
+#include "psa/crypto.h"
 #include "psa/update.h"
+#include "mbedtls/sha256.h"
 
 /* Includes for OTA PAL PSA */
 #include "version/application_version.h"
@@ -64,7 +66,13 @@
 /* OTA orchestrator includes*/
 #include "mqtt_helpers.h"
 #include "ota_config.h"
+#include "ota_delta_source.h"
+#include "ota_download_checkpoint.h"
+#include "ota_flash_writer.h"
+#include "ota_image_header.h"
+#include "ota_model_install.h"
 #include "ota_orchestrator_helpers.h"
+#include "ota_payload_decoder.h"
 #include "ota_register_callback.h"
 #include "ota_types_definitions.h"
 
@@ -80,14 +88,32 @@
 #endif
 #include "logging_stack.h"
 
-#define NUM_OF_BLOCKS_REQUESTED    1U
 #define START_JOB_MSG_LENGTH       147U
-#define MAX_JOB_ID_LENGTH          64U
+#define MAX_JOB_ID_LENGTH          OTA_CHECKPOINT_MAX_JOB_ID_LENGTH
 #define UPDATE_JOB_MSG_LENGTH      128U
 
 extern void vOtaNotActiveHook( void );
 extern void vOtaActiveHook( void );
 
+#if ( MCUBOOT_IMAGE_NUMBER == 3 )
+
+/* Load a model-only update into the running application, see
+ * keyword_detection/main.c. The write hook returns false if the application
+ * cannot reload its model, the updated hook is told whether the new model
+ * is in place or the running one must be restored. */
+    extern bool xOtaModelImageWriteHook( uint32_t ulOffset,
+                                         const uint8_t * pucData,
+                                         size_t xLength );
+    extern void vOtaModelImageUpdatedHook( bool xUpdated );
+
+/* Tells whether the application can be rebooted without interrupting its
+ * work, so that MCUboot installs a reloaded model. */
+    extern bool xOtaApplicationIdleHook( void );
+#endif
+
+/* Key used to verify the signature of OTA images, provisioned by main.c. */
+extern psa_key_handle_t xOTACodeVerifyKeyHandle;
+
 /* Provides external linkage only when running unit test */
 #ifdef UNIT_TESTING
     #define STATIC    /* as nothing */
@@ -97,6 +123,46 @@ extern void vOtaActiveHook( void );
 
 /* -------------------- Demo configurations ------------------------- */
 
+/**
+ * @brief Number of file blocks kept requested from the streaming service at
+ * any time.
+ *
+ * Received blocks of the window are tracked in the 32-bit bitmap of the
+ * download checkpoint.
+ */
+#define OTA_DOWNLOAD_WINDOW_BLOCKS                       otaconfigMAX_NUM_BLOCKS_REQUEST
+
+/**
+ * @brief Encoding of the streamed file blocks, see ota_config.h.
+ */
+#ifndef otaconfigSTREAM_DATA_TYPE
+    #define otaconfigSTREAM_DATA_TYPE                    DATA_TYPE_CBOR
+#endif
+
+/**
+ * @brief Number of written blocks between two download checkpoints, see
+ * ota_config.h.
+ */
+#ifndef otaconfigCHECKPOINT_INTERVAL_BLOCKS
+    #define otaconfigCHECKPOINT_INTERVAL_BLOCKS          16U
+#endif
+
+/**
+ * @brief Resume a download from the checkpoint of a previous boot, see
+ * ota_config.h.
+ */
+#ifndef otaconfigRESUME_AFTER_REBOOT
+    #define otaconfigRESUME_AFTER_REBOOT                 0
+#endif
+
+#if ( OTA_DOWNLOAD_WINDOW_BLOCKS < 1 ) || ( OTA_DOWNLOAD_WINDOW_BLOCKS > OTA_CHECKPOINT_WINDOW_BLOCKS )
+    #error "otaconfigMAX_NUM_BLOCKS_REQUEST must be between 1 and 32."
+#endif
+
+#if ( otaconfigMAX_NUM_OTA_DATA_BUFFERS < ( OTA_DOWNLOAD_WINDOW_BLOCKS + 1 ) )
+    #error "otaconfigMAX_NUM_OTA_DATA_BUFFERS must hold a full window of blocks plus a control message."
+#endif
+
 /**
  * @brief The name of the AWS Thing which will be updated with the new firmware
  * image.
@@ -209,9 +275,20 @@ static uint8_t currentFileId = 0;
 
 
 /**
- * @brief Index of the current file block that is being streamed.
+ * @brief Blocks of the file written so far. Its windowBaseBlock, the first
+ * block not received yet, is the start of the download window.
+ */
+static OtaDownloadCheckpoint_t downloadProgress = { 0 };
+
+/**
+ * @brief Index of the first file block that has never been requested.
+ */
+static uint32_t nextBlockToRequest = 0;
+
+/**
+ * @brief Number of blocks in the file being streamed.
  */
-static uint32_t currentBlockOffset = 0;
+static uint32_t totalNumOfBlocks = 0;
 
 /**
  * @brief Number of file blocks left to be streamed.
@@ -219,9 +296,31 @@ static uint32_t currentBlockOffset = 0;
 static uint32_t numOfBlocksRemaining = 0;
 
 /**
- * @brief Number of bytes that have been received of the file being downloaded.
+ * @brief Tick count when the download last made progress or re-requested
+ * missing blocks.
  */
-static uint32_t totalBytesReceived = 0;
+static TickType_t lastBlockActivityTick = 0;
+
+/**
+ * @brief Number of consecutive re-requests sent without receiving a new block.
+ */
+static uint32_t requestMomentum = 0;
+
+/**
+ * @brief Number of blocks written since downloadProgress was last persisted.
+ */
+static uint32_t blocksSinceCheckpoint = 0;
+
+/**
+ * @brief Set while the image is open for writing in this boot.
+ */
+static bool imageFileOpen = false;
+
+/**
+ * @brief Set when the next file block request resumes an interrupted download
+ * rather than starting a new one.
+ */
+static bool resumeDownloadPending = false;
 
 /**
  * @brief A statically allocated array of data buffers used by the OTA agent.
@@ -238,11 +337,129 @@ static OtaDataEvent_t dataBuffers[ otaconfigMAX_NUM_OTA_DATA_BUFFERS ] = { 0 };
  */
 static SemaphoreHandle_t xBufferSemaphore;
 
+/**
+ * @brief Mutex guarding mqttFileDownloaderContext, which the OTA agent task
+ * initializes for each job while the MQTT agent task decodes data blocks with
+ * it.
+ */
+static SemaphoreHandle_t xDownloaderSemaphore;
+
 /**
  * @brief Buffer to hold the decoded signature from the job document.
  */
 static uint8_t OtaImageSignatureDecoded[ OTA_MAX_SIGNATURE_SIZE ] = { 0 };
 
+/**
+ * @brief SHA-256 of the image, computed over the image data as it is written.
+ * The state of an mbed TLS context, unlike that of a PSA hash operation, can
+ * be saved with the download checkpoint.
+ */
+static mbedtls_sha256_context imageHashContext;
+
+/**
+ * @brief Set while imageHashContext covers all the image data decoded so far.
+ */
+static bool imageHashActive = false;
+
+#if ( otaconfigRESUME_AFTER_REBOOT == 1 )
+
+/**
+ * @brief Number of image hash states kept, enough to cover the sectors held
+ * by the flash writer and the one being filled.
+ */
+    #define OTA_IMAGE_HASH_SNAPSHOTS    ( otaconfigFLASH_WRITE_BUFFERS + 1U )
+
+    _Static_assert( sizeof( mbedtls_sha256_context ) <= OTA_CHECKPOINT_HASH_STATE_SIZE,
+                    "The image hash state does not fit in a download checkpoint." );
+
+/**
+ * @brief State of the image hash at a flash sector boundary of the image.
+ */
+    typedef struct ImageHashSnapshot
+    {
+        uint32_t offset;                /*!< Image bytes hashed. */
+        bool valid;                     /*!< Set once the snapshot is taken. */
+        mbedtls_sha256_context context; /*!< Hash of the image bytes before offset. */
+    } ImageHashSnapshot_t;
+
+/**
+ * @brief Image hash states at the last sector boundaries. A download resumed
+ * after a reboot starts from one of them, as the sectors after it may not be
+ * in flash yet.
+ */
+    static ImageHashSnapshot_t imageHashSnapshots[ OTA_IMAGE_HASH_SNAPSHOTS ];
+#endif /* otaconfigRESUME_AFTER_REBOOT == 1 */
+
+/**
+ * @brief Index of the next block to hash and queue to the flash writer.
+ */
+static uint32_t nextBlockToWrite = 0;
+
+/**
+ * @brief Blocks received out of order, held until every block before them has
+ * been written. Block n is held in slot n % OTA_DOWNLOAD_WINDOW_BLOCKS.
+ */
+static OtaDataEvent_t * blocksWaitingToWrite[ OTA_DOWNLOAD_WINDOW_BLOCKS ] = { 0 };
+
+/**
+ * @brief Decodes the file downloaded into the image written to flash, when
+ * it is a compressed or delta payload rather than an image.
+ */
+static OtaPayloadDecoder_t payloadDecoder;
+
+/**
+ * @brief Offset within the image of the next decoded byte.
+ */
+static uint32_t imageWriteOffset = 0;
+
+/**
+ * @brief First bytes of the image, holding its MCUboot header.
+ */
+static uint8_t imageHeaderBytes[ OTA_IMAGE_HEADER_SIZE ];
+
+/**
+ * @brief The image is not newer than the running component, the download
+ * is aborted.
+ */
+static bool imageRejected = false;
+
+/**
+ * @brief The model-only image is also loaded into the model execution area,
+ * so the application can reload it without a reboot.
+ */
+static bool modelMirrorActive = false;
+
+/**
+ * @brief The model execution area no longer holds the running model.
+ */
+static bool modelMirrorDirty = false;
+
+/**
+ * @brief A model reloaded in place, the job completes once MCUboot has
+ * installed it on the next boot.
+ */
+static OtaModelInstall_t modelInstall = { 0 };
+
+/**
+ * @brief Number of stream payload bytes received from the MQTT agent since
+ * boot. Only the MQTT agent task writes it.
+ */
+static uint32_t ulStreamBytesReceived = 0;
+
+/**
+ * @brief ulStreamBytesReceived when the counters were last reset.
+ */
+static uint32_t ulFileBytesReceivedBase = 0;
+
+/**
+ * @brief Number of bytes copied on the way from the MQTT agent network buffer
+ * to flash for the current file: the decode into the OTA data buffers, the
+ * payload decoder buffers, the model mirror and the flash writer staging
+ * buffers. Only the OTA agent task writes it. Logged per received kilobyte
+ * once the file is closed or the download aborted.
+ */
+static uint32_t ulStreamBytesCopied = 0;
+
 /* -------------------------------------------------------------------------- */
 
 /**
@@ -324,21 +541,189 @@ STATIC void initMqttDownloader( AfrOtaJobDocumentFields_t * jobFields );
 STATIC void freeOtaDataEventBuffer( OtaDataEvent_t * const pxBuffer );
 
 /**
- * @brief
+ * @brief Record a received block of the download window.
  *
- * @param[in] pData Pointer to the received data block.
+ * Blocks may arrive out of order. Duplicates and blocks outside of the window
+ * are dropped. The caller holds a recorded block until every block before it
+ * has arrived, then writes it, see writeBlockInOrder().
+ *
+ * @param[in] blockId Index of the block within the file.
  * @param[in] dataLength Length of the received data block.
  *
- * @return The number of bytes written successfully, or a negative error code from the platform
- * abstraction layer.
+ * @return The length of the recorded block, or 0 if the block was dropped.
+ */
+STATIC int16_t recordReceivedBlock( int32_t blockId,
+                                    size_t dataLength );
+
+/**
+ * @brief Request a contiguous range of data blocks from the file being streamed.
+ *
+ * @param[in] blockOffset Index of the first block requested.
+ * @param[in] numOfBlocks Number of blocks requested.
+ */
+STATIC void requestDataBlock( uint32_t blockOffset,
+                              uint32_t numOfBlocks );
+
+/**
+ * @brief Request the blocks of the download window that have never been
+ * requested.
+ */
+STATIC void requestWindowBlocks( void );
+
+/**
+ * @brief Request again the blocks of the download window that were requested
+ * but have not arrived.
+ */
+STATIC void requestMissingBlocks( void );
+
+/**
+ * @brief Re-request missing blocks once the download has been idle for
+ * otaconfigFILE_REQUEST_WAIT_MS, and abort it after
+ * otaconfigMAX_NUM_REQUEST_MOMENTUM unanswered re-requests.
+ */
+STATIC void checkDownloadProgress( void );
+
+/**
+ * @brief Persist the download progress and the image hash in protected
+ * storage, up to the last block in flash the hash state is known at. Does
+ * nothing unless otaconfigRESUME_AFTER_REBOOT is 1.
+ */
+STATIC void saveDownloadCheckpoint( void );
+
+/**
+ * @brief Restore the progress of the download just opened from the
+ * checkpoint of a previous boot, or persist a fresh checkpoint for it, when
+ * otaconfigRESUME_AFTER_REBOOT is 1. Then start the flash writer where the
+ * download resumes.
+ */
+STATIC void restoreDownloadCheckpoint( void );
+
+/**
+ * @brief Request every missing block of the download window after the
+ * download was interrupted.
+ */
+STATIC void resumeDownload( void );
+
+/**
+ * @brief Drop the streamed image hash.
+ */
+STATIC void abortImageHash( void );
+
+/**
+ * @brief Start hashing the image being downloaded from its first block.
+ */
+STATIC void startImageHash( void );
+
+/**
+ * @brief Add image data to the streamed image hash.
+ *
+ * @param[in] offset Offset of the data within the image.
+ * @param[in] data The data.
+ * @param[in] length Length of the data.
+ */
+STATIC void hashImageData( uint32_t offset,
+                           const uint8_t * data,
+                           size_t length );
+
+/**
+ * @brief Return the blocks held by writeBlockInOrder() to the buffer pool.
+ */
+STATIC void discardHeldBlocks( void );
+
+/**
+ * @brief Decode a received block into the image, in file order.
+ *
+ * A block received out of order is held until every block before it has been
+ * written. Its buffer returns to the pool once it has been decoded, so the
+ * flash writer can combine consecutive blocks into whole sectors.
+ *
+ * @param[in] pxBlock The received block, owned by this function from now on.
  */
-STATIC int16_t handleMqttStreamsBlockArrived( uint8_t * pData,
-                                              size_t dataLength );
+STATIC void writeBlockInOrder( OtaDataEvent_t * const pxBlock );
 
 /**
- * @brief Request the next data block from the file being streamed.
+ * @brief Hash decoded image data and queue it to the flash writer, after
+ * checking the image version from its header.
+ *
+ * Implements OtaPayloadInterface_t::writeImage.
+ */
+STATIC bool writeImageData( const uint8_t * data,
+                            size_t length,
+                            void * context );
+
+/**
+ * @brief Reject an image that is not newer than the component it updates,
+ * from the MCUboot header at its start.
+ *
+ * @return true if the image may be downloaded, otherwise false.
+ */
+STATIC bool checkImageVersion( void );
+
+/**
+ * @brief Load decoded model-only image data into the model execution area.
  */
-STATIC void requestDataBlock( void );
+STATIC void mirrorModelImage( const uint8_t * data,
+                              size_t length );
+
+/**
+ * @brief Tell the application whether the model loaded with
+ * mirrorModelImage() is to be used or the running one restored.
+ *
+ * @param[in] updated true to use the new model.
+ */
+STATIC void finishModelMirror( bool updated );
+
+/**
+ * @brief Abort the download of the current job and fail it.
+ */
+STATIC void abortDownload( void );
+
+/**
+ * @brief Log the bytes received and copied for the file, then reset the
+ * counters for the next one.
+ */
+STATIC void logReceivePath( void );
+
+/**
+ * @brief Reboot, so that MCUboot installs the model reloaded at runtime and
+ * the self test completes its job.
+ */
+STATIC void rebootToInstallModel( void );
+
+/**
+ * @brief Reboot to install a reloaded model once the OTA agent and the
+ * application are idle.
+ */
+STATIC void installModelWhenIdle( void );
+
+/**
+ * @brief Check that a delta payload was made against the running image.
+ *
+ * Implements OtaPayloadInterface_t::checkSource.
+ */
+STATIC bool checkDeltaSource( const OtaPayloadHeader_t * header,
+                              void * context );
+
+/**
+ * @brief Read the running image a delta payload is applied to.
+ *
+ * Implements OtaPayloadInterface_t::readSource.
+ */
+STATIC bool readDeltaSource( uint32_t offset,
+                             uint8_t * data,
+                             size_t length,
+                             void * context );
+
+/**
+ * @brief Verify the job document signature of the image against its digest.
+ *
+ * @param[in] digest SHA-256 digest of the image.
+ * @param[in] digestLength Length of digest.
+ *
+ * @return true if the signature is valid, otherwise false.
+ */
+STATIC bool verifyImageSignature( const uint8_t * digest,
+                                  size_t digestLength );
 
 /**
  * @brief Fetch an unused OTA event buffer from the pool.
@@ -445,6 +830,17 @@ static OtaTopicFilterCallback_t otaTopicFilterCallbacks[] =
     }
 };
 
+/**
+ * @brief Functions the payload decoder writes the image through.
+ */
+static const OtaPayloadInterface_t payloadCallbacks =
+{
+    .writeImage  = writeImageData,
+    .checkSource = checkDeltaSource,
+    .readSource  = readDeltaSource,
+    .context     = NULL
+};
+
 /* -------------------------------------------------------------------------- */
 
 /*
@@ -460,14 +856,97 @@ STATIC void otaAgentShutdown( void )
     OtaSendEvent_FreeRTOS( &eventMsg );
 }
 
+STATIC void logReceivePath( void )
+{
+    uint32_t received = ulStreamBytesReceived;
+    uint32_t fileBytesReceived = received - ulFileBytesReceivedBase;
+
+    if( fileBytesReceived > 0U )
+    {
+        LogInfo( ( "OTA receive path: %u bytes received, %u bytes copied per KB received.\n",
+                   fileBytesReceived,
+                   ( uint32_t ) ( ( ( uint64_t ) ulStreamBytesCopied * 1024U ) / fileBytesReceived ) ) );
+    }
+
+    ulFileBytesReceivedBase = received;
+    ulStreamBytesCopied = 0U;
+}
+
 STATIC bool closeFile( void )
 {
-    return otaPal_CloseFile( &jobFields );
+    bool closed = false;
+    uint8_t digest[ PSA_HASH_LENGTH( PSA_ALG_SHA_256 ) ];
+
+    bool decoded = otaPayload_Finish( &payloadDecoder );
+    bool written = otaFlashWriter_Finish();
+
+    logReceivePath();
+
+    if( ( decoded == false ) || ( written == false ) )
+    {
+        LogError( ( "Failed to decode the file or write the image to flash.\n" ) );
+        abortImageHash();
+    }
+    else
+    {
+        if( imageHashActive &&
+            ( nextBlockToWrite == totalNumOfBlocks ) &&
+            ( mbedtls_sha256_finish( &imageHashContext, digest ) == 0 ) )
+        {
+            /* The digest was computed while the image was streamed, so only
+             * the signature is left to check. The staged image is not read
+             * back. The signature is checked before the image is finished,
+             * so that otaPal_CloseFile() can still finish it otherwise.
+             * After otaPal_CreateFileForRx(), fileId holds the PSA
+             * component. */
+            closed = verifyImageSignature( digest, sizeof( digest ) ) &&
+                     ( psa_fwu_finish( ( psa_fwu_component_t ) jobFields.fileId ) == PSA_SUCCESS );
+        }
+
+        abortImageHash();
+
+        if( closed == false )
+        {
+            LogInfo( ( "No verified streamed digest for the image, verifying it from flash.\n" ) );
+            closed = otaPal_CloseFile( &jobFields );
+        }
+    }
+
+    if( closed == false )
+    {
+        finishModelMirror( false );
+    }
+
+    return closed;
 }
 
 STATIC bool activateImage( void )
 {
-    return otaPal_ActivateNewImage( &jobFields );
+    bool activated;
+    psa_status_t status;
+
+    if( modelMirrorActive )
+    {
+        /* The new model already runs from RAM. MCUboot installs it in flash
+         * on the next boot, the application image is left as it is. */
+        status = psa_fwu_install();
+        activated = ( status == PSA_SUCCESS ) || ( status == PSA_SUCCESS_REBOOT );
+        finishModelMirror( activated );
+
+        if( activated )
+        {
+            ( void ) otaModelInstall_Staged( &modelInstall,
+                                             globalJobId,
+                                             app_strnlen( globalJobId, MAX_JOB_ID_LENGTH ) );
+        }
+    }
+    else
+    {
+        finishModelMirror( false );
+        activated = otaPal_ActivateNewImage( &jobFields );
+    }
+
+    return activated;
 }
 
 STATIC void sendStatusDetailsMessage( void )
@@ -676,10 +1155,34 @@ STATIC void prvMqttDataCallback( void * pvIncomingPublishCallbackContext,
 
     if( pxData != NULL )
     {
-        if( ( size_t ) pxData->dataLength >= pxPublishInfo->payloadLength )
+        int32_t blockSize = 0;
+        MQTTFileDownloaderStatus_t xDecodeStatus;
+
+        /*
+         * MQTT streams Library:
+         * Extracting and decoding the received data block straight from the
+         * MQTT agent network buffer into the loaned OTA data buffer. The
+         * payload is only valid for the duration of this callback, so the
+         * decoded block is the only copy handed over to the OTA agent task.
+         * A CBOR block is a byte string copied as is, a JSON block is base64
+         * decoded on the way. The context is not reinitialized for another
+         * job during the decode.
+         */
+        ( void ) xSemaphoreTake( xDownloaderSemaphore, portMAX_DELAY );
+        xDecodeStatus = mqttDownloader_processReceivedDataBlock( &mqttFileDownloaderContext,
+                                                                 ( uint8_t * ) pxPublishInfo->pPayload,
+                                                                 pxPublishInfo->payloadLength,
+                                                                 &pxData->fileId,
+                                                                 &pxData->blockId,
+                                                                 &blockSize,
+                                                                 pxData->data,
+                                                                 &pxData->dataLength );
+        ( void ) xSemaphoreGive( xDownloaderSemaphore );
+
+        if( xDecodeStatus == MQTTFileDownloaderSuccess )
         {
-            memcpy( pxData->data, pxPublishInfo->pPayload, pxPublishInfo->payloadLength );
-            pxData->dataLength = pxPublishInfo->payloadLength;
+            ulStreamBytesReceived += ( uint32_t ) pxPublishInfo->payloadLength;
+
             eventMsg.eventId = OtaAgentEventReceivedFileBlock;
             eventMsg.dataEvent = pxData;
 
@@ -688,7 +1191,8 @@ STATIC void prvMqttDataCallback( void * pvIncomingPublishCallbackContext,
         }
         else
         {
-            LogError( ( "Error: OTA data buffers are too small for the data message received.\n" ) );
+            LogError( ( "Error: Failed to decode the data message received: %d.\n", xDecodeStatus ) );
+            freeOtaDataEventBuffer( pxData );
         }
     }
     else
@@ -723,7 +1227,8 @@ void prvRegisterOTACallback( const char * pTopicFilter,
         if( isMatch )
         {
             /* Add subscription so that incoming publishes are routed to the application callback. */
-            subscriptionAdded = addSubscription( pTopicFilter,
+            subscriptionAdded = addSubscription( pxGetMqttAgentSubscriptionList( otaexampleMQTT_AGENT_CONNECTION ),
+                                                 pTopicFilter,
                                                  topicFilterLength,
                                                  otaTopicFilterCallbacks[ index ].callback,
                                                  NULL );
@@ -780,8 +1285,6 @@ STATIC OtaPalJobDocProcessingResult_t receivedJobDocumentHandler( OtaJobEventDat
     size_t jobIdLength = 0U;
     OtaPalJobDocProcessingResult_t xResult = OtaPalJobDocFileCreateFailed;
 
-    memset( &jobFields, 0, sizeof( jobFields ) );
-
     /*
      * AWS IoT Jobs library:
      * Extracting the job ID from the received OTA job document.
@@ -790,19 +1293,44 @@ STATIC OtaPalJobDocProcessingResult_t receivedJobDocumentHandler( OtaJobEventDat
 
     if( jobIdLength )
     {
-        if( strncmp( globalJobId, jobId, jobIdLength ) )
+        OtaModelInstallAction_t modelInstallAction = otaModelInstall_OnJobDocument( &modelInstall, jobId, jobIdLength );
+
+        if( modelInstallAction == OtaModelInstallReboot )
+        {
+            /* The staged model blocks any other update until it is
+             * installed. The job is fetched again after the reboot. */
+            LogInfo( ( "Installing the reloaded ML model before the next job.\n" ) );
+            rebootToInstallModel();
+        }
+        else if( modelInstallAction == OtaModelInstallWait )
+        {
+            /* The model of this job is already in use. The job is completed
+             * by the self test once MCUboot has installed it on the next
+             * boot. */
+            LogInfo( ( "The ML model of the job is installed on the next boot.\n" ) );
+            xResult = OtaPalJobDocProcessingStateInvalid;
+        }
+        else if( strncmp( globalJobId, jobId, jobIdLength ) )
         {
             parseJobDocument = true;
             memcpy( globalJobId, jobId, jobIdLength );
         }
         else
         {
+            /* The job being downloaded, e.g. requested again after the agent
+             * was resumed on reconnection. Pick the download up where it
+             * stopped. */
+            resumeDownloadPending = imageFileOpen;
             xResult = OtaPalJobDocFileCreated;
         }
     }
 
     if( parseJobDocument )
     {
+        /* The fields of the job being downloaded stay in use by the PAL and
+         * the flash writer, so they are only cleared for a new job. */
+        memset( &jobFields, 0, sizeof( jobFields ) );
+
         bool handled = jobDocumentParser( ( char * ) jobDoc->jobData, jobDoc->jobDataLength, &jobFields );
 
         populateJobStatusDetailsFields( ( char * ) jobDoc->jobData, jobDoc->jobDataLength, &jobStatusDetails );
@@ -887,6 +1415,12 @@ STATIC OtaPalJobDocProcessingResult_t receivedJobDocumentHandler( OtaJobEventDat
                 if( handled )
                 {
                     xResult = otaPal_CreateFileForRx( &jobFields );
+
+                    if( xResult == OtaPalJobDocFileCreated )
+                    {
+                        imageFileOpen = true;
+                        restoreDownloadCheckpoint();
+                    }
                 }
                 else
                 {
@@ -909,29 +1443,46 @@ STATIC void initMqttDownloader( AfrOtaJobDocumentFields_t * jobFields )
                            mqttFileDownloader_CONFIG_BLOCK_SIZE;
     numOfBlocksRemaining += ( jobFields->fileSize %
                               mqttFileDownloader_CONFIG_BLOCK_SIZE > 0 ) ? 1 : 0;
+    totalNumOfBlocks = numOfBlocksRemaining;
     currentFileId = ( uint8_t ) jobFields->fileId;
-    currentBlockOffset = 0;
-    totalBytesReceived = 0;
+    nextBlockToRequest = 0;
+    requestMomentum = 0;
+    blocksSinceCheckpoint = 0;
+    resumeDownloadPending = false;
+    discardHeldBlocks();
+    finishModelMirror( false );
+    otaModelInstall_Init( &modelInstall );
+    nextBlockToWrite = 0;
+    startImageHash();
+    otaCheckpoint_Reset( &downloadProgress,
+                         globalJobId,
+                         app_strnlen( globalJobId, MAX_JOB_ID_LENGTH ),
+                         jobFields->fileId,
+                         jobFields->fileSize );
 
     /*
      * MQTT streams Library:
      * Initializing the MQTT streams downloader. Passing the
      * parameters extracted from the AWS IoT OTA jobs document
-     * using OTA jobs parser.
+     * using OTA jobs parser. The data callback decodes blocks with the
+     * context from the MQTT agent task.
      */
+    ( void ) xSemaphoreTake( xDownloaderSemaphore, portMAX_DELAY );
     mqttDownloader_init( &mqttFileDownloaderContext,
                          jobFields->imageRef,
                          jobFields->imageRefLen,
                          OTA_THING_NAME,
                          strlen( OTA_THING_NAME ),
-                         DATA_TYPE_JSON );
+                         otaconfigSTREAM_DATA_TYPE );
+    ( void ) xSemaphoreGive( xDownloaderSemaphore );
 
     prvMQTTSubscribe( mqttFileDownloaderContext.topicStreamData,
                       mqttFileDownloaderContext.topicStreamDataLength,
                       0 );
 }
 
-STATIC void requestDataBlock( void )
+STATIC void requestDataBlock( uint32_t blockOffset,
+                              uint32_t numOfBlocks )
 {
     char getStreamRequest[ GET_STREAM_REQUEST_BUFFER_SIZE ];
     size_t getStreamRequestLength = 0U;
@@ -945,8 +1496,8 @@ STATIC void requestDataBlock( void )
     getStreamRequestLength = mqttDownloader_createGetDataBlockRequest( mqttFileDownloaderContext.dataType,
                                                                        currentFileId,
                                                                        mqttFileDownloader_CONFIG_BLOCK_SIZE,
-                                                                       ( uint16_t ) currentBlockOffset,
-                                                                       NUM_OF_BLOCKS_REQUESTED,
+                                                                       ( uint16_t ) blockOffset,
+                                                                       ( uint16_t ) numOfBlocks,
                                                                        getStreamRequest,
                                                                        GET_STREAM_REQUEST_BUFFER_SIZE );
 
@@ -957,25 +1508,602 @@ STATIC void requestDataBlock( void )
                     0 );
 }
 
-/* Stores the received data blocks in the flash partition reserved for OTA */
-STATIC int16_t handleMqttStreamsBlockArrived( uint8_t * data,
-                                              size_t dataLength )
+STATIC void requestWindowBlocks( void )
+{
+    uint32_t windowEnd = otaCheckpoint_GetWindowEnd( &downloadProgress,
+                                                     OTA_DOWNLOAD_WINDOW_BLOCKS,
+                                                     totalNumOfBlocks );
+
+    /* A single request covers all the slots opened since the last one. */
+    if( nextBlockToRequest < windowEnd )
+    {
+        requestDataBlock( nextBlockToRequest, windowEnd - nextBlockToRequest );
+        nextBlockToRequest = windowEnd;
+    }
+}
+
+STATIC void requestMissingBlocks( void )
+{
+    uint32_t runStart = downloadProgress.windowBaseBlock;
+    uint32_t runLength = 0U;
+
+    /* Request each run of consecutive missing blocks with a single request. */
+    do
+    {
+        runLength = otaCheckpoint_FindMissingRun( &downloadProgress,
+                                                  runStart + runLength,
+                                                  nextBlockToRequest,
+                                                  &runStart );
+
+        if( runLength > 0U )
+        {
+            LogInfo( ( "Re-requesting blocks %u to %u.\n", runStart, runStart + runLength - 1U ) );
+            requestDataBlock( runStart, runLength );
+        }
+    } while( runLength > 0U );
+}
+
+STATIC void checkDownloadProgress( void )
+{
+    if( ( otaAgentState == OtaAgentStateWaitingForFileBlock ) &&
+        ( ( xTaskGetTickCount() - lastBlockActivityTick ) >= pdMS_TO_TICKS( otaconfigFILE_REQUEST_WAIT_MS ) ) )
+    {
+        lastBlockActivityTick = xTaskGetTickCount();
+        requestMomentum++;
+
+        if( requestMomentum > otaconfigMAX_NUM_REQUEST_MOMENTUM )
+        {
+            LogError( ( "No file block received after %u requests, aborting the download.\n",
+                        otaconfigMAX_NUM_REQUEST_MOMENTUM ) );
+            abortDownload();
+        }
+        else
+        {
+            requestMissingBlocks();
+        }
+    }
+}
+
+STATIC void abortDownload( void )
+{
+    otaFlashWriter_Abort();
+    ( void ) otaPal_Abort( &jobFields );
+    discardHeldBlocks();
+    logReceivePath();
+    abortImageHash();
+    finishModelMirror( false );
+    imageFileOpen = false;
+    #if ( otaconfigRESUME_AFTER_REBOOT == 1 )
+        ( void ) otaCheckpoint_Erase();
+    #endif
+    sendFinalJobStatusMessage( Failed );
+
+    /* Close the window so late blocks are dropped. */
+    nextBlockToRequest = downloadProgress.windowBaseBlock;
+    otaAgentState = OtaAgentStateReady;
+    vOtaNotActiveHook();
+}
+
+STATIC void rebootToInstallModel( void )
+{
+    LogInfo( ( "Rebooting to install the ML model.\n" ) );
+
+    if( otaPal_ResetDevice( &jobFields ) == false )
+    {
+        LogError( ( "Failed to reboot to install the ML model.\n" ) );
+    }
+}
+
+STATIC void installModelWhenIdle( void )
+{
+    #if ( MCUBOOT_IMAGE_NUMBER == 3 )
+        if( modelInstall.pending &&
+            ( otaAgentState == OtaAgentStateReady ) &&
+            ( otaModelInstall_OnIdle( &modelInstall, xOtaApplicationIdleHook() ) == OtaModelInstallReboot ) )
+        {
+            rebootToInstallModel();
+        }
+    #endif
+}
+
+STATIC void saveDownloadCheckpoint( void )
+{
+    #if ( otaconfigRESUME_AFTER_REBOOT == 1 )
+        OtaDownloadCheckpoint_t checkpoint = downloadProgress;
+        const ImageHashSnapshot_t * snapshot = NULL;
+        uint32_t resumeOffset = otaFlashWriter_GetWrittenOffset();
+
+        /* Blocks still held in RAM by the flash writer or for ordering are
+         * lost on a reboot, so only the blocks before the flash write offset
+         * count. */
+        if( resumeOffset > ( checkpoint.windowBaseBlock * mqttFileDownloader_CONFIG_BLOCK_SIZE ) )
+        {
+            resumeOffset = checkpoint.windowBaseBlock * mqttFileDownloader_CONFIG_BLOCK_SIZE;
+        }
+
+        /* The decoder state is not persisted, so a compressed or delta
+         * payload is downloaded again from its start. */
+        if( otaPayload_IsEncoded( &payloadDecoder ) )
+        {
+            resumeOffset = 0U;
+        }
+
+        /* Resume from the last block boundary the hash state is known at, or
+         * without a hash, the image is then verified from flash. */
+        if( imageHashActive && ( resumeOffset > 0U ) )
+        {
+            for( uint32_t ulIndex = 0; ulIndex < OTA_IMAGE_HASH_SNAPSHOTS; ulIndex++ )
+            {
+                if( imageHashSnapshots[ ulIndex ].valid &&
+                    ( imageHashSnapshots[ ulIndex ].offset <= resumeOffset ) &&
+                    ( ( imageHashSnapshots[ ulIndex ].offset % mqttFileDownloader_CONFIG_BLOCK_SIZE ) == 0U ) &&
+                    ( ( snapshot == NULL ) || ( imageHashSnapshots[ ulIndex ].offset > snapshot->offset ) ) )
+                {
+                    snapshot = &imageHashSnapshots[ ulIndex ];
+                }
+            }
+
+            resumeOffset = ( snapshot != NULL ) ? snapshot->offset : 0U;
+        }
+
+        checkpoint.windowBaseBlock = resumeOffset / mqttFileDownloader_CONFIG_BLOCK_SIZE;
+        checkpoint.windowReceivedBitmap = 0U;
+        checkpoint.bytesReceived = checkpoint.windowBaseBlock * mqttFileDownloader_CONFIG_BLOCK_SIZE;
+        checkpoint.imageHashSaved = ( snapshot != NULL ) ? 1U : 0U;
+
+        if( snapshot != NULL )
+        {
+            ( void ) memcpy( checkpoint.imageHashState, &( snapshot->context ), sizeof( snapshot->context ) );
+        }
+
+        if( otaCheckpoint_Save( &checkpoint ) != OtaCheckpointSuccess )
+        {
+            LogError( ( "Failed to save the download checkpoint.\n" ) );
+        }
+    #endif /* otaconfigRESUME_AFTER_REBOOT == 1 */
+
+    blocksSinceCheckpoint = 0;
+}
+
+STATIC void restoreDownloadCheckpoint( void )
+{
+    #if ( otaconfigRESUME_AFTER_REBOOT == 1 )
+        OtaDownloadCheckpoint_t checkpoint;
+
+        if( ( otaCheckpoint_Load( &checkpoint ) == OtaCheckpointSuccess ) &&
+            otaCheckpoint_MatchesJob( &checkpoint,
+                                      downloadProgress.jobId,
+                                      app_strnlen( downloadProgress.jobId, MAX_JOB_ID_LENGTH ),
+                                      downloadProgress.fileId,
+                                      downloadProgress.fileSize ) &&
+            ( otaCheckpoint_GetReceivedBlockCount( &checkpoint ) < totalNumOfBlocks ) )
+        {
+            /* A download resumed from block 0 keeps the hash just started. */
+            if( ( checkpoint.windowBaseBlock > 0U ) && imageHashActive )
+            {
+                if( checkpoint.imageHashSaved == 1U )
+                {
+                    ( void ) memcpy( &imageHashContext, checkpoint.imageHashState, sizeof( imageHashContext ) );
+                }
+                else
+                {
+                    abortImageHash();
+                }
+            }
+
+            downloadProgress = checkpoint;
+
+            /* Only blocks before the window are known to be in flash. */
+            downloadProgress.windowReceivedBitmap = 0U;
+            numOfBlocksRemaining = totalNumOfBlocks - downloadProgress.windowBaseBlock;
+            nextBlockToWrite = downloadProgress.windowBaseBlock;
+            resumeDownloadPending = true;
+        }
+        else
+        {
+            /* A fresh checkpoint replaces any checkpoint left by another job. */
+            saveDownloadCheckpoint();
+        }
+    #endif /* otaconfigRESUME_AFTER_REBOOT == 1 */
+
+    /* A resumed download is always a plain image, see saveDownloadCheckpoint(). */
+    otaPayload_Init( &payloadDecoder, &payloadCallbacks, nextBlockToWrite == 0U );
+    otaFlashWriter_Start( &jobFields, nextBlockToWrite * mqttFileDownloader_CONFIG_BLOCK_SIZE );
+    imageWriteOffset = nextBlockToWrite * mqttFileDownloader_CONFIG_BLOCK_SIZE;
+    imageRejected = false;
+
+    #if ( MCUBOOT_IMAGE_NUMBER == 3 )
+        /* Only a model streamed from its start can be loaded in place. After
+         * otaPal_CreateFileForRx(), fileId holds the PSA component. */
+        modelMirrorActive = ( jobFields.fileId == FWU_COMPONENT_ID_ML_MODEL ) && ( imageWriteOffset == 0U );
+    #endif
+}
+
+STATIC void abortImageHash( void )
+{
+    if( imageHashActive )
+    {
+        mbedtls_sha256_free( &imageHashContext );
+        imageHashActive = false;
+    }
+}
+
+STATIC void startImageHash( void )
+{
+    abortImageHash();
+
+    mbedtls_sha256_init( &imageHashContext );
+    imageHashActive = ( mbedtls_sha256_starts( &imageHashContext, 0 ) == 0 );
+
+    if( imageHashActive == false )
+    {
+        LogError( ( "Failed to start the image hash, the image will be verified from flash.\n" ) );
+        mbedtls_sha256_free( &imageHashContext );
+    }
+
+    #if ( otaconfigRESUME_AFTER_REBOOT == 1 )
+        ( void ) memset( imageHashSnapshots, 0, sizeof( imageHashSnapshots ) );
+    #endif
+}
+
+STATIC void hashImageData( uint32_t offset,
+                           const uint8_t * data,
+                           size_t length )
+{
+    size_t chunkLength;
+
+    while( imageHashActive && ( length > 0U ) )
+    {
+        chunkLength = length;
+
+        #if ( otaconfigRESUME_AFTER_REBOOT == 1 )
+        {
+            uint32_t sectorOffset = offset % otaconfigFLASH_WRITE_SECTOR_SIZE;
+            ImageHashSnapshot_t * snapshot;
+
+            /* The flash writer writes whole sectors, a download resumed
+             * after a reboot starts at a sector boundary. */
+            if( sectorOffset == 0U )
+            {
+                snapshot = &imageHashSnapshots[ ( offset / otaconfigFLASH_WRITE_SECTOR_SIZE ) % OTA_IMAGE_HASH_SNAPSHOTS ];
+                snapshot->offset = offset;
+                snapshot->context = imageHashContext;
+                snapshot->valid = true;
+            }
+
+            if( chunkLength > ( otaconfigFLASH_WRITE_SECTOR_SIZE - sectorOffset ) )
+            {
+                chunkLength = otaconfigFLASH_WRITE_SECTOR_SIZE - sectorOffset;
+            }
+        }
+        #endif /* otaconfigRESUME_AFTER_REBOOT == 1 */
+
+        if( mbedtls_sha256_update( &imageHashContext, data, chunkLength ) != 0 )
+        {
+            LogError( ( "Failed to hash the image, it will be verified from flash.\n" ) );
+            abortImageHash();
+        }
+
+        offset += ( uint32_t ) chunkLength;
+        data += chunkLength;
+        length -= chunkLength;
+    }
+}
+
+STATIC void discardHeldBlocks( void )
+{
+    for( uint32_t ulSlot = 0; ulSlot < OTA_DOWNLOAD_WINDOW_BLOCKS; ulSlot++ )
+    {
+        if( blocksWaitingToWrite[ ulSlot ] != NULL )
+        {
+            freeOtaDataEventBuffer( blocksWaitingToWrite[ ulSlot ] );
+            blocksWaitingToWrite[ ulSlot ] = NULL;
+        }
+    }
+}
+
+STATIC void writeBlockInOrder( OtaDataEvent_t * const pxBlock )
+{
+    OtaDataEvent_t * pxNextBlock;
+    uint32_t decoderCopiedBytes;
+
+    blocksWaitingToWrite[ ( uint32_t ) pxBlock->blockId % OTA_DOWNLOAD_WINDOW_BLOCKS ] = pxBlock;
+
+    /* Write every block now in file order. Held blocks are always within the
+     * download window, so each one has a slot of its own. */
+    pxNextBlock = blocksWaitingToWrite[ nextBlockToWrite % OTA_DOWNLOAD_WINDOW_BLOCKS ];
+
+    while( ( pxNextBlock != NULL ) && ( ( uint32_t ) pxNextBlock->blockId == nextBlockToWrite ) )
+    {
+        decoderCopiedBytes = otaPayload_GetCopiedBytes( &payloadDecoder );
+
+        /* A failure is reported again when the file is closed. */
+        if( otaPayload_Decode( &payloadDecoder, pxNextBlock->data, pxNextBlock->dataLength ) == false )
+        {
+            LogError( ( "Failed to decode block %u into the image.\n", nextBlockToWrite ) );
+        }
+
+        /* The header bytes and the decoded bytes the decoder buffered. */
+        ulStreamBytesCopied += otaPayload_GetCopiedBytes( &payloadDecoder ) - decoderCopiedBytes;
+
+        blocksWaitingToWrite[ nextBlockToWrite % OTA_DOWNLOAD_WINDOW_BLOCKS ] = NULL;
+        freeOtaDataEventBuffer( pxNextBlock );
+        nextBlockToWrite++;
+        pxNextBlock = blocksWaitingToWrite[ nextBlockToWrite % OTA_DOWNLOAD_WINDOW_BLOCKS ];
+    }
+}
+
+STATIC bool writeImageData( const uint8_t * data,
+                            size_t length,
+                            void * context )
+{
+    size_t headerLength;
+    bool written = false;
+
+    ( void ) context;
+
+    /* The version is checked from the first bytes, so an old image is
+     * rejected before the rest of it is downloaded. */
+    if( imageWriteOffset < OTA_IMAGE_HEADER_SIZE )
+    {
+        headerLength = OTA_IMAGE_HEADER_SIZE - imageWriteOffset;
+        headerLength = ( headerLength < length ) ? headerLength : length;
+        ( void ) memcpy( &imageHeaderBytes[ imageWriteOffset ], data, headerLength );
+
+        if( ( ( imageWriteOffset + headerLength ) == OTA_IMAGE_HEADER_SIZE ) &&
+            ( checkImageVersion() == false ) )
+        {
+            imageRejected = true;
+        }
+    }
+
+    if( imageRejected == false )
+    {
+        mirrorModelImage( data, length );
+        hashImageData( imageWriteOffset, data, length );
+        imageWriteOffset += ( uint32_t ) length;
+
+        written = otaFlashWriter_Write( data, length );
+
+        /* The flash writer stages every byte in a sector buffer. */
+        ulStreamBytesCopied += ( uint32_t ) length;
+    }
+
+    return written;
+}
+
+STATIC bool checkImageVersion( void )
+{
+    OtaImageHeader_t header;
+    OtaImageVersion_t runningVersion;
+    psa_fwu_component_info_t componentInfo = { 0 };
+    bool accepted = false;
+
+    if( otaImageHeader_Parse( imageHeaderBytes, sizeof( imageHeaderBytes ), &header ) == false )
+    {
+        LogError( ( "The image does not start with an MCUboot header.\n" ) );
+    }
+    else if( psa_fwu_query( ( psa_fwu_component_t ) jobFields.fileId, &componentInfo ) != PSA_SUCCESS )
+    {
+        /* MCUboot still checks the version when it installs the image. */
+        LogError( ( "Failed to query the version of component %u.\n", jobFields.fileId ) );
+        accepted = true;
+    }
+    else
+    {
+        runningVersion.major = componentInfo.version.major;
+        runningVersion.minor = componentInfo.version.minor;
+        runningVersion.revision = componentInfo.version.patch;
+        runningVersion.buildNum = componentInfo.version.build;
+
+        LogInfo( ( "Component %u image version=%u.%u.%u+%u, running version=%u.%u.%u+%u\n",
+                   jobFields.fileId,
+                   header.version.major, header.version.minor,
+                   header.version.revision, header.version.buildNum,
+                   runningVersion.major, runningVersion.minor,
+                   runningVersion.revision, runningVersion.buildNum ) );
+
+        accepted = ( otaImageHeader_CompareVersions( &header.version, &runningVersion ) > 0 );
+
+        if( accepted == false )
+        {
+            LogError( ( "The image is not newer than the running component, rejecting it.\n" ) );
+        }
+    }
+
+    return accepted;
+}
+
+STATIC void mirrorModelImage( const uint8_t * data,
+                              size_t length )
 {
-    int16_t writeblockRes = -1;
+    #if ( MCUBOOT_IMAGE_NUMBER == 3 )
+        if( modelMirrorActive )
+        {
+            modelMirrorDirty = true;
+
+            if( xOtaModelImageWriteHook( imageWriteOffset, data, length ) == false )
+            {
+                LogInfo( ( "The ML model cannot be reloaded at runtime, it is loaded on the next boot.\n" ) );
+                modelMirrorActive = false;
+            }
+            else
+            {
+                ulStreamBytesCopied += ( uint32_t ) length;
+            }
+        }
+    #else
+        ( void ) data;
+        ( void ) length;
+    #endif
+}
 
-    LogInfo( ( "Downloaded block %u of %u. \n", currentBlockOffset, ( currentBlockOffset + numOfBlocksRemaining ) ) );
+STATIC void finishModelMirror( bool updated )
+{
+    #if ( MCUBOOT_IMAGE_NUMBER == 3 )
+        if( modelMirrorDirty )
+        {
+            vOtaModelImageUpdatedHook( updated );
+        }
+    #else
+        ( void ) updated;
+    #endif
 
-    writeblockRes = otaPal_WriteBlock( &jobFields,
-                                       totalBytesReceived,
-                                       data,
-                                       dataLength );
+    modelMirrorActive = false;
+    modelMirrorDirty = false;
+}
 
-    if( writeblockRes > 0 )
+STATIC bool checkDeltaSource( const OtaPayloadHeader_t * header,
+                              void * context )
+{
+    bool matches = false;
+
+    ( void ) context;
+
+    #ifdef otaconfigDELTA_SOURCE_ADDRESS
+        matches = otaDeltaSource_Matches( header,
+                                          ( const uint8_t * ) otaconfigDELTA_SOURCE_ADDRESS,
+                                          otaconfigDELTA_SOURCE_SIZE );
+
+        if( matches == false )
+        {
+            LogError( ( "The delta payload was not made against the running image.\n" ) );
+        }
+    #else
+        ( void ) header;
+        LogError( ( "Delta payloads are not supported, otaconfigDELTA_SOURCE_ADDRESS is not defined.\n" ) );
+    #endif
+
+    return matches;
+}
+
+STATIC bool readDeltaSource( uint32_t offset,
+                             uint8_t * data,
+                             size_t length,
+                             void * context )
+{
+    bool read = false;
+
+    ( void ) context;
+
+    #ifdef otaconfigDELTA_SOURCE_ADDRESS
+        read = otaDeltaSource_Read( ( const uint8_t * ) otaconfigDELTA_SOURCE_ADDRESS,
+                                    otaconfigDELTA_SOURCE_SIZE,
+                                    offset,
+                                    data,
+                                    length );
+    #else
+        ( void ) offset;
+        ( void ) data;
+        ( void ) length;
+    #endif
+
+    return read;
+}
+
+STATIC bool verifyImageSignature( const uint8_t * digest,
+                                  size_t digestLength )
+{
+    psa_key_attributes_t keyAttributes = PSA_KEY_ATTRIBUTES_INIT;
+    uint8_t rawSignature[ OTA_MAX_SIGNATURE_SIZE ];
+    const uint8_t * signature = ( const uint8_t * ) jobFields.signature;
+    size_t signatureLength = jobFields.signatureLen;
+    size_t coordinateLength;
+    bool verified = false;
+
+    if( psa_get_key_attributes( xOTACodeVerifyKeyHandle, &keyAttributes ) == PSA_SUCCESS )
     {
-        totalBytesReceived += writeblockRes;
+        verified = true;
+
+        /* ECDSA signatures are DER encoded, PSA expects r and s concatenated. */
+        if( PSA_KEY_TYPE_IS_ECC( psa_get_key_type( &keyAttributes ) ) )
+        {
+            coordinateLength = PSA_BITS_TO_BYTES( psa_get_key_bits( &keyAttributes ) );
+            verified = ( ( 2U * coordinateLength ) <= sizeof( rawSignature ) ) &&
+                       convertEcdsaSignatureToRaw( signature, signatureLength, rawSignature, coordinateLength );
+            signature = rawSignature;
+            signatureLength = 2U * coordinateLength;
+        }
+
+        verified = verified &&
+                   ( psa_verify_hash( xOTACodeVerifyKeyHandle,
+                                      psa_get_key_algorithm( &keyAttributes ),
+                                      digest,
+                                      digestLength,
+                                      signature,
+                                      signatureLength ) == PSA_SUCCESS );
+
+        psa_reset_key_attributes( &keyAttributes );
+    }
+
+    if( verified == false )
+    {
+        LogError( ( "The image signature does not match its streamed digest.\n" ) );
     }
 
-    return writeblockRes;
+    return verified;
+}
+
+STATIC void resumeDownload( void )
+{
+    uint32_t windowEnd = otaCheckpoint_GetWindowEnd( &downloadProgress,
+                                                     OTA_DOWNLOAD_WINDOW_BLOCKS,
+                                                     totalNumOfBlocks );
+
+    LogInfo( ( "Resuming the download, %u of %u blocks already written.\n",
+               totalNumOfBlocks - numOfBlocksRemaining,
+               totalNumOfBlocks ) );
+
+    /* Requests sent before the interruption may have been lost, so every
+     * missing block of the window is requested again. */
+    nextBlockToRequest = windowEnd;
+    lastBlockActivityTick = xTaskGetTickCount();
+    requestMomentum = 0;
+    requestMissingBlocks();
+}
+
+STATIC int16_t recordReceivedBlock( int32_t blockId,
+                                    size_t dataLength )
+{
+    int16_t recordedLength = 0;
+
+    if( ( blockId < ( int32_t ) downloadProgress.windowBaseBlock ) ||
+        ( ( uint32_t ) blockId >= nextBlockToRequest ) )
+    {
+        LogInfo( ( "Dropping block %d outside of the download window.\n", ( int ) blockId ) );
+    }
+    else
+    {
+        if( otaCheckpoint_IsBlockReceived( &downloadProgress, ( uint32_t ) blockId ) )
+        {
+            LogInfo( ( "Dropping duplicate block %d.\n", ( int ) blockId ) );
+        }
+        else
+        {
+            LogInfo( ( "Downloaded block %d of %u. \n", ( int ) blockId, totalNumOfBlocks ) );
+
+            recordedLength = ( int16_t ) dataLength;
+
+            if( recordedLength > 0 )
+            {
+                /* Slides the window past every block received in order. */
+                ( void ) otaCheckpoint_MarkBlockReceived( &downloadProgress,
+                                                          ( uint32_t ) blockId,
+                                                          ( uint32_t ) recordedLength );
+                numOfBlocksRemaining--;
+                blocksSinceCheckpoint++;
+
+                /* The checkpoint only records the blocks already in flash. */
+                if( ( otaconfigCHECKPOINT_INTERVAL_BLOCKS > 0U ) &&
+                    ( blocksSinceCheckpoint >= otaconfigCHECKPOINT_INTERVAL_BLOCKS ) )
+                {
+                    saveDownloadCheckpoint();
+                }
+            }
+        }
+    }
+
+    return recordedLength;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1032,7 +2160,14 @@ STATIC void processOTAEvents()
     OtaEvent_t recvEventId = 0;
     OtaEventMsg_t nextEvent = { 0 };
 
-    OtaReceiveEvent_FreeRTOS( &recvEvent );
+    if( OtaReceiveEvent_FreeRTOS( &recvEvent ) != OtaOsSuccess )
+    {
+        /* Nothing arrived within the receive timeout, the zeroed event is
+         * ignored below. */
+        checkDownloadProgress();
+        installModelWhenIdle();
+    }
+
     recvEventId = recvEvent.eventId;
 
     switch( recvEventId )
@@ -1085,18 +2220,32 @@ STATIC void processOTAEvents()
             otaAgentState = OtaAgentStateRequestingFileBlock;
             LogInfo( ( "Requesting file block.\n" ) );
 
-            if( currentBlockOffset == 0 )
+            if( resumeDownloadPending )
+            {
+                resumeDownloadPending = false;
+                resumeDownload();
+            }
+            else
             {
-                LogInfo( ( "Starting the download. \n" ) );
+                if( nextBlockToRequest == 0 )
+                {
+                    LogInfo( ( "Starting the download. \n" ) );
+                }
+
+                requestWindowBlocks();
             }
 
-            requestDataBlock();
+            lastBlockActivityTick = xTaskGetTickCount();
+            otaAgentState = OtaAgentStateWaitingForFileBlock;
 
             break;
 
         case OtaAgentEventReceivedFileBlock:
             LogInfo( ( "Received file block.\n" ) );
 
+            /* The data callback decoded the block into the loaned buffer. */
+            ulStreamBytesCopied += ( uint32_t ) recvEvent.dataEvent->dataLength;
+
             if( otaAgentState == OtaAgentStateSuspended )
             {
                 LogInfo( ( "OTA agent is in Suspended State. Dropping file block. \n" ) );
@@ -1110,45 +2259,39 @@ STATIC void processOTAEvents()
                 break;
             }
 
-            int32_t fileId;
-            int32_t blockId;
-            int32_t blockSize;
-            uint8_t decodedData[ mqttFileDownloader_CONFIG_BLOCK_SIZE ];
-            size_t decodedDataLength = 0;
             int16_t result;
 
-            /*
-             * MQTT streams Library:
-             * Extracting and decoding the received data block from the incoming MQTT message.
-             */
-            mqttDownloader_processReceivedDataBlock(
-                &mqttFileDownloaderContext,
-                recvEvent.dataEvent->data,
-                recvEvent.dataEvent->dataLength,
-                &fileId,
-                &blockId,
-                &blockSize,
-                decodedData,
-                &decodedDataLength );
-
-            result = handleMqttStreamsBlockArrived( decodedData, decodedDataLength );
-            freeOtaDataEventBuffer( recvEvent.dataEvent );
+            /* The block was decoded by the data callback, record it and
+             * write it from the loaned buffer once it is in file order. */
+            result = recordReceivedBlock( recvEvent.dataEvent->blockId,
+                                          recvEvent.dataEvent->dataLength );
 
             if( result > 0 )
             {
-                numOfBlocksRemaining--;
-                currentBlockOffset++;
-            }
+                /* The buffer returns to the pool once its block is written. */
+                writeBlockInOrder( recvEvent.dataEvent );
 
-            if( numOfBlocksRemaining == 0 )
-            {
-                nextEvent.eventId = OtaAgentEventCloseFile;
-                OtaSendEvent_FreeRTOS( &nextEvent );
+                lastBlockActivityTick = xTaskGetTickCount();
+                requestMomentum = 0;
+
+                if( imageRejected )
+                {
+                    abortDownload();
+                }
+                else if( numOfBlocksRemaining == 0 )
+                {
+                    nextEvent.eventId = OtaAgentEventCloseFile;
+                    OtaSendEvent_FreeRTOS( &nextEvent );
+                }
+                else if( nextBlockToRequest < ( downloadProgress.windowBaseBlock + OTA_DOWNLOAD_WINDOW_BLOCKS ) )
+                {
+                    /* The window slid, keep it full. */
+                    requestWindowBlocks();
+                }
             }
             else
             {
-                nextEvent.eventId = OtaAgentEventRequestFileBlock;
-                OtaSendEvent_FreeRTOS( &nextEvent );
+                freeOtaDataEventBuffer( recvEvent.dataEvent );
             }
 
             break;
@@ -1156,6 +2299,12 @@ STATIC void processOTAEvents()
         case OtaAgentEventCloseFile:
             LogInfo( ( "Closing file.\n" ) );
 
+            /* Every block has been written, there is nothing left to resume. */
+            imageFileOpen = false;
+            #if ( otaconfigRESUME_AFTER_REBOOT == 1 )
+                ( void ) otaCheckpoint_Erase();
+            #endif
+
             if( closeFile() == true )
             {
                 nextEvent.eventId = OtaAgentEventActivateImage;
@@ -1173,8 +2322,19 @@ STATIC void processOTAEvents()
             {
                 LogInfo( ( "Activated image.\n" ) );
 
-                nextEvent.eventId = OtaAgentEventRequestJobDocument;
-                OtaSendEvent_FreeRTOS( &nextEvent );
+                if( modelInstall.pending )
+                {
+                    /* Nothing was rebooted, go back to the application until
+                     * it is idle, see installModelWhenIdle(). */
+                    LogInfo( ( "Reloaded the ML model, rebooting to install it once the application is idle.\n" ) );
+                    otaAgentState = OtaAgentStateReady;
+                    vOtaNotActiveHook();
+                }
+                else
+                {
+                    nextEvent.eventId = OtaAgentEventRequestJobDocument;
+                    OtaSendEvent_FreeRTOS( &nextEvent );
+                }
             }
 
             break;
@@ -1182,6 +2342,12 @@ STATIC void processOTAEvents()
 
         case OtaAgentEventSuspend:
             LogInfo( ( "Suspending OTA agent.\n" ) );
+
+            if( ( imageFileOpen == true ) && ( otaAgentState != OtaAgentStateSuspended ) )
+            {
+                saveDownloadCheckpoint();
+            }
+
             otaAgentState = OtaAgentStateSuspended;
             break;
 
@@ -1230,7 +2396,10 @@ STATIC BaseType_t prvRunOTADemo( void )
     OtaEventMsg_t initEvent = { 0 };
 
     vWaitUntilMQTTAgentReady();
-    vWaitUntilMQTTAgentConnected();
+
+    /* Jobs and file blocks go over the bulk connection, which connects on
+     * its own. */
+    vWaitUntilMqttAgentConnectionConnected( otaexampleMQTT_AGENT_CONNECTION );
 
     /****************************** Init OTA Library. ******************************/
 
@@ -1241,6 +2410,11 @@ STATIC BaseType_t prvRunOTADemo( void )
 
     /****************************** Create OTA Agent Task. ******************************/
 
+    if( ( xStatus == pdPASS ) && ( otaFlashWriter_Init() == false ) )
+    {
+        xStatus = pdFAIL;
+    }
+
     if( xStatus == pdPASS )
     {
         xStatus = xTaskCreate( prvOTAAgentTask,
@@ -1271,7 +2445,7 @@ STATIC BaseType_t prvRunOTADemo( void )
 
         for( ; ; )
         {
-            if( !xIsMqttAgentConnected() )
+            if( !xIsMqttAgentConnectionConnected( otaexampleMQTT_AGENT_CONNECTION ) )
             {
                 eventMsg.eventId = OtaAgentEventSuspend;
                 OtaSendEvent_FreeRTOS( &eventMsg );
@@ -1297,7 +2471,8 @@ STATIC BaseType_t prvRunOTADemo( void )
      * Remove callback for receiving messages intended for OTA agent from broker,
      * for which the topic has not been subscribed for.
      */
-    removeSubscription( OTA_DEFAULT_TOPIC_FILTER,
+    removeSubscription( pxGetMqttAgentSubscriptionList( otaexampleMQTT_AGENT_CONNECTION ),
+                        OTA_DEFAULT_TOPIC_FILTER,
                         OTA_DEFAULT_TOPIC_FILTER_LENGTH );
 
     return xStatus;
@@ -1339,12 +2514,23 @@ STATIC void vOtaDemoTask( void * pvParam )
         }
     }
 
-    /* Initialize semaphore for buffer operations. */
+    /* Initialize semaphores for buffer and downloader operations. */
     xBufferSemaphore = xSemaphoreCreateMutex();
+    xDownloaderSemaphore = xSemaphoreCreateMutex();
 
-    if( xBufferSemaphore == NULL )
+    if( ( xBufferSemaphore == NULL ) || ( xDownloaderSemaphore == NULL ) )
     {
-        LogError( ( "Failed to initialize buffer semaphore." ) );
+        LogError( ( "Failed to initialize buffer semaphores." ) );
+
+        if( xBufferSemaphore != NULL )
+        {
+            vSemaphoreDelete( xBufferSemaphore );
+        }
+
+        if( xDownloaderSemaphore != NULL )
+        {
+            vSemaphoreDelete( xDownloaderSemaphore );
+        }
     }
     else
     {
@@ -1359,8 +2545,9 @@ STATIC void vOtaDemoTask( void * pvParam )
 
         /* / ****************************** Cleanup ****************************** / */
 
-        /* Cleanup semaphore created for buffer operations. */
+        /* Cleanup semaphores created for buffer and downloader operations. */
         vSemaphoreDelete( xBufferSemaphore );
+        vSemaphoreDelete( xDownloaderSemaphore );
     }
 }
 
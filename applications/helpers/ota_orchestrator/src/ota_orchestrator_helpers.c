@@ -12,6 +12,7 @@
 /* Standard library include. */
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "jobs.h"
 #include "ota_job_processor.h"
@@ -48,6 +49,55 @@ bool convertSignatureToDER( uint8_t * dest,
     return returnVal;
 }
 
+bool convertEcdsaSignatureToRaw( const uint8_t * der,
+                                 size_t derLength,
+                                 uint8_t * raw,
+                                 size_t coordinateLength )
+{
+    bool returnVal = false;
+    size_t index = 0U;
+    size_t integerLength = 0U;
+
+    /* SEQUENCE { INTEGER r, INTEGER s }. The sequence length takes two bytes
+     * for P-384 signatures. */
+    if( ( derLength > 2U ) && ( der[ 0 ] == 0x30U ) )
+    {
+        index = ( der[ 1 ] == 0x81U ) ? 3U : 2U;
+        returnVal = true;
+    }
+
+    for( size_t integer = 0U; ( integer < 2U ) && returnVal; integer++ )
+    {
+        returnVal = ( ( index + 2U ) <= derLength ) && ( der[ index ] == 0x02U );
+
+        if( returnVal )
+        {
+            integerLength = der[ index + 1U ];
+            index += 2U;
+
+            /* Drop the leading zero that keeps a DER integer positive. */
+            while( ( integerLength > coordinateLength ) && ( index < derLength ) && ( der[ index ] == 0U ) )
+            {
+                index++;
+                integerLength--;
+            }
+
+            returnVal = ( integerLength <= coordinateLength ) && ( ( index + integerLength ) <= derLength );
+        }
+
+        if( returnVal )
+        {
+            uint8_t * coordinate = &raw[ integer * coordinateLength ];
+
+            ( void ) memset( coordinate, 0, coordinateLength - integerLength );
+            ( void ) memcpy( &coordinate[ coordinateLength - integerLength ], &der[ index ], integerLength );
+            index += integerLength;
+        }
+    }
+
+    return returnVal;
+}
+
 bool jobDocumentParser( char * message,
                         size_t messageLength,
                         AfrOtaJobDocumentFields_t * jobFields )
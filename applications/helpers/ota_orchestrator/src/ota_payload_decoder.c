@@ -0,0 +1,596 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ota_payload_decoder.h"
+
+/*
+ * An encoded payload is a header followed by a body, produced by
+ * tools/scripts/create_ota_payload.py.
+ *
+ * A compressed body is an LZSS bit stream, most significant bit first. A 1
+ * bit is followed by an 8-bit literal. A 0 bit is followed by a windowBits
+ * wide back reference distance minus one, then a lookaheadBits wide length
+ * minus one. The final byte is padded with 0 bits.
+ *
+ * A delta body, once decompressed, is a sequence of commands, each an opcode
+ * byte followed by an unsigned LEB128 operand:
+ * - COPY_ADD n: n bytes follow, each added to the next source byte.
+ * - INSERT n: n bytes follow, copied as they are.
+ * - SEEK d: move the source offset by d, zigzag encoded.
+ */
+
+#define LZSS_STATE_TAG           0U
+#define LZSS_STATE_LITERAL       1U
+#define LZSS_STATE_INDEX         2U
+#define LZSS_STATE_COUNT         3U
+
+#define DELTA_STATE_OPCODE       0U
+#define DELTA_STATE_OPERAND      1U
+#define DELTA_STATE_DATA         2U
+
+#define DELTA_OPCODE_COPY_ADD    1U
+#define DELTA_OPCODE_INSERT      2U
+#define DELTA_OPCODE_SEEK        3U
+
+/* Smallest LZSS field widths producing a valid stream. */
+#define LZSS_MIN_WINDOW_BITS     4U
+#define LZSS_MIN_LOOKAHEAD_BITS  3U
+
+/* Number of bytes identifying an encoded payload. */
+#define PAYLOAD_MAGIC_LENGTH     4U
+
+/* -------------------------------------------------------------------------- */
+
+static uint32_t readLittleEndian32( const uint8_t * bytes )
+{
+    return ( uint32_t ) bytes[ 0 ] |
+           ( ( uint32_t ) bytes[ 1 ] << 8 ) |
+           ( ( uint32_t ) bytes[ 2 ] << 16 ) |
+           ( ( uint32_t ) bytes[ 3 ] << 24 );
+}
+
+static bool flushOutput( OtaPayloadDecoder_t * decoder )
+{
+    bool written = true;
+
+    if( decoder->outputFill > 0U )
+    {
+        written = decoder->callbacks->writeImage( decoder->outputChunk,
+                                                  decoder->outputFill,
+                                                  decoder->callbacks->context );
+        decoder->outputFill = 0U;
+    }
+
+    return written;
+}
+
+static bool imageHasRoom( const OtaPayloadDecoder_t * decoder,
+                          size_t length )
+{
+    /* An encoded payload must not decode to more than the image size in its
+     * header. */
+    return decoder->passthrough ||
+           ( length <= ( size_t ) ( decoder->header.imageSize - decoder->imageBytes ) );
+}
+
+static bool emitImageByte( OtaPayloadDecoder_t * decoder,
+                           uint8_t byte )
+{
+    bool emitted = imageHasRoom( decoder, 1U );
+
+    if( emitted )
+    {
+        decoder->outputChunk[ decoder->outputFill ] = byte;
+        decoder->outputFill++;
+        decoder->imageBytes++;
+        decoder->copiedBytes++;
+
+        if( decoder->outputFill == sizeof( decoder->outputChunk ) )
+        {
+            emitted = flushOutput( decoder );
+        }
+    }
+
+    return emitted;
+}
+
+/* Write bytes that are already image data straight from where they are,
+ * after the decoded bytes buffered before them. */
+static bool emitImageSpan( OtaPayloadDecoder_t * decoder,
+                           const uint8_t * data,
+                           size_t length )
+{
+    bool emitted = imageHasRoom( decoder, length ) && flushOutput( decoder );
+
+    if( emitted && ( length > 0U ) )
+    {
+        emitted = decoder->callbacks->writeImage( data, length, decoder->callbacks->context );
+        decoder->imageBytes += ( uint32_t ) length;
+    }
+
+    return emitted;
+}
+
+static bool readSourceByte( OtaPayloadDecoder_t * decoder,
+                            uint8_t * byte )
+{
+    bool read = true;
+    size_t length;
+
+    if( decoder->sourceOffset >= decoder->header.sourceSize )
+    {
+        read = false;
+    }
+    else if( ( decoder->sourceOffset < decoder->sourceChunkOffset ) ||
+             ( ( decoder->sourceOffset - decoder->sourceChunkOffset ) >= decoder->sourceChunkLength ) )
+    {
+        length = decoder->header.sourceSize - decoder->sourceOffset;
+
+        if( length > sizeof( decoder->sourceChunk ) )
+        {
+            length = sizeof( decoder->sourceChunk );
+        }
+
+        read = decoder->callbacks->readSource( decoder->sourceOffset,
+                                               decoder->sourceChunk,
+                                               length,
+                                               decoder->callbacks->context );
+        decoder->sourceChunkOffset = decoder->sourceOffset;
+        decoder->sourceChunkLength = read ? length : 0U;
+    }
+    else
+    {
+        /* Already read. */
+    }
+
+    if( read )
+    {
+        *byte = decoder->sourceChunk[ decoder->sourceOffset - decoder->sourceChunkOffset ];
+        decoder->sourceOffset++;
+    }
+
+    return read;
+}
+
+static bool applyDeltaByte( OtaPayloadDecoder_t * decoder,
+                            uint8_t byte )
+{
+    bool applied = true;
+    uint8_t sourceByte = 0U;
+
+    switch( decoder->deltaState )
+    {
+        case DELTA_STATE_OPCODE:
+            decoder->deltaOpcode = byte;
+            decoder->deltaOperand = 0U;
+            decoder->deltaOperandShift = 0U;
+            decoder->deltaState = DELTA_STATE_OPERAND;
+            applied = ( byte >= DELTA_OPCODE_COPY_ADD ) && ( byte <= DELTA_OPCODE_SEEK );
+            break;
+
+        case DELTA_STATE_OPERAND:
+
+            if( ( decoder->deltaOperandShift > 28U ) ||
+                ( ( decoder->deltaOperandShift == 28U ) && ( ( byte & 0x70U ) != 0U ) ) )
+            {
+                /* The operand does not fit in 32 bits. */
+                applied = false;
+                break;
+            }
+
+            decoder->deltaOperand |= ( uint32_t ) ( byte & 0x7FU ) << decoder->deltaOperandShift;
+            decoder->deltaOperandShift += 7U;
+
+            if( ( byte & 0x80U ) == 0U )
+            {
+                if( decoder->deltaOpcode == DELTA_OPCODE_SEEK )
+                {
+                    /* Zigzag decoding, the source offset wraps like an int32_t. */
+                    decoder->sourceOffset += ( decoder->deltaOperand >> 1 ) ^ ( 0U - ( decoder->deltaOperand & 1U ) );
+                    decoder->deltaState = DELTA_STATE_OPCODE;
+                }
+                else
+                {
+                    decoder->deltaRemaining = decoder->deltaOperand;
+                    decoder->deltaState = ( decoder->deltaRemaining > 0U ) ? DELTA_STATE_DATA : DELTA_STATE_OPCODE;
+                }
+            }
+
+            break;
+
+        case DELTA_STATE_DATA:
+
+            if( decoder->deltaOpcode == DELTA_OPCODE_COPY_ADD )
+            {
+                applied = readSourceByte( decoder, &sourceByte );
+            }
+
+            applied = applied && emitImageByte( decoder, ( uint8_t ) ( sourceByte + byte ) );
+            decoder->deltaRemaining--;
+
+            if( decoder->deltaRemaining == 0U )
+            {
+                decoder->deltaState = DELTA_STATE_OPCODE;
+            }
+
+            break;
+
+        default:
+            applied = false;
+            break;
+    }
+
+    return applied;
+}
+
+static bool decodedByte( OtaPayloadDecoder_t * decoder,
+                         uint8_t byte )
+{
+    bool decoded;
+
+    if( ( decoder->header.flags & OTA_PAYLOAD_FLAG_DELTA ) != 0U )
+    {
+        decoded = applyDeltaByte( decoder, byte );
+    }
+    else
+    {
+        decoded = emitImageByte( decoder, byte );
+    }
+
+    return decoded;
+}
+
+static bool lzssOutputByte( OtaPayloadDecoder_t * decoder,
+                            uint8_t byte )
+{
+    uint32_t mask = ( 1UL << decoder->header.windowBits ) - 1U;
+
+    /* windowHead counts every byte decompressed, it is masked into the
+     * window. */
+    decoder->window[ decoder->windowHead & mask ] = byte;
+    decoder->windowHead++;
+
+    return decodedByte( decoder, byte );
+}
+
+/* Repeat count bytes of the window. Without a delta to apply, the run is
+ * checked against the image size once and copied into the output chunk in
+ * one go. */
+static bool lzssOutputRun( OtaPayloadDecoder_t * decoder,
+                           uint32_t count )
+{
+    uint32_t mask = ( 1UL << decoder->header.windowBits ) - 1U;
+    bool decompressed;
+    uint8_t byte;
+
+    if( ( decoder->header.flags & OTA_PAYLOAD_FLAG_DELTA ) != 0U )
+    {
+        decompressed = true;
+
+        while( decompressed && ( count > 0U ) )
+        {
+            decompressed = lzssOutputByte( decoder,
+                                           decoder->window[ ( decoder->windowHead - decoder->backrefIndex ) & mask ] );
+            count--;
+        }
+    }
+    else
+    {
+        decompressed = imageHasRoom( decoder, count );
+
+        while( decompressed && ( count > 0U ) )
+        {
+            byte = decoder->window[ ( decoder->windowHead - decoder->backrefIndex ) & mask ];
+            decoder->window[ decoder->windowHead & mask ] = byte;
+            decoder->windowHead++;
+            decoder->outputChunk[ decoder->outputFill ] = byte;
+            decoder->outputFill++;
+            decoder->imageBytes++;
+            decoder->copiedBytes++;
+            count--;
+
+            if( decoder->outputFill == sizeof( decoder->outputChunk ) )
+            {
+                decompressed = flushOutput( decoder );
+            }
+        }
+    }
+
+    return decompressed;
+}
+
+static uint32_t takeBits( OtaPayloadDecoder_t * decoder,
+                          uint8_t count )
+{
+    decoder->bitCount -= count;
+
+    return ( decoder->bitBuffer >> decoder->bitCount ) & ( ( 1UL << count ) - 1U );
+}
+
+static bool decompressByte( OtaPayloadDecoder_t * decoder,
+                            uint8_t byte )
+{
+    bool decompressed = true;
+    bool progress = true;
+    uint32_t count;
+
+    decoder->bitBuffer = ( decoder->bitBuffer << 8 ) | byte;
+    decoder->bitCount += 8U;
+
+    while( decompressed && progress )
+    {
+        progress = false;
+
+        switch( decoder->lzssState )
+        {
+            case LZSS_STATE_TAG:
+
+                if( decoder->bitCount >= 1U )
+                {
+                    decoder->lzssState = ( takeBits( decoder, 1U ) != 0U ) ? LZSS_STATE_LITERAL : LZSS_STATE_INDEX;
+                    progress = true;
+                }
+
+                break;
+
+            case LZSS_STATE_LITERAL:
+
+                if( decoder->bitCount >= 8U )
+                {
+                    decompressed = lzssOutputByte( decoder, ( uint8_t ) takeBits( decoder, 8U ) );
+                    decoder->lzssState = LZSS_STATE_TAG;
+                    progress = true;
+                }
+
+                break;
+
+            case LZSS_STATE_INDEX:
+
+                if( decoder->bitCount >= decoder->header.windowBits )
+                {
+                    decoder->backrefIndex = takeBits( decoder, decoder->header.windowBits ) + 1U;
+                    decoder->lzssState = LZSS_STATE_COUNT;
+                    progress = true;
+                }
+
+                break;
+
+            case LZSS_STATE_COUNT:
+
+                if( decoder->bitCount >= decoder->header.lookaheadBits )
+                {
+                    count = takeBits( decoder, decoder->header.lookaheadBits ) + 1U;
+
+                    /* A reference before the first byte is invalid. */
+                    decompressed = ( decoder->backrefIndex <= decoder->windowHead ) &&
+                                   lzssOutputRun( decoder, count );
+
+                    decoder->lzssState = LZSS_STATE_TAG;
+                    progress = true;
+                }
+
+                break;
+
+            default:
+                decompressed = false;
+                break;
+        }
+    }
+
+    return decompressed;
+}
+
+static bool parseHeader( OtaPayloadDecoder_t * decoder )
+{
+    OtaPayloadHeader_t * header = &decoder->header;
+    const uint8_t * bytes = decoder->headerBytes;
+    bool valid;
+
+    header->magic = readLittleEndian32( &bytes[ 0 ] );
+    header->version = bytes[ 4 ];
+    header->flags = bytes[ 5 ];
+    header->windowBits = bytes[ 6 ];
+    header->lookaheadBits = bytes[ 7 ];
+    header->imageSize = readLittleEndian32( &bytes[ 8 ] );
+    header->sourceSize = readLittleEndian32( &bytes[ 12 ] );
+    ( void ) memcpy( header->sourceDigest, &bytes[ 16 ], sizeof( header->sourceDigest ) );
+
+    valid = ( header->version == OTA_PAYLOAD_VERSION ) &&
+            ( ( header->flags & ~( OTA_PAYLOAD_FLAG_COMPRESSED | OTA_PAYLOAD_FLAG_DELTA ) ) == 0U );
+
+    if( valid && ( ( header->flags & OTA_PAYLOAD_FLAG_COMPRESSED ) != 0U ) )
+    {
+        valid = ( header->windowBits >= LZSS_MIN_WINDOW_BITS ) &&
+                ( header->windowBits <= OTA_PAYLOAD_MAX_WINDOW_BITS ) &&
+                ( header->lookaheadBits >= LZSS_MIN_LOOKAHEAD_BITS ) &&
+                ( header->lookaheadBits < header->windowBits );
+    }
+
+    if( valid && ( ( header->flags & OTA_PAYLOAD_FLAG_DELTA ) != 0U ) )
+    {
+        valid = ( decoder->callbacks->checkSource != NULL ) &&
+                ( decoder->callbacks->readSource != NULL ) &&
+                decoder->callbacks->checkSource( header, decoder->callbacks->context );
+    }
+
+    decoder->headerParsed = true;
+
+    return valid;
+}
+
+/* Emit the bytes held while looking for the magic number of a file that turns
+ * out to be a plain image. */
+static bool startPassthrough( OtaPayloadDecoder_t * decoder )
+{
+    decoder->passthrough = true;
+
+    return emitImageSpan( decoder, decoder->headerBytes, decoder->headerFill );
+}
+
+static bool headerByte( OtaPayloadDecoder_t * decoder,
+                        uint8_t byte )
+{
+    bool accepted = true;
+
+    decoder->headerBytes[ decoder->headerFill ] = byte;
+    decoder->headerFill++;
+    decoder->copiedBytes++;
+
+    if( ( decoder->headerFill == PAYLOAD_MAGIC_LENGTH ) &&
+        ( readLittleEndian32( decoder->headerBytes ) != OTA_PAYLOAD_MAGIC ) )
+    {
+        accepted = startPassthrough( decoder );
+    }
+    else if( decoder->headerFill == OTA_PAYLOAD_HEADER_SIZE )
+    {
+        accepted = parseHeader( decoder );
+    }
+    else
+    {
+        /* More header bytes to come. */
+    }
+
+    return accepted;
+}
+
+/* Number of the next bytes of an uncompressed body that are image data as
+ * they are: the whole body of a stored payload, or what is left of an INSERT
+ * command of a delta. */
+static size_t literalRunLength( const OtaPayloadDecoder_t * decoder,
+                                size_t available )
+{
+    size_t run = 0U;
+
+    if( ( decoder->header.flags & OTA_PAYLOAD_FLAG_DELTA ) == 0U )
+    {
+        run = available;
+    }
+    else if( ( decoder->deltaState == DELTA_STATE_DATA ) &&
+             ( decoder->deltaOpcode == DELTA_OPCODE_INSERT ) )
+    {
+        run = ( decoder->deltaRemaining < available ) ? decoder->deltaRemaining : available;
+    }
+    else
+    {
+        /* A command, or bytes added to the source. */
+    }
+
+    return run;
+}
+
+static bool emitLiteralRun( OtaPayloadDecoder_t * decoder,
+                            const uint8_t * data,
+                            size_t length )
+{
+    bool emitted = emitImageSpan( decoder, data, length );
+
+    if( ( decoder->header.flags & OTA_PAYLOAD_FLAG_DELTA ) != 0U )
+    {
+        decoder->deltaRemaining -= ( uint32_t ) length;
+
+        if( decoder->deltaRemaining == 0U )
+        {
+            decoder->deltaState = DELTA_STATE_OPCODE;
+        }
+    }
+
+    return emitted;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void otaPayload_Init( OtaPayloadDecoder_t * decoder,
+                      const OtaPayloadInterface_t * callbacks,
+                      bool atFileStart )
+{
+    ( void ) memset( decoder, 0, sizeof( *decoder ) );
+    decoder->callbacks = callbacks;
+    decoder->passthrough = ( atFileStart == false );
+}
+
+bool otaPayload_Decode( OtaPayloadDecoder_t * decoder,
+                        const uint8_t * data,
+                        size_t length )
+{
+    bool decoded = true;
+    size_t offset = 0U;
+    size_t consumed;
+
+    while( ( decoder->failed == false ) && ( offset < length ) )
+    {
+        consumed = 1U;
+
+        if( decoder->passthrough )
+        {
+            /* A plain image is written straight from the received block. */
+            consumed = length - offset;
+            decoded = emitImageSpan( decoder, &data[ offset ], consumed );
+        }
+        else if( decoder->headerParsed == false )
+        {
+            decoded = headerByte( decoder, data[ offset ] );
+        }
+        else if( ( decoder->header.flags & OTA_PAYLOAD_FLAG_COMPRESSED ) != 0U )
+        {
+            decoded = decompressByte( decoder, data[ offset ] );
+        }
+        else if( literalRunLength( decoder, length - offset ) > 0U )
+        {
+            consumed = literalRunLength( decoder, length - offset );
+            decoded = emitLiteralRun( decoder, &data[ offset ], consumed );
+        }
+        else
+        {
+            decoded = decodedByte( decoder, data[ offset ] );
+        }
+
+        decoder->failed = ( decoded == false );
+        offset += consumed;
+    }
+
+    return decoder->failed == false;
+}
+
+bool otaPayload_Finish( OtaPayloadDecoder_t * decoder )
+{
+    bool finished = ( decoder->failed == false );
+
+    if( finished && ( decoder->passthrough == false ) && ( decoder->headerParsed == false ) )
+    {
+        /* A plain image too short to hold the magic number. */
+        finished = ( decoder->headerFill < PAYLOAD_MAGIC_LENGTH ) && startPassthrough( decoder );
+    }
+
+    if( finished && ( decoder->passthrough == false ) )
+    {
+        finished = ( decoder->imageBytes == decoder->header.imageSize ) &&
+                   ( decoder->deltaState == DELTA_STATE_OPCODE );
+    }
+
+    finished = finished && flushOutput( decoder );
+    decoder->failed = ( finished == false );
+
+    return finished;
+}
+
+bool otaPayload_IsEncoded( const OtaPayloadDecoder_t * decoder )
+{
+    return decoder->headerParsed && ( decoder->passthrough == false );
+}
+
+uint32_t otaPayload_GetCopiedBytes( const OtaPayloadDecoder_t * decoder )
+{
+    return decoder->copiedBytes;
+}
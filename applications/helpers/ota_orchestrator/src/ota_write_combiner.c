@@ -0,0 +1,88 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ota_write_combiner.h"
+
+/**
+ * @brief Submit the buffer being filled and move on to the next one.
+ */
+static bool submitBuffer( OtaWriteCombiner_t * combiner )
+{
+    uint32_t offset = combiner->bufferOffset;
+    size_t length = combiner->bufferFill;
+
+    combiner->bufferOffset += ( uint32_t ) length;
+    combiner->bufferFill = 0U;
+    combiner->buffer = combiner->submit( combiner->buffer, offset, length, combiner->context );
+
+    return combiner->buffer != NULL;
+}
+
+void otaWriteCombiner_Init( OtaWriteCombiner_t * combiner,
+                            size_t sectorSize,
+                            uint32_t startOffset,
+                            uint8_t * buffer,
+                            OtaWriteCombinerSubmit_t submit,
+                            void * context )
+{
+    combiner->buffer = buffer;
+    combiner->sectorSize = sectorSize;
+    combiner->bufferOffset = startOffset;
+    combiner->bufferFill = 0U;
+    combiner->submit = submit;
+    combiner->context = context;
+}
+
+bool otaWriteCombiner_Append( OtaWriteCombiner_t * combiner,
+                              const uint8_t * data,
+                              size_t length )
+{
+    size_t chunkLength;
+    size_t copyLength;
+
+    while( ( combiner->buffer != NULL ) && ( length > 0U ) )
+    {
+        /* A buffer stops at the sector boundary after its first byte. */
+        chunkLength = combiner->sectorSize - ( combiner->bufferOffset % combiner->sectorSize );
+        copyLength = chunkLength - combiner->bufferFill;
+
+        if( copyLength > length )
+        {
+            copyLength = length;
+        }
+
+        ( void ) memcpy( &combiner->buffer[ combiner->bufferFill ], data, copyLength );
+        combiner->bufferFill += copyLength;
+        data += copyLength;
+        length -= copyLength;
+
+        if( combiner->bufferFill == chunkLength )
+        {
+            ( void ) submitBuffer( combiner );
+        }
+    }
+
+    return combiner->buffer != NULL;
+}
+
+bool otaWriteCombiner_Flush( OtaWriteCombiner_t * combiner )
+{
+    if( ( combiner->buffer != NULL ) && ( combiner->bufferFill > 0U ) )
+    {
+        ( void ) submitBuffer( combiner );
+    }
+
+    return combiner->buffer != NULL;
+}
@@ -0,0 +1,15 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OTA_CONFIG_H
+#define OTA_CONFIG_H
+
+#define otaconfigCHECKPOINT_STORAGE_UID    ( 0x4F544143UL )
+
+/* The download window of the applications. */
+#define otaconfigFILE_REQUEST_WAIT_MS      10000U
+#define otaconfigMAX_NUM_BLOCKS_REQUEST    4U
+
+#endif /* OTA_CONFIG_H */
@@ -0,0 +1,216 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <vector>
+
+#include "fff.h"
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ota_delta_source.h"
+#include "ota_payload_decoder.h"
+#include "psa/crypto.h"
+#include "psa/error.h"
+}
+
+#define COPY_ADD    1U
+
+/* The image of the slot is followed by erased flash. */
+static const size_t imageSize = 300U;
+static const size_t slotSize = 512U;
+
+/* Stands in for SHA-256, any change of the input changes the digest. */
+static psa_status_t fake_hash( psa_algorithm_t alg,
+                               const uint8_t * input,
+                               size_t inputLength,
+                               uint8_t * hash,
+                               size_t hashSize,
+                               size_t * hashLength )
+{
+    ( void ) alg;
+
+    memset( hash, 0, hashSize );
+
+    for( size_t i = 0; i < inputLength; i++ )
+    {
+        hash[ i % hashSize ] = ( uint8_t ) ( ( hash[ i % hashSize ] * 31U ) + input[ i ] + 1U );
+    }
+
+    *hashLength = hashSize;
+
+    return PSA_SUCCESS;
+}
+
+static OtaPayloadHeader_t header_for( const std::vector< uint8_t > & image )
+{
+    OtaPayloadHeader_t header = {};
+    size_t digestLength = 0U;
+
+    header.sourceSize = image.size();
+    ( void ) fake_hash( PSA_ALG_SHA_256, image.data(), image.size(), header.sourceDigest,
+                        sizeof( header.sourceDigest ), &digestLength );
+
+    return header;
+}
+
+class TestOtaDeltaSource : public ::testing::Test {
+public:
+    TestOtaDeltaSource() : slot( slotSize, 0xFFU )
+    {
+        RESET_FAKE( psa_hash_compute );
+        psa_hash_compute_fake.custom_fake = fake_hash;
+
+        for( size_t i = 0; i < imageSize; i++ )
+        {
+            slot[ i ] = ( uint8_t ) ( i * 7U );
+        }
+    }
+
+    std::vector< uint8_t > image()
+    {
+        return std::vector< uint8_t >( slot.begin(), slot.begin() + imageSize );
+    }
+
+    std::vector< uint8_t > slot;
+};
+
+TEST_F( TestOtaDeltaSource, a_delta_made_against_the_image_in_the_slot_matches )
+{
+    OtaPayloadHeader_t header = header_for( image() );
+
+    EXPECT_TRUE( otaDeltaSource_Matches( &header, slot.data(), slot.size() ) );
+    EXPECT_EQ( psa_hash_compute_fake.call_count, 1U );
+    EXPECT_EQ( psa_hash_compute_fake.arg0_val, PSA_ALG_SHA_256 );
+    EXPECT_EQ( psa_hash_compute_fake.arg1_val, slot.data() );
+    EXPECT_EQ( psa_hash_compute_fake.arg2_val, imageSize );
+}
+
+TEST_F( TestOtaDeltaSource, a_delta_made_against_another_image_does_not_match )
+{
+    std::vector< uint8_t > other = image();
+
+    other[ 100 ] ^= 0x01U;
+
+    OtaPayloadHeader_t header = header_for( other );
+
+    EXPECT_FALSE( otaDeltaSource_Matches( &header, slot.data(), slot.size() ) );
+}
+
+TEST_F( TestOtaDeltaSource, a_source_larger_than_the_slot_does_not_match )
+{
+    OtaPayloadHeader_t header = header_for( std::vector< uint8_t >( slotSize + 1U, 0xFFU ) );
+
+    EXPECT_FALSE( otaDeltaSource_Matches( &header, slot.data(), slot.size() ) );
+    EXPECT_EQ( psa_hash_compute_fake.call_count, 0U );
+}
+
+TEST_F( TestOtaDeltaSource, a_failed_hash_does_not_match )
+{
+    OtaPayloadHeader_t header = header_for( image() );
+
+    psa_hash_compute_fake.custom_fake = NULL;
+    psa_hash_compute_fake.return_val = PSA_ERROR_PROGRAMMER_ERROR;
+
+    EXPECT_FALSE( otaDeltaSource_Matches( &header, slot.data(), slot.size() ) );
+    EXPECT_FALSE( otaDeltaSource_Matches( NULL, slot.data(), slot.size() ) );
+    EXPECT_FALSE( otaDeltaSource_Matches( &header, NULL, slot.size() ) );
+}
+
+TEST_F( TestOtaDeltaSource, reads_stay_within_the_slot )
+{
+    uint8_t data[ 16 ];
+
+    EXPECT_TRUE( otaDeltaSource_Read( slot.data(), slot.size(), 10U, data, sizeof( data ) ) );
+    EXPECT_EQ( memcmp( data, &slot[ 10 ], sizeof( data ) ), 0 );
+
+    EXPECT_TRUE( otaDeltaSource_Read( slot.data(), slot.size(), slotSize - sizeof( data ), data, sizeof( data ) ) );
+    EXPECT_FALSE( otaDeltaSource_Read( slot.data(), slot.size(), slotSize - sizeof( data ) + 1U, data, sizeof( data ) ) );
+    EXPECT_FALSE( otaDeltaSource_Read( slot.data(), slot.size(), slotSize + 1U, data, 0U ) );
+    EXPECT_FALSE( otaDeltaSource_Read( slot.data(), slot.size(), 0xFFFFFFFFU, data, sizeof( data ) ) );
+}
+
+/* The decoder reads the running image from the slot, as the OTA agent does. */
+static std::vector< uint8_t > decodedImage;
+static std::vector< uint8_t > * deltaSlot;
+
+static bool write_image( const uint8_t * data,
+                         size_t length,
+                         void * context )
+{
+    ( void ) context;
+
+    decodedImage.insert( decodedImage.end(), data, data + length );
+
+    return true;
+}
+
+static bool check_source( const OtaPayloadHeader_t * header,
+                          void * context )
+{
+    ( void ) context;
+
+    return otaDeltaSource_Matches( header, deltaSlot->data(), deltaSlot->size() );
+}
+
+static bool read_source( uint32_t offset,
+                         uint8_t * data,
+                         size_t length,
+                         void * context )
+{
+    ( void ) context;
+
+    return otaDeltaSource_Read( deltaSlot->data(), deltaSlot->size(), offset, data, length );
+}
+
+static const OtaPayloadInterface_t callbacks = { write_image, check_source, read_source, NULL };
+
+TEST_F( TestOtaDeltaSource, a_delta_payload_is_applied_to_the_image_in_the_slot )
+{
+    OtaPayloadDecoder_t decoder;
+    std::vector< uint8_t > expected = image();
+    OtaPayloadHeader_t header = header_for( expected );
+    std::vector< uint8_t > file = { 'O', 'T', 'A', 'P', OTA_PAYLOAD_VERSION, OTA_PAYLOAD_FLAG_DELTA, 8U, 4U };
+
+    for( uint32_t value : { ( uint32_t ) imageSize, header.sourceSize } )
+    {
+        for( int shift = 0; shift < 32; shift += 8 )
+        {
+            file.push_back( ( uint8_t ) ( value >> shift ) );
+        }
+    }
+
+    file.insert( file.end(), header.sourceDigest, header.sourceDigest + sizeof( header.sourceDigest ) );
+    ASSERT_EQ( file.size(), OTA_PAYLOAD_HEADER_SIZE );
+
+    /* The whole image, every 50th byte plus one. */
+    file.push_back( COPY_ADD );
+    file.push_back( ( uint8_t ) ( ( imageSize & 0x7FU ) | 0x80U ) );
+    file.push_back( ( uint8_t ) ( imageSize >> 7 ) );
+
+    for( size_t i = 0; i < imageSize; i++ )
+    {
+        file.push_back( ( i % 50U == 0U ) ? 1U : 0U );
+        expected[ i ] += ( i % 50U == 0U ) ? 1U : 0U;
+    }
+
+    decodedImage.clear();
+    deltaSlot = &slot;
+    otaPayload_Init( &decoder, &callbacks, true );
+
+    EXPECT_TRUE( otaPayload_Decode( &decoder, file.data(), file.size() ) );
+    EXPECT_TRUE( otaPayload_Finish( &decoder ) );
+    EXPECT_EQ( decodedImage, expected );
+
+    /* The same payload does not apply once the slot holds another image. */
+    slot[ 0 ] ^= 0x01U;
+    decodedImage.clear();
+    otaPayload_Init( &decoder, &callbacks, true );
+
+    EXPECT_FALSE( otaPayload_Decode( &decoder, file.data(), file.size() ) );
+    EXPECT_TRUE( decodedImage.empty() );
+}
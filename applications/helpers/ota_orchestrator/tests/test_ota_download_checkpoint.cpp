@@ -0,0 +1,404 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "fff.h"
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ota_download_checkpoint.h"
+#include "psa/protected_storage.h"
+}
+
+DEFINE_FFF_GLOBALS
+
+/* Contents of the protected storage asset standing in for the checkpoint. */
+static std::vector< uint8_t > storedAsset;
+static bool assetStored;
+
+static psa_status_t store_asset( psa_storage_uid_t uid,
+                                 size_t data_length,
+                                 const void * p_data,
+                                 psa_storage_create_flags_t create_flags )
+{
+    const uint8_t * data = ( const uint8_t * ) p_data;
+
+    storedAsset.assign( data, data + data_length );
+    assetStored = true;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t read_asset( psa_storage_uid_t uid,
+                                size_t data_offset,
+                                size_t data_size,
+                                void * p_data,
+                                size_t * p_data_length )
+{
+    psa_status_t status = PSA_ERROR_DOES_NOT_EXIST;
+
+    if( assetStored )
+    {
+        *p_data_length = std::min( data_size, storedAsset.size() - data_offset );
+        memcpy( p_data, storedAsset.data() + data_offset, *p_data_length );
+        status = PSA_SUCCESS;
+    }
+
+    return status;
+}
+
+static psa_status_t remove_asset( psa_storage_uid_t uid )
+{
+    psa_status_t status = assetStored ? PSA_SUCCESS : PSA_ERROR_DOES_NOT_EXIST;
+
+    storedAsset.clear();
+    assetStored = false;
+
+    return status;
+}
+
+class TestOtaDownloadCheckpoint : public ::testing::Test {
+public:
+    TestOtaDownloadCheckpoint()
+    {
+        RESET_FAKE( psa_ps_set );
+        RESET_FAKE( psa_ps_get );
+        RESET_FAKE( psa_ps_remove );
+
+        psa_ps_set_fake.custom_fake = store_asset;
+        psa_ps_get_fake.custom_fake = read_asset;
+        psa_ps_remove_fake.custom_fake = remove_asset;
+
+        storedAsset.clear();
+        assetStored = false;
+
+        otaCheckpoint_Reset( &checkpoint, "job-1", 5, 1, 100 * 4096 );
+    }
+
+    OtaDownloadCheckpoint_t checkpoint;
+};
+
+TEST_F( TestOtaDownloadCheckpoint, reset_starts_with_no_block_received )
+{
+    EXPECT_EQ( otaCheckpoint_GetReceivedBlockCount( &checkpoint ), 0 );
+    EXPECT_FALSE( otaCheckpoint_IsBlockReceived( &checkpoint, 0 ) );
+    EXPECT_EQ( checkpoint.bytesReceived, 0 );
+    EXPECT_STREQ( checkpoint.jobId, "job-1" );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, reset_truncates_a_job_id_too_long_to_be_held )
+{
+    char jobId[ OTA_CHECKPOINT_MAX_JOB_ID_LENGTH + 8 ];
+
+    memset( jobId, 'a', sizeof( jobId ) );
+    otaCheckpoint_Reset( &checkpoint, jobId, sizeof( jobId ), 1, 4096 );
+
+    EXPECT_EQ( strlen( checkpoint.jobId ), OTA_CHECKPOINT_MAX_JOB_ID_LENGTH - 1 );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, in_order_blocks_slide_the_window )
+{
+    EXPECT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 0, 4096 ) );
+    EXPECT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 1, 4096 ) );
+
+    EXPECT_EQ( checkpoint.windowBaseBlock, 2 );
+    EXPECT_EQ( checkpoint.windowReceivedBitmap, 0 );
+    EXPECT_EQ( checkpoint.bytesReceived, 2 * 4096 );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, out_of_order_blocks_are_remembered_until_the_gap_is_filled )
+{
+    EXPECT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 2, 4096 ) );
+    EXPECT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 1, 4096 ) );
+
+    EXPECT_EQ( checkpoint.windowBaseBlock, 0 );
+    EXPECT_TRUE( otaCheckpoint_IsBlockReceived( &checkpoint, 2 ) );
+    EXPECT_FALSE( otaCheckpoint_IsBlockReceived( &checkpoint, 0 ) );
+    EXPECT_EQ( otaCheckpoint_GetReceivedBlockCount( &checkpoint ), 2 );
+
+    EXPECT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 0, 4096 ) );
+
+    EXPECT_EQ( checkpoint.windowBaseBlock, 3 );
+    EXPECT_EQ( checkpoint.windowReceivedBitmap, 0 );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, the_window_ends_past_the_first_missing_block_or_at_the_last_block )
+{
+    EXPECT_EQ( otaCheckpoint_GetWindowEnd( &checkpoint, 4, 10 ), 4 );
+
+    ASSERT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 0, 4096 ) );
+    ASSERT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 2, 4096 ) );
+
+    EXPECT_EQ( otaCheckpoint_GetWindowEnd( &checkpoint, 4, 10 ), 5 );
+    EXPECT_EQ( otaCheckpoint_GetWindowEnd( &checkpoint, 4, 3 ), 3 );
+    EXPECT_EQ( otaCheckpoint_GetWindowEnd( &checkpoint, 4, 0 ), 0 );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, missing_blocks_are_found_run_by_run )
+{
+    uint32_t runStart = 0;
+
+    ASSERT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 0, 4096 ) );
+    ASSERT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 3, 4096 ) );
+    ASSERT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 4, 4096 ) );
+
+    EXPECT_EQ( otaCheckpoint_FindMissingRun( &checkpoint, 0, 8, &runStart ), 2 );
+    EXPECT_EQ( runStart, 1 );
+    EXPECT_EQ( otaCheckpoint_FindMissingRun( &checkpoint, 3, 8, &runStart ), 3 );
+    EXPECT_EQ( runStart, 5 );
+    EXPECT_EQ( otaCheckpoint_FindMissingRun( &checkpoint, 2, 3, &runStart ), 1 );
+    EXPECT_EQ( runStart, 2 );
+
+    runStart = 42;
+    EXPECT_EQ( otaCheckpoint_FindMissingRun( &checkpoint, 3, 5, &runStart ), 0 );
+    EXPECT_EQ( otaCheckpoint_FindMissingRun( &checkpoint, 8, 8, &runStart ), 0 );
+    EXPECT_EQ( runStart, 42 );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, duplicate_blocks_are_not_marked_twice )
+{
+    EXPECT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 3, 4096 ) );
+    EXPECT_FALSE( otaCheckpoint_MarkBlockReceived( &checkpoint, 3, 4096 ) );
+    EXPECT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, 0, 4096 ) );
+    EXPECT_FALSE( otaCheckpoint_MarkBlockReceived( &checkpoint, 0, 4096 ) );
+
+    EXPECT_EQ( checkpoint.bytesReceived, 2 * 4096 );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, blocks_past_the_tracked_window_are_not_marked )
+{
+    EXPECT_FALSE( otaCheckpoint_MarkBlockReceived( &checkpoint, OTA_CHECKPOINT_WINDOW_BLOCKS, 4096 ) );
+    EXPECT_FALSE( otaCheckpoint_IsBlockReceived( &checkpoint, OTA_CHECKPOINT_WINDOW_BLOCKS ) );
+    EXPECT_TRUE( otaCheckpoint_MarkBlockReceived( &checkpoint, OTA_CHECKPOINT_WINDOW_BLOCKS - 1, 4096 ) );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, matches_only_the_same_job_file_and_size )
+{
+    EXPECT_TRUE( otaCheckpoint_MatchesJob( &checkpoint, "job-1", 5, 1, 100 * 4096 ) );
+    EXPECT_FALSE( otaCheckpoint_MatchesJob( &checkpoint, "job-2", 5, 1, 100 * 4096 ) );
+    EXPECT_FALSE( otaCheckpoint_MatchesJob( &checkpoint, "job-1", 4, 1, 100 * 4096 ) );
+    EXPECT_FALSE( otaCheckpoint_MatchesJob( &checkpoint, "job-10", 6, 1, 100 * 4096 ) );
+    EXPECT_FALSE( otaCheckpoint_MatchesJob( &checkpoint, "job-1", 5, 2, 100 * 4096 ) );
+    EXPECT_FALSE( otaCheckpoint_MatchesJob( &checkpoint, "job-1", 5, 1, 99 * 4096 ) );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, saved_checkpoint_is_loaded_back )
+{
+    OtaDownloadCheckpoint_t loaded;
+
+    ( void ) otaCheckpoint_MarkBlockReceived( &checkpoint, 0, 4096 );
+    ( void ) otaCheckpoint_MarkBlockReceived( &checkpoint, 5, 4096 );
+
+    EXPECT_EQ( otaCheckpoint_Save( &checkpoint ), OtaCheckpointSuccess );
+    EXPECT_EQ( otaCheckpoint_Load( &loaded ), OtaCheckpointSuccess );
+
+    EXPECT_EQ( memcmp( &loaded, &checkpoint, sizeof( checkpoint ) ), 0 );
+    EXPECT_EQ( psa_ps_set_fake.arg0_val, psa_ps_get_fake.arg0_val );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, image_hash_state_is_loaded_back )
+{
+    OtaDownloadCheckpoint_t loaded;
+
+    EXPECT_EQ( checkpoint.imageHashSaved, 0 );
+
+    for( size_t i = 0; i < sizeof( checkpoint.imageHashState ); i++ )
+    {
+        checkpoint.imageHashState[ i ] = ( uint8_t ) ( i * 3 + 1 );
+    }
+
+    checkpoint.imageHashSaved = 1;
+
+    ASSERT_EQ( otaCheckpoint_Save( &checkpoint ), OtaCheckpointSuccess );
+    ASSERT_EQ( otaCheckpoint_Load( &loaded ), OtaCheckpointSuccess );
+
+    EXPECT_EQ( loaded.imageHashSaved, 1 );
+    EXPECT_EQ( memcmp( loaded.imageHashState, checkpoint.imageHashState, sizeof( checkpoint.imageHashState ) ), 0 );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, save_errors_if_protected_storage_fails )
+{
+    psa_ps_set_fake.custom_fake = nullptr;
+    psa_ps_set_fake.return_val = PSA_ERROR_STORAGE_FAILURE;
+
+    EXPECT_EQ( otaCheckpoint_Save( &checkpoint ), OtaCheckpointStorageError );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, load_reports_a_missing_checkpoint )
+{
+    OtaDownloadCheckpoint_t loaded;
+
+    EXPECT_EQ( otaCheckpoint_Load( &loaded ), OtaCheckpointNotFound );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, load_rejects_a_checkpoint_of_another_size )
+{
+    OtaDownloadCheckpoint_t loaded;
+
+    ( void ) store_asset( 0, sizeof( checkpoint ) - 4, &checkpoint, PSA_STORAGE_FLAG_NONE );
+
+    EXPECT_EQ( otaCheckpoint_Load( &loaded ), OtaCheckpointInvalid );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, load_rejects_a_checkpoint_of_another_version )
+{
+    OtaDownloadCheckpoint_t loaded;
+
+    checkpoint.version++;
+    ( void ) otaCheckpoint_Save( &checkpoint );
+
+    EXPECT_EQ( otaCheckpoint_Load( &loaded ), OtaCheckpointInvalid );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, load_errors_if_protected_storage_fails )
+{
+    OtaDownloadCheckpoint_t loaded;
+
+    psa_ps_get_fake.custom_fake = nullptr;
+    psa_ps_get_fake.return_val = PSA_ERROR_STORAGE_FAILURE;
+
+    EXPECT_EQ( otaCheckpoint_Load( &loaded ), OtaCheckpointStorageError );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, erase_removes_the_checkpoint )
+{
+    OtaDownloadCheckpoint_t loaded;
+
+    ( void ) otaCheckpoint_Save( &checkpoint );
+
+    EXPECT_EQ( otaCheckpoint_Erase(), OtaCheckpointSuccess );
+    EXPECT_EQ( otaCheckpoint_Load( &loaded ), OtaCheckpointNotFound );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, erasing_a_missing_checkpoint_succeeds )
+{
+    EXPECT_EQ( otaCheckpoint_Erase(), OtaCheckpointSuccess );
+}
+
+TEST_F( TestOtaDownloadCheckpoint, erase_errors_if_protected_storage_fails )
+{
+    psa_ps_remove_fake.custom_fake = nullptr;
+    psa_ps_remove_fake.return_val = PSA_ERROR_STORAGE_FAILURE;
+
+    EXPECT_EQ( otaCheckpoint_Erase(), OtaCheckpointStorageError );
+}
+
+/* Download an image of numBlocks blocks the way the OTA orchestrator does:
+ * keep a window of blocks requested, receive them in random order with
+ * duplicates, and checkpoint every interval blocks. The link drops at random
+ * points. Half of the drops save a checkpoint, as on a disconnection, the
+ * other half lose every block written since the last checkpoint, as on a
+ * power loss. Each drop restarts from the checkpoint held in storage. */
+static void download_with_random_interruptions( uint32_t seed )
+{
+    const uint32_t numBlocks = 300;
+    const uint32_t windowBlocks = 8;
+    const uint32_t interval = 16;
+    const uint32_t blockSize = 4096;
+    std::mt19937 rng( seed );
+    std::vector< uint8_t > image( numBlocks, 0 );
+    std::vector< uint32_t > writes( numBlocks, 0 );
+    OtaDownloadCheckpoint_t progress;
+    uint32_t sinceCheckpoint = 0;
+    uint32_t interruptions = 0;
+
+    otaCheckpoint_Reset( &progress, "job-1", 5, 1, numBlocks * blockSize );
+    ASSERT_EQ( otaCheckpoint_Save( &progress ), OtaCheckpointSuccess );
+
+    while( otaCheckpoint_GetReceivedBlockCount( &progress ) < numBlocks )
+    {
+        std::vector< uint32_t > inFlight;
+        uint32_t windowEnd = std::min( progress.windowBaseBlock + windowBlocks, numBlocks );
+        bool interrupted = false;
+
+        for( uint32_t block = progress.windowBaseBlock; block < windowEnd; block++ )
+        {
+            if( !otaCheckpoint_IsBlockReceived( &progress, block ) )
+            {
+                inFlight.push_back( block );
+            }
+        }
+
+        std::shuffle( inFlight.begin(), inFlight.end(), rng );
+
+        for( uint32_t block : inFlight )
+        {
+            if( ( rng() % 25 ) == 0 )
+            {
+                interrupted = true;
+                break;
+            }
+
+            /* The block is written to flash before it is recorded. */
+            image[ block ] = ( uint8_t ) ( block * 7 + 1 );
+            writes[ block ]++;
+            ASSERT_TRUE( otaCheckpoint_MarkBlockReceived( &progress, block, blockSize ) );
+
+            if( ( rng() % 8 ) == 0 )
+            {
+                EXPECT_FALSE( otaCheckpoint_MarkBlockReceived( &progress, block, blockSize ) );
+            }
+
+            if( ++sinceCheckpoint >= interval )
+            {
+                ASSERT_EQ( otaCheckpoint_Save( &progress ), OtaCheckpointSuccess );
+                sinceCheckpoint = 0;
+            }
+        }
+
+        if( interrupted )
+        {
+            interruptions++;
+
+            if( ( rng() % 2 ) == 0 )
+            {
+                ASSERT_EQ( otaCheckpoint_Save( &progress ), OtaCheckpointSuccess );
+            }
+
+            /* Nothing but the flash and the stored checkpoint survives. */
+            memset( &progress, 0xA5, sizeof( progress ) );
+            sinceCheckpoint = 0;
+
+            ASSERT_EQ( otaCheckpoint_Load( &progress ), OtaCheckpointSuccess );
+            ASSERT_TRUE( otaCheckpoint_MatchesJob( &progress, "job-1", 5, 1, numBlocks * blockSize ) );
+
+            /* A checkpoint never records a block that is not in flash. */
+            for( uint32_t block = 0; block < numBlocks; block++ )
+            {
+                if( otaCheckpoint_IsBlockReceived( &progress, block ) )
+                {
+                    ASSERT_EQ( image[ block ], ( uint8_t ) ( block * 7 + 1 ) ) << "block " << block;
+                }
+            }
+        }
+    }
+
+    EXPECT_GT( interruptions, 0 );
+    EXPECT_EQ( progress.windowBaseBlock, numBlocks );
+    EXPECT_EQ( progress.windowReceivedBitmap, 0 );
+
+    for( uint32_t block = 0; block < numBlocks; block++ )
+    {
+        EXPECT_EQ( image[ block ], ( uint8_t ) ( block * 7 + 1 ) ) << "block " << block;
+
+        /* Only blocks lost with a power loss are written more than once. */
+        EXPECT_LE( writes[ block ], 1 + interruptions ) << "block " << block;
+    }
+}
+
+TEST_F( TestOtaDownloadCheckpoint, download_resumes_after_random_interruptions )
+{
+    for( uint32_t seed = 1; seed <= 50; seed++ )
+    {
+        SCOPED_TRACE( seed );
+        download_with_random_interruptions( seed );
+    }
+}
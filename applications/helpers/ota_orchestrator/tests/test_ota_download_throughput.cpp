@@ -0,0 +1,250 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "fff.h"
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ota_config.h"
+#include "ota_download_checkpoint.h"
+}
+
+DEFINE_FFF_GLOBALS
+
+static const uint32_t blockSize = 4096U;
+static const uint32_t numBlocks = 256U;
+
+/* A broker a 60 ms round trip away, sending at 1 MB/s. */
+static const double linkLatencyMs = 30.0;
+static const double linkBytesPerMs = 1000.0;
+
+/* Simulates the download of a file from an MQTT file streams server. The
+ * server queues the blocks of each GetStream request and sends them one
+ * after the other over the link. The client keeps its window of blocks
+ * requested the way the OTA orchestrator does, with the window helpers of
+ * the download checkpoint. Time is simulated, in milliseconds. */
+class StreamDownload
+{
+public:
+    StreamDownload( uint32_t windowBlocks,
+                    uint32_t lossPeriod = 0U ) :
+        windowBlocks( windowBlocks ),
+        lossPeriod( lossPeriod ),
+        received( numBlocks, 0U )
+    {
+        otaCheckpoint_Reset( &progress, "job-1", 5, 1, numBlocks * blockSize );
+    }
+
+    /* Runs the download, returns the throughput in MB/s. */
+    double run()
+    {
+        requestWindowBlocks();
+
+        while( ( otaCheckpoint_GetReceivedBlockCount( &progress ) < numBlocks ) && ( rounds < 100000U ) )
+        {
+            double timeoutAt = lastActivity + otaconfigFILE_REQUEST_WAIT_MS;
+
+            if( events.empty() || ( events.top().at > timeoutAt ) )
+            {
+                now = timeoutAt;
+                lastActivity = now;
+                timeouts++;
+                requestMissingBlocks();
+            }
+            else
+            {
+                Event event = events.top();
+
+                events.pop();
+                now = event.at;
+
+                if( event.request )
+                {
+                    serve( event.block, event.count );
+                }
+                else
+                {
+                    blockArrived( event.block );
+                }
+            }
+
+            rounds++;
+        }
+
+        return ( numBlocks * blockSize ) / now / 1000.0;
+    }
+
+    uint32_t windowBlocks;
+    uint32_t lossPeriod;
+    OtaDownloadCheckpoint_t progress;
+    std::vector< uint32_t > received;
+    uint32_t requests = 0U;
+    uint32_t sent = 0U;
+    uint32_t timeouts = 0U;
+
+private:
+    struct Event
+    {
+        double at;
+        bool request;
+        uint32_t block;
+        uint32_t count;
+
+        bool operator>( const Event & other ) const
+        {
+            return at > other.at;
+        }
+    };
+
+    void request( uint32_t block,
+                  uint32_t count )
+    {
+        requests++;
+        events.push( { now + linkLatencyMs, true, block, count } );
+    }
+
+    /* As requestWindowBlocks() of the orchestrator. */
+    void requestWindowBlocks()
+    {
+        uint32_t windowEnd = otaCheckpoint_GetWindowEnd( &progress, windowBlocks, numBlocks );
+
+        if( nextBlockToRequest < windowEnd )
+        {
+            request( nextBlockToRequest, windowEnd - nextBlockToRequest );
+            nextBlockToRequest = windowEnd;
+        }
+    }
+
+    /* As requestMissingBlocks() of the orchestrator. */
+    void requestMissingBlocks()
+    {
+        uint32_t runStart = progress.windowBaseBlock;
+        uint32_t runLength = 0U;
+
+        do
+        {
+            runLength = otaCheckpoint_FindMissingRun( &progress, runStart + runLength, nextBlockToRequest, &runStart );
+
+            if( runLength > 0U )
+            {
+                request( runStart, runLength );
+            }
+        } while( runLength > 0U );
+    }
+
+    void serve( uint32_t block,
+                uint32_t count )
+    {
+        for( uint32_t i = 0; i < count; i++ )
+        {
+            linkFreeAt = std::max( linkFreeAt, now ) + ( blockSize / linkBytesPerMs );
+            sent++;
+
+            if( ( lossPeriod == 0U ) || ( ( sent % lossPeriod ) != 0U ) )
+            {
+                events.push( { linkFreeAt + linkLatencyMs, false, block + i, 0U } );
+            }
+        }
+    }
+
+    /* As handling OtaAgentEventReceivedFileBlock in the orchestrator. */
+    void blockArrived( uint32_t block )
+    {
+        if( ( block >= progress.windowBaseBlock ) &&
+            ( block < nextBlockToRequest ) &&
+            otaCheckpoint_MarkBlockReceived( &progress, block, blockSize ) )
+        {
+            received[ block ]++;
+            lastActivity = now;
+
+            if( nextBlockToRequest < ( progress.windowBaseBlock + windowBlocks ) )
+            {
+                requestWindowBlocks();
+            }
+        }
+    }
+
+    std::priority_queue< Event, std::vector< Event >, std::greater< Event > > events;
+    uint32_t nextBlockToRequest = 0U;
+    double now = 0.0;
+    double lastActivity = 0.0;
+    double linkFreeAt = 0.0;
+    uint32_t rounds = 0U;
+};
+
+TEST( TestOtaDownloadThroughput, the_window_hides_the_round_trip_per_block )
+{
+    StreamDownload oneBlock( 1U );
+    StreamDownload window( otaconfigMAX_NUM_BLOCKS_REQUEST );
+    double oneBlockMBps = oneBlock.run();
+    double windowMBps = window.run();
+
+    EXPECT_GT( windowMBps, 0.9 * otaconfigMAX_NUM_BLOCKS_REQUEST * oneBlockMBps );
+
+    /* A window past the bandwidth-delay product fills the link. */
+    StreamDownload fullWindow( OTA_CHECKPOINT_WINDOW_BLOCKS );
+
+    EXPECT_GT( fullWindow.run(), 0.9 * linkBytesPerMs / 1000.0 );
+}
+
+TEST( TestOtaDownloadThroughput, each_block_is_written_once_with_one_request_per_slid_block )
+{
+    StreamDownload download( otaconfigMAX_NUM_BLOCKS_REQUEST );
+
+    ( void ) download.run();
+
+    EXPECT_EQ( download.progress.windowBaseBlock, numBlocks );
+    EXPECT_EQ( download.sent, numBlocks );
+    EXPECT_EQ( download.requests, numBlocks - otaconfigMAX_NUM_BLOCKS_REQUEST + 1U );
+    EXPECT_EQ( download.timeouts, 0U );
+
+    for( uint32_t block = 0; block < numBlocks; block++ )
+    {
+        EXPECT_EQ( download.received[ block ], 1U ) << "block " << block;
+    }
+}
+
+TEST( TestOtaDownloadThroughput, lost_blocks_are_requested_again_after_the_wait )
+{
+    StreamDownload download( otaconfigMAX_NUM_BLOCKS_REQUEST, 37U );
+
+    ( void ) download.run();
+
+    EXPECT_EQ( download.progress.windowBaseBlock, numBlocks );
+    EXPECT_GT( download.timeouts, 0U );
+
+    for( uint32_t block = 0; block < numBlocks; block++ )
+    {
+        EXPECT_EQ( download.received[ block ], 1U ) << "block " << block;
+    }
+}
+
+TEST( TestOtaDownloadThroughput, benchmark_the_throughput )
+{
+    for( uint32_t windowBlocks = 1U; windowBlocks <= OTA_CHECKPOINT_WINDOW_BLOCKS; windowBlocks *= 2U )
+    {
+        StreamDownload download( windowBlocks );
+        double throughputMBps = download.run();
+
+        EXPECT_EQ( download.progress.windowBaseBlock, numBlocks );
+
+        RecordProperty( "window" + std::to_string( windowBlocks ) + "MBps", std::to_string( throughputMBps ) );
+        printf( "%u KB over a %.0f ms round trip at %.1f MB/s, window of %2u blocks: %.3f MB/s\n",
+                ( numBlocks * blockSize ) / 1024U,
+                2.0 * linkLatencyMs,
+                linkBytesPerMs / 1000.0,
+                windowBlocks,
+                throughputMBps );
+    }
+}
@@ -0,0 +1,102 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ota_image_header.h"
+}
+
+/* Builds the start of a signed image as imgtool lays it out. */
+static std::vector< uint8_t > make_header( uint8_t major,
+                                           uint8_t minor,
+                                           uint16_t revision,
+                                           uint32_t buildNum )
+{
+    std::vector< uint8_t > header( 0x400U, 0U );
+    uint32_t magic = OTA_IMAGE_HEADER_MAGIC;
+    uint32_t imageSize = 0x12345U;
+
+    for( int i = 0; i < 4; i++ )
+    {
+        header[ i ] = ( uint8_t ) ( magic >> ( 8 * i ) );
+        header[ 12 + i ] = ( uint8_t ) ( imageSize >> ( 8 * i ) );
+        header[ 24 + i ] = ( uint8_t ) ( buildNum >> ( 8 * i ) );
+    }
+
+    header[ 8 ] = 0x00U;
+    header[ 9 ] = 0x04U;
+    header[ 20 ] = major;
+    header[ 21 ] = minor;
+    header[ 22 ] = ( uint8_t ) revision;
+    header[ 23 ] = ( uint8_t ) ( revision >> 8 );
+
+    return header;
+}
+
+TEST( TestOtaImageHeader, the_header_of_a_signed_image_is_parsed )
+{
+    std::vector< uint8_t > image = make_header( 1U, 2U, 0x0304U, 0x05060708U );
+    OtaImageHeader_t header;
+
+    ASSERT_TRUE( otaImageHeader_Parse( image.data(), image.size(), &header ) );
+    EXPECT_EQ( header.headerSize, 0x400U );
+    EXPECT_EQ( header.imageSize, 0x12345U );
+    EXPECT_EQ( header.version.major, 1U );
+    EXPECT_EQ( header.version.minor, 2U );
+    EXPECT_EQ( header.version.revision, 0x0304U );
+    EXPECT_EQ( header.version.buildNum, 0x05060708U );
+}
+
+TEST( TestOtaImageHeader, data_without_the_magic_number_is_not_an_image )
+{
+    std::vector< uint8_t > image = make_header( 0U, 0U, 42U, 0U );
+    OtaImageHeader_t header;
+
+    image[ 0 ] ^= 0xFFU;
+
+    EXPECT_FALSE( otaImageHeader_Parse( image.data(), image.size(), &header ) );
+}
+
+TEST( TestOtaImageHeader, a_truncated_header_is_rejected )
+{
+    std::vector< uint8_t > image = make_header( 0U, 0U, 42U, 0U );
+    OtaImageHeader_t header;
+
+    EXPECT_FALSE( otaImageHeader_Parse( image.data(), OTA_IMAGE_HEADER_SIZE - 1U, &header ) );
+    EXPECT_FALSE( otaImageHeader_Parse( NULL, image.size(), &header ) );
+}
+
+TEST( TestOtaImageHeader, a_header_size_smaller_than_the_header_is_rejected )
+{
+    std::vector< uint8_t > image = make_header( 0U, 0U, 42U, 0U );
+    OtaImageHeader_t header;
+
+    image[ 8 ] = OTA_IMAGE_HEADER_SIZE - 1U;
+    image[ 9 ] = 0U;
+
+    EXPECT_FALSE( otaImageHeader_Parse( image.data(), image.size(), &header ) );
+}
+
+TEST( TestOtaImageHeader, versions_compare_from_the_most_significant_field )
+{
+    OtaImageVersion_t reference = { 1U, 2U, 3U, 4U };
+    OtaImageVersion_t equal = { 1U, 2U, 3U, 4U };
+    OtaImageVersion_t higherMajor = { 2U, 0U, 0U, 0U };
+    OtaImageVersion_t higherMinor = { 1U, 3U, 0U, 0U };
+    OtaImageVersion_t higherRevision = { 1U, 2U, 4U, 0U };
+    OtaImageVersion_t higherBuild = { 1U, 2U, 3U, 5U };
+    OtaImageVersion_t lowerRevision = { 1U, 2U, 2U, 9U };
+
+    EXPECT_EQ( otaImageHeader_CompareVersions( &equal, &reference ), 0 );
+    EXPECT_GT( otaImageHeader_CompareVersions( &higherMajor, &reference ), 0 );
+    EXPECT_GT( otaImageHeader_CompareVersions( &higherMinor, &reference ), 0 );
+    EXPECT_GT( otaImageHeader_CompareVersions( &higherRevision, &reference ), 0 );
+    EXPECT_GT( otaImageHeader_CompareVersions( &higherBuild, &reference ), 0 );
+    EXPECT_LT( otaImageHeader_CompareVersions( &lowerRevision, &reference ), 0 );
+    EXPECT_LT( otaImageHeader_CompareVersions( &reference, &higherMajor ), 0 );
+}
@@ -0,0 +1,96 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ota_model_install.h"
+}
+
+static const std::string firstJob = "model-update-0-0-42";
+static const std::string secondJob = "model-update-0-0-43";
+
+class TestOtaModelInstall : public ::testing::Test
+{
+public:
+    TestOtaModelInstall()
+    {
+        otaModelInstall_Init( &install );
+    }
+
+    bool staged( const std::string & jobId )
+    {
+        return otaModelInstall_Staged( &install, jobId.data(), jobId.size() );
+    }
+
+    OtaModelInstallAction_t jobDocument( const std::string & jobId )
+    {
+        return otaModelInstall_OnJobDocument( &install, jobId.data(), jobId.size() );
+    }
+
+    OtaModelInstall_t install;
+};
+
+TEST_F( TestOtaModelInstall, without_an_installed_model_jobs_are_processed )
+{
+    EXPECT_EQ( jobDocument( firstJob ), OtaModelInstallNone );
+    EXPECT_EQ( otaModelInstall_OnIdle( &install, true ), OtaModelInstallNone );
+    EXPECT_EQ( otaModelInstall_OnIdle( &install, false ), OtaModelInstallNone );
+}
+
+TEST_F( TestOtaModelInstall, the_job_of_the_installed_model_is_left_to_the_self_test )
+{
+    ASSERT_TRUE( staged( firstJob ) );
+
+    EXPECT_EQ( jobDocument( firstJob ), OtaModelInstallWait );
+}
+
+TEST_F( TestOtaModelInstall, the_device_reboots_once_the_application_is_idle )
+{
+    ASSERT_TRUE( staged( firstJob ) );
+
+    EXPECT_EQ( otaModelInstall_OnIdle( &install, false ), OtaModelInstallWait );
+    EXPECT_EQ( otaModelInstall_OnIdle( &install, true ), OtaModelInstallReboot );
+}
+
+TEST_F( TestOtaModelInstall, a_second_model_update_is_started_after_the_reboot )
+{
+    ASSERT_TRUE( staged( firstJob ) );
+
+    /* The first model is still staged, it is installed before the second
+     * job is downloaded. */
+    EXPECT_EQ( jobDocument( secondJob ), OtaModelInstallReboot );
+
+    /* After the reboot nothing is pending, the second job is downloaded and
+     * installed the same way. */
+    otaModelInstall_Init( &install );
+    EXPECT_EQ( jobDocument( secondJob ), OtaModelInstallNone );
+
+    ASSERT_TRUE( staged( secondJob ) );
+    EXPECT_EQ( jobDocument( secondJob ), OtaModelInstallWait );
+    EXPECT_EQ( jobDocument( firstJob ), OtaModelInstallReboot );
+    EXPECT_EQ( otaModelInstall_OnIdle( &install, true ), OtaModelInstallReboot );
+}
+
+TEST_F( TestOtaModelInstall, job_ids_are_compared_in_full )
+{
+    ASSERT_TRUE( staged( firstJob ) );
+
+    EXPECT_EQ( jobDocument( firstJob.substr( 0, firstJob.size() - 1U ) ), OtaModelInstallReboot );
+    EXPECT_EQ( jobDocument( firstJob + "0" ), OtaModelInstallReboot );
+    EXPECT_EQ( otaModelInstall_OnJobDocument( &install, NULL, 0U ), OtaModelInstallReboot );
+}
+
+TEST_F( TestOtaModelInstall, job_ids_too_long_are_not_recorded )
+{
+    const std::string longJob( OTA_MODEL_INSTALL_MAX_JOB_ID_LENGTH + 1U, 'a' );
+
+    EXPECT_FALSE( staged( longJob ) );
+    EXPECT_FALSE( install.pending );
+    EXPECT_TRUE( staged( longJob.substr( 0, OTA_MODEL_INSTALL_MAX_JOB_ID_LENGTH ) ) );
+    EXPECT_EQ( jobDocument( longJob.substr( 0, OTA_MODEL_INSTALL_MAX_JOB_ID_LENGTH ) ), OtaModelInstallWait );
+}
@@ -0,0 +1,519 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ota_payload_decoder.h"
+}
+
+#define COPY_ADD    1U
+#define INSERT      2U
+#define SEEK        3U
+
+static std::vector< uint8_t > decodedImage;
+static std::vector< const uint8_t * > writtenSpans;
+static std::vector< uint8_t > sourceImage;
+static bool sourceAccepted;
+static bool writeSucceeds;
+
+static bool write_image( const uint8_t * data,
+                         size_t length,
+                         void * context )
+{
+    ( void ) context;
+
+    writtenSpans.push_back( data );
+    decodedImage.insert( decodedImage.end(), data, data + length );
+
+    return writeSucceeds;
+}
+
+static bool check_source( const OtaPayloadHeader_t * header,
+                          void * context )
+{
+    ( void ) context;
+
+    return sourceAccepted && ( header->sourceSize == sourceImage.size() );
+}
+
+static bool read_source( uint32_t offset,
+                         uint8_t * data,
+                         size_t length,
+                         void * context )
+{
+    ( void ) context;
+
+    EXPECT_LE( offset + length, sourceImage.size() );
+    memcpy( data, sourceImage.data() + offset, length );
+
+    return true;
+}
+
+static const OtaPayloadInterface_t callbacks = { write_image, check_source, read_source, NULL };
+
+static std::vector< uint8_t > make_header( uint8_t flags,
+                                           uint32_t imageSize,
+                                           uint32_t sourceSize = 0U,
+                                           uint8_t windowBits = 8U,
+                                           uint8_t lookaheadBits = 4U )
+{
+    std::vector< uint8_t > header = { 'O', 'T', 'A', 'P', OTA_PAYLOAD_VERSION, flags, windowBits, lookaheadBits };
+
+    for( uint32_t value : { imageSize, sourceSize } )
+    {
+        for( int shift = 0; shift < 32; shift += 8 )
+        {
+            header.push_back( ( uint8_t ) ( value >> shift ) );
+        }
+    }
+
+    header.resize( OTA_PAYLOAD_HEADER_SIZE, 0U );
+
+    return header;
+}
+
+static void append_command( std::vector< uint8_t > & body,
+                            uint8_t opcode,
+                            uint32_t operand )
+{
+    body.push_back( opcode );
+
+    do
+    {
+        body.push_back( ( uint8_t ) ( ( operand & 0x7FU ) | ( ( operand > 0x7FU ) ? 0x80U : 0U ) ) );
+        operand >>= 7;
+    } while( operand > 0U );
+}
+
+/* Greedy LZSS encoder producing the bit stream the decoder expects. */
+static std::vector< uint8_t > lzss_compress( const std::vector< uint8_t > & data,
+                                             uint8_t windowBits,
+                                             uint8_t lookaheadBits )
+{
+    std::vector< uint8_t > out;
+    uint32_t accumulator = 0U;
+    uint32_t count = 0U;
+    size_t position = 0U;
+
+    auto write_bits = [ & ]( uint32_t value, uint32_t width ) {
+        accumulator = ( accumulator << width ) | value;
+        count += width;
+
+        while( count >= 8U )
+        {
+            count -= 8U;
+            out.push_back( ( uint8_t ) ( accumulator >> count ) );
+        }
+
+        accumulator &= ( 1UL << count ) - 1U;
+    };
+
+    while( position < data.size() )
+    {
+        size_t bestLength = 0U;
+        size_t bestDistance = 0U;
+
+        for( size_t distance = 1U; ( distance <= ( 1U << windowBits ) ) && ( distance <= position ); distance++ )
+        {
+            size_t length = 0U;
+
+            while( ( length < ( 1U << lookaheadBits ) ) && ( position + length < data.size() ) &&
+                   ( data[ position + length - distance ] == data[ position + length ] ) )
+            {
+                length++;
+            }
+
+            if( length > bestLength )
+            {
+                bestLength = length;
+                bestDistance = distance;
+            }
+        }
+
+        if( bestLength >= 3U )
+        {
+            write_bits( 0U, 1U );
+            write_bits( bestDistance - 1U, windowBits );
+            write_bits( bestLength - 1U, lookaheadBits );
+            position += bestLength;
+        }
+        else
+        {
+            write_bits( 1U, 1U );
+            write_bits( data[ position ], 8U );
+            position++;
+        }
+    }
+
+    if( count > 0U )
+    {
+        out.push_back( ( uint8_t ) ( accumulator << ( 8U - count ) ) );
+    }
+
+    return out;
+}
+
+static std::vector< uint8_t > make_image( size_t length,
+                                          uint32_t seed )
+{
+    std::mt19937 generator( seed );
+    std::vector< uint8_t > image( length );
+
+    /* Repetitive enough to compress, like code and model data. */
+    for( size_t i = 0; i < length; i++ )
+    {
+        image[ i ] = ( generator() % 4U == 0U ) ? ( uint8_t ) generator() : ( uint8_t ) ( i / 16U );
+    }
+
+    return image;
+}
+
+class TestOtaPayloadDecoder : public ::testing::Test {
+public:
+    TestOtaPayloadDecoder()
+    {
+        decodedImage.clear();
+        writtenSpans.clear();
+        sourceImage.clear();
+        sourceAccepted = true;
+        writeSucceeds = true;
+        otaPayload_Init( &decoder, &callbacks, true );
+    }
+
+    /* Feed the file in chunks of random length, like stream blocks. */
+    bool decode( const std::vector< uint8_t > & file,
+                 uint32_t seed = 0U )
+    {
+        std::mt19937 generator( seed );
+        size_t offset = 0U;
+        bool decoded = true;
+
+        while( decoded && ( offset < file.size() ) )
+        {
+            size_t length = std::min< size_t >( 1U + ( generator() % 300U ), file.size() - offset );
+
+            decoded = otaPayload_Decode( &decoder, &file[ offset ], length );
+            offset += length;
+        }
+
+        return decoded && otaPayload_Finish( &decoder );
+    }
+
+    OtaPayloadDecoder_t decoder;
+};
+
+TEST_F( TestOtaPayloadDecoder, a_plain_image_is_written_as_is )
+{
+    std::vector< uint8_t > image = make_image( 5000U, 1U );
+
+    EXPECT_TRUE( decode( image ) );
+    EXPECT_FALSE( otaPayload_IsEncoded( &decoder ) );
+    EXPECT_EQ( decodedImage, image );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_plain_image_is_written_straight_from_the_blocks )
+{
+    std::vector< uint8_t > image = make_image( 3000U, 8U );
+
+    ASSERT_TRUE( otaPayload_Decode( &decoder, image.data(), 1000U ) );
+    ASSERT_TRUE( otaPayload_Decode( &decoder, &image[ 1000 ], 2000U ) );
+    ASSERT_TRUE( otaPayload_Finish( &decoder ) );
+
+    /* The bytes held to look for the magic number, then the blocks. */
+    ASSERT_EQ( writtenSpans.size(), 3U );
+    EXPECT_EQ( writtenSpans[ 1 ], &image[ 4 ] );
+    EXPECT_EQ( writtenSpans[ 2 ], &image[ 1000 ] );
+    EXPECT_EQ( decodedImage, image );
+    EXPECT_EQ( otaPayload_GetCopiedBytes( &decoder ), 4U );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_stored_payload_is_written_straight_from_the_blocks )
+{
+    std::vector< uint8_t > image = make_image( 1000U, 9U );
+    std::vector< uint8_t > file = make_header( 0U, image.size() );
+
+    file.insert( file.end(), image.begin(), image.end() );
+
+    ASSERT_TRUE( otaPayload_Decode( &decoder, file.data(), file.size() ) );
+    ASSERT_TRUE( otaPayload_Finish( &decoder ) );
+
+    ASSERT_EQ( writtenSpans.size(), 1U );
+    EXPECT_EQ( writtenSpans[ 0 ], &file[ OTA_PAYLOAD_HEADER_SIZE ] );
+    EXPECT_EQ( decodedImage, image );
+}
+
+TEST_F( TestOtaPayloadDecoder, delta_inserts_are_written_straight_from_the_blocks )
+{
+    std::vector< uint8_t > inserted = make_image( 500U, 10U );
+    std::vector< uint8_t > expected;
+    std::vector< uint8_t > body;
+
+    sourceImage = make_image( 100U, 11U );
+
+    append_command( body, COPY_ADD, 10U );
+    body.insert( body.end(), 10U, 0U );
+    append_command( body, INSERT, inserted.size() );
+
+    size_t insertStart = OTA_PAYLOAD_HEADER_SIZE + body.size();
+
+    body.insert( body.end(), inserted.begin(), inserted.end() );
+    expected.insert( expected.end(), sourceImage.begin(), sourceImage.begin() + 10 );
+    expected.insert( expected.end(), inserted.begin(), inserted.end() );
+
+    std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_DELTA, expected.size(), sourceImage.size() );
+    file.insert( file.end(), body.begin(), body.end() );
+
+    ASSERT_TRUE( otaPayload_Decode( &decoder, file.data(), file.size() ) );
+    ASSERT_TRUE( otaPayload_Finish( &decoder ) );
+
+    /* The copied bytes, then the inserted ones in place. */
+    ASSERT_EQ( writtenSpans.size(), 2U );
+    EXPECT_EQ( writtenSpans[ 1 ], &file[ insertStart ] );
+    EXPECT_EQ( decodedImage, expected );
+    EXPECT_EQ( otaPayload_GetCopiedBytes( &decoder ), OTA_PAYLOAD_HEADER_SIZE + 10U );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_plain_image_shorter_than_the_magic_is_written_as_is )
+{
+    std::vector< uint8_t > image = { 'O', 'T' };
+
+    EXPECT_TRUE( decode( image ) );
+    EXPECT_EQ( decodedImage, image );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_resumed_download_is_written_as_is )
+{
+    std::vector< uint8_t > file = make_header( 0U, 4U );
+
+    otaPayload_Init( &decoder, &callbacks, false );
+
+    EXPECT_TRUE( decode( file ) );
+    EXPECT_EQ( decodedImage, file );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_stored_payload_is_written_after_its_header )
+{
+    std::vector< uint8_t > image = make_image( 1000U, 2U );
+    std::vector< uint8_t > file = make_header( 0U, image.size() );
+
+    file.insert( file.end(), image.begin(), image.end() );
+
+    EXPECT_TRUE( decode( file ) );
+    EXPECT_TRUE( otaPayload_IsEncoded( &decoder ) );
+    EXPECT_EQ( decodedImage, image );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_compressed_payload_is_decompressed )
+{
+    std::vector< uint8_t > image = make_image( 8000U, 3U );
+    std::vector< uint8_t > body = lzss_compress( image, 8U, 4U );
+    std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_COMPRESSED, image.size(), 0U, 8U, 4U );
+
+    file.insert( file.end(), body.begin(), body.end() );
+
+    EXPECT_LT( body.size(), image.size() );
+    EXPECT_TRUE( decode( file ) );
+    EXPECT_EQ( decodedImage, image );
+    EXPECT_EQ( otaPayload_GetCopiedBytes( &decoder ), OTA_PAYLOAD_HEADER_SIZE + image.size() );
+}
+
+TEST_F( TestOtaPayloadDecoder, overlapping_back_references_repeat_the_window )
+{
+    std::vector< uint8_t > image( 3000U, 0xA5U );
+    std::vector< uint8_t > body = lzss_compress( image, OTA_PAYLOAD_MAX_WINDOW_BITS, 8U );
+    std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_COMPRESSED, image.size(), 0U, OTA_PAYLOAD_MAX_WINDOW_BITS, 8U );
+
+    file.insert( file.end(), body.begin(), body.end() );
+
+    EXPECT_TRUE( decode( file ) );
+    EXPECT_EQ( decodedImage, image );
+}
+
+TEST_F( TestOtaPayloadDecoder, delta_commands_rebuild_the_image_from_the_source )
+{
+    std::vector< uint8_t > body;
+    std::vector< uint8_t > expected;
+
+    sourceImage = make_image( 400U, 4U );
+
+    /* Bytes 100 to 199 of the source, each plus one. */
+    append_command( body, SEEK, 200U );
+    append_command( body, COPY_ADD, 100U );
+    body.insert( body.end(), 100U, 1U );
+    expected.insert( expected.end(), sourceImage.begin() + 100, sourceImage.begin() + 200 );
+    std::for_each( expected.begin(), expected.end(), []( uint8_t & byte ) { byte++; } );
+
+    /* Three new bytes. */
+    append_command( body, INSERT, 3U );
+    body.insert( body.end(), { 7U, 8U, 9U } );
+    expected.insert( expected.end(), { 7U, 8U, 9U } );
+
+    /* Back to bytes 50 to 59, unchanged. */
+    append_command( body, SEEK, 2U * 150U - 1U );
+    append_command( body, COPY_ADD, 10U );
+    body.insert( body.end(), 10U, 0U );
+    expected.insert( expected.end(), sourceImage.begin() + 50, sourceImage.begin() + 60 );
+
+    std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_DELTA, expected.size(), sourceImage.size() );
+    file.insert( file.end(), body.begin(), body.end() );
+
+    EXPECT_TRUE( decode( file ) );
+    EXPECT_EQ( decodedImage, expected );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_compressed_delta_is_decompressed_then_applied )
+{
+    std::vector< uint8_t > image;
+    std::vector< uint8_t > delta;
+
+    sourceImage = make_image( 6000U, 5U );
+    image = sourceImage;
+
+    for( size_t i = 0; i < image.size(); i += 97U )
+    {
+        image[ i ] ^= 0x5AU;
+    }
+
+    append_command( delta, COPY_ADD, image.size() );
+
+    for( size_t i = 0; i < image.size(); i++ )
+    {
+        delta.push_back( ( uint8_t ) ( image[ i ] - sourceImage[ i ] ) );
+    }
+
+    std::vector< uint8_t > body = lzss_compress( delta, 10U, 8U );
+    std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_COMPRESSED | OTA_PAYLOAD_FLAG_DELTA,
+                                               image.size(), sourceImage.size(), 10U, 8U );
+    file.insert( file.end(), body.begin(), body.end() );
+
+    EXPECT_LT( body.size(), image.size() / 4U );
+    EXPECT_TRUE( decode( file ) );
+    EXPECT_EQ( decodedImage, image );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_delta_against_another_source_is_rejected )
+{
+    std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_DELTA, 1U, 1U );
+
+    sourceImage = { 0U };
+    sourceAccepted = false;
+    append_command( file, INSERT, 1U );
+    file.push_back( 0U );
+
+    EXPECT_FALSE( decode( file ) );
+    EXPECT_TRUE( decodedImage.empty() );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_delta_reading_past_the_source_is_rejected )
+{
+    std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_DELTA, 20U, 10U );
+
+    sourceImage.resize( 10U );
+    append_command( file, COPY_ADD, 20U );
+    file.insert( file.end(), 20U, 0U );
+
+    EXPECT_FALSE( decode( file ) );
+}
+
+TEST_F( TestOtaPayloadDecoder, an_unknown_delta_opcode_is_rejected )
+{
+    std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_DELTA, 1U, 1U );
+
+    sourceImage = { 0U };
+    append_command( file, 9U, 1U );
+
+    EXPECT_FALSE( decode( file ) );
+}
+
+TEST_F( TestOtaPayloadDecoder, an_unsupported_header_is_rejected )
+{
+    std::vector< uint8_t > badVersion = make_header( 0U, 0U );
+    std::vector< uint8_t > badFlags = make_header( 0x80U, 0U );
+    std::vector< uint8_t > badWindow = make_header( OTA_PAYLOAD_FLAG_COMPRESSED, 0U, 0U, OTA_PAYLOAD_MAX_WINDOW_BITS + 1U, 4U );
+    std::vector< uint8_t > badLookahead = make_header( OTA_PAYLOAD_FLAG_COMPRESSED, 0U, 0U, 8U, 8U );
+
+    badVersion[ 4 ] = OTA_PAYLOAD_VERSION + 1U;
+
+    for( const std::vector< uint8_t > & file : { badVersion, badFlags, badWindow, badLookahead } )
+    {
+        otaPayload_Init( &decoder, &callbacks, true );
+        EXPECT_FALSE( decode( file ) );
+    }
+}
+
+TEST_F( TestOtaPayloadDecoder, a_back_reference_before_the_start_is_rejected )
+{
+    std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_COMPRESSED, 4U, 0U, 8U, 4U );
+
+    /* Back reference of distance 1 and length 4 with nothing decoded. */
+    file.insert( file.end(), { 0x00U, 0x18U } );
+
+    EXPECT_FALSE( decode( file ) );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_payload_longer_than_its_image_is_rejected )
+{
+    std::vector< uint8_t > file = make_header( 0U, 2U );
+
+    file.insert( file.end(), { 1U, 2U, 3U } );
+
+    EXPECT_FALSE( decode( file ) );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_truncated_payload_does_not_finish )
+{
+    std::vector< uint8_t > image = make_image( 500U, 6U );
+    std::vector< uint8_t > file = make_header( 0U, image.size() );
+
+    file.insert( file.end(), image.begin(), image.end() - 1 );
+
+    EXPECT_FALSE( decode( file ) );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_truncated_header_does_not_finish )
+{
+    std::vector< uint8_t > file = make_header( 0U, 0U );
+
+    file.resize( OTA_PAYLOAD_HEADER_SIZE / 2U );
+
+    EXPECT_FALSE( decode( file ) );
+}
+
+TEST_F( TestOtaPayloadDecoder, a_failed_write_fails_the_decoding )
+{
+    std::vector< uint8_t > image = make_image( 1000U, 7U );
+
+    writeSucceeds = false;
+
+    EXPECT_FALSE( decode( image ) );
+    EXPECT_FALSE( otaPayload_Decode( &decoder, image.data(), 1U ) );
+}
+
+TEST_F( TestOtaPayloadDecoder, random_images_round_trip_through_every_encoding )
+{
+    for( uint32_t seed = 0; seed < 20U; seed++ )
+    {
+        std::mt19937 generator( seed );
+        std::vector< uint8_t > image = make_image( 1U + ( generator() % 3000U ), seed );
+        uint8_t windowBits = 4U + ( generator() % ( OTA_PAYLOAD_MAX_WINDOW_BITS - 3U ) );
+        uint8_t lookaheadBits = 3U + ( generator() % ( windowBits - 3U ) );
+        std::vector< uint8_t > body = lzss_compress( image, windowBits, lookaheadBits );
+        std::vector< uint8_t > file = make_header( OTA_PAYLOAD_FLAG_COMPRESSED, image.size(), 0U, windowBits, lookaheadBits );
+
+        file.insert( file.end(), body.begin(), body.end() );
+        decodedImage.clear();
+        otaPayload_Init( &decoder, &callbacks, true );
+
+        EXPECT_TRUE( decode( file, seed ) ) << "seed " << seed;
+        EXPECT_EQ( decodedImage, image ) << "seed " << seed;
+    }
+}
@@ -0,0 +1,367 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+/* Compares the two encodings of the data blocks sent by the AWS IoT MQTT
+ * file streams service, see otaconfigSTREAM_DATA_TYPE. A JSON block is a
+ * document with the payload as base64 text:
+ *     {"f":<file>,"i":<block>,"l":<length>,"p":"<base64>"}
+ * A CBOR block is a map with the same keys and the payload as a byte string.
+ *
+ * The MQTT file streams library is not built for the host tests, so the
+ * blocks are decoded by the reference decoders below. They do the same work
+ * as the library: the JSON payload is base64 decoded, the CBOR payload is
+ * copied as is. */
+
+static const uint32_t blockSize = 4096U;
+static const uint32_t fileId = 0U;
+
+static const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static std::string encode_json_block( uint32_t blockId,
+                                      const std::vector< uint8_t > & payload )
+{
+    std::string block = "{\"f\":" + std::to_string( fileId ) +
+                        ",\"i\":" + std::to_string( blockId ) +
+                        ",\"l\":" + std::to_string( payload.size() ) +
+                        ",\"p\":\"";
+
+    for( size_t i = 0; i < payload.size(); i += 3U )
+    {
+        uint32_t triple = ( uint32_t ) payload[ i ] << 16;
+        size_t remaining = payload.size() - i;
+
+        triple |= ( remaining > 1U ) ? ( ( uint32_t ) payload[ i + 1U ] << 8 ) : 0U;
+        triple |= ( remaining > 2U ) ? payload[ i + 2U ] : 0U;
+
+        block += base64Alphabet[ ( triple >> 18 ) & 0x3FU ];
+        block += base64Alphabet[ ( triple >> 12 ) & 0x3FU ];
+        block += ( remaining > 1U ) ? base64Alphabet[ ( triple >> 6 ) & 0x3FU ] : '=';
+        block += ( remaining > 2U ) ? base64Alphabet[ triple & 0x3FU ] : '=';
+    }
+
+    return block + "\"}";
+}
+
+static void append_cbor_head( std::vector< uint8_t > & block,
+                              uint8_t majorType,
+                              uint32_t value )
+{
+    if( value < 24U )
+    {
+        block.push_back( ( uint8_t ) ( ( majorType << 5 ) | value ) );
+    }
+    else if( value <= 0xFFU )
+    {
+        block.push_back( ( uint8_t ) ( ( majorType << 5 ) | 24U ) );
+        block.push_back( ( uint8_t ) value );
+    }
+    else
+    {
+        block.push_back( ( uint8_t ) ( ( majorType << 5 ) | 25U ) );
+        block.push_back( ( uint8_t ) ( value >> 8 ) );
+        block.push_back( ( uint8_t ) value );
+    }
+}
+
+static void append_cbor_key( std::vector< uint8_t > & block,
+                             char key )
+{
+    append_cbor_head( block, 3U, 1U );
+    block.push_back( ( uint8_t ) key );
+}
+
+static std::vector< uint8_t > encode_cbor_block( uint32_t blockId,
+                                                 const std::vector< uint8_t > & payload )
+{
+    std::vector< uint8_t > block;
+
+    append_cbor_head( block, 5U, 4U );
+    append_cbor_key( block, 'f' );
+    append_cbor_head( block, 0U, fileId );
+    append_cbor_key( block, 'i' );
+    append_cbor_head( block, 0U, blockId );
+    append_cbor_key( block, 'l' );
+    append_cbor_head( block, 0U, ( uint32_t ) payload.size() );
+    append_cbor_key( block, 'p' );
+    append_cbor_head( block, 2U, ( uint32_t ) payload.size() );
+    block.insert( block.end(), payload.begin(), payload.end() );
+
+    return block;
+}
+
+static uint32_t parse_json_number( const std::string & block,
+                                   const char * key )
+{
+    size_t position = block.find( key ) + strlen( key );
+    uint32_t value = 0U;
+
+    while( ( block[ position ] >= '0' ) && ( block[ position ] <= '9' ) )
+    {
+        value = ( value * 10U ) + ( uint32_t ) ( block[ position ] - '0' );
+        position++;
+    }
+
+    return value;
+}
+
+/* Returns the length of the payload, or 0 if the block is not valid. */
+static size_t decode_json_block( const std::string & block,
+                                 uint32_t * blockId,
+                                 uint8_t * payload,
+                                 size_t payloadSize )
+{
+    static int8_t sextets[ 256 ];
+    static bool sextetsSet = false;
+    size_t start = block.find( "\"p\":\"" );
+    size_t length = 0U;
+    uint32_t bits = 0U;
+    uint32_t bitCount = 0U;
+
+    if( sextetsSet == false )
+    {
+        memset( sextets, -1, sizeof( sextets ) );
+
+        for( int8_t i = 0; i < 64; i++ )
+        {
+            sextets[ ( uint8_t ) base64Alphabet[ i ] ] = i;
+        }
+
+        sextetsSet = true;
+    }
+
+    if( start == std::string::npos )
+    {
+        return 0U;
+    }
+
+    *blockId = parse_json_number( block, "\"i\":" );
+
+    for( size_t i = start + 5U; ( i < block.size() ) && ( block[ i ] != '"' ) && ( block[ i ] != '=' ); i++ )
+    {
+        int8_t sextet = sextets[ ( uint8_t ) block[ i ] ];
+
+        if( sextet < 0 )
+        {
+            return 0U;
+        }
+
+        bits = ( bits << 6 ) | ( uint32_t ) sextet;
+        bitCount += 6U;
+
+        if( bitCount >= 8U )
+        {
+            bitCount -= 8U;
+
+            if( length == payloadSize )
+            {
+                return 0U;
+            }
+
+            payload[ length++ ] = ( uint8_t ) ( bits >> bitCount );
+        }
+    }
+
+    return ( length == parse_json_number( block, "\"l\":" ) ) ? length : 0U;
+}
+
+static bool read_cbor_head( const std::vector< uint8_t > & block,
+                            size_t * position,
+                            uint8_t * majorType,
+                            uint32_t * value )
+{
+    uint8_t initial;
+    uint8_t argument;
+
+    if( *position >= block.size() )
+    {
+        return false;
+    }
+
+    initial = block[ ( *position )++ ];
+    *majorType = initial >> 5;
+    argument = initial & 0x1FU;
+
+    if( argument < 24U )
+    {
+        *value = argument;
+    }
+    else if( ( argument == 24U ) && ( *position + 1U <= block.size() ) )
+    {
+        *value = block[ ( *position )++ ];
+    }
+    else if( ( argument == 25U ) && ( *position + 2U <= block.size() ) )
+    {
+        *value = ( ( uint32_t ) block[ *position ] << 8 ) | block[ *position + 1U ];
+        *position += 2U;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/* Returns the length of the payload, or 0 if the block is not valid. */
+static size_t decode_cbor_block( const std::vector< uint8_t > & block,
+                                 uint32_t * blockId,
+                                 uint8_t * payload,
+                                 size_t payloadSize )
+{
+    size_t position = 0U;
+    size_t length = 0U;
+    uint8_t majorType;
+    uint32_t entries;
+
+    if( !read_cbor_head( block, &position, &majorType, &entries ) || ( majorType != 5U ) )
+    {
+        return 0U;
+    }
+
+    for( uint32_t entry = 0; entry < entries; entry++ )
+    {
+        uint32_t value;
+        char key;
+
+        if( !read_cbor_head( block, &position, &majorType, &value ) ||
+            ( majorType != 3U ) || ( value != 1U ) || ( position >= block.size() ) )
+        {
+            return 0U;
+        }
+
+        key = ( char ) block[ position++ ];
+
+        if( !read_cbor_head( block, &position, &majorType, &value ) )
+        {
+            return 0U;
+        }
+
+        if( ( key == 'p' ) && ( majorType == 2U ) )
+        {
+            if( ( value > payloadSize ) || ( position + value > block.size() ) )
+            {
+                return 0U;
+            }
+
+            memcpy( payload, &block[ position ], value );
+            position += value;
+            length = value;
+        }
+        else if( ( key == 'i' ) && ( majorType == 0U ) )
+        {
+            *blockId = value;
+        }
+    }
+
+    return length;
+}
+
+static std::vector< uint8_t > random_payload( uint32_t seed )
+{
+    std::mt19937 generator( seed );
+    std::vector< uint8_t > payload( blockSize );
+
+    for( uint8_t & value : payload )
+    {
+        value = ( uint8_t ) generator();
+    }
+
+    return payload;
+}
+
+TEST( TestOtaStreamEncoding, both_encodings_decode_to_the_block )
+{
+    std::vector< uint8_t > payload = random_payload( 1U );
+    std::vector< uint8_t > decoded( blockSize );
+    uint32_t blockId = 0U;
+
+    ASSERT_EQ( decode_json_block( encode_json_block( 1234U, payload ), &blockId, decoded.data(), decoded.size() ), blockSize );
+    EXPECT_EQ( blockId, 1234U );
+    EXPECT_EQ( decoded, payload );
+
+    decoded.assign( blockSize, 0U );
+    blockId = 0U;
+
+    ASSERT_EQ( decode_cbor_block( encode_cbor_block( 1234U, payload ), &blockId, decoded.data(), decoded.size() ), blockSize );
+    EXPECT_EQ( blockId, 1234U );
+    EXPECT_EQ( decoded, payload );
+}
+
+TEST( TestOtaStreamEncoding, cbor_blocks_are_a_quarter_smaller_on_the_wire )
+{
+    std::vector< uint8_t > payload = random_payload( 2U );
+    size_t jsonBytes = encode_json_block( 1234U, payload ).size();
+    size_t cborBytes = encode_cbor_block( 1234U, payload ).size();
+
+    /* Base64 sends 4 characters for every 3 bytes. */
+    EXPECT_GE( jsonBytes, ( ( blockSize + 2U ) / 3U ) * 4U );
+    EXPECT_LE( cborBytes, blockSize + 32U );
+    EXPECT_LT( cborBytes * 4U, jsonBytes * 3U );
+}
+
+TEST( TestOtaStreamEncoding, benchmark_the_wire_bytes_and_the_decode_time )
+{
+    const uint32_t rounds = 2000U;
+    const uint32_t blocks = 16U;
+    std::vector< std::string > jsonBlocks;
+    std::vector< std::vector< uint8_t > > cborBlocks;
+    std::vector< uint8_t > decoded( blockSize );
+    size_t jsonBytes = 0U;
+    size_t cborBytes = 0U;
+    size_t decodedBytes = 0U;
+    uint32_t blockId = 0U;
+
+    for( uint32_t block = 0; block < blocks; block++ )
+    {
+        std::vector< uint8_t > payload = random_payload( block );
+
+        jsonBlocks.push_back( encode_json_block( block, payload ) );
+        cborBlocks.push_back( encode_cbor_block( block, payload ) );
+        jsonBytes += jsonBlocks.back().size();
+        cborBytes += cborBlocks.back().size();
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for( uint32_t round = 0; round < rounds; round++ )
+    {
+        decodedBytes += decode_json_block( jsonBlocks[ round % blocks ], &blockId, decoded.data(), decoded.size() );
+    }
+
+    double jsonUs = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() / rounds;
+
+    start = std::chrono::steady_clock::now();
+
+    for( uint32_t round = 0; round < rounds; round++ )
+    {
+        decodedBytes += decode_cbor_block( cborBlocks[ round % blocks ], &blockId, decoded.data(), decoded.size() );
+    }
+
+    double cborUs = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() / rounds;
+
+    EXPECT_EQ( decodedBytes, 2U * rounds * blockSize );
+
+    RecordProperty( "jsonWireBytes", std::to_string( jsonBytes / blocks ) );
+    RecordProperty( "cborWireBytes", std::to_string( cborBytes / blocks ) );
+    RecordProperty( "jsonDecodeUs", std::to_string( jsonUs ) );
+    RecordProperty( "cborDecodeUs", std::to_string( cborUs ) );
+    printf( "%u byte block: JSON %zu wire bytes, decode %.2f us; CBOR %zu wire bytes, decode %.2f us\n",
+            blockSize,
+            jsonBytes / blocks,
+            jsonUs,
+            cborBytes / blocks,
+            cborUs );
+}
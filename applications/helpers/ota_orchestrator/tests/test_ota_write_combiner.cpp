@@ -0,0 +1,245 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ota_write_combiner.h"
+}
+
+#define SECTOR_SIZE    256U
+
+/* A chunk handed over by the combiner, as it would be written to flash. */
+struct WrittenChunk
+{
+    uint32_t offset;
+    std::vector< uint8_t > data;
+};
+
+static std::vector< WrittenChunk > writtenChunks;
+static uint8_t sectorBuffers[ 2 ][ SECTOR_SIZE ];
+static size_t submitsBeforeFailure;
+
+/* Copies the chunk out, and hands the other buffer back like a double
+ * buffered writer would. */
+static uint8_t * record_chunk( uint8_t * buffer,
+                               uint32_t offset,
+                               size_t length,
+                               void * context )
+{
+    uint8_t * nextBuffer = NULL;
+
+    ( void ) context;
+
+    if( writtenChunks.size() < submitsBeforeFailure )
+    {
+        writtenChunks.push_back( { offset, std::vector< uint8_t >( buffer, buffer + length ) } );
+        nextBuffer = ( buffer == sectorBuffers[ 0 ] ) ? sectorBuffers[ 1 ] : sectorBuffers[ 0 ];
+        memset( nextBuffer, 0xFF, SECTOR_SIZE );
+    }
+
+    return nextBuffer;
+}
+
+static std::vector< uint8_t > make_image( size_t length )
+{
+    std::vector< uint8_t > image( length );
+
+    for( size_t i = 0; i < length; i++ )
+    {
+        image[ i ] = ( uint8_t ) ( ( i * 7U ) + ( i >> 8 ) );
+    }
+
+    return image;
+}
+
+class TestOtaWriteCombiner : public ::testing::Test {
+public:
+    TestOtaWriteCombiner()
+    {
+        writtenChunks.clear();
+        submitsBeforeFailure = SIZE_MAX;
+    }
+
+    void start( uint32_t startOffset )
+    {
+        otaWriteCombiner_Init( &combiner, SECTOR_SIZE, startOffset, sectorBuffers[ 0 ], record_chunk, NULL );
+    }
+
+    /* Rebuild the image from the written chunks, checking they are
+     * contiguous from startOffset. */
+    std::vector< uint8_t > written_image( uint32_t startOffset )
+    {
+        std::vector< uint8_t > image;
+        uint32_t offset = startOffset;
+
+        for( const WrittenChunk & chunk : writtenChunks )
+        {
+            EXPECT_EQ( chunk.offset, offset );
+            image.insert( image.end(), chunk.data.begin(), chunk.data.end() );
+            offset += chunk.data.size();
+        }
+
+        return image;
+    }
+
+    OtaWriteCombiner_t combiner;
+};
+
+TEST_F( TestOtaWriteCombiner, nothing_is_written_before_a_sector_is_full )
+{
+    std::vector< uint8_t > image = make_image( SECTOR_SIZE - 1U );
+
+    start( 0 );
+
+    EXPECT_TRUE( otaWriteCombiner_Append( &combiner, image.data(), image.size() ) );
+    EXPECT_TRUE( writtenChunks.empty() );
+}
+
+TEST_F( TestOtaWriteCombiner, blocks_are_combined_into_whole_sectors )
+{
+    std::vector< uint8_t > image = make_image( 4U * SECTOR_SIZE );
+
+    start( 0 );
+
+    for( size_t offset = 0; offset < image.size(); offset += SECTOR_SIZE / 4U )
+    {
+        EXPECT_TRUE( otaWriteCombiner_Append( &combiner, &image[ offset ], SECTOR_SIZE / 4U ) );
+    }
+
+    ASSERT_EQ( writtenChunks.size(), 4U );
+
+    for( const WrittenChunk & chunk : writtenChunks )
+    {
+        EXPECT_EQ( chunk.offset % SECTOR_SIZE, 0U );
+        EXPECT_EQ( chunk.data.size(), SECTOR_SIZE );
+    }
+
+    EXPECT_EQ( written_image( 0 ), image );
+}
+
+TEST_F( TestOtaWriteCombiner, blocks_straddling_a_sector_boundary_are_split )
+{
+    std::vector< uint8_t > image = make_image( 3U * 100U );
+
+    start( 0 );
+
+    for( size_t offset = 0; offset < image.size(); offset += 100U )
+    {
+        EXPECT_TRUE( otaWriteCombiner_Append( &combiner, &image[ offset ], 100U ) );
+    }
+
+    ASSERT_EQ( writtenChunks.size(), 1U );
+    EXPECT_EQ( writtenChunks[ 0 ].data.size(), SECTOR_SIZE );
+
+    EXPECT_TRUE( otaWriteCombiner_Flush( &combiner ) );
+
+    ASSERT_EQ( writtenChunks.size(), 2U );
+    EXPECT_EQ( writtenChunks[ 1 ].offset, SECTOR_SIZE );
+    EXPECT_EQ( writtenChunks[ 1 ].data.size(), 300U - SECTOR_SIZE );
+    EXPECT_EQ( written_image( 0 ), image );
+}
+
+TEST_F( TestOtaWriteCombiner, data_larger_than_a_sector_is_written_in_sectors )
+{
+    std::vector< uint8_t > image = make_image( ( 3U * SECTOR_SIZE ) + 10U );
+
+    start( 0 );
+
+    EXPECT_TRUE( otaWriteCombiner_Append( &combiner, image.data(), image.size() ) );
+    EXPECT_EQ( writtenChunks.size(), 3U );
+
+    EXPECT_TRUE( otaWriteCombiner_Flush( &combiner ) );
+    EXPECT_EQ( written_image( 0 ), image );
+}
+
+TEST_F( TestOtaWriteCombiner, an_unaligned_start_is_written_up_to_the_next_boundary )
+{
+    std::vector< uint8_t > image = make_image( 2U * SECTOR_SIZE );
+    uint32_t startOffset = SECTOR_SIZE + 40U;
+
+    start( startOffset );
+
+    EXPECT_TRUE( otaWriteCombiner_Append( &combiner, image.data(), image.size() ) );
+    EXPECT_TRUE( otaWriteCombiner_Flush( &combiner ) );
+
+    ASSERT_EQ( writtenChunks.size(), 3U );
+    EXPECT_EQ( writtenChunks[ 0 ].data.size(), SECTOR_SIZE - 40U );
+    EXPECT_EQ( writtenChunks[ 1 ].offset, 2U * SECTOR_SIZE );
+    EXPECT_EQ( writtenChunks[ 2 ].data.size(), 40U );
+    EXPECT_EQ( written_image( startOffset ), image );
+}
+
+TEST_F( TestOtaWriteCombiner, flushing_an_empty_buffer_writes_nothing )
+{
+    std::vector< uint8_t > image = make_image( SECTOR_SIZE );
+
+    start( 0 );
+
+    EXPECT_TRUE( otaWriteCombiner_Append( &combiner, image.data(), image.size() ) );
+    EXPECT_TRUE( otaWriteCombiner_Flush( &combiner ) );
+    EXPECT_EQ( writtenChunks.size(), 1U );
+}
+
+TEST_F( TestOtaWriteCombiner, a_failed_submit_fails_every_later_call )
+{
+    std::vector< uint8_t > image = make_image( 3U * SECTOR_SIZE );
+
+    submitsBeforeFailure = 1U;
+    start( 0 );
+
+    EXPECT_TRUE( otaWriteCombiner_Append( &combiner, image.data(), SECTOR_SIZE ) );
+    EXPECT_FALSE( otaWriteCombiner_Append( &combiner, &image[ SECTOR_SIZE ], SECTOR_SIZE ) );
+    EXPECT_FALSE( otaWriteCombiner_Append( &combiner, &image[ 2U * SECTOR_SIZE ], 1U ) );
+    EXPECT_FALSE( otaWriteCombiner_Flush( &combiner ) );
+    EXPECT_EQ( writtenChunks.size(), 1U );
+}
+
+TEST_F( TestOtaWriteCombiner, random_block_sizes_are_written_in_aligned_chunks )
+{
+    for( uint32_t seed = 0; seed < 50U; seed++ )
+    {
+        std::mt19937 generator( seed );
+        std::uniform_int_distribution< size_t > imageLength( 1U, 20U * SECTOR_SIZE );
+        std::uniform_int_distribution< size_t > blockLength( 1U, 2U * SECTOR_SIZE );
+        std::uniform_int_distribution< uint32_t > startOffset( 0U, 4U * SECTOR_SIZE );
+        std::vector< uint8_t > image = make_image( imageLength( generator ) );
+        uint32_t start_offset = startOffset( generator );
+        size_t offset = 0U;
+
+        writtenChunks.clear();
+        start( start_offset );
+
+        while( offset < image.size() )
+        {
+            size_t length = std::min( blockLength( generator ), image.size() - offset );
+
+            ASSERT_TRUE( otaWriteCombiner_Append( &combiner, &image[ offset ], length ) );
+            offset += length;
+        }
+
+        ASSERT_TRUE( otaWriteCombiner_Flush( &combiner ) );
+
+        for( size_t i = 0; i < writtenChunks.size(); i++ )
+        {
+            uint32_t end = writtenChunks[ i ].offset + writtenChunks[ i ].data.size();
+
+            /* Only the last chunk may end short of a sector boundary. */
+            EXPECT_LE( writtenChunks[ i ].data.size(), SECTOR_SIZE ) << "seed " << seed;
+
+            if( i + 1U < writtenChunks.size() )
+            {
+                EXPECT_EQ( end % SECTOR_SIZE, 0U ) << "seed " << seed;
+            }
+        }
+
+        EXPECT_EQ( written_image( start_offset ), image ) << "seed " << seed;
+    }
+}
@@ -0,0 +1,121 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file overlay.h
+ * @brief Draw detection boxes, labels and scores over a frame.
+ *
+ * Only the pixels of the box borders and of the glyphs are written: a box is
+ * four rectangle fills, whatever its size, and a glyph is one fill per run of
+ * set pixels in each of its rows. The rectangles are written directly into
+ * the frame, or handed to a fill function, e.g. an arm-2d one.
+ */
+
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Size of the glyphs of the built-in font, and space between them, in pixels
+ * at scale 1. */
+#define overlayGLYPH_WIDTH      5
+#define overlayGLYPH_HEIGHT     7
+#define overlayGLYPH_SPACING    1
+
+/* Longest label text, the score included. */
+#define overlayMAX_LABEL_LENGTH    32
+
+/**
+ * @brief A rectangle, in pixels.
+ */
+typedef struct OverlayRect
+{
+    int32_t lX;
+    int32_t lY;
+    int32_t lWidth;
+    int32_t lHeight;
+} OverlayRect_t;
+
+/**
+ * @brief Fill a rectangle that lies within the canvas.
+ */
+typedef void ( * OverlayFillRect_t )( void * pvContext,
+                                      const OverlayRect_t * pxRect,
+                                      uint32_t ulColour );
+
+/**
+ * @brief The frame to draw over.
+ */
+typedef struct OverlayCanvas
+{
+    uint8_t * pucPixels;          /*!< First pixel of the frame. */
+    uint32_t ulWidth;             /*!< Width of the frame, in pixels. */
+    uint32_t ulHeight;            /*!< Height of the frame, in pixels. */
+    uint32_t ulPitch;             /*!< Bytes between the starts of two lines. */
+    uint32_t ulBytesPerPixel;     /*!< 2 or 4. */
+    OverlayFillRect_t xFillRect;  /*!< Fills the rectangles, or NULL to write the pixels directly. */
+    void * pvFillContext;         /*!< Passed to xFillRect. */
+} OverlayCanvas_t;
+
+/**
+ * @brief A detection to draw.
+ */
+typedef struct OverlayBox
+{
+    OverlayRect_t xRect;  /*!< Outer bounds of the box. */
+    uint32_t ulColour;    /*!< Colour of the box and of its label, in the format of the frame. */
+    const char * pcLabel; /*!< Label written above the box, or NULL. */
+    int32_t lScore;       /*!< Score in percent written after the label, or negative for none. */
+} OverlayBox_t;
+
+/**
+ * @brief Fill a rectangle, clipped to the canvas.
+ *
+ * @param[in] pxCanvas The canvas.
+ * @param[in] pxRect The rectangle.
+ * @param[in] ulColour The colour, in the format of the frame.
+ */
+void vOverlayFillRect( const OverlayCanvas_t * pxCanvas,
+                       const OverlayRect_t * pxRect,
+                       uint32_t ulColour );
+
+/**
+ * @brief Write a text with the built-in font, clipped to the canvas. Lower
+ * case letters are written in upper case, the characters without a glyph as
+ * spaces.
+ *
+ * @param[in] pxCanvas The canvas.
+ * @param[in] lX Left of the first glyph.
+ * @param[in] lY Top of the glyphs.
+ * @param[in] pcText The text.
+ * @param[in] ulScale Size of a font pixel, in pixels.
+ * @param[in] ulColour The colour, in the format of the frame.
+ */
+void vOverlayDrawText( const OverlayCanvas_t * pxCanvas,
+                       int32_t lX,
+                       int32_t lY,
+                       const char * pcText,
+                       uint32_t ulScale,
+                       uint32_t ulColour );
+
+/**
+ * @brief Draw all the detections of a frame: the borders of the boxes first,
+ * then the labels, so that no box covers the label of another. A label goes
+ * above its box, or inside it when there is no room above.
+ *
+ * @param[in] pxCanvas The canvas.
+ * @param[in] pxBoxes The detections.
+ * @param[in] xCount Number of detections.
+ * @param[in] ulThickness Width of the borders, in pixels.
+ * @param[in] ulTextScale Scale of the labels, 0 for none.
+ */
+void vOverlayDrawBoxes( const OverlayCanvas_t * pxCanvas,
+                        const OverlayBox_t * pxBoxes,
+                        size_t xCount,
+                        uint32_t ulThickness,
+                        uint32_t ulTextScale );
+
+#endif /* OVERLAY_H */
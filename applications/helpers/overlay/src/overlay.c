@@ -0,0 +1,359 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "overlay.h"
+
+/* Space taken by the score: a space, up to 10 digits and a percent sign. */
+#define overlaySCORE_LENGTH    12
+
+/* 5x7 font, a row per byte with the leftmost pixel in bit 4. */
+static const uint8_t ucSpaceGlyph[ overlayGLYPH_HEIGHT ] = { 0 };
+
+static const uint8_t ucDigitGlyphs[ 10 ][ overlayGLYPH_HEIGHT ] =
+{
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, /* 0 */
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, /* 1 */
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, /* 2 */
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, /* 3 */
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, /* 4 */
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, /* 5 */
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, /* 6 */
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, /* 7 */
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, /* 8 */
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, /* 9 */
+};
+
+static const uint8_t ucLetterGlyphs[ 26 ][ overlayGLYPH_HEIGHT ] =
+{
+    { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, /* A */
+    { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, /* B */
+    { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, /* C */
+    { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, /* D */
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, /* E */
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, /* F */
+    { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, /* G */
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, /* H */
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, /* I */
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, /* J */
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, /* K */
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, /* L */
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, /* M */
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, /* N */
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, /* O */
+    { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, /* P */
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, /* Q */
+    { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, /* R */
+    { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, /* S */
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, /* T */
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, /* U */
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, /* V */
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, /* W */
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, /* X */
+    { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 }, /* Y */
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, /* Z */
+};
+
+static const uint8_t ucDotGlyph[ overlayGLYPH_HEIGHT ] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C };
+static const uint8_t ucPercentGlyph[ overlayGLYPH_HEIGHT ] = { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 };
+static const uint8_t ucColonGlyph[ overlayGLYPH_HEIGHT ] = { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 };
+static const uint8_t ucDashGlyph[ overlayGLYPH_HEIGHT ] = { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 };
+
+/*-----------------------------------------------------------*/
+
+static const uint8_t * prvGetGlyph( char cCharacter )
+{
+    if( ( cCharacter >= '0' ) && ( cCharacter <= '9' ) )
+    {
+        return ucDigitGlyphs[ cCharacter - '0' ];
+    }
+    else if( ( cCharacter >= 'A' ) && ( cCharacter <= 'Z' ) )
+    {
+        return ucLetterGlyphs[ cCharacter - 'A' ];
+    }
+    else if( ( cCharacter >= 'a' ) && ( cCharacter <= 'z' ) )
+    {
+        return ucLetterGlyphs[ cCharacter - 'a' ];
+    }
+
+    switch( cCharacter )
+    {
+        case '.':
+            return ucDotGlyph;
+
+        case '%':
+            return ucPercentGlyph;
+
+        case ':':
+            return ucColonGlyph;
+
+        case '-':
+            return ucDashGlyph;
+
+        default:
+            return ucSpaceGlyph;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvWriteRect( const OverlayCanvas_t * pxCanvas,
+                          const OverlayRect_t * pxRect,
+                          uint32_t ulColour )
+{
+    uint8_t * pucLine = pxCanvas->pucPixels +
+                        ( ( size_t ) pxRect->lY * pxCanvas->ulPitch ) +
+                        ( ( size_t ) pxRect->lX * pxCanvas->ulBytesPerPixel );
+    int32_t lRow;
+    int32_t lColumn;
+
+    for( lRow = 0; lRow < pxRect->lHeight; lRow++, pucLine += pxCanvas->ulPitch )
+    {
+        if( pxCanvas->ulBytesPerPixel == 2U )
+        {
+            uint16_t * pusPixel = ( uint16_t * ) pucLine;
+
+            for( lColumn = 0; lColumn < pxRect->lWidth; lColumn++ )
+            {
+                pusPixel[ lColumn ] = ( uint16_t ) ulColour;
+            }
+        }
+        else
+        {
+            uint32_t * pulPixel = ( uint32_t * ) pucLine;
+
+            for( lColumn = 0; lColumn < pxRect->lWidth; lColumn++ )
+            {
+                pulPixel[ lColumn ] = ulColour;
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvFormatLabel( const OverlayBox_t * pxBox,
+                            char * pcText )
+{
+    char cDigits[ 10 ];
+    size_t xLength = 0;
+    size_t xDigits = 0;
+    uint32_t ulScore;
+
+    if( pxBox->pcLabel != NULL )
+    {
+        while( ( pxBox->pcLabel[ xLength ] != '\0' ) && ( xLength < ( overlayMAX_LABEL_LENGTH - 1 - overlaySCORE_LENGTH ) ) )
+        {
+            pcText[ xLength ] = pxBox->pcLabel[ xLength ];
+            xLength++;
+        }
+    }
+
+    if( pxBox->lScore >= 0 )
+    {
+        ulScore = ( uint32_t ) pxBox->lScore;
+
+        do
+        {
+            cDigits[ xDigits++ ] = ( char ) ( '0' + ( ulScore % 10U ) );
+            ulScore /= 10U;
+        } while( ulScore != 0U );
+
+        if( xLength > 0U )
+        {
+            pcText[ xLength++ ] = ' ';
+        }
+
+        while( xDigits > 0U )
+        {
+            pcText[ xLength++ ] = cDigits[ --xDigits ];
+        }
+
+        pcText[ xLength++ ] = '%';
+    }
+
+    pcText[ xLength ] = '\0';
+}
+
+/*-----------------------------------------------------------*/
+
+void vOverlayFillRect( const OverlayCanvas_t * pxCanvas,
+                       const OverlayRect_t * pxRect,
+                       uint32_t ulColour )
+{
+    int64_t llLeft = pxRect->lX;
+    int64_t llTop = pxRect->lY;
+    int64_t llRight = ( int64_t ) pxRect->lX + pxRect->lWidth;
+    int64_t llBottom = ( int64_t ) pxRect->lY + pxRect->lHeight;
+    OverlayRect_t xClipped;
+
+    if( llLeft < 0 )
+    {
+        llLeft = 0;
+    }
+
+    if( llTop < 0 )
+    {
+        llTop = 0;
+    }
+
+    if( llRight > ( int64_t ) pxCanvas->ulWidth )
+    {
+        llRight = pxCanvas->ulWidth;
+    }
+
+    if( llBottom > ( int64_t ) pxCanvas->ulHeight )
+    {
+        llBottom = pxCanvas->ulHeight;
+    }
+
+    if( ( llLeft >= llRight ) || ( llTop >= llBottom ) )
+    {
+        return;
+    }
+
+    xClipped.lX = ( int32_t ) llLeft;
+    xClipped.lY = ( int32_t ) llTop;
+    xClipped.lWidth = ( int32_t ) ( llRight - llLeft );
+    xClipped.lHeight = ( int32_t ) ( llBottom - llTop );
+
+    if( pxCanvas->xFillRect != NULL )
+    {
+        pxCanvas->xFillRect( pxCanvas->pvFillContext, &xClipped, ulColour );
+    }
+    else
+    {
+        prvWriteRect( pxCanvas, &xClipped, ulColour );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void vOverlayDrawText( const OverlayCanvas_t * pxCanvas,
+                       int32_t lX,
+                       int32_t lY,
+                       const char * pcText,
+                       uint32_t ulScale,
+                       uint32_t ulColour )
+{
+    const int32_t lScale = ( int32_t ) ulScale;
+    const uint8_t * pucGlyph;
+    OverlayRect_t xRun;
+    int32_t lRow;
+    int32_t lColumn;
+    int32_t lEnd;
+
+    for( ; *pcText != '\0'; pcText++, lX += ( overlayGLYPH_WIDTH + overlayGLYPH_SPACING ) * lScale )
+    {
+        pucGlyph = prvGetGlyph( *pcText );
+
+        for( lRow = 0; lRow < overlayGLYPH_HEIGHT; lRow++ )
+        {
+            lColumn = 0;
+
+            while( lColumn < overlayGLYPH_WIDTH )
+            {
+                if( ( pucGlyph[ lRow ] & ( 0x10U >> lColumn ) ) == 0U )
+                {
+                    lColumn++;
+                    continue;
+                }
+
+                /* One fill for the run of set pixels. */
+                lEnd = lColumn + 1;
+
+                while( ( lEnd < overlayGLYPH_WIDTH ) && ( ( pucGlyph[ lRow ] & ( 0x10U >> lEnd ) ) != 0U ) )
+                {
+                    lEnd++;
+                }
+
+                xRun.lX = lX + ( lColumn * lScale );
+                xRun.lY = lY + ( lRow * lScale );
+                xRun.lWidth = ( lEnd - lColumn ) * lScale;
+                xRun.lHeight = lScale;
+                vOverlayFillRect( pxCanvas, &xRun, ulColour );
+
+                lColumn = lEnd;
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void vOverlayDrawBoxes( const OverlayCanvas_t * pxCanvas,
+                        const OverlayBox_t * pxBoxes,
+                        size_t xCount,
+                        uint32_t ulThickness,
+                        uint32_t ulTextScale )
+{
+    const int32_t lTextHeight = ( overlayGLYPH_HEIGHT + 1 ) * ( int32_t ) ulTextScale;
+    char cLabel[ overlayMAX_LABEL_LENGTH ];
+    const OverlayRect_t * pxBox;
+    OverlayRect_t xEdge;
+    int32_t lThickness;
+    size_t i;
+
+    for( i = 0; i < xCount; i++ )
+    {
+        pxBox = &pxBoxes[ i ].xRect;
+
+        if( ( pxBox->lWidth <= 0 ) || ( pxBox->lHeight <= 0 ) || ( ulThickness == 0U ) )
+        {
+            continue;
+        }
+
+        /* Boxes without an interior are filled. */
+        if( ( ( int64_t ) pxBox->lWidth <= ( 2 * ( int64_t ) ulThickness ) ) ||
+            ( ( int64_t ) pxBox->lHeight <= ( 2 * ( int64_t ) ulThickness ) ) )
+        {
+            vOverlayFillRect( pxCanvas, pxBox, pxBoxes[ i ].ulColour );
+            continue;
+        }
+
+        lThickness = ( int32_t ) ulThickness;
+
+        xEdge = ( OverlayRect_t ) { pxBox->lX, pxBox->lY, pxBox->lWidth, lThickness };
+        vOverlayFillRect( pxCanvas, &xEdge, pxBoxes[ i ].ulColour );
+
+        xEdge.lY = pxBox->lY + pxBox->lHeight - lThickness;
+        vOverlayFillRect( pxCanvas, &xEdge, pxBoxes[ i ].ulColour );
+
+        xEdge = ( OverlayRect_t ) { pxBox->lX, pxBox->lY + lThickness, lThickness, pxBox->lHeight - ( 2 * lThickness ) };
+        vOverlayFillRect( pxCanvas, &xEdge, pxBoxes[ i ].ulColour );
+
+        xEdge.lX = pxBox->lX + pxBox->lWidth - lThickness;
+        vOverlayFillRect( pxCanvas, &xEdge, pxBoxes[ i ].ulColour );
+    }
+
+    if( ulTextScale == 0U )
+    {
+        return;
+    }
+
+    for( i = 0; i < xCount; i++ )
+    {
+        pxBox = &pxBoxes[ i ].xRect;
+        prvFormatLabel( &pxBoxes[ i ], cLabel );
+
+        if( cLabel[ 0 ] == '\0' )
+        {
+            continue;
+        }
+
+        if( pxBox->lY >= lTextHeight )
+        {
+            vOverlayDrawText( pxCanvas, pxBox->lX, pxBox->lY - lTextHeight, cLabel, ulTextScale, pxBoxes[ i ].ulColour );
+        }
+        else
+        {
+            vOverlayDrawText( pxCanvas,
+                              pxBox->lX + ( int32_t ) ulThickness + ( int32_t ) ulTextScale,
+                              pxBox->lY + ( int32_t ) ulThickness + ( int32_t ) ulTextScale,
+                              cLabel,
+                              ulTextScale,
+                              pxBoxes[ i ].ulColour );
+        }
+    }
+}
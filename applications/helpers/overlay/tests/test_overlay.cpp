@@ -0,0 +1,298 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "overlay.h"
+}
+
+static const uint16_t background = 0x1234U;
+static const uint16_t yellow = 0xFFE0U;
+static const uint16_t red = 0xF800U;
+
+template<typename Pixel>
+class Frame
+{
+public:
+    Frame( uint32_t width,
+           uint32_t height,
+           Pixel fill = background ) : pixels( width * height, fill )
+    {
+        canvas.pucPixels = reinterpret_cast<uint8_t *>( pixels.data() );
+        canvas.ulWidth = width;
+        canvas.ulHeight = height;
+        canvas.ulPitch = width * sizeof( Pixel );
+        canvas.ulBytesPerPixel = sizeof( Pixel );
+        canvas.xFillRect = nullptr;
+        canvas.pvFillContext = nullptr;
+    }
+
+    Pixel at( uint32_t x,
+              uint32_t y ) const
+    {
+        return pixels[ y * canvas.ulWidth + x ];
+    }
+
+    size_t count( Pixel colour ) const
+    {
+        size_t found = 0U;
+
+        for( Pixel pixel : pixels )
+        {
+            found += ( pixel == colour ) ? 1U : 0U;
+        }
+
+        return found;
+    }
+
+    std::vector<Pixel> pixels;
+    OverlayCanvas_t canvas;
+};
+
+static OverlayBox_t box( int32_t x,
+                         int32_t y,
+                         int32_t width,
+                         int32_t height,
+                         uint32_t colour = yellow,
+                         const char * label = nullptr,
+                         int32_t score = -1 )
+{
+    return OverlayBox_t { { x, y, width, height }, colour, label, score };
+}
+
+/* What the application did before: fill a whole box-sized tile, fill its
+ * interior with a mask colour and copy the tile without the mask colour. */
+static void drawWithColourKeying( Frame<uint16_t> & frame,
+                                  const OverlayRect_t & rect,
+                                  uint32_t thickness,
+                                  std::vector<uint16_t> & tile )
+{
+    tile.assign( rect.lWidth * rect.lHeight, yellow );
+
+    for( int32_t y = thickness; y < rect.lHeight - ( int32_t ) thickness; y++ )
+    {
+        for( int32_t x = thickness; x < rect.lWidth - ( int32_t ) thickness; x++ )
+        {
+            tile[ y * rect.lWidth + x ] = red;
+        }
+    }
+
+    for( int32_t y = 0; y < rect.lHeight; y++ )
+    {
+        for( int32_t x = 0; x < rect.lWidth; x++ )
+        {
+            if( tile[ y * rect.lWidth + x ] != red )
+            {
+                frame.pixels[ ( rect.lY + y ) * frame.canvas.ulWidth + rect.lX + x ] = tile[ y * rect.lWidth + x ];
+            }
+        }
+    }
+}
+
+TEST( TestOverlay, a_box_only_writes_its_border )
+{
+    Frame<uint16_t> frame( 64, 48 );
+    OverlayBox_t boxes[] = { box( 10, 5, 20, 30 ) };
+
+    vOverlayDrawBoxes( &frame.canvas, boxes, 1, 2, 0 );
+
+    EXPECT_EQ( frame.count( yellow ), 20U * 30U - 16U * 26U );
+    EXPECT_EQ( frame.at( 10, 5 ), yellow );
+    EXPECT_EQ( frame.at( 29, 34 ), yellow );
+    EXPECT_EQ( frame.at( 11, 6 ), yellow );
+    EXPECT_EQ( frame.at( 12, 7 ), background );
+    EXPECT_EQ( frame.at( 27, 32 ), background );
+    EXPECT_EQ( frame.at( 30, 5 ), background );
+    EXPECT_EQ( frame.at( 10, 35 ), background );
+}
+
+TEST( TestOverlay, boxes_without_an_interior_are_filled )
+{
+    Frame<uint16_t> frame( 32, 32 );
+    OverlayBox_t boxes[] = { box( 0, 0, 4, 10 ), box( 10, 10, 10, 3 ), box( 20, 20, 0, 5 ) };
+
+    vOverlayDrawBoxes( &frame.canvas, boxes, 3, 2, 0 );
+
+    EXPECT_EQ( frame.count( yellow ), 4U * 10U + 10U * 3U );
+}
+
+TEST( TestOverlay, boxes_are_clipped_to_the_frame )
+{
+    Frame<uint16_t> frame( 32, 32 );
+    OverlayBox_t boxes[] = { box( -5, -5, 15, 15 ), box( 25, 25, 100, 100 ), box( 40, 0, 10, 10 ), box( INT32_MAX - 1, 0, INT32_MAX, 4 ) };
+
+    vOverlayDrawBoxes( &frame.canvas, boxes, 4, 1, 0 );
+
+    /* Only the right and bottom edges of the first box, the top and left
+     * edges of the second box. */
+    EXPECT_EQ( frame.count( yellow ), 10U + 9U + 7U + 6U );
+    EXPECT_EQ( frame.at( 9, 0 ), yellow );
+    EXPECT_EQ( frame.at( 0, 9 ), yellow );
+    EXPECT_EQ( frame.at( 31, 25 ), yellow );
+    EXPECT_EQ( frame.at( 25, 31 ), yellow );
+}
+
+TEST( TestOverlay, four_byte_pixels_are_written_whole )
+{
+    Frame<uint32_t> frame( 16, 16, 0U );
+    OverlayBox_t boxes[] = { box( 2, 2, 8, 8, 0xFFFF00U ) };
+
+    vOverlayDrawBoxes( &frame.canvas, boxes, 1, 1, 0 );
+
+    EXPECT_EQ( frame.count( 0xFFFF00U ), 28U );
+    EXPECT_EQ( frame.at( 2, 2 ), 0xFFFF00U );
+    EXPECT_EQ( frame.at( 3, 3 ), 0U );
+}
+
+TEST( TestOverlay, a_box_is_four_fills_whatever_its_size )
+{
+    Frame<uint16_t> frame( 640, 480 );
+    std::vector<OverlayRect_t> fills;
+    OverlayBox_t boxes[] = { box( 10, 10, 20, 20 ), box( 0, 0, 640, 480 ) };
+
+    frame.canvas.xFillRect = []( void * context, const OverlayRect_t * rect, uint32_t colour ) {
+                                 ( void ) colour;
+                                 static_cast<std::vector<OverlayRect_t> *>( context )->push_back( *rect );
+                             };
+    frame.canvas.pvFillContext = &fills;
+
+    vOverlayDrawBoxes( &frame.canvas, boxes, 2, 3, 0 );
+
+    ASSERT_EQ( fills.size(), 8U );
+    EXPECT_EQ( fills[ 4 ].lWidth, 640 );
+    EXPECT_EQ( fills[ 4 ].lHeight, 3 );
+    EXPECT_EQ( fills[ 7 ].lX, 637 );
+    EXPECT_EQ( fills[ 7 ].lHeight, 474 );
+
+    /* The frame is left to the fill function. */
+    EXPECT_EQ( frame.count( background ), 640U * 480U );
+}
+
+TEST( TestOverlay, glyphs_are_filled_a_run_at_a_time )
+{
+    Frame<uint16_t> frame( 64, 32 );
+    size_t fills = 0U;
+
+    /* The "1" glyph has 10 pixels in 7 runs, one per row. */
+    vOverlayDrawText( &frame.canvas, 0, 0, "1", 2, yellow );
+    EXPECT_EQ( frame.count( yellow ), 10U * 2U * 2U );
+    EXPECT_EQ( frame.at( 4, 0 ), yellow );
+    EXPECT_EQ( frame.at( 5, 1 ), yellow );
+
+    frame.canvas.xFillRect = []( void * context, const OverlayRect_t * rect, uint32_t colour ) {
+                                 ( void ) rect;
+                                 ( void ) colour;
+                                 ( *static_cast<size_t *>( context ) )++;
+                             };
+    frame.canvas.pvFillContext = &fills;
+
+    vOverlayDrawText( &frame.canvas, 0, 0, "1", 1, yellow );
+    EXPECT_EQ( fills, 7U );
+}
+
+TEST( TestOverlay, lower_case_and_unknown_characters_are_mapped )
+{
+    Frame<uint16_t> upper( 64, 8 );
+    Frame<uint16_t> lower( 64, 8 );
+    Frame<uint16_t> unknown( 64, 8 );
+
+    vOverlayDrawText( &upper.canvas, 0, 0, "FACE", 1, yellow );
+    vOverlayDrawText( &lower.canvas, 0, 0, "face", 1, yellow );
+    vOverlayDrawText( &unknown.canvas, 0, 0, "#?~", 1, yellow );
+
+    EXPECT_EQ( upper.pixels, lower.pixels );
+    EXPECT_GT( upper.count( yellow ), 0U );
+    EXPECT_EQ( unknown.count( yellow ), 0U );
+}
+
+TEST( TestOverlay, labels_and_scores_go_above_the_box_or_inside_it )
+{
+    Frame<uint16_t> frame( 200, 100 );
+    Frame<uint16_t> expected( 200, 100 );
+    OverlayBox_t boxes[] = { box( 10, 40, 50, 50, yellow, "face", 87 ), box( 100, 2, 50, 50, red, nullptr, 5 ) };
+
+    vOverlayDrawBoxes( &frame.canvas, boxes, 2, 2, 1 );
+
+    vOverlayDrawBoxes( &expected.canvas, boxes, 2, 2, 0 );
+    vOverlayDrawText( &expected.canvas, 10, 40 - ( overlayGLYPH_HEIGHT + 1 ), "FACE 87%", 1, yellow );
+    vOverlayDrawText( &expected.canvas, 100 + 2 + 1, 2 + 2 + 1, "5%", 1, red );
+
+    EXPECT_EQ( frame.pixels, expected.pixels );
+}
+
+TEST( TestOverlay, long_labels_are_truncated )
+{
+    Frame<uint16_t> frame( 400, 40 );
+    Frame<uint16_t> expected( 400, 40 );
+    OverlayBox_t boxes[] = { box( 0, 20, 300, 10, yellow, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", 100 ) };
+
+    vOverlayDrawBoxes( &frame.canvas, boxes, 1, 1, 1 );
+
+    vOverlayDrawBoxes( &expected.canvas, boxes, 1, 1, 0 );
+    vOverlayDrawText( &expected.canvas, 0, 20 - ( overlayGLYPH_HEIGHT + 1 ), "ABCDEFGHIJKLMNOPQRS 100%", 1, yellow );
+
+    EXPECT_EQ( frame.pixels, expected.pixels );
+}
+
+TEST( TestOverlay, benchmark_border_fills_against_colour_keyed_tiles )
+{
+    const uint32_t width = 1920U;
+    const uint32_t height = 1080U;
+    const uint32_t thickness = 2U;
+    const int rounds = 20;
+    std::mt19937 generator( 20261018U );
+    std::uniform_int_distribution<int32_t> size( 40, 400 );
+    std::vector<OverlayBox_t> boxes;
+    std::vector<uint16_t> tile;
+    Frame<uint16_t> keyed( width, height );
+    Frame<uint16_t> bordered( width, height );
+
+    /* A frame of detections, within the frame. */
+    for( int i = 0; i < 10; i++ )
+    {
+        int32_t boxWidth = size( generator );
+        int32_t boxHeight = size( generator );
+        int32_t x = std::uniform_int_distribution<int32_t>( 0, width - boxWidth )( generator );
+        int32_t y = std::uniform_int_distribution<int32_t>( 0, height - boxHeight )( generator );
+
+        boxes.push_back( box( x, y, boxWidth, boxHeight ) );
+    }
+
+    auto measure = [ & ]( const std::function<void()> & draw ) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for( int round = 0; round < rounds; round++ )
+        {
+            draw();
+        }
+
+        return std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() / rounds;
+    };
+
+    double keyedUs = measure( [ & ]() {
+        for( const OverlayBox_t & detection : boxes )
+        {
+            drawWithColourKeying( keyed, detection.xRect, thickness, tile );
+        }
+    } );
+    double borderUs = measure( [ & ]() {
+        vOverlayDrawBoxes( &bordered.canvas, boxes.data(), boxes.size(), thickness, 0 );
+    } );
+
+    EXPECT_EQ( keyed.pixels, bordered.pixels );
+
+    RecordProperty( "colourKeyedUs", std::to_string( keyedUs ) );
+    RecordProperty( "borderUs", std::to_string( borderUs ) );
+    printf( "10 boxes on %ux%u RGB565: colour keyed tiles %.1f us, border fills %.1f us per frame\n", width, height, keyedUs, borderUs );
+}
@@ -69,6 +69,7 @@
 
 /* TF-M ITS include */
 #include "psa/internal_trusted_storage.h"
+#include "psa/crypto.h"
 
 /* Default FreeRTOS API for console logging. */
 #define DEV_MODE_KEY_PROVISIONING_PRINT( X )    printf
@@ -97,6 +98,10 @@ extern void vLoggingPrint( const char * pcFormat );
 #define FIRST_BOOT_ITS_UID          ( 1U )
 #define BOOT_PATTERN                ( 0x55 )
 
+#define MANIFEST_ITS_UID            ( 2U )
+#define MANIFEST_MAGIC              ( 0x4D414E46UL )
+#define MANIFEST_VERSION            ( 1U )
+
 /* Adding one to all of the lengths because ASN1 may pad a leading 0 byte
  * to numbers that could be interpreted as negative */
 typedef struct RsaParams_t
@@ -111,6 +116,15 @@ typedef struct RsaParams_t
     CK_BYTE coefficient[ COEFFICIENT_LENGTH + 1 ];
 } RsaParams_t;
 
+/* Record that the device was provisioned, kept in ITS so that the
+ * provisioning check at boot is a single ITS read and does not need to look
+ * at the PKCS #11 objects. */
+typedef struct ProvisioningManifest_t
+{
+    uint32_t ulMagic;
+    uint32_t ulVersion;
+} ProvisioningManifest_t;
+
 /* Internal structure for capturing the provisioned state of the host device. */
 typedef struct ProvisionedState_t
 {
@@ -1482,7 +1496,27 @@ UBaseType_t uxIsDeviceProvisioned( void )
         const psa_storage_uid_t uid = FIRST_BOOT_ITS_UID;
         uint8_t boot_pattern_in_its = 0;
         size_t read_data_length = 0;
+        ProvisioningManifest_t xManifest = { 0 };
+
+        status = psa_its_get( MANIFEST_ITS_UID, 0, sizeof( xManifest ), &xManifest,
+                              &read_data_length );
+
+        if( status == PSA_SUCCESS )
+        {
+            if( ( read_data_length == sizeof( xManifest ) ) &&
+                ( xManifest.ulMagic == MANIFEST_MAGIC ) &&
+                ( xManifest.ulVersion == MANIFEST_VERSION ) )
+            {
+                return 1;
+            }
+            else
+            {
+                return 0;
+            }
+        }
 
+        /* Devices provisioned before the manifest was recorded only have the
+         * boot pattern. */
         status = psa_its_get( uid, 0, 1, &boot_pattern_in_its,
                               &read_data_length );
 
@@ -1515,9 +1549,28 @@ psa_status_t xWriteDeviceProvisioned( void )
         const psa_storage_uid_t uid = FIRST_BOOT_ITS_UID;
         const psa_storage_create_flags_t flags = PSA_STORAGE_FLAG_WRITE_ONCE;
         uint8_t first_boot_pattern = BOOT_PATTERN;
+        struct psa_storage_info_t xInfo;
+        ProvisioningManifest_t xManifest = { 0 };
+        psa_status_t status;
+
+        /* The pattern is write-once, it is already there when the device is
+         * provisioned again because its manifest is not valid. */
+        status = psa_its_get_info( uid, &xInfo );
+
+        if( status == PSA_ERROR_DOES_NOT_EXIST )
+        {
+            /* Write the pattern to ITS */
+            status = psa_its_set( uid, 1, &first_boot_pattern, flags );
+        }
+
+        if( status == PSA_SUCCESS )
+        {
+            xManifest.ulMagic = MANIFEST_MAGIC;
+            xManifest.ulVersion = MANIFEST_VERSION;
+            status = psa_its_set( MANIFEST_ITS_UID, sizeof( xManifest ), &xManifest, PSA_STORAGE_FLAG_NONE );
+        }
 
-        /* Write the pattern to ITS */
-        return psa_its_set( uid, 1, &first_boot_pattern, flags );
+        return status;
     #else /* ifdef PSA_CRYPTO_IMPLEMENTATION_TFM */
         return PSA_SUCCESS;
     #endif /* ifdef PSA_CRYPTO_IMPLEMENTATION_TFM */
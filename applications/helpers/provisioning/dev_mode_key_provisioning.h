@@ -249,7 +249,19 @@ CK_RV xDestroyProvidedObjects( CK_SESSION_HANDLE xSession,
 int xOtaProvisionCodeSigningKey( psa_key_handle_t * pxKeyHandle,
                                  size_t keyBits );
 
+/**
+ * \brief Check whether the device was provisioned, from the manifest recorded
+ *        in ITS.
+ *
+ *   \return 1 if the device is provisioned, 0 if it needs provisioning.
+ */
 UBaseType_t uxIsDeviceProvisioned( void );
+
+/**
+ * \brief Record in ITS that the device was provisioned.
+ *
+ *   \return PSA_SUCCESS if the record was written.
+ */
 psa_status_t xWriteDeviceProvisioned( void );
 
 #endif /* _AWS_DEV_MODE_KEY_PROVISIONING_H_ */
@@ -28,6 +28,8 @@
 #ifndef SNTP_CLIENT_TASK_H
 #define SNTP_CLIENT_TASK_H
 
+#include <stdint.h>
+
 #include "mbedtls/platform_time.h"
 
 /**
@@ -65,6 +67,20 @@ void vPrintTime( const mbedtls_time_t * pTime );
  */
 void initializeSystemClock( void );
 
+/**
+ * @brief Used by application to query UTC time with microsecond resolution
+ * from the system, e.g. to timestamp inference results and logs.
+ *
+ * @note This does not wait for the SNTP client task while it synchronizes
+ * the system time, and can be called from any task. It briefly enters a
+ * critical section to read the tick count, so it must not be called from an
+ * interrupt.
+ *
+ * @return The current time in the system as microseconds since
+ * 1st January 1970 00h:00m:00s.
+ */
+uint64_t systemGetUtcTimeUs( void );
+
 /**
  * @brief Used by application to query wall-clock
  * time as unsigned integer seconds from the system.
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef SNTP_CLOCK_H
+#define SNTP_CLOCK_H
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Offset above which the clock is stepped to the time server's time
+ * instead of slewed towards it.
+ */
+#ifndef SNTP_CLOCK_STEP_THRESHOLD_US
+    #define SNTP_CLOCK_STEP_THRESHOLD_US    ( 128000 )
+#endif
+
+/**
+ * @brief Maximum rate at which an offset is slewed in, in parts per million.
+ */
+#ifndef SNTP_CLOCK_MAX_SLEW_PPM
+    #define SNTP_CLOCK_MAX_SLEW_PPM    ( 500 )
+#endif
+
+/**
+ * @brief Maximum rate correction of the local clock, in parts per billion.
+ */
+#ifndef SNTP_CLOCK_MAX_DRIFT_PPB
+    #define SNTP_CLOCK_MAX_DRIFT_PPB    ( 500000 )
+#endif
+
+/**
+ * @brief Shortest interval between synchronizations used to estimate drift.
+ */
+#ifndef SNTP_CLOCK_MIN_DRIFT_INTERVAL_US
+    #define SNTP_CLOCK_MIN_DRIFT_INTERVAL_US    ( 1000000 )
+#endif
+
+/**
+ * @brief Duration over which a leap second is smeared before it happens.
+ */
+#ifndef SNTP_CLOCK_LEAP_SMEAR_SECONDS
+    #define SNTP_CLOCK_LEAP_SMEAR_SECONDS    ( 1000 )
+#endif
+
+/**
+ * @brief Leap second announced by a time server for the end of the month.
+ */
+typedef enum SntpClockLeapSecond
+{
+    SntpClockNoLeapSecond = 0,
+    SntpClockLeapSecondInserted, /*!< The last minute has 61 seconds. */
+    SntpClockLeapSecondDeleted   /*!< The last minute has 59 seconds. */
+} SntpClockLeapSecond_t;
+
+/**
+ * @brief Parameters mapping the local clock to UTC.
+ *
+ * UTC = baseUtcUs + elapsed + elapsed x driftPpb / 10^9 + slewed part of slewUs
+ * where elapsed is the local time since baseLocalUs. The leap second smear is
+ * added on top of that.
+ */
+typedef struct SntpClockState
+{
+    uint64_t baseLocalUs;         /*!< Local time the clock was last synchronized at. */
+    uint64_t baseUtcUs;           /*!< UTC at baseLocalUs, in microseconds since 1st January 1970. */
+    int32_t driftPpb;             /*!< Rate correction of the local clock. */
+    int32_t slewUs;               /*!< Offset slewed in from baseLocalUs. */
+    uint32_t slewDurationUs;      /*!< Local time it takes to slew in slewUs. */
+    uint64_t leapUtcUs;           /*!< UTC at which the pending leap second happens. */
+    uint64_t leapSmearStartUtcUs; /*!< UTC at which the smear of the leap second starts. */
+    int32_t leapAdjustmentUs;     /*!< Adjustment made by the leap second, 0 if none is pending. */
+    bool synchronized;            /*!< Whether the clock was ever synchronized. */
+} SntpClockState_t;
+
+/**
+ * @brief UTC clock updated by a single writer and read without locks.
+ *
+ * The writer updates the copy of the state readers are not using and then
+ * bumps the sequence number, so a reader preempting the writer never waits
+ * for it. A reader retries if the sequence number changed while it copied.
+ */
+typedef struct SntpClock
+{
+    uint32_t sequence;
+    SntpClockState_t states[ 2 ];
+    bool driftMeasured;
+} SntpClock_t;
+
+/**
+ * @brief Initialize the clock to a time that is not synchronized yet.
+ *
+ * @param[out] clock The clock.
+ * @param[in] localUs The local time, in microseconds.
+ * @param[in] utcUs The UTC at localUs, in microseconds since 1st January 1970.
+ */
+void sntpClock_Init( SntpClock_t * clock,
+                     uint64_t localUs,
+                     uint64_t utcUs );
+
+/**
+ * @brief Get the UTC at a local time. Can be called concurrently with
+ * sntpClock_Synchronize.
+ *
+ * @param[in] clock The clock.
+ * @param[in] localUs The local time, in microseconds.
+ *
+ * @return The UTC in microseconds since 1st January 1970.
+ */
+uint64_t sntpClock_GetUtcUs( const SntpClock_t * clock,
+                             uint64_t localUs );
+
+/**
+ * @brief Correct the clock with the offset measured against a time server.
+ *
+ * The first offset and offsets above SNTP_CLOCK_STEP_THRESHOLD_US step the
+ * clock, smaller ones are slewed in so the clock never goes backwards. The
+ * rate correction is refined from the offset left once the previous slew is
+ * accounted for.
+ *
+ * @param[in, out] clock The clock. Only one task may synchronize it.
+ * @param[in] localUs The local time the offset was measured at.
+ * @param[in] offsetUs The time server's time minus sntpClock_GetUtcUs at localUs.
+ * @param[in] leapSecond The leap second announced by the time server.
+ */
+void sntpClock_Synchronize( SntpClock_t * clock,
+                            uint64_t localUs,
+                            int64_t offsetUs,
+                            SntpClockLeapSecond_t leapSecond );
+
+#endif /* SNTP_CLOCK_H */
@@ -60,8 +60,11 @@
 #include "app_config.h"
 
 #include "sntp_client_task.h"
+#include "sntp_clock.h"
 #include "core_sntp_config.h"
 
+#include CMSIS_device_header
+
 /* Kernel includes. */
 #include "FreeRTOS.h"
 #include "task.h"
@@ -69,14 +72,14 @@
 /* SNTP library include. */
 #include "core_sntp_client.h"
 
-/* Synchronization primitive include. */
-#include "semphr.h"
-
 /* FreeRTOS+TCP includes */
 #include "FreeRTOS_IP.h"
 #include "FreeRTOS_UDP_IP.h"
 #include "FreeRTOS_Sockets.h"
 
+/* Resolver cache shared with the TLS transport. */
+#include "dns_cache.h"
+
 /* PKCS11 includes. */
 #include "core_pki_utils.h"
 #include "core_pkcs11_config.h"
@@ -134,13 +137,13 @@
 #define SNTP_CONTEXT_NETWORK_BUFFER_SIZE        ( SNTP_PACKET_BASE_SIZE )
 
 /**
- * @brief The constant for storing the number of milliseconds per FreeRTOS tick in the system.
- * @note This value represents the time duration per tick from the perspective of the
- * of Windows Simulator based FreeRTOS system that carries lagging clock drift in relation to
- * internet time or UTC time. Thus, the actual time duration value per tick of the system will be
- * larger from the perspective of internet time.
+ * @brief The number of microseconds per FreeRTOS tick in the system.
+ * @note The targets run 1 tick per millisecond whatever configTICK_RATE_HZ,
+ * see FreeRTOSConfig_target.h, so the tick duration comes from TICKS_TO_pdMS.
+ * This is the nominal duration. The drift estimated by the system clock
+ * corrects the difference with internet time or UTC time.
  */
-#define MILLISECONDS_PER_TICK                   ( 1 )
+#define MICROSECONDS_PER_TICK                   ( ( uint64_t ) TICKS_TO_pdMS( 1U ) * 1000U )
 
 /**
  * @brief The fixed size of the key for the AES-128-CMAC algorithm used for authenticating communication
@@ -243,29 +246,24 @@ struct SntpAuthContext
  * in Coordinated Universal Time (UTC) for system.
  *
  * @note This demo uses the following mathematical model to represent current
- * time in RAM.
+ * time in RAM, see sntp_clock.h.
  *
- *  BaseTime = Time set at boot or the last synchronized time
- *  Slew Rate = Number of milliseconds to adjust per system time second
- *  No. of ticks since last SNTP sync = Current FreeRTOS Tick Count -
- *                                      Tick count at last SNTP sync
+ *  Local Time = FreeRTOS tick count x Microseconds per tick +
+ *               Microseconds elapsed in the current tick (from SysTick)
  *
- *  Time Elapsed since last SNTP sync = No. of ticks since last SNTP sync
- *                                                    x
- *                                      Number of milliseconds per FreeRTOS tick
+ *  Current Time = Base Time at last SNTP sync +
+ *                 Local Time elapsed since last SNTP sync x ( 1 + Drift ) +
+ *                 Slewed part of the offset measured at last SNTP sync +
+ *                 Leap second smear
  *
- *  Slew Adjustment = Slew Rate x Time Elapsed since last SNTP sync
- *
- *  Current Time = Base Time +
- *                 Time Elapsed since last SNTP sync +
- *                 Slew Adjustment
+ * The SNTP client task is the only writer of the clock, which other tasks
+ * read without waiting for it. Reading the local time enters a critical
+ * section for the tick count, so the clock is not read from interrupts.
  */
 typedef struct SystemClock
 {
-    UTCTime_t baseTime;
-    TickType_t lastSyncTickCount;
+    SntpClock_t clock;
     uint32_t pollPeriod;
-    uint64_t slewRate; /* Milliseconds/Seconds */
     bool firstTimeSyncDone;
 } SystemClock_t;
 
@@ -275,12 +273,6 @@ typedef struct SystemClock
  */
 static SystemClock_t systemClock;
 
-/**
- * @brief Mutex for protecting access to the shared memory of the
- * system clock parameters.
- */
-static SemaphoreHandle_t xMutex = NULL;
-
 /*
  * @brief Stores the configured time servers in an array.
  */
@@ -313,29 +305,16 @@ static const int32_t pAuthKeyIds[] = { democonfigLIST_OF_AUTHENTICATION_KEY_IDS
 static uint32_t translateYearToUnixSeconds( uint16_t year );
 
 /**
- * @brief Calculates the current time in the system.
- * It calculates the current time as:
- *
- *   BaseTime = Time set at device boot or the last synchronized time
- *   SlewRate = Number of milliseconds to adjust per system time second
+ * @brief Reads the local time of the system with microsecond resolution from
+ * the FreeRTOS tick count and the SysTick counter.
  *
- *   Current Time = Base Time +
- *                  Time since last SNTP Synchronization +
- *                  Slew Adjustment (if slew rate > 0) for time period since
- *                  last SNTP synchronization
+ * @note The tick count and its overflows are read with
+ * vTaskSetTimeOutState(), which enters a critical section. This function
+ * must not be called from an interrupt.
  *
- * @param[in] pBaseTime The base time in the system clock parameters.
- * @param[in] lastSyncTickCount The tick count at the last time synchronization
- * with a time server.
- * @param[in] slewRate The slew rate as seconds of clock adjustment per FreeRTOS
- * system time second.
- * @param[out] pCurrentTime This will be populated with the calculated current
- * UTC time in the system.
+ * @return The microseconds elapsed since the scheduler started.
  */
-static void calculateCurrentTime( UTCTime_t * pBaseTime,
-                                  TickType_t lastSyncTickCount,
-                                  uint64_t slewRate,
-                                  UTCTime_t * pCurrentTime );
+static uint64_t getLocalTimeUs( void );
 
 /**
  * @brief Initializes the SNTP context for the SNTP client task.
@@ -440,21 +419,15 @@ static void sntpClient_GetTime( SntpTimestamp_t * pCurrentTime );
  *
  * @note This demo uses a combination of "step" AND "slew" methodology
  * for system clock correction.
- * 1. "Step" correction is ALWAYS used to immediately correct the system clock
- *    to match server time on every successful time synchronization with a
- *    time server (that occurs periodically on the poll interval gaps).
+ * 1. "Step" correction is used to immediately correct the system clock to match
+ *    server time on the first time synchronization since device boot-up, and
+ *    whenever the clock offset exceeds SNTP_CLOCK_STEP_THRESHOLD_US.
  *
- * 2. "Slew" correction approach is used for compensating system clock drift
- *    during the poll interval period between time synchronization attempts with
- *    time server(s) when latest time server is not known. The "slew rate" is
- *    calculated ONLY once on the occasion of the second successful time
- *    synchronization with a time server. This is because the demo initializes
- *    system time with (the first second of) the democonfigSYSTEM_START_YEAR
- *    configuration, and thus, the the actual system clock drift over a period
- *    of time can be calculated only AFTER the demo system time has been synchronized
- *    with server time once. Thus, after the first time period of poll interval has
- *    transpired, the system clock drift is calculated correctly on the subsequent
- *    successful time synchronization with a time server.
+ * 2. "Slew" correction is used for smaller clock offsets, which are corrected
+ *    gradually so that the system time never goes backwards. The system clock
+ *    drift is estimated again on every time synchronization from the part of
+ *    the clock offset that the previous slew does not account for, so the rate
+ *    correction follows changes of the system clock drift.
  *
  * @note The above system clock correction algorithm is just one example of a correction
  * approach. It can be modified to suit your application needs. For example, your
@@ -471,14 +444,13 @@ static void sntpClient_GetTime( SntpTimestamp_t * pCurrentTime );
  * time response.
  * @param[in] clockOffsetMs The value, in milliseconds, of system clock offset relative
  * to the server time calculated by the coreSNTP library. If the value is positive, then
- * the system is BEHIND the server time, and a "slew" clock correction approach is used in
- * this demo. If the value is negative, then the system time is AHEAD of the server time,
- * and a "step" clock correction approach is used in this demo.
+ * the system is BEHIND the server time. If the value is negative, then the system time is
+ * AHEAD of the server time.
  * @param[in] leapSecondInfo This indicates whether there is an upcoming leap second insertion
  * or deletion (according to astronomical time) the last minute of the end of the month that the
  * system time needs to adjust for. Leap second adjustment is valuable for applications that
- * require non-abrupt increment of time for use cases like logging. This demo DOES NOT showcase
- * leap second adjustment in system clock.
+ * require non-abrupt increment of time for use cases like logging. This demo smears the leap
+ * second over the last SNTP_CLOCK_LEAP_SMEAR_SECONDS before it happens.
  */
 static void sntpClient_SetTime( const SntpServerInfo_t * pTimeServer,
                                 const SntpTimestamp_t * pServerTime,
@@ -672,38 +644,32 @@ static uint32_t translateYearToUnixSeconds( uint16_t year )
     return( numOfDaysSince1970 * 24 * 3600 );
 }
 
-void calculateCurrentTime( UTCTime_t * pBaseTime,
-                           TickType_t lastSyncTickCount,
-                           uint64_t slewRate,
-                           UTCTime_t * pCurrentTime )
+static uint64_t getLocalTimeUs( void )
 {
-    uint64_t msElapsedSinceLastSync = 0;
-    TickType_t ticksElapsedSinceLastSync = xTaskGetTickCount() - lastSyncTickCount;
+    TimeOut_t tickState;
+    uint32_t reload = SysTick->LOAD + 1U;
+    uint32_t countdown;
+    uint64_t ticks;
+
+    /* Retry if the tick interrupt ran between reading the tick count and
+     * the SysTick counter. */
+    do
+    {
+        vTaskSetTimeOutState( &tickState );
+        countdown = SysTick->VAL;
 
-    /* Calculate time elapsed since last synchronization according to the number
-     * of system ticks passed. */
-    msElapsedSinceLastSync = ticksElapsedSinceLastSync * MILLISECONDS_PER_TICK;
+        ticks = ( ( uint64_t ) ( uint32_t ) tickState.xOverflowCount << ( sizeof( TickType_t ) * 8U ) ) |
+                ( uint64_t ) tickState.xTimeOnEntering;
 
-    /* If slew rate is set, then apply the slew-based clock adjustment for the elapsed time. */
-    if( slewRate > 0 )
-    {
-        /* Slew Adjustment = Slew Rate ( Milliseconds/seconds )
-         *                                      x
-         *                   No. of seconds since last synchronization. */
-        msElapsedSinceLastSync += slewRate * ( msElapsedSinceLastSync / 1000 );
-    }
+        /* The counter has wrapped but the tick interrupt is masked. */
+        if( ( ( SCB->ICSR & SCB_ICSR_PENDSTSET_Msk ) != 0U ) && ( countdown > ( reload / 2U ) ) )
+        {
+            ticks++;
+        }
+    } while( tickState.xTimeOnEntering != xTaskGetTickCount() );
 
-    /* Set the current UTC time in the output parameter. */
-    if( msElapsedSinceLastSync >= 1000 )
-    {
-        pCurrentTime->secs = pBaseTime->secs + msElapsedSinceLastSync / 1000;
-        pCurrentTime->msecs = msElapsedSinceLastSync % 1000;
-    }
-    else
-    {
-        pCurrentTime->secs = pBaseTime->secs;
-        pCurrentTime->msecs = msElapsedSinceLastSync;
-    }
+    return ( ticks * MICROSECONDS_PER_TICK ) +
+           ( ( ( uint64_t ) ( reload - 1U - countdown ) * MICROSECONDS_PER_TICK ) / reload );
 }
 
 /********************** DNS Resolution Interface *******************************/
@@ -713,7 +679,9 @@ static bool resolveDns( const SntpServerInfo_t * pServerAddr,
     uint32_t resolvedAddr = 0;
     bool status = false;
 
-    resolvedAddr = FreeRTOS_gethostbyname( pServerAddr->pServerName );
+    /* Reuse the last resolved address of the time server so that polls do
+     * not depend on the DNS server being reachable. */
+    resolvedAddr = DnsCache_Resolve( pServerAddr->pServerName );
 
     /* Set the output parameter if DNS look up succeeded. */
     if( resolvedAddr != 0 )
@@ -851,22 +819,11 @@ static int32_t UdpTransport_Recv( NetworkContext_t * pNetworkContext,
 /**************************** Time Interfaces ************************************************/
 static void sntpClient_GetTime( SntpTimestamp_t * pCurrentTime )
 {
-    UTCTime_t currentTime;
+    uint64_t currentTimeUs = systemGetUtcTimeUs();
     uint64_t ntpSecs;
 
-    /* Obtain mutex for accessing system clock variables */
-    xSemaphoreTake( xMutex, portMAX_DELAY );
-
-    calculateCurrentTime( &systemClock.baseTime,
-                          systemClock.lastSyncTickCount,
-                          systemClock.slewRate,
-                          &currentTime );
-
-    /* Release mutex. */
-    xSemaphoreGive( xMutex );
-
     /* Convert UTC time from UNIX timescale to SNTP timestamp format. */
-    ntpSecs = currentTime.secs + SNTP_TIME_AT_UNIX_EPOCH_SECS;
+    ntpSecs = ( currentTimeUs / 1000000U ) + SNTP_TIME_AT_UNIX_EPOCH_SECS;
 
     /* Support case of SNTP timestamp rollover on 7 February 2036 when
      * converting from UNIX time to SNTP timestamp. */
@@ -881,7 +838,7 @@ static void sntpClient_GetTime( SntpTimestamp_t * pCurrentTime )
         pCurrentTime->seconds = ntpSecs;
     }
 
-    pCurrentTime->fractions = MILLISECONDS_TO_SNTP_FRACTIONS( currentTime.msecs );
+    pCurrentTime->fractions = ( uint32_t ) ( currentTimeUs % 1000000U ) * SNTP_FRACTION_VALUE_PER_MICROSECOND;
 }
 
 static void sntpClient_SetTime( const SntpServerInfo_t * pTimeServer,
@@ -889,59 +846,48 @@ static void sntpClient_SetTime( const SntpServerInfo_t * pTimeServer,
                                 int64_t clockOffsetMs,
                                 SntpLeapSecondInfo_t leapSecondInfo )
 {
-    /* Note: This demo DOES NOT show adjustment of leap second in system time,
-     * if an upcoming leap second adjustment is mentioned in server response.
-     * Leap second adjustment occurs at low frequency (only for the last minute of June
-     * or December) and can be useful for applications that require smooth system
-     * time continuum ALWAYS including the time of the leap second adjustment.
-     *
-     * For more information on leap seconds, refer to
-     * https://www.nist.gov/pml/time-and-frequency-division/leap-seconds-faqs.
-     */
-    ( void ) leapSecondInfo;
+    uint64_t localTimeUs = getLocalTimeUs();
+    int64_t clockOffsetUs = clockOffsetMs * 1000;
+    SntpClockLeapSecond_t leapSecond = SntpClockNoLeapSecond;
 
     LogInfo( ( "Received time from time server: %s", pTimeServer->pServerName ) );
 
-    /* Obtain the mutext for accessing system clock variables. */
-    xSemaphoreTake( xMutex, portMAX_DELAY );
-
-    /* Always correct the system base time on receiving time from server.*/
-    SntpStatus_t status;
-    uint32_t unixSecs;
-    uint32_t unixMicroSecs;
-
-    /* Convert server time from NTP timestamp to UNIX format. */
-    status = Sntp_ConvertToUnixTime( pServerTime,
-                                     &unixSecs,
-                                     &unixMicroSecs );
-    configASSERT( status == SntpSuccess );
-
-    /* Always correct the base time of the system clock as the time received from the server. */
-    systemClock.baseTime.secs = unixSecs;
-    systemClock.baseTime.msecs = unixMicroSecs / 1000;
-
-    /* Set the clock adjustment "slew" rate of system clock if it wasn't set already and this is NOT
-     * the first clock synchronization since device boot-up. */
-    if( ( systemClock.firstTimeSyncDone == true ) && ( systemClock.slewRate == 0 ) )
+    /* Leap seconds are smeared over the end of the last day of the month,
+     * which keeps the system time monotonic. For more information on leap
+     * seconds, refer to
+     * https://www.nist.gov/pml/time-and-frequency-division/leap-seconds-faqs. */
+    if( leapSecondInfo == LastMinuteHas61Seconds )
     {
-        /* We will use a "slew" correction approach to compensate for system clock
-         * drift over poll interval period that exists between consecutive time synchronizations
-         * with time server. */
-
-        /* Calculate the "slew" rate for system clock as milliseconds of adjustment needed per second. */
-        systemClock.slewRate = clockOffsetMs / systemClock.pollPeriod;
+        leapSecond = SntpClockLeapSecondInserted;
+    }
+    else if( leapSecondInfo == LastMinuteHas59Seconds )
+    {
+        leapSecond = SntpClockLeapSecondDeleted;
     }
 
-    /* Set the system clock flag that indicates completion of the first time synchronization since device boot-up. */
+    /* The first synchronization since device boot-up sets the time received
+     * from the server, which may be years away from the start time. */
     if( systemClock.firstTimeSyncDone == false )
     {
+        SntpStatus_t status;
+        uint32_t unixSecs;
+        uint32_t unixMicroSecs;
+
+        /* Convert server time from NTP timestamp to UNIX format. */
+        status = Sntp_ConvertToUnixTime( pServerTime,
+                                         &unixSecs,
+                                         &unixMicroSecs );
+        configASSERT( status == SntpSuccess );
+
+        clockOffsetUs = ( int64_t ) ( ( ( uint64_t ) unixSecs * 1000000U ) + unixMicroSecs ) -
+                        ( int64_t ) sntpClock_GetUtcUs( &systemClock.clock, localTimeUs );
+
         systemClock.firstTimeSyncDone = true;
     }
 
-    /* Store the tick count of the current time synchronization in the system clock. */
-    systemClock.lastSyncTickCount = xTaskGetTickCount();
-
-    xSemaphoreGive( xMutex );
+    /* Step or slew the system clock by the offset measured by the server, and
+     * refine the drift estimated over the previous poll periods. */
+    sntpClock_Synchronize( &systemClock.clock, localTimeUs, clockOffsetUs, leapSecond );
 }
 
 /**************************** Authentication Utilities and Interface Functions ***********************************************/
@@ -1314,17 +1260,12 @@ static uint32_t generateRandomNumber()
 void initializeSystemClock( void )
 {
     /* On boot-up initialize the system time as the first second in the configured year. */
-    int64_t startupTimeInUnixSecs = translateYearToUnixSeconds( democonfigSYSTEM_START_YEAR );
+    uint64_t startupTimeInUnixSecs = translateYearToUnixSeconds( democonfigSYSTEM_START_YEAR );
 
-    systemClock.baseTime.secs = startupTimeInUnixSecs;
-    systemClock.baseTime.msecs = 0;
+    sntpClock_Init( &systemClock.clock, getLocalTimeUs(), startupTimeInUnixSecs * 1000000U );
 
     LogInfo( ( "System time has been initialized to the year %u", democonfigSYSTEM_START_YEAR ) );
 
-    /* Initialize semaphore for guarding access to system clock variables. */
-    xMutex = xSemaphoreCreateMutex();
-    configASSERT( xMutex );
-
     /* Clear the first time sync completed flag of the system clock object so that a "step" correction
      * of system time is utilized for the first time synchronization from a time server. */
     systemClock.firstTimeSyncDone = false;
@@ -1639,22 +1580,25 @@ void sntpTask( void * pParameters )
 
 /*-----------------------------------------------------------*/
 
-mbedtls_time_t systemGetWallClockTime( mbedtls_time_t * pTime )
+uint64_t systemGetUtcTimeUs( void )
 {
-    UTCTime_t xCurrentTimeUtc;
-
-    /* Obtain the mutext for accessing system clock variables. */
-    xSemaphoreTake( xMutex, portMAX_DELAY );
-
     /* Calculate the current RAM-based time using a mathematical formula using
      * system clock state parameters and the time transpired since last synchronization. */
-    calculateCurrentTime( &systemClock.baseTime,
-                          systemClock.lastSyncTickCount,
-                          systemClock.slewRate,
-                          &xCurrentTimeUtc );
+    return sntpClock_GetUtcUs( &systemClock.clock, getLocalTimeUs() );
+}
+
+/*-----------------------------------------------------------*/
+
+mbedtls_time_t systemGetWallClockTime( mbedtls_time_t * pTime )
+{
+    mbedtls_time_t xCurrentTime = ( mbedtls_time_t ) ( systemGetUtcTimeUs() / 1000000U );
+
+    if( pTime != NULL )
+    {
+        *pTime = xCurrentTime;
+    }
 
-    xSemaphoreGive( xMutex );
-    return xCurrentTimeUtc.secs;
+    return xCurrentTime;
 }
 
 /*-----------------------------------------------------------*/
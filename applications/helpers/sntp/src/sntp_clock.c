@@ -0,0 +1,277 @@
+/*
+ * Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ *
+ * SPDX-License-Identifier: MIT
+ * Licensed under the MIT License. See the LICENSE accompanying this file
+ * for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sntp_clock.h"
+
+#define US_PER_SECOND    ( 1000000LL )
+#define US_PER_DAY       ( 86400ULL * 1000000ULL )
+#define PPB_PER_UNIT     ( 1000000000LL )
+
+static int64_t clampToRange( int64_t value,
+                             int64_t limit )
+{
+    int64_t clamped = value;
+
+    if( clamped > limit )
+    {
+        clamped = limit;
+    }
+    else if( clamped < -limit )
+    {
+        clamped = -limit;
+    }
+
+    return clamped;
+}
+
+/* Civil date from days since 1st January 1970, see
+ * http://howardhinnant.github.io/date_algorithms.html */
+static void civilFromDays( uint32_t days,
+                           uint32_t * year,
+                           uint32_t * month,
+                           uint32_t * day )
+{
+    uint32_t shifted = days + 719468U;
+    uint32_t era = shifted / 146097U;
+    uint32_t dayOfEra = shifted - ( era * 146097U );
+    uint32_t yearOfEra = ( dayOfEra - ( dayOfEra / 1460U ) + ( dayOfEra / 36524U ) - ( dayOfEra / 146096U ) ) / 365U;
+    uint32_t dayOfYear = dayOfEra - ( ( 365U * yearOfEra ) + ( yearOfEra / 4U ) - ( yearOfEra / 100U ) );
+    uint32_t monthFromMarch = ( ( 5U * dayOfYear ) + 2U ) / 153U;
+
+    *day = dayOfYear - ( ( ( 153U * monthFromMarch ) + 2U ) / 5U ) + 1U;
+    *month = ( monthFromMarch < 10U ) ? ( monthFromMarch + 3U ) : ( monthFromMarch - 9U );
+    *year = yearOfEra + ( era * 400U ) + ( ( *month <= 2U ) ? 1U : 0U );
+}
+
+static uint32_t daysInMonth( uint32_t year,
+                             uint32_t month )
+{
+    static const uint8_t monthDays[ 12 ] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leapYear = ( ( year % 4U ) == 0U ) && ( ( ( year % 100U ) != 0U ) || ( ( year % 400U ) == 0U ) );
+
+    return monthDays[ month - 1U ] + ( ( ( month == 2U ) && leapYear ) ? 1U : 0U );
+}
+
+/* Leap seconds happen at the end of the last day of a month. */
+static uint64_t startOfNextMonthUs( uint64_t utcUs )
+{
+    uint32_t days = ( uint32_t ) ( utcUs / US_PER_DAY );
+    uint32_t year;
+    uint32_t month;
+    uint32_t day;
+
+    civilFromDays( days, &year, &month, &day );
+
+    return ( ( uint64_t ) days + daysInMonth( year, month ) - day + 1U ) * US_PER_DAY;
+}
+
+static int64_t slewedUs( const SntpClockState_t * state,
+                         int64_t elapsedUs )
+{
+    int64_t slewed = 0;
+
+    if( elapsedUs >= ( int64_t ) state->slewDurationUs )
+    {
+        slewed = state->slewUs;
+    }
+    else if( elapsedUs > 0 )
+    {
+        slewed = ( ( int64_t ) state->slewUs * elapsedUs ) / ( int64_t ) state->slewDurationUs;
+    }
+
+    return slewed;
+}
+
+/* UTC at localUs, without the leap second smear. */
+static uint64_t unsmearedUtcUs( const SntpClockState_t * state,
+                                uint64_t localUs )
+{
+    /* A reader may have sampled the local time just before the state it uses
+     * was synchronized, which makes the elapsed time slightly negative. */
+    int64_t elapsedUs = ( int64_t ) ( localUs - state->baseLocalUs );
+
+    return state->baseUtcUs +
+           ( uint64_t ) ( elapsedUs +
+                          ( ( elapsedUs * state->driftPpb ) / PPB_PER_UNIT ) +
+                          slewedUs( state, elapsedUs ) );
+}
+
+/* A leap second is spread over the end of the day it happens on instead of
+ * repeating or skipping a second, so the clock stays monotonic. */
+static int64_t leapSmearUs( const SntpClockState_t * state,
+                            uint64_t utcUs )
+{
+    int64_t smear = 0;
+
+    if( state->leapAdjustmentUs != 0 )
+    {
+        if( utcUs >= state->leapUtcUs )
+        {
+            smear = state->leapAdjustmentUs;
+        }
+        else if( utcUs > state->leapSmearStartUtcUs )
+        {
+            smear = ( ( int64_t ) state->leapAdjustmentUs * ( int64_t ) ( utcUs - state->leapSmearStartUtcUs ) ) /
+                    ( int64_t ) ( state->leapUtcUs - state->leapSmearStartUtcUs );
+        }
+    }
+
+    return smear;
+}
+
+static void readState( const SntpClock_t * clock,
+                       SntpClockState_t * state )
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = __atomic_load_n( &clock->sequence, __ATOMIC_ACQUIRE );
+        *state = clock->states[ sequence & 1U ];
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    } while( __atomic_load_n( &clock->sequence, __ATOMIC_RELAXED ) != sequence );
+}
+
+static void publishState( SntpClock_t * clock,
+                          const SntpClockState_t * state )
+{
+    uint32_t sequence = clock->sequence + 1U;
+
+    /* Readers use the other copy until the sequence number moves to this one. */
+    clock->states[ sequence & 1U ] = *state;
+    __atomic_store_n( &clock->sequence, sequence, __ATOMIC_RELEASE );
+}
+
+void sntpClock_Init( SntpClock_t * clock,
+                     uint64_t localUs,
+                     uint64_t utcUs )
+{
+    SntpClockState_t state;
+
+    ( void ) memset( clock, 0, sizeof( *clock ) );
+    ( void ) memset( &state, 0, sizeof( state ) );
+
+    state.baseLocalUs = localUs;
+    state.baseUtcUs = utcUs;
+
+    publishState( clock, &state );
+}
+
+uint64_t sntpClock_GetUtcUs( const SntpClock_t * clock,
+                             uint64_t localUs )
+{
+    SntpClockState_t state;
+    uint64_t utcUs;
+
+    readState( clock, &state );
+
+    utcUs = unsmearedUtcUs( &state, localUs );
+
+    return utcUs + ( uint64_t ) leapSmearUs( &state, utcUs );
+}
+
+void sntpClock_Synchronize( SntpClock_t * clock,
+                            uint64_t localUs,
+                            int64_t offsetUs,
+                            SntpClockLeapSecond_t leapSecond )
+{
+    /* Only this function writes the states, so the current one is stable. */
+    const SntpClockState_t * current = &clock->states[ clock->sequence & 1U ];
+    SntpClockState_t next = *current;
+    int64_t elapsedUs = ( int64_t ) ( localUs - current->baseLocalUs );
+    uint64_t utcUs = unsmearedUtcUs( current, localUs );
+    int64_t smearUs = leapSmearUs( current, utcUs );
+    int64_t errorUs = offsetUs;
+
+    if( ( current->leapAdjustmentUs != 0 ) && ( utcUs >= current->leapUtcUs ) )
+    {
+        /* The time server's time includes the leap second now. */
+        utcUs += ( uint64_t ) smearUs;
+        next.leapAdjustmentUs = 0;
+    }
+    else
+    {
+        /* The time server does not smear, so the offset includes the smear. */
+        errorUs += smearUs;
+    }
+
+    /* Whatever the previous slew has not corrected yet is not drift. */
+    if( current->synchronized &&
+        ( elapsedUs >= SNTP_CLOCK_MIN_DRIFT_INTERVAL_US ) &&
+        ( errorUs >= -SNTP_CLOCK_STEP_THRESHOLD_US ) &&
+        ( errorUs <= SNTP_CLOCK_STEP_THRESHOLD_US ) )
+    {
+        int64_t residualUs = errorUs - ( current->slewUs - slewedUs( current, elapsedUs ) );
+        int64_t measuredPpb = ( residualUs * PPB_PER_UNIT ) / elapsedUs;
+
+        /* Trust the first measurement fully and average the later ones, as
+         * each is only as precise as the server's round trip. */
+        if( clock->driftMeasured == false )
+        {
+            clock->driftMeasured = true;
+        }
+        else
+        {
+            measuredPpb /= 4;
+        }
+
+        next.driftPpb = ( int32_t ) clampToRange( ( int64_t ) current->driftPpb + measuredPpb,
+                                                  SNTP_CLOCK_MAX_DRIFT_PPB );
+    }
+
+    next.baseLocalUs = localUs;
+
+    if( ( current->synchronized == false ) ||
+        ( errorUs < -SNTP_CLOCK_STEP_THRESHOLD_US ) ||
+        ( errorUs > SNTP_CLOCK_STEP_THRESHOLD_US ) )
+    {
+        next.baseUtcUs = utcUs + ( uint64_t ) errorUs;
+        next.slewUs = 0;
+        next.slewDurationUs = 0;
+    }
+    else
+    {
+        next.baseUtcUs = utcUs;
+        next.slewUs = ( int32_t ) errorUs;
+        next.slewDurationUs = ( uint32_t ) ( ( ( errorUs < 0 ) ? -errorUs : errorUs ) *
+                                             ( US_PER_SECOND / SNTP_CLOCK_MAX_SLEW_PPM ) );
+    }
+
+    next.synchronized = true;
+
+    if( ( leapSecond != SntpClockNoLeapSecond ) && ( next.leapAdjustmentUs == 0 ) )
+    {
+        uint64_t smearDurationUs = ( uint64_t ) SNTP_CLOCK_LEAP_SMEAR_SECONDS * ( uint64_t ) US_PER_SECOND;
+
+        next.leapUtcUs = startOfNextMonthUs( next.baseUtcUs );
+        next.leapSmearStartUtcUs = next.baseUtcUs;
+
+        if( ( next.leapUtcUs - next.baseUtcUs ) > smearDurationUs )
+        {
+            next.leapSmearStartUtcUs = next.leapUtcUs - smearDurationUs;
+        }
+
+        next.leapAdjustmentUs = ( leapSecond == SntpClockLeapSecondInserted ) ? -US_PER_SECOND : US_PER_SECOND;
+    }
+    else if( ( leapSecond == SntpClockNoLeapSecond ) &&
+             ( next.leapAdjustmentUs != 0 ) &&
+             ( next.baseUtcUs <= next.leapSmearStartUtcUs ) )
+    {
+        /* The announcement was withdrawn before the smear started. */
+        next.leapAdjustmentUs = 0;
+    }
+
+    publishState( clock, &next );
+}
@@ -0,0 +1,154 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "sntp_clock.h"
+}
+
+/* 2016-12-31 00:00:00 UTC, the day of the last leap second. */
+static const uint64_t lastLeapDayUs = 1483142400ULL * 1000000ULL;
+static const uint64_t dayUs = 86400ULL * 1000000ULL;
+
+class TestSntpClock : public ::testing::Test
+{
+public:
+    TestSntpClock()
+    {
+        sntpClock_Init( &clock, 0U, lastLeapDayUs );
+    }
+
+    SntpClock_t clock;
+};
+
+TEST_F( TestSntpClock, the_clock_runs_at_the_local_rate_until_synchronized )
+{
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, 0U ), lastLeapDayUs );
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, 1234567U ), lastLeapDayUs + 1234567U );
+}
+
+TEST_F( TestSntpClock, the_first_synchronization_steps_the_clock )
+{
+    sntpClock_Synchronize( &clock, 1000U, 5000, SntpClockNoLeapSecond );
+
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, 1000U ), lastLeapDayUs + 6000U );
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, 2000U ), lastLeapDayUs + 7000U );
+}
+
+TEST_F( TestSntpClock, a_small_offset_is_slewed_in_without_going_backwards )
+{
+    sntpClock_Synchronize( &clock, 0U, 0, SntpClockNoLeapSecond );
+    sntpClock_Synchronize( &clock, 0U, -10000, SntpClockNoLeapSecond );
+
+    uint64_t slewDurationUs = 10000U * ( 1000000U / SNTP_CLOCK_MAX_SLEW_PPM );
+    uint64_t previous = sntpClock_GetUtcUs( &clock, 0U );
+
+    EXPECT_EQ( previous, lastLeapDayUs );
+
+    for( uint64_t localUs = 1000U; localUs <= slewDurationUs; localUs += 1000U )
+    {
+        uint64_t now = sntpClock_GetUtcUs( &clock, localUs );
+        EXPECT_GT( now, previous );
+        previous = now;
+    }
+
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, slewDurationUs ), lastLeapDayUs + slewDurationUs - 10000U );
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, 2U * slewDurationUs ), lastLeapDayUs + 2U * slewDurationUs - 10000U );
+}
+
+TEST_F( TestSntpClock, a_large_offset_steps_the_clock )
+{
+    sntpClock_Synchronize( &clock, 0U, 0, SntpClockNoLeapSecond );
+    sntpClock_Synchronize( &clock, 1000U, -2000000, SntpClockNoLeapSecond );
+
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, 1000U ), lastLeapDayUs + 1000U - 2000000U );
+}
+
+TEST_F( TestSntpClock, the_drift_of_the_local_clock_is_estimated_across_polls )
+{
+    /* The local clock runs 100 ppm slow. */
+    const double localRate = 1.0 - 100e-6;
+    const uint64_t pollUs = 64U * 1000000U;
+    uint64_t localUs = 0U;
+    int64_t offsetUs = 0;
+
+    for( int poll = 0; poll < 30; poll++ )
+    {
+        uint64_t trueUtcUs = lastLeapDayUs + ( uint64_t ) ( ( double ) localUs / localRate );
+
+        offsetUs = ( int64_t ) ( trueUtcUs - sntpClock_GetUtcUs( &clock, localUs ) );
+        sntpClock_Synchronize( &clock, localUs, offsetUs, SntpClockNoLeapSecond );
+        localUs += pollUs;
+    }
+
+    /* 100 ppm over a poll is 6.4 ms, the estimate keeps the error well below. */
+    EXPECT_LT( offsetUs, 200 );
+    EXPECT_GT( offsetUs, -200 );
+    EXPECT_NEAR( clock.states[ clock.sequence & 1U ].driftPpb, 100010, 1000 );
+}
+
+TEST_F( TestSntpClock, an_inserted_leap_second_is_smeared_before_midnight )
+{
+    uint64_t smearUs = SNTP_CLOCK_LEAP_SMEAR_SECONDS * 1000000ULL;
+    uint64_t smearStartLocalUs = dayUs - smearUs;
+
+    sntpClock_Synchronize( &clock, 0U, 0, SntpClockLeapSecondInserted );
+
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, smearStartLocalUs ), lastLeapDayUs + smearStartLocalUs );
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, smearStartLocalUs + smearUs / 2U ),
+               lastLeapDayUs + smearStartLocalUs + smearUs / 2U - 500000U );
+
+    uint64_t previous = sntpClock_GetUtcUs( &clock, smearStartLocalUs );
+
+    for( uint64_t localUs = smearStartLocalUs; localUs <= dayUs + 2000000U; localUs += 100000U )
+    {
+        uint64_t now = sntpClock_GetUtcUs( &clock, localUs );
+        EXPECT_GE( now, previous );
+        previous = now;
+    }
+
+    /* 23:59:60 has been absorbed, UTC is a second behind the local count. */
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, dayUs + 5000000U ), lastLeapDayUs + dayUs + 4000000U );
+
+    /* The time server includes the leap second after midnight. */
+    sntpClock_Synchronize( &clock, dayUs + 5000000U, 0, SntpClockNoLeapSecond );
+
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, dayUs + 6000000U ), lastLeapDayUs + dayUs + 5000000U );
+    EXPECT_EQ( clock.states[ clock.sequence & 1U ].leapAdjustmentUs, 0 );
+}
+
+TEST_F( TestSntpClock, the_server_time_during_the_smear_is_not_slewed_in )
+{
+    uint64_t smearMiddleLocalUs = dayUs - ( SNTP_CLOCK_LEAP_SMEAR_SECONDS * 1000000ULL ) / 2U;
+
+    sntpClock_Synchronize( &clock, 0U, 0, SntpClockLeapSecondInserted );
+
+    /* The server does not smear, so it is half a second ahead. */
+    sntpClock_Synchronize( &clock, smearMiddleLocalUs, 500000, SntpClockLeapSecondInserted );
+
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, dayUs + 1000000U ), lastLeapDayUs + dayUs );
+}
+
+TEST_F( TestSntpClock, a_leap_second_announced_early_happens_at_the_end_of_the_month )
+{
+    /* 2016-12-01 00:00:00 UTC. */
+    uint64_t monthStartUs = 1480550400ULL * 1000000ULL;
+
+    sntpClock_Init( &clock, 0U, monthStartUs );
+    sntpClock_Synchronize( &clock, 0U, 0, SntpClockLeapSecondDeleted );
+
+    EXPECT_EQ( clock.states[ clock.sequence & 1U ].leapUtcUs, lastLeapDayUs + dayUs );
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, 31U * dayUs + 1000000U ), monthStartUs + 31U * dayUs + 2000000U );
+}
+
+TEST_F( TestSntpClock, a_withdrawn_leap_second_announcement_is_cancelled )
+{
+    sntpClock_Synchronize( &clock, 0U, 0, SntpClockLeapSecondInserted );
+    sntpClock_Synchronize( &clock, 1000000U, 0, SntpClockNoLeapSecond );
+
+    EXPECT_EQ( clock.states[ clock.sequence & 1U ].leapAdjustmentUs, 0 );
+    EXPECT_EQ( sntpClock_GetUtcUs( &clock, dayUs + 1000000U ), lastLeapDayUs + dayUs + 1000000U );
+}
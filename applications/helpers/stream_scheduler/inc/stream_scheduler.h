@@ -0,0 +1,151 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file stream_scheduler.h
+ * @brief Share one inference engine between several camera streams.
+ *
+ * Every stream has a short queue of frames waiting for inference. When its
+ * queue is full, a new frame replaces the oldest one, so a slow stream
+ * shows recent frames rather than an old backlog. The frames are taken
+ * from the streams in turn, one frame from each stream that has any, so
+ * every stream gets the same share of the engine whatever its frame rate.
+ *
+ * The scheduler is not thread-safe, the callers serialise the accesses.
+ */
+
+#ifndef STREAM_SCHEDULER_H
+#define STREAM_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef streamschedulerMAX_STREAMS
+    #define streamschedulerMAX_STREAMS    4
+#endif
+
+#ifndef streamschedulerQUEUE_LENGTH
+    #define streamschedulerQUEUE_LENGTH    2
+#endif
+
+/**
+ * @brief An image in memory.
+ */
+typedef struct StreamImage
+{
+    uint32_t ulAddress; /*!< First pixel, 0 for no image. */
+    uint32_t ulWidth;
+    uint32_t ulHeight;
+    uint32_t ulFormat;
+} StreamImage_t;
+
+/**
+ * @brief A frame waiting for inference.
+ */
+typedef struct StreamFrame
+{
+    uint32_t ulStream;                /*!< Stream of the frame. */
+    uint32_t ulFrameId;               /*!< Identifier of the frame in its stream. */
+    uint32_t ulReadyTime;             /*!< When the frame was ready, in milliseconds. */
+    StreamImage_t xImage;             /*!< The image to infer. */
+    StreamImage_t xFullResolution;    /*!< The image the results apply to, e.g. to display them. */
+} StreamFrame_t;
+
+/**
+ * @brief Counters of a stream.
+ */
+typedef struct StreamStats
+{
+    uint32_t ulQueued;         /*!< Frames queued. */
+    uint32_t ulDropped;        /*!< Frames replaced by a newer one before inference. */
+    uint32_t ulInferred;       /*!< Frames inferred. */
+    uint32_t ulFpsX100;        /*!< Inferred frames per second, times 100, averaged over the last frames. */
+    uint32_t ulLastLatency;    /*!< Milliseconds from ready to inferred of the last frame. */
+    uint32_t ulAverageLatency; /*!< Average of the latencies. */
+    uint32_t ulMaxLatency;     /*!< Largest latency. */
+} StreamStats_t;
+
+/**
+ * @brief A stream. The fields are private to stream_scheduler.c.
+ */
+typedef struct StreamQueue
+{
+    StreamFrame_t xFrames[ streamschedulerQUEUE_LENGTH ];
+    uint32_t ulHead;             /*!< Oldest frame. */
+    uint32_t ulCount;            /*!< Frames queued. */
+    uint32_t ulLastDoneTime;     /*!< When the last frame was inferred. */
+    uint32_t ulIntervalX16;      /*!< Moving average of the time between inferred frames, in 1/16 ms. */
+    uint64_t ullTotalLatency;    /*!< Sum of the latencies. */
+    StreamStats_t xStats;        /*!< The counters, without the averages. */
+} StreamQueue_t;
+
+/**
+ * @brief A scheduler. The fields are private to stream_scheduler.c.
+ */
+typedef struct StreamScheduler
+{
+    StreamQueue_t xStreams[ streamschedulerMAX_STREAMS ];
+    uint32_t ulStreams; /*!< Number of streams. */
+    uint32_t ulNext;    /*!< First stream to look at for the next frame. */
+} StreamScheduler_t;
+
+/**
+ * @brief Start a scheduler without frames.
+ *
+ * @param[out] pxScheduler The scheduler.
+ * @param[in] ulStreams Number of streams, at most streamschedulerMAX_STREAMS.
+ */
+void vStreamSchedulerInit( StreamScheduler_t * pxScheduler,
+                           uint32_t ulStreams );
+
+/**
+ * @brief Queue a frame of a stream, replacing the oldest frame of the stream
+ * if its queue is full.
+ *
+ * @param[in, out] pxScheduler The scheduler.
+ * @param[in] pxFrame The frame.
+ *
+ * @return false if the stream does not exist.
+ */
+bool xStreamSchedulerPush( StreamScheduler_t * pxScheduler,
+                           const StreamFrame_t * pxFrame );
+
+/**
+ * @brief Take the next frame to infer: the oldest frame of the next stream,
+ * in turn, that has any.
+ *
+ * @param[in, out] pxScheduler The scheduler.
+ * @param[out] pxFrame The frame.
+ *
+ * @return false if no stream has a frame.
+ */
+bool xStreamSchedulerPop( StreamScheduler_t * pxScheduler,
+                          StreamFrame_t * pxFrame );
+
+/**
+ * @brief Record the end of the inference of a frame.
+ *
+ * @param[in, out] pxScheduler The scheduler.
+ * @param[in] pxFrame The frame, as taken from the scheduler.
+ * @param[in] ulTime The time, in milliseconds, on the clock of ulReadyTime.
+ */
+void vStreamSchedulerDone( StreamScheduler_t * pxScheduler,
+                           const StreamFrame_t * pxFrame,
+                           uint32_t ulTime );
+
+/**
+ * @brief Get the counters of a stream.
+ *
+ * @param[in] pxScheduler The scheduler.
+ * @param[in] ulStream The stream.
+ * @param[out] pxStats The counters.
+ *
+ * @return false if the stream does not exist.
+ */
+bool xStreamSchedulerGetStats( const StreamScheduler_t * pxScheduler,
+                               uint32_t ulStream,
+                               StreamStats_t * pxStats );
+
+#endif /* STREAM_SCHEDULER_H */
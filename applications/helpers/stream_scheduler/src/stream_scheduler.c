@@ -0,0 +1,152 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+
+#include "stream_scheduler.h"
+
+/*-----------------------------------------------------------*/
+
+void vStreamSchedulerInit( StreamScheduler_t * pxScheduler,
+                           uint32_t ulStreams )
+{
+    *pxScheduler = ( StreamScheduler_t ) { 0 };
+
+    pxScheduler->ulStreams = ( ulStreams < streamschedulerMAX_STREAMS ) ? ulStreams : streamschedulerMAX_STREAMS;
+}
+
+/*-----------------------------------------------------------*/
+
+bool xStreamSchedulerPush( StreamScheduler_t * pxScheduler,
+                           const StreamFrame_t * pxFrame )
+{
+    StreamQueue_t * pxQueue;
+
+    if( pxFrame->ulStream >= pxScheduler->ulStreams )
+    {
+        return false;
+    }
+
+    pxQueue = &pxScheduler->xStreams[ pxFrame->ulStream ];
+
+    if( pxQueue->ulCount == streamschedulerQUEUE_LENGTH )
+    {
+        /* The oldest frame makes room for the new one. */
+        pxQueue->ulHead = ( pxQueue->ulHead + 1U ) % streamschedulerQUEUE_LENGTH;
+        pxQueue->ulCount--;
+        pxQueue->xStats.ulDropped++;
+    }
+
+    pxQueue->xFrames[ ( pxQueue->ulHead + pxQueue->ulCount ) % streamschedulerQUEUE_LENGTH ] = *pxFrame;
+    pxQueue->ulCount++;
+    pxQueue->xStats.ulQueued++;
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+bool xStreamSchedulerPop( StreamScheduler_t * pxScheduler,
+                          StreamFrame_t * pxFrame )
+{
+    StreamQueue_t * pxQueue;
+    uint32_t ulStream;
+    uint32_t i;
+
+    for( i = 0; i < pxScheduler->ulStreams; i++ )
+    {
+        ulStream = ( pxScheduler->ulNext + i ) % pxScheduler->ulStreams;
+        pxQueue = &pxScheduler->xStreams[ ulStream ];
+
+        if( pxQueue->ulCount > 0U )
+        {
+            *pxFrame = pxQueue->xFrames[ pxQueue->ulHead ];
+            pxQueue->ulHead = ( pxQueue->ulHead + 1U ) % streamschedulerQUEUE_LENGTH;
+            pxQueue->ulCount--;
+
+            /* The other streams go first next time. */
+            pxScheduler->ulNext = ( ulStream + 1U ) % pxScheduler->ulStreams;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*-----------------------------------------------------------*/
+
+void vStreamSchedulerDone( StreamScheduler_t * pxScheduler,
+                           const StreamFrame_t * pxFrame,
+                           uint32_t ulTime )
+{
+    StreamQueue_t * pxQueue;
+    uint32_t ulLatency;
+    uint32_t ulInterval;
+
+    if( pxFrame->ulStream >= pxScheduler->ulStreams )
+    {
+        return;
+    }
+
+    pxQueue = &pxScheduler->xStreams[ pxFrame->ulStream ];
+    ulLatency = ulTime - pxFrame->ulReadyTime;
+
+    if( pxQueue->xStats.ulInferred > 0U )
+    {
+        ulInterval = ulTime - pxQueue->ulLastDoneTime;
+
+        /* Average over about the last 8 frames. */
+        if( pxQueue->ulIntervalX16 == 0U )
+        {
+            pxQueue->ulIntervalX16 = ulInterval * 16U;
+        }
+        else
+        {
+            pxQueue->ulIntervalX16 = pxQueue->ulIntervalX16 - ( pxQueue->ulIntervalX16 / 8U ) + ( ulInterval * 2U );
+        }
+    }
+
+    pxQueue->ulLastDoneTime = ulTime;
+    pxQueue->ullTotalLatency += ulLatency;
+    pxQueue->xStats.ulInferred++;
+    pxQueue->xStats.ulLastLatency = ulLatency;
+
+    if( ulLatency > pxQueue->xStats.ulMaxLatency )
+    {
+        pxQueue->xStats.ulMaxLatency = ulLatency;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+bool xStreamSchedulerGetStats( const StreamScheduler_t * pxScheduler,
+                               uint32_t ulStream,
+                               StreamStats_t * pxStats )
+{
+    const StreamQueue_t * pxQueue;
+
+    if( ulStream >= pxScheduler->ulStreams )
+    {
+        return false;
+    }
+
+    pxQueue = &pxScheduler->xStreams[ ulStream ];
+    *pxStats = pxQueue->xStats;
+    pxStats->ulFpsX100 = 0U;
+    pxStats->ulAverageLatency = 0U;
+
+    if( pxQueue->ulIntervalX16 > 0U )
+    {
+        pxStats->ulFpsX100 = ( 100U * 1000U * 16U ) / pxQueue->ulIntervalX16;
+    }
+
+    if( pxQueue->xStats.ulInferred > 0U )
+    {
+        pxStats->ulAverageLatency = ( uint32_t ) ( pxQueue->ullTotalLatency / pxQueue->xStats.ulInferred );
+    }
+
+    return true;
+}
@@ -0,0 +1,215 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "stream_scheduler.h"
+}
+
+static StreamFrame_t frame( uint32_t stream,
+                            uint32_t id,
+                            uint32_t readyTime = 0U )
+{
+    StreamFrame_t streamFrame = {};
+
+    streamFrame.ulStream = stream;
+    streamFrame.ulFrameId = id;
+    streamFrame.ulReadyTime = readyTime;
+    streamFrame.xImage.ulAddress = 0x1000U * ( id + 1U );
+
+    return streamFrame;
+}
+
+class TestStreamScheduler : public ::testing::Test
+{
+public:
+    TestStreamScheduler()
+    {
+        vStreamSchedulerInit( &scheduler, 3 );
+    }
+
+    StreamStats_t stats( uint32_t stream )
+    {
+        StreamStats_t streamStats;
+
+        EXPECT_TRUE( xStreamSchedulerGetStats( &scheduler, stream, &streamStats ) );
+
+        return streamStats;
+    }
+
+    std::vector<uint32_t> popStreams()
+    {
+        std::vector<uint32_t> streams;
+        StreamFrame_t next;
+
+        while( xStreamSchedulerPop( &scheduler, &next ) )
+        {
+            streams.push_back( next.ulStream );
+        }
+
+        return streams;
+    }
+
+    StreamScheduler_t scheduler;
+};
+
+TEST_F( TestStreamScheduler, nothing_is_popped_without_frames )
+{
+    StreamFrame_t next;
+
+    EXPECT_FALSE( xStreamSchedulerPop( &scheduler, &next ) );
+}
+
+TEST_F( TestStreamScheduler, frames_of_unknown_streams_are_rejected )
+{
+    StreamFrame_t unknown = frame( 3, 0 );
+    StreamStats_t streamStats;
+
+    EXPECT_FALSE( xStreamSchedulerPush( &scheduler, &unknown ) );
+    EXPECT_FALSE( xStreamSchedulerGetStats( &scheduler, 3, &streamStats ) );
+    EXPECT_TRUE( popStreams().empty() );
+}
+
+TEST_F( TestStreamScheduler, the_number_of_streams_is_capped )
+{
+    StreamFrame_t last = frame( streamschedulerMAX_STREAMS - 1U, 0 );
+    StreamFrame_t beyond = frame( streamschedulerMAX_STREAMS, 0 );
+
+    vStreamSchedulerInit( &scheduler, streamschedulerMAX_STREAMS + 1U );
+
+    EXPECT_TRUE( xStreamSchedulerPush( &scheduler, &last ) );
+    EXPECT_FALSE( xStreamSchedulerPush( &scheduler, &beyond ) );
+}
+
+TEST_F( TestStreamScheduler, a_stream_is_served_in_order )
+{
+    StreamFrame_t next;
+
+    for( uint32_t id = 0; id < streamschedulerQUEUE_LENGTH; id++ )
+    {
+        StreamFrame_t queued = frame( 1, id );
+        ASSERT_TRUE( xStreamSchedulerPush( &scheduler, &queued ) );
+    }
+
+    for( uint32_t id = 0; id < streamschedulerQUEUE_LENGTH; id++ )
+    {
+        ASSERT_TRUE( xStreamSchedulerPop( &scheduler, &next ) );
+        EXPECT_EQ( next.ulStream, 1U );
+        EXPECT_EQ( next.ulFrameId, id );
+        EXPECT_EQ( next.xImage.ulAddress, 0x1000U * ( id + 1U ) );
+    }
+
+    EXPECT_FALSE( xStreamSchedulerPop( &scheduler, &next ) );
+}
+
+TEST_F( TestStreamScheduler, a_full_queue_drops_its_oldest_frame )
+{
+    StreamFrame_t next;
+
+    for( uint32_t id = 0; id < streamschedulerQUEUE_LENGTH + 3U; id++ )
+    {
+        StreamFrame_t queued = frame( 0, id );
+        ASSERT_TRUE( xStreamSchedulerPush( &scheduler, &queued ) );
+    }
+
+    ASSERT_TRUE( xStreamSchedulerPop( &scheduler, &next ) );
+    EXPECT_EQ( next.ulFrameId, 3U );
+    EXPECT_EQ( stats( 0 ).ulQueued, streamschedulerQUEUE_LENGTH + 3U );
+    EXPECT_EQ( stats( 0 ).ulDropped, 3U );
+
+    /* The other streams are not affected. */
+    EXPECT_EQ( stats( 1 ).ulDropped, 0U );
+}
+
+TEST_F( TestStreamScheduler, streams_take_turns )
+{
+    /* Stream 0 produces three times as many frames as stream 2. */
+    for( uint32_t id = 0; id < 2; id++ )
+    {
+        StreamFrame_t fast = frame( 0, id );
+        StreamFrame_t slow = frame( 2, id );
+
+        ASSERT_TRUE( xStreamSchedulerPush( &scheduler, &fast ) );
+        ASSERT_TRUE( xStreamSchedulerPush( &scheduler, &slow ) );
+    }
+
+    EXPECT_EQ( popStreams(), ( std::vector<uint32_t> { 0, 2, 0, 2 } ) );
+}
+
+TEST_F( TestStreamScheduler, a_busy_stream_does_not_starve_the_others )
+{
+    std::vector<uint32_t> served( 3, 0U );
+    StreamFrame_t next;
+
+    /* Stream 0 always has a frame, the others one every third round. */
+    for( uint32_t round = 0; round < 300; round++ )
+    {
+        StreamFrame_t busy = frame( 0, round );
+        ASSERT_TRUE( xStreamSchedulerPush( &scheduler, &busy ) );
+
+        if( ( round % 3U ) == 0U )
+        {
+            StreamFrame_t quiet1 = frame( 1, round );
+            StreamFrame_t quiet2 = frame( 2, round );
+
+            ASSERT_TRUE( xStreamSchedulerPush( &scheduler, &quiet1 ) );
+            ASSERT_TRUE( xStreamSchedulerPush( &scheduler, &quiet2 ) );
+        }
+
+        ASSERT_TRUE( xStreamSchedulerPop( &scheduler, &next ) );
+        served[ next.ulStream ]++;
+    }
+
+    /* The quiet streams get every frame they produce. */
+    EXPECT_EQ( served[ 1 ] + stats( 1 ).ulDropped + scheduler.xStreams[ 1 ].ulCount, 100U );
+    EXPECT_EQ( stats( 1 ).ulDropped, 0U );
+    EXPECT_EQ( stats( 2 ).ulDropped, 0U );
+    EXPECT_GE( served[ 0 ], 100U );
+}
+
+TEST_F( TestStreamScheduler, latencies_are_measured_per_stream )
+{
+    StreamFrame_t first = frame( 0, 0, 100 );
+    StreamFrame_t second = frame( 0, 1, 150 );
+    StreamFrame_t other = frame( 1, 0, 100 );
+
+    vStreamSchedulerDone( &scheduler, &first, 140 );
+    vStreamSchedulerDone( &scheduler, &second, 170 );
+    vStreamSchedulerDone( &scheduler, &other, 400 );
+
+    EXPECT_EQ( stats( 0 ).ulInferred, 2U );
+    EXPECT_EQ( stats( 0 ).ulLastLatency, 20U );
+    EXPECT_EQ( stats( 0 ).ulMaxLatency, 40U );
+    EXPECT_EQ( stats( 0 ).ulAverageLatency, 30U );
+    EXPECT_EQ( stats( 1 ).ulAverageLatency, 300U );
+}
+
+TEST_F( TestStreamScheduler, the_frame_rate_follows_the_inferred_frames )
+{
+    uint32_t time = 0xFFFFFF00U;
+
+    /* 25 fps, across the wrap of the clock. */
+    for( uint32_t id = 0; id < 20; id++, time += 40U )
+    {
+        StreamFrame_t inferred = frame( 2, id, time - 10U );
+        vStreamSchedulerDone( &scheduler, &inferred, time );
+    }
+
+    EXPECT_EQ( stats( 2 ).ulFpsX100, 2500U );
+    EXPECT_EQ( stats( 2 ).ulMaxLatency, 10U );
+
+    /* Slows down to 10 fps. */
+    for( uint32_t id = 20; id < 60; id++, time += 100U )
+    {
+        StreamFrame_t inferred = frame( 2, id, time );
+        vStreamSchedulerDone( &scheduler, &inferred, time );
+    }
+
+    EXPECT_NEAR( stats( 2 ).ulFpsX100, 1000U, 10U );
+    EXPECT_EQ( stats( 0 ).ulFpsX100, 0U );
+}
@@ -63,7 +63,7 @@
  *
  * <b>Possible values:</b> Any unsigned 32 integer. <br>
  */
-#define otaconfigFILE_REQUEST_WAIT_MS           100000U /* TODO */
+#define otaconfigFILE_REQUEST_WAIT_MS           10000U
 
 /**
  * @brief The maximum allowed length of the thing name used by the OTA agent.
@@ -82,18 +82,28 @@
  * @brief The maximum number of data blocks requested from OTA streaming
  * service.
  *
- * @note This configuration parameter is sent with data requests and represents
- * the maximum number of data blocks the service will send in response. The
- * maximum limit for this must be calculated from the maximum data response
- * limit (128 KB from service) divided by the block size. For example if block
- * size is set as 1 KB then the maximum number of data blocks that we can
- * request is 128/1 = 128 blocks. Configure this parameter to this maximum
- * limit or lower based on how many data blocks response is expected for each
- * data requests.
+ * @note The OTA orchestrator keeps this many blocks requested at any time, as
+ * a sliding window over the file. A larger window hides more of the broker
+ * round trip per block at the cost of one OTA data buffer per block. The
+ * total must stay below the maximum data response limit (128 KB from
+ * service) divided by the block size.
  *
- * <b>Possible values:</b> Any unsigned 32 integer value greater than 0. <br>
+ * <b>Possible values:</b> Any unsigned 32 integer value from 1 to 32. <br>
  */
-#define otaconfigMAX_NUM_BLOCKS_REQUEST         1U /* TODO */
+#define otaconfigMAX_NUM_BLOCKS_REQUEST         4U
+
+/**
+ * @brief Encoding of the file blocks streamed by the AWS IoT MQTT file
+ * streams service.
+ *
+ * @note With DATA_TYPE_CBOR each block is a raw CBOR byte string and is
+ * copied once, straight from the MQTT network buffer into an OTA data
+ * buffer. With DATA_TYPE_JSON each block is base64 text, about a third
+ * larger on the wire, and must be base64 decoded.
+ *
+ * <b>Possible values:</b> DATA_TYPE_CBOR or DATA_TYPE_JSON. <br>
+ */
+#define otaconfigSTREAM_DATA_TYPE               DATA_TYPE_CBOR
 
 /**
  * @brief The maximum number of requests allowed to send without a response
@@ -122,11 +132,86 @@
  * @brief The number of data buffers reserved by the OTA agent.
  *
  * @note This configurations parameter sets the maximum number of static data
- * buffers used by the OTA agent for job and file data blocks received.
+ * buffers used by the OTA agent for job and file data blocks received. It
+ * must hold a full download window of blocks plus a control message.
+ *
+ * <b>Possible values:</b> Any unsigned 32 integer. <br>
+ */
+#define otaconfigMAX_NUM_OTA_DATA_BUFFERS       ( otaconfigMAX_NUM_BLOCKS_REQUEST + 1U )
+
+/**
+ * @brief Number of file blocks written between two checkpoints of the
+ * download progress.
+ *
+ * @note With otaconfigRESUME_AFTER_REBOOT set to '1', the received blocks,
+ * file ID, job ID and image hash state are saved to PSA protected storage
+ * every this many blocks and when the MQTT connection drops, so a download
+ * interrupted by a reboot resumes from the checkpoint rather than from
+ * block 0. Set to 0 to only save a checkpoint when the connection drops.
  *
  * <b>Possible values:</b> Any unsigned 32 integer. <br>
  */
-#define otaconfigMAX_NUM_OTA_DATA_BUFFERS       otaconfigMAX_NUM_BLOCKS_REQUEST + 1 /* TODO */
+#define otaconfigCHECKPOINT_INTERVAL_BLOCKS     16U
+
+/**
+ * @brief PSA protected storage UID of the download checkpoint.
+ *
+ * <b>Possible values:</b> Any non-zero UID not used by the application. <br>
+ */
+#define otaconfigCHECKPOINT_STORAGE_UID         ( 0x4F544143UL )
+
+/**
+ * @brief Flag to resume a download from the checkpoint saved before a reboot.
+ *
+ * @note The TF-M firmware update service erases the staging area when an
+ * image is opened for writing after a reset, so the blocks written before
+ * the reboot are lost and the download must restart from block 0. Set this
+ * to '1' only with a firmware update service that keeps the staging area.
+ * With '0', nothing is written to protected storage. Downloads interrupted
+ * by a disconnection always resume from the progress held in RAM.
+ *
+ * <b>Possible values:</b> 0 or 1. <br>
+ */
+#define otaconfigRESUME_AFTER_REBOOT            0
+
+/**
+ * @brief Flash sector size of the staging area the image is written to.
+ *
+ * @note File blocks are combined into buffers of this size, so the image is
+ * written to flash one whole sector at a time, whatever the block size.
+ *
+ * <b>Possible values:</b> Any power of two up to 16384. <br>
+ */
+#define otaconfigFLASH_WRITE_SECTOR_SIZE        4096U
+
+/**
+ * @brief Number of sector buffers used to write the image to flash.
+ *
+ * @note A buffer is filled with received blocks while the others are being
+ * written by the flash writer task.
+ *
+ * <b>Possible values:</b> Any unsigned 32 integer from 2. <br>
+ */
+#define otaconfigFLASH_WRITE_BUFFERS            2U
+
+/**
+ * @brief Address and size of the memory mapped running image that delta
+ * payloads are applied to.
+ *
+ * @note Compressed payloads created by tools/scripts/create_ota_payload.py are
+ * always accepted. Delta payloads are only accepted when these are defined,
+ * and when the SHA-256 of the running image matches the one in the payload.
+ *
+ * The non-secure image runs from its primary slot, whose address and size
+ * are passed by the build when the ML model image has a slot of its own.
+ *
+ * <b>Possible values:</b> Undefined, or the address and size of the image in
+ * the active slot. <br>
+ */
+#if defined( NS_IMAGE_LOAD_ADDRESS ) && defined( NS_IMAGE_PRIMARY_SLOT_SIZE )
+    #define otaconfigDELTA_SOURCE_ADDRESS    ( NS_IMAGE_LOAD_ADDRESS )
+    #define otaconfigDELTA_SOURCE_SIZE       ( NS_IMAGE_PRIMARY_SLOT_SIZE )
+#endif
 
 /**
  * @brief Flag to enable booting into updates that have an identical or lower
@@ -206,6 +206,11 @@ void * mbedtls_platform_calloc( size_t nmemb,
                                 size_t size );
 void mbedtls_platform_free( void * ptr );
 
+/* Size of the arena reserved for the mbed TLS allocations, see
+ * mbedtls_freertos_port.h. 0 to allocate from the FreeRTOS heap. The arena
+ * is opt-in and has not been run on a target yet. */
+#define MBEDTLS_FREERTOS_ARENA_SIZE    0
+
 /**
  * \def MBEDTLS_PLATFORM_NO_STD_FUNCTIONS
  *
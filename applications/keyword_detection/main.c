@@ -109,6 +109,23 @@ void vOtaNotActiveHook( void )
     #endif
 }
 
+bool xOtaModelImageWriteHook( uint32_t ulOffset,
+                              const uint8_t * pucData,
+                              size_t xLength )
+{
+    return xMlModelImageWrite( ulOffset, pucData, xLength );
+}
+
+void vOtaModelImageUpdatedHook( bool xUpdated )
+{
+    vMlModelImageUpdated( xUpdated );
+}
+
+bool xOtaApplicationIdleHook( void )
+{
+    return xMlTaskInferenceIdle();
+}
+
 void vAssertCalled( const char * pcFile,
                     unsigned long ulLine )
 {
@@ -157,6 +174,8 @@ uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
 
 int main( void )
 {
+    vBootTimelineMark( BootTimelineMain );
+
     bsp_serial_init();
 
     xLoggingTaskInitialize( appCONFIG_LOGGING_TASK_STACK_SIZE,
@@ -226,6 +245,8 @@ int main( void )
         }
     }
 
+    vBootTimelineMark( BootTimelineProvisioned );
+
     /* The next initializations are done as a part of the main */
     /* function as these resources are shared between tasks */
     /* and it is not guranteed that the task which initialise */
@@ -283,6 +304,8 @@ int main( void )
         vStartMlTask();
     #endif
 
+    vBootTimelineMark( BootTimelineSchedulerStart );
+
     vTaskStartScheduler();
 
     /* If all is well, the scheduler will now be running, and the following
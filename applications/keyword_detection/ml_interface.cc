@@ -36,6 +36,7 @@ extern "C" {
 #include <cstdint>
 #include <cstdio>
 #include <functional>
+#include <new>
 #include <stdbool.h>
 #include <string>
 #include <utility>
@@ -62,12 +63,6 @@ extern "C" {
  */
 #define mqttexampleTOPIC    democonfigCLIENT_IDENTIFIER "/ml/inference"
 
-/**
- * @brief The MQTT agent manages the MQTT contexts.  This set the handle to the
- * context used by this demo.
- */
-extern MQTTAgentContext_t xGlobalMqttAgentContext;
-
 /**
  * @brief The maximum time for which application waits for an MQTT operation to be complete.
  * This involves receiving an acknowledgment for broker for SUBSCRIBE, UNSUBSCRIBE and non
@@ -80,6 +75,27 @@ extern MQTTAgentContext_t xGlobalMqttAgentContext;
  */
 #define appMAX_UINT32         ( 0xffffffff )
 
+/**
+ * @brief An updated model can be loaded into the execution area and used
+ * without a reboot. With VSI audio, the audio driver keeps the processing
+ * loop running, so the model is only reloaded on boot.
+ */
+#if defined( NS_ML_MODEL_IMAGE_EXECUTION_ADDRESS ) && !defined( AUDIO_VSI )
+    #define mlMODEL_RELOAD_SUPPORTED    1
+#else
+    #define mlMODEL_RELOAD_SUPPORTED    0
+#endif
+
+/**
+ * @brief Maximum time a model update waits for the inference to stop.
+ */
+#define mlMODEL_LOCK_TIMEOUT_MS    ( 1000U )
+
+/**
+ * @brief Held by the ML task while it runs inference on the model.
+ */
+static SemaphoreHandle_t xModelMutex = NULL;
+
 extern EventGroupHandle_t xSystemEvents;
 extern QueueHandle_t xMlMqttQueue;
 
@@ -178,7 +194,7 @@ static void prvMqttSendMessage( const char * message )
     xCommandParams.pCmdCompleteCallbackContext = ( MQTTAgentCommandContext_t * ) &xCommandContext;
 
     LogInfo( ( "Attempting to publish (%s) to the MQTT topic %s.\r\n", message, mqttexampleTOPIC ) );
-    mqttStatus = MQTTAgent_Publish( &xGlobalMqttAgentContext,
+    mqttStatus = MQTTAgent_Publish( pxGetMqttAgentContext( eMqttAgentConnectionControl ),
                                     &publishInfo,
                                     &xCommandParams );
 
@@ -247,6 +263,14 @@ void vMlTaskInferenceStop()
 
 void vStartMlTask( void )
 {
+    xModelMutex = xSemaphoreCreateMutex();
+
+    if( xModelMutex == NULL )
+    {
+        LogError( ( "Failed to create the ML model mutex\r\n" ) );
+        return;
+    }
+
     if( xTaskCreate( vMlTask,
                      "ML_TASK",
                      appCONFIG_ML_TASK_STACK_SIZE,
@@ -565,7 +589,7 @@ static ml_processing_state_t prvConvertInferenceResult( const std::string &label
     return ML_UNKNOWN;
 }
 
-static void prvProcessAudio( ApplicationContext &ctx )
+static bool prvProcessAudio( ApplicationContext &ctx )
 {
     /* Constants */
     constexpr int minTensorDims =
@@ -579,7 +603,7 @@ static void prvProcessAudio( ApplicationContext &ctx )
     if( !model.IsInited() )
     {
         LogError( ( "Model is not initialised! Terminating processing.\n" ) );
-        return;
+        return false;
     }
 
     const auto frameLength = ctx.Get<int>( "frameLength" );         /* 640 */
@@ -593,12 +617,12 @@ static void prvProcessAudio( ApplicationContext &ctx )
     if( !inputTensor->dims )
     {
         LogError( ( "Invalid input tensor dims\n" ) );
-        return;
+        return false;
     }
     else if( inputTensor->dims->size < minTensorDims )
     {
         LogError( ( "Input tensor dimension should be >= %d\n", minTensorDims ) );
-        return;
+        return false;
     }
 
     TfLiteIntArray * inputShape = model.GetInputShape( 0 );
@@ -643,7 +667,7 @@ static void prvProcessAudio( ApplicationContext &ctx )
     if( !mfccFeatureCalc )
     {
         LogError( ( "No feature calculator available" ) );
-        return;
+        return false;
     }
 
     #ifdef AUDIO_VSI
@@ -696,9 +720,11 @@ static void prvProcessAudio( ApplicationContext &ctx )
                 if( !model.RunInference() )
                 {
                     LogError( ( "Failed to run inference" ) );
-                    return;
+                    return false;
                 }
 
+                vBootTimelineMark( BootTimelineFirstInference );
+
                 std::vector<ClassificationResult> classificationResult;
                 auto &classifier = ctx.Get<KwsClassifier &>( "classifier" );
                 classifier.GetClassificationResults(
@@ -719,7 +745,7 @@ static void prvProcessAudio( ApplicationContext &ctx )
                 if( prvPresentInferenceResult( result ) != true )
                 {
                     LogError( ( "Failed to present inference result" ) );
-                    return;
+                    return false;
                 }
 
                 first_iteration = false;
@@ -745,7 +771,7 @@ static void prvProcessAudio( ApplicationContext &ctx )
             if( ( pusSampleDataPtr == NULL ) || ( ulSampleDataSize < preProcess.m_audioDataWindowSize ) )
             {
                 LogError( ( "No audio sample data available for inference.\r\n" ) );
-                return;
+                return false;
             }
 
             /* Creating a sliding window through the whole audio clip. */
@@ -769,19 +795,21 @@ static void prvProcessAudio( ApplicationContext &ctx )
                 if( !preProcess.DoPreProcess( inferenceWindow, audioDataSlider.Index() ) )
                 {
                     LogError( ( "Pre-processing failed." ) );
-                    return;
+                    return false;
                 }
 
                 if( !model.RunInference() )
                 {
                     LogError( ( "Inference failed." ) );
-                    return;
+                    return false;
                 }
 
+                vBootTimelineMark( BootTimelineFirstInference );
+
                 if( !postProcess.DoPostProcess() )
                 {
                     LogError( ( "Post-processing failed." ) );
-                    return;
+                    return false;
                 }
 
                 auto result = kws::KwsResult( singleInfResult,
@@ -801,17 +829,29 @@ static void prvProcessAudio( ApplicationContext &ctx )
                 if( prvPresentInferenceResult( result ) != true )
                 {
                     LogError( ( "Failed to present inference result" ) );
-                    return;
+                    return false;
                 }
             } /* while (audioDataSlider.HasNext()) */
         #endif /* AUDIO_VSI */
 
+        /* The model may be updated over the air while inference is stopped. */
+        ( void ) xSemaphoreGive( xModelMutex );
+
         EventBits_t flags = xEventGroupWaitBits( xSystemEvents, ( EventBits_t ) EVENT_MASK_ML_START, pdTRUE, pdFAIL, portMAX_DELAY );
 
+        ( void ) xSemaphoreTake( xModelMutex, portMAX_DELAY );
+
         if( flags & EVENT_MASK_ML_START )
         {
             LogInfo( ( "Restarting audio processing %u\r\n", flags ) );
         }
+
+        #if ( mlMODEL_RELOAD_SUPPORTED == 1 )
+            if( xEventGroupGetBits( xSystemEvents ) & EVENT_MASK_ML_MODEL_RELOAD )
+            {
+                return true;
+            }
+        #endif
     } /* while (true) */
 }
 
@@ -1029,14 +1069,26 @@ static int prvMlInterfaceInit()
     static arm::app::MicroNetKwsModel model; /* Model wrapper object. */
 
     #ifdef USE_ETHOS
+        static bool xNpuInitialised = false;
+
         /* Initialize the ethos U55 */
-        if( prvArmNpuInit() != 0 )
+        if( !xNpuInitialised && ( prvArmNpuInit() != 0 ) )
         {
             LogError( ( "Failed to arm npu\n" ) );
             return -1;
         }
+
+        xNpuInitialised = true;
+        vBootTimelineMark( BootTimelineNpuReady );
     #endif /* USE_ETHOS */
 
+    if( model.IsInited() )
+    {
+        /* Reloading an updated model, start from a fresh wrapper. */
+        model.~MicroNetKwsModel();
+        new( &model ) arm::app::MicroNetKwsModel();
+    }
+
     /* Load the model. */
     if( !model.Init( ::arm::app::tensorArena,
                      sizeof( ::arm::app::tensorArena ),
@@ -1057,10 +1109,13 @@ static int prvMlInterfaceInit()
     caseContext.Set<arm::app::KwsClassifier &>( "classifier", classifier );
 
     static std::vector<std::string> labels;
+    labels.clear();
     GetLabelsVector( labels );
 
     caseContext.Set<const std::vector<std::string> &>( "labels", labels );
 
+    vBootTimelineMark( BootTimelineModelReady );
+
     LogInfo( ( "*** ML interface initialised\r\n" ) );
     return 0;
 }
@@ -1075,6 +1130,13 @@ void vMlTask( void * arg )
         memcpy( reinterpret_cast<void *>( NS_ML_MODEL_IMAGE_EXECUTION_ADDRESS ), reinterpret_cast<void *>( NS_ML_MODEL_IMAGE_LOAD_ADDRESS ), static_cast<size_t>( NS_ML_MODEL_IMAGE_SIZE ) );
     #endif
 
+    /* Initialise the NPU and the model while the network comes up instead
+     * of once inference is started. */
+    ( void ) xSemaphoreTake( xModelMutex, portMAX_DELAY );
+    ( void ) xEventGroupClearBits( xSystemEvents, ( EventBits_t ) EVENT_MASK_ML_MODEL_RELOAD );
+    bool xModelInitialised = ( prvMlInterfaceInit() >= 0 );
+    ( void ) xSemaphoreGive( xModelMutex );
+
     EventBits_t flags = xEventGroupWaitBits( xSystemEvents, ( EventBits_t ) EVENT_MASK_ML_START, pdTRUE, pdFAIL, portMAX_DELAY );
 
     if( flags & EVENT_MASK_ML_START )
@@ -1082,13 +1144,95 @@ void vMlTask( void * arg )
         LogInfo( ( "Initial start of audio processing\r\n" ) );
     }
 
-    if( prvMlInterfaceInit() < 0 )
+    ( void ) xSemaphoreTake( xModelMutex, portMAX_DELAY );
+
+    while( true )
     {
-        LogError( ( "prvMlInterfaceInit failed\r\n" ) );
-        return;
+        /* Load the model again if it was updated since it was initialised. */
+        if( !xModelInitialised || ( ( xEventGroupGetBits( xSystemEvents ) & EVENT_MASK_ML_MODEL_RELOAD ) != 0 ) )
+        {
+            /* The execution area holds the model to load from now on. */
+            ( void ) xEventGroupClearBits( xSystemEvents, ( EventBits_t ) EVENT_MASK_ML_MODEL_RELOAD );
+
+            if( prvMlInterfaceInit() < 0 )
+            {
+                LogError( ( "prvMlInterfaceInit failed\r\n" ) );
+                break;
+            }
+        }
+
+        xModelInitialised = false;
+
+        if( !prvProcessAudio( caseContext ) )
+        {
+            break;
+        }
+
+        LogInfo( ( "Reloading the updated ML model\r\n" ) );
+    }
+
+    ( void ) xSemaphoreGive( xModelMutex );
+}
+
+bool xMlModelImageWrite( uint32_t ulOffset,
+                         const uint8_t * pucData,
+                         size_t xLength )
+{
+    bool xWritten = false;
+
+    #if ( mlMODEL_RELOAD_SUPPORTED == 1 )
+        if( ( xModelMutex != NULL ) &&
+            ( ulOffset <= NS_ML_MODEL_IMAGE_SIZE ) &&
+            ( xLength <= ( NS_ML_MODEL_IMAGE_SIZE - ulOffset ) ) &&
+            ( xSemaphoreTake( xModelMutex, pdMS_TO_TICKS( mlMODEL_LOCK_TIMEOUT_MS ) ) == pdTRUE ) )
+        {
+            memcpy( reinterpret_cast<uint8_t *>( NS_ML_MODEL_IMAGE_EXECUTION_ADDRESS ) + ulOffset, pucData, xLength );
+            ( void ) xSemaphoreGive( xModelMutex );
+            xWritten = true;
+        }
+    #else /* mlMODEL_RELOAD_SUPPORTED == 1 */
+        ( void ) ulOffset;
+        ( void ) pucData;
+        ( void ) xLength;
+    #endif /* mlMODEL_RELOAD_SUPPORTED == 1 */
+
+    return xWritten;
+}
+
+void vMlModelImageUpdated( bool xUpdated )
+{
+    #if ( mlMODEL_RELOAD_SUPPORTED == 1 )
+        if( xUpdated )
+        {
+            LogInfo( ( "Updated ML model loaded, it is used from the next inference start\r\n" ) );
+            ( void ) xEventGroupSetBits( xSystemEvents, ( EventBits_t ) EVENT_MASK_ML_MODEL_RELOAD );
+        }
+        else if( xSemaphoreTake( xModelMutex, portMAX_DELAY ) == pdTRUE )
+        {
+            /* The running model is still the one in flash. */
+            LogInfo( ( "Restoring the running ML model\r\n" ) );
+            memcpy( reinterpret_cast<void *>( NS_ML_MODEL_IMAGE_EXECUTION_ADDRESS ), reinterpret_cast<void *>( NS_ML_MODEL_IMAGE_LOAD_ADDRESS ), static_cast<size_t>( NS_ML_MODEL_IMAGE_SIZE ) );
+            ( void ) xSemaphoreGive( xModelMutex );
+        }
+    #else /* mlMODEL_RELOAD_SUPPORTED == 1 */
+        ( void ) xUpdated;
+    #endif /* mlMODEL_RELOAD_SUPPORTED == 1 */
+}
+
+bool xMlTaskInferenceIdle( void )
+{
+    bool xIdle = false;
+
+    if( ( xModelMutex != NULL ) &&
+        ( ( xEventGroupGetBits( xSystemEvents ) & EVENT_MASK_ML_START ) == 0 ) &&
+        ( xSemaphoreTake( xModelMutex, 0 ) == pdTRUE ) )
+    {
+        /* The ML task only releases the model between two runs. */
+        ( void ) xSemaphoreGive( xModelMutex );
+        xIdle = true;
     }
 
-    prvProcessAudio( caseContext );
+    return xIdle;
 }
 
 void vMlMqttTask( void * arg )
@@ -6,6 +6,7 @@
 #ifndef ML_INTERFACE_H
     #define ML_INTERFACE_H
 
+    #include <stdbool.h>
     #include <stddef.h>
     #include <stdint.h>
 
@@ -66,6 +67,34 @@
  */
     void vMlMqttTask( void * arg );
 
+/**
+ * @brief Load part of an updated model image into the model execution area,
+ *        while inference is stopped.
+ * @param ulOffset Offset of the data within the signed model image.
+ * @param pucData Data to load.
+ * @param xLength Length of the data.
+ * @return true if the data was loaded, false if the model cannot be
+ *         reloaded at runtime.
+ */
+    bool xMlModelImageWrite( uint32_t ulOffset,
+                             const uint8_t * pucData,
+                             size_t xLength );
+
+/**
+ * @brief Reload the model once inference restarts, or restore the running
+ *        model after a failed update.
+ * @param xUpdated true if the whole updated model image has been loaded and
+ *        verified.
+ */
+    void vMlModelImageUpdated( bool xUpdated );
+
+/**
+ * @brief Check whether inference is idle, so the device can be rebooted
+ *        without interrupting it.
+ * @return true if no inference runs or is about to start.
+ */
+    bool xMlTaskInferenceIdle( void );
+
 /**
  * @brief Create ML task.
  */
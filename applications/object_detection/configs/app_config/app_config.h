@@ -29,6 +29,19 @@
 #define appCONFIG_MQTT_AGENT_TASK_STACK_SIZE        ( 4096 )
 #define appCONFIG_MQTT_AGENT_TASK_PRIORITY          ( tskIDLE_PRIORITY + 2 )
 
+/**
+ * @brief Number of MQTT connections run by the MQTT agent.
+ *
+ * Connection 0 carries control traffic and keeps the demo client identifier.
+ * A second connection carries bulk traffic such as OTA file blocks and
+ * connects as "<client identifier>-1", which the device policy must
+ * allow. The bulk agent task runs at a lower priority than the control agent.
+ *
+ * At most 2: the control connection and one bulk connection.
+ */
+#define appCONFIG_MQTT_AGENT_NUM_CONNECTIONS        ( 1U )
+#define appCONFIG_MQTT_AGENT_BULK_TASK_PRIORITY     ( tskIDLE_PRIORITY + 1 )
+
 
 #define appCONFIG_ML_TASK_STACK_SIZE                ( 8192 )
 #define appCONFIG_ML_TASK_PRIORITY                  ( tskIDLE_PRIORITY + 1 )
@@ -57,14 +57,14 @@ extern uint32_t SystemCoreClock;
 #define configTOTAL_HEAP_SIZE               0
 #define configAPPLICATION_ALLOCATED_HEAP    0
 
-#define configENABLE_MVE                    0
 #define configENABLE_FPU                    1
 #define configENABLE_MPU                    0
 #define configENABLE_TRUSTZONE              0
 #define configRUN_FREERTOS_SECURE_ONLY      0
 
-/* The target specific macros `configTICK_RATE_HZ`, `pdMS_TO_TICKS` and
- * `TICKS_TO_pdMS` are defined in `FreeRTOSConfig_target.h`. */
+/* The target specific macros `configTICK_RATE_HZ`, `pdMS_TO_TICKS`,
+ * `TICKS_TO_pdMS` and the default of `configENABLE_MVE` are defined in
+ * `FreeRTOSConfig_target.h`. */
 #include "FreeRTOSConfig_target.h"
 
 #define configMINIMAL_STACK_SIZE                   4096
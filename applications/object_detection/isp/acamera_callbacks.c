@@ -12,32 +12,45 @@
 pvFrameReadyHandler_t pvDownscaledFrameReady = NULL;
 pvFrameReadyHandler_t pvFullResolutionFrameReady = NULL;
 
-static uint32_t ulCoherentDmaAllocatedSize = 0;
+static uint32_t ulCoherentDmaAllocatedSize[ FIRMWARE_CONTEXT_NUMBER ];
 typedef uint8_t ucFrameBuffer_t[ isp_configMAX_OUTPUT_FRAME_SIZE ];
-static ucFrameBuffer_t * xFullResolutionBuffer = ( ucFrameBuffer_t * ) isp_configFULL_RESOLUTION_BUFFER_BASE;
-static ucFrameBuffer_t * xDownscaledBuffer = ( ucFrameBuffer_t * ) isp_configDOWNSCALED_BUFFER_BASE;
+typedef ucFrameBuffer_t xFrameRing_t[ isp_configMAX_BUFFERED_FRAMES ];
+static xFrameRing_t * xFullResolutionBuffer = ( xFrameRing_t * ) isp_configFULL_RESOLUTION_BUFFER_BASE;
+static xFrameRing_t * xDownscaledBuffer = ( xFrameRing_t * ) isp_configDOWNSCALED_BUFFER_BASE;
+static uint32_t ulFullResolutionFrameCounter[ FIRMWARE_CONTEXT_NUMBER ];
+static uint32_t ulDownscaledFrameCounter[ FIRMWARE_CONTEXT_NUMBER ];
 
 /* This is for FVP stream optimisation */
 #include "FreeRTOS.h"
 #include "semphr.h"
 extern SemaphoreHandle_t xStreamSemaphore;
 
-/* Only 1 allocation is supported, it is for the Temper Frame */
+/* Each context allocates from its own slice of the coherent DMA memory, only
+ * the Temper Frame is allocated. */
 void * pvCallbackDmaAllocCoherent( uint32_t ulContextId,
                                    uint64_t ullSize,
                                    uint64_t * ullDmaAddress )
 {
     uint32_t ulAddress;
 
-    if( ulCoherentDmaAllocatedSize + ullSize > isp_configCOHERENT_DMA_MEMORY_SIZE )
+    if( ulContextId >= FIRMWARE_CONTEXT_NUMBER )
+    {
+        LOG( LOG_ERR, "DMA alloc: Unknown context %u", ulContextId );
+        *ullDmaAddress = 0;
+        return NULL;
+    }
+
+    if( ulCoherentDmaAllocatedSize[ ulContextId ] + ullSize > isp_configCOHERENT_DMA_CONTEXT_SIZE )
     {
         LOG( LOG_ERR, "Not enough memory" );
         *ullDmaAddress = 0;
         return NULL;
     }
 
-    ulAddress = isp_configCOHERENT_DMA_MEMORY_BASE + ulCoherentDmaAllocatedSize;
-    ulCoherentDmaAllocatedSize += ullSize;
+    ulAddress = isp_configCOHERENT_DMA_MEMORY_BASE +
+                ( ulContextId * isp_configCOHERENT_DMA_CONTEXT_SIZE ) +
+                ulCoherentDmaAllocatedSize[ ulContextId ];
+    ulCoherentDmaAllocatedSize[ ulContextId ] += ullSize;
 
     *ullDmaAddress = ulAddress;
 
@@ -45,24 +58,32 @@ void * pvCallbackDmaAllocCoherent( uint32_t ulContextId,
     *ullDmaAddress -= ISP_SOC_DMA_BUS_OFFSET;
 
     LOG( LOG_DEBUG,
-         "DMA alloc: 0x%x, Memory left: 0x%x",
+         "DMA alloc: 0x%x, Memory left in context %u: 0x%x",
          ( uint32_t ) ullSize,
-         isp_configCOHERENT_DMA_MEMORY_SIZE - ulCoherentDmaAllocatedSize );
+         ulContextId,
+         isp_configCOHERENT_DMA_CONTEXT_SIZE - ulCoherentDmaAllocatedSize[ ulContextId ] );
     return ( void * ) ulAddress;
 }
 
-/* Only 1 allocation is supported, it is for the Temper Frame */
+/* Freeing releases the whole slice of the context, which only holds the
+ * Temper Frame. */
 void vCallbackDmaFreeCoherent( uint32_t ulContextId,
                                uint64_t ullSize,
                                void * pvVirtualAddress,
                                uint64_t ullDmaAddress )
 {
-    if( ( ( uint32_t ) pvVirtualAddress ) != isp_configCOHERENT_DMA_MEMORY_SIZE )
+    if( ulContextId >= FIRMWARE_CONTEXT_NUMBER )
     {
-        LOG( LOG_ERR, "DMA free: Trying to fr  ee unknown memory: 0x%x", ( uint32_t ) pvVirtualAddress );
+        LOG( LOG_ERR, "DMA free: Unknown context %u", ulContextId );
+        return;
     }
 
-    ulCoherentDmaAllocatedSize = 0;
+    if( ( ( uint32_t ) pvVirtualAddress ) != ( isp_configCOHERENT_DMA_MEMORY_BASE + ( ulContextId * isp_configCOHERENT_DMA_CONTEXT_SIZE ) ) )
+    {
+        LOG( LOG_ERR, "DMA free: Trying to free unknown memory: 0x%x", ( uint32_t ) pvVirtualAddress );
+    }
+
+    ulCoherentDmaAllocatedSize[ ulContextId ] = 0;
 }
 
 int32_t lCallbackStreamGetFrame( uint32_t ulContextId,
@@ -70,7 +91,6 @@ int32_t lCallbackStreamGetFrame( uint32_t ulContextId,
                                  aframe_t * pxAFrames,
                                  uint64_t ullNumPlanes )
 {
-    static uint32_t ulDownscaledFrameCounter = 0;
     uint32_t ulAddress = 0;
 
     while( ullNumPlanes > 1 )
@@ -80,16 +100,19 @@ int32_t lCallbackStreamGetFrame( uint32_t ulContextId,
         pxAFrames[ ullNumPlanes ].status = dma_buf_purge;
     }
 
-    if( xType == ACAMERA_STREAM_FR )
+    if( ulContextId >= FIRMWARE_CONTEXT_NUMBER )
+    {
+        /* No buffer ring */
+    }
+    else if( xType == ACAMERA_STREAM_FR )
     {
-        static uint32_t ulFullResolutionFrameCounter = 0;
-        ulAddress = ( uint32_t ) xFullResolutionBuffer[ ulFullResolutionFrameCounter % isp_configMAX_BUFFERED_FRAMES ];
-        ulFullResolutionFrameCounter++;
+        ulAddress = ( uint32_t ) xFullResolutionBuffer[ ulContextId ][ ulFullResolutionFrameCounter[ ulContextId ] % isp_configMAX_BUFFERED_FRAMES ];
+        ulFullResolutionFrameCounter[ ulContextId ]++;
     }
     else if( xType == ACAMERA_STREAM_DS1 )
     {
-        ulAddress = ( uint32_t ) xDownscaledBuffer[ ulDownscaledFrameCounter % isp_configMAX_BUFFERED_FRAMES ];
-        ulDownscaledFrameCounter++;
+        ulAddress = ( uint32_t ) xDownscaledBuffer[ ulContextId ][ ulDownscaledFrameCounter[ ulContextId ] % isp_configMAX_BUFFERED_FRAMES ];
+        ulDownscaledFrameCounter[ ulContextId ]++;
     }
 
     pxAFrames[ 0 ].address = ulAddress;
@@ -186,7 +209,7 @@ int32_t lCallbackStreamPutFrame( uint32_t ulContextId,
 
         if( pvDownscaledFrameReady != NULL )
         {
-            pvDownscaledFrameReady( ulAddress, ulWidth, ulHeight, ulFormat, pxAFrames->frame_id );
+            pvDownscaledFrameReady( ulContextId, ulAddress, ulWidth, ulHeight, ulFormat, pxAFrames->frame_id );
         }
 
         /* Let stream thread start the next frame */
@@ -205,7 +228,7 @@ int32_t lCallbackStreamPutFrame( uint32_t ulContextId,
 
         if( pvFullResolutionFrameReady != NULL )
         {
-            pvFullResolutionFrameReady( ulAddress, ulWidth, ulHeight, ulFormat, pxAFrames->frame_id );
+            pvFullResolutionFrameReady( ulContextId, ulAddress, ulWidth, ulHeight, ulFormat, pxAFrames->frame_id );
         }
     }
 
@@ -28,23 +28,24 @@
 
 #define ENABLE_TPG_AT_START    0
 
-static acamera_settings xACameraSettings[ FIRMWARE_CONTEXT_NUMBER ] =
+/* Every context streams the FVP sensor with the same settings */
+static const acamera_settings xACameraContextSettings =
 {
-    {
-        .sensor_init = fvp_sensor_init,
-        .sensor_deinit = fvp_sensor_deinit,
-        .get_calibrations = get_calibrations_dummy,
-        .lens_init = NULL,
-        .lens_deinit = NULL,
-        .isp_base = 0x0,
-        .hw_isp_addr = ISP_SOC_START_ADDR,
-        .callback_dma_alloc_coherent = pvCallbackDmaAllocCoherent,
-        .callback_dma_free_coherent = vCallbackDmaFreeCoherent,
-        .callback_stream_get_frame = lCallbackStreamGetFrame,
-        .callback_stream_put_frame = lCallbackStreamPutFrame,
-    },
+    .sensor_init = fvp_sensor_init,
+    .sensor_deinit = fvp_sensor_deinit,
+    .get_calibrations = get_calibrations_dummy,
+    .lens_init = NULL,
+    .lens_deinit = NULL,
+    .isp_base = 0x0,
+    .hw_isp_addr = ISP_SOC_START_ADDR,
+    .callback_dma_alloc_coherent = pvCallbackDmaAllocCoherent,
+    .callback_dma_free_coherent = vCallbackDmaFreeCoherent,
+    .callback_stream_get_frame = lCallbackStreamGetFrame,
+    .callback_stream_put_frame = lCallbackStreamPutFrame,
 };
 
+static acamera_settings xACameraSettings[ FIRMWARE_CONTEXT_NUMBER ];
+
 /* This example will run the infinite loop to process the firmware events. */
 /* This variable also can be changed outside to stop the processing. */
 volatile int32_t lACameraMainLoopActive = 1;
@@ -129,6 +130,11 @@ static int prvIspInitialConfig()
     /* the structure acamera_settings must be filled properly. */
     /* the total number of initialized context must not exceed FIRMWARE_CONTEXT_NUMBER */
     /* all contexts are numerated from 0 till ctx_number - 1 */
+    for( ulContextNumber = 0; ulContextNumber < FIRMWARE_CONTEXT_NUMBER; ulContextNumber++ )
+    {
+        xACameraSettings[ ulContextNumber ] = xACameraContextSettings;
+    }
+
     lResult = acamera_init( xACameraSettings, FIRMWARE_CONTEXT_NUMBER );
 
     if( lResult != 0 )
@@ -263,6 +269,8 @@ static void prvACameraThread( void * pvParameters )
 {
     static uint32_t ulDoInitialSetup = 1;
     uint32_t ulReturnCode = 0;
+    uint32_t ulContextNumber;
+    uint32_t ulPreviousContextNumber = 0;
 
     if( prvIspInitialConfig() )
     {
@@ -294,12 +302,21 @@ static void prvACameraThread( void * pvParameters )
         if( ulDoInitialSetup )
         {
             ulDoInitialSetup = 0;
-            application_command( TIMAGE, IMAGE_RESIZE_TYPE_ID, SCALER_DS, COMMAND_SET, &ulReturnCode );
-            application_command( TIMAGE, IMAGE_RESIZE_WIDTH_ID, 192, COMMAND_SET, &ulReturnCode );
-            application_command( TIMAGE, IMAGE_RESIZE_HEIGHT_ID, 192, COMMAND_SET, &ulReturnCode );
-            application_command( TIMAGE, IMAGE_RESIZE_ENABLE_ID, RUN, COMMAND_SET, &ulReturnCode );
+            application_command( TGENERAL, ACTIVE_CONTEXT, 0, COMMAND_GET, &ulPreviousContextNumber );
+
+            for( ulContextNumber = 0; ulContextNumber < FIRMWARE_CONTEXT_NUMBER; ulContextNumber++ )
+            {
+                application_command( TGENERAL, ACTIVE_CONTEXT, ulContextNumber, COMMAND_SET, &ulReturnCode );
+
+                application_command( TIMAGE, IMAGE_RESIZE_TYPE_ID, SCALER_DS, COMMAND_SET, &ulReturnCode );
+                application_command( TIMAGE, IMAGE_RESIZE_WIDTH_ID, 192, COMMAND_SET, &ulReturnCode );
+                application_command( TIMAGE, IMAGE_RESIZE_HEIGHT_ID, 192, COMMAND_SET, &ulReturnCode );
+                application_command( TIMAGE, IMAGE_RESIZE_ENABLE_ID, RUN, COMMAND_SET, &ulReturnCode );
+
+                application_command( TSENSOR, SENSOR_STREAMING, ON, COMMAND_SET, &ulReturnCode );
+            }
 
-            application_command( TSENSOR, SENSOR_STREAMING, ON, COMMAND_SET, &ulReturnCode );
+            application_command( TGENERAL, ACTIVE_CONTEXT, ulPreviousContextNumber, COMMAND_SET, &ulReturnCode );
         }
 
         taskYIELD();
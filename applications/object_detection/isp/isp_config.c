@@ -7,17 +7,26 @@
 
 #include "device_cfg.h"
 #include "device_definition.h"
+#include "hdlcd_display.h"
 #include "hdlcd_drv.h"
 #include "hdlcd_helper.h"
+#include "inference_scheduler.h"
 #include "stdint.h"
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "arm_2d.h"
 
 #include "isp_config.h"
 
 #include "ml_interface.h"
+#include "mve_kernels.h"
+#include "overlay.h"
+#include "stream_scheduler.h"
+
+#include "semphr.h"
+#include "task.h"
 
 /*
  * Semihosting is a mechanism that enables code running on an ARM target
@@ -35,29 +44,39 @@
 #endif
 
 #define isp_configHIGHLIGHTED_FRAME_WIDTH       2
-
-#define isp_configMAX_BORDER_WIDTH              320
-#define isp_configMAX_BORDER_HEIGHT             240
-#define isp_configMAX_BORDER_BYTES_PER_PIXEL    4
-#define isp_configBORDER_BUFFER_SIZE            ( isp_configMAX_BORDER_WIDTH * isp_configMAX_BORDER_HEIGHT * isp_configMAX_BORDER_BYTES_PER_PIXEL )
+#define isp_configLABEL_SCALE                   2
 
 #define isp_configMAX_DETECT_RESULTS            10
 
-/* This buffer is used by FP unit, align it to prevent unaligned FP faults */
-static uint8_t ucBorderTileBuffer[ isp_configBORDER_BUFFER_SIZE ] __ALIGNED( 4 );
-static volatile uint8_t ucFlag = 0;
+/* Longest wait for the display to flip the previous frame, a few refreshes */
+#define isp_configDISPLAY_FLIP_TIMEOUT_MS       100
 
-static struct LastFrame xLastFrame =
-{
-    .ulDisplayed     = 0,
-    .ulInferred      = 0,
-    .xFullResolution =
-    {
-        .ulMode      = HDLCD_PIXEL_FORMAT_NOT_SUPPORTED,
-        .ulWidth     = 0,
-        .ulHeight    = 0
-    }
-};
+#if FIRMWARE_CONTEXT_NUMBER > streamschedulerMAX_STREAMS
+    #error "Every ISP context needs a stream of the scheduler"
+#endif
+
+/* A downscaled buffer must not be reused by the ISP while its frame waits in
+ * the queue or is inferred: the queued frames, the inferred one and the one
+ * being written all need a buffer of the ring. */
+#if ( streamschedulerQUEUE_LENGTH + 2 ) > isp_configMAX_BUFFERED_FRAMES
+    #error "The buffer rings are too short for the queues of the scheduler"
+#endif
+
+static struct hdlcd_display xDisplay;
+
+/* Last full resolution frame of every context */
+static struct FullResolutionImage xLastFullResolution[ FIRMWARE_CONTEXT_NUMBER ];
+
+/* Downscaled frames of every context waiting for inference */
+static StreamScheduler_t xScheduler;
+static SemaphoreHandle_t xFramesQueued = NULL;
+static StaticSemaphore_t xFramesQueuedBuffer;
+
+/* What to infer of the frames of every context, and the detections of the
+ * last inferred frame, reused for the skipped frames */
+static InferenceScheduler_t xInferenceSchedulers[ FIRMWARE_CONTEXT_NUMBER ];
+static struct DetectRegion_t xLastResults[ FIRMWARE_CONTEXT_NUMBER ][ isp_configMAX_DETECT_RESULTS ];
+static uint32_t ulLastResultsCount[ FIRMWARE_CONTEXT_NUMBER ];
 
 struct arm_2d_tile_t xRootTile =
 {
@@ -72,26 +91,31 @@ struct arm_2d_tile_t xRootTile =
 #define isp_configMAX_INFER_FRAME_HEIGHT    192
 #define isp_configMAX_INFER_FRAME_SIZE      ( isp_configMAX_INFER_FRAME_WIDTH * isp_configMAX_INFER_FRAME_HEIGHT )
 uint8_t ucGrayBuffer[ isp_configMAX_INFER_FRAME_SIZE ] __attribute__( ( aligned( 32 ) ) );
-static void prvHdlcdShow( uint32_t address,
-                          uint32_t width,
-                          uint32_t height,
-                          uint32_t mode );
-static void prvHandleFullResolutionFrame( uint32_t ulAddress,
+static uint8_t ucRegionBuffer[ isp_configMAX_INFER_FRAME_SIZE ] __attribute__( ( aligned( 32 ) ) );
+static void prvHdlcdShow( uint32_t ulWidth,
+                          uint32_t ulHeight,
+                          uint32_t ulMode );
+static void prvHandleFullResolutionFrame( uint32_t ulContextId,
+                                          uint32_t ulAddress,
                                           uint32_t ulWidth,
                                           uint32_t ulHeight,
                                           uint32_t ulMode,
                                           uint32_t ulFrameId );
-static void prvHandleDownscaledFrame( uint32_t ulAddress,
+static void prvHandleDownscaledFrame( uint32_t ulContextId,
+                                      uint32_t ulAddress,
                                       uint32_t ulWidth,
                                       uint32_t ulHeight,
                                       uint32_t ulMode,
                                       uint32_t ulFrameId );
-static void prvDrawFrameOnTile( struct arm_2d_tile_t * pxDest,
-                                struct arm_2d_region_t * pxFrame,
-                                enum hdlcd_pixel_format eFormat );
+static void prvInferFrame( const StreamFrame_t * pxFrame );
+static uint32_t prvDetect( const StreamFrame_t * pxFrame,
+                           struct DetectRegion_t * pxResults );
+static void prvLogStreamStats( uint32_t ulStream );
+static void prvFillRectOnTile( void * pvTile,
+                               const OverlayRect_t * pxRect,
+                               uint32_t ulColour );
 void vHDLCDHandler( void );
 void vEnableHdlcdIrq( void );
-void vDisableHdlcdIrq( void );
 
 extern int32_t lIspInit();
 extern void arm_2d_init( void );
@@ -133,6 +157,31 @@ void vStartISPDemo()
         }
     }
 
+    hdlcd_display_init( &xDisplay,
+                        &HDLCD_DEV,
+                        ( void * ) isp_configDISPLAY_BUFFER_BASE,
+                        ( void * ) ( isp_configDISPLAY_BUFFER_BASE + isp_configMAX_OUTPUT_FRAME_SIZE ),
+                        isp_configMAX_OUTPUT_FRAME_SIZE );
+    vEnableHdlcdIrq();
+
+    const InferenceSchedulerConfig_t xInferenceConfig =
+    {
+        .ulCellThreshold    = isp_configINFER_CELL_THRESHOLD,
+        .ulSceneThreshold   = isp_configINFER_SCENE_THRESHOLD,
+        .ulMaxSkippedFrames = isp_configINFER_MAX_SKIPPED_FRAMES,
+        .ulFullPeriod       = isp_configINFER_FULL_PERIOD,
+        .ulRegionMargin     = isp_configINFER_REGION_MARGIN,
+        .ulMaxRegionPercent = isp_configINFER_MAX_REGION_PERCENT
+    };
+
+    for( uint32_t i = 0; i < FIRMWARE_CONTEXT_NUMBER; i++ )
+    {
+        vInferenceSchedulerInit( &xInferenceSchedulers[ i ], &xInferenceConfig );
+    }
+
+    vStreamSchedulerInit( &xScheduler, FIRMWARE_CONTEXT_NUMBER );
+    xFramesQueued = xSemaphoreCreateBinaryStatic( &xFramesQueuedBuffer );
+
     LogInfo( ( "Starting ISP init!\r\n" ) );
 
     lIspInit();
@@ -164,6 +213,13 @@ void vRgbToGrayscale( const uint8_t * pucSrcImage,
                       const size_t xDstImageSize,
                       enum hdlcd_pixel_format eFormat )
 {
+    /* The frames of the ISP are RGB565, which has a vector kernel. */
+    if( eFormat == HDLCD_PIXEL_FORMAT_RGB565 )
+    {
+        vMveRgb565ToGray( ( const uint16_t * ) pucSrcImage, pucDstImage, xDstImageSize );
+        return;
+    }
+
     const struct hdlcd_pixel_cfg_t * const pxPixelConfig = HDLCD_MODES[ eFormat ].pixel_cfg;
     const uint32_t ulRedOffset = pxPixelConfig->red.offset;
     const uint32_t ulGreenOffset = pxPixelConfig->green.offset;
@@ -226,42 +282,44 @@ void vGrayscaleToRgb( const uint8_t * pucSrcImage,
     LogInfo( ( "srcGray: %02u-%02u\r\n", ulGrayMinimum, ulGrayMaximum ) );
 }
 
-static void prvHandleFullResolutionFrame( uint32_t ulAddress,
+static void prvHandleFullResolutionFrame( uint32_t ulContextId,
+                                          uint32_t ulAddress,
                                           uint32_t ulWidth,
                                           uint32_t ulHeight,
                                           uint32_t ulMode,
                                           uint32_t ulFrameId )
 {
-    /* If the previous full frame wasn't inferred yet, skip this frame */
-    if( xLastFrame.ulDisplayed == xLastFrame.ulInferred )
+    ( void ) ulFrameId;
+
+    if( ulContextId >= FIRMWARE_CONTEXT_NUMBER )
     {
-        xLastFrame.ulDisplayed = ulFrameId;
-        xLastFrame.xFullResolution.ulMode = ulMode;
-        xLastFrame.xFullResolution.ulWidth = ulWidth;
-        xLastFrame.xFullResolution.ulHeight = ulHeight;
-        prvHdlcdShow( ulAddress, ulWidth, ulHeight, ulMode );
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    xLastFullResolution[ ulContextId ].ulAddress = ulAddress;
+    xLastFullResolution[ ulContextId ].ulMode = ulMode;
+    xLastFullResolution[ ulContextId ].ulWidth = ulWidth;
+    xLastFullResolution[ ulContextId ].ulHeight = ulHeight;
+    taskEXIT_CRITICAL();
+
+    if( ulContextId == isp_configDISPLAYED_CONTEXT )
+    {
+        prvHdlcdShow( ulWidth, ulHeight, ulMode );
     }
 }
 
-static void prvHandleDownscaledFrame( uint32_t ulAddress,
+static void prvHandleDownscaledFrame( uint32_t ulContextId,
+                                      uint32_t ulAddress,
                                       uint32_t ulWidth,
                                       uint32_t ulHeight,
                                       uint32_t ulMode,
                                       uint32_t ulFrameId )
 {
-    xLastFrame.ulInferred = ulFrameId;
-    uint32_t i = 0UL;
-    uint32_t ulResultsCount = 0UL;
-    struct DetectRegion_t xResults[ isp_configMAX_DETECT_RESULTS ];
-    float xUpscaleWidth = xLastFrame.xFullResolution.ulWidth / ulWidth;
-    float xUpscaleHeight = xLastFrame.xFullResolution.ulHeight / ulHeight;
+    StreamFrame_t xFrame;
 
-    static struct arm_2d_region_t xFrameRegion = { 0 };
-    enum hdlcd_pixel_format ePixelFormat = HDLCD_PIXEL_FORMAT_RGB565;
-
-    if( ePixelFormat == HDLCD_PIXEL_FORMAT_NOT_SUPPORTED )
+    if( ulContextId >= FIRMWARE_CONTEXT_NUMBER )
     {
-        LogError( ( "Unsupported pixel format: 0x%x\r\n", xLastFrame.xFullResolution.ulMode ) );
         return;
     }
 
@@ -271,189 +329,304 @@ static void prvHandleDownscaledFrame( uint32_t ulAddress,
         return;
     }
 
-    /* Note: mode Vs xLastFrame.xFullResolution.ulMode */
-    LogInfo( ( "Converting to Gray: 0x%x -> 0x%x\r\n", ulAddress, ( uint32_t ) ucGrayBuffer ) );
-    vRgbToGrayscale( ( uint8_t * ) ulAddress, ucGrayBuffer, ulWidth * ulHeight, HDLCD_PIXEL_FORMAT_RGB565 );
+    xFrame.ulStream = ulContextId;
+    xFrame.ulFrameId = ulFrameId;
+    xFrame.ulReadyTime = TICKS_TO_pdMS( xTaskGetTickCount() );
+    xFrame.xImage.ulAddress = ulAddress;
+    xFrame.xImage.ulWidth = ulWidth;
+    xFrame.xImage.ulHeight = ulHeight;
+    xFrame.xImage.ulFormat = ulMode;
+
+    /* The ML task infers the frame, the ISP goes on with the next one */
+    taskENTER_CRITICAL();
+    xFrame.xFullResolution.ulAddress = xLastFullResolution[ ulContextId ].ulAddress;
+    xFrame.xFullResolution.ulWidth = xLastFullResolution[ ulContextId ].ulWidth;
+    xFrame.xFullResolution.ulHeight = xLastFullResolution[ ulContextId ].ulHeight;
+    xFrame.xFullResolution.ulFormat = xLastFullResolution[ ulContextId ].ulMode;
+    ( void ) xStreamSchedulerPush( &xScheduler, &xFrame );
+    taskEXIT_CRITICAL();
+
+    ( void ) xSemaphoreGive( xFramesQueued );
+}
 
-    /*taskENTER_CRITICAL(); */
-    ulResultsCount = isp_configMAX_DETECT_RESULTS;
-    lMLRunInference( ucGrayBuffer, xResults, &ulResultsCount );
-    /*taskEXIT_CRITICAL(); */
+void vIspInferQueuedFrames( TickType_t xTimeout )
+{
+    StreamFrame_t xFrame;
+    BaseType_t xFound;
 
-    hdlcd_disable( &HDLCD_DEV );
+    if( ( xFramesQueued == NULL ) || ( xSemaphoreTake( xFramesQueued, xTimeout ) != pdTRUE ) )
+    {
+        return;
+    }
 
-    /* Draw frame according to selected region in the secondary buffer */
-    for( i = 0; i < ulResultsCount; i++ )
+    do
     {
-        xFrameRegion.tSize.iWidth = ( int ) xResults[ i ].ulW * xUpscaleWidth;
-        xFrameRegion.tSize.iHeight = ( int ) xResults[ i ].ulH * xUpscaleHeight;
-        xFrameRegion.tLocation.iX = ( int ) xResults[ i ].ulX * xUpscaleWidth;
-        xFrameRegion.tLocation.iY = ( int ) xResults[ i ].ulY * xUpscaleHeight;
+        taskENTER_CRITICAL();
+        xFound = xStreamSchedulerPop( &xScheduler, &xFrame ) ? pdTRUE : pdFALSE;
+        taskEXIT_CRITICAL();
 
-        if( xFrameRegion.tSize.iWidth < isp_configHIGHLIGHTED_FRAME_WIDTH * 3 )
+        if( xFound == pdTRUE )
         {
-            xFrameRegion.tSize.iWidth = isp_configHIGHLIGHTED_FRAME_WIDTH * 3;
-        }
+            prvInferFrame( &xFrame );
 
-        if( xFrameRegion.tSize.iHeight < isp_configHIGHLIGHTED_FRAME_WIDTH * 3 )
-        {
-            xFrameRegion.tSize.iHeight = isp_configHIGHLIGHTED_FRAME_WIDTH * 3;
+            taskENTER_CRITICAL();
+            vStreamSchedulerDone( &xScheduler, &xFrame, TICKS_TO_pdMS( xTaskGetTickCount() ) );
+            taskEXIT_CRITICAL();
+
+            prvLogStreamStats( xFrame.ulStream );
         }
+    } while( xFound == pdTRUE );
+}
+
+static void prvLogStreamStats( uint32_t ulStream )
+{
+    StreamStats_t xStats;
+    InferenceSchedulerStats_t xDecisions;
 
-        prvDrawFrameOnTile( &xRootTile, &xFrameRegion, ePixelFormat );
+    taskENTER_CRITICAL();
+    ( void ) xStreamSchedulerGetStats( &xScheduler, ulStream, &xStats );
+    taskEXIT_CRITICAL();
+
+    vInferenceSchedulerGetStats( &xInferenceSchedulers[ ulStream ], &xDecisions );
+
+    if( ( xStats.ulInferred % isp_configSTATS_LOG_PERIOD ) == 0 )
+    {
+        LogInfo( ( "Context %u: %u.%02u fps, latency %u ms (max %u ms), %u of %u frames dropped\r\n",
+                   ulStream,
+                   xStats.ulFpsX100 / 100,
+                   xStats.ulFpsX100 % 100,
+                   xStats.ulAverageLatency,
+                   xStats.ulMaxLatency,
+                   xStats.ulDropped,
+                   xStats.ulQueued ) );
+        LogInfo( ( "Context %u: %u frames inferred in full, %u in regions of %u%% of the frame, %u skipped\r\n",
+                   ulStream,
+                   xDecisions.ulFull,
+                   xDecisions.ulRegion,
+                   xDecisions.ulRegionPercent,
+                   xDecisions.ulSkipped ) );
     }
+}
 
-    hdlcd_enable( &HDLCD_DEV );
-    /* Wait until HDLCD is displayed at least once */
-    ucFlag = 0;
-    vEnableHdlcdIrq();
+/* Detects in the whole frame, in a region of it or reuses the last
+ * detections, depending on how much the frame changed */
+static uint32_t prvDetect( const StreamFrame_t * pxFrame,
+                           struct DetectRegion_t * pxResults )
+{
+    InferenceScheduler_t * pxInferenceScheduler = &xInferenceSchedulers[ pxFrame->ulStream ];
+    InferenceRect_t xDetections[ isp_configMAX_DETECT_RESULTS ];
+    InferenceRect_t xRegion;
+    InferenceDecision_t xDecision;
+    const uint8_t * pucInput = ucGrayBuffer;
+    uint32_t ulWidth = pxFrame->xImage.ulWidth;
+    uint32_t ulHeight = pxFrame->xImage.ulHeight;
+    uint32_t ulResultsCount;
+    uint32_t i;
+
+    xDecision = xInferenceSchedulerDecide( pxInferenceScheduler, ucGrayBuffer, ulWidth, ulHeight, &xRegion );
+
+    if( xDecision == eInferenceSkip )
+    {
+        ulResultsCount = ulLastResultsCount[ pxFrame->ulStream ];
+        memcpy( pxResults, xLastResults[ pxFrame->ulStream ], ulResultsCount * sizeof( struct DetectRegion_t ) );
+
+        return ulResultsCount;
+    }
 
-    while( ucFlag < 5 )
+    if( xDecision == eInferenceRegion )
     {
+        /* The model input has the size of the frame, the region is scaled
+         * up to it. */
+        vInferenceSchedulerScaleRegion( ucGrayBuffer, ulWidth, ulHeight, &xRegion, ucRegionBuffer );
+        pucInput = ucRegionBuffer;
     }
 
-    vDisableHdlcdIrq();
+    ulResultsCount = isp_configMAX_DETECT_RESULTS;
+    lMLRunInference( pucInput, pxResults, &ulResultsCount );
+
+    for( i = 0; i < ulResultsCount; i++ )
+    {
+        xDetections[ i ].ulX = pxResults[ i ].ulX;
+        xDetections[ i ].ulY = pxResults[ i ].ulY;
+        xDetections[ i ].ulWidth = pxResults[ i ].ulW;
+        xDetections[ i ].ulHeight = pxResults[ i ].ulH;
+
+        if( xDecision == eInferenceRegion )
+        {
+            vInferenceSchedulerRegionToFrame( ulWidth, ulHeight, &xRegion, &xDetections[ i ] );
+            pxResults[ i ].ulX = xDetections[ i ].ulX;
+            pxResults[ i ].ulY = xDetections[ i ].ulY;
+            pxResults[ i ].ulW = xDetections[ i ].ulWidth;
+            pxResults[ i ].ulH = xDetections[ i ].ulHeight;
+        }
+    }
+
+    vInferenceSchedulerSetDetections( pxInferenceScheduler, xDetections, ulResultsCount );
+
+    ulLastResultsCount[ pxFrame->ulStream ] = ulResultsCount;
+    memcpy( xLastResults[ pxFrame->ulStream ], pxResults, ulResultsCount * sizeof( struct DetectRegion_t ) );
+
+    return ulResultsCount;
 }
 
-static void prvHdlcdShow( uint32_t ulAddress,
-                          uint32_t ulWidth,
-                          uint32_t ulHeight,
-                          uint32_t ulMode )
+static void prvInferFrame( const StreamFrame_t * pxFrame )
 {
-    struct hdlcd_resolution_cfg_t xCustomResolutionConfig = { 0 };
+    uint32_t i = 0UL;
+    uint32_t ulResultsCount = 0UL;
+    struct DetectRegion_t xResults[ isp_configMAX_DETECT_RESULTS ];
+    OverlayBox_t xBoxes[ isp_configMAX_DETECT_RESULTS ];
+    OverlayCanvas_t xCanvas;
+    void * pvBackBuffer;
+    const StreamImage_t * pxFullResolution = &pxFrame->xFullResolution;
+    float xUpscaleWidth = pxFullResolution->ulWidth / pxFrame->xImage.ulWidth;
+    float xUpscaleHeight = pxFullResolution->ulHeight / pxFrame->xImage.ulHeight;
 
-    enum hdlcd_error_t eHdlcdErr = 0;
     enum hdlcd_pixel_format ePixelFormat = HDLCD_PIXEL_FORMAT_RGB565;
 
-    LogInfo( ( "Displaying image...\r\n" ) );
-
     if( ePixelFormat == HDLCD_PIXEL_FORMAT_NOT_SUPPORTED )
     {
-        LogError( ( "Unsupported pixel format: 0x%x\r\n", ulMode ) );
+        LogError( ( "Unsupported pixel format: 0x%x\r\n", pxFullResolution->ulFormat ) );
         return;
     }
 
-    hdlcd_disable( &HDLCD_DEV );
+    /* Note: mode Vs pxFullResolution->ulFormat */
+    LogInfo( ( "Converting to Gray: 0x%x -> 0x%x\r\n", pxFrame->xImage.ulAddress, ( uint32_t ) ucGrayBuffer ) );
+    vRgbToGrayscale( ( uint8_t * ) pxFrame->xImage.ulAddress,
+                     ucGrayBuffer,
+                     pxFrame->xImage.ulWidth * pxFrame->xImage.ulHeight,
+                     HDLCD_PIXEL_FORMAT_RGB565 );
 
-    /* Note: This only works, because FVP ignores all timing values */
-    xCustomResolutionConfig.v_data = ulHeight;
-    xCustomResolutionConfig.h_data = ulWidth;
-    hdlcd_set_custom_resolution( &HDLCD_DEV, &xCustomResolutionConfig );
+    ulResultsCount = prvDetect( pxFrame, xResults );
 
-    struct hdlcd_buffer_cfg_t xHdlcdBuffer =
+    /* Only one context is shown, the others are only inferred */
+    if( pxFrame->ulStream != isp_configDISPLAYED_CONTEXT )
     {
-        .base_address = ulAddress,
-        .line_length  = ulWidth * HDLCD_MODES[ ePixelFormat ].bytes_per_pixel,
-        .line_count   = ulHeight - 1,
-        .line_pitch   = ulWidth * HDLCD_MODES[ ePixelFormat ].bytes_per_pixel,
-        .pixel_format = HDLCD_MODES[ ePixelFormat ].pixel_format
-    };
+        return;
+    }
 
-    eHdlcdErr = hdlcd_buffer_config( &HDLCD_DEV, &xHdlcdBuffer );
+    /* Compose the full resolution frame and its detections in the back
+     * buffer, the display keeps showing the previous frame meanwhile. */
+    pvBackBuffer = hdlcd_display_acquire( &xDisplay, pdMS_TO_TICKS( isp_configDISPLAY_FLIP_TIMEOUT_MS ) );
 
-    if( eHdlcdErr != HDLCD_ERR_NONE )
+    if( ( pvBackBuffer == NULL ) || ( pxFullResolution->ulAddress == 0 ) )
     {
-        LogError( ( "HDLCD buffer config error! \r\n" ) );
-
-        while( 1 )
-        {
-        }
+        LogError( ( "No display buffer available!\r\n" ) );
+        return;
     }
 
-    eHdlcdErr = hdlcd_pixel_config( &HDLCD_DEV, HDLCD_MODES[ ePixelFormat ].pixel_cfg );
+    vMveCopy( pvBackBuffer,
+              ( const void * ) pxFullResolution->ulAddress,
+              pxFullResolution->ulWidth * pxFullResolution->ulHeight * HDLCD_MODES[ ePixelFormat ].bytes_per_pixel );
 
-    if( eHdlcdErr != HDLCD_ERR_NONE )
+    xRootTile.pwBuffer = ( uint32_t * ) pvBackBuffer;
+    xRootTile.tRegion.tSize.iWidth = pxFullResolution->ulWidth;
+    xRootTile.tRegion.tSize.iHeight = pxFullResolution->ulHeight;
+    xRootTile.tInfo.tColourInfo.chScheme = ulHdlcdToArm2dColorScheme( ePixelFormat );
+
+    /* Draw the borders of all the detected regions in the back buffer */
+    for( i = 0; i < ulResultsCount; i++ )
     {
-        LogError( ( "HDLCD pixel config error! \r\n" ) );
+        xBoxes[ i ].xRect.lWidth = ( int32_t ) ( xResults[ i ].ulW * xUpscaleWidth );
+        xBoxes[ i ].xRect.lHeight = ( int32_t ) ( xResults[ i ].ulH * xUpscaleHeight );
+        xBoxes[ i ].xRect.lX = ( int32_t ) ( xResults[ i ].ulX * xUpscaleWidth );
+        xBoxes[ i ].xRect.lY = ( int32_t ) ( xResults[ i ].ulY * xUpscaleHeight );
+        xBoxes[ i ].ulColour = HDLCD_MODES[ ePixelFormat ].default_highlight_color;
+        xBoxes[ i ].pcLabel = "face";
+        xBoxes[ i ].lScore = ( int32_t ) ( xResults[ i ].xScore * 100.0f + 0.5f );
+
+        if( xBoxes[ i ].xRect.lWidth < isp_configHIGHLIGHTED_FRAME_WIDTH * 3 )
+        {
+            xBoxes[ i ].xRect.lWidth = isp_configHIGHLIGHTED_FRAME_WIDTH * 3;
+        }
 
-        while( 1 )
+        if( xBoxes[ i ].xRect.lHeight < isp_configHIGHLIGHTED_FRAME_WIDTH * 3 )
         {
+            xBoxes[ i ].xRect.lHeight = isp_configHIGHLIGHTED_FRAME_WIDTH * 3;
         }
     }
 
-    xRootTile.pwBuffer = ( uint32_t * ) ulAddress;
-    xRootTile.tRegion.tSize.iWidth = ulWidth;
-    xRootTile.tRegion.tSize.iHeight = ulHeight;
-    xRootTile.tInfo.tColourInfo.chScheme = ulHdlcdToArm2dColorScheme( ePixelFormat );
+    xCanvas.pucPixels = ( uint8_t * ) pvBackBuffer;
+    xCanvas.ulWidth = pxFullResolution->ulWidth;
+    xCanvas.ulHeight = pxFullResolution->ulHeight;
+    xCanvas.ulBytesPerPixel = HDLCD_MODES[ ePixelFormat ].bytes_per_pixel;
+    xCanvas.ulPitch = xCanvas.ulWidth * xCanvas.ulBytesPerPixel;
+    xCanvas.xFillRect = prvFillRectOnTile;
+    xCanvas.pvFillContext = &xRootTile;
 
-    hdlcd_enable( &HDLCD_DEV );
+    vOverlayDrawBoxes( &xCanvas, xBoxes, ulResultsCount, isp_configHIGHLIGHTED_FRAME_WIDTH, isp_configLABEL_SCALE );
 
-    LogInfo( ( "Image displayed\r\n" ) );
+    /* Shown from the next refresh on, without waiting for it */
+    if( hdlcd_display_present( &xDisplay ) == false )
+    {
+        LogError( ( "Display frame dropped, the previous one is not shown yet!\r\n" ) );
+    }
 }
 
-static void prvDrawFrameOnTile( struct arm_2d_tile_t * pxDestination,
-                                struct arm_2d_region_t * pxFrame,
-                                enum hdlcd_pixel_format eFormat )
+static void prvHdlcdShow( uint32_t ulWidth,
+                          uint32_t ulHeight,
+                          uint32_t ulMode )
 {
-    static struct arm_2d_region_t xBlendRegion = { 0 };
-    static struct arm_2d_tile_t xBorderTile = { 0 };
-    uint_fast8_t xOpacity = 0xFF;
-
-    xBlendRegion.tSize.iWidth = ( pxFrame->tSize.iWidth - 2 * isp_configHIGHLIGHTED_FRAME_WIDTH );
-    xBlendRegion.tSize.iHeight = ( pxFrame->tSize.iHeight - 2 * isp_configHIGHLIGHTED_FRAME_WIDTH );
-    xBlendRegion.tLocation.iX = isp_configHIGHLIGHTED_FRAME_WIDTH;
-    xBlendRegion.tLocation.iY = isp_configHIGHLIGHTED_FRAME_WIDTH;
-
-    xBorderTile.tRegion.tSize.iWidth = pxFrame->tSize.iWidth;
-    xBorderTile.tRegion.tSize.iHeight = pxFrame->tSize.iHeight;
-    xBorderTile.tInfo.bIsRoot = true;
-    xBorderTile.tInfo.bHasEnforcedColour = true;
-    xBorderTile.tInfo.tColourInfo.chScheme = ulHdlcdToArm2dColorScheme( eFormat );
-    xBorderTile.pwBuffer = ( uint32_t * ) ucBorderTileBuffer;
+    enum hdlcd_pixel_format ePixelFormat = HDLCD_PIXEL_FORMAT_RGB565;
 
-    if( eFormat == HDLCD_PIXEL_FORMAT_RGB565 )
+    if( ePixelFormat == HDLCD_PIXEL_FORMAT_NOT_SUPPORTED )
     {
-        arm_2dp_rgb16_fill_colour(
-            NULL, &xBorderTile, &xBorderTile.tRegion, ( uint16_t ) HDLCD_MODES[ eFormat ].default_highlight_color );
-        arm_2dp_rgb16_fill_colour( NULL, &xBorderTile, &xBlendRegion, ( uint16_t ) HDLCD_MODES[ eFormat ].default_mask_color );
-        arm_2dp_rgb565_tile_copy_with_colour_keying_and_opacity(
-            NULL,
-            &xBorderTile,
-            pxDestination,
-            pxFrame,
-            xOpacity,
-            ( arm_2d_color_rgb565_t ) { .tValue = ( uint16_t ) HDLCD_MODES[ eFormat ].default_mask_color } );
+        LogError( ( "Unsupported pixel format: 0x%x\r\n", ulMode ) );
+        return;
     }
-    else
+
+    /* The HDLCD is only reprogrammed when the resolution changes */
+    if( hdlcd_display_configure( &xDisplay, ulWidth, ulHeight, ePixelFormat ) == false )
     {
-        arm_2dp_rgb32_fill_colour(
-            NULL, &xBorderTile, &xBorderTile.tRegion, HDLCD_MODES[ eFormat ].default_highlight_color );
-        arm_2dp_rgb32_fill_colour( NULL, &xBorderTile, &xBlendRegion, HDLCD_MODES[ eFormat ].default_mask_color );
-        arm_2dp_cccn888_tile_copy_with_colour_keying_and_opacity(
-            NULL,
-            &xBorderTile,
-            pxDestination,
-            pxFrame,
-            xOpacity,
-            ( arm_2d_color_cccn888_t ) { .tValue = HDLCD_MODES[ eFormat ].default_mask_color } );
+        LogError( ( "HDLCD config error! \r\n" ) );
+
+        while( 1 )
+        {
+        }
     }
 }
 
-void vHDLCDHandler( void )
+/* Fills the rectangles of the overlay with arm-2d */
+static void prvFillRectOnTile( void * pvTile,
+                               const OverlayRect_t * pxRect,
+                               uint32_t ulColour )
 {
-    /* Clear IRQ */
-    uint32_t ulIrqState = hdlcd_get_irq_state( &HDLCD_DEV );
-
-    hdlcd_clear_irq( &HDLCD_DEV, ulIrqState );
+    struct arm_2d_tile_t * pxTile = ( struct arm_2d_tile_t * ) pvTile;
+    struct arm_2d_region_t xRegion =
+    {
+        .tLocation   =
+        {
+            .iX      = pxRect->lX,
+            .iY      = pxRect->lY
+        },
+        .tSize       =
+        {
+            .iWidth  = pxRect->lWidth,
+            .iHeight = pxRect->lHeight
+        }
+    };
 
-    if( ulIrqState & INT_DMA_END_Msk )
+    if( pxTile->tInfo.tColourInfo.chScheme == ARM_2D_COLOUR_RGB565 )
+    {
+        arm_2dp_rgb16_fill_colour( NULL, pxTile, &xRegion, ( uint16_t ) ulColour );
+    }
+    else
     {
-        ucFlag++;
+        arm_2dp_rgb32_fill_colour( NULL, pxTile, &xRegion, ulColour );
     }
+}
+
+void vHDLCDHandler( void )
+{
+    /* Clears the IRQ and flips the display buffers at the end of a frame */
+    hdlcd_display_irq_handler( &xDisplay );
 
     __NVIC_ClearPendingIRQ( HDLCD_IRQn );
 }
 
 void vEnableHdlcdIrq( void )
 {
+    /* The HDLCD interrupt itself is enabled with the display configuration */
     NVIC_ClearPendingIRQ( HDLCD_IRQn );
     NVIC_SetVector( HDLCD_IRQn, ( uint32_t ) vHDLCDHandler );
     NVIC_EnableIRQ( HDLCD_IRQn );
-    hdlcd_enable_irq( &HDLCD_DEV, INT_DMA_END_Msk );
-}
-
-void vDisableHdlcdIrq( void )
-{
-    NVIC_DisableIRQ( HDLCD_IRQn );
-    hdlcd_disable_irq( &HDLCD_DEV, INT_DMA_END_Msk );
 }
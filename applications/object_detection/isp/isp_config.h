@@ -4,11 +4,14 @@
  */
 
 #include "acamera_firmware_api.h"
+#include "acamera_firmware_config.h"
 #include "acamera_sensor_api.h"
 #include "acamera_types.h"
 
 #include "platform_base_address.h"
 
+#include "FreeRTOS.h"
+
 #include "logging_levels.h"
 
 /* Logging configuration for the MQTT library. */
@@ -31,28 +34,46 @@
 #define isp_configMAX_INPUT_FRAME_SIZE           ( isp_configMAX_FRAME_WIDTH * isp_configMAX_FRAME_HEIGHT * isp_configMAX_BITS_PER_PIXEL / 8 )
 #define isp_configMAX_OUTPUT_FRAME_SIZE          ( isp_configMAX_FRAME_WIDTH * isp_configMAX_FRAME_HEIGHT * isp_configMAX_BYTES_PER_PIXEL )
 
-/* 5400KB */
-#define isp_configCOHERENT_DMA_MEMORY_SIZE       isp_configMAX_INPUT_FRAME_SIZE
+/* Every context has its own 5400KB slice of the coherent DMA memory */
+#define isp_configCOHERENT_DMA_CONTEXT_SIZE      ( isp_configMAX_INPUT_FRAME_SIZE )
+#define isp_configCOHERENT_DMA_MEMORY_SIZE       ( isp_configCOHERENT_DMA_CONTEXT_SIZE * FIRMWARE_CONTEXT_NUMBER )
 
+/* Every context has its own ring of full resolution and of downscaled buffers */
 #define isp_configMAX_BUFFERED_FRAMES            4
+#define isp_configFRAME_RING_SIZE                ( isp_configMAX_OUTPUT_FRAME_SIZE * isp_configMAX_BUFFERED_FRAMES )
 #define isp_configFULL_RESOLUTION_BUFFER_BASE    ( isp_configCOHERENT_DMA_MEMORY_BASE + isp_configCOHERENT_DMA_MEMORY_SIZE )
-#define isp_configDOWNSCALED_BUFFER_BASE         ( isp_configFULL_RESOLUTION_BUFFER_BASE + ( isp_configMAX_OUTPUT_FRAME_SIZE * isp_configMAX_BUFFERED_FRAMES ) )
+#define isp_configDOWNSCALED_BUFFER_BASE         ( isp_configFULL_RESOLUTION_BUFFER_BASE + ( isp_configFRAME_RING_SIZE * FIRMWARE_CONTEXT_NUMBER ) )
+
+/* Front and back buffers of the display, each holds a full resolution frame */
+#define isp_configDISPLAY_BUFFER_BASE            ( isp_configDOWNSCALED_BUFFER_BASE + ( isp_configFRAME_RING_SIZE * FIRMWARE_CONTEXT_NUMBER ) )
+
+/* The context whose frames and detections are displayed */
+#define isp_configDISPLAYED_CONTEXT              0
+
+/* Inferred frames between two logs of the statistics of a context */
+#define isp_configSTATS_LOG_PERIOD               30
+
+/* How much of every frame to infer, see inference_scheduler.h. A cell of the
+ * frame changed if its mean intensity moved by more than the cell threshold,
+ * the scene changed if all the cells moved by more than the scene threshold
+ * on average. */
+#define isp_configINFER_CELL_THRESHOLD           12
+#define isp_configINFER_SCENE_THRESHOLD          24
+#define isp_configINFER_MAX_SKIPPED_FRAMES       15
+#define isp_configINFER_FULL_PERIOD              8
+#define isp_configINFER_REGION_MARGIN            24
+#define isp_configINFER_MAX_REGION_PERCENT       50
 
 struct FullResolutionImage
 {
+    uint32_t ulAddress;
     uint32_t ulMode;
     uint32_t ulWidth;
     uint32_t ulHeight;
 };
 
-struct LastFrame
-{
-    uint32_t ulDisplayed;
-    uint32_t ulInferred;
-    struct FullResolutionImage xFullResolution;
-};
-
-typedef void (* pvFrameReadyHandler_t)( uint32_t ulAddress,
+typedef void (* pvFrameReadyHandler_t)( uint32_t ulContextId,
+                                        uint32_t ulAddress,
                                         uint32_t ulWidth,
                                         uint32_t ulHeight,
                                         uint32_t ulMode,
@@ -91,3 +112,7 @@ extern int32_t lCallbackStreamPutFrame( uint32_t ulContextId,
                                         uint64_t ullNumPlanes );
 
 void vStartISPDemo();
+
+/* Infer the frames queued by the contexts, taking them from each context in
+ * turn. Waits up to xTimeout for a first frame. */
+void vIspInferQueuedFrames( TickType_t xTimeout );
@@ -149,6 +149,8 @@ uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
 
 int main( void )
 {
+    vBootTimelineMark( BootTimelineMain );
+
     bsp_serial_init();
 
     xLoggingTaskInitialize( appCONFIG_LOGGING_TASK_STACK_SIZE,
@@ -218,6 +220,8 @@ int main( void )
         }
     }
 
+    vBootTimelineMark( BootTimelineProvisioned );
+
     /* The next initializations are done as a part of the main */
     /* function as these resources are shared between tasks */
     /* and it is not guranteed that the task which initialise */
@@ -254,6 +258,8 @@ int main( void )
 
     vStartMlTask( NULL );
 
+    vBootTimelineMark( BootTimelineSchedulerStart );
+
     vTaskStartScheduler();
 
     /* If all is well, the scheduler will now be running, and the following
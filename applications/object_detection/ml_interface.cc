@@ -61,12 +61,6 @@ extern "C" {
  */
 #define mqttexampleTOPIC    democonfigCLIENT_IDENTIFIER "/ml/inference"
 
-/**
- * @brief The MQTT agent manages the MQTT contexts.  This set the handle to the
- * context used by this demo.
- */
-extern MQTTAgentContext_t xGlobalMqttAgentContext;
-
 /**
  * @brief The maximum time for which application waits for an MQTT operation to be complete.
  * This involves receiving an acknowledgment for broker for SUBSCRIBE, UNSUBSCRIBE and non
@@ -138,7 +132,7 @@ static void prvMqttSendMessage( const char * pcMessage )
     xCommandParams.pCmdCompleteCallbackContext = ( MQTTAgentCommandContext_t * ) &xCommandContext;
 
     LogInfo( ( "Attempting to publish (%s) to the MQTT topic %s.\r\n", pcMessage, mqttexampleTOPIC ) );
-    xMqttStatus = MQTTAgent_Publish( &xGlobalMqttAgentContext,
+    xMqttStatus = MQTTAgent_Publish( pxGetMqttAgentContext( eMqttAgentConnectionControl ),
                                      &xPublishInfo,
                                      &xCommandParams );
 
@@ -341,6 +335,8 @@ static int prvProcessImage( ApplicationContext &xApplicationContext,
         return -1;
     }
 
+    vBootTimelineMark( BootTimelineFirstInference );
+
     if( !xPostProcess.DoPostProcess() )
     {
         LogError( ( "Post-processing failed." ) );
@@ -353,6 +349,7 @@ static int prvProcessImage( ApplicationContext &xApplicationContext,
         pxCResults[ i ].ulY = xResults[ i ].m_y0;
         pxCResults[ i ].ulW = xResults[ i ].m_w;
         pxCResults[ i ].ulH = xResults[ i ].m_h;
+        pxCResults[ i ].xScore = xResults[ i ].m_normalisedVal;
     }
 
     if( !prvPresentInferenceResult( xResults ) )
@@ -470,6 +467,8 @@ static int prvMlInterfaceInit( void )
             LogError( ( "Failed to arm npu\n" ) );
             return -1;
         }
+
+        vBootTimelineMark( BootTimelineNpuReady );
     #endif /* USE_ETHOS */
 
     /* Load the model. */
@@ -487,6 +486,8 @@ static int prvMlInterfaceInit( void )
     /* Instantiate application context. */
     xCaseContext.Set<arm::app::Model &>( "model", xModel );
 
+    vBootTimelineMark( BootTimelineModelReady );
+
     LogInfo( ( "*** ML interface initialised\r\n" ) );
     return 0;
 }
@@ -495,6 +496,14 @@ void vMlTask( void * pvParameters )
 {
     LogInfo( ( "ML Task start\r\n" ) );
 
+    /* Initialise the NPU and the model while the network comes up instead
+     * of once inference is started. */
+    if( prvMlInterfaceInit() < 0 )
+    {
+        LogError( ( "prvMlInterfaceInit failed\r\n" ) );
+        return;
+    }
+
     EventBits_t xFlags = xEventGroupWaitBits(
         xSystemEvents, ( EventBits_t ) EVENT_MASK_ML_START, pdTRUE, pdFAIL, portMAX_DELAY
         );
@@ -504,18 +513,12 @@ void vMlTask( void * pvParameters )
         LogInfo( ( "Initial start of image processing\r\n" ) );
     }
 
-    if( prvMlInterfaceInit() < 0 )
-    {
-        LogError( ( "prvMlInterfaceInit failed\r\n" ) );
-        return;
-    }
-
     vStartISPDemo();
 
     while( 1 )
     {
         xFlags = xEventGroupWaitBits(
-            xSystemEvents, ( EventBits_t ) EVENT_MASK_ML_STOP, pdTRUE, pdFAIL, 300
+            xSystemEvents, ( EventBits_t ) EVENT_MASK_ML_STOP, pdTRUE, pdFAIL, 0
             );
 
         if( xFlags & EVENT_MASK_ML_STOP )
@@ -523,6 +526,9 @@ void vMlTask( void * pvParameters )
             LogInfo( ( "Stopping image processing\r\n" ) );
             break;
         }
+
+        /* The frames of all the ISP contexts are inferred by this task */
+        vIspInferQueuedFrames( 300 );
     }
 }
 
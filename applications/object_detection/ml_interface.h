@@ -18,6 +18,7 @@
         uint32_t ulY;
         uint32_t ulW;
         uint32_t ulH;
+        float xScore;
     };
 
     typedef struct
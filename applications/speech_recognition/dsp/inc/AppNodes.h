@@ -77,7 +77,7 @@ public:
         int16_t * b = this->pxGetWriteBuffer();
         const int16_t * current = mDsp->pxGetCurrentBuffer();
 
-        memcpy( b, current, outputSize * sizeof( int16_t ) );
+        vMveCopy( b, current, outputSize * sizeof( int16_t ) );
         return 0;
     }
 
@@ -166,7 +166,7 @@ public:
         int16_t * a = this->pxGetReadBuffer();
         int16_t * b = this->pxGetWriteBuffer();
 
-        memcpy( b, a, sizeof( int16_t ) * inputSize );
+        vMveCopy( b, a, sizeof( int16_t ) * inputSize );
 
         /* Noise reduction using libspeex */
         #if defined( ENABLE_DSP )
@@ -19,6 +19,10 @@
 
 #include <vector>
 
+extern "C" {
+#include "mve_kernels.h"
+}
+
 /* FIFOS */
 template<typename T>
 class FIFOBase {
@@ -53,7 +57,8 @@ public:
 
         if( readPos > 0 )
         {
-            memcpy( ( void * ) mBuffer, ( void * ) ( mBuffer + readPos ), ( writePos - readPos ) * sizeof( T ) );
+            /* The unread samples may overlap the start of the buffer. */
+            vMveCopy( ( void * ) mBuffer, ( void * ) ( mBuffer + readPos ), ( writePos - readPos ) * sizeof( T ) );
             writePos -= readPos;
             readPos = 0;
         }
@@ -16,6 +16,8 @@
 #include <cstring>
 
 extern "C" {
+#include "mve_kernels.h"
+
 /* Include header that defines log levels. */
 #include "logging_levels.h"
 
@@ -143,14 +145,14 @@ DSPML::~DSPML()
 void DSPML::vCopyToDSPBufferFrom( int16_t * buf )
 {
     prvDspMlLock( mutex );
-    memcpy( dspBuffer, buf, sizeof( int16_t ) * nbSamples );
+    vMveCopy( dspBuffer, buf, sizeof( int16_t ) * nbSamples );
     prvDspMlUnlock( mutex );
 }
 
 void DSPML::vCopyFromMLBufferInto( int16_t * buf )
 {
     prvDspMlLock( mutex );
-    memcpy( buf, mlBuffer, sizeof( int16_t ) * nbSamples );
+    vMveCopy( buf, mlBuffer, sizeof( int16_t ) * nbSamples );
     prvDspMlUnlock( mutex );
 }
 
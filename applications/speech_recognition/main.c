@@ -156,6 +156,8 @@ uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
 
 int main( void )
 {
+    vBootTimelineMark( BootTimelineMain );
+
     bsp_serial_init();
 
     xLoggingTaskInitialize( appCONFIG_LOGGING_TASK_STACK_SIZE,
@@ -225,6 +227,8 @@ int main( void )
         }
     }
 
+    vBootTimelineMark( BootTimelineProvisioned );
+
     /* The next initializations are done as a part of the main */
     /* function as these resources are shared between tasks */
     /* and it is not guranteed that the task which initialise */
@@ -270,6 +274,8 @@ int main( void )
         vOtaNotActiveHook();
     }
 
+    vBootTimelineMark( BootTimelineSchedulerStart );
+
     vTaskStartScheduler();
 
     /* If all is well, the scheduler will now be running, and the following
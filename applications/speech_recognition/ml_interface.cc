@@ -69,12 +69,6 @@ extern "C" {
  */
 #define mqttexampleTOPIC    democonfigCLIENT_IDENTIFIER "/ml/inference"
 
-/**
- * @brief The MQTT agent manages the MQTT contexts.  This set the handle to the
- * context used by this demo.
- */
-extern MQTTAgentContext_t xGlobalMqttAgentContext;
-
 /**
  * @brief The maximum time for which application waits for an MQTT operation to be complete.
  * This involves receiving an acknowledgment for broker for SUBSCRIBE, UNSUBSCRIBE and non
@@ -143,7 +137,7 @@ static void prvMqttSendMessage( const char * message )
     xCommandParams.pCmdCompleteCallbackContext = ( MQTTAgentCommandContext_t * ) &xCommandContext;
 
     LogInfo( ( "Attempting to publish (%s) to the MQTT topic %s.\r\n", message, mqttexampleTOPIC ) );
-    mqttStatus = MQTTAgent_Publish( &xGlobalMqttAgentContext,
+    mqttStatus = MQTTAgent_Publish( pxGetMqttAgentContext( eMqttAgentConnectionControl ),
                                     &publishInfo,
                                     &xCommandParams );
 
@@ -385,6 +379,8 @@ static void prvProcessAudio( ApplicationContext &ctx,
                 return;
             }
 
+            vBootTimelineMark( BootTimelineFirstInference );
+
             LogDebug( ( "Doing post processing\n" ) );
 
             /* Post processing needs to know if we are on the last audio window. */
@@ -553,6 +549,8 @@ static int prvMlInterfaceInit( void )
             LogError( ( "Failed to arm npu\n" ) );
             return -1;
         }
+
+        vBootTimelineMark( BootTimelineNpuReady );
     #endif /* USE_ETHOS */
 
     /* Load the model. */
@@ -579,6 +577,8 @@ static int prvMlInterfaceInit( void )
     caseContext.Set<const std::vector<std::string> &>( "labels", labels );
     caseContext.Set<arm::app::AsrClassifier &>( "classifier", classifier );
 
+    vBootTimelineMark( BootTimelineModelReady );
+
     LogInfo( ( "*** ML interface initialised\r\n" ) );
     return 0;
 }
@@ -588,6 +588,14 @@ void vMlTask( void * pvParameters )
     LogInfo( ( "ML Task start\r\n" ) );
     DSPML * dspMLConnection = static_cast<DSPML *>( pvParameters );
 
+    /* Initialise the NPU and the model while the network comes up instead
+     * of once inference is started. */
+    if( prvMlInterfaceInit() < 0 )
+    {
+        LogError( ( "prvMlInterfaceInit failed\r\n" ) );
+        return;
+    }
+
     EventBits_t flags = xEventGroupWaitBits(
         xSystemEvents, ( EventBits_t ) EVENT_MASK_ML_START, pdTRUE, pdFAIL, portMAX_DELAY
         );
@@ -597,12 +605,6 @@ void vMlTask( void * pvParameters )
         LogInfo( ( "Initial start of audio processing\r\n" ) );
     }
 
-    if( prvMlInterfaceInit() < 0 )
-    {
-        LogError( ( "prvMlInterfaceInit failed\r\n" ) );
-        return;
-    }
-
     prvProcessAudio( caseContext, dspMLConnection );
 }
 
@@ -29,3 +29,11 @@
 #define configTICK_RATE_HZ    ( ( uint32_t ) 150 )
 #define pdMS_TO_TICKS( xTimeInMs )    ( ( TickType_t ) xTimeInMs )
 #define TICKS_TO_pdMS( xTicks )       ( ( uint32_t ) xTicks )
+
+/* The Cortex-M85 of Corstone-310 implements the M-profile Vector Extension
+ * (Helium). Saving the MVE registers of the tasks has not been built for this
+ * target yet, so it is off unless the application defines configENABLE_MVE to
+ * 1 before including this file. configENABLE_FPU must then be 1 as well. */
+#ifndef configENABLE_MVE
+    #define configENABLE_MVE    0
+#endif
@@ -0,0 +1,62 @@
+/*
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026, Arm Limited. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice, this
+ *    list of conditions and the following disclaimer in the documentation and/or
+ *    other materials provided with the distribution.
+ * - Neither the name of ARM nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef __SYSTEM_SPINLOCK_PLATFORM_H__
+#define __SYSTEM_SPINLOCK_PLATFORM_H__
+
+#include <stdint.h>
+
+#include "system_spinlock.h"
+
+/**
+ *   Usage of a spinlock, recorded when SYSTEM_SPINLOCK_STATS is 1.
+ *   The hold times are in CPU cycles, from the outermost lock to its unlock.
+ */
+typedef struct
+{
+    uint32_t acquisitions;
+    /* Locks taken while already held, by a nested lock or by an interrupt
+     * above configMAX_SYSCALL_INTERRUPT_PRIORITY. Nothing ever waits for
+     * a lock, so there is no contention to count. */
+    uint32_t nested;
+    uint32_t max_hold_cycles;
+    uint64_t total_hold_cycles;
+} system_spinlock_stats_t;
+
+/**
+ *   Get the usage of a spinlock.
+ *
+ *   @return 0 on success, -1 if the statistics are not recorded.
+ */
+int32_t system_spinlock_get_stats( sys_spinlock lock,
+                                   system_spinlock_stats_t * stats );
+
+#endif //__SYSTEM_SPINLOCK_PLATFORM_H__
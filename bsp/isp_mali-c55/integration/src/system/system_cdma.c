@@ -36,6 +36,22 @@
 #include "semphr.h"
 #include "task.h"
 
+#if defined( ISP_CDMA_DMA350 )
+    #include <stdbool.h>
+
+    #include CMSIS_device_header
+    #include "device_definition.h"
+    #include "dma350_ch_drv.h"
+    #include "dma350_lib.h"
+    #include "platform_irq.h"
+
+/* Longest a transfer may take before it is stopped and done with memcpy(). */
+    #define CDMA_DMA350_TIMEOUT_MS    100
+
+/* Same priority as the ISP interrupt. */
+    #define CDMA_DMA350_IRQ_PRIORITY    7
+#endif
+
 #define ioremap( addr, size )           ( ( void * ) addr )
 #define iounmap( addr )                 ( void ) addr
 
@@ -89,11 +105,22 @@ typedef struct
     dma_completion_callback complete_func;
     uint32_t nents_done;
     struct completion comp;
+
+    /* copies the whole list when the DMA350 is used */
+    struct tasklet_struct dma350_task;
 } system_cdma_device_t;
 
 volatile struct tasklet_struct head_tasklet;
 SemaphoreHandle_t xTaskletSemaphore = NULL;
 StaticSemaphore_t xTaskletMutexBuffer;
+static TaskHandle_t xCdmaTask = NULL;
+
+#if defined( ISP_CDMA_DMA350 )
+    static SemaphoreHandle_t xDma350Done = NULL;
+    static StaticSemaphore_t xDma350DoneBuffer;
+    static volatile BaseType_t xDma350Error = pdFALSE;
+    static BaseType_t xDma350Ready = pdFALSE;
+#endif
 
 static void tasklet_schedule( struct tasklet_struct * new_tasklet )
 {
@@ -119,6 +146,12 @@ static void tasklet_schedule( struct tasklet_struct * new_tasklet )
     }
 
     xSemaphoreGive( xTaskletSemaphore );
+
+    /* Wake the processing thread up rather than leave it to its next poll. */
+    if( xCdmaTask != NULL )
+    {
+        xTaskNotifyGive( xCdmaTask );
+    }
 }
 
 static void cdma_processing_thread( void * pvParameters )
@@ -140,8 +173,7 @@ static void cdma_processing_thread( void * pvParameters )
         else
         {
             xSemaphoreGive( xTaskletSemaphore );
-            vTaskDelay( pdMS_TO_TICKS( 10 ) );
-            taskYIELD();
+            ( void ) ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( 10 ) );
         }
     }
 }
@@ -169,15 +201,113 @@ static void complete( struct completion * comp )
     }
 }
 
+#if defined( ISP_CDMA_DMA350 )
+
+    static void dma350_irq_handler( void )
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+        if( dma350_ch_is_stat_set( &ISP_CDMA_DMA350_CHANNEL, DMA350_CH_STAT_ERR ) )
+        {
+            xDma350Error = pdTRUE;
+            dma350_ch_clear_stat( &ISP_CDMA_DMA350_CHANNEL, DMA350_CH_STAT_ERR );
+        }
+
+        dma350_ch_clear_stat( &ISP_CDMA_DMA350_CHANNEL, DMA350_CH_STAT_DONE );
+
+        xSemaphoreGiveFromISR( xDma350Done, &xHigherPriorityTaskWoken );
+        portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    }
+
+    static void dma350_setup( void )
+    {
+        xDma350Done = xSemaphoreCreateBinaryStatic( &xDma350DoneBuffer );
+
+        if( dma350_ch_init( &ISP_CDMA_DMA350_CHANNEL ) != DMA350_CH_ERR_NONE )
+        {
+            LOG( LOG_ERR, "DMA350 channel unavailable, copying with memcpy" );
+            return;
+        }
+
+        NVIC_SetVector( ISP_CDMA_DMA350_IRQn, ( uint32_t ) dma350_irq_handler );
+        NVIC_SetPriority( ISP_CDMA_DMA350_IRQn, CDMA_DMA350_IRQ_PRIORITY );
+        NVIC_EnableIRQ( ISP_CDMA_DMA350_IRQn );
+
+        xDma350Ready = pdTRUE;
+    }
+
+/* Copy one entry with the DMA350 and sleep until its interrupt. Returns
+ * false if the DMA350 did not complete the copy. */
+    static bool dma350_copy( void * dst_mem,
+                             void * src_mem,
+                             size_t size,
+                             uint32_t direction )
+    {
+        bool done = false;
+
+        if( size == 0 )
+        {
+            return true;
+        }
+
+        /* The firmware memory is cacheable, the ISP registers are not. */
+        #if defined( __DCACHE_PRESENT ) && ( __DCACHE_PRESENT == 1U )
+            if( direction == SYS_DMA_TO_DEVICE )
+            {
+                SCB_CleanDCache_by_Addr( src_mem, ( int32_t ) size );
+            }
+            else
+            {
+                SCB_CleanInvalidateDCache_by_Addr( dst_mem, ( int32_t ) size );
+            }
+        #endif
+
+        xDma350Error = pdFALSE;
+
+        if( dma350_memcpy( &ISP_CDMA_DMA350_CHANNEL, src_mem, dst_mem, ( uint32_t ) size,
+                           DMA350_LIB_EXEC_IRQ ) == DMA350_LIB_ERR_NONE )
+        {
+            if( xSemaphoreTake( xDma350Done, pdMS_TO_TICKS( CDMA_DMA350_TIMEOUT_MS ) ) == pdTRUE )
+            {
+                done = ( xDma350Error == pdFALSE );
+            }
+            else
+            {
+                LOG( LOG_ERR, "DMA350 transfer timed out" );
+                dma350_ch_cmd( &ISP_CDMA_DMA350_CHANNEL, DMA350_CH_CMD_STOPCMD );
+
+                /* Drop a completion that raced with the stop. */
+                ( void ) xSemaphoreTake( xDma350Done, 0 );
+            }
+        }
+
+        /* Drop the lines the CPU may have fetched again during the transfer. */
+        #if defined( __DCACHE_PRESENT ) && ( __DCACHE_PRESENT == 1U )
+            if( direction != SYS_DMA_TO_DEVICE )
+            {
+                SCB_CleanInvalidateDCache_by_Addr( dst_mem, ( int32_t ) size );
+            }
+        #endif
+
+        return done;
+    }
+
+#endif /* if defined( ISP_CDMA_DMA350 ) */
+
 void system_cdma_setup()
 {
     xTaskletSemaphore = xSemaphoreCreateMutexStatic( &xTaskletMutexBuffer );
+
+    #if defined( ISP_CDMA_DMA350 )
+        dma350_setup();
+    #endif
+
     xTaskCreate( cdma_processing_thread,
                  "cdma",
                  configMINIMAL_STACK_SIZE,
                  NULL,
                  ( configMAX_PRIORITIES - 3 ) | portPRIVILEGE_BIT,
-                 NULL );
+                 &xCdmaTask );
 }
 
 #define MAX_DMA_MEM_ADDR_PAIRS    2
@@ -424,6 +554,38 @@ static void memcopy_func( unsigned long p_task )
     dma_complete_func( mem_addr->sys_back_ptr );
 }
 
+#if defined( ISP_CDMA_DMA350 )
+
+/* Copy the whole list, one entry after the other on the same channel. An
+ * entry the DMA350 fails to copy is copied with memcpy() instead. */
+    static void dma350_copy_func( unsigned long p_device )
+    {
+        system_cdma_device_t * system_cdma_device = ( system_cdma_device_t * ) p_device;
+        int32_t buff_loc = system_cdma_device->buff_loc;
+        uint32_t fw_ctx_id = system_cdma_device->cur_fw_ctx_id;
+        uint32_t direction = system_cdma_device->direction;
+        unsigned int nents = system_cdma_device->sg_device_nents[ fw_ctx_id ][ buff_loc ];
+        unsigned int i;
+
+        for( i = 0; i < nents; i++ )
+        {
+            mem_addr_pair_t * mem_addr = &system_cdma_device->mem_addrs[ fw_ctx_id ][ buff_loc ][ i ];
+            void * src_mem = ( direction == SYS_DMA_TO_DEVICE ) ? mem_addr->fw_addr : mem_addr->dev_addr;
+            void * dst_mem = ( direction == SYS_DMA_TO_DEVICE ) ? mem_addr->dev_addr : mem_addr->fw_addr;
+
+            if( !dma350_copy( dst_mem, src_mem, mem_addr->size, direction ) )
+            {
+                memcpy( dst_mem, src_mem, mem_addr->size );
+            }
+
+            LOG( LOG_DEBUG, "(%d:%d) d:%p s:%p l:%ld dma350", buff_loc, direction, dst_mem, src_mem, mem_addr->size );
+
+            dma_complete_func( system_cdma_device );
+        }
+    }
+
+#endif /* if defined( ISP_CDMA_DMA350 ) */
+
 void system_cdma_unmap_sg( void * ctx )
 {
 }
@@ -477,14 +639,25 @@ int32_t system_cdma_copy_sg( void * ctx,
     system_cdma_device->direction = direction;
     system_cdma_device->buff_loc = buff_loc;
 
-    for( i = 0; i < SYSTEM_DMA_MAX_CHANNEL; i++ )
+    #if defined( ISP_CDMA_DMA350 )
+        if( xDma350Ready == pdTRUE )
+        {
+            system_cdma_device->dma350_task.data = ( unsigned long ) system_cdma_device;
+            system_cdma_device->dma350_task.func = dma350_copy_func;
+            tasklet_schedule( &system_cdma_device->dma350_task );
+        }
+        else
+    #endif /* if defined( ISP_CDMA_DMA350 ) */
     {
-        system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ].mem_data =
-            &( system_cdma_device->mem_addrs[ fw_ctx_id ][ buff_loc ][ i ] );
-        system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ].m_task.data =
-            ( unsigned long ) &system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ];
-        system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ].m_task.func = memcopy_func;
-        tasklet_schedule( &system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ].m_task );
+        for( i = 0; i < SYSTEM_DMA_MAX_CHANNEL; i++ )
+        {
+            system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ].mem_data =
+                &( system_cdma_device->mem_addrs[ fw_ctx_id ][ buff_loc ][ i ] );
+            system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ].m_task.data =
+                ( unsigned long ) &system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ];
+            system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ].m_task.func = memcopy_func;
+            tasklet_schedule( &system_cdma_device->task_list[ fw_ctx_id ][ buff_loc ][ i ].m_task );
+        }
     }
 
     if( async_dma == 0 )
@@ -29,83 +29,140 @@
  */
 
 #include "system_spinlock.h"
+#include "system_spinlock_platform.h"
 #include "acamera_logger.h"
 #include "acamera_types.h"
 
 #include "FreeRTOS.h"
-#include "semphr.h"
 
 #include CMSIS_device_header
 #include "cmsis_compiler.h"
 
-/*! Test if in interrupt mode */
-__STATIC_INLINE
-int isInterrupt()
+#include <string.h>
+
+#ifndef SYSTEM_SPINLOCK_STATS
+    #define SYSTEM_SPINLOCK_STATS    0
+#endif
+
+#if SYSTEM_SPINLOCK_STATS
+    #define DWT_LAR_UNLOCK    ( 0xC5ACCE55UL )
+#endif
+
+/* The CPU is the only bus master that takes the locks, so masking the
+ * interrupts that may take them is enough: nothing spins. The mask is raised
+ * to configMAX_SYSCALL_INTERRUPT_PRIORITY, which covers the ISP interrupt and
+ * works the same from tasks and interrupt handlers.
+ *
+ * The mask is raised directly rather than with taskENTER_CRITICAL(), which
+ * can not be used from interrupt handlers. It is therefore not counted by the
+ * critical nesting of the kernel: a taskEXIT_CRITICAL() under a lock, from
+ * any FreeRTOS API that enters a critical section, clears BASEPRI and
+ * unmasks the interrupts while the lock is held. No FreeRTOS API may be
+ * called under a lock, system_spinlock_unlock() asserts that the mask is
+ * still raised. */
+typedef struct
 {
-    return ( SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk ) != 0;
-}
+    /* Locks held, more than 1 when the lock is taken again while held. */
+    volatile uint32_t depth;
+    #if SYSTEM_SPINLOCK_STATS
+        uint32_t acquired_cycle;
+        system_spinlock_stats_t stats;
+    #endif
+} system_spinlock_t;
 
 int system_spinlock_init( sys_spinlock * lock )
 {
-    SemaphoreHandle_t xSemaphore = xSemaphoreCreateMutex();
+    system_spinlock_t * spinlock = pvPortMalloc( sizeof( system_spinlock_t ) );
 
-    if( xSemaphore == NULL )
+    if( spinlock == NULL )
     {
         return -1;
     }
 
-    *lock = xSemaphore;
+    memset( spinlock, 0, sizeof( system_spinlock_t ) );
+
+    #if SYSTEM_SPINLOCK_STATS
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->LAR = DWT_LAR_UNLOCK;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    #endif
+
+    *lock = spinlock;
     return 0;
 }
 
 unsigned long system_spinlock_lock( sys_spinlock lock )
 {
-    LOG( LOG_DEBUG, "LOCK 0x%x", ( uint32_t ) lock );
+    system_spinlock_t * spinlock = ( system_spinlock_t * ) lock;
+    unsigned long flags = portSET_INTERRUPT_MASK_FROM_ISR();
 
-    if( isInterrupt() )
-    {
-        if( xSemaphoreTakeFromISR( ( SemaphoreHandle_t ) lock, NULL ) != pdTRUE )
+    #if SYSTEM_SPINLOCK_STATS
+        if( spinlock->depth != 0U )
         {
-            LOG( LOG_DEBUG, "    FAIL" );
-            return -1;
+            spinlock->stats.nested++;
         }
-    }
-    else
-    {
-        if( xSemaphoreTake( ( SemaphoreHandle_t ) lock, portMAX_DELAY ) != pdTRUE )
+        else
         {
-            LOG( LOG_DEBUG, "    FAIL" );
-            return -1;
+            spinlock->acquired_cycle = DWT->CYCCNT;
         }
-    }
 
-    return 0;
+        spinlock->stats.acquisitions++;
+    #endif
+
+    spinlock->depth++;
+
+    return flags;
 }
 
 void system_spinlock_unlock( sys_spinlock lock,
                              unsigned long flags )
 {
-    LOG( LOG_DEBUG, "UNLOCK 0x%x", ( uint32_t ) lock );
+    system_spinlock_t * spinlock = ( system_spinlock_t * ) lock;
 
-    if( isInterrupt() )
-    {
-        if( xSemaphoreGiveFromISR( ( SemaphoreHandle_t ) lock, NULL ) != pdTRUE )
-        {
-            LOG( LOG_DEBUG, "    FAIL" );
-            return;
-        }
-    }
-    else
-    {
-        if( xSemaphoreGive( ( SemaphoreHandle_t ) lock ) != pdTRUE )
+    /* A FreeRTOS API called under the lock cleared the mask. */
+    configASSERT( __get_BASEPRI() != 0U );
+    configASSERT( spinlock->depth != 0U );
+
+    spinlock->depth--;
+
+    #if SYSTEM_SPINLOCK_STATS
+        if( spinlock->depth == 0U )
         {
-            LOG( LOG_DEBUG, "    FAIL" );
-            return;
+            uint32_t hold_cycles = DWT->CYCCNT - spinlock->acquired_cycle;
+
+            if( hold_cycles > spinlock->stats.max_hold_cycles )
+            {
+                spinlock->stats.max_hold_cycles = hold_cycles;
+            }
+
+            spinlock->stats.total_hold_cycles += hold_cycles;
         }
-    }
+    #endif
+
+    /* Restores the mask of the caller, so nested locks unwind in order. */
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( flags );
 }
 
 void system_spinlock_destroy( sys_spinlock lock )
 {
-    vSemaphoreDelete( ( SemaphoreHandle_t ) lock );
+    vPortFree( lock );
+}
+
+int32_t system_spinlock_get_stats( sys_spinlock lock,
+                                   system_spinlock_stats_t * stats )
+{
+    #if SYSTEM_SPINLOCK_STATS
+        system_spinlock_t * spinlock = ( system_spinlock_t * ) lock;
+        unsigned long flags = portSET_INTERRUPT_MASK_FROM_ISR();
+
+        *stats = spinlock->stats;
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( flags );
+
+        return 0;
+    #else
+        ( void ) lock;
+        ( void ) stats;
+
+        return -1;
+    #endif
 }
@@ -34,7 +34,8 @@ typedef enum MQTTStatus
     MQTTSuccess = 0,
     MQTTBadParameter,
     MQTTSendFailed,
-    MQTTRecvFailed
+    MQTTRecvFailed,
+    MQTTKeepAliveTimeout
 } MQTTStatus_t;
 
 typedef struct MQTTConnectInfo
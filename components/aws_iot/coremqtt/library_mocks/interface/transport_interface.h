@@ -26,10 +26,20 @@
 #ifndef TRANSPORT_INTERFACE_H_
 #define TRANSPORT_INTERFACE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int32_t ( * TransportRecv_t )( int * pNetworkContext,
+                                       void * pBuffer,
+                                       size_t bytesToRecv );
+typedef int32_t ( * TransportSend_t )( int * pNetworkContext,
+                                       const void * pBuffer,
+                                       size_t bytesToSend );
+
 typedef struct TransportInterface
 {
-    int recv;
-    int send;
+    TransportRecv_t recv;
+    TransportSend_t send;
     int writev;
     int * pNetworkContext;
 } TransportInterface_t;
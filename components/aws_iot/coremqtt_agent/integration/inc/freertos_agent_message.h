@@ -38,17 +38,124 @@
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
 #include "queue.h"
+#include "semphr.h"
 
 /* Include MQTT agent messaging interface. */
 #include "core_mqtt_agent_message_interface.h"
+#include "core_mqtt_agent.h"
+
+/**
+ * @brief Depth of the queue holding high priority commands.
+ *
+ * High priority commands are the ones that keep the connection alive or
+ * change its state: PINGREQ, CONNECT, DISCONNECT and TERMINATE.
+ */
+#ifndef agentMessageHIGH_PRIORITY_QUEUE_LENGTH
+    #define agentMessageHIGH_PRIORITY_QUEUE_LENGTH      ( 4U )
+#endif
+
+/**
+ * @brief Depth of the queue holding normal priority commands.
+ *
+ * Normal priority commands are application publishes, subscribes and
+ * unsubscribes.
+ */
+#ifndef agentMessageNORMAL_PRIORITY_QUEUE_LENGTH
+    #define agentMessageNORMAL_PRIORITY_QUEUE_LENGTH    ( 16U )
+#endif
+
+/**
+ * @brief Depth of the queue holding low priority commands.
+ *
+ * Bounding this queue stops bulk traffic from holding every command
+ * structure of the pool, so normal and high priority senders can still queue
+ * work during a large transfer.
+ */
+#ifndef agentMessageLOW_PRIORITY_QUEUE_LENGTH
+    #define agentMessageLOW_PRIORITY_QUEUE_LENGTH       ( 16U )
+#endif
+
+/**
+ * @brief Publishes, subscribes and unsubscribes on topics starting with this
+ * prefix are low priority.
+ *
+ * The AWS IoT reserved topics carry the OTA jobs and file streams traffic.
+ */
+#ifndef agentMessageLOW_PRIORITY_TOPIC_PREFIX
+    #define agentMessageLOW_PRIORITY_TOPIC_PREFIX       "$aws/"
+#endif
+
+/**
+ * @brief Number of times a waiting command may be overtaken by commands of
+ * a higher priority before it is served anyway.
+ */
+#ifndef agentMessageSTARVATION_LIMIT
+    #define agentMessageSTARVATION_LIMIT                ( 8U )
+#endif
+
+/**
+ * @ingroup mqtt_agent_enum_types
+ * @brief Priority levels of the commands delivered to the agent.
+ */
+typedef enum AgentMessagePriority
+{
+    AgentMessagePriorityHigh = 0, /*!< Keep-alive and connection management. */
+    AgentMessagePriorityNormal,   /*!< Application publishes and subscriptions. */
+    AgentMessagePriorityLow,      /*!< Bulk traffic on #agentMessageLOW_PRIORITY_TOPIC_PREFIX topics. */
+    AgentMessagePriorityCount     /*!< Number of priority levels. */
+} AgentMessagePriority_t;
+
+/**
+ * @ingroup mqtt_agent_struct_types
+ * @brief Queueing statistics of one priority level.
+ */
+typedef struct AgentMessageStats
+{
+    uint32_t sent;                 /*!< Commands queued at this priority. */
+    uint32_t received;             /*!< Commands handed to the agent from this priority. */
+    uint32_t dropped;              /*!< Commands that could not be queued within the block time. */
+    uint32_t starvationPromotions; /*!< Commands served ahead of higher priorities to prevent starvation. */
+    uint32_t maxLatencyMs;         /*!< Longest time a command spent queued. */
+    uint32_t totalLatencyMs;       /*!< Sum of queueing times, divide by received for the mean. */
+} AgentMessageStats_t;
+
+/**
+ * @ingroup mqtt_agent_struct_types
+ * @brief A command as held in a priority queue.
+ */
+typedef struct AgentPriorityMessage
+{
+    MQTTAgentCommand_t * pCommand; /*!< Command to deliver to the agent. */
+    TickType_t enqueueTime;        /*!< Tick count when the command was queued. */
+} AgentPriorityMessage_t;
+
+/**
+ * @ingroup mqtt_agent_struct_types
+ * @brief Static storage backing the queues of a priority message context.
+ */
+typedef struct AgentPriorityMessageStorage
+{
+    StaticQueue_t queueStructure[ AgentMessagePriorityCount ];
+    StaticSemaphore_t pendingStructure;
+    uint8_t highStorage[ agentMessageHIGH_PRIORITY_QUEUE_LENGTH * sizeof( AgentPriorityMessage_t ) ];
+    uint8_t normalStorage[ agentMessageNORMAL_PRIORITY_QUEUE_LENGTH * sizeof( AgentPriorityMessage_t ) ];
+    uint8_t lowStorage[ agentMessageLOW_PRIORITY_QUEUE_LENGTH * sizeof( AgentPriorityMessage_t ) ];
+} AgentPriorityMessageStorage_t;
 
 /**
  * @ingroup mqtt_agent_struct_types
  * @brief Context with which tasks may deliver messages to the agent.
+ *
+ * Agent_MessageSend() and Agent_MessageReceive() use `queue` as a plain FIFO.
+ * The Agent_PriorityMessage functions use the remaining members instead.
  */
 struct MQTTAgentMessageContext
 {
-    QueueHandle_t queue;
+    QueueHandle_t queue;                                        /*!< FIFO used by Agent_MessageSend() and Agent_MessageReceive(). */
+    QueueHandle_t priorityQueue[ AgentMessagePriorityCount ];   /*!< One bounded queue per priority level. */
+    SemaphoreHandle_t pending;                                  /*!< Counts the commands queued across all priority levels. */
+    uint32_t overtaken[ AgentMessagePriorityCount ];            /*!< Commands served ahead of a waiting command of this level. */
+    AgentMessageStats_t stats[ AgentMessagePriorityCount ];     /*!< Queueing statistics per priority level. */
 };
 
 /*-----------------------------------------------------------*/
@@ -81,4 +188,56 @@ bool Agent_MessageReceive( MQTTAgentMessageContext_t * pMsgCtx,
                            MQTTAgentCommand_t ** pReceivedCommand,
                            uint32_t blockTimeMs );
 
+/**
+ * @brief Create the priority queues of the specified context.
+ *
+ * @param[in] pMsgCtx An #MQTTAgentMessageContext_t.
+ * @param[in] pStorage Static storage for the queues, owned by the caller.
+ */
+void Agent_PriorityMessageInit( MQTTAgentMessageContext_t * pMsgCtx,
+                                AgentPriorityMessageStorage_t * pStorage );
+
+/**
+ * @brief Send a message to the queue matching the command's priority.
+ * Must be thread safe.
+ *
+ * @param[in] pMsgCtx An #MQTTAgentMessageContext_t set up by Agent_PriorityMessageInit().
+ * @param[in] pCommandToSend Pointer to address to send to queue.
+ * @param[in] blockTimeMs Block time to wait for space in the priority's queue.
+ *
+ * @return `true` if send was successful, else `false`.
+ */
+bool Agent_PriorityMessageSend( MQTTAgentMessageContext_t * pMsgCtx,
+                                MQTTAgentCommand_t * const * pCommandToSend,
+                                uint32_t blockTimeMs );
+
+/**
+ * @brief Receive the highest priority message from the specified context.
+ *
+ * A command that has been overtaken #agentMessageSTARVATION_LIMIT times is
+ * served before any higher priority command.
+ *
+ * @param[in] pMsgCtx An #MQTTAgentMessageContext_t set up by Agent_PriorityMessageInit().
+ * @param[in] pReceivedCommand Pointer to write address of received command.
+ * @param[in] blockTimeMs Block time to wait for a receive.
+ *
+ * @return `true` if receive was successful, else `false`.
+ */
+bool Agent_PriorityMessageReceive( MQTTAgentMessageContext_t * pMsgCtx,
+                                   MQTTAgentCommand_t ** pReceivedCommand,
+                                   uint32_t blockTimeMs );
+
+/**
+ * @brief Copy the queueing statistics of one priority level.
+ *
+ * @param[in] pMsgCtx An #MQTTAgentMessageContext_t set up by Agent_PriorityMessageInit().
+ * @param[in] priority Priority level to report.
+ * @param[out] pStats Written with the statistics of the level.
+ *
+ * @return `true` if the statistics were copied, else `false`.
+ */
+bool Agent_PriorityMessageGetStats( MQTTAgentMessageContext_t * pMsgCtx,
+                                    AgentMessagePriority_t priority,
+                                    AgentMessageStats_t * pStats );
+
 #endif /* FREERTOS_AGENT_MESSAGE_H */
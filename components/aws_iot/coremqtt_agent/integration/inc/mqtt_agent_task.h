@@ -38,6 +38,9 @@
 #include "core_mqtt_agent.h"
 #include "core_mqtt_serializer.h"
 
+/* Agent message interface include. */
+#include "freertos_agent_message.h"
+
 /**
  * @brief Defines the structure to use as the command callback context in this
  * demo.
@@ -49,6 +52,105 @@ struct MQTTAgentCommandContext
     void * pArgs;
 };
 
+/**
+ * @brief Link-health telemetry collected by the MQTT agent task.
+ *
+ * Round-trip times are measured from a PINGREQ, CONNECT, SUBSCRIBE,
+ * UNSUBSCRIBE or QoS1 PUBLISH leaving the transport to the PINGRESP, CONNACK,
+ * SUBACK, UNSUBACK or PUBACK with the same packet identifier received back.
+ * One request is timed at a time.
+ */
+typedef struct MqttAgentLinkHealth
+{
+    uint32_t ulLastRttMs;           /*!< Most recent round-trip time sample. */
+    uint32_t ulSmoothedRttMs;       /*!< Exponentially weighted round-trip time. */
+    uint32_t ulRttSamples;          /*!< Number of round-trip time samples taken. */
+    uint32_t ulConnectAttempts;     /*!< TLS and MQTT connection attempts. */
+    uint32_t ulConnectFailures;     /*!< Connection attempts that failed. */
+    uint32_t ulFailureRatePermille; /*!< Smoothed connection failure rate. */
+    uint32_t ulKeepAliveTimeouts;   /*!< Sessions ended by a missing PINGRESP. */
+    uint32_t ulSendFailures;        /*!< Sessions ended by a transport send error. */
+    uint32_t ulRecvFailures;        /*!< Sessions ended by a transport receive error. */
+    uint32_t ulOtherDisconnects;    /*!< Sessions ended for any other reason. */
+    uint16_t usKeepAliveSeconds;    /*!< Keep-alive used for the next CONNECT. */
+    uint16_t usBackoffCeilingMs;    /*!< Current reconnect back-off ceiling. */
+} MqttAgentLinkHealth_t;
+
+/**
+ * @brief MQTT connections run by the agent.
+ *
+ * Each connection has its own TLS session, network buffer, command queue and
+ * subscription list. When appCONFIG_MQTT_AGENT_NUM_CONNECTIONS is smaller than
+ * the number of identifiers, the extra identifiers share the control
+ * connection. There is at most one connection per identifier, so
+ * appCONFIG_MQTT_AGENT_NUM_CONNECTIONS is 1 or 2.
+ */
+typedef enum MqttAgentConnectionId
+{
+    eMqttAgentConnectionControl = 0, /*!< Latency-sensitive traffic such as inference results. */
+    eMqttAgentConnectionBulk         /*!< Bulk transfers such as OTA jobs and file streams. */
+} MqttAgentConnectionId_t;
+
 void vStartMqttAgentTask( void );
 
+/**
+ * @brief Get the MQTT agent context to post commands to for a connection.
+ *
+ * @param[in] xConnection Connection identifier.
+ *
+ * @return The agent context of the connection.
+ */
+MQTTAgentContext_t * pxGetMqttAgentContext( MqttAgentConnectionId_t xConnection );
+
+/**
+ * @brief Get the subscription list incoming publishes of a connection are
+ * dispatched from. The element type is SubscriptionElement_t from
+ * subscription_manager.h.
+ *
+ * @param[in] xConnection Connection identifier.
+ *
+ * @return The subscription list of the connection.
+ */
+struct subscriptionElement * pxGetMqttAgentSubscriptionList( MqttAgentConnectionId_t xConnection );
+
+/**
+ * @brief Take a consistent snapshot of the link-health telemetry of a
+ * connection.
+ *
+ * @param[in] xConnection Connection identifier.
+ * @param[out] pxLinkHealth Where to copy the telemetry.
+ */
+void vGetMqttAgentLinkHealth( MqttAgentConnectionId_t xConnection,
+                              MqttAgentLinkHealth_t * pxLinkHealth );
+
+/**
+ * @brief Wait until a connection is connected to the MQTT broker.
+ *
+ * @param[in] xConnection Connection identifier.
+ */
+void vWaitUntilMqttAgentConnectionConnected( MqttAgentConnectionId_t xConnection );
+
+/**
+ * @brief Check whether a connection is connected to the MQTT broker.
+ *
+ * @param[in] xConnection Connection identifier.
+ *
+ * @return true if the connection is connected, otherwise false.
+ */
+bool xIsMqttAgentConnectionConnected( MqttAgentConnectionId_t xConnection );
+
+/**
+ * @brief Take a snapshot of the command queueing statistics of one priority
+ * level of a connection.
+ *
+ * @param[in] xConnection Connection identifier.
+ * @param[in] xPriority Priority level of the command queue.
+ * @param[out] pxStats Where to copy the statistics.
+ *
+ * @return true if the statistics were copied, false for an invalid level.
+ */
+bool xGetMqttAgentCommandQueueStats( MqttAgentConnectionId_t xConnection,
+                                     AgentMessagePriority_t xPriority,
+                                     AgentMessageStats_t * pxStats );
+
 #endif /* MQTT_AGENT_H */
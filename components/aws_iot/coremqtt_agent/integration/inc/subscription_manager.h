@@ -85,7 +85,8 @@ typedef struct subscriptionElement
  *
  * @return `true` if subscription added or exists, `false` if insufficient memory.
  */
-bool addSubscription( const char * pcTopicFilterString,
+bool addSubscription( SubscriptionElement_t * pxSubscriptionList,
+                      const char * pcTopicFilterString,
                       uint16_t usTopicFilterLength,
                       IncomingPubCallback_t pxIncomingPublishCallback,
                       void * pvIncomingPublishCallbackContext );
@@ -103,7 +104,8 @@ bool addSubscription( const char * pcTopicFilterString,
  * @return `true` if subscription has been removed, `false` if the subscription
  * does not exist or deletion failed.
  */
-bool removeSubscription( const char * pcTopicFilterString,
+bool removeSubscription( SubscriptionElement_t * pxSubscriptionList,
+                         const char * pcTopicFilterString,
                          uint16_t usTopicFilterLength );
 
 /**
@@ -116,6 +118,7 @@ bool removeSubscription( const char * pcTopicFilterString,
  * @return `true` if an application callback could be invoked;
  *  `false` otherwise.
  */
-bool handleIncomingPublishes( MQTTPublishInfo_t * pxPublishInfo );
+bool handleIncomingPublishes( SubscriptionElement_t * pxSubscriptionList,
+                              MQTTPublishInfo_t * pxPublishInfo );
 
 #endif /* SUBSCRIPTION_MANAGER_H */
@@ -35,6 +35,29 @@
 #include "fff.h"
 #include "queue.h"
 
+typedef enum AgentMessagePriority
+{
+    AgentMessagePriorityHigh = 0,
+    AgentMessagePriorityNormal,
+    AgentMessagePriorityLow,
+    AgentMessagePriorityCount
+} AgentMessagePriority_t;
+
+typedef struct AgentMessageStats
+{
+    uint32_t sent;
+    uint32_t received;
+    uint32_t dropped;
+    uint32_t starvationPromotions;
+    uint32_t maxLatencyMs;
+    uint32_t totalLatencyMs;
+} AgentMessageStats_t;
+
+typedef struct AgentPriorityMessageStorage
+{
+    int dummy;
+} AgentPriorityMessageStorage_t;
+
 struct MQTTAgentMessageContext
 {
     QueueHandle_t queue;
@@ -50,5 +73,23 @@ DECLARE_FAKE_VALUE_FUNC( bool,
                          MQTTAgentMessageContext_t *,
                          MQTTAgentCommand_t **,
                          uint32_t );
+DECLARE_FAKE_VOID_FUNC( Agent_PriorityMessageInit,
+                        MQTTAgentMessageContext_t *,
+                        AgentPriorityMessageStorage_t * );
+DECLARE_FAKE_VALUE_FUNC( bool,
+                         Agent_PriorityMessageSend,
+                         MQTTAgentMessageContext_t *,
+                         MQTTAgentCommand_t * const *,
+                         uint32_t );
+DECLARE_FAKE_VALUE_FUNC( bool,
+                         Agent_PriorityMessageReceive,
+                         MQTTAgentMessageContext_t *,
+                         MQTTAgentCommand_t **,
+                         uint32_t );
+DECLARE_FAKE_VALUE_FUNC( bool,
+                         Agent_PriorityMessageGetStats,
+                         MQTTAgentMessageContext_t *,
+                         AgentMessagePriority_t,
+                         AgentMessageStats_t * );
 
 #endif /* FREERTOS_AGENT_MESSAGE_H */
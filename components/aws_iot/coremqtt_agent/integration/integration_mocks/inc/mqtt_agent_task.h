@@ -29,6 +29,9 @@
 #ifndef MQTT_AGENT_H
 #define MQTT_AGENT_H
 
+#include <stdbool.h>
+
+#include "fff.h"
 #include "core_mqtt.h"
 #include "core_mqtt_agent.h"
 #include "task.h"
@@ -40,6 +43,38 @@ struct MQTTAgentCommandContext
     void * pArgs;
 };
 
-extern MQTTAgentContext_t xGlobalMqttAgentContext;
+typedef struct MqttAgentLinkHealth
+{
+    uint32_t ulLastRttMs;
+    uint32_t ulSmoothedRttMs;
+    uint32_t ulRttSamples;
+    uint32_t ulConnectAttempts;
+    uint32_t ulConnectFailures;
+    uint32_t ulFailureRatePermille;
+    uint32_t ulKeepAliveTimeouts;
+    uint32_t ulSendFailures;
+    uint32_t ulRecvFailures;
+    uint32_t ulOtherDisconnects;
+    uint16_t usKeepAliveSeconds;
+    uint16_t usBackoffCeilingMs;
+} MqttAgentLinkHealth_t;
+
+typedef enum MqttAgentConnectionId
+{
+    eMqttAgentConnectionControl = 0,
+    eMqttAgentConnectionBulk
+} MqttAgentConnectionId_t;
+
+DECLARE_FAKE_VALUE_FUNC( MQTTAgentContext_t *,
+                         pxGetMqttAgentContext,
+                         MqttAgentConnectionId_t );
+DECLARE_FAKE_VOID_FUNC( vWaitUntilMqttAgentConnectionConnected,
+                        MqttAgentConnectionId_t );
+DECLARE_FAKE_VALUE_FUNC( bool,
+                         xIsMqttAgentConnectionConnected,
+                         MqttAgentConnectionId_t );
+
+void vGetMqttAgentLinkHealth( MqttAgentConnectionId_t xConnection,
+                              MqttAgentLinkHealth_t * pxLinkHealth );
 
 #endif /* MQTT_AGENT_H */
@@ -49,16 +49,19 @@ typedef void (* IncomingPubCallback_t)( void * pvIncomingPublishCallbackContext,
 
 DECLARE_FAKE_VALUE_FUNC( bool,
                          addSubscription,
+                         SubscriptionElement_t *,
                          const char *,
                          uint16_t,
                          IncomingPubCallback_t,
                          void * );
 DECLARE_FAKE_VOID_FUNC( removeSubscription,
+                        SubscriptionElement_t *,
                         const char *,
                         uint16_t );
 
 DECLARE_FAKE_VALUE_FUNC( bool,
                          handleIncomingPublishes,
+                         SubscriptionElement_t *,
                          MQTTPublishInfo_t * );
 
 #endif /* SUBSCRIPTION_MANAGER_H */
@@ -38,3 +38,21 @@ DEFINE_FAKE_VALUE_FUNC( bool,
                         MQTTAgentMessageContext_t *,
                         MQTTAgentCommand_t * *,
                         uint32_t );
+DEFINE_FAKE_VOID_FUNC( Agent_PriorityMessageInit,
+                       MQTTAgentMessageContext_t *,
+                       AgentPriorityMessageStorage_t * );
+DEFINE_FAKE_VALUE_FUNC( bool,
+                        Agent_PriorityMessageSend,
+                        MQTTAgentMessageContext_t *,
+                        MQTTAgentCommand_t * const *,
+                        uint32_t );
+DEFINE_FAKE_VALUE_FUNC( bool,
+                        Agent_PriorityMessageReceive,
+                        MQTTAgentMessageContext_t *,
+                        MQTTAgentCommand_t * *,
+                        uint32_t );
+DEFINE_FAKE_VALUE_FUNC( bool,
+                        Agent_PriorityMessageGetStats,
+                        MQTTAgentMessageContext_t *,
+                        AgentMessagePriority_t,
+                        AgentMessageStats_t * );
@@ -26,6 +26,14 @@
  *
  */
 
+#include "fff.h"
 #include "mqtt_agent_task.h"
 
-MQTTAgentContext_t xGlobalMqttAgentContext;
+DEFINE_FAKE_VALUE_FUNC( MQTTAgentContext_t *,
+                        pxGetMqttAgentContext,
+                        MqttAgentConnectionId_t );
+DEFINE_FAKE_VOID_FUNC( vWaitUntilMqttAgentConnectionConnected,
+                       MqttAgentConnectionId_t );
+DEFINE_FAKE_VALUE_FUNC( bool,
+                        xIsMqttAgentConnectionConnected,
+                        MqttAgentConnectionId_t );
@@ -31,16 +31,17 @@
 
 DEFINE_FAKE_VALUE_FUNC( bool,
                         addSubscription,
+                        SubscriptionElement_t *,
                         const char *,
                         uint16_t,
                         IncomingPubCallback_t,
                         void * );
 DEFINE_FAKE_VOID_FUNC( removeSubscription,
+                       SubscriptionElement_t *,
                        const char *,
                        uint16_t );
 
 DEFINE_FAKE_VALUE_FUNC( bool,
                         handleIncomingPublishes,
+                        SubscriptionElement_t *,
                         MQTTPublishInfo_t * );
-
-SubscriptionElement_t xGlobalSubscriptionList[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];
@@ -37,11 +37,55 @@
 
 /* Kernel includes. */
 #include "FreeRTOS.h"
+#include "task.h"
 
 /* Header include. */
 #include "core_mqtt_agent_message_interface.h"
+#include "core_mqtt_agent.h"
 #include "freertos_agent_message.h"
 
+/**
+ * @brief Length of #agentMessageLOW_PRIORITY_TOPIC_PREFIX without the terminator.
+ */
+#define LOW_PRIORITY_TOPIC_PREFIX_LENGTH    ( sizeof( agentMessageLOW_PRIORITY_TOPIC_PREFIX ) - 1U )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check whether a topic belongs to the low priority traffic.
+ *
+ * @param[in] pTopic Topic name or filter, not NUL terminated.
+ * @param[in] topicLength Length of the topic.
+ *
+ * @return `true` if the topic starts with #agentMessageLOW_PRIORITY_TOPIC_PREFIX.
+ */
+static bool isLowPriorityTopic( const char * pTopic,
+                                uint16_t topicLength );
+
+/**
+ * @brief Map a command onto the priority level it is queued at.
+ *
+ * Subscribes and unsubscribes are classified by topic like publishes, so
+ * that the commands of one producer stay in order in a single queue.
+ *
+ * @param[in] pCommand Command to classify.
+ *
+ * @return Priority level of the command.
+ */
+static AgentMessagePriority_t getCommandPriority( const MQTTAgentCommand_t * pCommand );
+
+/**
+ * @brief Choose the priority level to serve next.
+ *
+ * @param[in] pMsgCtx Context holding the priority queues.
+ * @param[out] pPromoted Set to `true` if the level was chosen to prevent starvation.
+ *
+ * @return Level to receive from, or #AgentMessagePriorityCount if all queues
+ * are empty.
+ */
+static AgentMessagePriority_t selectPriority( MQTTAgentMessageContext_t * pMsgCtx,
+                                              bool * pPromoted );
+
 /*-----------------------------------------------------------*/
 
 bool Agent_MessageSend( MQTTAgentMessageContext_t * pMsgCtx,
@@ -73,3 +117,276 @@ bool Agent_MessageReceive( MQTTAgentMessageContext_t * pMsgCtx,
 
     return ( queueStatus == pdPASS ) ? true : false;
 }
+
+/*-----------------------------------------------------------*/
+
+static bool isLowPriorityTopic( const char * pTopic,
+                                uint16_t topicLength )
+{
+    bool lowPriority = false;
+
+    if( ( pTopic != NULL ) && ( topicLength >= LOW_PRIORITY_TOPIC_PREFIX_LENGTH ) )
+    {
+        lowPriority = ( strncmp( pTopic,
+                                 agentMessageLOW_PRIORITY_TOPIC_PREFIX,
+                                 LOW_PRIORITY_TOPIC_PREFIX_LENGTH ) == 0 );
+    }
+
+    return lowPriority;
+}
+
+/*-----------------------------------------------------------*/
+
+static AgentMessagePriority_t getCommandPriority( const MQTTAgentCommand_t * pCommand )
+{
+    AgentMessagePriority_t priority = AgentMessagePriorityNormal;
+    const MQTTPublishInfo_t * pPublishInfo;
+    const MQTTAgentSubscribeArgs_t * pSubscribeArgs;
+
+    if( pCommand != NULL )
+    {
+        switch( pCommand->commandType )
+        {
+            case PING:
+            case CONNECT:
+            case DISCONNECT:
+            case TERMINATE:
+                priority = AgentMessagePriorityHigh;
+                break;
+
+            case PUBLISH:
+                pPublishInfo = ( const MQTTPublishInfo_t * ) pCommand->pArgs;
+
+                if( ( pPublishInfo != NULL ) &&
+                    isLowPriorityTopic( pPublishInfo->pTopicName, pPublishInfo->topicNameLength ) )
+                {
+                    priority = AgentMessagePriorityLow;
+                }
+
+                break;
+
+            case SUBSCRIBE:
+            case UNSUBSCRIBE:
+                pSubscribeArgs = ( const MQTTAgentSubscribeArgs_t * ) pCommand->pArgs;
+
+                if( ( pSubscribeArgs != NULL ) &&
+                    ( pSubscribeArgs->pSubscribeInfo != NULL ) &&
+                    ( pSubscribeArgs->numSubscriptions > 0U ) &&
+                    isLowPriorityTopic( pSubscribeArgs->pSubscribeInfo[ 0 ].pTopicFilter,
+                                        pSubscribeArgs->pSubscribeInfo[ 0 ].topicFilterLength ) )
+                {
+                    priority = AgentMessagePriorityLow;
+                }
+
+                break;
+
+            default:
+                /* Process loop requests and anything unknown. */
+                break;
+        }
+    }
+
+    return priority;
+}
+
+/*-----------------------------------------------------------*/
+
+static AgentMessagePriority_t selectPriority( MQTTAgentMessageContext_t * pMsgCtx,
+                                              bool * pPromoted )
+{
+    AgentMessagePriority_t selected = AgentMessagePriorityCount;
+    AgentMessagePriority_t starving = AgentMessagePriorityCount;
+    bool waiting[ AgentMessagePriorityCount ];
+    uint32_t level;
+
+    for( level = 0U; level < ( uint32_t ) AgentMessagePriorityCount; level++ )
+    {
+        waiting[ level ] = ( uxQueueMessagesWaiting( pMsgCtx->priorityQueue[ level ] ) > 0U );
+
+        if( waiting[ level ] )
+        {
+            if( selected == AgentMessagePriorityCount )
+            {
+                selected = ( AgentMessagePriority_t ) level;
+            }
+            else if( ( starving == AgentMessagePriorityCount ) &&
+                     ( pMsgCtx->overtaken[ level ] >= agentMessageSTARVATION_LIMIT ) )
+            {
+                starving = ( AgentMessagePriority_t ) level;
+            }
+        }
+    }
+
+    *pPromoted = ( starving != AgentMessagePriorityCount );
+
+    if( *pPromoted )
+    {
+        selected = starving;
+    }
+
+    if( selected != AgentMessagePriorityCount )
+    {
+        /* Every other level with a command waiting has been overtaken once more. */
+        for( level = 0U; level < ( uint32_t ) AgentMessagePriorityCount; level++ )
+        {
+            if( level == ( uint32_t ) selected )
+            {
+                pMsgCtx->overtaken[ level ] = 0U;
+            }
+            else if( waiting[ level ] )
+            {
+                pMsgCtx->overtaken[ level ]++;
+            }
+        }
+    }
+
+    return selected;
+}
+
+/*-----------------------------------------------------------*/
+
+void Agent_PriorityMessageInit( MQTTAgentMessageContext_t * pMsgCtx,
+                                AgentPriorityMessageStorage_t * pStorage )
+{
+    configASSERT( ( pMsgCtx != NULL ) && ( pStorage != NULL ) );
+
+    memset( pMsgCtx, 0x00, sizeof( MQTTAgentMessageContext_t ) );
+
+    pMsgCtx->priorityQueue[ AgentMessagePriorityHigh ] = xQueueCreateStatic( agentMessageHIGH_PRIORITY_QUEUE_LENGTH,
+                                                                             sizeof( AgentPriorityMessage_t ),
+                                                                             pStorage->highStorage,
+                                                                             &( pStorage->queueStructure[ AgentMessagePriorityHigh ] ) );
+    pMsgCtx->priorityQueue[ AgentMessagePriorityNormal ] = xQueueCreateStatic( agentMessageNORMAL_PRIORITY_QUEUE_LENGTH,
+                                                                               sizeof( AgentPriorityMessage_t ),
+                                                                               pStorage->normalStorage,
+                                                                               &( pStorage->queueStructure[ AgentMessagePriorityNormal ] ) );
+    pMsgCtx->priorityQueue[ AgentMessagePriorityLow ] = xQueueCreateStatic( agentMessageLOW_PRIORITY_QUEUE_LENGTH,
+                                                                            sizeof( AgentPriorityMessage_t ),
+                                                                            pStorage->lowStorage,
+                                                                            &( pStorage->queueStructure[ AgentMessagePriorityLow ] ) );
+    pMsgCtx->pending = xSemaphoreCreateCountingStatic( agentMessageHIGH_PRIORITY_QUEUE_LENGTH +
+                                                       agentMessageNORMAL_PRIORITY_QUEUE_LENGTH +
+                                                       agentMessageLOW_PRIORITY_QUEUE_LENGTH,
+                                                       0U,
+                                                       &( pStorage->pendingStructure ) );
+
+    configASSERT( pMsgCtx->priorityQueue[ AgentMessagePriorityHigh ] );
+    configASSERT( pMsgCtx->priorityQueue[ AgentMessagePriorityNormal ] );
+    configASSERT( pMsgCtx->priorityQueue[ AgentMessagePriorityLow ] );
+    configASSERT( pMsgCtx->pending );
+}
+
+/*-----------------------------------------------------------*/
+
+bool Agent_PriorityMessageSend( MQTTAgentMessageContext_t * pMsgCtx,
+                                MQTTAgentCommand_t * const * pCommandToSend,
+                                uint32_t blockTimeMs )
+{
+    BaseType_t queueStatus = pdFAIL;
+    AgentPriorityMessage_t message;
+    AgentMessagePriority_t priority;
+
+    if( ( pMsgCtx != NULL ) && ( pCommandToSend != NULL ) )
+    {
+        priority = getCommandPriority( *pCommandToSend );
+        message.pCommand = *pCommandToSend;
+        message.enqueueTime = xTaskGetTickCount();
+
+        queueStatus = xQueueSendToBack( pMsgCtx->priorityQueue[ priority ], &message, pdMS_TO_TICKS( blockTimeMs ) );
+
+        if( queueStatus == pdPASS )
+        {
+            /* The command is in its queue before the receiver is woken, so
+             * every count taken from the semaphore has a command to match. */
+            ( void ) xSemaphoreGive( pMsgCtx->pending );
+        }
+
+        taskENTER_CRITICAL();
+        {
+            if( queueStatus == pdPASS )
+            {
+                pMsgCtx->stats[ priority ].sent++;
+            }
+            else
+            {
+                pMsgCtx->stats[ priority ].dropped++;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return ( queueStatus == pdPASS ) ? true : false;
+}
+
+/*-----------------------------------------------------------*/
+
+bool Agent_PriorityMessageReceive( MQTTAgentMessageContext_t * pMsgCtx,
+                                   MQTTAgentCommand_t ** pReceivedCommand,
+                                   uint32_t blockTimeMs )
+{
+    BaseType_t queueStatus = pdFAIL;
+    AgentPriorityMessage_t message;
+    AgentMessagePriority_t priority = AgentMessagePriorityCount;
+    bool promoted = false;
+    uint32_t latencyMs;
+
+    if( ( pMsgCtx != NULL ) && ( pReceivedCommand != NULL ) &&
+        ( xSemaphoreTake( pMsgCtx->pending, pdMS_TO_TICKS( blockTimeMs ) ) == pdPASS ) )
+    {
+        /* Only the agent task receives, so the selected queue cannot be
+         * drained by anyone else before the receive below. */
+        priority = selectPriority( pMsgCtx, &promoted );
+
+        if( priority != AgentMessagePriorityCount )
+        {
+            queueStatus = xQueueReceive( pMsgCtx->priorityQueue[ priority ], &message, 0U );
+        }
+    }
+
+    if( queueStatus == pdPASS )
+    {
+        *pReceivedCommand = message.pCommand;
+        latencyMs = ( uint32_t ) TICKS_TO_pdMS( xTaskGetTickCount() - message.enqueueTime );
+
+        taskENTER_CRITICAL();
+        {
+            pMsgCtx->stats[ priority ].received++;
+            pMsgCtx->stats[ priority ].totalLatencyMs += latencyMs;
+
+            if( latencyMs > pMsgCtx->stats[ priority ].maxLatencyMs )
+            {
+                pMsgCtx->stats[ priority ].maxLatencyMs = latencyMs;
+            }
+
+            if( promoted )
+            {
+                pMsgCtx->stats[ priority ].starvationPromotions++;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return ( queueStatus == pdPASS ) ? true : false;
+}
+
+/*-----------------------------------------------------------*/
+
+bool Agent_PriorityMessageGetStats( MQTTAgentMessageContext_t * pMsgCtx,
+                                    AgentMessagePriority_t priority,
+                                    AgentMessageStats_t * pStats )
+{
+    bool statsCopied = false;
+
+    if( ( pMsgCtx != NULL ) && ( pStats != NULL ) && ( priority < AgentMessagePriorityCount ) )
+    {
+        taskENTER_CRITICAL();
+        {
+            *pStats = pMsgCtx->stats[ priority ];
+        }
+        taskEXIT_CRITICAL();
+
+        statsCopied = true;
+    }
+
+    return statsCopied;
+}
@@ -143,6 +143,36 @@
  */
 #define MQTT_AGENT_KEEP_ALIVE_INTERVAL_SECONDS       ( 100U )
 
+/**
+ * @brief Bounds for the keep-alive interval chosen by the link-health monitor.
+ *
+ * The keep-alive is halved, down to the minimum, when sessions drop early,
+ * which keeps NAT and firewall bindings alive on poor links. It is doubled, up
+ * to the maximum, after long stable sessions to cut idle PINGREQ traffic.
+ */
+#define MQTT_AGENT_KEEP_ALIVE_MIN_SECONDS            ( 30U )
+#define MQTT_AGENT_KEEP_ALIVE_MAX_SECONDS            ( 400U )
+
+/**
+ * @brief A session shorter than this many keep-alive intervals is treated as
+ * unstable, one longer than MQTT_AGENT_STABLE_SESSION_KEEP_ALIVES as stable.
+ */
+#define MQTT_AGENT_UNSTABLE_SESSION_KEEP_ALIVES      ( 2U )
+#define MQTT_AGENT_STABLE_SESSION_KEEP_ALIVES        ( 20U )
+
+/**
+ * @brief The smoothed round-trip time must be below this for the keep-alive
+ * to be lengthened.
+ */
+#define MQTT_AGENT_GOOD_LINK_RTT_MS                  ( 1000U )
+
+/**
+ * @brief Upper limit for the reconnect back-off ceiling. The ceiling is scaled
+ * between RETRY_MAX_BACKOFF_DELAY_MS and this value by the smoothed connection
+ * failure rate.
+ */
+#define MQTT_AGENT_BACKOFF_CEILING_MAX_MS            ( 60000U )
+
 /**
  * @brief Socket send and receive timeouts to use.  Specified in milliseconds.
  */
@@ -154,60 +184,114 @@
  */
 #define MQTT_AGENT_CONNACK_RECV_TIMEOUT_MS           ( 1000U )
 
-/*-----------------------------------------------------------*/
-
 /**
- * @brief Global entry time into the application to use as a reference timestamp
- * in the #prvGetTimeMs function. #prvGetTimeMs will always return the difference
- * between the current time and the global entry time. This will reduce the chances
- * of overflow for the 32 bit unsigned integer used for holding the timestamp.
+ * @brief Number of independent MQTT connections run by the agent.
+ *
+ * Each connection has its own TLS session, network buffer, command queue,
+ * subscription list and agent task, so bulk transfers on
+ * eMqttAgentConnectionBulk do not hold up control traffic on
+ * eMqttAgentConnectionControl. Connections other than the first append
+ * "-<index>" to democonfigCLIENT_IDENTIFIER, which the broker policy must
+ * allow. With a single connection every connection identifier maps onto it.
+ *
+ * At most one connection per MqttAgentConnectionId_t is supported, each one
+ * reports its state through its own system event bit.
  */
-static uint32_t ulGlobalEntryTimeMs;
+#ifndef appCONFIG_MQTT_AGENT_NUM_CONNECTIONS
+    #define appCONFIG_MQTT_AGENT_NUM_CONNECTIONS     ( 1U )
+#endif
+
+#if ( appCONFIG_MQTT_AGENT_NUM_CONNECTIONS < 1U ) || ( appCONFIG_MQTT_AGENT_NUM_CONNECTIONS > 2U )
+    #error "appCONFIG_MQTT_AGENT_NUM_CONNECTIONS must be 1 or 2, the control and the bulk connections."
+#endif
 
 /**
- * @brief The buffer is used to hold the serialized packets for transmission to and from
- * the transport interface.
+ * @brief Priority of the agent tasks serving connections other than the
+ * control connection.
  */
-static uint8_t xNetworkBuffer[ MQTT_AGENT_NETWORK_BUFFER_SIZE ];
+#ifndef appCONFIG_MQTT_AGENT_BULK_TASK_PRIORITY
+    #define appCONFIG_MQTT_AGENT_BULK_TASK_PRIORITY    appCONFIG_MQTT_AGENT_TASK_PRIORITY
+#endif
 
 /**
- * @brief FreeRTOS blocking queue to be used as MQTT Agent context.
+ * @brief Size of the buffer holding a connection's MQTT client identifier.
  */
-static MQTTAgentMessageContext_t xCommandQueue;
+#define MQTT_AGENT_CLIENT_IDENTIFIER_BUFFER_SIZE     ( 128U )
+
+/*-----------------------------------------------------------*/
 
 /**
- * @brief The network context used by the MQTT library transport interface.
- * See https://www.freertos.org/network-interface.html
+ * @brief Position in the MQTT packets of one direction of a connection. The
+ * transport is called with whatever chunks coreMQTT or the TLS records make,
+ * so packets are followed byte by byte to learn the type and the packet
+ * identifier of each one.
  */
-static NetworkContext_t xNetworkContextMqtt;
+typedef struct MqttPacketStream
+{
+    uint32_t ulRemainingLength;  /*!< Bytes of the packet after the fixed header. */
+    uint32_t ulLengthMultiplier; /*!< Weight of the next remaining length byte, 0 once the length is known. */
+    uint32_t ulOffset;           /*!< Bytes after the fixed header seen so far. */
+    uint16_t usTopicLength;      /*!< Length of the topic of a PUBLISH. */
+    uint16_t usPacketId;         /*!< Packet identifier, once read. */
+    uint8_t ucPacketType;        /*!< First byte of the packet, 0 between packets. */
+} MqttPacketStream_t;
 
 /**
- * @brief MQTT CONNECT packet parameters.
+ * @brief State owned by one MQTT connection of the agent.
  */
-static MQTTConnectInfo_t xConnectInfo = { 0 };
+typedef struct MqttAgentConnection
+{
+    MQTTAgentContext_t xAgentContext;                                                  /*!< coreMQTT-Agent context. */
+    MQTTAgentMessageContext_t xCommandQueue;                                           /*!< Priority command queues feeding the agent. */
+    AgentPriorityMessageStorage_t xCommandQueueStorage;                                /*!< Storage for the priority command queues. */
+    uint8_t ucNetworkBuffer[ MQTT_AGENT_NETWORK_BUFFER_SIZE ];                         /*!< Serialized packets to and from the transport. */
+    NetworkContext_t xNetworkContext;                                                  /*!< Transport used by the connection. */
+    MQTTConnectInfo_t xConnectInfo;                                                    /*!< MQTT CONNECT packet parameters. */
+    char cClientIdentifier[ MQTT_AGENT_CLIENT_IDENTIFIER_BUFFER_SIZE ];                /*!< Client identifier sent in CONNECT. */
+    SubscriptionElement_t xSubscriptionList[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ]; /*!< Subscriptions carried by the connection. */
+    MQTTAgentSubscribeArgs_t xResubscribeArgs;                                         /*!< Resubscribe command arguments. */
+    MQTTSubscribeInfo_t xResubscribeInfo[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];    /*!< Topic filters being resubscribed. */
+    MQTTAgentCommandInfo_t xResubscribeCommandParams;                                  /*!< Resubscribe command parameters. */
+    MqttAgentLinkHealth_t xLinkHealth;                                                 /*!< Link-health telemetry. */
+    MqttPacketStream_t xSentPackets;                                                   /*!< Packets sent to the broker. */
+    MqttPacketStream_t xReceivedPackets;                                               /*!< Packets received from the broker. */
+    uint32_t ulRttProbeSentMs;                                                         /*!< Send time of the outstanding round-trip probe. */
+    uint16_t usRttProbePacketId;                                                       /*!< Packet identifier the probe's response carries, 0 for none. */
+    uint8_t ucRttProbeResponse;                                                        /*!< First byte of the response ending the probe. */
+    bool xRttProbePending;                                                             /*!< Set while a round-trip probe is outstanding. */
+} MqttAgentConnection_t;
 
 /*-----------------------------------------------------------*/
 
 /**
- * @brief Static handle used for MQTT agent context.
+ * @brief Global entry time into the application to use as a reference timestamp
+ * in the #prvGetTimeMs function. #prvGetTimeMs will always return the difference
+ * between the current time and the global entry time. This will reduce the chances
+ * of overflow for the 32 bit unsigned integer used for holding the timestamp.
  */
-MQTTAgentContext_t xGlobalMqttAgentContext;
+static uint32_t ulGlobalEntryTimeMs;
 
-/*-----------------------------------------------------------*/
+/**
+ * @brief The MQTT connections run by the agent. Each connection is only
+ * written by its own agent task, apart from the subscription lists which the
+ * subscription manager updates from one task at a time. The subscription
+ * manager expects the lists to be initialized to 0, which static storage
+ * guarantees.
+ */
+static MqttAgentConnection_t xConnections[ appCONFIG_MQTT_AGENT_NUM_CONNECTIONS ];
 
 /**
- * @brief The global array of subscription elements.
- *
- * @note No thread safety is required to this array, since the updates the array
- * elements are done only from one task at a time. The subscription manager
- * implementation expects that the array of the subscription elements used for
- * storing subscriptions to be initialized to 0. As this is a global array, it
- * will be intialized to 0 by default.
+ * @brief Number of connections whose agent context has been initialized.
  */
-extern SubscriptionElement_t xGlobalSubscriptionList[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];
+static UBaseType_t uxInitializedConnections = 0U;
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Look up the TLS client credentials ahead of the first connection.
+ */
+STATIC void prvLoadTlsCredentials( void );
+
 /**
  * @brief Retry logic to establish a connection to the MQTT broker.
  *
@@ -223,26 +307,31 @@ STATIC BaseType_t prvSocketConnect( NetworkContext_t * pxNetworkContext );
  * @brief Initializes an MQTT context, including transport interface and
  * network buffer.
  *
+ * @param[in] uxConnection Index of the connection to initialize.
+ *
  * @return `MQTTSuccess` if the initialization succeeds, else `MQTTBadParameter`.
  */
-STATIC MQTTStatus_t prvMQTTInit( void );
+STATIC MQTTStatus_t prvMQTTInit( UBaseType_t uxConnection );
 
 /**
  * @brief Sends an MQTT Connect packet over the already connected TCP socket.
- * This function takes no inputs, but does rely on the global 'xConnectInfo'
- * variable, which contains information such as passwords and user identifiers,
- * and whether to start a clean MQTT session.
+ * Relies on the connection's 'xConnectInfo', which contains information such
+ * as passwords and user identifiers, and whether to start a clean MQTT session.
+ *
+ * @param[in] uxConnection Index of the connection to connect.
  *
  * @return `MQTTSuccess` if connection succeeds, else appropriate error code
  * from MQTT_Connect.
  */
-STATIC MQTTStatus_t prvMQTTConnect( void );
+STATIC MQTTStatus_t prvMQTTConnect( UBaseType_t uxConnection );
 
 /**
  * @brief Disconnects from the MQTT broker.
  * Initiates an MQTT disconnect and then teardown underlying TCP connection.
+ *
+ * @param[in] uxConnection Index of the connection to disconnect.
  */
-STATIC void prvDisconnectFromMQTTBroker( void );
+STATIC void prvDisconnectFromMQTTBroker( UBaseType_t uxConnection );
 
 /**
  * @brief Task for MQTT agent.
@@ -250,10 +339,97 @@ STATIC void prvDisconnectFromMQTTBroker( void );
  * MQTT, terminates agent, or the MQTT connection is broken. If the MQTT connection is broken, the task
  * tries to reconnect to the broker.
  *
- * @param[in] pParam Can be used to pass down functionality to the agent task
+ * @param[in] pParam Index of the connection served by the task, cast to a pointer.
  */
 STATIC void prvMQTTAgentTask( void * pParam );
 
+/**
+ * @brief Transport send and receive wrappers that time requests expecting a
+ * response from the broker.
+ */
+STATIC int32_t prvTransportSend( NetworkContext_t * pxNetworkContext,
+                                 const void * pvBuffer,
+                                 size_t xBytesToSend );
+STATIC int32_t prvTransportRecv( NetworkContext_t * pxNetworkContext,
+                                 void * pvBuffer,
+                                 size_t xBytesToRecv );
+
+/**
+ * @brief Follow bytes of a packet stream and pass each packet to
+ * prvLinkHealthRecordPacket() once its type, and its packet identifier if it
+ * has one, are known.
+ *
+ * @param[in] pxConnection The connection the bytes went over.
+ * @param[in] xSent true for bytes sent to the broker.
+ * @param[in] pucData The bytes.
+ * @param[in] xLength Number of bytes.
+ */
+STATIC void prvPacketStreamProcess( MqttAgentConnection_t * pxConnection,
+                                    bool xSent,
+                                    const uint8_t * pucData,
+                                    size_t xLength );
+
+/**
+ * @brief Start a round-trip probe on a request the broker answers, or end it
+ * on the response to the probed request.
+ *
+ * @param[in] pxConnection The connection the packet went over.
+ * @param[in] xSent true for a packet sent to the broker.
+ * @param[in] ucPacketType First byte of the packet.
+ * @param[in] usPacketId Packet identifier, 0 for packets without one.
+ */
+STATIC void prvLinkHealthRecordPacket( MqttAgentConnection_t * pxConnection,
+                                       bool xSent,
+                                       uint8_t ucPacketType,
+                                       uint16_t usPacketId );
+
+/**
+ * @brief Forget the packets and the probe of a previous transport connection.
+ */
+STATIC void prvPacketStreamsReset( MqttAgentConnection_t * pxConnection );
+
+/**
+ * @brief Account for a connection attempt and raise or lower the reconnect
+ * back-off ceiling based on the smoothed failure rate.
+ *
+ * @param[in] uxConnection Index of the connection attempted.
+ * @param[in] xConnected pdPASS if the TLS and MQTT connection succeeded.
+ */
+STATIC void prvLinkHealthRecordConnect( UBaseType_t uxConnection,
+                                        BaseType_t xConnected );
+
+/**
+ * @brief Account for the end of an MQTT session and pick the keep-alive
+ * interval for the next one.
+ *
+ * @param[in] uxConnection Index of the connection that dropped.
+ * @param[in] xStatus Status MQTTAgent_CommandLoop() returned with.
+ * @param[in] ulSessionMs How long the session lasted.
+ */
+STATIC void prvLinkHealthRecordDisconnect( UBaseType_t uxConnection,
+                                           MQTTStatus_t xStatus,
+                                           uint32_t ulSessionMs );
+
+/**
+ * @brief Map a connection identifier onto an existing connection. Identifiers
+ * beyond the configured number of connections share the control connection.
+ */
+STATIC UBaseType_t prvConnectionIndex( MqttAgentConnectionId_t xConnection );
+
+/**
+ * @brief System event bit set while a connection is connected to the broker.
+ * The control connection uses EVENT_MASK_MQTT_CONNECTED, the bulk connection
+ * EVENT_MASK_MQTT_BULK_CONNECTED.
+ */
+STATIC EventBits_t prvConnectedEventMask( UBaseType_t uxConnection );
+
+/**
+ * @brief Find the connection owning a network or agent context. Unknown
+ * contexts are attributed to the control connection.
+ */
+STATIC MqttAgentConnection_t * prvConnectionFromNetworkContext( NetworkContext_t * pxNetworkContext );
+STATIC MqttAgentConnection_t * prvConnectionFromAgentContext( MQTTAgentContext_t * pxAgentContext );
+
 /*-----------------------------------------------------------*/
 
 STATIC uint32_t prvGetTimeMs( void )
@@ -291,6 +467,373 @@ STATIC UBaseType_t prvGetRandomNumber( void )
     return uxRandomValue;
 }
 
+STATIC UBaseType_t prvConnectionIndex( MqttAgentConnectionId_t xConnection )
+{
+    UBaseType_t uxConnection = ( UBaseType_t ) xConnection;
+
+    if( uxConnection >= appCONFIG_MQTT_AGENT_NUM_CONNECTIONS )
+    {
+        uxConnection = ( UBaseType_t ) eMqttAgentConnectionControl;
+    }
+
+    return uxConnection;
+}
+
+STATIC EventBits_t prvConnectedEventMask( UBaseType_t uxConnection )
+{
+    return ( uxConnection == ( UBaseType_t ) eMqttAgentConnectionControl ) ? EVENT_MASK_MQTT_CONNECTED : EVENT_MASK_MQTT_BULK_CONNECTED;
+}
+
+STATIC MqttAgentConnection_t * prvConnectionFromNetworkContext( NetworkContext_t * pxNetworkContext )
+{
+    MqttAgentConnection_t * pxConnection = &( xConnections[ eMqttAgentConnectionControl ] );
+    UBaseType_t uxConnection;
+
+    for( uxConnection = 0U; uxConnection < appCONFIG_MQTT_AGENT_NUM_CONNECTIONS; uxConnection++ )
+    {
+        if( pxNetworkContext == &( xConnections[ uxConnection ].xNetworkContext ) )
+        {
+            pxConnection = &( xConnections[ uxConnection ] );
+            break;
+        }
+    }
+
+    return pxConnection;
+}
+
+STATIC MqttAgentConnection_t * prvConnectionFromAgentContext( MQTTAgentContext_t * pxAgentContext )
+{
+    MqttAgentConnection_t * pxConnection = &( xConnections[ eMqttAgentConnectionControl ] );
+    UBaseType_t uxConnection;
+
+    for( uxConnection = 0U; uxConnection < appCONFIG_MQTT_AGENT_NUM_CONNECTIONS; uxConnection++ )
+    {
+        if( pxAgentContext == &( xConnections[ uxConnection ].xAgentContext ) )
+        {
+            pxConnection = &( xConnections[ uxConnection ] );
+            break;
+        }
+    }
+
+    return pxConnection;
+}
+
+STATIC void prvLinkHealthRecordRtt( MqttAgentConnection_t * pxConnection,
+                                    uint32_t ulRttMs )
+{
+    MqttAgentLinkHealth_t * pxLinkHealth = &( pxConnection->xLinkHealth );
+
+    taskENTER_CRITICAL();
+    {
+        pxLinkHealth->ulLastRttMs = ulRttMs;
+
+        if( pxLinkHealth->ulRttSamples == 0U )
+        {
+            pxLinkHealth->ulSmoothedRttMs = ulRttMs;
+        }
+        else
+        {
+            /* Same 1/8 gain TCP uses for its smoothed round-trip time. */
+            pxLinkHealth->ulSmoothedRttMs = ( ( 7U * pxLinkHealth->ulSmoothedRttMs ) + ulRttMs ) / 8U;
+        }
+
+        pxLinkHealth->ulRttSamples++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+STATIC void prvLinkHealthRecordConnect( UBaseType_t uxConnection,
+                                        BaseType_t xConnected )
+{
+    MqttAgentLinkHealth_t * pxLinkHealth = &( xConnections[ uxConnection ].xLinkHealth );
+    uint32_t ulCeilingMs;
+
+    taskENTER_CRITICAL();
+    {
+        pxLinkHealth->ulConnectAttempts++;
+
+        if( xConnected == pdPASS )
+        {
+            pxLinkHealth->ulFailureRatePermille = ( 7U * pxLinkHealth->ulFailureRatePermille ) / 8U;
+        }
+        else
+        {
+            pxLinkHealth->ulConnectFailures++;
+            pxLinkHealth->ulFailureRatePermille = ( ( 7U * pxLinkHealth->ulFailureRatePermille ) + 1000U ) / 8U;
+        }
+
+        ulCeilingMs = RETRY_MAX_BACKOFF_DELAY_MS +
+                      ( ( ( MQTT_AGENT_BACKOFF_CEILING_MAX_MS - RETRY_MAX_BACKOFF_DELAY_MS ) *
+                          pxLinkHealth->ulFailureRatePermille ) / 1000U );
+        pxLinkHealth->usBackoffCeilingMs = ( uint16_t ) ulCeilingMs;
+    }
+    taskEXIT_CRITICAL();
+}
+
+STATIC void prvLinkHealthRecordDisconnect( UBaseType_t uxConnection,
+                                           MQTTStatus_t xStatus,
+                                           uint32_t ulSessionMs )
+{
+    MqttAgentConnection_t * pxConnection = &( xConnections[ uxConnection ] );
+    MqttAgentLinkHealth_t * pxLinkHealth = &( pxConnection->xLinkHealth );
+    uint32_t ulKeepAliveMs = ( uint32_t ) pxLinkHealth->usKeepAliveSeconds * 1000U;
+    uint16_t usKeepAliveSeconds = pxLinkHealth->usKeepAliveSeconds;
+
+    /* A missing PINGRESP or a session that did not survive a couple of
+     * keep-alive periods suggests an idle timeout in the path, so ping more
+     * often. A long session on a responsive link can afford to ping less. */
+    if( ( xStatus == MQTTKeepAliveTimeout ) ||
+        ( ulSessionMs < ( MQTT_AGENT_UNSTABLE_SESSION_KEEP_ALIVES * ulKeepAliveMs ) ) )
+    {
+        usKeepAliveSeconds /= 2U;
+
+        if( usKeepAliveSeconds < MQTT_AGENT_KEEP_ALIVE_MIN_SECONDS )
+        {
+            usKeepAliveSeconds = MQTT_AGENT_KEEP_ALIVE_MIN_SECONDS;
+        }
+    }
+    else if( ( ulSessionMs >= ( MQTT_AGENT_STABLE_SESSION_KEEP_ALIVES * ulKeepAliveMs ) ) &&
+             ( pxLinkHealth->ulSmoothedRttMs < MQTT_AGENT_GOOD_LINK_RTT_MS ) )
+    {
+        usKeepAliveSeconds *= 2U;
+
+        if( usKeepAliveSeconds > MQTT_AGENT_KEEP_ALIVE_MAX_SECONDS )
+        {
+            usKeepAliveSeconds = MQTT_AGENT_KEEP_ALIVE_MAX_SECONDS;
+        }
+    }
+
+    taskENTER_CRITICAL();
+    {
+        switch( xStatus )
+        {
+            case MQTTKeepAliveTimeout:
+                pxLinkHealth->ulKeepAliveTimeouts++;
+                break;
+
+            case MQTTSendFailed:
+                pxLinkHealth->ulSendFailures++;
+                break;
+
+            case MQTTRecvFailed:
+                pxLinkHealth->ulRecvFailures++;
+                break;
+
+            default:
+                pxLinkHealth->ulOtherDisconnects++;
+                break;
+        }
+
+        pxLinkHealth->usKeepAliveSeconds = usKeepAliveSeconds;
+    }
+    taskEXIT_CRITICAL();
+
+    /* A probe still outstanding will never be answered on this connection. */
+    prvPacketStreamsReset( pxConnection );
+
+    LogInfo( ( "MQTT connection %u session lasted %u ms, smoothed RTT %u ms. "
+               "Next keep-alive %u s, back-off ceiling %u ms.",
+               ( unsigned int ) uxConnection,
+               ( unsigned int ) ulSessionMs,
+               ( unsigned int ) pxLinkHealth->ulSmoothedRttMs,
+               ( unsigned int ) usKeepAliveSeconds,
+               ( unsigned int ) pxLinkHealth->usBackoffCeilingMs ) );
+}
+
+/* Packets carrying a packet identifier the RTT probes need. */
+#define mqttPACKET_HAS_ID( ucType )                            \
+    ( ( ( ( ucType ) & 0xF0U ) == 0x40U ) || /* PUBACK */      \
+      ( ( ( ucType ) & 0xF0U ) == 0x80U ) || /* SUBSCRIBE */   \
+      ( ( ( ucType ) & 0xF0U ) == 0x90U ) || /* SUBACK */      \
+      ( ( ( ucType ) & 0xF0U ) == 0xA0U ) || /* UNSUBSCRIBE */ \
+      ( ( ( ucType ) & 0xF0U ) == 0xB0U ) || /* UNSUBACK */    \
+      ( ( ( ucType ) & 0xF6U ) == 0x32U ) )  /* PUBLISH QoS1 */
+
+STATIC void prvLinkHealthRecordPacket( MqttAgentConnection_t * pxConnection,
+                                       bool xSent,
+                                       uint8_t ucPacketType,
+                                       uint16_t usPacketId )
+{
+    uint8_t ucResponse = 0U;
+
+    if( xSent == false )
+    {
+        if( ( pxConnection->xRttProbePending == true ) &&
+            ( ucPacketType == pxConnection->ucRttProbeResponse ) &&
+            ( usPacketId == pxConnection->usRttProbePacketId ) )
+        {
+            pxConnection->xRttProbePending = false;
+            prvLinkHealthRecordRtt( pxConnection, prvGetTimeMs() - pxConnection->ulRttProbeSentMs );
+        }
+    }
+    else if( pxConnection->xRttProbePending == false )
+    {
+        if( ucPacketType == 0xC0U ) /* PINGREQ */
+        {
+            ucResponse = 0xD0U;     /* PINGRESP */
+        }
+        else if( ucPacketType == 0x10U ) /* CONNECT */
+        {
+            ucResponse = 0x20U;          /* CONNACK */
+        }
+        else if( ucPacketType == 0x82U ) /* SUBSCRIBE */
+        {
+            ucResponse = 0x90U;          /* SUBACK */
+        }
+        else if( ucPacketType == 0xA2U ) /* UNSUBSCRIBE */
+        {
+            ucResponse = 0xB0U;          /* UNSUBACK */
+        }
+        else if( ( ucPacketType & 0xF6U ) == 0x32U ) /* PUBLISH QoS1, any DUP and RETAIN */
+        {
+            ucResponse = 0x40U;                      /* PUBACK */
+        }
+
+        if( ucResponse != 0U )
+        {
+            pxConnection->ucRttProbeResponse = ucResponse;
+            pxConnection->usRttProbePacketId = usPacketId;
+            pxConnection->ulRttProbeSentMs = prvGetTimeMs();
+            pxConnection->xRttProbePending = true;
+        }
+    }
+}
+
+STATIC void prvPacketStreamProcess( MqttAgentConnection_t * pxConnection,
+                                    bool xSent,
+                                    const uint8_t * pucData,
+                                    size_t xLength )
+{
+    MqttPacketStream_t * pxStream = xSent ? &( pxConnection->xSentPackets ) : &( pxConnection->xReceivedPackets );
+    uint32_t ulIdOffset;
+    size_t xIndex;
+    uint8_t ucByte;
+
+    for( xIndex = 0U; xIndex < xLength; xIndex++ )
+    {
+        ucByte = pucData[ xIndex ];
+
+        if( pxStream->ucPacketType == 0U )
+        {
+            /* Fixed header: packet type and flags, 0 is not a valid one. */
+            ( void ) memset( pxStream, 0, sizeof( *pxStream ) );
+            pxStream->ucPacketType = ucByte;
+            pxStream->ulLengthMultiplier = 1U;
+            continue;
+        }
+
+        if( pxStream->ulLengthMultiplier != 0U )
+        {
+            /* Fixed header: remaining length, at most 4 bytes of 7 bits. */
+            pxStream->ulRemainingLength += ( ( uint32_t ) ucByte & 0x7FU ) * pxStream->ulLengthMultiplier;
+            pxStream->ulLengthMultiplier *= 128U;
+
+            if( ( ( ucByte & 0x80U ) == 0U ) || ( pxStream->ulLengthMultiplier > ( 128U * 128U * 128U ) ) )
+            {
+                pxStream->ulLengthMultiplier = 0U;
+
+                if( !mqttPACKET_HAS_ID( pxStream->ucPacketType ) )
+                {
+                    prvLinkHealthRecordPacket( pxConnection, xSent, pxStream->ucPacketType, 0U );
+                }
+            }
+        }
+        else
+        {
+            /* Variable header. A PUBLISH carries its packet identifier
+             * after the topic, the others first. */
+            if( ( pxStream->ucPacketType & 0xF0U ) == 0x30U )
+            {
+                if( pxStream->ulOffset < 2U )
+                {
+                    pxStream->usTopicLength = ( uint16_t ) ( ( pxStream->usTopicLength << 8 ) | ucByte );
+                }
+
+                ulIdOffset = 2U + pxStream->usTopicLength;
+            }
+            else
+            {
+                ulIdOffset = 0U;
+            }
+
+            if( mqttPACKET_HAS_ID( pxStream->ucPacketType ) &&
+                ( pxStream->ulOffset >= ulIdOffset ) &&
+                ( pxStream->ulOffset < ( ulIdOffset + 2U ) ) )
+            {
+                pxStream->usPacketId = ( uint16_t ) ( ( pxStream->usPacketId << 8 ) | ucByte );
+
+                if( pxStream->ulOffset == ( ulIdOffset + 1U ) )
+                {
+                    prvLinkHealthRecordPacket( pxConnection, xSent, pxStream->ucPacketType, pxStream->usPacketId );
+                }
+            }
+
+            pxStream->ulOffset++;
+        }
+
+        if( ( pxStream->ulLengthMultiplier == 0U ) && ( pxStream->ulOffset >= pxStream->ulRemainingLength ) )
+        {
+            pxStream->ucPacketType = 0U;
+        }
+    }
+}
+
+STATIC void prvPacketStreamsReset( MqttAgentConnection_t * pxConnection )
+{
+    ( void ) memset( &( pxConnection->xSentPackets ), 0, sizeof( pxConnection->xSentPackets ) );
+    ( void ) memset( &( pxConnection->xReceivedPackets ), 0, sizeof( pxConnection->xReceivedPackets ) );
+    pxConnection->xRttProbePending = false;
+}
+
+STATIC int32_t prvTransportSend( NetworkContext_t * pxNetworkContext,
+                                 const void * pvBuffer,
+                                 size_t xBytesToSend )
+{
+    MqttAgentConnection_t * pxConnection = prvConnectionFromNetworkContext( pxNetworkContext );
+    int32_t lBytesSent;
+
+    lBytesSent = Transport_Send( pxNetworkContext, pvBuffer, xBytesToSend );
+
+    if( lBytesSent > 0 )
+    {
+        prvPacketStreamProcess( pxConnection, true, ( const uint8_t * ) pvBuffer, ( size_t ) lBytesSent );
+    }
+
+    return lBytesSent;
+}
+
+STATIC int32_t prvTransportRecv( NetworkContext_t * pxNetworkContext,
+                                 void * pvBuffer,
+                                 size_t xBytesToRecv )
+{
+    MqttAgentConnection_t * pxConnection = prvConnectionFromNetworkContext( pxNetworkContext );
+    int32_t lBytesReceived;
+
+    lBytesReceived = Transport_Recv( pxNetworkContext, pvBuffer, xBytesToRecv );
+
+    if( lBytesReceived > 0 )
+    {
+        prvPacketStreamProcess( pxConnection, false, ( const uint8_t * ) pvBuffer, ( size_t ) lBytesReceived );
+    }
+
+    return lBytesReceived;
+}
+
+STATIC void prvLoadTlsCredentials( void )
+{
+    TLSParams_t xTLSParams = { 0 };
+
+    xTLSParams.pClientCertLabel = pkcs11configLABEL_DEVICE_CERTIFICATE_FOR_TLS;
+    xTLSParams.pPrivateKeyLabel = pkcs11configLABEL_DEVICE_PRIVATE_KEY_FOR_TLS;
+    xTLSParams.pLoginPIN = configPKCS11_DEFAULT_USER_PIN;
+
+    /* The handshake looks the credentials up itself if this fails. */
+    if( Transport_LoadCredentials( &xTLSParams ) != TRANSPORT_STATUS_SUCCESS )
+    {
+        LogWarn( ( "TLS credentials could not be loaded ahead of the connection." ) );
+    }
+}
+
 STATIC BaseType_t prvSocketConnect( NetworkContext_t * pxNetworkContext )
 {
     BaseType_t xConnected = pdFAIL;
@@ -346,6 +889,9 @@ STATIC BaseType_t prvSocketConnect( NetworkContext_t * pxNetworkContext )
 
     if( xConnected )
     {
+        /* The packets of a new transport connection start afresh. */
+        prvPacketStreamsReset( prvConnectionFromNetworkContext( pxNetworkContext ) );
+
         LogInfo( ( "Successfully created a TLS connection to %s:%d.",
                    democonfigMQTT_BROKER_ENDPOINT,
                    democonfigMQTT_BROKER_PORT ) );
@@ -364,7 +910,9 @@ STATIC BaseType_t prvSocketDisconnect( NetworkContext_t * pxNetworkContext )
     if( Transport_Disconnect( pxNetworkContext ) == TRANSPORT_STATUS_SUCCESS )
     {
         xDisconnected = pdPASS;
-        ( void ) xEventGroupClearBits( xSystemEvents, EVENT_MASK_MQTT_CONNECTED );
+
+        ( void ) xEventGroupClearBits( xSystemEvents,
+                                       prvConnectedEventMask( ( UBaseType_t ) ( prvConnectionFromNetworkContext( pxNetworkContext ) - xConnections ) ) );
     }
 
     return xDisconnected;
@@ -374,27 +922,24 @@ STATIC void prvIncomingPublishCallback( MQTTAgentContext_t * pMqttAgentContext,
                                         uint16_t packetId,
                                         MQTTPublishInfo_t * pxPublishInfo )
 {
+    MqttAgentConnection_t * pxConnection = prvConnectionFromAgentContext( pMqttAgentContext );
     bool xPublishHandled = false;
 
     ( void ) packetId;
 
     /* Fan out the incoming publishes to the callbacks registered using
-     * subscription manager. */
-    xPublishHandled = handleIncomingPublishes( pxPublishInfo );
+     * subscription manager on the connection the publish arrived on. */
+    xPublishHandled = handleIncomingPublishes( pxConnection->xSubscriptionList, pxPublishInfo );
 
     /* If there are no callbacks to handle the incoming publishes,
      * handle it as an unsolicited publish. */
     if( xPublishHandled != true )
     {
-        /* Ensure the topic string is terminated for printing.  This will over-
-         * write the message ID, which is restored afterwards. */
-        char * pcLocation = ( char * ) &( pxPublishInfo->pTopicName[ pxPublishInfo->topicNameLength ] );
-        char cOriginalChar = *pcLocation;
-        /* Copy to safe buffer for printing. */
-        char printBuffer[ pxPublishInfo->topicNameLength + 1 ];
-        memcpy( printBuffer, &( pxPublishInfo->pTopicName ), pxPublishInfo->topicNameLength );
-        printBuffer[ pxPublishInfo->topicNameLength ] = 0x00; /* ends in '\0' */
-        LogWarn( ( "Received an unsolicited publish from topic %s", printBuffer ) );
+        /* The topic is not terminated, print it in place from the network
+         * buffer rather than copying it out. */
+        LogWarn( ( "Received an unsolicited publish from topic %.*s",
+                   pxPublishInfo->topicNameLength,
+                   pxPublishInfo->pTopicName ) );
     }
 }
 
@@ -402,6 +947,8 @@ STATIC void prvReSubscriptionCommandCallback( MQTTAgentCommandContext_t * pxComm
                                               MQTTAgentReturnInfo_t * pxReturnInfo )
 {
     MQTTAgentSubscribeArgs_t * pxSubscribeArgs = ( MQTTAgentSubscribeArgs_t * ) pxCommandContext;
+    MqttAgentConnection_t * pxConnection;
+    UBaseType_t uxConnection;
 
     /* If the return code is success, no further action is required as all the topic filters
      * are already part of the subscription list. */
@@ -409,6 +956,17 @@ STATIC void prvReSubscriptionCommandCallback( MQTTAgentCommandContext_t * pxComm
     {
         size_t xIndex;
 
+        /* The arguments are embedded in the connection they resubscribe. */
+        pxConnection = &( xConnections[ eMqttAgentConnectionControl ] );
+
+        for( uxConnection = 0U; uxConnection < appCONFIG_MQTT_AGENT_NUM_CONNECTIONS; uxConnection++ )
+        {
+            if( pxSubscribeArgs == &( xConnections[ uxConnection ].xResubscribeArgs ) )
+            {
+                pxConnection = &( xConnections[ uxConnection ] );
+            }
+        }
+
         /* Check through each of the suback codes and determine if there are any failures. */
         for( xIndex = 0; xIndex < pxSubscribeArgs->numSubscriptions; xIndex++ )
         {
@@ -419,7 +977,8 @@ STATIC void prvReSubscriptionCommandCallback( MQTTAgentCommandContext_t * pxComm
                             pxSubscribeArgs->pSubscribeInfo[ xIndex ].topicFilterLength,
                             pxSubscribeArgs->pSubscribeInfo[ xIndex ].pTopicFilter ) );
                 /* Remove subscription callback for unsubscribe. */
-                removeSubscription( pxSubscribeArgs->pSubscribeInfo[ xIndex ].pTopicFilter,
+                removeSubscription( pxConnection->xSubscriptionList,
+                                    pxSubscribeArgs->pSubscribeInfo[ xIndex ].pTopicFilter,
                                     pxSubscribeArgs->pSubscribeInfo[ xIndex ].topicFilterLength );
             }
         }
@@ -430,40 +989,41 @@ STATIC void prvReSubscriptionCommandCallback( MQTTAgentCommandContext_t * pxComm
     }
 }
 
-STATIC MQTTStatus_t prvMQTTInit( void )
+STATIC MQTTStatus_t prvMQTTInit( UBaseType_t uxConnection )
 {
+    MqttAgentConnection_t * pxConnection = &( xConnections[ uxConnection ] );
     TransportInterface_t xTransport = { 0 };
     MQTTStatus_t xReturn;
-    MQTTFixedBuffer_t xFixedBuffer = { .pBuffer = xNetworkBuffer, .size = MQTT_AGENT_NETWORK_BUFFER_SIZE };
-    static uint8_t staticQueueStorageArea[ MQTT_AGENT_COMMAND_QUEUE_LENGTH * sizeof( MQTTAgentCommand_t * ) ];
-    static StaticQueue_t staticQueueStructure;
+    MQTTFixedBuffer_t xFixedBuffer = { .pBuffer = pxConnection->ucNetworkBuffer, .size = MQTT_AGENT_NETWORK_BUFFER_SIZE };
+    UBaseType_t uxInitialized;
     MQTTAgentMessageInterface_t messageInterface =
     {
         .pMsgCtx        = NULL,
-        .send           = Agent_MessageSend,
-        .recv           = Agent_MessageReceive,
+        .send           = Agent_PriorityMessageSend,
+        .recv           = Agent_PriorityMessageReceive,
         .getCommand     = Agent_GetCommand,
         .releaseCommand = Agent_ReleaseCommand
     };
 
-    LogDebug( ( "Creating command queue." ) );
-    xCommandQueue.queue = xQueueCreateStatic( MQTT_AGENT_COMMAND_QUEUE_LENGTH,
-                                              sizeof( MQTTAgentCommand_t * ),
-                                              staticQueueStorageArea,
-                                              &staticQueueStructure );
-    configASSERT( xCommandQueue.queue );
-    messageInterface.pMsgCtx = &xCommandQueue;
+    LogDebug( ( "Creating command queues." ) );
+    Agent_PriorityMessageInit( &( pxConnection->xCommandQueue ), &( pxConnection->xCommandQueueStorage ) );
+    messageInterface.pMsgCtx = &( pxConnection->xCommandQueue );
 
-    /* Initialize the task pool. */
+    /* Initialize the task pool. The pool is shared by all connections and only
+     * initialized once. */
     Agent_InitializePool();
 
+    /* Each connection starts from the default keep-alive and back-off ceiling. */
+    pxConnection->xLinkHealth.usKeepAliveSeconds = MQTT_AGENT_KEEP_ALIVE_INTERVAL_SECONDS;
+    pxConnection->xLinkHealth.usBackoffCeilingMs = RETRY_MAX_BACKOFF_DELAY_MS;
+
     /* Fill in Transport Interface send and receive function pointers. */
-    xTransport.pNetworkContext = &xNetworkContextMqtt;
-    xTransport.send = Transport_Send;
-    xTransport.recv = Transport_Recv;
+    xTransport.pNetworkContext = &( pxConnection->xNetworkContext );
+    xTransport.send = prvTransportSend;
+    xTransport.recv = prvTransportRecv;
 
     /* Initialize MQTT library. */
-    xReturn = MQTTAgent_Init( &xGlobalMqttAgentContext,
+    xReturn = MQTTAgent_Init( &( pxConnection->xAgentContext ),
                               &messageInterface,
                               &xFixedBuffer,
                               &xTransport,
@@ -477,22 +1037,38 @@ STATIC MQTTStatus_t prvMQTTInit( void )
     }
     else
     {
-        ( void ) xEventGroupSetBits( xSystemEvents, EVENT_MASK_MQTT_INIT );
+        taskENTER_CRITICAL();
+        {
+            uxInitializedConnections++;
+            uxInitialized = uxInitializedConnections;
+        }
+        taskEXIT_CRITICAL();
+
+        /* Users may post commands to any connection once the agent reports
+         * ready, so wait for all of them. */
+        if( uxInitialized == appCONFIG_MQTT_AGENT_NUM_CONNECTIONS )
+        {
+            vBootTimelineMark( BootTimelineMqttReady );
+            ( void ) xEventGroupSetBits( xSystemEvents, EVENT_MASK_MQTT_INIT );
+        }
     }
 
     return xReturn;
 }
 
-STATIC MQTTStatus_t prvHandleResubscribe( void )
+STATIC MQTTStatus_t prvHandleResubscribe( UBaseType_t uxConnection )
 {
+    MqttAgentConnection_t * pxConnection = &( xConnections[ uxConnection ] );
     MQTTStatus_t xResult = MQTTBadParameter;
     uint32_t ulIndex = 0U;
     uint16_t usNumSubscriptions = 0U;
 
-    /* These variables need to stay in scope until command completes. */
-    static MQTTAgentSubscribeArgs_t xSubArgs = { 0 };
-    static MQTTSubscribeInfo_t xSubInfo[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ] = { 0 };
-    static MQTTAgentCommandInfo_t xCommandParams = { 0 };
+    /* These variables need to stay in scope until command completes, so they
+     * live in the connection. */
+    MQTTAgentSubscribeArgs_t * pxSubArgs = &( pxConnection->xResubscribeArgs );
+    MQTTSubscribeInfo_t * pxSubInfo = pxConnection->xResubscribeInfo;
+    MQTTAgentCommandInfo_t * pxCommandParams = &( pxConnection->xResubscribeCommandParams );
+    SubscriptionElement_t * pxSubscriptionList = pxConnection->xSubscriptionList;
 
     /* Loop through each subscription in the subscription list and add a subscribe
      * command to the command queue. */
@@ -500,17 +1076,17 @@ STATIC MQTTStatus_t prvHandleResubscribe( void )
     {
         /* Check if there is a subscription in the subscription list. This demo
          * doesn't check for duplicate subscriptions. */
-        if( xGlobalSubscriptionList[ ulIndex ].usFilterStringLength != 0 )
+        if( pxSubscriptionList[ ulIndex ].usFilterStringLength != 0 )
         {
-            xSubInfo[ usNumSubscriptions ].pTopicFilter = xGlobalSubscriptionList[ ulIndex ].pcSubscriptionFilterString;
-            xSubInfo[ usNumSubscriptions ].topicFilterLength = xGlobalSubscriptionList[ ulIndex ].usFilterStringLength;
+            pxSubInfo[ usNumSubscriptions ].pTopicFilter = pxSubscriptionList[ ulIndex ].pcSubscriptionFilterString;
+            pxSubInfo[ usNumSubscriptions ].topicFilterLength = pxSubscriptionList[ ulIndex ].usFilterStringLength;
 
             /* QoS1 is used for all the subscriptions in this demo. */
-            xSubInfo[ usNumSubscriptions ].qos = MQTTQoS1;
+            pxSubInfo[ usNumSubscriptions ].qos = MQTTQoS1;
 
             LogInfo( ( "Resubscribe to the topic %.*s will be attempted.",
-                       xSubInfo[ usNumSubscriptions ].topicFilterLength,
-                       xSubInfo[ usNumSubscriptions ].pTopicFilter ) );
+                       pxSubInfo[ usNumSubscriptions ].topicFilterLength,
+                       pxSubInfo[ usNumSubscriptions ].pTopicFilter ) );
 
             usNumSubscriptions++;
         }
@@ -518,17 +1094,17 @@ STATIC MQTTStatus_t prvHandleResubscribe( void )
 
     if( usNumSubscriptions > 0U )
     {
-        xSubArgs.pSubscribeInfo = xSubInfo;
-        xSubArgs.numSubscriptions = usNumSubscriptions;
+        pxSubArgs->pSubscribeInfo = pxSubInfo;
+        pxSubArgs->numSubscriptions = usNumSubscriptions;
 
         /* The block time can be 0 as the command loop is not running at this point. */
-        xCommandParams.blockTimeMs = 0U;
-        xCommandParams.cmdCompleteCallback = prvReSubscriptionCommandCallback;
-        xCommandParams.pCmdCompleteCallbackContext = ( void * ) &xSubArgs;
+        pxCommandParams->blockTimeMs = 0U;
+        pxCommandParams->cmdCompleteCallback = prvReSubscriptionCommandCallback;
+        pxCommandParams->pCmdCompleteCallbackContext = ( void * ) pxSubArgs;
 
         /* Enqueue subscribe to the command queue. These commands will be processed only
          * when command loop starts. */
-        xResult = MQTTAgent_Subscribe( &xGlobalMqttAgentContext, &xSubArgs, &xCommandParams );
+        xResult = MQTTAgent_Subscribe( &( pxConnection->xAgentContext ), pxSubArgs, pxCommandParams );
     }
     else
     {
@@ -545,47 +1121,67 @@ STATIC MQTTStatus_t prvHandleResubscribe( void )
     return xResult;
 }
 
-STATIC MQTTStatus_t prvMQTTConnect( void )
+STATIC MQTTStatus_t prvMQTTConnect( UBaseType_t uxConnection )
 {
+    MqttAgentConnection_t * pxConnection = &( xConnections[ uxConnection ] );
+    MQTTConnectInfo_t * pxConnectInfo = &( pxConnection->xConnectInfo );
     MQTTStatus_t xResult;
     bool xSessionPresent = false;
 
     /* The client identifier is used to uniquely identify this MQTT client to
      * the MQTT broker. In a production device the identifier can be something
-     * unique, such as a device serial number. */
-    xConnectInfo.pClientIdentifier = democonfigCLIENT_IDENTIFIER;
-    xConnectInfo.clientIdentifierLength = ( uint16_t ) strlen( democonfigCLIENT_IDENTIFIER );
+     * unique, such as a device serial number. The broker drops an existing
+     * connection when another one uses the same identifier, so additional
+     * connections are suffixed with their index. */
+    if( uxConnection == ( UBaseType_t ) eMqttAgentConnectionControl )
+    {
+        ( void ) snprintf( pxConnection->cClientIdentifier,
+                           sizeof( pxConnection->cClientIdentifier ),
+                           "%s",
+                           democonfigCLIENT_IDENTIFIER );
+    }
+    else
+    {
+        ( void ) snprintf( pxConnection->cClientIdentifier,
+                           sizeof( pxConnection->cClientIdentifier ),
+                           "%s-%u",
+                           democonfigCLIENT_IDENTIFIER,
+                           ( unsigned int ) uxConnection );
+    }
+
+    pxConnectInfo->pClientIdentifier = pxConnection->cClientIdentifier;
+    pxConnectInfo->clientIdentifierLength = ( uint16_t ) strlen( pxConnection->cClientIdentifier );
 
     /* Set MQTT keep-alive period. It is the responsibility of the application
      * to ensure that the interval between Control Packets being sent does not
      * exceed the Keep Alive value. In the absence of sending any other Control
      * Packets, the Client MUST send a PINGREQ Packet.  This responsibility will
-     * be moved inside the agent. */
-    xConnectInfo.keepAliveSeconds = MQTT_AGENT_KEEP_ALIVE_INTERVAL_SECONDS;
+     * be moved inside the agent. The interval adapts to the link health. */
+    pxConnectInfo->keepAliveSeconds = pxConnection->xLinkHealth.usKeepAliveSeconds;
 
-    LogInfo( ( "Creating an MQTT connection to the broker. \n" ) );
+    LogInfo( ( "Creating MQTT connection %u to the broker. \n", ( unsigned int ) uxConnection ) );
 
-    ( void ) MQTTAgent_CancelAll( &( xGlobalMqttAgentContext ) );
+    ( void ) MQTTAgent_CancelAll( &( pxConnection->xAgentContext ) );
 
     /* Send MQTT CONNECT packet to broker. MQTT's Last Will and Testament feature
      * is not used in this demo, so it is passed as NULL. */
-    xResult = MQTT_Connect( &( xGlobalMqttAgentContext.mqttContext ),
-                            &xConnectInfo,
+    xResult = MQTT_Connect( &( pxConnection->xAgentContext.mqttContext ),
+                            pxConnectInfo,
                             NULL,
                             MQTT_AGENT_CONNACK_RECV_TIMEOUT_MS,
                             &xSessionPresent );
 
     /* Resume a session if desired. */
     if( ( xResult == MQTTSuccess ) &&
-        ( xConnectInfo.cleanSession == false ) )
+        ( pxConnectInfo->cleanSession == false ) )
     {
         LogInfo( ( "Resuming persistent MQTT Session." ) );
-        xResult = MQTTAgent_ResumeSession( &xGlobalMqttAgentContext, xSessionPresent );
+        xResult = MQTTAgent_ResumeSession( &( pxConnection->xAgentContext ), xSessionPresent );
 
         /* Resubscribe to all the subscribed topics. */
         if( ( xResult == MQTTSuccess ) && ( xSessionPresent == false ) )
         {
-            xResult = prvHandleResubscribe();
+            xResult = prvHandleResubscribe( uxConnection );
         }
     }
     else if( xResult == MQTTSuccess )
@@ -594,9 +1190,14 @@ STATIC MQTTStatus_t prvMQTTConnect( void )
         LogInfo( ( "Session present: %d\n", xSessionPresent ) );
         LogInfo( ( "Starting a clean MQTT Session." ) );
         /* Further reconnects will include a session resume operation */
-        xConnectInfo.cleanSession = false;
+        pxConnectInfo->cleanSession = false;
 
-        ( void ) xEventGroupSetBits( xSystemEvents, EVENT_MASK_MQTT_CONNECTED );
+        if( uxConnection == ( UBaseType_t ) eMqttAgentConnectionControl )
+        {
+            vBootTimelineMark( BootTimelineMqttConnected );
+        }
+
+        ( void ) xEventGroupSetBits( xSystemEvents, prvConnectedEventMask( uxConnection ) );
     }
     else
     {
@@ -617,10 +1218,11 @@ STATIC void prvDisconnectCommandCallback( MQTTAgentCommandContext_t * pxCommandC
     }
 }
 
-STATIC void prvDisconnectFromMQTTBroker( void )
+STATIC void prvDisconnectFromMQTTBroker( UBaseType_t uxConnection )
 {
     static MQTTAgentCommandContext_t xCommandContext = { 0 };
     static MQTTAgentCommandInfo_t xCommandParams = { 0 };
+    MqttAgentConnection_t * pxConnection = &( xConnections[ uxConnection ] );
     MQTTStatus_t xCommandStatus;
 
     /* Disconnect from broker. */
@@ -634,7 +1236,7 @@ STATIC void prvDisconnectFromMQTTBroker( void )
     xCommandContext.xReturnStatus = MQTTSendFailed;
 
     /* Disconnect MQTT session. */
-    xCommandStatus = MQTTAgent_Disconnect( &xGlobalMqttAgentContext, &xCommandParams );
+    xCommandStatus = MQTTAgent_Disconnect( &( pxConnection->xAgentContext ), &xCommandParams );
     configASSERT( xCommandStatus == MQTTSuccess );
 
     xTaskNotifyWait( 0,
@@ -643,7 +1245,7 @@ STATIC void prvDisconnectFromMQTTBroker( void )
                      pdMS_TO_TICKS( MQTT_AGENT_MS_TO_WAIT_FOR_NOTIFICATION ) );
 
     /* End TLS session, then close TCP connection. */
-    if( prvSocketDisconnect( &xNetworkContextMqtt ) != pdPASS )
+    if( prvSocketDisconnect( &( pxConnection->xNetworkContext ) ) != pdPASS )
     {
         LogError( ( "Failed to disconnect socket." ) );
     }
@@ -651,18 +1253,26 @@ STATIC void prvDisconnectFromMQTTBroker( void )
 
 STATIC void prvMQTTAgentTask( void * pParam )
 {
+    UBaseType_t uxConnection = ( UBaseType_t ) ( uintptr_t ) pParam;
+    MqttAgentConnection_t * pxConnection = &( xConnections[ uxConnection ] );
     BaseType_t xResult;
     MQTTStatus_t xMQTTStatus = MQTTSuccess;
     BackoffAlgorithmStatus_t xBackoffAlgStatus;
     BackoffAlgorithmContext_t xReconnectParams = { 0 };
     uint16_t usNextRetryBackOff = 0U;
+    uint32_t ulSessionStartMs;
 
-    ( void ) pParam;
+    /* All the connections use the same credentials, look them up while the
+     * network comes up rather than during the first TLS handshake. */
+    if( uxConnection == ( UBaseType_t ) eMqttAgentConnectionControl )
+    {
+        prvLoadTlsCredentials();
+    }
 
     vWaitUntilNetworkIsUp();
 
     /* Initialize the MQTT context with the buffer and transport interface. */
-    xMQTTStatus = prvMQTTInit();
+    xMQTTStatus = prvMQTTInit( uxConnection );
 
     if( xMQTTStatus != MQTTSuccess )
     {
@@ -682,10 +1292,13 @@ STATIC void prvMQTTAgentTask( void * pParam )
     while( true )
     {
         /* Connect a TCP socket to the broker. */
-        xResult = prvSocketConnect( &xNetworkContextMqtt );
+        xResult = prvSocketConnect( &( pxConnection->xNetworkContext ) );
 
         if( xResult != pdPASS )
         {
+            prvLinkHealthRecordConnect( uxConnection, pdFAIL );
+            xReconnectParams.maxBackoffDelay = pxConnection->xLinkHealth.usBackoffCeilingMs;
+
             xBackoffAlgStatus = BackoffAlgorithm_GetNextBackoff( &xReconnectParams, prvGetRandomNumber(), &usNextRetryBackOff );
 
             if( xBackoffAlgStatus == BackoffAlgorithmSuccess )
@@ -712,15 +1325,18 @@ STATIC void prvMQTTAgentTask( void * pParam )
          * previous session data. Also, establishing a connection with clean session
          * will ensure that the broker does not store any data when this client
          * gets disconnected. */
-        xConnectInfo.cleanSession = true;
+        pxConnection->xConnectInfo.cleanSession = true;
 
         /* Form an MQTT connection without a persistent session. */
-        xMQTTStatus = prvMQTTConnect();
+        xMQTTStatus = prvMQTTConnect( uxConnection );
 
         if( xMQTTStatus != MQTTSuccess )
         {
             /* End TLS session, then close TCP connection. */
-            prvSocketDisconnect( &xNetworkContextMqtt );
+            prvSocketDisconnect( &( pxConnection->xNetworkContext ) );
+
+            prvLinkHealthRecordConnect( uxConnection, pdFAIL );
+            xReconnectParams.maxBackoffDelay = pxConnection->xLinkHealth.usBackoffCeilingMs;
 
             xBackoffAlgStatus = BackoffAlgorithm_GetNextBackoff( &xReconnectParams, prvGetRandomNumber(), &usNextRetryBackOff );
 
@@ -744,20 +1360,23 @@ STATIC void prvMQTTAgentTask( void * pParam )
             continue;
         }
 
+        prvLinkHealthRecordConnect( uxConnection, pdPASS );
+        ulSessionStartMs = prvGetTimeMs();
+
         /* MQTTAgent_CommandLoop() is effectively the agent implementation.  It
          * will manage the MQTT protocol until such time that an error occurs,
          * which could be a disconnect.  If an error occurs the MQTT context on
          * which the error happened is returned so there can be an attempt to
          * clean up and reconnect however the application writer prefers. */
-        xMQTTStatus = MQTTAgent_CommandLoop( &xGlobalMqttAgentContext );
+        xMQTTStatus = MQTTAgent_CommandLoop( &( pxConnection->xAgentContext ) );
 
-        ( void ) xEventGroupClearBits( xSystemEvents, EVENT_MASK_MQTT_CONNECTED );
+        ( void ) xEventGroupClearBits( xSystemEvents, prvConnectedEventMask( uxConnection ) );
 
 
         LogError( ( "MQTTAgent_CommandLoop returned with status: %s.",
                     MQTT_Status_strerror( xMQTTStatus ) ) );
 
-        ( void ) MQTTAgent_CancelAll( &( xGlobalMqttAgentContext ) );
+        ( void ) MQTTAgent_CancelAll( &( pxConnection->xAgentContext ) );
 
         /* Success is returned for application initiated disconnect or termination. The socket will also be disconnected by the caller. */
         if( xMQTTStatus == MQTTSuccess )
@@ -766,29 +1385,113 @@ STATIC void prvMQTTAgentTask( void * pParam )
         }
 
         /* End TLS session, then close TCP connection. */
-        prvSocketDisconnect( &xNetworkContextMqtt );
+        prvSocketDisconnect( &( pxConnection->xNetworkContext ) );
+
+        prvLinkHealthRecordDisconnect( uxConnection, xMQTTStatus, prvGetTimeMs() - ulSessionStartMs );
+
+        /* Start the next outage from the base delay again, bounded by the
+         * ceiling the failure history so far calls for. */
+        BackoffAlgorithm_InitializeParams( &xReconnectParams,
+                                           RETRY_BACKOFF_BASE_MS,
+                                           pxConnection->xLinkHealth.usBackoffCeilingMs,
+                                           BACKOFF_ALGORITHM_RETRY_FOREVER );
     }
 
-    ( void ) xEventGroupClearBits( xSystemEvents, EVENT_MASK_MQTT_INIT | EVENT_MASK_MQTT_CONNECTED );
+    if( uxConnection == ( UBaseType_t ) eMqttAgentConnectionControl )
+    {
+        ( void ) xEventGroupClearBits( xSystemEvents, EVENT_MASK_MQTT_INIT );
+    }
 
-    LogError( ( "Terminating MqttAgentTask." ) );
+    ( void ) xEventGroupClearBits( xSystemEvents, prvConnectedEventMask( uxConnection ) );
+
+    LogError( ( "Terminating MqttAgentTask for connection %u.", ( unsigned int ) uxConnection ) );
 
     vTaskDelete( NULL );
 }
 
 /*-----------------------------------------------------------*/
 
+MQTTAgentContext_t * pxGetMqttAgentContext( MqttAgentConnectionId_t xConnection )
+{
+    return &( xConnections[ prvConnectionIndex( xConnection ) ].xAgentContext );
+}
+
+/*-----------------------------------------------------------*/
+
+SubscriptionElement_t * pxGetMqttAgentSubscriptionList( MqttAgentConnectionId_t xConnection )
+{
+    return xConnections[ prvConnectionIndex( xConnection ) ].xSubscriptionList;
+}
+
+/*-----------------------------------------------------------*/
+
+void vGetMqttAgentLinkHealth( MqttAgentConnectionId_t xConnection,
+                              MqttAgentLinkHealth_t * pxLinkHealth )
+{
+    configASSERT( pxLinkHealth != NULL );
+
+    taskENTER_CRITICAL();
+    {
+        *pxLinkHealth = xConnections[ prvConnectionIndex( xConnection ) ].xLinkHealth;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*-----------------------------------------------------------*/
+
+void vWaitUntilMqttAgentConnectionConnected( MqttAgentConnectionId_t xConnection )
+{
+    /* There is no need to check the return value of this API, since the task
+     * is waiting for a particular bit to be set and is waiting forever. */
+    ( void ) xEventGroupWaitBits( xSystemEvents,
+                                  prvConnectedEventMask( prvConnectionIndex( xConnection ) ),
+                                  pdFALSE,
+                                  pdFALSE,
+                                  portMAX_DELAY );
+}
+
+/*-----------------------------------------------------------*/
+
+bool xIsMqttAgentConnectionConnected( MqttAgentConnectionId_t xConnection )
+{
+    EventBits_t uxEvents = xEventGroupGetBits( xSystemEvents );
+
+    return ( uxEvents & prvConnectedEventMask( prvConnectionIndex( xConnection ) ) ) != 0;
+}
+
+/*-----------------------------------------------------------*/
+
+bool xGetMqttAgentCommandQueueStats( MqttAgentConnectionId_t xConnection,
+                                     AgentMessagePriority_t xPriority,
+                                     AgentMessageStats_t * pxStats )
+{
+    return Agent_PriorityMessageGetStats( &( xConnections[ prvConnectionIndex( xConnection ) ].xCommandQueue ),
+                                          xPriority,
+                                          pxStats );
+}
+
+/*-----------------------------------------------------------*/
+
 /*
- * @brief Create MQTT agent task.
+ * @brief Create an MQTT agent task for each connection.
  */
 void vStartMqttAgentTask( void )
 {
-    xTaskCreate( prvMQTTAgentTask,
-                 "MQTT Agent Task ",
-                 appCONFIG_MQTT_AGENT_TASK_STACK_SIZE,
-                 NULL,
-                 appCONFIG_MQTT_AGENT_TASK_PRIORITY,
-                 NULL );
+    UBaseType_t uxConnection;
+
+    /* The command pool is shared by the agent tasks, initialize it before any
+     * of them runs. */
+    Agent_InitializePool();
+
+    for( uxConnection = 0U; uxConnection < appCONFIG_MQTT_AGENT_NUM_CONNECTIONS; uxConnection++ )
+    {
+        xTaskCreate( prvMQTTAgentTask,
+                     ( uxConnection == ( UBaseType_t ) eMqttAgentConnectionControl ) ? "MQTT Agent Task " : "MQTT Bulk Agent ",
+                     appCONFIG_MQTT_AGENT_TASK_STACK_SIZE,
+                     ( void * ) ( uintptr_t ) uxConnection,
+                     ( uxConnection == ( UBaseType_t ) eMqttAgentConnectionControl ) ? appCONFIG_MQTT_AGENT_TASK_PRIORITY : appCONFIG_MQTT_AGENT_BULK_TASK_PRIORITY,
+                     NULL );
+    }
 }
 
 /*-----------------------------------------------------------*/
@@ -49,31 +49,22 @@
 /* Subscription manager header include. */
 #include "subscription_manager.h"
 
-/**
- * @brief The global array of subscription elements.
- *
- * @note No thread safety is required to this array, since the updates the array
- * elements are done only from one task at a time. The subscription manager
- * implementation expects that the array of the subscription elements used for
- * storing subscriptions to be initialized to 0. As this is a global array, it
- * will be intialized to 0 by default.
- */
-SubscriptionElement_t xGlobalSubscriptionList[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];
-
-
-bool addSubscription( const char * pcTopicFilterString,
+bool addSubscription( SubscriptionElement_t * pxSubscriptionList,
+                      const char * pcTopicFilterString,
                       uint16_t usTopicFilterLength,
                       IncomingPubCallback_t pxIncomingPublishCallback,
                       void * pvIncomingPublishCallbackContext )
 {
     bool xReturnStatus = false;
 
-    if( ( pcTopicFilterString == NULL ) ||
+    if( ( pxSubscriptionList == NULL ) ||
+        ( pcTopicFilterString == NULL ) ||
         ( usTopicFilterLength == 0U ) ||
         ( pxIncomingPublishCallback == NULL ) )
     {
-        LogError( ( "Invalid parameter. spcTopicFilterString=%p,"
+        LogError( ( "Invalid parameter. pxSubscriptionList=%p, spcTopicFilterString=%p,"
                     " usTopicFilterLength=%u, pxIncomingPublishCallback=%p.",
+                    pxSubscriptionList,
                     pcTopicFilterString,
                     ( unsigned int ) usTopicFilterLength,
                     pxIncomingPublishCallback ) );
@@ -87,16 +78,16 @@ bool addSubscription( const char * pcTopicFilterString,
          * Scans backwards to find duplicates. */
         for( lIndex = ( int32_t ) SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS - 1; lIndex >= 0; lIndex-- )
         {
-            if( xGlobalSubscriptionList[ lIndex ].usFilterStringLength == 0 )
+            if( pxSubscriptionList[ lIndex ].usFilterStringLength == 0 )
             {
                 xAvailableIndex = lIndex;
             }
-            else if( ( xGlobalSubscriptionList[ lIndex ].usFilterStringLength == usTopicFilterLength ) &&
-                     ( strncmp( pcTopicFilterString, xGlobalSubscriptionList[ lIndex ].pcSubscriptionFilterString, ( size_t ) usTopicFilterLength ) == 0 ) )
+            else if( ( pxSubscriptionList[ lIndex ].usFilterStringLength == usTopicFilterLength ) &&
+                     ( strncmp( pcTopicFilterString, pxSubscriptionList[ lIndex ].pcSubscriptionFilterString, ( size_t ) usTopicFilterLength ) == 0 ) )
             {
                 /* If a subscription already exists, don't do anything. */
-                if( ( xGlobalSubscriptionList[ lIndex ].pxIncomingPublishCallback == pxIncomingPublishCallback ) &&
-                    ( xGlobalSubscriptionList[ lIndex ].pvIncomingPublishCallbackContext == pvIncomingPublishCallbackContext ) )
+                if( ( pxSubscriptionList[ lIndex ].pxIncomingPublishCallback == pxIncomingPublishCallback ) &&
+                    ( pxSubscriptionList[ lIndex ].pvIncomingPublishCallbackContext == pvIncomingPublishCallbackContext ) )
                 {
                     LogWarn( ( "Subscription already exists.\n" ) );
                     xAvailableIndex = SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS;
@@ -108,10 +99,10 @@ bool addSubscription( const char * pcTopicFilterString,
 
         if( xAvailableIndex < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS )
         {
-            xGlobalSubscriptionList[ xAvailableIndex ].pcSubscriptionFilterString = pcTopicFilterString;
-            xGlobalSubscriptionList[ xAvailableIndex ].usFilterStringLength = usTopicFilterLength;
-            xGlobalSubscriptionList[ xAvailableIndex ].pxIncomingPublishCallback = pxIncomingPublishCallback;
-            xGlobalSubscriptionList[ xAvailableIndex ].pvIncomingPublishCallbackContext = pvIncomingPublishCallbackContext;
+            pxSubscriptionList[ xAvailableIndex ].pcSubscriptionFilterString = pcTopicFilterString;
+            pxSubscriptionList[ xAvailableIndex ].usFilterStringLength = usTopicFilterLength;
+            pxSubscriptionList[ xAvailableIndex ].pxIncomingPublishCallback = pxIncomingPublishCallback;
+            pxSubscriptionList[ xAvailableIndex ].pvIncomingPublishCallbackContext = pvIncomingPublishCallbackContext;
             xReturnStatus = true;
         }
     }
@@ -121,16 +112,19 @@ bool addSubscription( const char * pcTopicFilterString,
 
 /*-----------------------------------------------------------*/
 
-bool removeSubscription( const char * pcTopicFilterString,
+bool removeSubscription( SubscriptionElement_t * pxSubscriptionList,
+                         const char * pcTopicFilterString,
                          uint16_t usTopicFilterLength )
 {
     bool found = false;
 
-    if( ( pcTopicFilterString == NULL ) ||
+    if( ( pxSubscriptionList == NULL ) ||
+        ( pcTopicFilterString == NULL ) ||
         ( usTopicFilterLength == 0U ) )
     {
-        LogError( ( "Invalid parameter.  pcTopicFilterString=%p,"
+        LogError( ( "Invalid parameter. pxSubscriptionList=%p, pcTopicFilterString=%p,"
                     " usTopicFilterLength=%u.",
+                    pxSubscriptionList,
                     pcTopicFilterString,
                     ( unsigned int ) usTopicFilterLength ) );
     }
@@ -140,12 +134,12 @@ bool removeSubscription( const char * pcTopicFilterString,
 
         for( lIndex = 0; lIndex < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS; lIndex++ )
         {
-            if( xGlobalSubscriptionList[ lIndex ].usFilterStringLength == usTopicFilterLength )
+            if( pxSubscriptionList[ lIndex ].usFilterStringLength == usTopicFilterLength )
             {
-                if( strncmp( xGlobalSubscriptionList[ lIndex ].pcSubscriptionFilterString, pcTopicFilterString, usTopicFilterLength ) == 0 )
+                if( strncmp( pxSubscriptionList[ lIndex ].pcSubscriptionFilterString, pcTopicFilterString, usTopicFilterLength ) == 0 )
                 {
                     found = true;
-                    memset( &( xGlobalSubscriptionList[ lIndex ] ), 0x00, sizeof( SubscriptionElement_t ) );
+                    memset( &( pxSubscriptionList[ lIndex ] ), 0x00, sizeof( SubscriptionElement_t ) );
                 }
             }
         }
@@ -156,13 +150,16 @@ bool removeSubscription( const char * pcTopicFilterString,
 
 /*-----------------------------------------------------------*/
 
-bool handleIncomingPublishes( MQTTPublishInfo_t * pxPublishInfo )
+bool handleIncomingPublishes( SubscriptionElement_t * pxSubscriptionList,
+                              MQTTPublishInfo_t * pxPublishInfo )
 {
     bool isMatched = false, publishHandled = false;
 
-    if( pxPublishInfo == NULL )
+    if( ( pxSubscriptionList == NULL ) ||
+        ( pxPublishInfo == NULL ) )
     {
-        LogError( ( "Invalid parameter. pxPublishInfo=%p,",
+        LogError( ( "Invalid parameter. pxSubscriptionList=%p, pxPublishInfo=%p,",
+                    pxSubscriptionList,
                     pxPublishInfo ) );
     }
     else
@@ -171,17 +168,17 @@ bool handleIncomingPublishes( MQTTPublishInfo_t * pxPublishInfo )
 
         for( lIndex = 0; lIndex < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS; lIndex++ )
         {
-            if( xGlobalSubscriptionList[ lIndex ].usFilterStringLength > 0 )
+            if( pxSubscriptionList[ lIndex ].usFilterStringLength > 0 )
             {
                 MQTT_MatchTopic( pxPublishInfo->pTopicName,
                                  pxPublishInfo->topicNameLength,
-                                 xGlobalSubscriptionList[ lIndex ].pcSubscriptionFilterString,
-                                 xGlobalSubscriptionList[ lIndex ].usFilterStringLength,
+                                 pxSubscriptionList[ lIndex ].pcSubscriptionFilterString,
+                                 pxSubscriptionList[ lIndex ].usFilterStringLength,
                                  &isMatched );
 
                 if( isMatched == true )
                 {
-                    xGlobalSubscriptionList[ lIndex ].pxIncomingPublishCallback( xGlobalSubscriptionList[ lIndex ].pvIncomingPublishCallbackContext,
+                    pxSubscriptionList[ lIndex ].pxIncomingPublishCallback( pxSubscriptionList[ lIndex ].pvIncomingPublishCallbackContext,
                                                                                  pxPublishInfo );
                     publishHandled = true;
                 }
@@ -3,6 +3,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <string.h>
+
 #include "fff.h"
 
 #include "gtest/gtest.h"
@@ -10,6 +12,13 @@
 extern "C" {
 #include "freertos_agent_message.h"
 #include "core_mqtt_agent_message_interface.h"
+#include "semphr.h"
+#include "task.h"
+
+/* Functions usually defined by main.c */
+DEFINE_FAKE_VOID_FUNC( vAssertCalled,
+                       const char *,
+                       unsigned long );
 }
 
 DEFINE_FFF_GLOBALS
@@ -86,3 +95,225 @@ TEST_F( TestFreertosAgentMessage, successfully_receiving_a_message_returns_true
     MQTTAgentCommand_t * command;
     EXPECT_TRUE( Agent_MessageReceive( &message, &command, 1 ) );
 }
+
+/* Queues standing in for the priority queues of a context. */
+static QueueDefinition priorityQueues[ AgentMessagePriorityCount ];
+
+/* Messages waiting in each stand-in queue. */
+static AgentPriorityMessage_t waitingMessages[ AgentMessagePriorityCount ][ 16 ];
+static UBaseType_t waitingCount[ AgentMessagePriorityCount ];
+
+static UBaseType_t priority_of_queue( QueueHandle_t queue )
+{
+    return ( UBaseType_t ) ( queue - priorityQueues );
+}
+
+static BaseType_t queue_message( QueueHandle_t queue,
+                                 const void * pvItemToQueue,
+                                 TickType_t xTicksToWait )
+{
+    UBaseType_t priority = priority_of_queue( queue );
+
+    waitingMessages[ priority ][ waitingCount[ priority ]++ ] = *( const AgentPriorityMessage_t * ) pvItemToQueue;
+
+    return pdPASS;
+}
+
+static UBaseType_t count_waiting_messages( QueueHandle_t queue )
+{
+    return waitingCount[ priority_of_queue( queue ) ];
+}
+
+static BaseType_t dequeue_message( QueueHandle_t queue,
+                                   void * pvBuffer,
+                                   TickType_t xTicksToWait )
+{
+    UBaseType_t priority = priority_of_queue( queue );
+    BaseType_t status = pdFAIL;
+
+    if( waitingCount[ priority ] > 0 )
+    {
+        *( AgentPriorityMessage_t * ) pvBuffer = waitingMessages[ priority ][ 0 ];
+        memmove( &waitingMessages[ priority ][ 0 ],
+                 &waitingMessages[ priority ][ 1 ],
+                 ( --waitingCount[ priority ] ) * sizeof( AgentPriorityMessage_t ) );
+        status = pdPASS;
+    }
+
+    return status;
+}
+
+class TestFreertosAgentPriorityMessage : public TestFreertosAgentMessage {
+public:
+    MQTTAgentMessageContext_t context = {};
+
+    TestFreertosAgentPriorityMessage()
+    {
+        RESET_FAKE( uxQueueMessagesWaiting );
+        RESET_FAKE( xSemaphoreTake );
+        RESET_FAKE( xSemaphoreGive );
+        RESET_FAKE( xTaskGetTickCount );
+
+        memset( waitingCount, 0, sizeof( waitingCount ) );
+
+        for( int priority = 0; priority < AgentMessagePriorityCount; priority++ )
+        {
+            context.priorityQueue[ priority ] = &priorityQueues[ priority ];
+        }
+
+        xQueueSendToBack_fake.custom_fake = queue_message;
+        xQueueReceive_fake.custom_fake = dequeue_message;
+        uxQueueMessagesWaiting_fake.custom_fake = count_waiting_messages;
+        xSemaphoreTake_fake.return_val = pdPASS;
+    }
+};
+
+TEST_F( TestFreertosAgentPriorityMessage, init_errors_if_queue_creation_returns_nullptr )
+{
+    AgentPriorityMessageStorage_t storage;
+
+    /* E.g. happens if out of memory. */
+    RESET_FAKE( xQueueCreateStatic );
+    RESET_FAKE( xSemaphoreCreateCountingStatic );
+    RESET_FAKE( vAssertCalled );
+    xQueueCreateStatic_fake.return_val = nullptr;
+    xSemaphoreCreateCountingStatic_fake.return_val = 1;
+
+    Agent_PriorityMessageInit( &context, &storage );
+
+    EXPECT_EQ( xQueueCreateStatic_fake.call_count, AgentMessagePriorityCount );
+    EXPECT_NE( vAssertCalled_fake.call_count, 0 );
+}
+
+TEST_F( TestFreertosAgentPriorityMessage, commands_are_queued_by_priority )
+{
+    MQTTPublishInfo_t otaPublish = { .pTopicName = "$aws/things/thing/streams/1/get", .topicNameLength = 31 };
+    MQTTPublishInfo_t appPublish = { .pTopicName = "thing/ml/inference", .topicNameLength = 18 };
+    MQTTSubscribeInfo_t otaSubscription = { .pTopicFilter = "$aws/things/thing/jobs/#", .topicFilterLength = 24 };
+    MQTTAgentSubscribeArgs_t otaSubscribe = { .pSubscribeInfo = &otaSubscription, .numSubscriptions = 1 };
+    MQTTAgentCommand_t ping = { .commandType = PING, .pArgs = nullptr };
+    MQTTAgentCommand_t blockRequest = { .commandType = PUBLISH, .pArgs = &otaPublish };
+    MQTTAgentCommand_t alert = { .commandType = PUBLISH, .pArgs = &appPublish };
+    MQTTAgentCommand_t jobsSubscribe = { .commandType = SUBSCRIBE, .pArgs = &otaSubscribe };
+    MQTTAgentCommand_t * command;
+
+    command = &blockRequest;
+    EXPECT_TRUE( Agent_PriorityMessageSend( &context, &command, 1 ) );
+    command = &alert;
+    EXPECT_TRUE( Agent_PriorityMessageSend( &context, &command, 1 ) );
+    command = &ping;
+    EXPECT_TRUE( Agent_PriorityMessageSend( &context, &command, 1 ) );
+    command = &jobsSubscribe;
+    EXPECT_TRUE( Agent_PriorityMessageSend( &context, &command, 1 ) );
+
+    EXPECT_EQ( waitingCount[ AgentMessagePriorityHigh ], 1 );
+    EXPECT_EQ( waitingCount[ AgentMessagePriorityNormal ], 1 );
+    EXPECT_EQ( waitingCount[ AgentMessagePriorityLow ], 2 );
+    EXPECT_EQ( waitingMessages[ AgentMessagePriorityHigh ][ 0 ].pCommand, &ping );
+    EXPECT_EQ( waitingMessages[ AgentMessagePriorityNormal ][ 0 ].pCommand, &alert );
+    EXPECT_EQ( xSemaphoreGive_fake.call_count, 4 );
+}
+
+TEST_F( TestFreertosAgentPriorityMessage, failing_to_queue_a_command_counts_it_as_dropped )
+{
+    MQTTAgentCommand_t ping = { .commandType = PING, .pArgs = nullptr };
+    MQTTAgentCommand_t * command = &ping;
+    AgentMessageStats_t stats;
+
+    xQueueSendToBack_fake.custom_fake = nullptr;
+    xQueueSendToBack_fake.return_val = pdFAIL;
+
+    EXPECT_FALSE( Agent_PriorityMessageSend( &context, &command, 1 ) );
+    EXPECT_EQ( xSemaphoreGive_fake.call_count, 0 );
+
+    EXPECT_TRUE( Agent_PriorityMessageGetStats( &context, AgentMessagePriorityHigh, &stats ) );
+    EXPECT_EQ( stats.sent, 0 );
+    EXPECT_EQ( stats.dropped, 1 );
+}
+
+TEST_F( TestFreertosAgentPriorityMessage, receive_fails_when_no_command_is_pending )
+{
+    MQTTAgentCommand_t * command;
+
+    xSemaphoreTake_fake.return_val = pdFAIL;
+
+    EXPECT_FALSE( Agent_PriorityMessageReceive( &context, &command, 1 ) );
+    EXPECT_EQ( xQueueReceive_fake.call_count, 0 );
+}
+
+TEST_F( TestFreertosAgentPriorityMessage, highest_priority_command_is_received_first )
+{
+    MQTTPublishInfo_t appPublish = { .pTopicName = "thing/ml/inference", .topicNameLength = 18 };
+    MQTTAgentCommand_t ping = { .commandType = PING, .pArgs = nullptr };
+    MQTTAgentCommand_t alert = { .commandType = PUBLISH, .pArgs = &appPublish };
+    MQTTAgentCommand_t * command;
+
+    command = &alert;
+    Agent_PriorityMessageSend( &context, &command, 1 );
+    command = &ping;
+    Agent_PriorityMessageSend( &context, &command, 1 );
+
+    EXPECT_TRUE( Agent_PriorityMessageReceive( &context, &command, 1 ) );
+    EXPECT_EQ( command, &ping );
+    EXPECT_TRUE( Agent_PriorityMessageReceive( &context, &command, 1 ) );
+    EXPECT_EQ( command, &alert );
+}
+
+TEST_F( TestFreertosAgentPriorityMessage, overtaken_command_is_promoted_to_prevent_starvation )
+{
+    MQTTPublishInfo_t otaPublish = { .pTopicName = "$aws/things/thing/streams/1/get", .topicNameLength = 31 };
+    MQTTPublishInfo_t appPublish = { .pTopicName = "thing/ml/inference", .topicNameLength = 18 };
+    MQTTAgentCommand_t blockRequest = { .commandType = PUBLISH, .pArgs = &otaPublish };
+    MQTTAgentCommand_t alert = { .commandType = PUBLISH, .pArgs = &appPublish };
+    MQTTAgentCommand_t * command = &blockRequest;
+    AgentMessageStats_t stats;
+
+    Agent_PriorityMessageSend( &context, &command, 1 );
+
+    /* Keep a normal priority command waiting for every receive. */
+    for( uint32_t i = 0; i < agentMessageSTARVATION_LIMIT; i++ )
+    {
+        command = &alert;
+        Agent_PriorityMessageSend( &context, &command, 1 );
+        EXPECT_TRUE( Agent_PriorityMessageReceive( &context, &command, 1 ) );
+        EXPECT_EQ( command, &alert );
+    }
+
+    command = &alert;
+    Agent_PriorityMessageSend( &context, &command, 1 );
+    EXPECT_TRUE( Agent_PriorityMessageReceive( &context, &command, 1 ) );
+    EXPECT_EQ( command, &blockRequest );
+
+    EXPECT_TRUE( Agent_PriorityMessageGetStats( &context, AgentMessagePriorityLow, &stats ) );
+    EXPECT_EQ( stats.received, 1 );
+    EXPECT_EQ( stats.starvationPromotions, 1 );
+}
+
+TEST_F( TestFreertosAgentPriorityMessage, receive_records_queueing_latency )
+{
+    MQTTAgentCommand_t ping = { .commandType = PING, .pArgs = nullptr };
+    MQTTAgentCommand_t * command = &ping;
+    AgentMessageStats_t stats;
+
+    xTaskGetTickCount_fake.return_val = 10;
+    Agent_PriorityMessageSend( &context, &command, 1 );
+    Agent_PriorityMessageSend( &context, &command, 1 );
+
+    xTaskGetTickCount_fake.return_val = 35;
+    Agent_PriorityMessageReceive( &context, &command, 1 );
+    xTaskGetTickCount_fake.return_val = 40;
+    Agent_PriorityMessageReceive( &context, &command, 1 );
+
+    EXPECT_TRUE( Agent_PriorityMessageGetStats( &context, AgentMessagePriorityHigh, &stats ) );
+    EXPECT_EQ( stats.sent, 2 );
+    EXPECT_EQ( stats.received, 2 );
+    EXPECT_EQ( stats.maxLatencyMs, 30 );
+    EXPECT_EQ( stats.totalLatencyMs, 55 );
+}
+
+TEST_F( TestFreertosAgentPriorityMessage, stats_of_an_invalid_priority_are_not_reported )
+{
+    AgentMessageStats_t stats;
+
+    EXPECT_FALSE( Agent_PriorityMessageGetStats( &context, AgentMessagePriorityCount, &stats ) );
+}
@@ -7,7 +7,9 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -34,9 +36,9 @@ extern "C" {
 
 extern void prvMQTTAgentTask( void * pParam );
 extern BaseType_t prvSocketConnect( NetworkContext_t * pNetworkContext );
-extern void prvDisconnectFromMQTTBroker( void );
-extern MQTTStatus_t prvMQTTInit( void );
-extern MQTTStatus_t prvMQTTConnect( void );
+extern void prvDisconnectFromMQTTBroker( UBaseType_t uxConnection );
+extern MQTTStatus_t prvMQTTInit( UBaseType_t uxConnection );
+extern MQTTStatus_t prvMQTTConnect( UBaseType_t uxConnection );
 extern uint32_t prvGetTimeMs( void );
 extern UBaseType_t prvGetRandomNumber( void );
 extern BaseType_t prvSocketConnect( NetworkContext_t * pxNetworkContext );
@@ -46,12 +48,24 @@ extern void prvIncomingPublishCallback( MQTTAgentContext_t * pMqttAgentContext,
                                         MQTTPublishInfo_t * pxPublishInfo );
 extern void prvReSubscriptionCommandCallback( MQTTAgentCommandContext_t * pxCommandContext,
                                               MQTTAgentReturnInfo_t * pxReturnInfo );
-extern MQTTStatus_t prvHandleResubscribe( void );
-extern MQTTStatus_t prvMQTTConnect( void );
+extern MQTTStatus_t prvHandleResubscribe( UBaseType_t uxConnection );
+extern MQTTStatus_t prvMQTTConnect( UBaseType_t uxConnection );
 extern void prvDisconnectCommandCallback( MQTTAgentCommandContext_t * pxCommandContext,
                                           MQTTAgentReturnInfo_t * pxReturnInfo );
-extern void prvDisconnectFromMQTTBroker( void );
+extern void prvDisconnectFromMQTTBroker( UBaseType_t uxConnection );
 extern void prvMQTTAgentTask( void * pParam );
+extern int32_t prvTransportSend( NetworkContext_t * pxNetworkContext,
+                                 const void * pvBuffer,
+                                 size_t xBytesToSend );
+extern int32_t prvTransportRecv( NetworkContext_t * pxNetworkContext,
+                                 void * pvBuffer,
+                                 size_t xBytesToRecv );
+extern void prvLinkHealthRecordConnect( UBaseType_t uxConnection,
+                                        BaseType_t xConnected );
+extern void prvLinkHealthRecordDisconnect( UBaseType_t uxConnection,
+                                           MQTTStatus_t xStatus,
+                                           uint32_t ulSessionMs );
+extern EventBits_t prvConnectedEventMask( UBaseType_t uxConnection );
 
 /* Directly copy-paste mock headers from the file under test's directory.
  * Otherwise, the non-mock files are detected. */
@@ -70,24 +84,33 @@ extern void prvMQTTAgentTask( void * pParam );
     #endif
 
     DECLARE_FAKE_VOID_FUNC( removeSubscription,
+                            SubscriptionElement_t *,
                             const char *,
                             uint16_t );
 
     DECLARE_FAKE_VALUE_FUNC( bool,
                              handleIncomingPublishes,
+                             SubscriptionElement_t *,
                              MQTTPublishInfo_t * );
 
     DEFINE_FAKE_VOID_FUNC( removeSubscription,
+                           SubscriptionElement_t *,
                            const char *,
                            uint16_t );
 
     DEFINE_FAKE_VALUE_FUNC( bool,
                             handleIncomingPublishes,
+                            SubscriptionElement_t *,
                             MQTTPublishInfo_t * );
-
-    SubscriptionElement_t xGlobalSubscriptionList[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];
 #endif /* SUBSCRIPTION_MANAGER_H */
 
+/* freertos_agent_message.c
+ * The real header is included through mqtt_agent_task.h, only the fake
+ * created by the integration mocks is declared here. */
+DECLARE_FAKE_VOID_FUNC( Agent_PriorityMessageInit,
+                        MQTTAgentMessageContext_t *,
+                        AgentPriorityMessageStorage_t * );
+
 /* freertos_command_pool.h */
 #ifndef FREERTOS_COMMAND_POOL_H
     #define FREERTOS_COMMAND_POOL_H
@@ -156,6 +179,7 @@ public:
     TestMqttAgentTask()
     {
         RESET_FAKE( Agent_InitializePool );
+        RESET_FAKE( Agent_PriorityMessageInit );
         RESET_FAKE( BackoffAlgorithm_InitializeParams );
         RESET_FAKE( BackoffAlgorithm_GetNextBackoff );
         RESET_FAKE( handleIncomingPublishes );
@@ -172,12 +196,18 @@ public:
         RESET_FAKE( SdkLogWarn );
         RESET_FAKE( Transport_Disconnect );
         RESET_FAKE( Transport_Connect );
+        RESET_FAKE( Transport_LoadCredentials );
+        RESET_FAKE( Transport_Recv );
+        RESET_FAKE( Transport_Send );
         RESET_FAKE( vAssertCalled );
+        RESET_FAKE( vBootTimelineMark );
         RESET_FAKE( vTaskDelay );
         RESET_FAKE( vTaskDelete );
         RESET_FAKE( vWaitUntilNetworkIsUp );
         RESET_FAKE( xEventGroupClearBits );
         RESET_FAKE( xEventGroupSetBits );
+        RESET_FAKE( xEventGroupGetBits );
+        RESET_FAKE( xEventGroupWaitBits );
         RESET_FAKE( xTaskCreate );
         RESET_FAKE( xTaskGetCurrentTaskHandle );
         RESET_FAKE( xTaskGetTickCount );
@@ -271,6 +301,23 @@ TransportStatus_t check_if_timeout_less_than_ten_seconds( NetworkContext_t * pNe
     return TRANSPORT_STATUS_SUCCESS;
 }
 
+/* Custom fake for MQTT_Connect */
+uint16_t usLastConnectKeepAliveSeconds = 0;
+MQTTStatus_t record_keep_alive_and_return_success( void * pContext,
+                                                   const MQTTConnectInfo_t * pConnectInfo,
+                                                   const MQTTPublishInfo_t * pWillInfo,
+                                                   uint32_t timeoutMs,
+                                                   bool * pSessionPresent )
+{
+    usLastConnectKeepAliveSeconds = pConnectInfo->keepAliveSeconds;
+    return MQTTSuccess;
+}
+/* Custom fake for MQTTAgent_CommandLoop */
+MQTTStatus_t lose_the_connection_once_then_return_success( MQTTAgentContext_t * pMqttAgentContext )
+{
+    return ( MQTTAgent_CommandLoop_fake.call_count == 1 ) ? MQTTRecvFailed : MQTTSuccess;
+}
+
 /* The  file under test contains static functions which the tests in this file assume are made visible
  * by conditional compiling macros. This test verifies these macros are defined. */
 TEST_F( TestMqttAgentTask, Can_test_static_functions )
@@ -378,7 +425,7 @@ TEST_F( TestMqttAgentTask, Disconnect_from_broker_tries_to_disconnect_from_MQTT_
     Transport_Disconnect_fake.return_val = TRANSPORT_STATUS_SUCCESS;
     xEventGroupClearBits_fake.return_val = 1;
     EXPECT_EQ( MQTTAgent_Disconnect_fake.call_count, 0 );
-    prvDisconnectFromMQTTBroker();
+    prvDisconnectFromMQTTBroker( 0 );
     EXPECT_NE( MQTTAgent_Disconnect_fake.call_count, 0 );
 }
 TEST_F( TestMqttAgentTask, Disconnect_from_broker_tries_to_close_TCP_connection_if_successful )
@@ -392,7 +439,7 @@ TEST_F( TestMqttAgentTask, Disconnect_from_broker_tries_to_close_TCP_connection_
     /* Successful mqtt closure. */
     MQTTAgent_Disconnect_fake.return_val = MQTTSuccess;
     EXPECT_EQ( Transport_Disconnect_fake.call_count, 0 );
-    prvDisconnectFromMQTTBroker();
+    prvDisconnectFromMQTTBroker( 0 );
     EXPECT_NE( Transport_Disconnect_fake.call_count, 0 );
 }
 TEST_F( TestMqttAgentTask, Disconnect_from_broker_errors_on_failure_to_close_TCP_connection )
@@ -405,7 +452,7 @@ TEST_F( TestMqttAgentTask, Disconnect_from_broker_errors_on_failure_to_close_TCP
     /* Fails to close mqtt connection. */
     MQTTAgent_Disconnect_fake.return_val = MQTTSuccess;
     Transport_Disconnect_fake.return_val = TRANSPORT_STATUS_INVALID_PARAMETER;
-    prvDisconnectFromMQTTBroker();
+    prvDisconnectFromMQTTBroker( 0 );
     expect_errors();
 }
 TEST_F( TestMqttAgentTask, Waits_for_MQTT_connection_to_close_before_trying_to_close_TCP_connection )
@@ -419,14 +466,14 @@ TEST_F( TestMqttAgentTask, Waits_for_MQTT_connection_to_close_before_trying_to_c
     MQTTAgent_Disconnect_fake.return_val = MQTTSuccess;
     Transport_Disconnect_fake.return_val = TRANSPORT_STATUS_SUCCESS;
     EXPECT_EQ( xTaskNotifyWait_fake.call_count, 0 );
-    prvDisconnectFromMQTTBroker();
+    prvDisconnectFromMQTTBroker( 0 );
     EXPECT_NE( xTaskNotifyWait_fake.call_count, 0 );
 
     /* Check this is not the case if MQTT closure fails. */
     RESET_FAKE( xTaskNotifyWait );
     MQTTAgent_Disconnect_fake.return_val = MQTTBadParameter;
     EXPECT_EQ( xTaskNotifyWait_fake.call_count, 0 ) << "Failed to reset fake.";
-    EXPECT_THROW( prvDisconnectFromMQTTBroker();
+    EXPECT_THROW( prvDisconnectFromMQTTBroker( 0 );
                   EXPECT_EQ( xTaskNotifyWait_fake.call_count, 0 ), ASSERTION_FAIL );
 }
 TEST_F( TestMqttAgentTask, Disconnect_from_broker_errors_on_failure_to_close_MQTT_connection )
@@ -440,7 +487,7 @@ TEST_F( TestMqttAgentTask, Disconnect_from_broker_errors_on_failure_to_close_MQT
     /* Fails to close mqtt connection. */
     MQTTAgent_Disconnect_fake.return_val = MQTTBadParameter;
     Transport_Disconnect_fake.return_val = TRANSPORT_STATUS_SUCCESS;
-    EXPECT_THROW( prvDisconnectFromMQTTBroker(), ASSERTION_FAIL );
+    EXPECT_THROW( prvDisconnectFromMQTTBroker( 0 ), ASSERTION_FAIL );
     expect_errors();
 }
 
@@ -467,29 +514,29 @@ public:
 TEST_F( TestMqttAgentTaskConnect, MQTT_connect_tries_to_create_a_connection )
 {
     EXPECT_EQ( MQTT_Connect_fake.call_count, 0 );
-    prvMQTTConnect();
+    prvMQTTConnect( 0 );
     EXPECT_NE( MQTT_Connect_fake.call_count, 0 );
 }
 TEST_F( TestMqttAgentTaskConnect, MQTT_connect_returns_failure_if_connection_fails )
 {
     MQTT_Connect_fake.return_val = MQTTBadParameter;
-    EXPECT_NE( prvMQTTConnect(), MQTTSuccess );
+    EXPECT_NE( prvMQTTConnect( 0 ), MQTTSuccess );
 }
 TEST_F( TestMqttAgentTaskConnect, MQTT_connect_returns_success_if_connection_succeeds )
 {
     MQTT_Connect_fake.return_val = MQTTSuccess;
-    EXPECT_EQ( prvMQTTConnect(), MQTTSuccess );
+    EXPECT_EQ( prvMQTTConnect( 0 ), MQTTSuccess );
 }
 /* This test would be ideal, but is not possible to write neatly for the file. */
 /* TEST_F(TestMqttAgentTask, MQTT_connect_updates_system_flags_when_creating_a_new_connection) { */
 /*     EXPECT_EQ(xEventGroupSetBits_fake.call_count, 0); */
-/*     prvMQTTConnect(); */
+/*     prvMQTTConnect( 0 ); */
 /*     EXPECT_NE(xEventGroupSetBits_fake.call_count, 0); */
 /* } */
 TEST_F( TestMqttAgentTaskConnect, MQTT_connect_does_not_set_incorrect_system_flags_when_creating_a_new_connection )
 {
     xEventGroupSetBits_fake.custom_fake = expect_mqtt_connected_event_mask;
-    prvMQTTConnect();
+    prvMQTTConnect( 0 );
 }
 
 /* Testing prvGetTimeMs */
@@ -610,28 +657,16 @@ TEST_F( TestMqttAgentTask, Command_callback_does_not_error_if_given_MQTT_success
 
 /* Testing prvMQTTInit */
 
-TEST_F( TestMqttAgentTask, MQTT_init_tries_to_create_a_command_queue )
-{
-    QueueDefinition queue = { 10 };
-
-    xQueueCreateStatic_fake.return_val = &queue;
-    MQTTAgent_Init_fake.return_val = MQTTSuccess;
-    xEventGroupSetBits_fake.return_val = 1;
-
-    EXPECT_EQ( xQueueCreateStatic_fake.call_count, 0 );
-    prvMQTTInit();
-    EXPECT_NE( xQueueCreateStatic_fake.call_count, 0 );
-}
-TEST_F( TestMqttAgentTask, MQTT_init_errors_if_command_queue_creation_returns_nullptr )
+TEST_F( TestMqttAgentTask, MQTT_init_tries_to_create_the_priority_command_queues )
 {
-    /* E.g. happens if out of memory. */
-    xQueueCreateStatic_fake.return_val = nullptr;
     MQTTAgent_Init_fake.return_val = MQTTSuccess;
     xEventGroupSetBits_fake.return_val = 1;
 
-    EXPECT_EQ( xQueueCreateStatic_fake.call_count, 0 );
-    EXPECT_THROW( prvMQTTInit(), ASSERTION_FAIL );
-    EXPECT_NE( xQueueCreateStatic_fake.call_count, 0 );
+    EXPECT_EQ( Agent_PriorityMessageInit_fake.call_count, 0 );
+    prvMQTTInit( 0 );
+    EXPECT_EQ( Agent_PriorityMessageInit_fake.call_count, 1 );
+    EXPECT_NE( Agent_PriorityMessageInit_fake.arg0_val, nullptr );
+    EXPECT_NE( Agent_PriorityMessageInit_fake.arg1_val, nullptr );
 }
 TEST_F( TestMqttAgentTask, MQTT_init_tries_to_initialise_MQTT_library )
 {
@@ -642,7 +677,7 @@ TEST_F( TestMqttAgentTask, MQTT_init_tries_to_initialise_MQTT_library )
     xEventGroupSetBits_fake.return_val = 1;
 
     EXPECT_EQ( MQTTAgent_Init_fake.call_count, 0 );
-    prvMQTTInit();
+    prvMQTTInit( 0 );
     EXPECT_NE( MQTTAgent_Init_fake.call_count, 0 );
 }
 TEST_F( TestMqttAgentTask, MQTT_init_errors_if_cannot_initialise_MQTT_library )
@@ -653,7 +688,7 @@ TEST_F( TestMqttAgentTask, MQTT_init_errors_if_cannot_initialise_MQTT_library )
     MQTTAgent_Init_fake.return_val = MQTTBadParameter;
     xEventGroupSetBits_fake.return_val = 1;
 
-    prvMQTTInit();
+    prvMQTTInit( 0 );
     expect_errors();
 }
 TEST_F( TestMqttAgentTask, MQTT_init_returns_success_if_successful )
@@ -664,7 +699,7 @@ TEST_F( TestMqttAgentTask, MQTT_init_returns_success_if_successful )
     MQTTAgent_Init_fake.return_val = MQTTSuccess;
     xEventGroupSetBits_fake.return_val = 1;
 
-    EXPECT_EQ( prvMQTTInit(), MQTTSuccess );
+    EXPECT_EQ( prvMQTTInit( 0 ), MQTTSuccess );
 }
 TEST_F( TestMqttAgentTask, MQTT_init_sets_system_MQTT_init_event_flag_if_successful )
 {
@@ -675,7 +710,7 @@ TEST_F( TestMqttAgentTask, MQTT_init_sets_system_MQTT_init_event_flag_if_success
     xEventGroupSetBits_fake.return_val = 1;
 
     EXPECT_EQ( xEventGroupSetBits_fake.call_count, 0 );
-    prvMQTTInit();
+    prvMQTTInit( 0 );
     EXPECT_NE( xEventGroupSetBits_fake.call_count, 0 );
 }
 
@@ -684,7 +719,7 @@ TEST_F( TestMqttAgentTask, Resubscribe_returns_success_if_subscription_succeeds
 {
     MQTTAgent_Subscribe_fake.return_val = MQTTSuccess;
     MQTT_Status_strerror_fake.return_val = "dummy";
-    EXPECT_EQ( prvHandleResubscribe(), MQTTSuccess );
+    EXPECT_EQ( prvHandleResubscribe( 0 ), MQTTSuccess );
 }
 
 /* Testing prvDisconnectCommandCallback */
@@ -788,6 +823,11 @@ TEST_F( TestMqttAgentTaskMainFunction, Agent_task_waits_for_network_to_start )
     prvMQTTAgentTask( nullptr );
     EXPECT_NE( vWaitUntilNetworkIsUp_fake.call_count, 0 );
 }
+TEST_F( TestMqttAgentTaskMainFunction, Agent_task_loads_the_TLS_credentials_before_the_network_is_up )
+{
+    prvMQTTAgentTask( nullptr );
+    EXPECT_EQ( Transport_LoadCredentials_fake.call_count, 1 );
+}
 TEST_F( TestMqttAgentTaskMainFunction, Agent_task_initialises_MQTT_library )
 {
     EXPECT_EQ( MQTTAgent_Init_fake.call_count, 0 );
@@ -813,3 +853,253 @@ TEST_F( TestMqttAgentTaskMainFunction, Agent_task_initialises_MQTT_pool )
     prvMQTTAgentTask( nullptr );
     EXPECT_NE( Agent_InitializePool_fake.call_count, 0 );
 }
+
+/* Testing the link-health monitor */
+
+/* Custom fake for MQTTAgent_Init */
+NetworkContext_t * pxInitializedNetworkContext = nullptr;
+MQTTStatus_t record_network_context_and_return_success( MQTTAgentContext_t * pMqttAgentContext,
+                                                        const MQTTAgentMessageInterface_t * pMsgInterface,
+                                                        const MQTTFixedBuffer_t * pNetworkBuffer,
+                                                        const TransportInterface_t * pTransportInterface,
+                                                        MQTTGetCurrentTimeFunc_t getCurrentTimeMs,
+                                                        MQTTAgentIncomingPublishCallback_t incomingCallback,
+                                                        int * pIncomingPacketContext )
+{
+    pxInitializedNetworkContext = pTransportInterface->pNetworkContext;
+    return MQTTSuccess;
+}
+
+/* Bytes the transport hands to the next receive. */
+static std::vector<uint8_t> xReceivedBytes;
+
+int32_t copy_received_bytes( NetworkContext_t * pNetworkContext,
+                             void * pBuffer,
+                             size_t bytesToRecv )
+{
+    size_t xLength = std::min( bytesToRecv, xReceivedBytes.size() );
+
+    std::copy( xReceivedBytes.begin(), xReceivedBytes.begin() + xLength, static_cast<uint8_t *>( pBuffer ) );
+    xReceivedBytes.erase( xReceivedBytes.begin(), xReceivedBytes.begin() + xLength );
+
+    return static_cast<int32_t>( xLength );
+}
+
+class TestMqttAgentTaskLinkHealth : public TestMqttAgentTask {
+public:
+    TestMqttAgentTaskLinkHealth()
+    {
+        /* The link health of a connection is reset when it is initialised. */
+        QueueDefinition queue = { 10 };
+
+        xQueueCreateStatic_fake.return_val = &queue;
+        MQTTAgent_Init_fake.custom_fake = record_network_context_and_return_success;
+        Transport_Recv_fake.custom_fake = copy_received_bytes;
+        prvMQTTInit( 0 );
+        vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xBefore );
+    }
+
+    void send( const std::vector<uint8_t> & xBytes,
+               TickType_t xTick )
+    {
+        xTaskGetTickCount_fake.return_val = xTick;
+        Transport_Send_fake.return_val = static_cast<int32_t>( xBytes.size() );
+        EXPECT_EQ( prvTransportSend( pxInitializedNetworkContext, xBytes.data(), xBytes.size() ), static_cast<int32_t>( xBytes.size() ) );
+    }
+
+    void receive( const std::vector<uint8_t> & xBytes,
+                  TickType_t xTick )
+    {
+        uint8_t ucBuffer[ 64 ];
+
+        xTaskGetTickCount_fake.return_val = xTick;
+        xReceivedBytes = xBytes;
+        EXPECT_EQ( prvTransportRecv( pxInitializedNetworkContext, ucBuffer, sizeof( ucBuffer ) ), static_cast<int32_t>( xBytes.size() ) );
+    }
+
+    MqttAgentLinkHealth_t after()
+    {
+        MqttAgentLinkHealth_t xAfter;
+
+        vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xAfter );
+
+        return xAfter;
+    }
+
+    MqttAgentLinkHealth_t xBefore;
+};
+
+TEST_F( TestMqttAgentTaskLinkHealth, Round_trip_time_is_measured_from_ping_request_to_response )
+{
+    send( { 0xC0, 0x00 }, 100 );
+    receive( { 0xD0, 0x00 }, 150 );
+
+    EXPECT_EQ( after().ulLastRttMs, 50 );
+    EXPECT_EQ( after().ulRttSamples, xBefore.ulRttSamples + 1 );
+    expect_no_errors();
+}
+TEST_F( TestMqttAgentTaskLinkHealth, Round_trip_time_is_not_sampled_for_unacknowledged_packets )
+{
+    /* QoS0 PUBLISH to "t", answered by nothing. */
+    send( { 0x30, 0x04, 0x00, 0x01, 't', 'x' }, 100 );
+    receive( { 0xD0, 0x00 }, 150 );
+
+    EXPECT_EQ( after().ulRttSamples, xBefore.ulRttSamples );
+}
+TEST_F( TestMqttAgentTaskLinkHealth, Round_trip_time_is_not_ended_by_other_inbound_packets )
+{
+    send( { 0xC0, 0x00 }, 100 );
+
+    /* An incoming QoS1 PUBLISH carrying packet identifier 0xD000, then a
+     * PUBACK nobody asked for. */
+    receive( { 0x32, 0x06, 0x00, 0x01, 't', 0xD0, 0x00, 'x' }, 120 );
+    receive( { 0x40, 0x02, 0x00, 0x01 }, 130 );
+    EXPECT_EQ( after().ulRttSamples, xBefore.ulRttSamples );
+
+    receive( { 0xD0, 0x00 }, 170 );
+    EXPECT_EQ( after().ulLastRttMs, 70 );
+    EXPECT_EQ( after().ulRttSamples, xBefore.ulRttSamples + 1 );
+}
+TEST_F( TestMqttAgentTaskLinkHealth, Round_trip_time_of_a_publish_ends_on_its_own_acknowledgement )
+{
+    /* coreMQTT sends the fixed header, the topic, the packet identifier and
+     * the payload of a PUBLISH separately. */
+    send( { 0x32, 0x08 }, 100 );
+    send( { 0x00, 0x02, 'a', 'b' }, 100 );
+    send( { 0x12, 0x34 }, 100 );
+    send( { 'x', 'y' }, 100 );
+
+    receive( { 0x40, 0x02, 0x12, 0x33 }, 110 );
+    EXPECT_EQ( after().ulRttSamples, xBefore.ulRttSamples );
+
+    /* Acknowledgements split across receives are followed too. */
+    receive( { 0x40 }, 120 );
+    receive( { 0x02, 0x12 }, 120 );
+    receive( { 0x34 }, 125 );
+    EXPECT_EQ( after().ulLastRttMs, 25 );
+    EXPECT_EQ( after().ulRttSamples, xBefore.ulRttSamples + 1 );
+    expect_no_errors();
+}
+TEST_F( TestMqttAgentTaskLinkHealth, Round_trip_time_is_measured_for_subscriptions_with_long_lengths )
+{
+    std::vector<uint8_t> xSubscribe = { 0x82, 0x81, 0x01, 0x00, 0x07, 0x00, 0x7C };
+
+    /* SUBSCRIBE of remaining length 129, to a topic filter of 124 bytes. */
+    xSubscribe.resize( xSubscribe.size() + 124, 'f' );
+    xSubscribe.push_back( 0x01 );
+    send( xSubscribe, 100 );
+
+    receive( { 0x90, 0x03, 0x00, 0x07, 0x01 }, 140 );
+    EXPECT_EQ( after().ulLastRttMs, 40 );
+    EXPECT_EQ( after().ulRttSamples, xBefore.ulRttSamples + 1 );
+}
+TEST_F( TestMqttAgentTaskLinkHealth, Keep_alive_shrinks_to_the_minimum_after_keep_alive_timeouts )
+{
+    MqttAgentLinkHealth_t xBefore, xAfter;
+
+    vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xBefore );
+
+    for( int i = 0; i < 10; i++ )
+    {
+        prvLinkHealthRecordDisconnect( 0, MQTTKeepAliveTimeout, UINT32_MAX );
+    }
+
+    vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xAfter );
+    EXPECT_EQ( xAfter.usKeepAliveSeconds, 30 );
+    EXPECT_EQ( xAfter.ulKeepAliveTimeouts, xBefore.ulKeepAliveTimeouts + 10 );
+    expect_no_errors();
+}
+TEST_F( TestMqttAgentTaskLinkHealth, Keep_alive_grows_to_the_maximum_after_long_stable_sessions )
+{
+    MqttAgentLinkHealth_t xBefore, xAfter;
+
+    vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xBefore );
+
+    for( int i = 0; i < 10; i++ )
+    {
+        prvLinkHealthRecordDisconnect( 0, MQTTRecvFailed, UINT32_MAX );
+    }
+
+    vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xAfter );
+    EXPECT_EQ( xAfter.usKeepAliveSeconds, 400 );
+    EXPECT_EQ( xAfter.ulRecvFailures, xBefore.ulRecvFailures + 10 );
+    expect_no_errors();
+}
+TEST_F( TestMqttAgentTaskLinkHealth, Keep_alive_shrinks_after_a_short_session )
+{
+    MqttAgentLinkHealth_t xBefore, xAfter;
+
+    prvLinkHealthRecordDisconnect( 0, MQTTRecvFailed, UINT32_MAX );
+    vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xBefore );
+    prvLinkHealthRecordDisconnect( 0, MQTTSendFailed, 0 );
+    vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xAfter );
+
+    EXPECT_LT( xAfter.usKeepAliveSeconds, xBefore.usKeepAliveSeconds );
+    EXPECT_EQ( xAfter.ulSendFailures, xBefore.ulSendFailures + 1 );
+}
+TEST_F( TestMqttAgentTaskLinkHealth, Backoff_ceiling_follows_the_connection_failure_rate )
+{
+    MqttAgentLinkHealth_t xLinkHealth;
+
+    for( int i = 0; i < 50; i++ )
+    {
+        prvLinkHealthRecordConnect( 0, pdFAIL );
+    }
+
+    vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xLinkHealth );
+    EXPECT_GT( xLinkHealth.usBackoffCeilingMs, 55000 );
+    EXPECT_LE( xLinkHealth.usBackoffCeilingMs, 60000 );
+
+    for( int i = 0; i < 50; i++ )
+    {
+        prvLinkHealthRecordConnect( 0, pdPASS );
+    }
+
+    vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xLinkHealth );
+    EXPECT_LT( xLinkHealth.usBackoffCeilingMs, 25000 );
+    expect_no_errors();
+}
+TEST_F( TestMqttAgentTaskLinkHealth, MQTT_connect_uses_the_adapted_keep_alive )
+{
+    MqttAgentLinkHealth_t xLinkHealth;
+
+    prvLinkHealthRecordDisconnect( 0, MQTTKeepAliveTimeout, 0 );
+    vGetMqttAgentLinkHealth( eMqttAgentConnectionControl, &xLinkHealth );
+
+    MQTT_Connect_fake.custom_fake = record_keep_alive_and_return_success;
+    prvMQTTConnect( 0 );
+    EXPECT_EQ( usLastConnectKeepAliveSeconds, xLinkHealth.usKeepAliveSeconds );
+}
+TEST_F( TestMqttAgentTaskMainFunction, Agent_task_resets_backoff_after_a_lost_connection )
+{
+    MQTTAgent_CommandLoop_fake.custom_fake = lose_the_connection_once_then_return_success;
+
+    prvMQTTAgentTask( nullptr );
+
+    EXPECT_EQ( MQTTAgent_CommandLoop_fake.call_count, 2 );
+    EXPECT_EQ( BackoffAlgorithm_InitializeParams_fake.call_count, 2 );
+}
+TEST_F( TestMqttAgentTask, Connection_identifiers_share_the_only_connection_by_default )
+{
+    EXPECT_EQ( pxGetMqttAgentContext( eMqttAgentConnectionBulk ),
+               pxGetMqttAgentContext( eMqttAgentConnectionControl ) );
+}
+TEST_F( TestMqttAgentTask, Each_connection_has_its_own_connected_event )
+{
+    EXPECT_EQ( prvConnectedEventMask( eMqttAgentConnectionControl ), EVENT_MASK_MQTT_CONNECTED );
+    EXPECT_EQ( prvConnectedEventMask( eMqttAgentConnectionBulk ), EVENT_MASK_MQTT_BULK_CONNECTED );
+}
+TEST_F( TestMqttAgentTask, Connection_identifiers_sharing_a_connection_share_its_connected_state )
+{
+    xEventGroupGetBits_fake.return_val = EVENT_MASK_MQTT_CONNECTED;
+    EXPECT_TRUE( xIsMqttAgentConnectionConnected( eMqttAgentConnectionControl ) );
+    EXPECT_TRUE( xIsMqttAgentConnectionConnected( eMqttAgentConnectionBulk ) );
+
+    xEventGroupGetBits_fake.return_val = EVENT_MASK_MQTT_BULK_CONNECTED;
+    EXPECT_FALSE( xIsMqttAgentConnectionConnected( eMqttAgentConnectionControl ) );
+    EXPECT_FALSE( xIsMqttAgentConnectionConnected( eMqttAgentConnectionBulk ) );
+
+    vWaitUntilMqttAgentConnectionConnected( eMqttAgentConnectionBulk );
+    EXPECT_EQ( xEventGroupWaitBits_fake.arg1_val, EVENT_MASK_MQTT_CONNECTED );
+    EXPECT_EQ( xEventGroupWaitBits_fake.arg4_val, portMAX_DELAY );
+}
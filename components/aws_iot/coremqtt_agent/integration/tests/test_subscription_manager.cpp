@@ -72,6 +72,8 @@ public:
 
 int context[ 10 ]; /* should not write to this if using it during a test. */
 
+SubscriptionElement_t xSubscriptionList[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];
+
 void expect_no_errors( void )
 {
     ASSERT_EQ( SdkLogError_fake.call_count, 0 );
@@ -90,7 +92,8 @@ void expect_no_warnings_or_errors( void )
 }
 
 /*
- * bool addSubscription( const char * pcTopicFilterString,
+ * bool addSubscription( SubscriptionElement_t * pxSubscriptionList,
+ *                    const char * pcTopicFilterString,
  *                    uint16_t usTopicFilterLength,
  *                    IncomingPubCallback_t pxIncomingPublishCallback,
  *                    void * pvIncomingPublishCallbackContext );
@@ -100,42 +103,42 @@ void expect_no_warnings_or_errors( void )
 
 TEST_F( TestSubscriptionManager, adding_a_nullptr_callback_function_does_not_segfault )
 {
-    addSubscription( "dummy", 5, nullptr, context );
+    addSubscription( xSubscriptionList, "dummy", 5, nullptr, context );
 }
 
 TEST_F( TestSubscriptionManager, adding_a_nullptr_topic_name_does_not_segfault )
 {
-    addSubscription( nullptr, 5, dummyCallback, context );
+    addSubscription( xSubscriptionList, nullptr, 5, dummyCallback, context );
 }
 
 TEST_F( TestSubscriptionManager, adding_a_nullptr_callback_context_does_not_segfault )
 {
-    addSubscription( "dummy", 5, dummyCallback, nullptr );
+    addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, nullptr );
 }
 
 TEST_F( TestSubscriptionManager, adding_a_valid_subscription_does_not_error )
 {
-    addSubscription( "dummy", 5, dummyCallback, context );
+    addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, context );
     expect_no_errors();
 }
 
 TEST_F( TestSubscriptionManager, adding_a_valid_subscription_returns_true )
 {
-    EXPECT_TRUE( addSubscription( "dummy", 5, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, context ) );
     expect_no_warnings_or_errors();
 }
 
 TEST_F( TestSubscriptionManager, adding_two_subscriptions_with_different_callbacks_returns_true )
 {
-    EXPECT_TRUE( addSubscription( "dummy", 5, dummyCallback, context ) );
-    EXPECT_TRUE( addSubscription( "dummy", 5, dummyCallback2, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy", 5, dummyCallback2, context ) );
     expect_no_warnings_or_errors();
 }
 
 TEST_F( TestSubscriptionManager, adding_two_subscriptions_which_differ_only_by_topic_should_succeed )
 {
-    EXPECT_TRUE( addSubscription( "dummy", 5, dummyCallback, context ) );
-    EXPECT_TRUE( addSubscription( "dummy2", 6, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy2", 6, dummyCallback, context ) );
     expect_no_warnings_or_errors();
 }
 
@@ -144,7 +147,7 @@ TEST_F( TestSubscriptionManager, can_handle_empty_topic_name )
     std::string str = "";
     const char * veryShortTopicName = str.c_str();
 
-    EXPECT_FALSE( addSubscription( veryShortTopicName, 0, dummyCallback, context ) );
+    EXPECT_FALSE( addSubscription( xSubscriptionList, veryShortTopicName, 0, dummyCallback, context ) );
 }
 
 TEST_F( TestSubscriptionManager, can_handle_very_long_topic_names )
@@ -161,24 +164,24 @@ TEST_F( TestSubscriptionManager, can_handle_very_long_topic_names )
                       "this is a very large string this is a very large string";
     const char * veryLongTopicName = str.c_str();
 
-    EXPECT_TRUE( addSubscription( veryLongTopicName, 551, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, veryLongTopicName, 551, dummyCallback, context ) );
     expect_no_warnings_or_errors();
 }
 
 /* This test also verifies it has been added correctly. */
 TEST_F( TestSubscriptionManager, adding_the_same_subscription_twice_causes_warnings )
 {
-    EXPECT_TRUE( addSubscription( "dummy", 5, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, context ) );
     expect_no_warnings_or_errors();
-    EXPECT_TRUE( addSubscription( "dummy", 5, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, context ) );
     expect_warnings();
 }
 
 TEST_F( TestSubscriptionManager, adding_duplicate_subscriptions_returns_true )
 {
-    EXPECT_TRUE( addSubscription( "dummy", 5, dummyCallback, context ) );
-    EXPECT_TRUE( addSubscription( "dummy", 5, dummyCallback, context ) );
-    EXPECT_TRUE( addSubscription( "dummy", 5, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "dummy", 5, dummyCallback, context ) );
 }
 
 TEST_F( TestSubscriptionManager, subscription_manager_eventually_cannot_add_subscriptions )
@@ -191,11 +194,11 @@ TEST_F( TestSubscriptionManager, subscription_manager_eventually_cannot_add_subs
     for( uint32_t i = 0; i < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS + excessSubscriptions; i++ )
     {
         topics[ i ] = std::to_string( i );
-        outOfMemory = !addSubscription( topics[ i ].c_str(), topics[ i ].length(), dummyCallback, context );
+        outOfMemory = !addSubscription( xSubscriptionList, topics[ i ].c_str(), topics[ i ].length(), dummyCallback, context );
     }
 
     EXPECT_TRUE( outOfMemory ) << "Appeared to add more subscriptions than the maximum limit.";
-    EXPECT_FALSE( addSubscription( "uniqueName", 5, dummyCallback, context ) ) << "Can still add subscriptions. Should be full.";
+    EXPECT_FALSE( addSubscription( xSubscriptionList, "uniqueName", 5, dummyCallback, context ) ) << "Can still add subscriptions. Should be full.";
 }
 
 TEST_F( TestSubscriptionManager, subscription_manager_has_the_correct_maximum_subscription_amount )
@@ -209,7 +212,7 @@ TEST_F( TestSubscriptionManager, subscription_manager_has_the_correct_maximum_su
     for( uint32_t i = 0; i < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS + excessSubscriptions; i++ )
     {
         topics[ i ] = std::to_string( i );
-        outOfMemory = !addSubscription( topics[ i ].c_str(), topics[ i ].length(), dummyCallback, ctxt );
+        outOfMemory = !addSubscription( xSubscriptionList, topics[ i ].c_str(), topics[ i ].length(), dummyCallback, ctxt );
 
         if( outOfMemory )
         {
@@ -229,52 +232,53 @@ TEST_F( TestSubscriptionManager, subscription_manager_does_not_overwrite_undelet
     for( uint32_t i = 0; i < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS + excessSubscriptions; i++ )
     {
         topics[ i ] = std::to_string( i );
-        outOfMemory = !addSubscription( topics[ i ].c_str(), topics[ i ].length(), dummyCallback, context );
+        outOfMemory = !addSubscription( xSubscriptionList, topics[ i ].c_str(), topics[ i ].length(), dummyCallback, context );
     }
 
     /* Should be out of memory. */
-    EXPECT_TRUE( addSubscription( "0", 1, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "0", 1, dummyCallback, context ) );
 }
 
 /*
- * bool removeSubscription( const char * pcTopicFilterString,
+ * bool removeSubscription( SubscriptionElement_t * pxSubscriptionList,
+ *                       const char * pcTopicFilterString,
  *                       uint16_t usTopicFilterLength );
  */
 
 
 TEST_F( TestSubscriptionManager, trying_to_remove_a_subscription_that_does_not_exist_does_not_error )
 {
-    removeSubscription( "doesNotExist", 13 );
+    removeSubscription( xSubscriptionList, "doesNotExist", 13 );
     expect_no_errors();
 }
 
 TEST_F( TestSubscriptionManager, adding_then_removing_a_subscription_does_not_error )
 {
-    EXPECT_TRUE( addSubscription( "0", 1, dummyCallback, context ) );
-    removeSubscription( "0", 1 );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "0", 1, dummyCallback, context ) );
+    removeSubscription( xSubscriptionList, "0", 1 );
     expect_no_errors();
 }
 
 TEST_F( TestSubscriptionManager, removing_a_subscription_successfully_returns_true )
 {
-    EXPECT_TRUE( addSubscription( "0", 1, dummyCallback, context ) );
-    EXPECT_TRUE( removeSubscription( "0", 1 ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "0", 1, dummyCallback, context ) );
+    EXPECT_TRUE( removeSubscription( xSubscriptionList, "0", 1 ) );
     expect_no_warnings_or_errors();
 }
 
 TEST_F( TestSubscriptionManager, adding_then_removing_a_subscription_actually_removes_it )
 {
-    EXPECT_TRUE( addSubscription( "0", 1, dummyCallback, context ) );
-    removeSubscription( "0", 1 );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "0", 1, dummyCallback, context ) );
+    removeSubscription( xSubscriptionList, "0", 1 );
     expect_no_warnings_or_errors();
     /* try to add the same subscription back. Should not get a warning that it already exists. */
-    EXPECT_TRUE( addSubscription( "0", 1, dummyCallback, context ) );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "0", 1, dummyCallback, context ) );
     expect_no_warnings_or_errors();
 }
 
 TEST_F( TestSubscriptionManager, failure_to_remove_a_subscription_returns_false )
 {
-    EXPECT_FALSE( removeSubscription( "0", 1 ) );
+    EXPECT_FALSE( removeSubscription( xSubscriptionList, "0", 1 ) );
 }
 
 
@@ -287,7 +291,7 @@ TEST_F( TestSubscriptionManager, get_no_failures_when_adding_then_removing_a_lot
     for( uint32_t i = 0; i < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS; i++ )
     {
         topics[ i ] = std::to_string( i );
-        outOfMemory = !addSubscription( topics[ i ].c_str(), topics[ i ].length(), dummyCallback, context );
+        outOfMemory = !addSubscription( xSubscriptionList, topics[ i ].c_str(), topics[ i ].length(), dummyCallback, context );
     }
 
     /* Should be out of memory. */
@@ -295,7 +299,7 @@ TEST_F( TestSubscriptionManager, get_no_failures_when_adding_then_removing_a_lot
 
     for( uint32_t i = 0; i < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS; i++ )
     {
-        removeSubscription( topics[ i ].c_str(), topics[ i ].length() );
+        removeSubscription( xSubscriptionList, topics[ i ].c_str(), topics[ i ].length() );
     }
 
     expect_no_warnings_or_errors();
@@ -310,17 +314,18 @@ TEST_F( TestSubscriptionManager, removing_from_a_full_subscription_list_creates_
     for( uint32_t i = 0; i < SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS + excessSubscriptions; i++ )
     {
         topics[ i ] = std::to_string( i );
-        outOfMemory = !addSubscription( topics[ i ].c_str(), topics[ i ].length(), dummyCallback, context );
+        outOfMemory = !addSubscription( xSubscriptionList, topics[ i ].c_str(), topics[ i ].length(), dummyCallback, context );
     }
 
     expect_no_warnings_or_errors();
     EXPECT_TRUE( outOfMemory );
-    removeSubscription( "0", 1 );
-    EXPECT_TRUE( addSubscription( "50", 2, dummyCallback, context ) );
+    removeSubscription( xSubscriptionList, "0", 1 );
+    EXPECT_TRUE( addSubscription( xSubscriptionList, "50", 2, dummyCallback, context ) );
 }
 
 /*
- * bool handleIncomingPublishes( MQTTPublishInfo_t * pxPublishInfo );
+ * bool handleIncomingPublishes( SubscriptionElement_t * pxSubscriptionList,
+ *                            MQTTPublishInfo_t * pxPublishInfo );
  */
 
 TEST_F( TestSubscriptionManager, callback_handler_does_not_error_if_passed_read_only_topic_name )
@@ -335,7 +340,7 @@ TEST_F( TestSubscriptionManager, callback_handler_does_not_error_if_passed_read_
         0
     };
 
-    handleIncomingPublishes( &info );
+    handleIncomingPublishes( xSubscriptionList, &info );
     expect_no_errors();
 }
 
@@ -365,7 +370,7 @@ MQTTStatus_t set_match_true_if_valid( const char * pTopicName,
 
 TEST_F( TestSubscriptionManager, callback_handler_validates_handler_for_subscription )
 {
-    addSubscription( "dummy/#", 8, dummyCallback, context );
+    addSubscription( xSubscriptionList, "dummy/#", 8, dummyCallback, context );
     MQTTPublishInfo_t info = {
         MQTTQoS0,
         true,
@@ -375,7 +380,7 @@ TEST_F( TestSubscriptionManager, callback_handler_validates_handler_for_subscrip
         nullptr,
         0
     };
-    handleIncomingPublishes( &info );
+    handleIncomingPublishes( xSubscriptionList, &info );
     EXPECT_NE( MQTT_MatchTopic_fake.call_count, 0 );
 }
 
@@ -391,13 +396,13 @@ TEST_F( TestSubscriptionManager, callback_handler_does_not_error_if_no_subscript
         nullptr,
         0
     };
-    handleIncomingPublishes( &info );
+    handleIncomingPublishes( xSubscriptionList, &info );
     expect_no_errors();
 }
 
 TEST_F( TestSubscriptionManager, callback_handler_does_not_call_handler_if_topic_does_not_match_any_subscriptions )
 {
-    addSubscription( "dummy/#", 8, dummyCallback, context );
+    addSubscription( xSubscriptionList, "dummy/#", 8, dummyCallback, context );
     MQTT_MatchTopic_fake.custom_fake = set_match_false; /* topic does not match. */
     MQTTPublishInfo_t info = {
         MQTTQoS0,
@@ -408,14 +413,14 @@ TEST_F( TestSubscriptionManager, callback_handler_does_not_call_handler_if_topic
         nullptr,
         0
     };
-    handleIncomingPublishes( &info );
+    handleIncomingPublishes( xSubscriptionList, &info );
     expect_no_errors();
     EXPECT_EQ( dummyCallback2_fake.call_count, 0 );
 }
 
 TEST_F( TestSubscriptionManager, callback_handler_calls_handler_if_topic_matches_subscription )
 {
-    addSubscription( "dummy/#", 8, dummyCallback, context );
+    addSubscription( xSubscriptionList, "dummy/#", 8, dummyCallback, context );
     MQTT_MatchTopic_fake.custom_fake = set_match_true_if_valid; /* topic always matches (if not empty subscriptionc) */
     MQTTPublishInfo_t info = {
         MQTTQoS0,
@@ -426,7 +431,7 @@ TEST_F( TestSubscriptionManager, callback_handler_calls_handler_if_topic_matches
         nullptr,
         0
     };
-    handleIncomingPublishes( &info );
+    handleIncomingPublishes( xSubscriptionList, &info );
     expect_no_errors();
     EXPECT_NE( dummyCallback_fake.call_count, 0 );
 }
@@ -443,13 +448,13 @@ TEST_F( TestSubscriptionManager, callback_handler_returns_false_if_no_subscripti
         nullptr,
         0
     };
-    EXPECT_FALSE( handleIncomingPublishes( &info ) );
+    EXPECT_FALSE( handleIncomingPublishes( xSubscriptionList, &info ) );
     expect_no_errors();
 }
 
 TEST_F( TestSubscriptionManager, callback_handler_returns_true_if_matching_subscription_exists_for_topic )
 {
-    addSubscription( "dummy/#", 8, dummyCallback, context );
+    addSubscription( xSubscriptionList, "dummy/#", 8, dummyCallback, context );
     MQTT_MatchTopic_fake.custom_fake = set_match_true_if_valid; /* topic always matches (if not empty subscriptionc) */
     MQTTPublishInfo_t info = {
         MQTTQoS0,
@@ -460,18 +465,18 @@ TEST_F( TestSubscriptionManager, callback_handler_returns_true_if_matching_subsc
         nullptr,
         0
     };
-    EXPECT_TRUE( handleIncomingPublishes( &info ) );
+    EXPECT_TRUE( handleIncomingPublishes( xSubscriptionList, &info ) );
     expect_no_errors();
 }
 
 TEST_F( TestSubscriptionManager, callback_handler_does_not_segfault_if_null_subscription_info_passed )
 {
-    handleIncomingPublishes( nullptr );
+    handleIncomingPublishes( xSubscriptionList, nullptr );
 }
 
 TEST_F( TestSubscriptionManager, callback_handler_calls_callback_function_a_single_time )
 {
-    addSubscription( "dummy/#", 8, dummyCallback, context );
+    addSubscription( xSubscriptionList, "dummy/#", 8, dummyCallback, context );
     MQTT_MatchTopic_fake.custom_fake = set_match_true_if_valid; /* topic always matches (if not empty subscriptionc) */
     MQTTPublishInfo_t info = {
         MQTTQoS0,
@@ -482,16 +487,16 @@ TEST_F( TestSubscriptionManager, callback_handler_calls_callback_function_a_sing
         nullptr,
         0
     };
-    handleIncomingPublishes( &info );
+    handleIncomingPublishes( xSubscriptionList, &info );
     expect_no_errors();
     EXPECT_EQ( dummyCallback_fake.call_count, 1 );
 }
 
 TEST_F( TestSubscriptionManager, callback_handler_calls_callback_function_for_every_matching_subscription )
 {
-    addSubscription( "dummy/#", 8, dummyCallback, context );
-    addSubscription( "dummy/", 8, dummyCallback2, context );
-    addSubscription( "dummy/##", 8, dummyCallback, context );
+    addSubscription( xSubscriptionList, "dummy/#", 8, dummyCallback, context );
+    addSubscription( xSubscriptionList, "dummy/", 8, dummyCallback2, context );
+    addSubscription( xSubscriptionList, "dummy/##", 8, dummyCallback, context );
     MQTT_MatchTopic_fake.custom_fake = set_match_true_if_valid; /* topic always matches (if not empty subscriptionc) */
     MQTTPublishInfo_t info = {
         MQTTQoS0,
@@ -502,8 +507,27 @@ TEST_F( TestSubscriptionManager, callback_handler_calls_callback_function_for_ev
         nullptr,
         0
     };
-    handleIncomingPublishes( &info );
+    handleIncomingPublishes( xSubscriptionList, &info );
     expect_no_errors();
     EXPECT_EQ( dummyCallback_fake.call_count, 2 );
     EXPECT_EQ( dummyCallback2_fake.call_count, 1 );
 }
+TEST_F( TestSubscriptionManager, callback_handler_ignores_subscriptions_in_other_lists )
+{
+    SubscriptionElement_t xOtherSubscriptionList[ SUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ] = {};
+
+    addSubscription( xOtherSubscriptionList, "dummy/#", 8, dummyCallback, context );
+    MQTT_MatchTopic_fake.custom_fake = set_match_true_if_valid; /* topic always matches (if not empty subscriptionc) */
+    MQTTPublishInfo_t info = {
+        MQTTQoS0,
+        true,
+        true,
+        "dummy/test",
+        9,
+        nullptr,
+        0
+    };
+    EXPECT_FALSE( handleIncomingPublishes( xSubscriptionList, &info ) );
+    EXPECT_EQ( dummyCallback_fake.call_count, 0 );
+    expect_no_errors();
+}
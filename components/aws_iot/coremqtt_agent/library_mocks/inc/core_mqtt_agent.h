@@ -33,8 +33,23 @@
 #include "fff.h"
 #include "transport_interface.h"
 
+typedef enum MQTTAgentCommandType
+{
+    NONE = 0,
+    PROCESSLOOP,
+    PUBLISH,
+    SUBSCRIBE,
+    UNSUBSCRIBE,
+    PING,
+    CONNECT,
+    DISCONNECT,
+    TERMINATE,
+    NUM_COMMANDS
+} MQTTAgentCommandType_t;
+
 struct MQTTAgentCommand
 {
+    MQTTAgentCommandType_t commandType;
     void * pArgs;
 };
 typedef struct MQTTAgentCommand MQTTAgentCommand_t;
@@ -40,7 +40,7 @@ typedef enum BackoffAlgorithmStatus
 
 typedef struct BackoffAlgorithmContext
 {
-    int dummy;
+    uint16_t maxBackoffDelay;
 } BackoffAlgorithmContext_t;
 
 DECLARE_FAKE_VALUE_FUNC( BackoffAlgorithmStatus_t,
@@ -0,0 +1,64 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file dns_cache.h
+ * @brief Host name resolution with address reuse and last-known-good
+ * fallback, shared by the TLS transport and the SNTP client.
+ */
+
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Maximum number of host names remembered by the cache.
+ */
+#ifndef dnscacheMAX_ENTRIES
+    #define dnscacheMAX_ENTRIES             ( 4U )
+#endif
+
+/**
+ * @brief Maximum length of a cached host name, excluding the terminator.
+ * Longer host names are resolved but not cached.
+ */
+#ifndef dnscacheMAX_HOST_NAME_LENGTH
+    #define dnscacheMAX_HOST_NAME_LENGTH    ( 128U )
+#endif
+
+/**
+ * @brief Time in milliseconds during which a resolved address is reused
+ * without querying the resolver again.
+ *
+ * Once expired, the next lookup queries the resolver. If the query fails, the
+ * expired address is returned as the last known good address.
+ */
+#ifndef dnscacheENTRY_TTL_MS
+    #define dnscacheENTRY_TTL_MS            ( 10U * 60U * 1000U )
+#endif
+
+/**
+ * @brief Resolve a host name to an IPv4 address.
+ *
+ * @param[in] pHostName NULL-terminated host name to resolve.
+ *
+ * @return The IPv4 address in network byte order, or 0 if the host name
+ * could not be resolved and no previous address is known.
+ */
+uint32_t DnsCache_Resolve( const char * pHostName );
+
+/**
+ * @brief Mark the cached address of a host name as expired.
+ *
+ * Used when a connection to the cached address fails, so that the next
+ * lookup queries the resolver. The address is kept as the last known good
+ * address in case the resolver cannot be reached.
+ *
+ * @param[in] pHostName NULL-terminated host name to expire.
+ */
+void DnsCache_Expire( const char * pHostName );
+
+#endif /* DNS_CACHE_H */
@@ -137,6 +137,18 @@ TransportStatus_t Transport_Connect( NetworkContext_t * pNetworkContext,
                                      uint32_t sendTimeoutMs,
                                      uint32_t recvTimeoutMs );
 
+/**
+ * @brief Looks up the client credentials of TLS connections ahead of the first
+ * Transport_Connect, e.g. while the network comes up.
+ *
+ * @param[in] pTLSParams Credentials of the connections, only the PKCS #11
+ *            labels and the login PIN are used.
+ *
+ * @return #TRANSPORT_STATUS_SUCCESS on success;
+ *         #TRANSPORT_STATUS_INVALID_PARAMETER, #TRANSPORT_STATUS_CREDENTIALS_INVALID on failure.
+ */
+TransportStatus_t Transport_LoadCredentials( const TLSParams_t * pTLSParams );
+
 /**
  * @brief Closes a TLS session on top of a TCP connection using the Secure Sockets API.
  *
@@ -60,10 +60,16 @@ typedef struct ServerInfo
     uint16_t port;
 } ServerInfo_t;
 
-static int Transport_Send = 1;
-static int Transport_Recv = 2;
-/* The above two lines are functions, but for */
-/* mqtt_agent_task they are not called merely assigned. */
+DECLARE_FAKE_VALUE_FUNC( int32_t,
+                         Transport_Send,
+                         NetworkContext_t *,
+                         const void *,
+                         size_t );
+DECLARE_FAKE_VALUE_FUNC( int32_t,
+                         Transport_Recv,
+                         NetworkContext_t *,
+                         void *,
+                         size_t );
 
 DECLARE_FAKE_VALUE_FUNC( TransportStatus_t,
                          Transport_Connect,
@@ -75,6 +81,9 @@ DECLARE_FAKE_VALUE_FUNC( TransportStatus_t,
 DECLARE_FAKE_VALUE_FUNC( TransportStatus_t,
                          Transport_Disconnect,
                          NetworkContext_t * );
+DECLARE_FAKE_VALUE_FUNC( TransportStatus_t,
+                         Transport_LoadCredentials,
+                         const TLSParams_t * );
 
 
 #endif /* TRANSPORT_INTERFACE_API_H */
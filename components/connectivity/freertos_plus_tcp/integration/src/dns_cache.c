@@ -0,0 +1,175 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "logging_levels.h"
+
+#define LIBRARY_LOG_NAME     "DNS CACHE"
+#define LIBRARY_LOG_LEVEL    LOG_INFO
+
+#include "logging_stack.h"
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_DNS.h"
+
+#include "dns_cache.h"
+
+typedef struct DnsCacheEntry
+{
+    char hostName[ dnscacheMAX_HOST_NAME_LENGTH + 1U ];
+    uint32_t address;
+    TickType_t resolvedAt;
+    bool expired;
+} DnsCacheEntry_t;
+
+static DnsCacheEntry_t dnsCacheEntries[ dnscacheMAX_ENTRIES ];
+
+/**
+ * @brief Find the entry of a host name. Must be called in a critical section.
+ *
+ * @return The entry, or NULL if the host name is not cached.
+ */
+static DnsCacheEntry_t * findEntry( const char * pHostName )
+{
+    DnsCacheEntry_t * pEntry = NULL;
+    size_t index;
+
+    for( index = 0; index < dnscacheMAX_ENTRIES; index++ )
+    {
+        if( ( dnsCacheEntries[ index ].address != 0U ) &&
+            ( strcmp( dnsCacheEntries[ index ].hostName, pHostName ) == 0 ) )
+        {
+            pEntry = &dnsCacheEntries[ index ];
+            break;
+        }
+    }
+
+    return pEntry;
+}
+
+/**
+ * @brief Store the address of a host name, replacing the least recently
+ * resolved entry if the cache is full.
+ */
+static void storeEntry( const char * pHostName,
+                        size_t hostNameLength,
+                        uint32_t address )
+{
+    DnsCacheEntry_t * pEntry;
+    size_t index;
+
+    taskENTER_CRITICAL();
+
+    pEntry = findEntry( pHostName );
+
+    if( pEntry == NULL )
+    {
+        pEntry = &dnsCacheEntries[ 0 ];
+
+        for( index = 0; index < dnscacheMAX_ENTRIES; index++ )
+        {
+            if( dnsCacheEntries[ index ].address == 0U )
+            {
+                pEntry = &dnsCacheEntries[ index ];
+                break;
+            }
+
+            if( ( TickType_t ) ( xTaskGetTickCount() - dnsCacheEntries[ index ].resolvedAt ) >
+                ( TickType_t ) ( xTaskGetTickCount() - pEntry->resolvedAt ) )
+            {
+                pEntry = &dnsCacheEntries[ index ];
+            }
+        }
+
+        ( void ) memcpy( pEntry->hostName, pHostName, hostNameLength );
+        pEntry->hostName[ hostNameLength ] = '\0';
+    }
+
+    pEntry->address = address;
+    pEntry->resolvedAt = xTaskGetTickCount();
+    pEntry->expired = false;
+
+    taskEXIT_CRITICAL();
+}
+
+uint32_t DnsCache_Resolve( const char * pHostName )
+{
+    DnsCacheEntry_t * pEntry;
+    uint32_t cachedAddress = 0U;
+    uint32_t address = 0U;
+    bool fresh = false;
+    bool cacheable = false;
+
+    if( pHostName != NULL )
+    {
+        cacheable = ( strlen( pHostName ) <= dnscacheMAX_HOST_NAME_LENGTH );
+
+        if( cacheable )
+        {
+            taskENTER_CRITICAL();
+
+            pEntry = findEntry( pHostName );
+
+            if( pEntry != NULL )
+            {
+                cachedAddress = pEntry->address;
+                fresh = ( pEntry->expired == false ) &&
+                        ( ( TickType_t ) ( xTaskGetTickCount() - pEntry->resolvedAt ) < pdMS_TO_TICKS( dnscacheENTRY_TTL_MS ) );
+            }
+
+            taskEXIT_CRITICAL();
+        }
+
+        if( fresh )
+        {
+            LogDebug( ( "Reusing cached address of %s.", pHostName ) );
+            address = cachedAddress;
+        }
+        else
+        {
+            address = ( uint32_t ) FreeRTOS_gethostbyname( pHostName );
+
+            if( address != 0U )
+            {
+                if( cacheable )
+                {
+                    storeEntry( pHostName, strlen( pHostName ), address );
+                }
+            }
+            else if( cachedAddress != 0U )
+            {
+                LogWarn( ( "DNS resolution of %s failed, using last known good address.", pHostName ) );
+                address = cachedAddress;
+            }
+        }
+    }
+
+    return address;
+}
+
+void DnsCache_Expire( const char * pHostName )
+{
+    DnsCacheEntry_t * pEntry;
+
+    if( pHostName != NULL )
+    {
+        taskENTER_CRITICAL();
+
+        pEntry = findEntry( pHostName );
+
+        if( pEntry != NULL )
+        {
+            pEntry->expired = true;
+        }
+
+        taskEXIT_CRITICAL();
+    }
+}
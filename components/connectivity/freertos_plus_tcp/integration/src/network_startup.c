@@ -8,6 +8,9 @@
 /* FreeRTOS includes. */
 #include <FreeRTOS.h>
 #include "FreeRTOS_IP.h"
+#if defined( ipconfigUSE_DHCP_HOOK ) && ( ipconfigUSE_DHCP_HOOK != 0 )
+    #include "FreeRTOS_DHCP.h"
+#endif
 
 /* System events helper header. */
 #include "events.h"
@@ -120,6 +123,7 @@ int32_t network_startup( void )
     if( eNetworkEvent == eNetworkUp )
     {
         LogInfo( ( "Network is up" ) );
+        vBootTimelineMark( BootTimelineNetworkUp );
         ( void ) xEventGroupSetBits( xSystemEvents, EVENT_MASK_NETWORK_UP );
     }
     else
@@ -128,3 +132,31 @@ int32_t network_startup( void )
         ( void ) xEventGroupClearBits( xSystemEvents, EVENT_MASK_NETWORK_UP );
     }
 }
+
+#if defined( ipconfigUSE_DHCP_HOOK ) && ( ipconfigUSE_DHCP_HOOK != 0 )
+
+/* Called by FreeRTOS+TCP at each DHCP phase, only used to time the boot. */
+    #if defined( ipconfigIPv4_BACKWARD_COMPATIBLE ) && ( ipconfigIPv4_BACKWARD_COMPATIBLE == 0 )
+        eDHCPCallbackAnswer_t xApplicationDHCPHook_Multi( eDHCPCallbackPhase_t eDHCPPhase,
+                                                          struct xNetworkEndPoint * pxEndPoint,
+                                                          IP_Address_t * pxIPAddress )
+    #else
+        eDHCPCallbackAnswer_t xApplicationDHCPHook( eDHCPCallbackPhase_t eDHCPPhase,
+                                                    uint32_t ulIPAddress )
+    #endif /* defined( ipconfigIPv4_BACKWARD_COMPATIBLE ) && ( ipconfigIPv4_BACKWARD_COMPATIBLE == 0 ) */
+    {
+        #if defined( ipconfigIPv4_BACKWARD_COMPATIBLE ) && ( ipconfigIPv4_BACKWARD_COMPATIBLE == 0 )
+            ( void ) pxEndPoint;
+            ( void ) pxIPAddress;
+        #else
+            ( void ) ulIPAddress;
+        #endif
+
+        if( eDHCPPhase == eDHCPPhasePreDiscover )
+        {
+            vBootTimelineMark( BootTimelineDhcpStart );
+        }
+
+        return eDHCPContinue;
+    }
+#endif /* defined( ipconfigUSE_DHCP_HOOK ) && ( ipconfigUSE_DHCP_HOOK != 0 ) */
@@ -49,9 +49,15 @@
 /* Transport header. */
 #include "transport_interface_api.h"
 
+/* Resolver cache header. */
+#include "dns_cache.h"
+
 /* TLS helper header. */
 #include "iot_tls.h"
 
+/* System events header. */
+#include "events.h"
+
 static int Recv_Cb( void * pvCallerContext,
                     unsigned char * pucReceiveBuffer,
                     size_t xReceiveLength );
@@ -99,12 +105,12 @@ TransportStatus_t Transport_Connect( NetworkContext_t * pNetworkContext,
 
             LogInfo( ( "Resolving host name: %s.", pServerInfo->pHostName ) );
             #if defined( ipconfigIPv4_BACKWARD_COMPATIBLE ) && ( ipconfigIPv4_BACKWARD_COMPATIBLE == 0 )
-                serverAddress.sin_address.ulIP_IPv4 = ( uint32_t ) FreeRTOS_gethostbyname( pServerInfo->pHostName );
+                serverAddress.sin_address.ulIP_IPv4 = DnsCache_Resolve( pServerInfo->pHostName );
 
                 /* Check for errors from DNS lookup. */
                 if( serverAddress.sin_address.ulIP_IPv4 == 0U )
             #else
-                serverAddress.sin_addr = ( uint32_t ) FreeRTOS_gethostbyname( pServerInfo->pHostName );
+                serverAddress.sin_addr = DnsCache_Resolve( pServerInfo->pHostName );
 
                 /* Check for errors from DNS lookup. */
                 if( serverAddress.sin_addr == 0U )
@@ -114,6 +120,10 @@ TransportStatus_t Transport_Connect( NetworkContext_t * pNetworkContext,
                             pServerInfo->pHostName ) );
                 status = TRANSPORT_STATUS_DNS_FAILURE;
             }
+            else
+            {
+                vBootTimelineMark( BootTimelineDnsResolved );
+            }
         }
 
         /* Create a TCP connection to the host. */
@@ -148,6 +158,10 @@ TransportStatus_t Transport_Connect( NetworkContext_t * pNetworkContext,
                             pServerInfo->pHostName,
                             pServerInfo->port ) );
                 status = TRANSPORT_STATUS_CONNECT_FAILURE;
+
+                /* The cached address may be stale, resolve it again on the
+                 * next attempt. */
+                DnsCache_Expire( pServerInfo->pHostName );
             }
         }
 
@@ -180,6 +194,10 @@ TransportStatus_t Transport_Connect( NetworkContext_t * pNetworkContext,
                     {
                         status = TRANSPORT_STATUS_TLS_FAILURE;
                     }
+                    else
+                    {
+                        vBootTimelineMark( BootTimelineTlsConnected );
+                    }
                 }
                 else
                 {
@@ -196,6 +214,30 @@ TransportStatus_t Transport_Connect( NetworkContext_t * pNetworkContext,
     return status;
 }
 
+TransportStatus_t Transport_LoadCredentials( const TLSParams_t * pTLSParams )
+{
+    TransportStatus_t status = TRANSPORT_STATUS_SUCCESS;
+    TLSHelperParams_t tlsHelperParams = { 0 };
+
+    if( pTLSParams == NULL )
+    {
+        status = TRANSPORT_STATUS_INVALID_PARAMETER;
+    }
+    else
+    {
+        tlsHelperParams.pPrivateKeyLabel = pTLSParams->pPrivateKeyLabel;
+        tlsHelperParams.pClientCertLabel = pTLSParams->pClientCertLabel;
+        tlsHelperParams.pcLoginPIN = pTLSParams->pLoginPIN;
+
+        if( TLS_LoadClientCredentials( &tlsHelperParams ) != pdTRUE )
+        {
+            status = TRANSPORT_STATUS_CREDENTIALS_INVALID;
+        }
+    }
+
+    return status;
+}
+
 TransportStatus_t Transport_Disconnect( NetworkContext_t * pNetworkContext )
 {
     TransportStatus_t status = TRANSPORT_STATUS_SUCCESS;
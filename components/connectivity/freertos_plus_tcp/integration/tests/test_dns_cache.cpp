@@ -0,0 +1,225 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "dns_cache.h"
+#include "FreeRTOS.h"
+#include "FreeRTOS_DNS.h"
+#include "logging_stack.h"
+#include "task.h"
+
+DEFINE_FAKE_VOID_FUNC_VARARG( SdkLogWarn,
+                              const char *,
+                              ... );
+DEFINE_FAKE_VOID_FUNC_VARARG( SdkLogDebug,
+                              const char *,
+                              ... );
+}
+
+static const TickType_t ttlTicks = pdMS_TO_TICKS( dnscacheENTRY_TTL_MS );
+static const uint32_t firstAddress = 0x0A00000AU;
+static const uint32_t secondAddress = 0x0B00000BU;
+
+/* The cache is not reset between the tests, so each test resolves host names
+ * of its own. */
+class TestDnsCache : public ::testing::Test
+{
+public:
+    TestDnsCache()
+    {
+        RESET_FAKE( FreeRTOS_gethostbyname );
+        RESET_FAKE( xTaskGetTickCount );
+        RESET_FAKE( vTaskEnterCritical );
+        RESET_FAKE( vTaskExitCritical );
+        RESET_FAKE( SdkLogWarn );
+        RESET_FAKE( SdkLogDebug );
+
+        hostName = std::string( ::testing::UnitTest::GetInstance()->current_test_info()->name() ) + ".example.com";
+    }
+
+    ~TestDnsCache()
+    {
+        EXPECT_EQ( vTaskEnterCritical_fake.call_count, vTaskExitCritical_fake.call_count );
+    }
+
+    uint32_t resolveAt( TickType_t tick,
+                        const std::string & name )
+    {
+        xTaskGetTickCount_fake.return_val = tick;
+
+        return DnsCache_Resolve( name.c_str() );
+    }
+
+    uint32_t resolveAt( TickType_t tick )
+    {
+        return resolveAt( tick, hostName );
+    }
+
+    std::string hostName;
+};
+
+TEST_F( TestDnsCache, a_fresh_address_is_reused_without_a_lookup )
+{
+    FreeRTOS_gethostbyname_fake.return_val = firstAddress;
+
+    EXPECT_EQ( resolveAt( 1000U ), firstAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 1U );
+    EXPECT_STREQ( FreeRTOS_gethostbyname_fake.arg0_val, hostName.c_str() );
+
+    FreeRTOS_gethostbyname_fake.return_val = secondAddress;
+
+    EXPECT_EQ( resolveAt( 1001U ), firstAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 1U );
+}
+
+TEST_F( TestDnsCache, an_address_is_reused_up_to_the_ttl_and_no_longer )
+{
+    FreeRTOS_gethostbyname_fake.return_val = firstAddress;
+    ASSERT_EQ( resolveAt( 2000U ), firstAddress );
+
+    FreeRTOS_gethostbyname_fake.return_val = secondAddress;
+
+    EXPECT_EQ( resolveAt( 2000U + ttlTicks - 1U ), firstAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 1U );
+
+    EXPECT_EQ( resolveAt( 2000U + ttlTicks ), secondAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 2U );
+}
+
+TEST_F( TestDnsCache, the_ttl_holds_across_a_tick_count_wrap )
+{
+    const TickType_t resolvedAt = std::numeric_limits<TickType_t>::max() - ( ttlTicks / 2U );
+
+    FreeRTOS_gethostbyname_fake.return_val = firstAddress;
+    ASSERT_EQ( resolveAt( resolvedAt ), firstAddress );
+
+    FreeRTOS_gethostbyname_fake.return_val = secondAddress;
+
+    /* The tick count wrapped, but the TTL has not elapsed. */
+    ASSERT_LT( resolvedAt + ttlTicks - 1U, resolvedAt );
+    EXPECT_EQ( resolveAt( resolvedAt + ttlTicks - 1U ), firstAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 1U );
+
+    EXPECT_EQ( resolveAt( resolvedAt + ttlTicks ), secondAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 2U );
+}
+
+TEST_F( TestDnsCache, an_expired_address_is_replaced_by_a_fresh_lookup )
+{
+    FreeRTOS_gethostbyname_fake.return_val = firstAddress;
+    ASSERT_EQ( resolveAt( 3000U ), firstAddress );
+
+    FreeRTOS_gethostbyname_fake.return_val = secondAddress;
+    EXPECT_EQ( resolveAt( 3000U + ttlTicks ), secondAddress );
+
+    /* The new address is fresh for a whole TTL. */
+    EXPECT_EQ( resolveAt( 3000U + ( 2U * ttlTicks ) - 1U ), secondAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 2U );
+}
+
+TEST_F( TestDnsCache, the_last_known_good_address_is_used_when_the_lookup_fails )
+{
+    FreeRTOS_gethostbyname_fake.return_val = firstAddress;
+    ASSERT_EQ( resolveAt( 4000U ), firstAddress );
+
+    FreeRTOS_gethostbyname_fake.return_val = 0U;
+    EXPECT_EQ( resolveAt( 4000U + ttlTicks ), firstAddress );
+    EXPECT_EQ( SdkLogWarn_fake.call_count, 1U );
+
+    /* A failed lookup does not refresh the address, the next use looks up
+     * again. */
+    EXPECT_EQ( resolveAt( 4000U + ttlTicks + 1U ), firstAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 3U );
+
+    FreeRTOS_gethostbyname_fake.return_val = secondAddress;
+    EXPECT_EQ( resolveAt( 4000U + ttlTicks + 2U ), secondAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 4U );
+}
+
+TEST_F( TestDnsCache, expiring_an_address_forces_a_fresh_lookup )
+{
+    FreeRTOS_gethostbyname_fake.return_val = firstAddress;
+    ASSERT_EQ( resolveAt( 5000U ), firstAddress );
+
+    DnsCache_Expire( hostName.c_str() );
+
+    /* Within the TTL, but the address was expired. */
+    FreeRTOS_gethostbyname_fake.return_val = 0U;
+    EXPECT_EQ( resolveAt( 5001U ), firstAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 2U );
+
+    FreeRTOS_gethostbyname_fake.return_val = secondAddress;
+    EXPECT_EQ( resolveAt( 5002U ), secondAddress );
+    EXPECT_EQ( resolveAt( 5003U ), secondAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 3U );
+}
+
+TEST_F( TestDnsCache, expiring_an_unknown_host_does_nothing )
+{
+    DnsCache_Expire( hostName.c_str() );
+    DnsCache_Expire( NULL );
+
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 0U );
+}
+
+TEST_F( TestDnsCache, a_host_that_never_resolved_gives_no_address )
+{
+    FreeRTOS_gethostbyname_fake.return_val = 0U;
+
+    EXPECT_EQ( resolveAt( 6000U ), 0U );
+    EXPECT_EQ( resolveAt( 6001U ), 0U );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 2U );
+
+    EXPECT_EQ( DnsCache_Resolve( NULL ), 0U );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 2U );
+}
+
+TEST_F( TestDnsCache, host_names_too_long_to_cache_are_looked_up_every_time )
+{
+    const std::string longName( dnscacheMAX_HOST_NAME_LENGTH + 1U, 'a' );
+
+    FreeRTOS_gethostbyname_fake.return_val = firstAddress;
+
+    EXPECT_EQ( resolveAt( 7000U, longName ), firstAddress );
+    EXPECT_EQ( resolveAt( 7001U, longName ), firstAddress );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, 2U );
+}
+
+TEST_F( TestDnsCache, a_full_cache_replaces_the_least_recently_resolved_address )
+{
+    const TickType_t start = 100000U;
+
+    FreeRTOS_gethostbyname_fake.return_val = firstAddress;
+
+    for( size_t entry = 0U; entry < dnscacheMAX_ENTRIES; entry++ )
+    {
+        ASSERT_EQ( resolveAt( start + entry, hostName + std::to_string( entry ) ), firstAddress );
+    }
+
+    /* Refresh the first one, the second one is now the oldest. */
+    DnsCache_Expire( ( hostName + "0" ).c_str() );
+    ASSERT_EQ( resolveAt( start + dnscacheMAX_ENTRIES, hostName + "0" ), firstAddress );
+    ASSERT_EQ( resolveAt( start + dnscacheMAX_ENTRIES + 1U, hostName + "new" ), firstAddress );
+    ASSERT_EQ( FreeRTOS_gethostbyname_fake.call_count, dnscacheMAX_ENTRIES + 2U );
+
+    /* The others are still cached. */
+    EXPECT_EQ( resolveAt( start + dnscacheMAX_ENTRIES + 2U, hostName + "0" ), firstAddress );
+
+    for( size_t entry = 2U; entry < dnscacheMAX_ENTRIES; entry++ )
+    {
+        EXPECT_EQ( resolveAt( start + dnscacheMAX_ENTRIES + 2U, hostName + std::to_string( entry ) ), firstAddress );
+    }
+
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, dnscacheMAX_ENTRIES + 2U );
+
+    FreeRTOS_gethostbyname_fake.return_val = 0U;
+    EXPECT_EQ( resolveAt( start + dnscacheMAX_ENTRIES + 3U, hostName + "1" ), 0U );
+    EXPECT_EQ( FreeRTOS_gethostbyname_fake.call_count, dnscacheMAX_ENTRIES + 3U );
+}
@@ -58,10 +58,17 @@ typedef struct ServerInfo
     uint16_t port;
 } ServerInfo_t;
 
-/* The below two are usually functions, but for */
-/* mqtt_agent_task they are not called merely assigned. */
-static int Transport_Send = 1;
-static int Transport_Recv = 2;
+DECLARE_FAKE_VALUE_FUNC( int32_t,
+                         Transport_Send,
+                         NetworkContext_t *,
+                         const void *,
+                         size_t );
+
+DECLARE_FAKE_VALUE_FUNC( int32_t,
+                         Transport_Recv,
+                         NetworkContext_t *,
+                         void *,
+                         size_t );
 
 DECLARE_FAKE_VALUE_FUNC( TransportStatus_t,
                          Transport_Connect,
@@ -74,5 +81,8 @@ DECLARE_FAKE_VALUE_FUNC( TransportStatus_t,
 DECLARE_FAKE_VALUE_FUNC( TransportStatus_t,
                          Transport_Disconnect,
                          NetworkContext_t * );
+DECLARE_FAKE_VALUE_FUNC( TransportStatus_t,
+                         Transport_LoadCredentials,
+                         const TLSParams_t * );
 
 #endif /* TRANSPORT_INTERFACE_API_H */
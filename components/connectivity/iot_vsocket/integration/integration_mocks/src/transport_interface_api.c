@@ -38,3 +38,18 @@ DEFINE_FAKE_VALUE_FUNC( TransportStatus_t,
 DEFINE_FAKE_VALUE_FUNC( TransportStatus_t,
                         Transport_Disconnect,
                         NetworkContext_t * );
+DEFINE_FAKE_VALUE_FUNC( TransportStatus_t,
+                        Transport_LoadCredentials,
+                        const TLSParams_t * );
+
+DEFINE_FAKE_VALUE_FUNC( int32_t,
+                        Transport_Send,
+                        NetworkContext_t *,
+                        const void *,
+                        size_t );
+
+DEFINE_FAKE_VALUE_FUNC( int32_t,
+                        Transport_Recv,
+                        NetworkContext_t *,
+                        void *,
+                        size_t );
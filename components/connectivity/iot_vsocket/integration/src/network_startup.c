@@ -25,5 +25,7 @@ int32_t network_startup( void )
         configASSERT( 0 );
     }
 
+    vBootTimelineMark( BootTimelineNetworkUp );
+
     return 0;
 }
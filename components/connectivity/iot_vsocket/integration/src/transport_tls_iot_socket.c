@@ -8,6 +8,7 @@
 #include "transport_interface_api.h"
 #include "iot_socket.h"
 #include "iot_tls.h"
+#include "events.h"
 
 /* Include header that defines log levels. */
 #include "logging_levels.h"
@@ -71,6 +72,10 @@ TransportStatus_t Transport_Connect( NetworkContext_t * pNetworkContext,
             {
                 status = TRANSPORT_STATUS_DNS_FAILURE;
             }
+            else
+            {
+                vBootTimelineMark( BootTimelineDnsResolved );
+            }
         }
 
         /* Create a TCP connection to the host. */
@@ -117,6 +122,10 @@ TransportStatus_t Transport_Connect( NetworkContext_t * pNetworkContext,
                     {
                         status = TRANSPORT_STATUS_TLS_FAILURE;
                     }
+                    else
+                    {
+                        vBootTimelineMark( BootTimelineTlsConnected );
+                    }
                 }
                 else
                 {
@@ -254,6 +263,30 @@ static int Send_Cb( void * pvCallerContext,
     return( rc );
 }
 
+TransportStatus_t Transport_LoadCredentials( const TLSParams_t * pTLSParams )
+{
+    TransportStatus_t status = TRANSPORT_STATUS_SUCCESS;
+    TLSHelperParams_t tlsHelperParams = { 0 };
+
+    if( pTLSParams == NULL )
+    {
+        status = TRANSPORT_STATUS_INVALID_PARAMETER;
+    }
+    else
+    {
+        tlsHelperParams.pPrivateKeyLabel = pTLSParams->pPrivateKeyLabel;
+        tlsHelperParams.pClientCertLabel = pTLSParams->pClientCertLabel;
+        tlsHelperParams.pcLoginPIN = pTLSParams->pLoginPIN;
+
+        if( TLS_LoadClientCredentials( &tlsHelperParams ) != pdTRUE )
+        {
+            status = TRANSPORT_STATUS_CREDENTIALS_INVALID;
+        }
+    }
+
+    return status;
+}
+
 TransportStatus_t Transport_Disconnect( NetworkContext_t * pNetworkContext )
 {
     TransportStatus_t status = TRANSPORT_STATUS_SUCCESS;
@@ -5,7 +5,28 @@
 
 /**
  * @file heap_management.h
- * @brief Thin wrappers around the C library used by the integration code.
+ * @brief Instrumented wrappers around the C library heap used by FreeRTOS
+ * and the integration code.
+ *
+ * Every block allocated with pvPortMalloc() or pvPortCalloc() carries a small
+ * header so that the heap usage can be accounted for: live bytes, high-water
+ * mark, counts per size class and per caller, and, on demand, the free blocks
+ * and a map of the heap region.
+ *
+ * Memory allocated with malloc() directly, e.g. by C++ new, the ML libraries
+ * or the C library itself, bypasses these wrappers and is not accounted for,
+ * although it takes space in the same heap region. The free space, the free
+ * blocks and the map only see the blocks of pvPortMalloc(), so they are upper
+ * bounds of what is really left: they over-report as much as was allocated
+ * with malloc() directly.
+ *
+ * Small blocks are taken from slabs: blocks of heapmanagementSLAB_SIZE bytes
+ * allocated with malloc() and cut into objects of a single size class, which
+ * keeps the objects of the same size together and avoids malloc() for the
+ * common sizes. A slab whose objects are all freed is given back to the C
+ * library at once while the slabs hold more than
+ * heapmanagementSLAB_RELEASE_BYTES, and kept for the next allocations
+ * otherwise. xHeapManagementReleaseSlabs() gives back the ones kept.
  */
 #ifndef HEAP_MANAGEMENT_H
     #define HEAP_MANAGEMENT_H
@@ -17,20 +38,113 @@
     #endif
 
 /**
- * @brief Wrapper for the C libraries malloc
+ * @brief Number of size classes. Class n holds the blocks of up to 16 << n
+ * bytes, the last class holds all the larger blocks.
+ */
+    #ifndef heapmanagementSIZE_CLASS_COUNT
+        #define heapmanagementSIZE_CLASS_COUNT    ( 12U )
+    #endif
+
+/**
+ * @brief Number of callers the allocations are attributed to. The callers
+ * seen once the table is full share its last entry.
+ */
+    #ifndef heapmanagementMAX_CALLERS
+        #define heapmanagementMAX_CALLERS    ( 16U )
+    #endif
+
+/**
+ * @brief Set to 0 to allocate every block with malloc().
+ */
+    #ifndef heapmanagementUSE_SLABS
+        #define heapmanagementUSE_SLABS    ( 1 )
+    #endif
+
+/**
+ * @brief Object sizes of the slab classes, in ascending order. A slab of a
+ * class holds as many objects as fit at this size, with the headers of the
+ * slab and of the objects, and the objects are grown to share the rest of
+ * the slab. A block is taken from the smallest class whose objects it fits
+ * in, larger blocks are allocated with malloc().
+ */
+    #ifndef heapmanagementSLAB_CLASS_SIZES
+        #define heapmanagementSLAB_CLASS_SIZES    { 16U, 32U, 64U, 128U, 256U, 512U, 1024U }
+    #endif
+
+/**
+ * @brief Size of a slab, it must hold at least one object of the largest class.
+ */
+    #ifndef heapmanagementSLAB_SIZE
+        #define heapmanagementSLAB_SIZE    ( 4096U )
+    #endif
+
+/**
+ * @brief Most memory held by the slabs. Once it is reached, the blocks that do
+ * not fit in the existing slabs are allocated with malloc().
+ */
+    #ifndef heapmanagementSLAB_MAX_BYTES
+        #define heapmanagementSLAB_MAX_BYTES    ( 16U * heapmanagementSLAB_SIZE )
+    #endif
+
+/**
+ * @brief Memory held by the slabs above which a slab that empties is given
+ * back to the C library at once.
+ */
+    #ifndef heapmanagementSLAB_RELEASE_BYTES
+        #define heapmanagementSLAB_RELEASE_BYTES    ( heapmanagementSLAB_MAX_BYTES / 2U )
+    #endif
+
+/**
+ * @brief Heap usage attributed to one caller.
+ */
+    typedef struct HeapCallerStats
+    {
+        const void * pvCaller; /*!< Return address of the allocation, NULL for the callers that did not fit in the table. */
+        size_t xLiveBytes;     /*!< Bytes currently allocated. */
+        size_t xLiveBlocks;    /*!< Blocks currently allocated. */
+        size_t xPeakBytes;     /*!< Largest number of bytes allocated at any time. */
+    } HeapCallerStats_t;
+
+/**
+ * @brief Snapshot of the heap usage.
+ */
+    typedef struct HeapManagementStats
+    {
+        size_t xHeapSize;                                                  /*!< Size of the heap region. */
+        size_t xLiveBytes;                                                 /*!< Bytes currently allocated, as requested. */
+        size_t xLiveBlocks;                                                /*!< Blocks currently allocated. */
+        size_t xPeakLiveBytes;                                             /*!< Largest number of bytes allocated at any time. */
+        size_t xFreeBytes;                                                 /*!< Bytes left in the heap region, at most. */
+        size_t xMinimumEverFreeBytes;                                      /*!< Fewest bytes left in the heap region at any time, at most. */
+        size_t xLargestFreeBlock;                                          /*!< Largest gap between the blocks of pvPortMalloc(). */
+        size_t xFreeBlocks;                                                /*!< Number of gaps between the blocks of pvPortMalloc(). */
+        size_t xSuccessfulAllocations;                                     /*!< Allocations that returned a block. */
+        size_t xSuccessfulFrees;                                           /*!< Blocks freed. */
+        size_t xFailedAllocations;                                         /*!< Allocations that returned NULL. */
+        size_t xSlabAllocations;                                           /*!< Allocations taken from a slab. */
+        size_t xSlabBytes;                                                 /*!< Bytes held by the slabs. */
+        size_t xSlabFreeBytes;                                             /*!< Bytes of the slab objects not allocated. */
+        size_t xLiveBlocksPerSizeClass[ heapmanagementSIZE_CLASS_COUNT ];  /*!< Blocks currently allocated in each size class. */
+        size_t xAllocationsPerSizeClass[ heapmanagementSIZE_CLASS_COUNT ]; /*!< Allocations made in each size class. */
+        HeapCallerStats_t xCallers[ heapmanagementMAX_CALLERS ];           /*!< Usage of each caller, in the order they were first seen. */
+        size_t xCallerCount;                                               /*!< Number of entries of xCallers in use. */
+    } HeapManagementStats_t;
+
+/**
+ * @brief Allocate a block of memory from the C library heap.
  * @param xWantedSize The number of bytes to be allocated
  * @return Either a non-NULL pointer to a block of memory on success, or NULL on failure
  */
     void * pvPortMalloc( size_t xWantedSize );
 
 /**
- * @brief Wrapper for the C libraries free function
+ * @brief Free a block allocated with pvPortMalloc() or pvPortCalloc().
  * @param pv Pointer to a memory location to be freed, or NULL
  */
     void vPortFree( void * pv );
 
 /**
- * @brief Wrapper for the C libraries calloc
+ * @brief Allocate a zeroed array from the C library heap.
  * @param xNum The number of elements
  * @param xSize The size of each element in bytes
  * @return Either a non-NULL pointer to a block of memory on success, or NULL on failure
@@ -39,27 +153,52 @@
                          size_t xSize );
 
 /**
- * @brief A dummy implementation as C standard library does not provide
- * functions to get the statistics of heap memory.
- * @return Always 0 in the integration build
- * @note These dummy implementation are needed
- * as this API is used as part of FreeRTOS Plus TCP code which is unused in the
- * FRI code (removed by the linker) but ARMClang linker requires all the compiled
- * symbols to be defined.
+ * @brief Get the number of bytes left in the heap region.
+ * @return The size of the heap region less the allocated blocks and their
+ * headers. The memory allocated with malloc() directly is not subtracted, so
+ * this is an upper bound.
  */
     size_t xPortGetFreeHeapSize( void );
 
 /**
- * @brief A dummy implementation as C standard library does not provide
- * functions to get the statistics of heap memory.
- * @return Always 0 in the integration build
- * @note These dummy implementation are needed
- * as this API is used as part of FreeRTOS Plus TCP code which is unused in the
- * FRI code (removed by the linker) but ARMClang linker requires all the compiled
- * symbols to be defined.
+ * @brief Get the fewest bytes that were left in the heap region since boot.
+ * @return The low-water mark of xPortGetFreeHeapSize(), an upper bound as well.
  */
     size_t xPortGetMinimumEverFreeHeapSize( void );
 
+/**
+ * @brief Take a snapshot of the heap usage.
+ *
+ * The free blocks are found by walking the allocated blocks in address order
+ * with the scheduler suspended, so this is meant for diagnostics only. The
+ * blocks allocated with malloc() directly are not seen, they are counted in
+ * the free blocks.
+ *
+ * @param[out] pxStats The heap usage.
+ */
+    void vHeapManagementGetStats( HeapManagementStats_t * pxStats );
+
+/**
+ * @brief Give the slabs kept with no object allocated back to the C library,
+ * e.g. before a large allocation.
+ * @return The number of bytes given back.
+ */
+    size_t xHeapManagementReleaseSlabs( void );
+
+/**
+ * @brief Draw a map of the heap region, one character per slice of the region:
+ * '.' for a free slice, '+' for a partly allocated slice and '#' for a fully
+ * allocated slice.
+ *
+ * The map is meant to be printed on demand, e.g. when an allocation fails.
+ *
+ * @param[out] pcBuffer Buffer for the NULL terminated map.
+ * @param[in] xBufferSize Size of the buffer, the number of slices is one less.
+ * @return The length of the map.
+ */
+    size_t xHeapManagementFormatFragmentationMap( char * pcBuffer,
+                                                  size_t xBufferSize );
+
     #ifdef __cplusplus
     }
     #endif
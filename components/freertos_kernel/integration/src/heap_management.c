@@ -3,31 +3,903 @@
  * SPDX-License-Identifier: MIT
  */
 
-#include "heap_management.h"
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "heap_management.h"
+
+/* Bounds of the heap region the C library allocates from, set by the linker
+ * script. */
+#if defined( __ARMCC_VERSION )
+    extern uint8_t Image$$ARM_LIB_HEAP$$ZI$$Base[];
+    extern uint8_t Image$$ARM_LIB_HEAP$$ZI$$Limit[];
+    #define heapREGION_START    ( ( uintptr_t ) Image$$ARM_LIB_HEAP$$ZI$$Base )
+    #define heapREGION_END      ( ( uintptr_t ) Image$$ARM_LIB_HEAP$$ZI$$Limit )
+#else
+    extern uint8_t __end__[];
+    extern uint8_t __HeapLimit[];
+    #define heapREGION_START    ( ( uintptr_t ) __end__ )
+    #define heapREGION_END      ( ( uintptr_t ) __HeapLimit )
+#endif
+
+#define heapREGION_SIZE    ( ( size_t ) ( heapREGION_END - heapREGION_START ) )
+
+/* The C library aligns the blocks to at least two pointers. */
+#define heapALIGNMENT                ( 2U * sizeof( void * ) )
+#define heapROUND_UP( xSize )        ( ( ( xSize ) + heapALIGNMENT - 1U ) & ~( heapALIGNMENT - 1U ) )
+
+#define heapBLOCK_MAGIC              ( 0xA5U )
+#define heapNOT_FROM_SLAB            ( 0xFFU )
+#define heapHEADER_SIZE              heapROUND_UP( sizeof( HeapBlockHeader_t ) )
+#define heapMAXIMUM_SIZE             ( SIZE_MAX - heapHEADER_SIZE - heapALIGNMENT )
+
+/* Space a block of xSize bytes takes in the heap region. */
+#define heapFOOTPRINT( xSize )       ( heapHEADER_SIZE + heapROUND_UP( xSize ) )
+
+/* Gaps between blocks too small to hold any block are the C library's own
+ * bookkeeping, not free memory. */
+#define heapMINIMUM_FREE_BLOCK       heapFOOTPRINT( 1U )
+
+#define heapSIZE_CLASS_SMALLEST      ( 16U )
+
+/* Start of slice xIndex of the heap region cut in xSlices slices. */
+#define heapSLICE_START( xIndex, xSlices ) \
+    ( heapREGION_START + ( uintptr_t ) ( ( ( uint64_t ) heapREGION_SIZE * ( xIndex ) ) / ( xSlices ) ) )
+
+/**
+ * @brief Header in front of every allocated block.
+ */
+typedef struct HeapBlockHeader
+{
+    struct HeapBlockHeader * pxPrev; /*!< Previous allocated block. */
+    struct HeapBlockHeader * pxNext; /*!< Next allocated block. */
+    size_t xSize;                    /*!< Size requested by the caller. */
+    uint16_t usCaller;               /*!< Entry of the caller in the usage statistics. */
+    uint8_t ucSlab;                  /*!< Entry of the slab the block was taken from, heapNOT_FROM_SLAB if it was allocated with malloc(). */
+    uint8_t ucMagic;                 /*!< heapBLOCK_MAGIC while the block is allocated. */
+} HeapBlockHeader_t;
+
+/**
+ * @brief Header at the start of a slab, followed by its objects. Each object
+ * is a block header and room for the largest block of the class.
+ */
+typedef struct HeapSlab
+{
+    HeapBlockHeader_t * pxFreeObjects; /*!< Objects not allocated, linked by pxNext. */
+    struct HeapSlab * pxNextPartial;   /*!< Next slab of the class with objects not allocated, in address order. */
+    uint16_t usObjectsInUse;           /*!< Number of objects allocated. */
+    uint8_t ucClass;                   /*!< Slab class of the objects. */
+    uint8_t ucEntry;                   /*!< Entry of the slab in pxSlabs. */
+} HeapSlab_t;
+
+#define heapSLAB_HEADER_SIZE    heapROUND_UP( sizeof( HeapSlab_t ) )
+#define heapSLAB_MAX_COUNT      ( heapmanagementSLAB_MAX_BYTES / heapmanagementSLAB_SIZE )
+#define heapSLAB_CLASS_COUNT    ( sizeof( xSlabClassSizes ) / sizeof( xSlabClassSizes[ 0 ] ) )
+
+/* The entry of the slab of a block is kept in a byte of its header, as is the
+ * entry of a slab in the slab header. */
+#if ( heapSLAB_MAX_COUNT >= 0xFFU )
+    #error "heapmanagementSLAB_MAX_BYTES allows too many slabs"
+#endif
+
+/**
+ * @brief Position of a walk through the free blocks of the heap region.
+ */
+typedef struct FreeBlockIterator
+{
+    const HeapBlockHeader_t * pxNextBlock;            /*!< Next allocated block, in address order. */
+    const HeapSlab_t * pxSlabs[ heapSLAB_MAX_COUNT ]; /*!< The slabs in address order, NULL after the last one. */
+    size_t xNextSlab;                                 /*!< Entry of the next slab in pxSlabs. */
+    uintptr_t uxCursor;                               /*!< End of the last allocated block seen. */
+} FreeBlockIterator_t;
+
+/* The heap usage. The fields that describe the free blocks are only filled in
+ * the snapshots. */
+static HeapManagementStats_t xHeapStats = { 0 };
+
+/* Space the allocated blocks and their headers take, now and at most. */
+static size_t xAllocatedFootprint = 0U;
+static size_t xPeakAllocatedFootprint = 0U;
+
+/* The allocated blocks, in no particular order until they are sorted for a
+ * snapshot. */
+static HeapBlockHeader_t * pxAllocatedBlocks = NULL;
+
+static const size_t xSlabClassSizes[] = heapmanagementSLAB_CLASS_SIZES;
+
+/* Largest block the objects of each class hold once they share the whole
+ * slab, and the number of objects per slab. 0 until the first allocation. */
+static size_t xSlabObjectSizes[ heapSLAB_CLASS_COUNT ] = { 0U };
+static size_t xSlabObjectCounts[ heapSLAB_CLASS_COUNT ] = { 0U };
+
+/* The slabs, NULL for the entries not in use. The blocks record the entry of
+ * their slab, so the slabs never move to another entry. */
+static HeapSlab_t * pxSlabs[ heapSLAB_MAX_COUNT ] = { NULL };
+
+/* The slabs of each class that have objects not allocated, lowest first. */
+static HeapSlab_t * pxPartialSlabs[ heapSLAB_CLASS_COUNT ] = { NULL };
+
+/*-----------------------------------------------------------*/
+
+static size_t prvSizeClass( size_t xSize )
+{
+    size_t xClass = 0U;
+    size_t xClassLimit = heapSIZE_CLASS_SMALLEST;
+
+    while( ( xSize > xClassLimit ) && ( xClass < ( heapmanagementSIZE_CLASS_COUNT - 1U ) ) )
+    {
+        xClassLimit <<= 1U;
+        xClass++;
+    }
+
+    return xClass;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t prvCallerEntry( const void * pvCaller )
+{
+    size_t xEntry;
+
+    for( xEntry = 0U; xEntry < xHeapStats.xCallerCount; xEntry++ )
+    {
+        if( xHeapStats.xCallers[ xEntry ].pvCaller == pvCaller )
+        {
+            break;
+        }
+    }
+
+    if( xEntry == xHeapStats.xCallerCount )
+    {
+        if( xHeapStats.xCallerCount < ( heapmanagementMAX_CALLERS - 1U ) )
+        {
+            xHeapStats.xCallers[ xEntry ].pvCaller = pvCaller;
+            xHeapStats.xCallerCount++;
+        }
+        else
+        {
+            /* The table is full, the last entry collects all the others. */
+            xEntry = heapmanagementMAX_CALLERS - 1U;
+            xHeapStats.xCallers[ xEntry ].pvCaller = NULL;
+            xHeapStats.xCallerCount = heapmanagementMAX_CALLERS;
+        }
+    }
+
+    return ( uint16_t ) xEntry;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Size the objects of each class: as many objects as fit in a slab at the
+ * size of the class, grown to share the whole slab. */
+static void prvSlabClassesInit( void )
+{
+    size_t xClass;
+    size_t xObjects;
+
+    for( xClass = 0U; xClass < heapSLAB_CLASS_COUNT; xClass++ )
+    {
+        xObjects = ( heapmanagementSLAB_SIZE - heapSLAB_HEADER_SIZE ) / heapFOOTPRINT( xSlabClassSizes[ xClass ] );
+
+        configASSERT( ( xObjects > 0U ) && ( xObjects <= UINT16_MAX ) );
+
+        xSlabObjectCounts[ xClass ] = xObjects;
+        xSlabObjectSizes[ xClass ] = ( ( ( heapmanagementSLAB_SIZE - heapSLAB_HEADER_SIZE ) / xObjects ) & ~( heapALIGNMENT - 1U ) ) - heapHEADER_SIZE;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t prvSlabClass( size_t xSize )
+{
+    size_t xClass = heapSLAB_CLASS_COUNT;
+
+    if( heapmanagementUSE_SLABS != 0 )
+    {
+        /* The first allocation is made before the scheduler starts, by the
+         * creation of the first task, so the classes are sized before any
+         * other task can allocate. */
+        if( xSlabObjectSizes[ 0 ] == 0U )
+        {
+            prvSlabClassesInit();
+        }
+
+        for( xClass = 0U; xClass < heapSLAB_CLASS_COUNT; xClass++ )
+        {
+            if( xSize <= xSlabObjectSizes[ xClass ] )
+            {
+                break;
+            }
+        }
+    }
+
+    return xClass;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Add a slab to the slabs of its class that have objects not allocated, in
+ * address order so that the lowest slab is filled first and the others empty
+ * out. Must be called with the scheduler suspended. */
+static void prvSlabInsertPartial( HeapSlab_t * pxSlab )
+{
+    HeapSlab_t ** ppxLink = &pxPartialSlabs[ pxSlab->ucClass ];
+
+    while( ( *ppxLink != NULL ) && ( ( uintptr_t ) *ppxLink < ( uintptr_t ) pxSlab ) )
+    {
+        ppxLink = &( *ppxLink )->pxNextPartial;
+    }
+
+    pxSlab->pxNextPartial = *ppxLink;
+    *ppxLink = pxSlab;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Forget an empty slab so that it can be freed. Must be called with the
+ * scheduler suspended. */
+static void prvSlabRemove( HeapSlab_t * pxSlab )
+{
+    HeapSlab_t ** ppxLink = &pxPartialSlabs[ pxSlab->ucClass ];
+
+    while( *ppxLink != pxSlab )
+    {
+        ppxLink = &( *ppxLink )->pxNextPartial;
+    }
+
+    *ppxLink = pxSlab->pxNextPartial;
+    pxSlabs[ pxSlab->ucEntry ] = NULL;
+
+    xHeapStats.xSlabBytes -= heapmanagementSLAB_SIZE;
+    xHeapStats.xSlabFreeBytes -= xSlabObjectCounts[ pxSlab->ucClass ] * xSlabObjectSizes[ pxSlab->ucClass ];
+    xAllocatedFootprint -= heapmanagementSLAB_SIZE;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Allocate a slab in an unused entry and cut it into objects. Must be called
+ * with the scheduler suspended. */
+static HeapSlab_t * prvSlabCreate( size_t xClass,
+                                   size_t xEntry )
+{
+    HeapSlab_t * pxSlab = malloc( heapmanagementSLAB_SIZE );
+    HeapBlockHeader_t * pxObject;
+    size_t xObjectSize = heapHEADER_SIZE + xSlabObjectSizes[ xClass ];
+    size_t xObjects = xSlabObjectCounts[ xClass ];
+    size_t xObject;
+
+    if( pxSlab != NULL )
+    {
+        pxSlab->pxFreeObjects = NULL;
+        pxSlab->usObjectsInUse = 0U;
+        pxSlab->ucClass = ( uint8_t ) xClass;
+        pxSlab->ucEntry = ( uint8_t ) xEntry;
+
+        /* Link the objects from the last so that they are handed out in
+         * address order. */
+        for( xObject = xObjects; xObject > 0U; xObject-- )
+        {
+            pxObject = ( HeapBlockHeader_t * ) ( ( uint8_t * ) pxSlab + heapSLAB_HEADER_SIZE + ( ( xObject - 1U ) * xObjectSize ) );
+            pxObject->ucMagic = 0U;
+            pxObject->pxNext = pxSlab->pxFreeObjects;
+            pxSlab->pxFreeObjects = pxObject;
+        }
+
+        pxSlabs[ xEntry ] = pxSlab;
+        prvSlabInsertPartial( pxSlab );
+
+        xHeapStats.xSlabBytes += heapmanagementSLAB_SIZE;
+        xHeapStats.xSlabFreeBytes += xObjects * xSlabObjectSizes[ xClass ];
+        xAllocatedFootprint += heapmanagementSLAB_SIZE;
+
+        if( xAllocatedFootprint > xPeakAllocatedFootprint )
+        {
+            xPeakAllocatedFootprint = xAllocatedFootprint;
+        }
+    }
+
+    return pxSlab;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Take an object from the lowest slab of the class that has one, allocating a
+ * new slab if they are all full. */
+static HeapBlockHeader_t * prvSlabTake( size_t xClass )
+{
+    HeapBlockHeader_t * pxObject = NULL;
+    HeapSlab_t * pxSlab;
+    size_t xEntry = 0U;
+
+    vTaskSuspendAll();
+    {
+        pxSlab = pxPartialSlabs[ xClass ];
+
+        if( pxSlab == NULL )
+        {
+            while( ( xEntry < heapSLAB_MAX_COUNT ) && ( pxSlabs[ xEntry ] != NULL ) )
+            {
+                xEntry++;
+            }
+
+            if( xEntry < heapSLAB_MAX_COUNT )
+            {
+                pxSlab = prvSlabCreate( xClass, xEntry );
+            }
+        }
+
+        if( pxSlab != NULL )
+        {
+            pxObject = pxSlab->pxFreeObjects;
+            pxSlab->pxFreeObjects = pxObject->pxNext;
+            pxSlab->usObjectsInUse++;
+
+            if( pxSlab->pxFreeObjects == NULL )
+            {
+                pxPartialSlabs[ xClass ] = pxSlab->pxNextPartial;
+            }
+
+            pxObject->ucSlab = pxSlab->ucEntry;
+            xHeapStats.xSlabFreeBytes -= xSlabObjectSizes[ xClass ];
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return pxObject;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Put an object back in its slab. Must be called with the scheduler
+ * suspended. Returns the slab to free if it emptied while the slabs hold more
+ * than heapmanagementSLAB_RELEASE_BYTES, NULL otherwise. */
+static HeapSlab_t * prvSlabGive( HeapBlockHeader_t * pxObject )
+{
+    HeapSlab_t * pxSlab = pxSlabs[ pxObject->ucSlab ];
+
+    configASSERT( pxSlab != NULL );
+
+    if( pxSlab->pxFreeObjects == NULL )
+    {
+        prvSlabInsertPartial( pxSlab );
+    }
+
+    pxObject->pxNext = pxSlab->pxFreeObjects;
+    pxSlab->pxFreeObjects = pxObject;
+    pxSlab->usObjectsInUse--;
+    xHeapStats.xSlabFreeBytes += xSlabObjectSizes[ pxSlab->ucClass ];
+
+    if( ( pxSlab->usObjectsInUse == 0U ) && ( xHeapStats.xSlabBytes > heapmanagementSLAB_RELEASE_BYTES ) )
+    {
+        prvSlabRemove( pxSlab );
+    }
+    else
+    {
+        pxSlab = NULL;
+    }
+
+    return pxSlab;
+}
+
+/*-----------------------------------------------------------*/
+
+static void * prvAllocate( size_t xWantedSize,
+                           const void * pvCaller )
+{
+    HeapBlockHeader_t * pxBlock = NULL;
+    HeapCallerStats_t * pxCaller;
+    size_t xClass = prvSlabClass( xWantedSize );
+
+    if( xClass < heapSLAB_CLASS_COUNT )
+    {
+        pxBlock = prvSlabTake( xClass );
+    }
+
+    /* The sizes without a slab class, and those of a class when the slabs
+     * cannot grow, are allocated on their own. */
+    if( ( pxBlock == NULL ) && ( xWantedSize <= heapMAXIMUM_SIZE ) )
+    {
+        pxBlock = malloc( heapHEADER_SIZE + xWantedSize );
+
+        if( pxBlock != NULL )
+        {
+            pxBlock->ucSlab = heapNOT_FROM_SLAB;
+        }
+    }
+
+    vTaskSuspendAll();
+    {
+        if( pxBlock != NULL )
+        {
+            pxBlock->xSize = xWantedSize;
+            pxBlock->usCaller = prvCallerEntry( pvCaller );
+            pxBlock->ucMagic = heapBLOCK_MAGIC;
+            pxBlock->pxPrev = NULL;
+            pxBlock->pxNext = pxAllocatedBlocks;
+
+            if( pxAllocatedBlocks != NULL )
+            {
+                pxAllocatedBlocks->pxPrev = pxBlock;
+            }
+
+            pxAllocatedBlocks = pxBlock;
+
+            xHeapStats.xLiveBytes += xWantedSize;
+            xHeapStats.xLiveBlocks++;
+            xHeapStats.xSuccessfulAllocations++;
+
+            if( xHeapStats.xLiveBytes > xHeapStats.xPeakLiveBytes )
+            {
+                xHeapStats.xPeakLiveBytes = xHeapStats.xLiveBytes;
+            }
+
+            if( pxBlock->ucSlab == heapNOT_FROM_SLAB )
+            {
+                xAllocatedFootprint += heapFOOTPRINT( xWantedSize );
+
+                if( xAllocatedFootprint > xPeakAllocatedFootprint )
+                {
+                    xPeakAllocatedFootprint = xAllocatedFootprint;
+                }
+            }
+            else
+            {
+                xHeapStats.xSlabAllocations++;
+            }
+
+            xClass = prvSizeClass( xWantedSize );
+            xHeapStats.xLiveBlocksPerSizeClass[ xClass ]++;
+            xHeapStats.xAllocationsPerSizeClass[ xClass ]++;
+
+            pxCaller = &xHeapStats.xCallers[ pxBlock->usCaller ];
+            pxCaller->xLiveBytes += xWantedSize;
+            pxCaller->xLiveBlocks++;
+
+            if( pxCaller->xLiveBytes > pxCaller->xPeakBytes )
+            {
+                pxCaller->xPeakBytes = pxCaller->xLiveBytes;
+            }
+        }
+        else
+        {
+            xHeapStats.xFailedAllocations++;
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return ( pxBlock != NULL ) ? ( void * ) ( ( uint8_t * ) pxBlock + heapHEADER_SIZE ) : NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Start a walk through the free blocks: sort the allocated blocks by address,
+ * with a bottom-up merge sort that needs no memory, and list the slabs by
+ * address. Must be called with the scheduler suspended. */
+static void prvStartFreeBlockWalk( FreeBlockIterator_t * pxIterator )
+{
+    HeapSlab_t * pxSlab;
+    size_t xEntry;
+    size_t xSorted;
+    size_t xPosition;
+    HeapBlockHeader_t * pxList = pxAllocatedBlocks;
+    HeapBlockHeader_t * pxPrevious = NULL;
+    HeapBlockHeader_t * pxBlock;
+    size_t xRunLength = 1U;
+    size_t xMerges;
+
+    do
+    {
+        HeapBlockHeader_t * pxLeft = pxList;
+        HeapBlockHeader_t * pxTail = NULL;
+
+        pxList = NULL;
+        xMerges = 0U;
+
+        /* Merge the runs of xRunLength blocks two by two, following the
+         * forward links only. */
+        while( pxLeft != NULL )
+        {
+            HeapBlockHeader_t * pxRight = pxLeft;
+            size_t xLeftLength = 0U;
+            size_t xRightLength = xRunLength;
+
+            xMerges++;
+
+            while( ( xLeftLength < xRunLength ) && ( pxRight != NULL ) )
+            {
+                xLeftLength++;
+                pxRight = pxRight->pxNext;
+            }
+
+            while( ( xLeftLength > 0U ) || ( ( xRightLength > 0U ) && ( pxRight != NULL ) ) )
+            {
+                if( ( xLeftLength > 0U ) &&
+                    ( ( xRightLength == 0U ) || ( pxRight == NULL ) || ( ( uintptr_t ) pxLeft < ( uintptr_t ) pxRight ) ) )
+                {
+                    pxBlock = pxLeft;
+                    pxLeft = pxLeft->pxNext;
+                    xLeftLength--;
+                }
+                else
+                {
+                    pxBlock = pxRight;
+                    pxRight = pxRight->pxNext;
+                    xRightLength--;
+                }
+
+                if( pxTail != NULL )
+                {
+                    pxTail->pxNext = pxBlock;
+                }
+                else
+                {
+                    pxList = pxBlock;
+                }
+
+                pxTail = pxBlock;
+            }
+
+            pxLeft = pxRight;
+        }
+
+        if( pxTail != NULL )
+        {
+            pxTail->pxNext = NULL;
+        }
+
+        xRunLength <<= 1U;
+    } while( xMerges > 1U );
+
+    pxAllocatedBlocks = pxList;
+
+    for( pxBlock = pxList; pxBlock != NULL; pxBlock = pxBlock->pxNext )
+    {
+        pxBlock->pxPrev = pxPrevious;
+        pxPrevious = pxBlock;
+    }
+
+    pxIterator->pxNextBlock = pxAllocatedBlocks;
+    pxIterator->xNextSlab = 0U;
+    pxIterator->uxCursor = heapREGION_START;
+
+    /* Insertion sort of the few slabs into the iterator, pxSlabs keeps its
+     * order. */
+    xSorted = 0U;
+
+    for( xEntry = 0U; xEntry < heapSLAB_MAX_COUNT; xEntry++ )
+    {
+        pxSlab = pxSlabs[ xEntry ];
+
+        if( pxSlab != NULL )
+        {
+            xPosition = xSorted;
+
+            while( ( xPosition > 0U ) && ( ( uintptr_t ) pxIterator->pxSlabs[ xPosition - 1U ] > ( uintptr_t ) pxSlab ) )
+            {
+                pxIterator->pxSlabs[ xPosition ] = pxIterator->pxSlabs[ xPosition - 1U ];
+                xPosition--;
+            }
+
+            pxIterator->pxSlabs[ xPosition ] = pxSlab;
+            xSorted++;
+        }
+    }
+
+    for( xEntry = xSorted; xEntry < heapSLAB_MAX_COUNT; xEntry++ )
+    {
+        pxIterator->pxSlabs[ xEntry ] = NULL;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/* Find the next free block of the heap region, the walk must have been
+ * started with prvStartFreeBlockWalk(). Blocks outside of the region are not from the C library
+ * heap and are skipped. The blocks allocated with malloc() directly are not
+ * known, so they are part of the free blocks found. */
+static BaseType_t prvNextFreeBlock( FreeBlockIterator_t * pxIterator,
+                                    uintptr_t * puxStart,
+                                    uintptr_t * puxEnd )
+{
+    BaseType_t xFound = pdFALSE;
+    uintptr_t uxBlockStart;
+    uintptr_t uxBlockEnd;
+
+    while( ( xFound == pdFALSE ) && ( pxIterator->uxCursor < heapREGION_END ) )
+    {
+        const HeapSlab_t * pxSlab = ( pxIterator->xNextSlab < heapSLAB_MAX_COUNT ) ? pxIterator->pxSlabs[ pxIterator->xNextSlab ] : NULL;
+
+        if( ( pxSlab != NULL ) &&
+            ( ( pxIterator->pxNextBlock == NULL ) || ( ( uintptr_t ) pxSlab < ( uintptr_t ) pxIterator->pxNextBlock ) ) )
+        {
+            /* The objects of the slab are within it. */
+            uxBlockStart = ( uintptr_t ) pxSlab;
+            uxBlockEnd = uxBlockStart + heapmanagementSLAB_SIZE;
+            pxIterator->xNextSlab++;
+
+            if( ( uxBlockStart < heapREGION_START ) || ( uxBlockEnd > heapREGION_END ) )
+            {
+                continue;
+            }
+        }
+        else if( pxIterator->pxNextBlock != NULL )
+        {
+            uxBlockStart = ( uintptr_t ) pxIterator->pxNextBlock;
+            uxBlockEnd = uxBlockStart + heapFOOTPRINT( pxIterator->pxNextBlock->xSize );
+            pxIterator->pxNextBlock = pxIterator->pxNextBlock->pxNext;
+
+            if( ( uxBlockStart < heapREGION_START ) || ( uxBlockEnd > heapREGION_END ) )
+            {
+                continue;
+            }
+        }
+        else
+        {
+            uxBlockStart = heapREGION_END;
+            uxBlockEnd = heapREGION_END;
+        }
+
+        if( uxBlockStart >= ( pxIterator->uxCursor + heapMINIMUM_FREE_BLOCK ) )
+        {
+            *puxStart = pxIterator->uxCursor;
+            *puxEnd = uxBlockStart;
+            xFound = pdTRUE;
+        }
+
+        if( uxBlockEnd > pxIterator->uxCursor )
+        {
+            pxIterator->uxCursor = uxBlockEnd;
+        }
+    }
+
+    return xFound;
+}
+
+/*-----------------------------------------------------------*/
 
 void * pvPortMalloc( size_t xWantedSize )
 {
-    return malloc( xWantedSize );
+    return prvAllocate( xWantedSize, __builtin_return_address( 0 ) );
 }
 
+/*-----------------------------------------------------------*/
+
 void vPortFree( void * pv )
 {
-    free( pv );
+    HeapBlockHeader_t * pxBlock;
+    HeapCallerStats_t * pxCaller;
+    void * pvRelease = NULL;
+
+    if( pv != NULL )
+    {
+        pxBlock = ( HeapBlockHeader_t * ) ( ( uint8_t * ) pv - heapHEADER_SIZE );
+
+        /* Catch blocks freed twice or not allocated with pvPortMalloc(). */
+        configASSERT( pxBlock->ucMagic == heapBLOCK_MAGIC );
+
+        vTaskSuspendAll();
+        {
+            if( pxBlock->pxPrev != NULL )
+            {
+                pxBlock->pxPrev->pxNext = pxBlock->pxNext;
+            }
+            else
+            {
+                pxAllocatedBlocks = pxBlock->pxNext;
+            }
+
+            if( pxBlock->pxNext != NULL )
+            {
+                pxBlock->pxNext->pxPrev = pxBlock->pxPrev;
+            }
+
+            xHeapStats.xLiveBytes -= pxBlock->xSize;
+            xHeapStats.xLiveBlocks--;
+            xHeapStats.xSuccessfulFrees++;
+            xHeapStats.xLiveBlocksPerSizeClass[ prvSizeClass( pxBlock->xSize ) ]--;
+
+            pxCaller = &xHeapStats.xCallers[ pxBlock->usCaller ];
+            pxCaller->xLiveBytes -= pxBlock->xSize;
+            pxCaller->xLiveBlocks--;
+
+            pxBlock->ucMagic = 0U;
+
+            if( pxBlock->ucSlab != heapNOT_FROM_SLAB )
+            {
+                pvRelease = prvSlabGive( pxBlock );
+            }
+            else
+            {
+                xAllocatedFootprint -= heapFOOTPRINT( pxBlock->xSize );
+                pvRelease = pxBlock;
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        if( pvRelease != NULL )
+        {
+            free( pvRelease );
+        }
+    }
 }
 
+/*-----------------------------------------------------------*/
+
 void * pvPortCalloc( size_t xNum,
                      size_t xSize )
 {
-    return calloc( xNum, xSize );
+    size_t xTotalSize = SIZE_MAX;
+    void * pv;
+
+    if( ( xSize == 0U ) || ( xNum <= ( SIZE_MAX / xSize ) ) )
+    {
+        xTotalSize = xNum * xSize;
+    }
+
+    /* An overflowing size is too large for prvAllocate() and fails there. */
+    pv = prvAllocate( xTotalSize, __builtin_return_address( 0 ) );
+
+    if( pv != NULL )
+    {
+        ( void ) memset( pv, 0, xTotalSize );
+    }
+
+    return pv;
 }
 
+/*-----------------------------------------------------------*/
+
 size_t xPortGetFreeHeapSize( void )
 {
-    return 0;
+    size_t xAllocated = xAllocatedFootprint;
+
+    return ( xAllocated < heapREGION_SIZE ) ? ( heapREGION_SIZE - xAllocated ) : 0U;
 }
 
+/*-----------------------------------------------------------*/
+
 size_t xPortGetMinimumEverFreeHeapSize( void )
 {
-    return 0;
+    size_t xPeak = xPeakAllocatedFootprint;
+
+    return ( xPeak < heapREGION_SIZE ) ? ( heapREGION_SIZE - xPeak ) : 0U;
+}
+
+/*-----------------------------------------------------------*/
+
+void vHeapManagementGetStats( HeapManagementStats_t * pxStats )
+{
+    FreeBlockIterator_t xIterator;
+    uintptr_t uxStart;
+    uintptr_t uxEnd;
+
+    vTaskSuspendAll();
+    {
+        *pxStats = xHeapStats;
+        pxStats->xHeapSize = heapREGION_SIZE;
+        pxStats->xFreeBytes = xPortGetFreeHeapSize();
+        pxStats->xMinimumEverFreeBytes = xPortGetMinimumEverFreeHeapSize();
+        pxStats->xLargestFreeBlock = 0U;
+        pxStats->xFreeBlocks = 0U;
+
+        prvStartFreeBlockWalk( &xIterator );
+
+        while( prvNextFreeBlock( &xIterator, &uxStart, &uxEnd ) == pdTRUE )
+        {
+            pxStats->xFreeBlocks++;
+
+            if( ( size_t ) ( uxEnd - uxStart ) > pxStats->xLargestFreeBlock )
+            {
+                pxStats->xLargestFreeBlock = ( size_t ) ( uxEnd - uxStart );
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+size_t xHeapManagementReleaseSlabs( void )
+{
+    HeapSlab_t * pxSlab;
+    size_t xReleased = 0U;
+    size_t xEntry;
+
+    vTaskSuspendAll();
+    {
+        for( xEntry = 0U; xEntry < heapSLAB_MAX_COUNT; xEntry++ )
+        {
+            pxSlab = pxSlabs[ xEntry ];
+
+            if( ( pxSlab != NULL ) && ( pxSlab->usObjectsInUse == 0U ) )
+            {
+                prvSlabRemove( pxSlab );
+                xReleased += heapmanagementSLAB_SIZE;
+
+                free( pxSlab );
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return xReleased;
+}
+
+/*-----------------------------------------------------------*/
+
+size_t xHeapManagementFormatFragmentationMap( char * pcBuffer,
+                                              size_t xBufferSize )
+{
+    FreeBlockIterator_t xIterator;
+    uintptr_t uxFreeStart;
+    uintptr_t uxFreeEnd;
+    uintptr_t uxSliceStart;
+    uintptr_t uxSliceEnd;
+    size_t xSlices = 0U;
+    size_t xSlice = 0U;
+    size_t xFreeInSlice = 0U;
+
+    if( xBufferSize > 0U )
+    {
+        xSlices = xBufferSize - 1U;
+
+        if( xSlices > heapREGION_SIZE )
+        {
+            xSlices = heapREGION_SIZE;
+        }
+    }
+
+    vTaskSuspendAll();
+    {
+        prvStartFreeBlockWalk( &xIterator );
+
+        /* Add each free block to the slices it covers, in address order. */
+        while( ( xSlice < xSlices ) && ( prvNextFreeBlock( &xIterator, &uxFreeStart, &uxFreeEnd ) == pdTRUE ) )
+        {
+            while( ( xSlice < xSlices ) && ( uxFreeStart < uxFreeEnd ) )
+            {
+                uxSliceStart = heapSLICE_START( xSlice, xSlices );
+                uxSliceEnd = heapSLICE_START( xSlice + 1U, xSlices );
+
+                if( uxFreeStart < uxSliceEnd )
+                {
+                    if( uxFreeStart < uxSliceStart )
+                    {
+                        uxFreeStart = uxSliceStart;
+                    }
+
+                    xFreeInSlice += ( size_t ) ( ( ( uxFreeEnd < uxSliceEnd ) ? uxFreeEnd : uxSliceEnd ) - uxFreeStart );
+                    uxFreeStart = ( uxFreeEnd < uxSliceEnd ) ? uxFreeEnd : uxSliceEnd;
+                }
+
+                if( uxFreeStart >= uxSliceEnd )
+                {
+                    pcBuffer[ xSlice ] = ( xFreeInSlice == 0U ) ? '#' :
+                                         ( xFreeInSlice >= ( size_t ) ( uxSliceEnd - uxSliceStart ) ) ? '.' : '+';
+                    xFreeInSlice = 0U;
+                    xSlice++;
+                }
+            }
+        }
+
+        /* The slices after the last free block are fully allocated. */
+        while( xSlice < xSlices )
+        {
+            pcBuffer[ xSlice ] = ( xFreeInSlice == 0U ) ? '#' : '+';
+            xFreeInSlice = 0U;
+            xSlice++;
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    if( xBufferSize > 0U )
+    {
+        pcBuffer[ xSlices ] = '\0';
+    }
+
+    return xSlices;
 }
@@ -5,10 +5,117 @@
 
 #include "gtest/gtest.h"
 #include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
 
 extern "C" {
 #include "heap_management.h"
 #include "alloc_fakes.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+DEFINE_FAKE_VOID_FUNC( vAssertCalled,
+                       const char *,
+                       unsigned long );
+
+/* The C library allocator, see the link options of the test. */
+void * __real_malloc( size_t size );
+void __real_free( void * ptr );
+
+/* The heap region, see the link options of the test. */
+alignas( 16 ) uint8_t testHeapRegion[ TEST_HEAP_REGION_SIZE ];
+}
+
+static const uintptr_t regionStart = reinterpret_cast<uintptr_t>( testHeapRegion );
+static const uintptr_t regionEnd = regionStart + TEST_HEAP_REGION_SIZE;
+static const size_t alignment = 2U * sizeof( void * );
+
+/* Above the largest slab class. */
+static const size_t largeSize = 2048U;
+
+static size_t roundUp( size_t size )
+{
+    return ( size + alignment - 1U ) & ~( alignment - 1U );
+}
+
+/* First fit allocator over the heap region, with a bookkeeping word in front
+ * of every chunk like the C library. */
+class RegionAllocator
+{
+public:
+    static void * allocate( size_t size )
+    {
+        size_t chunkSize = overhead + roundUp( size );
+        uintptr_t cursor = regionStart;
+
+        for( std::map<uintptr_t, size_t>::const_iterator chunk = chunks.begin(); chunk != chunks.end(); ++chunk )
+        {
+            if( chunk->first - cursor >= chunkSize )
+            {
+                break;
+            }
+
+            cursor = chunk->first + chunk->second;
+        }
+
+        if( cursor + chunkSize > regionEnd )
+        {
+            return nullptr;
+        }
+
+        chunks[ cursor ] = chunkSize;
+
+        return reinterpret_cast<void *>( cursor + overhead );
+    }
+
+    static void release( void * ptr )
+    {
+        if( ptr != nullptr )
+        {
+            ASSERT_EQ( chunks.erase( reinterpret_cast<uintptr_t>( ptr ) - overhead ), 1U );
+        }
+    }
+
+    static const size_t overhead = alignment;
+    static std::map<uintptr_t, size_t> chunks;
+};
+
+std::map<uintptr_t, size_t> RegionAllocator::chunks;
+
+/* Number of gaps between the chunks of the region allocator. */
+static size_t freeFragments()
+{
+    size_t count = 0U;
+    uintptr_t cursor = regionStart;
+
+    for( std::map<uintptr_t, size_t>::const_iterator chunk = RegionAllocator::chunks.begin(); chunk != RegionAllocator::chunks.end(); ++chunk )
+    {
+        count += ( chunk->first > cursor ) ? 1U : 0U;
+        cursor = chunk->first + chunk->second;
+    }
+
+    return count + ( ( regionEnd > cursor ) ? 1U : 0U );
+}
+
+/* Largest gap between the chunks of the region allocator. */
+static size_t largestGap()
+{
+    size_t largest = 0U;
+    uintptr_t cursor = regionStart;
+
+    for( std::map<uintptr_t, size_t>::const_iterator chunk = RegionAllocator::chunks.begin(); chunk != RegionAllocator::chunks.end(); ++chunk )
+    {
+        largest = std::max( largest, static_cast<size_t>( chunk->first - cursor ) );
+        cursor = chunk->first + chunk->second;
+    }
+
+    return std::max( largest, static_cast<size_t>( regionEnd - cursor ) );
 }
 
 class TestHeapManagement : public ::testing::Test {
@@ -18,173 +125,841 @@ public:
         RESET_FAKE( test_malloc );
         RESET_FAKE( test_calloc );
         RESET_FAKE( test_free );
+        RESET_FAKE( vAssertCalled );
+        RESET_FAKE( vTaskSuspendAll );
+        RESET_FAKE( xTaskResumeAll );
+
+        test_malloc_fake.custom_fake = RegionAllocator::allocate;
+        test_free_fake.custom_fake = RegionAllocator::release;
+
+        vHeapManagementGetStats( &initialStats );
+    }
+
+    ~TestHeapManagement()
+    {
+        /* Leave the heap empty for the next test. */
+        test_free_fake.custom_fake = RegionAllocator::release;
+
+        for( std::map<void *, size_t>::const_iterator block = blocks.begin(); block != blocks.end(); ++block )
+        {
+            vPortFree( block->first );
+        }
+
+        ( void ) xHeapManagementReleaseSlabs();
+
+        EXPECT_TRUE( RegionAllocator::chunks.empty() );
+        EXPECT_EQ( vAssertCalled_fake.call_count, 0U );
+        EXPECT_EQ( vTaskSuspendAll_fake.call_count, xTaskResumeAll_fake.call_count );
+    }
+
+    /* The helpers are not inlined so that they are a single caller. */
+    __attribute__( ( noinline ) ) void * allocate( size_t size )
+    {
+        void * ptr = pvPortMalloc( size );
+
+        if( ptr != nullptr )
+        {
+            blocks[ ptr ] = size;
+        }
+
+        return ptr;
+    }
+
+    void release( void * ptr )
+    {
+        blocks.erase( ptr );
+        vPortFree( ptr );
+    }
+
+    __attribute__( ( noinline ) ) static size_t headerSize()
+    {
+        void * ptr;
+        size_t size;
+
+        RESET_FAKE( test_malloc );
+        RESET_FAKE( test_free );
+        test_malloc_fake.custom_fake = RegionAllocator::allocate;
+        test_free_fake.custom_fake = RegionAllocator::release;
+        ptr = pvPortMalloc( largeSize );
+        size = test_malloc_fake.arg0_val - largeSize;
+        vPortFree( ptr );
+
+        return size;
+    }
+
+    /* Footprint of the blocks and slabs allocated with malloc(). */
+    static size_t allocatedFootprint()
+    {
+        size_t footprint = 0U;
+
+        for( std::map<uintptr_t, size_t>::const_iterator chunk = RegionAllocator::chunks.begin(); chunk != RegionAllocator::chunks.end(); ++chunk )
+        {
+            footprint += chunk->second - RegionAllocator::overhead;
+        }
+
+        return footprint;
+    }
+
+    /* Check the free blocks against the chunks of the region allocator. */
+    void expectFreeBlocks( const HeapManagementStats_t & stats )
+    {
+        size_t largest = 0U;
+        size_t count = 0U;
+        uintptr_t cursor = regionStart;
+
+        for( std::map<uintptr_t, size_t>::const_iterator chunk = RegionAllocator::chunks.begin(); ; ++chunk )
+        {
+            uintptr_t start = ( chunk == RegionAllocator::chunks.end() ) ? regionEnd : chunk->first + RegionAllocator::overhead;
+
+            /* Gaps too small for a block are allocator overhead. */
+            if( start - cursor >= header + alignment )
+            {
+                largest = std::max( largest, static_cast<size_t>( start - cursor ) );
+                count++;
+            }
+
+            if( chunk == RegionAllocator::chunks.end() )
+            {
+                break;
+            }
+
+            cursor = chunk->first + chunk->second;
+        }
+
+        EXPECT_EQ( stats.xLargestFreeBlock, largest );
+        EXPECT_EQ( stats.xFreeBlocks, count );
+    }
+
+    std::string fragmentationMap( size_t slices )
+    {
+        std::string map( slices + 1U, 'x' );
+        size_t length = xHeapManagementFormatFragmentationMap( &map[ 0 ], map.size() );
+
+        EXPECT_EQ( length, slices );
+        EXPECT_EQ( map[ slices ], '\0' );
+
+        return map.substr( 0, length );
     }
+
+    HeapManagementStats_t initialStats;
+    std::map<void *, size_t> blocks;
+    const size_t header = headerSize();
 };
 
-TEST_F( TestHeapManagement, calls_malloc_and_returns_same_pointer )
+TEST_F( TestHeapManagement, calls_malloc_once_and_returns_the_memory_after_the_header )
 {
-    static uint8_t dummy[ 32 ];
+    void * allocated_ptr = allocate( largeSize );
 
-    test_malloc_fake.return_val = dummy;
-    void * allocated_ptr = pvPortMalloc( 32 );
-    ASSERT_EQ( allocated_ptr, static_cast<void *>( dummy ) );
+    ASSERT_NE( allocated_ptr, nullptr );
+    EXPECT_EQ( test_malloc_fake.call_count, 1 );
+    EXPECT_EQ( test_malloc_fake.arg0_val, header + largeSize );
+    EXPECT_EQ( reinterpret_cast<uintptr_t>( allocated_ptr ), RegionAllocator::chunks.begin()->first + RegionAllocator::overhead + header );
+    EXPECT_EQ( reinterpret_cast<uintptr_t>( allocated_ptr ) % alignment, 0U );
+}
 
+TEST_F( TestHeapManagement, calling_malloc_with_size_zero_may_return_pointer )
+{
+    void * allocated_ptr = allocate( 0 );
+
+    /* The smallest slab class serves it. */
+    ASSERT_NE( allocated_ptr, nullptr );
     EXPECT_EQ( test_malloc_fake.call_count, 1 );
-    EXPECT_EQ( test_malloc_fake.arg0_val, static_cast<size_t>( 32 ) );
+    EXPECT_EQ( test_malloc_fake.arg0_val, heapmanagementSLAB_SIZE );
 }
 
-TEST_F( TestHeapManagement, calling_malloc_with_size_zero_may_return_null )
+TEST_F( TestHeapManagement, returns_null_when_malloc_fails )
 {
+    test_malloc_fake.custom_fake = nullptr;
     test_malloc_fake.return_val = nullptr;
-    void * allocated_ptr = pvPortMalloc( 0 );
+    void * allocated_ptr = pvPortMalloc( largeSize );
     ASSERT_EQ( allocated_ptr, nullptr );
 
     EXPECT_EQ( test_malloc_fake.call_count, 1 );
-    EXPECT_EQ( test_malloc_fake.arg0_val, static_cast<size_t>( 0 ) );
+    EXPECT_EQ( test_malloc_fake.arg0_val, header + largeSize );
+
+    HeapManagementStats_t stats;
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xFailedAllocations, initialStats.xFailedAllocations + 1U );
+    EXPECT_EQ( stats.xSuccessfulAllocations, initialStats.xSuccessfulAllocations );
 }
 
-TEST_F( TestHeapManagement, calling_malloc_with_size_zero_may_return_pointer )
+TEST_F( TestHeapManagement, returns_null_without_calling_malloc_when_the_size_overflows )
 {
-    static uint8_t dummy[ 1 ];
+    ASSERT_EQ( pvPortMalloc( SIZE_MAX ), nullptr );
+    ASSERT_EQ( pvPortMalloc( SIZE_MAX - header + 1U ), nullptr );
 
-    test_malloc_fake.return_val = dummy;
-    void * allocated_ptr = pvPortMalloc( 0 );
-    ASSERT_EQ( allocated_ptr, static_cast<void *>( dummy ) );
+    EXPECT_EQ( test_malloc_fake.call_count, 0 );
+}
+
+TEST_F( TestHeapManagement, calls_free_with_the_block_malloc_returned )
+{
+    void * allocated_ptr = allocate( largeSize );
+
+    release( allocated_ptr );
+
+    EXPECT_EQ( test_free_fake.call_count, 1 );
+    EXPECT_EQ( test_free_fake.arg0_val, static_cast<uint8_t *>( allocated_ptr ) - header );
+}
+
+TEST_F( TestHeapManagement, freeing_null_does_nothing )
+{
+    vPortFree( nullptr );
+    EXPECT_EQ( test_free_fake.call_count, 0 );
+}
+
+TEST_F( TestHeapManagement, calloc_allocates_zeroed_memory )
+{
+    ( void ) memset( testHeapRegion, 0xA5, sizeof( testHeapRegion ) );
+
+    uint64_t * allocated_ptr = static_cast<uint64_t *>( pvPortCalloc( largeSize / 8U, 8 ) );
+    ASSERT_NE( allocated_ptr, nullptr );
+    blocks[ allocated_ptr ] = largeSize;
 
     EXPECT_EQ( test_malloc_fake.call_count, 1 );
-    EXPECT_EQ( test_malloc_fake.arg0_val, static_cast<size_t>( 0 ) );
+    EXPECT_EQ( test_malloc_fake.arg0_val, header + largeSize );
+    EXPECT_EQ( test_calloc_fake.call_count, 0 );
+
+    for( size_t i = 0; i < largeSize / 8U; i++ )
+    {
+        ASSERT_EQ( allocated_ptr[ i ], 0U );
+    }
 }
 
-TEST_F( TestHeapManagement, returns_null_when_malloc_fails )
+TEST_F( TestHeapManagement, calloc_zeroes_a_reused_slab_object )
+{
+    void * allocated_ptr = pvPortMalloc( 32 );
+
+    ASSERT_NE( allocated_ptr, nullptr );
+    ( void ) memset( allocated_ptr, 0xA5, 32 );
+    vPortFree( allocated_ptr );
+
+    uint64_t * reused_ptr = static_cast<uint64_t *>( pvPortCalloc( 4, 8 ) );
+    ASSERT_EQ( reused_ptr, allocated_ptr );
+    blocks[ reused_ptr ] = 32U;
+
+    for( int i = 0; i < 4; i++ )
+    {
+        EXPECT_EQ( reused_ptr[ i ], 0U );
+    }
+}
+
+TEST_F( TestHeapManagement, calling_calloc_with_a_zero_count_or_size_may_return_pointer )
+{
+    void * allocated_ptrs[] = { pvPortCalloc( 0, 8 ), pvPortCalloc( 8, 0 ), pvPortCalloc( 0, 0 ) };
+
+    for( void * allocated_ptr : allocated_ptrs )
+    {
+        ASSERT_NE( allocated_ptr, nullptr );
+        blocks[ allocated_ptr ] = 0U;
+    }
+
+    /* All from one slab. */
+    EXPECT_EQ( test_malloc_fake.call_count, 1 );
+    EXPECT_EQ( test_malloc_fake.arg0_val, heapmanagementSLAB_SIZE );
+}
+
+TEST_F( TestHeapManagement, returns_null_when_calloc_fails )
 {
+    test_malloc_fake.custom_fake = nullptr;
     test_malloc_fake.return_val = nullptr;
-    void * allocated_ptr = pvPortMalloc( 64 );
+    void * allocated_ptr = pvPortCalloc( 16, 8 );
     ASSERT_EQ( allocated_ptr, nullptr );
 
+    /* A slab, then the block on its own. */
+    EXPECT_EQ( test_malloc_fake.call_count, 2 );
+    EXPECT_EQ( test_malloc_fake.arg0_val, header + 128U );
+}
+
+TEST_F( TestHeapManagement, returns_null_without_calling_malloc_when_calloc_overflows )
+{
+    ASSERT_EQ( pvPortCalloc( SIZE_MAX / 2U + 1U, 2 ), nullptr );
+
+    EXPECT_EQ( test_malloc_fake.call_count, 0 );
+}
+
+TEST_F( TestHeapManagement, small_allocations_are_taken_from_one_slab )
+{
+    void * allocated_ptrs[] = { allocate( 16 ), allocate( 12 ), allocate( 1 ) };
+    HeapManagementStats_t stats;
+
     EXPECT_EQ( test_malloc_fake.call_count, 1 );
-    EXPECT_EQ( test_malloc_fake.arg0_val, static_cast<size_t>( 64 ) );
+    EXPECT_EQ( test_malloc_fake.arg0_val, heapmanagementSLAB_SIZE );
+    ASSERT_EQ( RegionAllocator::chunks.size(), 1U );
+
+    uintptr_t slab = RegionAllocator::chunks.begin()->first + RegionAllocator::overhead;
+
+    for( size_t i = 0U; i < 3U; i++ )
+    {
+        ASSERT_NE( allocated_ptrs[ i ], nullptr );
+        EXPECT_EQ( reinterpret_cast<uintptr_t>( allocated_ptrs[ i ] ) % alignment, 0U );
+        EXPECT_GT( reinterpret_cast<uintptr_t>( allocated_ptrs[ i ] ), slab );
+        EXPECT_LE( reinterpret_cast<uintptr_t>( allocated_ptrs[ i ] ) + 16U, slab + heapmanagementSLAB_SIZE );
+    }
+
+    /* Handed out in address order. */
+    EXPECT_EQ( static_cast<uint8_t *>( allocated_ptrs[ 1 ] ) - static_cast<uint8_t *>( allocated_ptrs[ 0 ] ), header + 16U );
+    EXPECT_EQ( static_cast<uint8_t *>( allocated_ptrs[ 2 ] ) - static_cast<uint8_t *>( allocated_ptrs[ 1 ] ), header + 16U );
+
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xSlabBytes, heapmanagementSLAB_SIZE );
+    EXPECT_EQ( stats.xSlabAllocations, initialStats.xSlabAllocations + 3U );
+    EXPECT_EQ( stats.xLiveBytes, 29U );
+    EXPECT_EQ( xPortGetFreeHeapSize(), TEST_HEAP_REGION_SIZE - heapmanagementSLAB_SIZE );
 }
 
-TEST_F( TestHeapManagement, calls_free_with_same_pointer )
+TEST_F( TestHeapManagement, a_freed_slab_object_is_reused_without_calling_malloc_or_free )
 {
-    static uint8_t dummy[ 16 ];
-    void * allocated_ptr = static_cast<void *>( dummy );
+    void * allocated_ptr = pvPortMalloc( 100 );
+    HeapManagementStats_t stats;
 
+    ASSERT_NE( allocated_ptr, nullptr );
+    vHeapManagementGetStats( &stats );
     vPortFree( allocated_ptr );
 
-    EXPECT_EQ( test_free_fake.call_count, 1 );
-    EXPECT_EQ( test_free_fake.arg0_val, allocated_ptr );
+    /* Any size of the same class. */
+    void * reused_ptr = allocate( 128 );
+
+    EXPECT_EQ( reused_ptr, allocated_ptr );
+    EXPECT_EQ( test_malloc_fake.call_count, 1 );
+    EXPECT_EQ( test_free_fake.call_count, 0 );
+
+    release( reused_ptr );
+
+    HeapManagementStats_t released;
+    vHeapManagementGetStats( &released );
+    EXPECT_EQ( released.xSlabFreeBytes, stats.xSlabFreeBytes + 128U );
+    EXPECT_EQ( released.xSlabBytes, heapmanagementSLAB_SIZE );
 }
 
-TEST_F( TestHeapManagement, calls_free_with_null )
+TEST_F( TestHeapManagement, only_the_empty_slabs_are_released )
 {
-    vPortFree( nullptr );
+    void * small = allocate( 16 );
+    void * medium = pvPortMalloc( 64 );
+    HeapManagementStats_t stats;
+
+    ASSERT_NE( small, nullptr );
+    ASSERT_NE( medium, nullptr );
+    EXPECT_EQ( test_malloc_fake.call_count, 2 );
+    vPortFree( medium );
+
+    EXPECT_EQ( xHeapManagementReleaseSlabs(), heapmanagementSLAB_SIZE );
     EXPECT_EQ( test_free_fake.call_count, 1 );
-    EXPECT_EQ( test_free_fake.arg0_val, nullptr );
+    EXPECT_EQ( xHeapManagementReleaseSlabs(), 0U );
+
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xSlabBytes, heapmanagementSLAB_SIZE );
+    EXPECT_EQ( xPortGetFreeHeapSize(), TEST_HEAP_REGION_SIZE - heapmanagementSLAB_SIZE );
+
+    release( small );
+    EXPECT_EQ( xHeapManagementReleaseSlabs(), heapmanagementSLAB_SIZE );
+
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xSlabBytes, 0U );
+    EXPECT_EQ( stats.xSlabFreeBytes, 0U );
+    EXPECT_EQ( xPortGetFreeHeapSize(), TEST_HEAP_REGION_SIZE );
+    EXPECT_TRUE( RegionAllocator::chunks.empty() );
 }
 
-TEST_F( TestHeapManagement, calls_calloc_and_returns_same_pointer )
+TEST_F( TestHeapManagement, blocks_above_the_largest_slab_class_are_allocated_on_their_own )
 {
-    static uint64_t dummy[ 4 ];
+    void * allocated_ptr = allocate( largeSize );
+    HeapManagementStats_t stats;
 
-    test_calloc_fake.return_val = dummy;
-    void * allocated_ptr = pvPortCalloc( 4, 8 );
-    ASSERT_EQ( allocated_ptr, static_cast<void *>( dummy ) );
+    ASSERT_NE( allocated_ptr, nullptr );
+    EXPECT_EQ( test_malloc_fake.call_count, 1 );
+    EXPECT_EQ( test_malloc_fake.arg0_val, header + largeSize );
 
-    EXPECT_EQ( test_calloc_fake.call_count, 1 );
-    EXPECT_EQ( test_calloc_fake.arg0_val, 4 );
-    EXPECT_EQ( test_calloc_fake.arg1_val, 8 );
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xSlabBytes, 0U );
+    EXPECT_EQ( stats.xSlabAllocations, initialStats.xSlabAllocations );
 }
 
-TEST_F( TestHeapManagement, calling_calloc_with_num_zero_may_return_null )
+TEST_F( TestHeapManagement, the_objects_of_a_class_share_the_whole_slab )
 {
-    test_calloc_fake.return_val = nullptr;
-    void * allocated_ptr = pvPortCalloc( 0, 8 );
-    ASSERT_EQ( allocated_ptr, nullptr );
+    const size_t classSizes[] = heapmanagementSLAB_CLASS_SIZES;
+    const size_t largestClass = classSizes[ sizeof( classSizes ) / sizeof( classSizes[ 0 ] ) - 1U ];
+    const size_t objects = heapmanagementSLAB_SIZE / ( header + largestClass );
+    std::vector<uint8_t *> allocated_ptrs;
+
+    for( size_t i = 0U; i < objects; i++ )
+    {
+        allocated_ptrs.push_back( static_cast<uint8_t *>( allocate( largestClass ) ) );
+        ASSERT_NE( allocated_ptrs.back(), nullptr );
+    }
+
+    EXPECT_EQ( test_malloc_fake.call_count, 1 );
+
+    uintptr_t slabEnd = RegionAllocator::chunks.begin()->first + RegionAllocator::overhead + heapmanagementSLAB_SIZE;
+    size_t stride = allocated_ptrs[ 1 ] - allocated_ptrs[ 0 ];
+
+    /* The objects are grown into the space a smaller object would leave at
+     * the end of the slab, up to the alignment. */
+    EXPECT_GT( stride, header + largestClass );
+    EXPECT_EQ( stride % alignment, 0U );
+    EXPECT_LE( reinterpret_cast<uintptr_t>( allocated_ptrs.back() ) + stride - header, slabEnd );
+    EXPECT_GT( reinterpret_cast<uintptr_t>( allocated_ptrs.back() ) + stride - header + ( objects * alignment ), slabEnd );
 
-    EXPECT_EQ( test_calloc_fake.call_count, 1 );
-    EXPECT_EQ( test_calloc_fake.arg0_val, 0 );
-    EXPECT_EQ( test_calloc_fake.arg1_val, 8 );
+    /* Blocks a bit larger than the class fit in the grown objects. */
+    release( allocated_ptrs.back() );
+    EXPECT_EQ( allocate( stride - header ), allocated_ptrs.back() );
+    EXPECT_EQ( test_malloc_fake.call_count, 1 );
 }
 
-TEST_F( TestHeapManagement, calling_calloc_with_num_zero_may_return_pointer )
+TEST_F( TestHeapManagement, an_emptied_slab_is_released_once_the_slabs_hold_more_than_the_watermark )
 {
-    static uint8_t dummy[ 1 ];
+    const size_t slabs = ( heapmanagementSLAB_RELEASE_BYTES / heapmanagementSLAB_SIZE ) + 1U;
+    std::vector<void *> allocated_ptrs;
+    HeapManagementStats_t stats;
+    size_t objects;
+
+    /* Fill one slab above the watermark. */
+    while( static_cast<size_t>( test_malloc_fake.call_count ) <= slabs )
+    {
+        allocated_ptrs.push_back( allocate( 1024 ) );
+        ASSERT_NE( allocated_ptrs.back(), nullptr );
+    }
 
-    test_calloc_fake.return_val = dummy;
-    void * allocated_ptr = pvPortCalloc( 0, 8 );
-    ASSERT_EQ( allocated_ptr, static_cast<void *>( dummy ) );
+    release( allocated_ptrs.back() );
+    allocated_ptrs.pop_back();
+    objects = allocated_ptrs.size() / slabs;
 
-    EXPECT_EQ( test_calloc_fake.call_count, 1 );
-    EXPECT_EQ( test_calloc_fake.arg0_val, 0 );
-    EXPECT_EQ( test_calloc_fake.arg1_val, 8 );
+    vHeapManagementGetStats( &stats );
+    ASSERT_EQ( stats.xSlabBytes, slabs * heapmanagementSLAB_SIZE );
+
+    /* Empty the last slab. */
+    for( size_t i = 0U; i < objects; i++ )
+    {
+        release( allocated_ptrs.back() );
+        allocated_ptrs.pop_back();
+    }
+
+    EXPECT_EQ( test_free_fake.call_count, 2 );
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xSlabBytes, heapmanagementSLAB_RELEASE_BYTES );
+
+    /* At the watermark, an emptied slab is kept. */
+    for( size_t i = 0U; i < objects; i++ )
+    {
+        release( allocated_ptrs[ i ] );
+    }
+
+    EXPECT_EQ( test_free_fake.call_count, 2 );
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xSlabBytes, heapmanagementSLAB_RELEASE_BYTES );
+    EXPECT_EQ( xHeapManagementReleaseSlabs(), heapmanagementSLAB_SIZE );
 }
 
-TEST_F( TestHeapManagement, calling_calloc_with_size_zero_may_return_null )
+TEST_F( TestHeapManagement, small_blocks_are_allocated_on_their_own_when_no_slab_can_be_allocated )
 {
-    test_calloc_fake.return_val = nullptr;
-    void * allocated_ptr = pvPortCalloc( 8, 0 );
-    ASSERT_EQ( allocated_ptr, nullptr );
+    test_malloc_fake.custom_fake = []( size_t size ) {
+        return ( size == heapmanagementSLAB_SIZE ) ? nullptr : RegionAllocator::allocate( size );
+    };
+
+    void * allocated_ptr = allocate( 32 );
+
+    ASSERT_NE( allocated_ptr, nullptr );
+    EXPECT_EQ( test_malloc_fake.call_count, 2 );
+    EXPECT_EQ( test_malloc_fake.arg0_val, header + 32U );
+
+    release( allocated_ptr );
+    EXPECT_EQ( test_free_fake.call_count, 1 );
+    EXPECT_EQ( test_free_fake.arg0_val, static_cast<uint8_t *>( allocated_ptr ) - header );
+}
+
+TEST_F( TestHeapManagement, the_slabs_stop_growing_at_their_limit )
+{
+    HeapManagementStats_t stats;
+    size_t slabs = 0U;
+
+    /* Fill slabs until a block no longer fits in them. */
+    for( int i = 0; i < 1000; i++ )
+    {
+        size_t calls = test_malloc_fake.call_count;
+
+        ASSERT_NE( allocate( 1024 ), nullptr );
+
+        if( test_malloc_fake.call_count > calls )
+        {
+            if( test_malloc_fake.arg0_val != heapmanagementSLAB_SIZE )
+            {
+                break;
+            }
+
+            slabs++;
+        }
+    }
+
+    EXPECT_EQ( slabs, heapmanagementSLAB_MAX_BYTES / heapmanagementSLAB_SIZE );
+    EXPECT_EQ( test_malloc_fake.arg0_val, header + 1024U );
 
-    EXPECT_EQ( test_calloc_fake.call_count, 1 );
-    EXPECT_EQ( test_calloc_fake.arg0_val, 8 );
-    EXPECT_EQ( test_calloc_fake.arg1_val, 0 );
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xSlabBytes, heapmanagementSLAB_MAX_BYTES );
+    EXPECT_EQ( stats.xSlabFreeBytes, 0U );
+    EXPECT_EQ( stats.xSlabAllocations, initialStats.xSlabAllocations + blocks.size() - 1U );
+    EXPECT_EQ( xPortGetFreeHeapSize(), TEST_HEAP_REGION_SIZE - allocatedFootprint() );
 }
 
-TEST_F( TestHeapManagement, calling_calloc_with_size_zero_may_return_pointer )
+TEST_F( TestHeapManagement, the_whole_region_is_free_when_nothing_is_allocated )
 {
-    static uint8_t dummy[ 1 ];
+    HeapManagementStats_t stats;
+
+    vHeapManagementGetStats( &stats );
+
+    EXPECT_EQ( xPortGetFreeHeapSize(), TEST_HEAP_REGION_SIZE );
+    EXPECT_EQ( stats.xHeapSize, TEST_HEAP_REGION_SIZE );
+    EXPECT_EQ( stats.xFreeBytes, TEST_HEAP_REGION_SIZE );
+    EXPECT_EQ( stats.xLiveBytes, 0U );
+    EXPECT_EQ( stats.xLiveBlocks, 0U );
+    EXPECT_EQ( stats.xLargestFreeBlock, TEST_HEAP_REGION_SIZE );
+    EXPECT_EQ( stats.xFreeBlocks, 1U );
+    EXPECT_EQ( fragmentationMap( 8 ), "........" );
+}
 
-    test_calloc_fake.return_val = dummy;
-    void * allocated_ptr = pvPortCalloc( 8, 0 );
-    ASSERT_EQ( allocated_ptr, static_cast<void *>( dummy ) );
+TEST_F( TestHeapManagement, allocations_are_attributed_to_their_caller )
+{
+    void * first = pvPortMalloc( 100 );
+    void * second = pvPortMalloc( 200 );
+    void * third = pvPortMalloc( 300 );
+    HeapManagementStats_t stats;
+
+    ASSERT_NE( first, nullptr );
+    ASSERT_NE( second, nullptr );
+    ASSERT_NE( third, nullptr );
+    blocks[ first ] = 100U;
+    blocks[ third ] = 300U;
+    vPortFree( second );
+
+    vHeapManagementGetStats( &stats );
+    ASSERT_EQ( stats.xCallerCount, initialStats.xCallerCount + 3U );
+
+    const HeapCallerStats_t * callers = &stats.xCallers[ initialStats.xCallerCount ];
+    EXPECT_NE( callers[ 0 ].pvCaller, callers[ 1 ].pvCaller );
+    EXPECT_NE( callers[ 1 ].pvCaller, callers[ 2 ].pvCaller );
+    EXPECT_EQ( callers[ 0 ].xLiveBytes, 100U );
+    EXPECT_EQ( callers[ 0 ].xLiveBlocks, 1U );
+    EXPECT_EQ( callers[ 1 ].xLiveBytes, 0U );
+    EXPECT_EQ( callers[ 1 ].xLiveBlocks, 0U );
+    EXPECT_EQ( callers[ 1 ].xPeakBytes, 200U );
+    EXPECT_EQ( callers[ 2 ].xLiveBytes, 300U );
+}
+
+/* A different caller for each value of the template parameter. */
+template<size_t caller>
+__attribute__( ( noinline ) ) void allocateFrom( std::vector<void *> & allocated_ptrs )
+{
+    void * ptr = pvPortMalloc( caller + 1U );
 
-    EXPECT_EQ( test_calloc_fake.call_count, 1 );
-    EXPECT_EQ( test_calloc_fake.arg0_val, 8 );
-    EXPECT_EQ( test_calloc_fake.arg1_val, 0 );
+    allocated_ptrs.push_back( ptr );
 }
 
-TEST_F( TestHeapManagement, calling_calloc_zero_zero_may_return_null )
+template<size_t ... callers>
+std::vector<void *> allocateFromEach( std::index_sequence<callers...> )
 {
-    test_calloc_fake.return_val = nullptr;
-    void * allocated_ptr = pvPortCalloc( 0, 0 );
-    ASSERT_EQ( allocated_ptr, nullptr );
+    std::vector<void *> allocated_ptrs;
 
-    EXPECT_EQ( test_calloc_fake.call_count, 1 );
-    EXPECT_EQ( test_calloc_fake.arg0_val, 0 );
-    EXPECT_EQ( test_calloc_fake.arg1_val, 0 );
+    ( allocateFrom<callers>( allocated_ptrs ), ... );
+
+    return allocated_ptrs;
 }
 
-TEST_F( TestHeapManagement, calling_calloc_zero_zero_may_return_pointer )
+TEST_F( TestHeapManagement, callers_beyond_the_table_share_its_last_entry )
 {
-    static uint8_t dummy[ 1 ];
+    std::vector<void *> allocated_ptrs = allocateFromEach( std::make_index_sequence<heapmanagementMAX_CALLERS + 4U>() );
+    HeapManagementStats_t stats;
+    size_t liveBytes = 0U;
+
+    for( size_t i = 0U; i < allocated_ptrs.size(); i++ )
+    {
+        ASSERT_NE( allocated_ptrs[ i ], nullptr );
+        blocks[ allocated_ptrs[ i ] ] = i + 1U;
+    }
+
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xCallerCount, heapmanagementMAX_CALLERS );
+    EXPECT_EQ( stats.xCallers[ heapmanagementMAX_CALLERS - 1U ].pvCaller, nullptr );
 
-    test_calloc_fake.return_val = dummy;
-    void * allocated_ptr = pvPortCalloc( 0, 0 );
-    ASSERT_EQ( allocated_ptr, static_cast<void *>( dummy ) );
+    for( size_t i = 0U; i < stats.xCallerCount; i++ )
+    {
+        liveBytes += stats.xCallers[ i ].xLiveBytes;
+    }
 
-    EXPECT_EQ( test_calloc_fake.call_count, 1 );
-    EXPECT_EQ( test_calloc_fake.arg0_val, 0 );
-    EXPECT_EQ( test_calloc_fake.arg1_val, 0 );
+    EXPECT_EQ( liveBytes, stats.xLiveBytes );
 }
 
-TEST_F( TestHeapManagement, returns_null_when_calloc_fails )
+TEST_F( TestHeapManagement, the_fragmentation_map_shows_the_allocated_slices )
 {
-    test_calloc_fake.return_val = nullptr;
-    void * allocated_ptr = pvPortCalloc( 16, 8 );
-    ASSERT_EQ( allocated_ptr, nullptr );
+    const size_t slice = TEST_HEAP_REGION_SIZE / 16U;
+
+    /* The first block fills two slices, chunk overhead included. */
+    void * large = allocate( 2U * slice - RegionAllocator::overhead - header );
+    void * small = allocate( largeSize );
+    HeapManagementStats_t stats;
 
-    EXPECT_EQ( test_calloc_fake.call_count, 1 );
-    EXPECT_EQ( test_calloc_fake.arg0_val, 16 );
-    EXPECT_EQ( test_calloc_fake.arg1_val, 8 );
+    ASSERT_EQ( reinterpret_cast<uintptr_t>( large ), regionStart + RegionAllocator::overhead + header );
+    ASSERT_NE( small, nullptr );
+    EXPECT_EQ( fragmentationMap( 16 ), "##+............." );
+
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xFreeBlocks, 1U );
+    EXPECT_EQ( stats.xLargestFreeBlock, regionEnd - ( reinterpret_cast<uintptr_t>( small ) + largeSize ) );
+
+    release( large );
+    EXPECT_EQ( fragmentationMap( 16 ), "..+............." );
+    EXPECT_EQ( fragmentationMap( 4 ), "+..." );
+
+    vHeapManagementGetStats( &stats );
+    EXPECT_EQ( stats.xFreeBlocks, 2U );
 }
 
-TEST_F( TestHeapManagement, xPortGetFreeHeapSize_returns_zero )
+TEST_F( TestHeapManagement, accounting_holds_under_random_allocations_and_frees )
 {
-    ASSERT_EQ( xPortGetFreeHeapSize(), 0 );
+    std::mt19937 generator( 20261018U );
+    std::uniform_int_distribution<int> operation( 0, 99 );
+    std::uniform_int_distribution<int> sizeExponent( 0, 11 );
+    std::vector<size_t> liveBlocksPerClass( heapmanagementSIZE_CLASS_COUNT, 0U );
+    std::vector<size_t> allocationsPerClass( heapmanagementSIZE_CLASS_COUNT, 0U );
+    size_t liveBytes = 0U;
+    size_t peakLiveBytes = initialStats.xPeakLiveBytes;
+    size_t minimumFree = xPortGetMinimumEverFreeHeapSize();
+    size_t allocations = 0U;
+    size_t frees = 0U;
+    size_t failures = 0U;
+
+    auto sizeClass = []( size_t size ) {
+        size_t index = 0U;
+
+        while( ( size > ( 16U << index ) ) && ( index < heapmanagementSIZE_CLASS_COUNT - 1U ) )
+        {
+            index++;
+        }
+
+        return index;
+    };
+
+    for( int step = 0; step < 20000; step++ )
+    {
+        /* Allocate more than free on average, so that the heap fills up. */
+        if( blocks.empty() || ( operation( generator ) < 55 ) )
+        {
+            size_t size = std::uniform_int_distribution<size_t>( 0U, 16U << sizeExponent( generator ) )( generator );
+            void * ptr;
+
+            if( operation( generator ) < 20 )
+            {
+                ptr = pvPortCalloc( 1U, size );
+
+                if( ptr != nullptr )
+                {
+                    blocks[ ptr ] = size;
+                }
+            }
+            else
+            {
+                ptr = allocate( size );
+            }
+
+            if( ptr == nullptr )
+            {
+                failures++;
+                continue;
+            }
+
+            allocations++;
+            liveBytes += size;
+            peakLiveBytes = std::max( peakLiveBytes, liveBytes );
+            liveBlocksPerClass[ sizeClass( size ) ]++;
+            allocationsPerClass[ sizeClass( size ) ]++;
+        }
+        else
+        {
+            std::map<void *, size_t>::iterator block = blocks.begin();
+
+            std::advance( block, std::uniform_int_distribution<size_t>( 0U, blocks.size() - 1U )( generator ) );
+            liveBytes -= block->second;
+            liveBlocksPerClass[ sizeClass( block->second ) ]--;
+            frees++;
+            release( block->first );
+        }
+
+        ASSERT_EQ( xPortGetFreeHeapSize(), TEST_HEAP_REGION_SIZE - allocatedFootprint() );
+        ASSERT_EQ( vAssertCalled_fake.call_count, 0U );
+        minimumFree = std::min( minimumFree, xPortGetFreeHeapSize() );
+        ASSERT_EQ( xPortGetMinimumEverFreeHeapSize(), minimumFree );
+
+        if( ( step % 97 ) == 0 )
+        {
+            HeapManagementStats_t stats;
+            size_t callerLiveBytes = 0U;
+            size_t callerLiveBlocks = 0U;
+
+            vHeapManagementGetStats( &stats );
+
+            ASSERT_EQ( stats.xLiveBytes, liveBytes );
+            ASSERT_EQ( stats.xLiveBlocks, blocks.size() );
+            ASSERT_EQ( stats.xPeakLiveBytes, peakLiveBytes );
+            ASSERT_EQ( stats.xFreeBytes, xPortGetFreeHeapSize() );
+            ASSERT_EQ( stats.xMinimumEverFreeBytes, minimumFree );
+            ASSERT_EQ( stats.xSuccessfulAllocations, initialStats.xSuccessfulAllocations + allocations );
+            ASSERT_EQ( stats.xSuccessfulFrees, initialStats.xSuccessfulFrees + frees );
+            ASSERT_EQ( stats.xFailedAllocations, initialStats.xFailedAllocations + failures );
+
+            for( size_t i = 0U; i < heapmanagementSIZE_CLASS_COUNT; i++ )
+            {
+                ASSERT_EQ( stats.xLiveBlocksPerSizeClass[ i ], liveBlocksPerClass[ i ] );
+                ASSERT_EQ( stats.xAllocationsPerSizeClass[ i ], initialStats.xAllocationsPerSizeClass[ i ] + allocationsPerClass[ i ] );
+            }
+
+            for( size_t i = 0U; i < stats.xCallerCount; i++ )
+            {
+                callerLiveBytes += stats.xCallers[ i ].xLiveBytes;
+                callerLiveBlocks += stats.xCallers[ i ].xLiveBlocks;
+            }
+
+            ASSERT_EQ( callerLiveBytes, liveBytes );
+            ASSERT_EQ( callerLiveBlocks, blocks.size() );
+
+            expectFreeBlocks( stats );
+        }
+    }
+
+    /* The workload must have run the heap out of memory. */
+    EXPECT_GT( failures, 0U );
+    EXPECT_GT( frees, 1000U );
 }
 
-TEST_F( TestHeapManagement, xPortGetMinimumEverFreeHeapSize_returns_zero )
+/* Same sequence of allocations and frees for both allocators: buffers and
+ * blocks of a few common sizes that come and go, and some of the small blocks
+ * that are kept. Returns the average number of free fragments. */
+template<typename Allocate, typename Release>
+static size_t fragmentingWorkload( Allocate allocateBlock,
+                                   Release releaseBlock,
+                                   std::vector<void *> & kept )
 {
-    ASSERT_EQ( xPortGetMinimumEverFreeHeapSize(), 0 );
+    const size_t smallSizes[] = { 24U, 60U, 120U, 250U };
+    const size_t liveBlocks = 100U;
+    std::mt19937 generator( 20261018U );
+    std::uniform_int_distribution<int> percent( 0, 99 );
+    std::uniform_int_distribution<size_t> smallSize( 0U, 3U );
+    std::uniform_int_distribution<size_t> bufferSize( 1024U, 4096U );
+    std::vector<void *> transient;
+    size_t fragments = 0U;
+    size_t samples = 0U;
+
+    for( int step = 0; step < 20000; step++ )
+    {
+        bool buffer = percent( generator ) < 10;
+        void * ptr = allocateBlock( buffer ? bufferSize( generator ) : smallSizes[ smallSize( generator ) ] );
+
+        EXPECT_NE( ptr, nullptr );
+
+        if( !buffer && ( percent( generator ) < 2 ) )
+        {
+            kept.push_back( ptr );
+        }
+        else
+        {
+            transient.push_back( ptr );
+        }
+
+        if( transient.size() > liveBlocks )
+        {
+            size_t index = std::uniform_int_distribution<size_t>( 0U, transient.size() - 1U )( generator );
+
+            releaseBlock( transient[ index ] );
+            transient[ index ] = transient.back();
+            transient.pop_back();
+        }
+
+        if( ( step % 100 ) == 0 )
+        {
+            fragments += freeFragments();
+            samples++;
+        }
+    }
+
+    for( void * ptr : transient )
+    {
+        releaseBlock( ptr );
+    }
+
+    return fragments / samples;
+}
+
+TEST_F( TestHeapManagement, slabs_leave_fewer_free_fragments_than_malloc )
+{
+    std::vector<void *> kept;
+    size_t mallocFragments;
+    size_t slabFragments;
+    size_t mallocLargestFree;
+    size_t slabLargestFree;
+
+    mallocFragments = fragmentingWorkload( RegionAllocator::allocate, RegionAllocator::release, kept );
+    mallocLargestFree = largestGap();
+
+    for( void * ptr : kept )
+    {
+        RegionAllocator::release( ptr );
+    }
+
+    kept.clear();
+    slabFragments = fragmentingWorkload( pvPortMalloc, vPortFree, kept );
+    ( void ) xHeapManagementReleaseSlabs();
+    slabLargestFree = largestGap();
+
+    for( void * ptr : kept )
+    {
+        blocks[ ptr ] = 0U;
+    }
+
+    RecordProperty( "mallocFreeFragments", std::to_string( mallocFragments ) );
+    RecordProperty( "slabFreeFragments", std::to_string( slabFragments ) );
+    printf( "Free fragments: %zu with malloc(), %zu with slabs. "
+            "Largest free block with %zu blocks kept: %zu bytes with malloc(), %zu bytes with slabs\n",
+            mallocFragments, slabFragments, kept.size(), mallocLargestFree, slabLargestFree );
+
+    /* The slabs hold on to their free objects, so the largest free block is
+     * smaller, but the small blocks no longer leave holes between the
+     * buffers. */
+    EXPECT_LT( 3U * slabFragments, mallocFragments );
+}
+TEST_F( TestHeapManagement, benchmark_slab_allocations_against_the_c_library )
+{
+    const int rounds = 20000;
+    const size_t working = 32U;
+    std::vector<void *> allocated_ptrs( working );
+
+    auto measure = [ & ]( void * ( *allocateBlock )( size_t ), void ( * releaseBlock )( void * ) ) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for( int round = 0; round < rounds; round++ )
+        {
+            for( size_t i = 0U; i < working; i++ )
+            {
+                allocated_ptrs[ i ] = allocateBlock( 16U + ( ( i * 8U ) % 240U ) );
+            }
+
+            for( size_t i = 0U; i < working; i++ )
+            {
+                releaseBlock( allocated_ptrs[ ( i * 7U ) % working ] );
+            }
+        }
+
+        return std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count() / ( rounds * working );
+    };
+
+    /* The slabs are taken from the C library too. */
+    test_malloc_fake.custom_fake = __real_malloc;
+    test_free_fake.custom_fake = __real_free;
+
+    double libraryNs = measure( __real_malloc, __real_free );
+    double slabNs = measure( pvPortMalloc, vPortFree );
+
+    ( void ) xHeapManagementReleaseSlabs();
+
+    /* Only the first round allocates slabs. */
+    EXPECT_LE( test_malloc_fake.call_count, working );
+
+    RecordProperty( "mallocNs", std::to_string( libraryNs ) );
+    RecordProperty( "slabNs", std::to_string( slabNs ) );
+    printf( "malloc()/free(): %.1f ns, pvPortMalloc()/vPortFree(): %.1f ns per pair\n", libraryNs, slabNs );
 }
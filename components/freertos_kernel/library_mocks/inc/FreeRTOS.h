@@ -35,6 +35,7 @@
 #include "portmacro.h"
 
 typedef int StaticQueue_t;
+typedef int StaticSemaphore_t;
 
 /*
  * Definitions found in FreeTOSConfig.h.
@@ -33,6 +33,9 @@
 
 
 #include "fff.h"
+#include "portmacro.h"
+
+typedef int EventBits_t;
 
 DECLARE_FAKE_VALUE_FUNC( int,
                          xEventGroupClearBits,
@@ -44,4 +47,16 @@ DECLARE_FAKE_VALUE_FUNC( int,
                          void *,
                          const int );
 
+DECLARE_FAKE_VALUE_FUNC( int,
+                         xEventGroupGetBits,
+                         void * );
+
+DECLARE_FAKE_VALUE_FUNC( int,
+                         xEventGroupWaitBits,
+                         void *,
+                         const int,
+                         BaseType_t,
+                         BaseType_t,
+                         TickType_t );
+
 #endif /* EVENT_GROUPS_H */
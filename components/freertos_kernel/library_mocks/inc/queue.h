@@ -46,5 +46,6 @@ typedef struct QueueDefinition * QueueHandle_t;
 DECLARE_FAKE_VALUE_FUNC( BaseType_t, xQueueSendToBack, QueueHandle_t, const void *, TickType_t );
 DECLARE_FAKE_VALUE_FUNC( BaseType_t, xQueueReceive, QueueHandle_t, void *, TickType_t );
 DECLARE_FAKE_VALUE_FUNC( QueueHandle_t, xQueueCreateStatic, const UBaseType_t, const UBaseType_t, uint8_t *, StaticQueue_t * );
+DECLARE_FAKE_VALUE_FUNC( UBaseType_t, uxQueueMessagesWaiting, QueueHandle_t );
 
 #endif /* QUEUE_H */
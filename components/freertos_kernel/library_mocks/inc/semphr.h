@@ -33,6 +33,7 @@
 
 #include "fff.h"
 #include "portmacro.h"
+#include "FreeRTOS.h"
 
 typedef int SemaphoreHandle_t;
 
@@ -45,6 +46,11 @@ DECLARE_FAKE_VALUE_FUNC( BaseType_t,
                          SemaphoreHandle_t );
 DECLARE_FAKE_VALUE_FUNC( SemaphoreHandle_t,
                          xSemaphoreCreateMutex );
+DECLARE_FAKE_VALUE_FUNC( SemaphoreHandle_t,
+                         xSemaphoreCreateCountingStatic,
+                         UBaseType_t,
+                         UBaseType_t,
+                         StaticSemaphore_t * );
 DECLARE_FAKE_VOID_FUNC( vSemaphoreDelete,
                         SemaphoreHandle_t );
 
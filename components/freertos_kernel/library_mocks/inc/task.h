@@ -36,7 +36,10 @@
 #include "projdefs.h"
 #include <stdint.h>
 
-#define tskIDLE_PRIORITY    ( ( UBaseType_t ) 0U )
+#define tskIDLE_PRIORITY       ( ( UBaseType_t ) 0U )
+
+#define taskENTER_CRITICAL()    vTaskEnterCritical()
+#define taskEXIT_CRITICAL()     vTaskExitCritical()
 
 typedef int * TaskHandle_t;
 
@@ -70,6 +73,10 @@ DECLARE_FAKE_VALUE_FUNC( BaseType_t,
 
 DECLARE_FAKE_VOID_FUNC( vTaskDelete, TaskHandle_t );
 DECLARE_FAKE_VOID_FUNC( vTaskDelay, const TickType_t );
+DECLARE_FAKE_VOID_FUNC( vTaskEnterCritical );
+DECLARE_FAKE_VOID_FUNC( vTaskExitCritical );
+DECLARE_FAKE_VOID_FUNC( vTaskSuspendAll );
+DECLARE_FAKE_VALUE_FUNC( BaseType_t, xTaskResumeAll );
 
 DECLARE_FAKE_VALUE_FUNC( BaseType_t,
                          xTaskNotifyStateClear,
@@ -40,3 +40,15 @@ DEFINE_FAKE_VALUE_FUNC( int,
                         xEventGroupSetBits,
                         void *,
                         const int );
+
+DEFINE_FAKE_VALUE_FUNC( int,
+                        xEventGroupGetBits,
+                        void * );
+
+DEFINE_FAKE_VALUE_FUNC( int,
+                        xEventGroupWaitBits,
+                        void *,
+                        const int,
+                        BaseType_t,
+                        BaseType_t,
+                        TickType_t );
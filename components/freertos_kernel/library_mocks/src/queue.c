@@ -34,3 +34,4 @@
 DEFINE_FAKE_VALUE_FUNC( BaseType_t, xQueueSendToBack, QueueHandle_t, const void *, TickType_t );
 DEFINE_FAKE_VALUE_FUNC( BaseType_t, xQueueReceive, QueueHandle_t, void *, TickType_t );
 DEFINE_FAKE_VALUE_FUNC( QueueHandle_t, xQueueCreateStatic, const UBaseType_t, const UBaseType_t, uint8_t *, StaticQueue_t * );
+DEFINE_FAKE_VALUE_FUNC( UBaseType_t, uxQueueMessagesWaiting, QueueHandle_t );
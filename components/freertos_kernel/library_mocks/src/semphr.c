@@ -42,5 +42,10 @@ DEFINE_FAKE_VALUE_FUNC( BaseType_t,
                         SemaphoreHandle_t );
 DEFINE_FAKE_VALUE_FUNC( SemaphoreHandle_t,
                         xSemaphoreCreateMutex );
+DEFINE_FAKE_VALUE_FUNC( SemaphoreHandle_t,
+                        xSemaphoreCreateCountingStatic,
+                        UBaseType_t,
+                        UBaseType_t,
+                        StaticSemaphore_t * );
 DEFINE_FAKE_VOID_FUNC( vSemaphoreDelete,
                        SemaphoreHandle_t );
@@ -55,6 +55,10 @@ DEFINE_FAKE_VALUE_FUNC( BaseType_t,
 
 DEFINE_FAKE_VOID_FUNC( vTaskDelete, TaskHandle_t );
 DEFINE_FAKE_VOID_FUNC( vTaskDelay, const TickType_t );
+DEFINE_FAKE_VOID_FUNC( vTaskEnterCritical );
+DEFINE_FAKE_VOID_FUNC( vTaskExitCritical );
+DEFINE_FAKE_VOID_FUNC( vTaskSuspendAll );
+DEFINE_FAKE_VALUE_FUNC( BaseType_t, xTaskResumeAll );
 
 DEFINE_FAKE_VALUE_FUNC( BaseType_t,
                         xTaskNotifyStateClear,
@@ -132,6 +132,17 @@ typedef struct TLSHelperParams
 BaseType_t TLS_Init( TLSHelperParams_t * pxParams,
                      TLSContext_t * pxContext );
 
+/**
+ * @brief Look up the PKCS #11 client credential objects ahead of TLS_Init,
+ * so that the connections using the same labels do not have to.
+ *
+ * @param[in] pxParams TLS parameters, only the PKCS #11 labels and the login
+ * PIN are used.
+ *
+ * @return pdTRUE if both the private key and the certificate were found.
+ */
+BaseType_t TLS_LoadClientCredentials( const TLSHelperParams_t * pxParams );
+
 /**
  * @brief Perform TLS handshake with the given TLS context.
  *
@@ -0,0 +1,133 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file mbedtls_arena.h
+ * @brief First-fit allocator over a region reserved for mbedTLS.
+ *
+ * The free blocks are kept in address order and merged with their neighbours
+ * when a block is freed, so the transient allocations of a TLS handshake
+ * (X.509 parsing, bignums, ECDH) coalesce back into the region once mbedTLS
+ * frees its handshake state, without touching the application heap.
+ *
+ * The arena is not thread-safe, the callers serialise the accesses.
+ */
+
+#ifndef MBEDTLS_ARENA_H
+#define MBEDTLS_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Header of a block of the arena, allocated or free.
+ */
+typedef struct MbedtlsArenaBlock
+{
+    struct MbedtlsArenaBlock * pxNextFree; /*!< Next free block in address order, only for the free blocks. */
+    size_t xSize;                          /*!< Size of the block, header included. */
+} MbedtlsArenaBlock_t;
+
+/**
+ * @brief Usage of the arena.
+ */
+typedef struct MbedtlsArenaStats
+{
+    size_t xSize;                   /*!< Bytes of the region, headers included. */
+    size_t xAllocatedBytes;         /*!< Bytes of the allocated blocks, headers included. */
+    size_t xPeakAllocatedBytes;     /*!< Largest xAllocatedBytes at any time. */
+    size_t xLargestFreeBlock;       /*!< Largest free block, header included. */
+    size_t xFreeBlocks;             /*!< Number of free blocks. */
+    size_t xFailedAllocations;      /*!< Allocations the arena could not serve. */
+    size_t xHandshakes;             /*!< Handshakes that ended. */
+    size_t xHandshakePeakBytes;     /*!< Most bytes allocated during the last handshake, above the usage at its start. */
+    size_t xHandshakeRetainedBytes; /*!< Bytes the last handshake left allocated, e.g. the session and the record buffers. */
+    size_t xMaxHandshakePeakBytes;  /*!< Largest xHandshakePeakBytes of all the handshakes. */
+} MbedtlsArenaStats_t;
+
+/**
+ * @brief An arena. The fields are private to mbedtls_arena.c.
+ */
+typedef struct MbedtlsArena
+{
+    uint8_t * pucStart;                /*!< Start of the region, aligned. */
+    size_t xSize;                      /*!< Size of the region, a multiple of the alignment. */
+    MbedtlsArenaBlock_t * pxFreeList;  /*!< First free block. */
+    size_t xHandshakesInProgress;      /*!< Handshakes started and not ended. */
+    size_t xHandshakeStartBytes;       /*!< Bytes allocated when the first of them started. */
+    size_t xHandshakePeakAllocated;    /*!< Most bytes allocated since then. */
+    MbedtlsArenaStats_t xStats;        /*!< The usage, without the free blocks. */
+} MbedtlsArena_t;
+
+/**
+ * @brief Make a whole region a single free block.
+ *
+ * @param[out] pxArena The arena.
+ * @param[in] pvRegion The region, which must outlive the arena.
+ * @param[in] xRegionSize Size of the region.
+ */
+void mbedtlsArena_Init( MbedtlsArena_t * pxArena,
+                        void * pvRegion,
+                        size_t xRegionSize );
+
+/**
+ * @brief Allocate a block from the arena. The memory is not zeroed.
+ *
+ * @param[in, out] pxArena The arena.
+ * @param[in] xSize Size of the block.
+ *
+ * @return The block, aligned to two pointers, or NULL if it does not fit.
+ */
+void * mbedtlsArena_Allocate( MbedtlsArena_t * pxArena,
+                              size_t xSize );
+
+/**
+ * @brief Free a block allocated from the arena.
+ *
+ * @param[in, out] pxArena The arena.
+ * @param[in] pv The block, or NULL.
+ */
+void mbedtlsArena_Free( MbedtlsArena_t * pxArena,
+                        void * pv );
+
+/**
+ * @brief Check whether a block is in the region of the arena.
+ *
+ * @param[in] pxArena The arena.
+ * @param[in] pv The block.
+ *
+ * @return true if the block was allocated from the arena.
+ */
+bool mbedtlsArena_Contains( const MbedtlsArena_t * pxArena,
+                            const void * pv );
+
+/**
+ * @brief Mark the start of a handshake. Overlapping handshakes are measured
+ * together, from the start of the first to the end of the last.
+ *
+ * @param[in, out] pxArena The arena.
+ */
+void mbedtlsArena_HandshakeStarted( MbedtlsArena_t * pxArena );
+
+/**
+ * @brief Mark the end of a handshake, successful or not, and record its peak
+ * usage.
+ *
+ * @param[in, out] pxArena The arena.
+ */
+void mbedtlsArena_HandshakeEnded( MbedtlsArena_t * pxArena );
+
+/**
+ * @brief Get the usage of the arena. The free blocks are walked, so this is
+ * meant for diagnostics.
+ *
+ * @param[in] pxArena The arena.
+ * @param[out] pxStats The usage.
+ */
+void mbedtlsArena_GetStats( const MbedtlsArena_t * pxArena,
+                            MbedtlsArenaStats_t * pxStats );
+
+#endif /* MBEDTLS_ARENA_H */
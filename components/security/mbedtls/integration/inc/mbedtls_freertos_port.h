@@ -0,0 +1,44 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file mbedtls_freertos_port.h
+ * @brief Memory telemetry of the mbed TLS platform functions for FreeRTOS.
+ *
+ * When MBEDTLS_FREERTOS_ARENA_SIZE is set to a non-zero size in the mbed TLS
+ * configuration file, mbedtls_platform_calloc() allocates from an arena of
+ * that size reserved for mbed TLS, and only falls back to the FreeRTOS heap
+ * when the arena is full. The size is 0 in every application, the arena is
+ * only covered by the host tests so far.
+ */
+
+#ifndef MBEDTLS_FREERTOS_PORT_H
+#define MBEDTLS_FREERTOS_PORT_H
+
+#include "FreeRTOS.h"
+
+#include "mbedtls_arena.h"
+
+/**
+ * @brief Mark the start of a TLS handshake, to measure its peak usage.
+ */
+void mbedtls_platform_handshake_started( void );
+
+/**
+ * @brief Mark the end of a TLS handshake, successful or not.
+ */
+void mbedtls_platform_handshake_ended( void );
+
+/**
+ * @brief Get the usage of the arena reserved for mbed TLS. The failed
+ * allocations are those taken from the FreeRTOS heap instead.
+ *
+ * @param[out] pxStats The usage.
+ *
+ * @return pdFALSE if mbed TLS allocates from the FreeRTOS heap.
+ */
+BaseType_t mbedtls_platform_get_arena_stats( MbedtlsArenaStats_t * pxStats );
+
+#endif /* MBEDTLS_FREERTOS_PORT_H */
@@ -45,9 +45,11 @@
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
+#include "task.h"
 #include "mbedtls/debug.h"
 #include "mbedtls/base64.h"
 #include "iot_default_root_certificates.h"
+#include "mbedtls_freertos_port.h"
 
 int8_t PKI_pkcs11SignatureTombedTLSSignature( uint8_t * pucSig,
                                               size_t * pxSigLen );
@@ -83,6 +85,28 @@ static const char * pNoLowLevelMbedTlsCodeStr = "<No-Low-Level-Code>";
  */
 #define mbedtlsLowLevelCodeOrDefault( mbedTlsCode )    pNoLowLevelMbedTlsCodeStr
 
+/**
+ * @brief PKCS #11 objects found for the client credential labels of the last
+ * connection.
+ *
+ * Object handles stay valid until the objects are destroyed, so later
+ * connections with the same labels skip the C_FindObjects label searches.
+ * A cached handle that can no longer be used is searched for again.
+ */
+typedef struct TLSCredentialCache
+{
+    char cPrivateKeyLabel[ pkcs11configMAX_LABEL_LENGTH + 1 ];
+    char cClientCertLabel[ pkcs11configMAX_LABEL_LENGTH + 1 ];
+    CK_OBJECT_HANDLE xPrivateKey;
+    CK_OBJECT_HANDLE xClientCertificate;
+} TLSCredentialCache_t;
+
+/**
+ * @brief Credential objects shared by all the TLS contexts, accessed in
+ * critical sections as several tasks may connect at the same time.
+ */
+static TLSCredentialCache_t xCredentialCache = { { 0 }, { 0 }, CK_INVALID_HANDLE, CK_INVALID_HANDLE };
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -311,6 +335,8 @@ static int prvPrivateKeySigningCallback( mbedtls_pk_context * pvContext,
  * @param[in] pxTlsContext Caller TLS context.
  * @param[in] pcLabelName PKCS #11 certificate object label.
  * @param[in] xClass PKCS #11 certificate object class.
+ * @param[in, out] pxCertObj Handle of the certificate object, searched for
+ * by label if CK_INVALID_HANDLE.
  * @param[out] pxCertificateContext Certificate context.
  *
  * @return Zero on success.
@@ -318,23 +344,29 @@ static int prvPrivateKeySigningCallback( mbedtls_pk_context * pvContext,
 static CK_RV prvReadCertificateIntoContext( TLSContext_t * pxTlsContext,
                                             char * pcLabelName,
                                             CK_OBJECT_CLASS xClass,
+                                            CK_OBJECT_HANDLE * pxCertObj,
                                             mbedtls_x509_crt * pxCertificateContext )
 {
     CK_RV xResult = CKR_OK;
     int mbedTLSResult = 0;
     CK_ATTRIBUTE xTemplate = { 0 };
-    CK_OBJECT_HANDLE xCertObj = 0;
+    CK_OBJECT_HANDLE xCertObj = *pxCertObj;
 
     /* Get the handle of the certificate. */
-    xResult = xFindObjectWithLabelAndClass( pxTlsContext->xP11Session,
-                                            pcLabelName,
-                                            strlen( pcLabelName ),
-                                            xClass,
-                                            &xCertObj );
-
-    if( ( CKR_OK == xResult ) && ( xCertObj == CK_INVALID_HANDLE ) )
+    if( xCertObj == CK_INVALID_HANDLE )
     {
-        xResult = CKR_OBJECT_HANDLE_INVALID;
+        xResult = xFindObjectWithLabelAndClass( pxTlsContext->xP11Session,
+                                                pcLabelName,
+                                                strlen( pcLabelName ),
+                                                xClass,
+                                                &xCertObj );
+
+        if( ( CKR_OK == xResult ) && ( xCertObj == CK_INVALID_HANDLE ) )
+        {
+            xResult = CKR_OBJECT_HANDLE_INVALID;
+        }
+
+        *pxCertObj = xCertObj;
     }
 
     /* Query the certificate size. */
@@ -410,6 +442,8 @@ static CK_RV prvInitializeClientCredential( TLSContext_t * pxContext,
     CK_RV xResult = CKR_OK;
     CK_ATTRIBUTE xTemplate[ 2 ];
     mbedtls_pk_type_t xKeyAlgo = ( mbedtls_pk_type_t ) ~0;
+    TLSCredentialCache_t xCredentials = { 0 };
+    BaseType_t xCachedCredentials = pdFALSE;
 
     /* Initialize the mbed contexts. */
     mbedtls_x509_crt_init( &pxContext->xMbedX509Cli );
@@ -429,7 +463,47 @@ static CK_RV prvInitializeClientCredential( TLSContext_t * pxContext,
                                                                         strlen( pxParams->pcLoginPIN ) );
     }
 
+    /* Reuse the objects found for the same labels by an earlier connection. */
     if( CKR_OK == xResult )
+    {
+        taskENTER_CRITICAL();
+        xCredentials = xCredentialCache;
+        taskEXIT_CRITICAL();
+
+        xCachedCredentials = ( ( xCredentials.xPrivateKey != CK_INVALID_HANDLE ) &&
+                               ( strcmp( xCredentials.cPrivateKeyLabel, pxParams->pPrivateKeyLabel ) == 0 ) &&
+                               ( strcmp( xCredentials.cClientCertLabel, pxParams->pClientCertLabel ) == 0 ) ) ? pdTRUE : pdFALSE;
+
+        if( xCachedCredentials == pdTRUE )
+        {
+            pxContext->xP11PrivateKey = xCredentials.xPrivateKey;
+        }
+        else
+        {
+            xCredentials.xClientCertificate = CK_INVALID_HANDLE;
+        }
+    }
+
+    /* Query the device private key type, which also checks that a cached
+     * handle still refers to a private key. */
+    if( ( CKR_OK == xResult ) && ( xCachedCredentials == pdTRUE ) )
+    {
+        xTemplate[ 0 ].type = CKA_KEY_TYPE;
+        xTemplate[ 0 ].pValue = &pxContext->xKeyType;
+        xTemplate[ 0 ].ulValueLen = sizeof( CK_KEY_TYPE );
+
+        if( pxContext->pxP11FunctionList->C_GetAttributeValue( pxContext->xP11Session,
+                                                               pxContext->xP11PrivateKey,
+                                                               xTemplate,
+                                                               1 ) != CKR_OK )
+        {
+            /* The objects were created again since, search for them. */
+            xCachedCredentials = pdFALSE;
+            xCredentials.xClientCertificate = CK_INVALID_HANDLE;
+        }
+    }
+
+    if( ( CKR_OK == xResult ) && ( xCachedCredentials == pdFALSE ) )
     {
         /* Get the handle of the device private key. */
         xResult = xFindObjectWithLabelAndClass( pxContext->xP11Session,
@@ -437,24 +511,24 @@ static CK_RV prvInitializeClientCredential( TLSContext_t * pxContext,
                                                 strlen( pxParams->pPrivateKeyLabel ),
                                                 CKO_PRIVATE_KEY,
                                                 &pxContext->xP11PrivateKey );
-    }
 
-    if( ( CKR_OK == xResult ) && ( pxContext->xP11PrivateKey == CK_INVALID_HANDLE ) )
-    {
-        xResult = CKR_FUNCTION_FAILED;
-        LogError( ( "Private key not found at label %.*s", strlen( pxParams->pPrivateKeyLabel ), ( char * ) pxParams->pPrivateKeyLabel ) );
-    }
+        if( ( CKR_OK == xResult ) && ( pxContext->xP11PrivateKey == CK_INVALID_HANDLE ) )
+        {
+            xResult = CKR_FUNCTION_FAILED;
+            LogError( ( "Private key not found at label %.*s", strlen( pxParams->pPrivateKeyLabel ), ( char * ) pxParams->pPrivateKeyLabel ) );
+        }
 
-    /* Query the device private key type. */
-    if( xResult == CKR_OK )
-    {
-        xTemplate[ 0 ].type = CKA_KEY_TYPE;
-        xTemplate[ 0 ].pValue = &pxContext->xKeyType;
-        xTemplate[ 0 ].ulValueLen = sizeof( CK_KEY_TYPE );
-        xResult = pxContext->pxP11FunctionList->C_GetAttributeValue( pxContext->xP11Session,
-                                                                     pxContext->xP11PrivateKey,
-                                                                     xTemplate,
-                                                                     1 );
+        /* Query the device private key type. */
+        if( xResult == CKR_OK )
+        {
+            xTemplate[ 0 ].type = CKA_KEY_TYPE;
+            xTemplate[ 0 ].pValue = &pxContext->xKeyType;
+            xTemplate[ 0 ].ulValueLen = sizeof( CK_KEY_TYPE );
+            xResult = pxContext->pxP11FunctionList->C_GetAttributeValue( pxContext->xP11Session,
+                                                                         pxContext->xP11PrivateKey,
+                                                                         xTemplate,
+                                                                         1 );
+        }
     }
 
     /* Map the PKCS #11 key type to an mbedTLS algorithm. */
@@ -492,7 +566,33 @@ static CK_RV prvInitializeClientCredential( TLSContext_t * pxContext,
         xResult = prvReadCertificateIntoContext( pxContext,
                                                  ( char * ) pxParams->pClientCertLabel,
                                                  CKO_CERTIFICATE,
+                                                 &xCredentials.xClientCertificate,
                                                  &pxContext->xMbedX509Cli );
+
+        /* Search for the certificate if the cached handle no longer refers to it. */
+        if( ( xResult != CKR_OK ) && ( xCachedCredentials == pdTRUE ) )
+        {
+            xCredentials.xClientCertificate = CK_INVALID_HANDLE;
+            xResult = prvReadCertificateIntoContext( pxContext,
+                                                     ( char * ) pxParams->pClientCertLabel,
+                                                     CKO_CERTIFICATE,
+                                                     &xCredentials.xClientCertificate,
+                                                     &pxContext->xMbedX509Cli );
+        }
+    }
+
+    /* Remember the objects for the next connection. */
+    if( ( CKR_OK == xResult ) &&
+        ( strlen( pxParams->pPrivateKeyLabel ) <= pkcs11configMAX_LABEL_LENGTH ) &&
+        ( strlen( pxParams->pClientCertLabel ) <= pkcs11configMAX_LABEL_LENGTH ) )
+    {
+        ( void ) strcpy( xCredentials.cPrivateKeyLabel, pxParams->pPrivateKeyLabel );
+        ( void ) strcpy( xCredentials.cClientCertLabel, pxParams->pClientCertLabel );
+        xCredentials.xPrivateKey = pxContext->xP11PrivateKey;
+
+        taskENTER_CRITICAL();
+        xCredentialCache = xCredentials;
+        taskEXIT_CRITICAL();
     }
 
     /* Attach the client certificate(s) and private key to the TLS configuration. */
@@ -854,6 +954,9 @@ BaseType_t TLS_Init( TLSHelperParams_t * pxParams,
 int32_t TLS_Connect( TLSContext_t * pxContext )
 {
     int32_t result = 0;
+    MbedtlsArenaStats_t xArenaStats;
+
+    mbedtls_platform_handshake_started();
 
     /* Negotiate. */
     while( 0 != ( result = mbedtls_ssl_handshake( &pxContext->xMbedSslCtx ) ) )
@@ -872,6 +975,18 @@ int32_t TLS_Connect( TLSContext_t * pxContext )
         }
     }
 
+    mbedtls_platform_handshake_ended();
+
+    if( mbedtls_platform_get_arena_stats( &xArenaStats ) == pdTRUE )
+    {
+        LogInfo( ( "TLS arena: handshake peak %u bytes, %u bytes kept for the connection, %u of %u bytes allocated, %u allocations from the heap",
+                   ( unsigned ) xArenaStats.xHandshakePeakBytes,
+                   ( unsigned ) xArenaStats.xHandshakeRetainedBytes,
+                   ( unsigned ) xArenaStats.xAllocatedBytes,
+                   ( unsigned ) xArenaStats.xSize,
+                   ( unsigned ) xArenaStats.xFailedAllocations ) );
+    }
+
     return result;
 }
 
@@ -980,3 +1095,93 @@ void TLS_Cleanup( TLSContext_t * pxContext )
 {
     prvFreeContext( pxContext );
 }
+
+/*-----------------------------------------------------------*/
+
+BaseType_t TLS_LoadClientCredentials( const TLSHelperParams_t * pxParams )
+{
+    CK_RV xResult = CKR_OK;
+    CK_FUNCTION_LIST_PTR pxFunctionList = NULL;
+    CK_SESSION_HANDLE xSession = CK_INVALID_HANDLE;
+    TLSCredentialCache_t xCredentials = { { 0 }, { 0 }, CK_INVALID_HANDLE, CK_INVALID_HANDLE };
+
+    if( ( pxParams == NULL ) ||
+        ( pxParams->pPrivateKeyLabel == NULL ) ||
+        ( pxParams->pClientCertLabel == NULL ) ||
+        ( pxParams->pcLoginPIN == NULL ) ||
+        ( strlen( pxParams->pPrivateKeyLabel ) > pkcs11configMAX_LABEL_LENGTH ) ||
+        ( strlen( pxParams->pClientCertLabel ) > pkcs11configMAX_LABEL_LENGTH ) )
+    {
+        xResult = CKR_ARGUMENTS_BAD;
+    }
+
+    if( xResult == CKR_OK )
+    {
+        xResult = C_GetFunctionList( &pxFunctionList );
+    }
+
+    if( xResult == CKR_OK )
+    {
+        xResult = xInitializePkcs11Session( &xSession );
+
+        /* It is ok if the module was previously initialized. */
+        if( xResult == CKR_CRYPTOKI_ALREADY_INITIALIZED )
+        {
+            xResult = CKR_OK;
+        }
+    }
+
+    if( xResult == CKR_OK )
+    {
+        xResult = pxFunctionList->C_Login( xSession,
+                                           CKU_USER,
+                                           ( CK_UTF8CHAR_PTR ) pxParams->pcLoginPIN,
+                                           strlen( pxParams->pcLoginPIN ) );
+    }
+
+    if( xResult == CKR_OK )
+    {
+        xResult = xFindObjectWithLabelAndClass( xSession,
+                                                ( char * ) pxParams->pPrivateKeyLabel,
+                                                strlen( pxParams->pPrivateKeyLabel ),
+                                                CKO_PRIVATE_KEY,
+                                                &xCredentials.xPrivateKey );
+    }
+
+    if( xResult == CKR_OK )
+    {
+        xResult = xFindObjectWithLabelAndClass( xSession,
+                                                ( char * ) pxParams->pClientCertLabel,
+                                                strlen( pxParams->pClientCertLabel ),
+                                                CKO_CERTIFICATE,
+                                                &xCredentials.xClientCertificate );
+    }
+
+    if( ( xResult == CKR_OK ) &&
+        ( ( xCredentials.xPrivateKey == CK_INVALID_HANDLE ) ||
+          ( xCredentials.xClientCertificate == CK_INVALID_HANDLE ) ) )
+    {
+        xResult = CKR_OBJECT_HANDLE_INVALID;
+    }
+
+    if( xResult == CKR_OK )
+    {
+        ( void ) strcpy( xCredentials.cPrivateKeyLabel, pxParams->pPrivateKeyLabel );
+        ( void ) strcpy( xCredentials.cClientCertLabel, pxParams->pClientCertLabel );
+
+        taskENTER_CRITICAL();
+        xCredentialCache = xCredentials;
+        taskEXIT_CRITICAL();
+    }
+    else
+    {
+        LogWarn( ( "Client credentials could not be loaded ahead of the connection: %d", ( int ) xResult ) );
+    }
+
+    if( xSession != CK_INVALID_HANDLE )
+    {
+        ( void ) pxFunctionList->C_CloseSession( xSession );
+    }
+
+    return ( xResult == CKR_OK ) ? pdTRUE : pdFALSE;
+}
@@ -0,0 +1,240 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+
+#include "mbedtls_arena.h"
+
+#define arenaALIGNMENT              ( 2U * sizeof( void * ) )
+#define arenaROUND_UP( xSize )      ( ( ( xSize ) + arenaALIGNMENT - 1U ) & ~( arenaALIGNMENT - 1U ) )
+#define arenaHEADER_SIZE            arenaROUND_UP( sizeof( MbedtlsArenaBlock_t ) )
+
+/* Remainders smaller than this are left in the allocated block rather than
+ * split off as a free block. */
+#define arenaMINIMUM_BLOCK_SIZE     ( 2U * arenaHEADER_SIZE )
+
+/* The top bit of the size marks the allocated blocks, as in heap_4. */
+#define arenaALLOCATED_BIT          ( ( size_t ) 1U << ( ( sizeof( size_t ) * 8U ) - 1U ) )
+
+/*-----------------------------------------------------------*/
+
+/* Insert a block in the free list, in address order, and merge it with the
+ * free blocks either side of it. */
+static void prvInsertFreeBlock( MbedtlsArena_t * pxArena,
+                                MbedtlsArenaBlock_t * pxBlock )
+{
+    MbedtlsArenaBlock_t * pxPrevious = NULL;
+    MbedtlsArenaBlock_t * pxNext = pxArena->pxFreeList;
+
+    while( ( pxNext != NULL ) && ( ( uintptr_t ) pxNext < ( uintptr_t ) pxBlock ) )
+    {
+        pxPrevious = pxNext;
+        pxNext = pxNext->pxNextFree;
+    }
+
+    if( ( pxNext != NULL ) && ( ( ( uint8_t * ) pxBlock + pxBlock->xSize ) == ( uint8_t * ) pxNext ) )
+    {
+        pxBlock->xSize += pxNext->xSize;
+        pxNext = pxNext->pxNextFree;
+    }
+
+    pxBlock->pxNextFree = pxNext;
+
+    if( pxPrevious == NULL )
+    {
+        pxArena->pxFreeList = pxBlock;
+    }
+    else if( ( ( uint8_t * ) pxPrevious + pxPrevious->xSize ) == ( uint8_t * ) pxBlock )
+    {
+        pxPrevious->xSize += pxBlock->xSize;
+        pxPrevious->pxNextFree = pxNext;
+    }
+    else
+    {
+        pxPrevious->pxNextFree = pxBlock;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void mbedtlsArena_Init( MbedtlsArena_t * pxArena,
+                        void * pvRegion,
+                        size_t xRegionSize )
+{
+    uintptr_t uxStart = arenaROUND_UP( ( uintptr_t ) pvRegion );
+    uintptr_t uxEnd = ( ( uintptr_t ) pvRegion + xRegionSize ) & ~( ( uintptr_t ) arenaALIGNMENT - 1U );
+
+    *pxArena = ( MbedtlsArena_t ) { 0 };
+
+    if( ( pvRegion != NULL ) && ( uxEnd > uxStart ) && ( ( uxEnd - uxStart ) >= arenaMINIMUM_BLOCK_SIZE ) )
+    {
+        pxArena->pucStart = ( uint8_t * ) uxStart;
+        pxArena->xSize = ( size_t ) ( uxEnd - uxStart );
+        pxArena->pxFreeList = ( MbedtlsArenaBlock_t * ) uxStart;
+        pxArena->pxFreeList->pxNextFree = NULL;
+        pxArena->pxFreeList->xSize = pxArena->xSize;
+    }
+
+    pxArena->xStats.xSize = pxArena->xSize;
+}
+
+/*-----------------------------------------------------------*/
+
+void * mbedtlsArena_Allocate( MbedtlsArena_t * pxArena,
+                              size_t xSize )
+{
+    MbedtlsArenaBlock_t * pxPrevious = NULL;
+    MbedtlsArenaBlock_t * pxBlock = pxArena->pxFreeList;
+    MbedtlsArenaBlock_t * pxRemainder;
+    size_t xBlockSize = 0U;
+
+    if( xSize <= ( pxArena->xSize - arenaHEADER_SIZE ) )
+    {
+        xBlockSize = arenaHEADER_SIZE + arenaROUND_UP( xSize );
+    }
+
+    while( ( pxBlock != NULL ) && ( pxBlock->xSize < xBlockSize ) )
+    {
+        pxPrevious = pxBlock;
+        pxBlock = pxBlock->pxNextFree;
+    }
+
+    if( ( xBlockSize == 0U ) || ( pxBlock == NULL ) )
+    {
+        pxArena->xStats.xFailedAllocations++;
+
+        return NULL;
+    }
+
+    if( ( pxBlock->xSize - xBlockSize ) >= arenaMINIMUM_BLOCK_SIZE )
+    {
+        pxRemainder = ( MbedtlsArenaBlock_t * ) ( ( uint8_t * ) pxBlock + xBlockSize );
+        pxRemainder->xSize = pxBlock->xSize - xBlockSize;
+        pxRemainder->pxNextFree = pxBlock->pxNextFree;
+        pxBlock->xSize = xBlockSize;
+        pxBlock->pxNextFree = pxRemainder;
+    }
+
+    if( pxPrevious == NULL )
+    {
+        pxArena->pxFreeList = pxBlock->pxNextFree;
+    }
+    else
+    {
+        pxPrevious->pxNextFree = pxBlock->pxNextFree;
+    }
+
+    pxArena->xStats.xAllocatedBytes += pxBlock->xSize;
+
+    if( pxArena->xStats.xAllocatedBytes > pxArena->xStats.xPeakAllocatedBytes )
+    {
+        pxArena->xStats.xPeakAllocatedBytes = pxArena->xStats.xAllocatedBytes;
+    }
+
+    if( pxArena->xStats.xAllocatedBytes > pxArena->xHandshakePeakAllocated )
+    {
+        pxArena->xHandshakePeakAllocated = pxArena->xStats.xAllocatedBytes;
+    }
+
+    pxBlock->pxNextFree = NULL;
+    pxBlock->xSize |= arenaALLOCATED_BIT;
+
+    return ( uint8_t * ) pxBlock + arenaHEADER_SIZE;
+}
+
+/*-----------------------------------------------------------*/
+
+void mbedtlsArena_Free( MbedtlsArena_t * pxArena,
+                        void * pv )
+{
+    MbedtlsArenaBlock_t * pxBlock;
+
+    if( ( pv != NULL ) && mbedtlsArena_Contains( pxArena, pv ) )
+    {
+        pxBlock = ( MbedtlsArenaBlock_t * ) ( ( uint8_t * ) pv - arenaHEADER_SIZE );
+
+        /* Blocks freed twice are ignored. */
+        if( ( pxBlock->xSize & arenaALLOCATED_BIT ) != 0U )
+        {
+            pxBlock->xSize &= ~arenaALLOCATED_BIT;
+            pxArena->xStats.xAllocatedBytes -= pxBlock->xSize;
+            prvInsertFreeBlock( pxArena, pxBlock );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+bool mbedtlsArena_Contains( const MbedtlsArena_t * pxArena,
+                            const void * pv )
+{
+    return ( ( uintptr_t ) pv >= ( ( uintptr_t ) pxArena->pucStart + arenaHEADER_SIZE ) ) &&
+           ( ( uintptr_t ) pv < ( ( uintptr_t ) pxArena->pucStart + pxArena->xSize ) );
+}
+
+/*-----------------------------------------------------------*/
+
+void mbedtlsArena_HandshakeStarted( MbedtlsArena_t * pxArena )
+{
+    if( pxArena->xHandshakesInProgress == 0U )
+    {
+        pxArena->xHandshakeStartBytes = pxArena->xStats.xAllocatedBytes;
+        pxArena->xHandshakePeakAllocated = pxArena->xStats.xAllocatedBytes;
+    }
+
+    pxArena->xHandshakesInProgress++;
+}
+
+/*-----------------------------------------------------------*/
+
+void mbedtlsArena_HandshakeEnded( MbedtlsArena_t * pxArena )
+{
+    MbedtlsArenaStats_t * pxStats = &pxArena->xStats;
+
+    if( pxArena->xHandshakesInProgress > 0U )
+    {
+        pxArena->xHandshakesInProgress--;
+        pxStats->xHandshakes++;
+
+        if( pxArena->xHandshakesInProgress == 0U )
+        {
+            pxStats->xHandshakePeakBytes = pxArena->xHandshakePeakAllocated - pxArena->xHandshakeStartBytes;
+            pxStats->xHandshakeRetainedBytes = 0U;
+
+            /* The handshake may have freed more than it kept. */
+            if( pxStats->xAllocatedBytes > pxArena->xHandshakeStartBytes )
+            {
+                pxStats->xHandshakeRetainedBytes = pxStats->xAllocatedBytes - pxArena->xHandshakeStartBytes;
+            }
+
+            if( pxStats->xHandshakePeakBytes > pxStats->xMaxHandshakePeakBytes )
+            {
+                pxStats->xMaxHandshakePeakBytes = pxStats->xHandshakePeakBytes;
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void mbedtlsArena_GetStats( const MbedtlsArena_t * pxArena,
+                            MbedtlsArenaStats_t * pxStats )
+{
+    const MbedtlsArenaBlock_t * pxBlock;
+
+    *pxStats = pxArena->xStats;
+    pxStats->xLargestFreeBlock = 0U;
+    pxStats->xFreeBlocks = 0U;
+
+    for( pxBlock = pxArena->pxFreeList; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+    {
+        pxStats->xFreeBlocks++;
+
+        if( pxBlock->xSize > pxStats->xLargestFreeBlock )
+        {
+            pxStats->xLargestFreeBlock = pxBlock->xSize;
+        }
+    }
+}
@@ -33,6 +33,7 @@
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
+#include "task.h"
 
 /* mbed TLS includes. */
 
@@ -40,6 +41,9 @@
 #include "threading_alt.h"
 #include "mbedtls/ssl.h"
 
+#include "mbedtls_arena.h"
+#include "mbedtls_freertos_port.h"
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -51,6 +55,77 @@
  */
 #define TLS_RECORD_HEADER_BYTE_LENGTH    5
 
+/**
+ * @brief Size of the arena reserved for mbed TLS, 0 to allocate from the
+ * FreeRTOS heap.
+ */
+#ifndef MBEDTLS_FREERTOS_ARENA_SIZE
+    #define MBEDTLS_FREERTOS_ARENA_SIZE    0
+#endif
+
+/*-----------------------------------------------------------*/
+
+#if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 )
+
+/**
+ * @brief The region of the arena.
+ */
+    static uint8_t ucArenaRegion[ MBEDTLS_FREERTOS_ARENA_SIZE ] __attribute__( ( aligned( 8 ) ) );
+
+/**
+ * @brief The arena, accessed with the scheduler suspended.
+ */
+    static MbedtlsArena_t xArena;
+
+/**
+ * @brief pdTRUE once the arena covers its region.
+ */
+    static BaseType_t xArenaInitialised = pdFALSE;
+
+/**
+ * @brief Get the arena, covering its region on first use. Must be called with
+ * the scheduler suspended.
+ *
+ * @return The arena.
+ */
+    static MbedtlsArena_t * prvGetArena( void )
+    {
+        if( xArenaInitialised == pdFALSE )
+        {
+            mbedtlsArena_Init( &xArena, ucArenaRegion, sizeof( ucArenaRegion ) );
+            xArenaInitialised = pdTRUE;
+        }
+
+        return &xArena;
+    }
+#endif /* if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 ) */
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Allocates a block from the arena, if there is one.
+ *
+ * @param[in] totalSize Size of the block.
+ *
+ * @return The block, or NULL if it does not fit in the arena.
+ */
+static void * prvArenaAllocate( size_t totalSize )
+{
+    void * pBuffer = NULL;
+
+    #if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 )
+        vTaskSuspendAll();
+        {
+            pBuffer = mbedtlsArena_Allocate( prvGetArena(), totalSize );
+        }
+        ( void ) xTaskResumeAll();
+    #else /* if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 ) */
+        ( void ) totalSize;
+    #endif /* if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 ) */
+
+    return pBuffer;
+}
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -73,8 +148,15 @@ void * mbedtls_platform_calloc( size_t nmemb,
         /* Overflow check. */
         if( ( totalSize / size ) == nmemb )
         {
-            pBuffer = pvPortMalloc( totalSize );
+            pBuffer = prvArenaAllocate( totalSize );
 
+            /* The FreeRTOS heap takes what does not fit in the arena. */
+            if( pBuffer == NULL )
+            {
+                pBuffer = pvPortMalloc( totalSize );
+            }
+
+            /* Zeroed with the scheduler running, the buffers can be large. */
             if( pBuffer != NULL )
             {
                 ( void ) memset( pBuffer, 0x00, totalSize );
@@ -94,7 +176,67 @@ void * mbedtls_platform_calloc( size_t nmemb,
  */
 void mbedtls_platform_free( void * ptr )
 {
-    vPortFree( ptr );
+    #if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 )
+        if( mbedtlsArena_Contains( &xArena, ptr ) )
+        {
+            vTaskSuspendAll();
+            {
+                mbedtlsArena_Free( &xArena, ptr );
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+    #endif /* if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 ) */
+    {
+        vPortFree( ptr );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void mbedtls_platform_handshake_started( void )
+{
+    #if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 )
+        vTaskSuspendAll();
+        {
+            mbedtlsArena_HandshakeStarted( prvGetArena() );
+        }
+        ( void ) xTaskResumeAll();
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+void mbedtls_platform_handshake_ended( void )
+{
+    #if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 )
+        vTaskSuspendAll();
+        {
+            mbedtlsArena_HandshakeEnded( prvGetArena() );
+        }
+        ( void ) xTaskResumeAll();
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t mbedtls_platform_get_arena_stats( MbedtlsArenaStats_t * pxStats )
+{
+    BaseType_t xResult = pdFALSE;
+
+    #if ( MBEDTLS_FREERTOS_ARENA_SIZE > 0 )
+        vTaskSuspendAll();
+        {
+            mbedtlsArena_GetStats( prvGetArena(), pxStats );
+        }
+        ( void ) xTaskResumeAll();
+
+        xResult = pdTRUE;
+    #else
+        ( void ) pxStats;
+    #endif
+
+    return xResult;
 }
 
 /*-----------------------------------------------------------*/
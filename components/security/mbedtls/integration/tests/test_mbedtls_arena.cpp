@@ -0,0 +1,273 @@
+/* Copyright 2026 Arm Limited and/or its affiliates
+ * <open-source-office@arm.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <random>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "mbedtls_arena.h"
+}
+
+static const size_t regionSize = 16384U;
+static const size_t alignment = 2U * sizeof( void * );
+static const size_t header = ( sizeof( MbedtlsArenaBlock_t ) + alignment - 1U ) & ~( alignment - 1U );
+
+static size_t blockSize( size_t size )
+{
+    return header + ( ( size + alignment - 1U ) & ~( alignment - 1U ) );
+}
+
+class TestMbedtlsArena : public ::testing::Test
+{
+public:
+    TestMbedtlsArena()
+    {
+        mbedtlsArena_Init( &arena, region, sizeof( region ) );
+    }
+
+    MbedtlsArenaStats_t stats()
+    {
+        MbedtlsArenaStats_t arenaStats;
+
+        mbedtlsArena_GetStats( &arena, &arenaStats );
+
+        return arenaStats;
+    }
+
+    alignas( 16 ) uint8_t region[ regionSize ];
+    MbedtlsArena_t arena;
+};
+
+TEST_F( TestMbedtlsArena, the_whole_region_is_one_free_block )
+{
+    MbedtlsArenaStats_t arenaStats = stats();
+
+    EXPECT_EQ( arenaStats.xSize, regionSize );
+    EXPECT_EQ( arenaStats.xAllocatedBytes, 0U );
+    EXPECT_EQ( arenaStats.xFreeBlocks, 1U );
+    EXPECT_EQ( arenaStats.xLargestFreeBlock, regionSize );
+}
+
+TEST_F( TestMbedtlsArena, an_unaligned_region_is_trimmed_to_the_alignment )
+{
+    mbedtlsArena_Init( &arena, region + 1, sizeof( region ) - 1U );
+
+    EXPECT_EQ( stats().xSize, regionSize - alignment );
+}
+
+TEST_F( TestMbedtlsArena, blocks_are_aligned_and_taken_in_address_order )
+{
+    void * first = mbedtlsArena_Allocate( &arena, 1 );
+    void * second = mbedtlsArena_Allocate( &arena, 100 );
+
+    ASSERT_NE( first, nullptr );
+    ASSERT_NE( second, nullptr );
+    EXPECT_EQ( static_cast<uint8_t *>( first ), region + header );
+    EXPECT_EQ( static_cast<uint8_t *>( second ), region + blockSize( 1 ) + header );
+    EXPECT_EQ( reinterpret_cast<uintptr_t>( second ) % alignment, 0U );
+    EXPECT_TRUE( mbedtlsArena_Contains( &arena, first ) );
+    EXPECT_EQ( stats().xAllocatedBytes, blockSize( 1 ) + blockSize( 100 ) );
+}
+
+TEST_F( TestMbedtlsArena, allocations_that_do_not_fit_fail_and_are_counted )
+{
+    void * whole = mbedtlsArena_Allocate( &arena, regionSize - header );
+
+    ASSERT_NE( whole, nullptr );
+    EXPECT_EQ( mbedtlsArena_Allocate( &arena, 1 ), nullptr );
+    EXPECT_EQ( mbedtlsArena_Allocate( &arena, SIZE_MAX ), nullptr );
+
+    mbedtlsArena_Free( &arena, whole );
+    EXPECT_EQ( mbedtlsArena_Allocate( &arena, regionSize ), nullptr );
+    EXPECT_EQ( stats().xFailedAllocations, 3U );
+}
+
+TEST_F( TestMbedtlsArena, blocks_outside_of_the_region_are_not_contained )
+{
+    uint8_t outside;
+
+    EXPECT_FALSE( mbedtlsArena_Contains( &arena, &outside ) );
+    EXPECT_FALSE( mbedtlsArena_Contains( &arena, nullptr ) );
+    EXPECT_FALSE( mbedtlsArena_Contains( &arena, region + regionSize ) );
+}
+
+TEST_F( TestMbedtlsArena, freed_blocks_merge_with_their_free_neighbours )
+{
+    void * blocks[ 4 ];
+
+    for( void * & block : blocks )
+    {
+        block = mbedtlsArena_Allocate( &arena, 256 );
+        ASSERT_NE( block, nullptr );
+    }
+
+    mbedtlsArena_Free( &arena, blocks[ 0 ] );
+    mbedtlsArena_Free( &arena, blocks[ 2 ] );
+    EXPECT_EQ( stats().xFreeBlocks, 3U );
+
+    /* Between two free blocks. */
+    mbedtlsArena_Free( &arena, blocks[ 1 ] );
+    EXPECT_EQ( stats().xFreeBlocks, 2U );
+    EXPECT_EQ( stats().xLargestFreeBlock, regionSize - 4U * blockSize( 256 ) );
+
+    /* The first free block fits three of them again. */
+    EXPECT_EQ( mbedtlsArena_Allocate( &arena, 3U * blockSize( 256 ) - header ), blocks[ 0 ] );
+
+    mbedtlsArena_Free( &arena, blocks[ 0 ] );
+    mbedtlsArena_Free( &arena, blocks[ 3 ] );
+    EXPECT_EQ( stats().xFreeBlocks, 1U );
+    EXPECT_EQ( stats().xLargestFreeBlock, regionSize );
+    EXPECT_EQ( stats().xAllocatedBytes, 0U );
+}
+
+TEST_F( TestMbedtlsArena, freeing_a_block_twice_or_null_does_nothing )
+{
+    void * block = mbedtlsArena_Allocate( &arena, 64 );
+    void * other = mbedtlsArena_Allocate( &arena, 64 );
+
+    mbedtlsArena_Free( &arena, block );
+    mbedtlsArena_Free( &arena, block );
+    mbedtlsArena_Free( &arena, nullptr );
+
+    EXPECT_EQ( stats().xAllocatedBytes, blockSize( 64 ) );
+    EXPECT_EQ( stats().xFreeBlocks, 2U );
+    mbedtlsArena_Free( &arena, other );
+}
+
+TEST_F( TestMbedtlsArena, small_remainders_stay_in_the_allocated_block )
+{
+    void * block = mbedtlsArena_Allocate( &arena, regionSize - header - alignment );
+
+    ASSERT_NE( block, nullptr );
+    EXPECT_EQ( stats().xAllocatedBytes, regionSize );
+    EXPECT_EQ( stats().xFreeBlocks, 0U );
+
+    mbedtlsArena_Free( &arena, block );
+    EXPECT_EQ( stats().xLargestFreeBlock, regionSize );
+}
+
+TEST_F( TestMbedtlsArena, a_handshake_records_its_peak_and_what_it_kept )
+{
+    void * before = mbedtlsArena_Allocate( &arena, 1000 );
+
+    mbedtlsArena_HandshakeStarted( &arena );
+
+    void * session = mbedtlsArena_Allocate( &arena, 200 );
+    void * certificate = mbedtlsArena_Allocate( &arena, 3000 );
+    void * bignum = mbedtlsArena_Allocate( &arena, 500 );
+
+    mbedtlsArena_Free( &arena, bignum );
+    mbedtlsArena_Free( &arena, certificate );
+    mbedtlsArena_HandshakeEnded( &arena );
+
+    MbedtlsArenaStats_t arenaStats = stats();
+    EXPECT_EQ( arenaStats.xHandshakes, 1U );
+    EXPECT_EQ( arenaStats.xHandshakePeakBytes, blockSize( 200 ) + blockSize( 3000 ) + blockSize( 500 ) );
+    EXPECT_EQ( arenaStats.xHandshakeRetainedBytes, blockSize( 200 ) );
+    EXPECT_EQ( arenaStats.xMaxHandshakePeakBytes, arenaStats.xHandshakePeakBytes );
+
+    /* The transient blocks merged back into the free space. */
+    EXPECT_EQ( arenaStats.xFreeBlocks, 1U );
+
+    /* A smaller handshake that frees an older block. */
+    mbedtlsArena_HandshakeStarted( &arena );
+    mbedtlsArena_Free( &arena, mbedtlsArena_Allocate( &arena, 100 ) );
+    mbedtlsArena_Free( &arena, before );
+    mbedtlsArena_HandshakeEnded( &arena );
+
+    arenaStats = stats();
+    EXPECT_EQ( arenaStats.xHandshakes, 2U );
+    EXPECT_EQ( arenaStats.xHandshakePeakBytes, blockSize( 100 ) );
+    EXPECT_EQ( arenaStats.xHandshakeRetainedBytes, 0U );
+    EXPECT_EQ( arenaStats.xMaxHandshakePeakBytes, blockSize( 200 ) + blockSize( 3000 ) + blockSize( 500 ) );
+
+    mbedtlsArena_Free( &arena, session );
+}
+
+TEST_F( TestMbedtlsArena, overlapping_handshakes_are_measured_together )
+{
+    mbedtlsArena_HandshakeStarted( &arena );
+    void * first = mbedtlsArena_Allocate( &arena, 400 );
+
+    mbedtlsArena_HandshakeStarted( &arena );
+    void * second = mbedtlsArena_Allocate( &arena, 800 );
+
+    mbedtlsArena_Free( &arena, first );
+    mbedtlsArena_HandshakeEnded( &arena );
+    EXPECT_EQ( stats().xHandshakePeakBytes, 0U );
+
+    mbedtlsArena_Free( &arena, second );
+    mbedtlsArena_HandshakeEnded( &arena );
+    EXPECT_EQ( stats().xHandshakePeakBytes, blockSize( 400 ) + blockSize( 800 ) );
+    EXPECT_EQ( stats().xHandshakes, 2U );
+
+    /* Unbalanced ends are ignored. */
+    mbedtlsArena_HandshakeEnded( &arena );
+    EXPECT_EQ( stats().xHandshakes, 2U );
+}
+
+TEST_F( TestMbedtlsArena, the_region_coalesces_after_random_allocations_and_frees )
+{
+    std::mt19937 generator( 20261018U );
+    std::uniform_int_distribution<int> percent( 0, 99 );
+    std::uniform_int_distribution<size_t> size( 0U, 2048U );
+    std::map<uint8_t *, size_t> blocks;
+    size_t allocated = 0U;
+    size_t peak = 0U;
+
+    for( int step = 0; step < 20000; step++ )
+    {
+        if( blocks.empty() || ( percent( generator ) < 55 ) )
+        {
+            size_t wanted = size( generator );
+            uint8_t * block = static_cast<uint8_t *>( mbedtlsArena_Allocate( &arena, wanted ) );
+
+            if( block != nullptr )
+            {
+                std::map<uint8_t *, size_t>::iterator next = blocks.upper_bound( block );
+
+                /* No overlap with the allocated neighbours. */
+                ASSERT_EQ( reinterpret_cast<uintptr_t>( block ) % alignment, 0U );
+                ASSERT_TRUE( ( next == blocks.end() ) || ( block + wanted <= next->first - header ) );
+                ASSERT_TRUE( ( next == blocks.begin() ) || ( std::prev( next )->first + std::prev( next )->second <= block - header ) );
+
+                ( void ) memset( block, 0x5A, wanted );
+                blocks[ block ] = wanted;
+                allocated += blockSize( wanted );
+            }
+        }
+        else
+        {
+            std::map<uint8_t *, size_t>::iterator block = blocks.begin();
+
+            std::advance( block, std::uniform_int_distribution<size_t>( 0U, blocks.size() - 1U )( generator ) );
+            mbedtlsArena_Free( &arena, block->first );
+            blocks.erase( block );
+        }
+
+        MbedtlsArenaStats_t arenaStats = stats();
+        peak = std::max( peak, arenaStats.xAllocatedBytes );
+        ASSERT_GE( arenaStats.xAllocatedBytes, blocks.size() * header );
+        ASSERT_LE( arenaStats.xAllocatedBytes + arenaStats.xLargestFreeBlock, regionSize );
+        ASSERT_EQ( arenaStats.xPeakAllocatedBytes, peak );
+    }
+
+    EXPECT_GT( stats().xFailedAllocations, 0U );
+    EXPECT_GT( allocated, regionSize );
+
+    for( std::map<uint8_t *, size_t>::iterator block = blocks.begin(); block != blocks.end(); ++block )
+    {
+        mbedtlsArena_Free( &arena, block->first );
+    }
+
+    EXPECT_EQ( stats().xAllocatedBytes, 0U );
+    EXPECT_EQ( stats().xFreeBlocks, 1U );
+    EXPECT_EQ( stats().xLargestFreeBlock, regionSize );
+}
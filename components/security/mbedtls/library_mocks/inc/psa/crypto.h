@@ -12,6 +12,18 @@
 #include <stddef.h>
 #include <stdint.h>
 
+typedef uint32_t psa_algorithm_t;
+
+#define PSA_ALG_SHA_256    ( ( psa_algorithm_t ) 0x02000009 )
+
 DECLARE_FAKE_VALUE_FUNC( psa_status_t, psa_generate_random, uint8_t *, size_t );
+DECLARE_FAKE_VALUE_FUNC( psa_status_t,
+                         psa_hash_compute,
+                         psa_algorithm_t,
+                         const uint8_t *,
+                         size_t,
+                         uint8_t *,
+                         size_t,
+                         size_t * );
 
 #endif /* PSA_CRYPTO_H */
@@ -10,3 +10,11 @@ DEFINE_FAKE_VALUE_FUNC( psa_status_t,
                         psa_generate_random,
                         uint8_t *,
                         size_t );
+DEFINE_FAKE_VALUE_FUNC( psa_status_t,
+                        psa_hash_compute,
+                        psa_algorithm_t,
+                        const uint8_t *,
+                        size_t,
+                        uint8_t *,
+                        size_t,
+                        size_t * );
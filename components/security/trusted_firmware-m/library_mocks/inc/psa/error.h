@@ -12,5 +12,9 @@
 
 #define PSA_ERROR_PROGRAMMER_ERROR    ( ( psa_status_t ) -129 )
 
+#define PSA_ERROR_DOES_NOT_EXIST      ( ( psa_status_t ) -140 )
+
+#define PSA_ERROR_STORAGE_FAILURE     ( ( psa_status_t ) -146 )
+
 
 #endif /* __PSA_ERROR_H__ */
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef PSA_PROTECTED_STORAGE_H
+#define PSA_PROTECTED_STORAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fff.h"
+
+#include "psa/crypto_types.h"
+#include "psa/error.h"
+#include "psa/storage_common.h"
+
+DECLARE_FAKE_VALUE_FUNC( psa_status_t,
+                         psa_ps_set,
+                         psa_storage_uid_t,
+                         size_t,
+                         const void *,
+                         psa_storage_create_flags_t );
+DECLARE_FAKE_VALUE_FUNC( psa_status_t,
+                         psa_ps_get,
+                         psa_storage_uid_t,
+                         size_t,
+                         size_t,
+                         void *,
+                         size_t * );
+DECLARE_FAKE_VALUE_FUNC( psa_status_t,
+                         psa_ps_remove,
+                         psa_storage_uid_t );
+
+#endif /* PSA_PROTECTED_STORAGE_H */
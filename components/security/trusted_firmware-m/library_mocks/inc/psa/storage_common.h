@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef PSA_STORAGE_COMMON_H
+#define PSA_STORAGE_COMMON_H
+
+#include <stdint.h>
+
+typedef uint32_t psa_storage_create_flags_t;
+
+typedef uint64_t psa_storage_uid_t;
+
+#define PSA_STORAGE_FLAG_NONE    0u
+
+#endif /* PSA_STORAGE_COMMON_H */
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "psa/protected_storage.h"
+
+DEFINE_FAKE_VALUE_FUNC( psa_status_t,
+                        psa_ps_set,
+                        psa_storage_uid_t,
+                        size_t,
+                        const void *,
+                        psa_storage_create_flags_t );
+DEFINE_FAKE_VALUE_FUNC( psa_status_t,
+                        psa_ps_get,
+                        psa_storage_uid_t,
+                        size_t,
+                        size_t,
+                        void *,
+                        size_t * );
+DEFINE_FAKE_VALUE_FUNC( psa_status_t,
+                        psa_ps_remove,
+                        psa_storage_uid_t );
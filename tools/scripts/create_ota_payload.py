@@ -0,0 +1,383 @@
+#! /usr/bin/env python3
+#
+# Copyright 2026 Arm Limited and/or its affiliates
+# <open-source-office@arm.com>
+# SPDX-License-Identifier: MIT
+
+"""
+Create a compressed and/or delta OTA payload from a signed update image.
+
+The payload is decoded by the OTA orchestrator while it is downloaded, see
+applications/helpers/ota_orchestrator/src/ota_payload_decoder.c for the
+format. The image signature is unchanged: sign the image, not the payload.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+from pathlib import Path
+
+PAYLOAD_MAGIC = b"OTAP"
+PAYLOAD_VERSION = 1
+FLAG_COMPRESSED = 0x01
+FLAG_DELTA = 0x02
+
+# Must not exceed OTA_PAYLOAD_MAX_WINDOW_BITS of the decoder.
+MAX_WINDOW_BITS = 12
+
+OPCODE_COPY_ADD = 1
+OPCODE_INSERT = 2
+OPCODE_SEEK = 3
+
+# Length of the exact match used to find where the new image lines up with
+# the base image, and stride of the base image index.
+DELTA_SEED_LENGTH = 16
+DELTA_INDEX_STRIDE = 4
+
+# Mismatches tolerated while extending a delta copy past the last match.
+DELTA_MAX_SCORE_DROP = 16
+
+# Candidates examined per position when looking for an LZSS match.
+LZSS_MAX_CHAIN = 32
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.accumulator = 0
+        self.count = 0
+
+    def write(self, value, width):
+        self.accumulator = (self.accumulator << width) | value
+        self.count += width
+        while self.count >= 8:
+            self.count -= 8
+            self.out.append((self.accumulator >> self.count) & 0xFF)
+        self.accumulator &= (1 << self.count) - 1
+
+    def finish(self):
+        if self.count > 0:
+            self.out.append((self.accumulator << (8 - self.count)) & 0xFF)
+            self.count = 0
+            self.accumulator = 0
+        return bytes(self.out)
+
+
+def lzss_compress(data, window_bits, lookahead_bits):
+    window = 1 << window_bits
+    max_length = 1 << lookahead_bits
+    writer = BitWriter()
+    chains = {}
+    position = 0
+
+    def remember(index):
+        if index + 3 <= len(data):
+            chains.setdefault(data[index : index + 3], []).append(index)
+
+    while position < len(data):
+        best_length = 0
+        best_distance = 0
+        key = data[position : position + 3]
+        candidates = chains.get(key, [])
+
+        for candidate in reversed(candidates[-LZSS_MAX_CHAIN:]):
+            distance = position - candidate
+            if distance > window:
+                break
+            length = 3
+            while (
+                length < max_length
+                and position + length < len(data)
+                and data[candidate + length] == data[position + length]
+            ):
+                length += 1
+            if length > best_length:
+                best_length = length
+                best_distance = distance
+                if length == max_length:
+                    break
+
+        if len(candidates) > 4 * LZSS_MAX_CHAIN:
+            del candidates[: -LZSS_MAX_CHAIN]
+
+        # A back reference only pays off when it is shorter than the literals.
+        if best_length > 0 and 1 + window_bits + lookahead_bits < 9 * best_length:
+            writer.write(0, 1)
+            writer.write(best_distance - 1, window_bits)
+            writer.write(best_length - 1, lookahead_bits)
+            step = best_length
+        else:
+            writer.write(1, 1)
+            writer.write(data[position], 8)
+            step = 1
+
+        for index in range(position, position + step):
+            remember(index)
+        position += step
+
+    return writer.finish()
+
+
+def lzss_decompress(data, window_bits, lookahead_bits):
+    out = bytearray()
+    accumulator = 0
+    count = 0
+    state = "tag"
+    distance = 0
+
+    for byte in data:
+        accumulator = (accumulator << 8) | byte
+        count += 8
+        progress = True
+        while progress:
+            progress = False
+            if state == "tag" and count >= 1:
+                count -= 1
+                state = "literal" if (accumulator >> count) & 1 else "index"
+                progress = True
+            elif state == "literal" and count >= 8:
+                count -= 8
+                out.append((accumulator >> count) & 0xFF)
+                state = "tag"
+                progress = True
+            elif state == "index" and count >= window_bits:
+                count -= window_bits
+                distance = ((accumulator >> count) & ((1 << window_bits) - 1)) + 1
+                state = "count"
+                progress = True
+            elif state == "count" and count >= lookahead_bits:
+                count -= lookahead_bits
+                length = ((accumulator >> count) & ((1 << lookahead_bits) - 1)) + 1
+                for _ in range(length):
+                    out.append(out[-distance])
+                state = "tag"
+                progress = True
+        accumulator &= (1 << count) - 1
+
+    return bytes(out)
+
+
+def encode_varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def encode_zigzag(value):
+    return (value << 1) if value >= 0 else ((-value << 1) - 1)
+
+
+def delta_encode(base, image):
+    index = {}
+    for position in range(0, len(base) - DELTA_SEED_LENGTH + 1, DELTA_INDEX_STRIDE):
+        index.setdefault(base[position : position + DELTA_SEED_LENGTH], position)
+
+    out = bytearray()
+    position = 0
+    literal_start = 0
+    source_offset = 0
+
+    def insert(end):
+        if end > literal_start:
+            out.append(OPCODE_INSERT)
+            out.extend(encode_varint(end - literal_start))
+            out.extend(image[literal_start:end])
+
+    while position + DELTA_SEED_LENGTH <= len(image):
+        source = index.get(image[position : position + DELTA_SEED_LENGTH])
+        if source is None:
+            position += 1
+            continue
+
+        # Extend the match backwards into the pending literals.
+        while (
+            position > literal_start
+            and source > 0
+            and image[position - 1] == base[source - 1]
+        ):
+            position -= 1
+            source -= 1
+
+        # Extend it forwards while the bytes mostly match, like bsdiff.
+        score = 0
+        best_score = 0
+        length = 0
+        offset = 0
+        while position + offset < len(image) and source + offset < len(base):
+            score += 1 if image[position + offset] == base[source + offset] else -1
+            offset += 1
+            if score > best_score:
+                best_score = score
+                length = offset
+            elif best_score - score > DELTA_MAX_SCORE_DROP:
+                break
+
+        insert(position)
+        if source != source_offset:
+            out.append(OPCODE_SEEK)
+            out.extend(encode_varint(encode_zigzag(source - source_offset)))
+        out.append(OPCODE_COPY_ADD)
+        out.extend(encode_varint(length))
+        out.extend(
+            (image[position + i] - base[source + i]) & 0xFF for i in range(length)
+        )
+
+        position += length
+        source_offset = source + length
+        literal_start = position
+
+    insert(len(image))
+    return bytes(out)
+
+
+def delta_decode(base, delta):
+    out = bytearray()
+    position = 0
+    source_offset = 0
+
+    def read_varint():
+        nonlocal position
+        value = 0
+        shift = 0
+        while True:
+            byte = delta[position]
+            position += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    while position < len(delta):
+        opcode = delta[position]
+        position += 1
+        operand = read_varint()
+        if opcode == OPCODE_SEEK:
+            source_offset += (operand >> 1) ^ -(operand & 1)
+        elif opcode == OPCODE_INSERT:
+            out.extend(delta[position : position + operand])
+            position += operand
+        elif opcode == OPCODE_COPY_ADD:
+            for i in range(operand):
+                out.append((base[source_offset + i] + delta[position + i]) & 0xFF)
+            position += operand
+            source_offset += operand
+        else:
+            raise ValueError(f"invalid delta opcode {opcode}")
+
+    return bytes(out)
+
+
+def create_payload(image, base, compress, window_bits, lookahead_bits):
+    flags = 0
+    body = image
+    source_size = 0
+    source_digest = bytes(32)
+
+    if base is not None:
+        flags |= FLAG_DELTA
+        body = delta_encode(base, image)
+        source_size = len(base)
+        source_digest = hashlib.sha256(base).digest()
+
+    if compress:
+        flags |= FLAG_COMPRESSED
+        body = lzss_compress(body, window_bits, lookahead_bits)
+    else:
+        window_bits = 0
+        lookahead_bits = 0
+
+    header = (
+        PAYLOAD_MAGIC
+        + struct.pack(
+            "<BBBBII",
+            PAYLOAD_VERSION,
+            flags,
+            window_bits,
+            lookahead_bits,
+            len(image),
+            source_size,
+        )
+        + source_digest
+    )
+    return header + body
+
+
+def decode_payload(payload, base):
+    version, flags, window_bits, lookahead_bits, image_size, _ = struct.unpack_from(
+        "<BBBBII", payload, 4
+    )
+    body = payload[48:]
+    if flags & FLAG_COMPRESSED:
+        body = lzss_decompress(body, window_bits, lookahead_bits)
+    if flags & FLAG_DELTA:
+        body = delta_decode(base, body)
+    return body[:image_size] if len(body) >= image_size else None
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Create a compressed and/or delta OTA payload from a signed "
+        "update image."
+    )
+    parser.add_argument("image", type=Path, help="Signed update image.")
+    parser.add_argument("output", type=Path, help="Payload to upload for the OTA job.")
+    parser.add_argument(
+        "--base",
+        type=Path,
+        help="Signed image running on the device, to create a delta against.",
+    )
+    parser.add_argument(
+        "--no-compress",
+        action="store_true",
+        help="Do not LZSS compress the payload.",
+    )
+    parser.add_argument(
+        "--window-bits",
+        type=int,
+        default=11,
+        help=f"LZSS window size as a power of two, from 4 to {MAX_WINDOW_BITS}. "
+        "The device needs this much RAM to decompress.",
+    )
+    parser.add_argument(
+        "--lookahead-bits",
+        type=int,
+        help="LZSS match length field width, from 3 to window bits - 1. "
+        "Defaults to 8 for a delta, whose long runs of zeros favour long "
+        "matches, and to 4 otherwise.",
+    )
+    args = parser.parse_args()
+
+    if not 4 <= args.window_bits <= MAX_WINDOW_BITS:
+        parser.error(f"--window-bits must be between 4 and {MAX_WINDOW_BITS}")
+    if args.lookahead_bits is None:
+        args.lookahead_bits = 8 if args.base is not None else 4
+    if not 3 <= args.lookahead_bits < args.window_bits:
+        parser.error("--lookahead-bits must be between 3 and --window-bits - 1")
+    if args.base is None and args.no_compress:
+        parser.error("a payload must be compressed, a delta, or both")
+
+    image = args.image.read_bytes()
+    base = args.base.read_bytes() if args.base is not None else None
+    payload = create_payload(
+        image, base, not args.no_compress, args.window_bits, args.lookahead_bits
+    )
+
+    if decode_payload(payload, base) != image:
+        sys.exit("The payload does not decode back to the image.")
+
+    args.output.write_bytes(payload)
+    print(
+        f"{args.output}: {len(payload)} bytes, "
+        f"{100.0 * len(payload) / max(len(image), 1):.1f}% of {len(image)} bytes"
+    )
+
+
+if __name__ == "__main__":
+    main()